@@ -46,6 +46,10 @@ namespace DXBC2GLSL
 	public:
 		static uint32_t DefaultRules(GLSLVersion version);
 
+		// Translations are cached by the DXBC blob and the other parameters of FeedDXBC, so a shader shared by effects or variants
+		// is only translated once. FeedDXBC can be called from multiple threads.
+		static void ClearCache();
+
 		void FeedDXBC(void const * dxbc_data,
 			bool has_gs, bool has_ps, ShaderTessellatorPartitioning ds_partitioning, ShaderTessellatorOutputPrimitive ds_output_primitive,
 			GLSLVersion version);
@@ -83,9 +87,11 @@ namespace DXBC2GLSL
 		ShaderTessellatorOutputPrimitive DSOutputPrimitive() const;
 
 	private:
-		std::shared_ptr<DXBCContainer> dxbc_;
+		struct Translation;
+		struct TranslationCache;
+
+		std::shared_ptr<Translation const> translation_;
 		std::shared_ptr<ShaderProgram> shader_;
-		std::string glsl_;
 	};
 }
 
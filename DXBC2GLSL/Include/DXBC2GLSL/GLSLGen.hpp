@@ -34,6 +34,7 @@
 #pragma once
 
 #include <DXBC2GLSL/Shader.hpp>
+#include <DXBC2GLSL/StringBuilder.hpp>
 #include <map>
 
 enum GLSLVersion
@@ -137,52 +138,52 @@ public:
 	void FeedDXBC(std::shared_ptr<ShaderProgram> const & program,
 		bool has_gs, bool has_ps, ShaderTessellatorPartitioning ds_partitioning, ShaderTessellatorOutputPrimitive ds_output_primitive,
 		GLSLVersion version, uint32_t glsl_rules);
-	void ToGLSL(std::ostream& out);
-	void ToHSControlPointPhase(std::ostream& out);
-	void ToHSForkPhases(std::ostream& out);
-	void ToHSJoinPhases(std::ostream& out);
+	void ToGLSL(StringBuilder& out);
+	void ToHSControlPointPhase(StringBuilder& out);
+	void ToHSForkPhases(StringBuilder& out);
+	void ToHSJoinPhases(StringBuilder& out);
 
 private:
-	void ToStructs(std::ostream& out);
-	void ToType(std::ostream& out, DXBCShaderTypeDesc const& type_desc) const;
-	void ToDeclarations(std::ostream& out);
-	void ToDclInterShaderInputRecords(std::ostream& out);
-	void ToDclInterShaderOutputRecords(std::ostream& out);
-	void ToDclInterShaderPatchConstantRecords(std::ostream& out);
-	void ToDeclInterShaderInputRegisters(std::ostream& out) const;
-	void ToCopyToInterShaderInputRegisters(std::ostream& out) const;
-	void ToDeclInterShaderOutputRegisters(std::ostream& out) const;
-	void ToCopyToInterShaderOutputRecords(std::ostream& out) const;
-	void ToDclInterShaderPatchConstantRegisters(std::ostream& out);
-	void ToCopyToInterShaderPatchConstantRecords(std::ostream& out) const;
-	void ToCopyToInterShaderPatchConstantRegisters(std::ostream& out) const;
-	void ToDefaultHSControlPointPhase(std::ostream& out)const;
-	void ToDeclaration(std::ostream& out, ShaderDecl const & dcl);
-	void ToInstruction(std::ostream& out, ShaderInstruction const & insn) const;
-	void ToOperands(std::ostream& out, ShaderOperand const & op, uint32_t imm_as_type,
+	void ToStructs(StringBuilder& out);
+	void ToType(StringBuilder& out, DXBCShaderTypeDesc const& type_desc) const;
+	void ToDeclarations(StringBuilder& out);
+	void ToDclInterShaderInputRecords(StringBuilder& out);
+	void ToDclInterShaderOutputRecords(StringBuilder& out);
+	void ToDclInterShaderPatchConstantRecords(StringBuilder& out);
+	void ToDeclInterShaderInputRegisters(StringBuilder& out) const;
+	void ToCopyToInterShaderInputRegisters(StringBuilder& out) const;
+	void ToDeclInterShaderOutputRegisters(StringBuilder& out) const;
+	void ToCopyToInterShaderOutputRecords(StringBuilder& out) const;
+	void ToDclInterShaderPatchConstantRegisters(StringBuilder& out);
+	void ToCopyToInterShaderPatchConstantRecords(StringBuilder& out) const;
+	void ToCopyToInterShaderPatchConstantRegisters(StringBuilder& out) const;
+	void ToDefaultHSControlPointPhase(StringBuilder& out)const;
+	void ToDeclaration(StringBuilder& out, ShaderDecl const & dcl);
+	void ToInstruction(StringBuilder& out, ShaderInstruction const & insn) const;
+	void ToOperands(StringBuilder& out, ShaderOperand const & op, uint32_t imm_as_type,
 		bool mask = true, bool dcl_array = false, bool no_swizzle = false, bool no_idx = false, bool no_cast = false,
 		ShaderInputType const & sit = SIT_UNDEFINED) const;
 	ShaderImmType OperandAsCBufferType(
 		uint32_t imm_as_type, uint32_t offset, uint32_t var_start_offset, DXBCShaderTypeDesc const& var_type_desc) const;
 	ShaderImmType OperandAsType(ShaderOperand const & op, uint32_t imm_as_type) const;
-	int ToSingleComponentSelector(std::ostream& out, ShaderOperand const & op, int i, bool dot = true) const;
-	void ToOperandName(std::ostream& out, ShaderOperand const& op, DXBCShaderTypeDesc const& type_desc, const char* var_name,
+	int ToSingleComponentSelector(StringBuilder& out, ShaderOperand const & op, int i, bool dot = true) const;
+	void ToOperandName(StringBuilder& out, ShaderOperand const& op, DXBCShaderTypeDesc const& type_desc, const char* var_name,
 		uint32_t var_start_offset, std::vector<DXBCShaderVariable> const& cb_vars, uint32_t offset, bool contain_multi_var,
 		bool dynamic_indexed, uint32_t register_index, uint32_t num_selectors, bool no_swizzle, bool& need_comps) const;
-	void ToOperandName(std::ostream& out, ShaderOperand const & op, ShaderImmType as_type,
+	void ToOperandName(StringBuilder& out, ShaderOperand const & op, ShaderImmType as_type,
 		bool* need_idx, bool* need_comps, bool no_swizzle = false, bool no_idx = false,
 		ShaderInputType const & sit = SIT_UNDEFINED) const;
-	void ToComponentSelectors(std::ostream& out, ShaderOperand const & op, bool dot = true, uint32_t offset = 0) const;
-	void ToTemps(std::ostream& out, ShaderDecl const & dcl);
-	void ToImmConstBuffer(std::ostream& out, ShaderDecl const & dcl);
-	void ToDefaultValue(std::ostream& out, DXBCShaderVariable const & var);
-	void ToDefaultValue(std::ostream& out, DXBCShaderVariable const & var, uint32_t offset);
-	void ToDefaultValue(std::ostream& out, char const * value, ShaderVariableType type);
+	void ToComponentSelectors(StringBuilder& out, ShaderOperand const & op, bool dot = true, uint32_t offset = 0) const;
+	void ToTemps(StringBuilder& out, ShaderDecl const & dcl);
+	void ToImmConstBuffer(StringBuilder& out, ShaderDecl const & dcl);
+	void ToDefaultValue(StringBuilder& out, DXBCShaderVariable const & var);
+	void ToDefaultValue(StringBuilder& out, DXBCShaderVariable const & var, uint32_t offset);
+	void ToDefaultValue(StringBuilder& out, char const * value, ShaderVariableType type);
 	uint32_t ComponentSelectorFromMask(uint32_t mask, uint32_t comps) const;
 	uint32_t ComponentSelectorFromSwizzle(uint8_t const swizzle[4], uint32_t comps) const;
 	uint32_t ComponentSelectorFromScalar(uint8_t scalar) const;
 	uint32_t ComponentSelectorFromCount(uint32_t count) const;
-	void ToComponentSelector(std::ostream& out, uint32_t comps, uint32_t offset = 0) const;
+	void ToComponentSelector(StringBuilder& out, uint32_t comps, uint32_t offset = 0) const;
 	bool IsImmediateNumber(ShaderOperand const & op) const;
 	// param i:the component selector to get
 	// return:the idx of selector:0 1 2 3 stand for x y z w
@@ -0,0 +1,126 @@
+/**
+ * @file StringBuilder.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#ifndef _DXBC2GLSL_STRINGBUILDER_HPP
+#define _DXBC2GLSL_STRINGBUILDER_HPP
+
+#pragma once
+
+#include <DXBC2GLSL/Utils.hpp>
+
+#include <charconv>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Appends to a string without going through iostreams. Numbers are formatted the same way as a std::ostream with default flags,
+// so it can replace one without changing the output.
+class StringBuilder final
+{
+public:
+	explicit StringBuilder(std::string& str) noexcept
+		: str_(str)
+	{
+	}
+
+	// Same as setf(std::ios::showpoint), sticky for all floats that follow
+	void ShowPoint() noexcept
+	{
+		show_point_ = true;
+	}
+
+	StringBuilder& operator<<(char ch)
+	{
+		str_.push_back(ch);
+		return *this;
+	}
+	StringBuilder& operator<<(signed char ch)
+	{
+		return *this << static_cast<char>(ch);
+	}
+	StringBuilder& operator<<(unsigned char ch)
+	{
+		return *this << static_cast<char>(ch);
+	}
+	StringBuilder& operator<<(char const * str)
+	{
+		str_.append(str);
+		return *this;
+	}
+	StringBuilder& operator<<(std::string const & str)
+	{
+		str_.append(str);
+		return *this;
+	}
+	StringBuilder& operator<<(std::string_view str)
+	{
+		str_.append(str);
+		return *this;
+	}
+	StringBuilder& operator<<(bool v)
+	{
+		return *this << (v ? '1' : '0');
+	}
+
+	template <typename T, std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>, int> = 0>
+	StringBuilder& operator<<(T v)
+	{
+		if constexpr (std::is_enum_v<T>)
+		{
+			return *this << static_cast<std::underlying_type_t<T>>(v);
+		}
+		else
+		{
+			char buff[24];
+			auto const result = std::to_chars(buff, buff + sizeof(buff), v);
+			str_.append(buff, result.ptr);
+			return *this;
+		}
+	}
+
+	StringBuilder& operator<<(float v)
+	{
+		return *this << static_cast<double>(v);
+	}
+	StringBuilder& operator<<(double v)
+	{
+		char buff[64];
+		int const len = std::snprintf(buff, sizeof(buff), show_point_ ? "%#g" : "%g", v);
+		str_.append(buff, len);
+		return *this;
+	}
+
+private:
+	std::string& str_;
+	bool show_point_ = false;
+};
+
+#endif		// _DXBC2GLSL_STRINGBUILDER_HPP
@@ -29,18 +29,74 @@
  */
 
 #include <DXBC2GLSL/DXBC2GLSL.hpp>
-#include <KFL/CustomizedStreamBuf.hpp>
+#include <KFL/CXX20/span.hpp>
+#include <KFL/Hash.hpp>
 #include <DXBC2GLSL/DXBC.hpp>
 #include <DXBC2GLSL/GLSLGen.hpp>
-#include <sstream>
+#include <DXBC2GLSL/StringBuilder.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	// The cache starts over when it's full. Effects of a game rarely have this many distinct shaders.
+	size_t constexpr MAX_CACHED_TRANSLATIONS = 4096;
+}
 
 namespace DXBC2GLSL
 {
+	struct DXBC2GLSL::Translation
+	{
+		// The parsed shader points into this copy of the blob
+		std::vector<uint8_t> dxbc_data;
+		bool has_gs;
+		bool has_ps;
+		ShaderTessellatorPartitioning ds_partitioning;
+		ShaderTessellatorOutputPrimitive ds_output_primitive;
+		GLSLVersion version;
+		uint32_t glsl_rules;
+
+		std::shared_ptr<DXBCContainer> dxbc;
+		std::shared_ptr<ShaderProgram> shader;
+		std::string glsl;
+
+		bool Matches(std::span<uint8_t const> rhs_dxbc_data,
+			bool rhs_has_gs, bool rhs_has_ps, ShaderTessellatorPartitioning rhs_ds_partitioning,
+			ShaderTessellatorOutputPrimitive rhs_ds_output_primitive, GLSLVersion rhs_version, uint32_t rhs_glsl_rules) const
+		{
+			return (has_gs == rhs_has_gs) && (has_ps == rhs_has_ps) && (ds_partitioning == rhs_ds_partitioning)
+				&& (ds_output_primitive == rhs_ds_output_primitive) && (version == rhs_version) && (glsl_rules == rhs_glsl_rules)
+				&& std::equal(dxbc_data.begin(), dxbc_data.end(), rhs_dxbc_data.begin(), rhs_dxbc_data.end());
+		}
+	};
+
+	struct DXBC2GLSL::TranslationCache
+	{
+		std::mutex mutex;
+		std::unordered_map<size_t, std::shared_ptr<Translation const>> translations;
+
+		static TranslationCache& Instance()
+		{
+			static TranslationCache cache;
+			return cache;
+		}
+	};
+
 	uint32_t DXBC2GLSL::DefaultRules(GLSLVersion version)
 	{
 		return GLSLGen::DefaultRules(version);
 	}
 
+	void DXBC2GLSL::ClearCache()
+	{
+		auto& cache = TranslationCache::Instance();
+		std::lock_guard<std::mutex> lock(cache.mutex);
+		cache.translations.clear();
+	}
+
 	void DXBC2GLSL::FeedDXBC(void const * dxbc_data,
 			bool has_gs, bool has_ps, ShaderTessellatorPartitioning ds_partitioning, ShaderTessellatorOutputPrimitive ds_output_primitive,
 			GLSLVersion version)
@@ -52,26 +108,80 @@ namespace DXBC2GLSL
 			bool has_gs, bool has_ps, ShaderTessellatorPartitioning ds_partitioning, ShaderTessellatorOutputPrimitive ds_output_primitive,
 			GLSLVersion version, uint32_t glsl_rules)
 	{
-		dxbc_ = DXBCParse(dxbc_data);
-		if (dxbc_)
+		DXBCContainerHeader const * header = static_cast<DXBCContainerHeader const *>(dxbc_data);
+		if (KlayGE::LE2Native(header->fourcc) != FOURCC_DXBC)
+		{
+			// Nothing from the shader fed before is left to be queried
+			translation_.reset();
+			shader_.reset();
+			return;
+		}
+
+		std::span<uint8_t const> const dxbc(static_cast<uint8_t const *>(dxbc_data), KlayGE::LE2Native(header->total_size));
+		size_t key = KlayGE::HashValue(dxbc);
+		KlayGE::HashCombine(key, has_gs);
+		KlayGE::HashCombine(key, has_ps);
+		KlayGE::HashCombine(key, ds_partitioning);
+		KlayGE::HashCombine(key, ds_output_primitive);
+		KlayGE::HashCombine(key, version);
+		KlayGE::HashCombine(key, glsl_rules);
+
+		auto& cache = TranslationCache::Instance();
 		{
-			if (dxbc_->shader_chunk)
+			std::lock_guard<std::mutex> lock(cache.mutex);
+			auto iter = cache.translations.find(key);
+			if ((iter != cache.translations.end())
+				&& iter->second->Matches(dxbc, has_gs, has_ps, ds_partitioning, ds_output_primitive, version, glsl_rules))
 			{
-				shader_ = ShaderParse(*dxbc_);
+				translation_ = iter->second;
+				shader_ = translation_->shader;
+				return;
+			}
+		}
+
+		// Translated without holding the lock. Threads that miss the same shader at the same time all translate it.
+		auto translation = KlayGE::MakeSharedPtr<Translation>();
+		translation->dxbc_data.assign(dxbc.begin(), dxbc.end());
+		translation->has_gs = has_gs;
+		translation->has_ps = has_ps;
+		translation->ds_partitioning = ds_partitioning;
+		translation->ds_output_primitive = ds_output_primitive;
+		translation->version = version;
+		translation->glsl_rules = glsl_rules;
 
-				KlayGE::StringOutputStreamBuf glsl_buff(glsl_);
-				std::ostream ss(&glsl_buff);
+		translation->dxbc = DXBCParse(translation->dxbc_data.data());
+		if (translation->dxbc->shader_chunk)
+		{
+			translation->shader = ShaderParse(*translation->dxbc);
+
+			// A guess that avoids most of the reallocations. The extra space is given back once the code is complete.
+			translation->glsl.reserve(dxbc.size() * 2);
+			StringBuilder sb(translation->glsl);
+
+			GLSLGen converter;
+			converter.FeedDXBC(translation->shader, has_gs, has_ps, ds_partitioning, ds_output_primitive, version, glsl_rules);
+			converter.ToGLSL(sb);
+
+			translation->glsl.shrink_to_fit();
+		}
 
-				GLSLGen converter;
-				converter.FeedDXBC(shader_, has_gs, has_ps, ds_partitioning, ds_output_primitive, version, glsl_rules);
-				converter.ToGLSL(ss);
+		{
+			std::lock_guard<std::mutex> lock(cache.mutex);
+			if (cache.translations.size() >= MAX_CACHED_TRANSLATIONS)
+			{
+				cache.translations.clear();
 			}
+			cache.translations[key] = translation;
 		}
+
+		translation_ = std::move(translation);
+		shader_ = translation_->shader;
 	}
 
 	std::string const & DXBC2GLSL::GLSLString() const
 	{
-		return glsl_;
+		static std::string const empty;
+		return translation_ ? translation_->glsl : empty;
 	}
 
 	uint32_t DXBC2GLSL::NumInputParams() const
@@ -29,9 +29,17 @@
  */
 
 #include <DXBC2GLSL/DXBC2GLSL.hpp>
+#include <KFL/Thread.hpp>
+#include <KFL/Timer.hpp>
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
 #include <iostream>
 #include <fstream>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace
 {
@@ -43,8 +51,100 @@ namespace
 		std::cerr << "Latest version available from http://www.klayge.org/\n";
 		std::cerr << "\n";
 		std::cerr << "Usage: DXBC2GLSLCmd FILE [OUTPUT]\n";
+		std::cerr << "       DXBC2GLSLCmd -b DIR [OUTPUT_DIR] [-j JOBS]\n";
+		std::cerr << "\n";
+		std::cerr << "Batch mode converts every bytecode file under DIR, JOBS at a time (default: one per hardware thread).\n";
 		std::cerr << std::endl;
 	}
+
+	// Converts the files on num_jobs threads, and reports how many shaders per second are converted
+	int BatchConvert(std::filesystem::path const & input_dir, std::filesystem::path const & output_dir, uint32_t num_jobs)
+	{
+		std::vector<std::filesystem::path> files;
+		for (auto const & entry : std::filesystem::recursive_directory_iterator(input_dir))
+		{
+			if (entry.is_regular_file())
+			{
+				files.push_back(entry.path());
+			}
+		}
+
+		std::atomic<uint32_t> next_file(0);
+		std::atomic<uint32_t> num_converted(0);
+		std::atomic<uint32_t> num_skipped(0);
+		std::atomic<uint32_t> num_failed(0);
+		std::mutex output_mutex;
+
+		auto convert_files = [&]()
+		{
+			std::vector<char> data;
+			for (uint32_t i = next_file ++; i < files.size(); i = next_file ++)
+			{
+				std::filesystem::path const & file = files[i];
+
+				std::ifstream in(file, std::ios_base::in | std::ios_base::binary);
+				data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+				DXBCContainerHeader const * header = reinterpret_cast<DXBCContainerHeader const *>(data.data());
+				if ((data.size() < sizeof(DXBCContainerHeader)) || (KlayGE::LE2Native(header->fourcc) != FOURCC_DXBC)
+					|| (KlayGE::LE2Native(header->total_size) > data.size()))
+				{
+					++ num_skipped;
+					continue;
+				}
+
+				try
+				{
+					DXBC2GLSL::DXBC2GLSL dxbc2glsl;
+					dxbc2glsl.FeedDXBC(data.data(), true, true, STP_Fractional_Odd, STOP_Triangle_CW, GSV_430);
+
+					if (!output_dir.empty())
+					{
+						std::filesystem::path output_file = output_dir / std::filesystem::relative(file, input_dir);
+						output_file += ".glsl";
+
+						std::error_code ec;
+						std::filesystem::create_directories(output_file.parent_path(), ec);
+						std::ofstream out(output_file);
+						out << dxbc2glsl.GLSLString();
+					}
+
+					++ num_converted;
+				}
+				catch (std::exception& ex)
+				{
+					std::lock_guard<std::mutex> lock(output_mutex);
+					std::cout << "Error(s) in converting " << file.string() << ":" << std::endl;
+					std::cout << ex.what() << std::endl;
+
+					++ num_failed;
+				}
+			}
+		};
+
+		KlayGE::Timer timer;
+
+		// The calling thread is one of the jobs. Each of them pulls files until none are left.
+		KlayGE::ThreadPool tp(0, num_jobs - 1);
+		KlayGE::ParallelFor(tp, num_jobs, 1,
+			[&convert_files]([[maybe_unused]] uint32_t begin, [[maybe_unused]] uint32_t end)
+			{
+				convert_files();
+			},
+			num_jobs);
+
+		double const elapsed = timer.elapsed();
+
+		std::cout << num_converted << " shader(s) converted, " << num_failed << " failed, " << num_skipped << " skipped";
+		std::cout << " in " << elapsed << " s with " << num_jobs << " job(s)";
+		if (elapsed > 0)
+		{
+			std::cout << ", " << num_converted / elapsed << " shaders/s";
+		}
+		std::cout << std::endl;
+
+		return num_failed > 0 ? 1 : 0;
+	}
 } // namespace
 
 int main(int argc, char** argv)
@@ -55,6 +155,36 @@ int main(int argc, char** argv)
 		return 1;
 	}
 
+	if (std::string_view(argv[1]) == "-b")
+	{
+		if (argc < 3)
+		{
+			usage();
+			return 1;
+		}
+
+		std::filesystem::path output_dir;
+		uint32_t num_jobs = 0;
+		for (int i = 3; i < argc; ++ i)
+		{
+			if ((std::string_view(argv[i]) == "-j") && (i + 1 < argc))
+			{
+				num_jobs = static_cast<uint32_t>(std::stoul(argv[i + 1]));
+				++ i;
+			}
+			else
+			{
+				output_dir = argv[i];
+			}
+		}
+		if (num_jobs == 0)
+		{
+			num_jobs = std::max(std::thread::hardware_concurrency(), 1U);
+		}
+
+		return BatchConvert(argv[2], output_dir, num_jobs);
+	}
+
 	std::vector<char> data;
 	std::ifstream in(argv[1], std::ios_base::in | std::ios_base::binary);
 	std::ofstream out;
@@ -117,3 +117,9 @@
 #if defined(KLAYGE_COMPILER_MSVC) || defined(KLAYGE_COMPILER_GCC) || defined(KLAYGE_COMPILER_CLANG) || defined(KLAYGE_COMPILER_CLANGCL)
 	#define KLAYGE_HAS_STRUCT_PACK
 #endif
+
+#if defined(KLAYGE_COMPILER_MSVC) || defined(KLAYGE_COMPILER_CLANGCL)
+	#define KLAYGE_FORCEINLINE __forceinline
+#else
+	#define KLAYGE_FORCEINLINE inline __attribute__((always_inline))
+#endif
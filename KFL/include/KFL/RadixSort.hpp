@@ -0,0 +1,100 @@
+/**
+ * @file RadixSort.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KFL, a subproject of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#ifndef _KFL_RADIXSORT_HPP
+#define _KFL_RADIXSORT_HPP
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <KFL/CXX20/bit.hpp>
+
+namespace KlayGE
+{
+	// Maps a float to an unsigned integer with the same order, so floats can be radix sorted
+	inline uint32_t RadixSortKey(float v) noexcept
+	{
+		uint32_t const u = std::bit_cast<uint32_t>(v);
+		return (u & 0x80000000U) ? ~u : (u | 0x80000000U);
+	}
+
+	// Stable LSD radix sort of (key, value) pairs by key, one byte per pass. Bytes that are the same in every key are skipped.
+	template <typename Key, typename Value>
+	void RadixSort(std::vector<std::pair<Key, Value>>& items, std::vector<std::pair<Key, Value>>& scratch)
+	{
+		static_assert(std::is_unsigned_v<Key>);
+
+		uint32_t const num_items = static_cast<uint32_t>(items.size());
+		if (num_items <= 1)
+		{
+			return;
+		}
+
+		std::array<std::array<uint32_t, 256>, sizeof(Key)> histograms{};
+		for (auto const & item : items)
+		{
+			for (uint32_t d = 0; d < sizeof(Key); ++ d)
+			{
+				++ histograms[d][(item.first >> (d * 8)) & 0xFF];
+			}
+		}
+
+		scratch.resize(num_items);
+		for (uint32_t d = 0; d < sizeof(Key); ++ d)
+		{
+			auto& histogram = histograms[d];
+			if (histogram[(items[0].first >> (d * 8)) & 0xFF] == num_items)
+			{
+				continue;
+			}
+
+			uint32_t offset = 0;
+			for (auto& count : histogram)
+			{
+				uint32_t const c = count;
+				count = offset;
+				offset += c;
+			}
+
+			for (auto const & item : items)
+			{
+				scratch[histogram[(item.first >> (d * 8)) & 0xFF]++] = item;
+			}
+			items.swap(scratch);
+		}
+	}
+}
+
+#endif		// _KFL_RADIXSORT_HPP
@@ -39,6 +39,10 @@
 #include <string_view>
 #include <vector>
 
+#include <KFL/CXX20/span.hpp>
+#include <KFL/CustomizedStreamBuf.hpp>
+#include <KFL/Util.hpp>
+
 namespace KlayGE
 {
 	class ResIdentifier final
@@ -54,6 +58,14 @@ namespace KlayGE
 			: res_name_(std::move(name)), timestamp_(timestamp), istream_(is), streambuf_(streambuf)
 		{
 		}
+		// Contiguous in-memory resource, such as a memory mapped file or an extracted package item. data_owner keeps data alive.
+		ResIdentifier(std::string_view name, uint64_t timestamp,
+				std::span<uint8_t const> data, std::shared_ptr<void> const & data_owner)
+			: res_name_(std::move(name)), timestamp_(timestamp), data_(data), data_owner_(data_owner)
+		{
+			streambuf_ = MakeSharedPtr<MemInputStreamBuf>(data_.data(), static_cast<std::streamsize>(data_.size()));
+			istream_ = MakeSharedPtr<std::istream>(streambuf_.get());
+		}
 
 		void ResName(std::string_view name)
 		{
@@ -113,11 +125,21 @@ namespace KlayGE
 			return *istream_;
 		}
 
+		// The whole resource as a contiguous view, empty if it's only accessible as a stream.
+		// Readers can consume it in place instead of read() into temporary buffers.
+		std::span<uint8_t const> Data() const noexcept
+		{
+			return data_;
+		}
+
 	private:
 		std::string res_name_;
 		uint64_t timestamp_;
 		std::shared_ptr<std::istream> istream_;
 		std::shared_ptr<std::streambuf> streambuf_;
+
+		std::span<uint8_t const> data_;
+		std::shared_ptr<void> data_owner_;
 	};
 
 	using ResIdentifierPtr = std::shared_ptr<ResIdentifier>;
@@ -45,16 +45,31 @@ namespace KlayGE
 		constexpr SIMDMatrixF4() noexcept
 		{
 		}
-		explicit SIMDMatrixF4(float const * rhs);
+		explicit SIMDMatrixF4(float const * rhs)
+		{
+			m_[0] = SIMDMathLib::LoadVector4(rhs + 0);
+			m_[1] = SIMDMathLib::LoadVector4(rhs + 4);
+			m_[2] = SIMDMathLib::LoadVector4(rhs + 8);
+			m_[3] = SIMDMathLib::LoadVector4(rhs + 12);
+		}
 		constexpr SIMDMatrixF4(SIMDMatrixF4 const& rhs) : m_(rhs.m_)
 		{
 		}
 		SIMDMatrixF4(SIMDVectorF4 const & v1, SIMDVectorF4 const & v2,
-			SIMDVectorF4 const & v3, SIMDVectorF4 const & v4);
+			SIMDVectorF4 const & v3, SIMDVectorF4 const & v4)
+			: m_{v1, v2, v3, v4}
+		{
+		}
 		SIMDMatrixF4(float f11, float f12, float f13, float f14,
 			float f21, float f22, float f23, float f24,
 			float f31, float f32, float f33, float f34,
-			float f41, float f42, float f43, float f44);
+			float f41, float f42, float f43, float f44)
+		{
+			m_[0] = SIMDMathLib::SetVector(f11, f12, f13, f14);
+			m_[1] = SIMDMathLib::SetVector(f21, f22, f23, f24);
+			m_[2] = SIMDMathLib::SetVector(f31, f32, f33, f34);
+			m_[3] = SIMDMathLib::SetVector(f41, f42, f43, f44);
+		}
 
 		static constexpr size_t size()
 		{
@@ -64,27 +79,81 @@ namespace KlayGE
 		static SIMDMatrixF4 const & Zero();
 		static SIMDMatrixF4 const & Identity();
 
-		void Row(size_t index, SIMDVectorF4 const & rhs);
-		SIMDVectorF4 const & Row(size_t index) const;
-		void Col(size_t index, SIMDVectorF4 const & rhs);
-		SIMDVectorF4 const Col(size_t index) const;
+		void Row(size_t index, SIMDVectorF4 const & rhs)
+		{
+			m_[index] = rhs;
+		}
+		SIMDVectorF4 const & Row(size_t index) const
+		{
+			return m_[index];
+		}
+		void Col(size_t index, SIMDVectorF4 const & rhs)
+		{
+			m_[0] = SIMDMathLib::SetByIndex(m_[0], SIMDMathLib::GetByIndex(rhs, index), index);
+			m_[1] = SIMDMathLib::SetByIndex(m_[1], SIMDMathLib::GetByIndex(rhs, index), index);
+			m_[2] = SIMDMathLib::SetByIndex(m_[2], SIMDMathLib::GetByIndex(rhs, index), index);
+			m_[3] = SIMDMathLib::SetByIndex(m_[3], SIMDMathLib::GetByIndex(rhs, index), index);
+		}
+		SIMDVectorF4 const Col(size_t index) const
+		{
+			return SIMDMathLib::SetVector(SIMDMathLib::GetByIndex(m_[0], index),
+				SIMDMathLib::GetByIndex(m_[1], index),
+				SIMDMathLib::GetByIndex(m_[2], index),
+				SIMDMathLib::GetByIndex(m_[3], index));
+		}
 
-		void Set(size_t row, size_t col, float v);
-		float operator()(size_t row, size_t col) const;
+		void Set(size_t row, size_t col, float v)
+		{
+			this->Row(row, SIMDMathLib::SetByIndex(this->Row(row), v, col));
+		}
+		float operator()(size_t row, size_t col) const
+		{
+			return SIMDMathLib::GetByIndex(this->Row(row), col);
+		}
 
-		SIMDMatrixF4& operator+=(SIMDMatrixF4 const & rhs);
-		SIMDMatrixF4& operator-=(SIMDMatrixF4 const & rhs);
-		SIMDMatrixF4& operator*=(SIMDMatrixF4 const & rhs);
-		SIMDMatrixF4& operator*=(float rhs);
-		SIMDMatrixF4& operator/=(float rhs);
+		SIMDMatrixF4& operator+=(SIMDMatrixF4 const & rhs)
+		{
+			*this = SIMDMathLib::Add(*this, rhs);
+			return *this;
+		}
+		SIMDMatrixF4& operator-=(SIMDMatrixF4 const & rhs)
+		{
+			*this = SIMDMathLib::Substract(*this, rhs);
+			return *this;
+		}
+		SIMDMatrixF4& operator*=(SIMDMatrixF4 const & rhs)
+		{
+			*this = SIMDMathLib::Multiply(*this, rhs);
+			return *this;
+		}
+		SIMDMatrixF4& operator*=(float rhs)
+		{
+			*this = SIMDMathLib::Multiply(*this, rhs);
+			return *this;
+		}
+		SIMDMatrixF4& operator/=(float rhs)
+		{
+			*this = SIMDMathLib::Multiply(*this, 1.0f / rhs);
+			return *this;
+		}
 
-		SIMDMatrixF4& operator=(SIMDMatrixF4 const & rhs);
+		SIMDMatrixF4& operator=(SIMDMatrixF4 const & rhs)
+		{
+			if (this != &rhs)
+			{
+				m_ = rhs.m_;
+			}
+			return *this;
+		}
 
 		constexpr SIMDMatrixF4 const& operator+() const
 		{
 			return *this;
 		}
-		SIMDMatrixF4 const operator-() const;
+		SIMDMatrixF4 const operator-() const
+		{
+			return SIMDMathLib::Negative(*this);
+		}
 
 		KLAYGE_DEFAULT_ADD_OPERATOR1(SIMDMatrixF4);
 		KLAYGE_DEFAULT_SUB_OPERATOR1(SIMDMatrixF4);
@@ -30,6 +30,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <exception>
 #include <functional>
 #ifdef KLAYGE_COMPILER_MSVC
 #pragma warning(push)
@@ -40,6 +42,7 @@
 #pragma warning(pop)
 #endif
 #include <thread>
+#include <vector>
 
 #include <KFL/Noncopyable.hpp>
 
@@ -97,4 +100,51 @@ namespace KlayGE
 		class Impl;
 		std::unique_ptr<Impl> pimpl_;
 	};
+
+	// Splits [0, num_items) into contiguous ranges of at least min_items_per_task items, no more than max_tasks of them (0 means one
+	// per hardware thread), and calls func(begin, end) on each. The calling thread takes the first range, and returns when all of
+	// them are done. The first exception thrown by a range is rethrown after the others have finished.
+	template <typename Func>
+	void ParallelFor(ThreadPool& tp, uint32_t num_items, uint32_t min_items_per_task, Func const& func, uint32_t max_tasks = 0)
+	{
+		uint32_t num_threads = (max_tasks != 0) ? max_tasks : std::max(std::thread::hardware_concurrency(), 1U);
+		num_threads = std::min(num_threads, std::max(num_items / std::max(min_items_per_task, 1U), 1U));
+		if (num_threads <= 1)
+		{
+			func(0, num_items);
+			return;
+		}
+
+		uint32_t const items_per_thread = (num_items + num_threads - 1) / num_threads;
+		std::vector<std::future<void>> joiners;
+		for (uint32_t begin = items_per_thread; begin < num_items; begin += items_per_thread)
+		{
+			uint32_t const end = std::min(begin + items_per_thread, num_items);
+			joiners.emplace_back(tp.QueueThread([&func, begin, end] { func(begin, end); }));
+		}
+
+		// The workers reference func, so they have to be waited for even if the first range throws
+		std::exception_ptr first_exception;
+		try
+		{
+			func(0, std::min(items_per_thread, num_items));
+		}
+		catch (...)
+		{
+			first_exception = std::current_exception();
+		}
+
+		for (auto& joiner : joiners)
+		{
+			joiner.wait();
+		}
+		if (first_exception)
+		{
+			std::rethrow_exception(first_exception);
+		}
+		for (auto& joiner : joiners)
+		{
+			joiner.get();
+		}
+	}
 }
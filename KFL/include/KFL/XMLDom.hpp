@@ -203,6 +203,146 @@ namespace KlayGE
 		std::unique_ptr<Impl> pimpl_;
 	};
 
+	class XMLAttributeView;
+	class XMLDocument;
+
+	// Read-only node of an XMLDocument. Names and values point into the buffer of the document, which owns all its nodes.
+	// Child nodes are looked up by name in constant time.
+	class XMLNodeView final
+	{
+		friend class XMLDocument;
+
+		struct ChildSlot
+		{
+			size_t name_hash;
+			XMLNodeView const* first;
+			XMLNodeView const* last;
+		};
+
+	public:
+		XMLNodeView() noexcept = default;
+
+		std::string_view Name() const noexcept;
+		XMLNodeType Type() const noexcept;
+
+		XMLNodeView const* Parent() const noexcept;
+
+		XMLAttributeView const* FirstAttrib(std::string_view name) const noexcept;
+		XMLAttributeView const* NextAttrib(XMLAttributeView const& attrib, std::string_view name) const noexcept;
+		XMLAttributeView const* LastAttrib(std::string_view name) const noexcept;
+		XMLAttributeView const* FirstAttrib() const noexcept;
+		XMLAttributeView const* NextAttrib(XMLAttributeView const& attrib) const noexcept;
+		XMLAttributeView const* LastAttrib() const noexcept;
+
+		XMLAttributeView const* Attrib(std::string_view name) const noexcept;
+
+		bool TryConvertAttrib(std::string_view name, bool& val, bool default_val) const;
+		bool TryConvertAttrib(std::string_view name, int32_t& val, int32_t default_val) const;
+		bool TryConvertAttrib(std::string_view name, uint32_t& val, uint32_t default_val) const;
+		bool TryConvertAttrib(std::string_view name, float& val, float default_val) const;
+
+		bool AttribBool(std::string_view name, bool default_val) const;
+		int32_t AttribInt(std::string_view name, int32_t default_val) const;
+		uint32_t AttribUInt(std::string_view name, uint32_t default_val) const;
+		float AttribFloat(std::string_view name, float default_val) const;
+		std::string_view AttribString(std::string_view name, std::string_view default_val) const noexcept;
+
+		XMLNodeView const* FirstNode(std::string_view name) const noexcept;
+		XMLNodeView const* LastNode(std::string_view name) const noexcept;
+		XMLNodeView const* FirstNode() const noexcept;
+		XMLNodeView const* LastNode() const noexcept;
+
+		XMLNodeView const* PrevSibling(std::string_view name) const noexcept;
+		XMLNodeView const* NextSibling(std::string_view name) const noexcept;
+		XMLNodeView const* PrevSibling() const noexcept;
+		XMLNodeView const* NextSibling() const noexcept;
+
+		bool TryConvertValue(bool& val) const;
+		bool TryConvertValue(int32_t& val) const;
+		bool TryConvertValue(uint32_t& val) const;
+		bool TryConvertValue(float& val) const;
+
+		bool ValueBool() const;
+		int32_t ValueInt() const;
+		uint32_t ValueUInt() const;
+		float ValueFloat() const;
+		std::string_view ValueString() const noexcept;
+
+	private:
+		ChildSlot const* FindChildSlot(std::string_view name) const noexcept;
+
+	private:
+		XMLNodeType type_ = XMLNodeType::Element;
+		std::string_view name_;
+		std::string_view value_;
+
+		XMLNodeView const* parent_ = nullptr;
+		XMLNodeView const* first_child_ = nullptr;
+		XMLNodeView const* last_child_ = nullptr;
+		XMLNodeView const* prev_sibling_ = nullptr;
+		XMLNodeView const* next_sibling_ = nullptr;
+		XMLNodeView const* prev_same_name_ = nullptr;
+		XMLNodeView const* next_same_name_ = nullptr;
+
+		XMLAttributeView const* first_attr_ = nullptr;
+		XMLAttributeView const* last_attr_ = nullptr;
+
+		// Open addressing table from child names to the first and last child of each name
+		ChildSlot const* child_slots_ = nullptr;
+		uint32_t child_slot_mask_ = 0;
+	};
+
+	class XMLAttributeView final
+	{
+		friend class XMLDocument;
+
+	public:
+		XMLAttributeView() noexcept = default;
+
+		std::string_view Name() const noexcept;
+
+		XMLNodeView const* Parent() const noexcept;
+
+		XMLAttributeView const* NextAttrib(std::string_view name) const noexcept;
+		XMLAttributeView const* NextAttrib() const noexcept;
+
+		bool TryConvertValue(bool& val) const;
+		bool TryConvertValue(int32_t& val) const;
+		bool TryConvertValue(uint32_t& val) const;
+		bool TryConvertValue(float& val) const;
+
+		bool ValueBool() const;
+		int32_t ValueInt() const;
+		uint32_t ValueUInt() const;
+		float ValueFloat() const;
+		std::string_view ValueString() const noexcept;
+
+	private:
+		std::string_view name_;
+		std::string_view value_;
+
+		XMLNodeView const* parent_ = nullptr;
+		XMLAttributeView const* next_ = nullptr;
+	};
+
+	// Parses an XML file in place, for code that only reads it. Unlike LoadXml, no string is copied. All nodes and attributes
+	// are stored in a few arrays that live as long as the document.
+	class XMLDocument final
+	{
+		KLAYGE_NONCOPYABLE(XMLDocument);
+
+	public:
+		explicit XMLDocument(ResIdentifier& source);
+		~XMLDocument() noexcept;
+
+		// The root element, the same node LoadXml returns. nullptr for an empty file.
+		XMLNodeView const* Root() const noexcept;
+
+	private:
+		class Impl;
+		std::unique_ptr<Impl> pimpl_;
+	};
+
 	XMLNode LoadXml(ResIdentifier& source);
 	void SaveXml(XMLNode const& node, std::ostream& os);
 } // namespace KlayGE
@@ -30,6 +30,8 @@
 
 #include <KFL/KFL.hpp>
 
+#include <KFL/CXX20/bit.hpp>
+#include <KFL/Hash.hpp>
 #include <KFL/ResIdentifier.hpp>
 #include <KFL/StringUtil.hpp>
 #include <KFL/Util.hpp>
@@ -90,46 +92,40 @@ namespace
 		return ret;
 	}
 
-	XMLNode CreateXmlNodeFromRapidXmlNode(rapidxml::xml_node<char> const& node)
+	XMLNodeType XmlNodeTypeFromRapidXmlNodeType(rapidxml::node_type type)
 	{
-		XMLNodeType type;
-		switch (node.type())
+		switch (type)
 		{
 		case rapidxml::node_document:
-			type = XMLNodeType::Document;
-			break;
+			return XMLNodeType::Document;
 
 		case rapidxml::node_element:
-			type = XMLNodeType::Element;
-			break;
+			return XMLNodeType::Element;
 
 		case rapidxml::node_data:
-			type = XMLNodeType::Data;
-			break;
+			return XMLNodeType::Data;
 
 		case rapidxml::node_cdata:
-			type = XMLNodeType::CData;
-			break;
+			return XMLNodeType::CData;
 
 		case rapidxml::node_comment:
-			type = XMLNodeType::Comment;
-			break;
+			return XMLNodeType::Comment;
 
 		case rapidxml::node_declaration:
-			type = XMLNodeType::Declaration;
-			break;
+			return XMLNodeType::Declaration;
 
 		case rapidxml::node_doctype:
-			type = XMLNodeType::Doctype;
-			break;
+			return XMLNodeType::Doctype;
 
 		case rapidxml::node_pi:
 		default:
-			type = XMLNodeType::PI;
-			break;
+			return XMLNodeType::PI;
 		}
+	}
 
-		XMLNode ret(type, std::string_view(node.name(), node.name_size()));
+	XMLNode CreateXmlNodeFromRapidXmlNode(rapidxml::xml_node<char> const& node)
+	{
+		XMLNode ret(XmlNodeTypeFromRapidXmlNodeType(node.type()), std::string_view(node.name(), node.name_size()));
 		ret.Value(std::string_view(node.value(), node.value_size()));
 
 		for (auto* child = node.first_node(); child; child = child->next_sibling())
@@ -202,7 +198,7 @@ namespace
 		return ret;
 	}
 
-	bool TryConvertStringToValue(std::string const& value_str, int32_t& val)
+	bool TryConvertStringToValue(std::string_view value_str, int32_t& val)
 	{
 #ifdef KLAYGE_CXX17_LIBRARY_CHARCONV_SUPPORT
 		char const* str = value_str.data();
@@ -211,7 +207,7 @@ namespace
 #else
 		try
 		{
-			val = std::stol(value_str);
+			val = std::stol(std::string(value_str));
 			return true;
 		}
 		catch (...)
@@ -221,7 +217,7 @@ namespace
 #endif
 	}
 
-	bool TryConvertStringToValue(std::string const& value_str, uint32_t& val)
+	bool TryConvertStringToValue(std::string_view value_str, uint32_t& val)
 	{
 #ifdef KLAYGE_CXX17_LIBRARY_CHARCONV_SUPPORT
 		char const* str = value_str.data();
@@ -230,7 +226,7 @@ namespace
 #else
 		try
 		{
-			val = std::stoul(value_str);
+			val = std::stoul(std::string(value_str));
 			return true;
 		}
 		catch (...)
@@ -240,7 +236,7 @@ namespace
 #endif
 	}
 
-	bool TryConvertStringToValue(std::string const& value_str, float& val)
+	bool TryConvertStringToValue(std::string_view value_str, float& val)
 	{
 #ifdef KLAYGE_CXX17_LIBRARY_CHARCONV_FP_SUPPORT
 		char const* str = value_str.data();
@@ -249,7 +245,7 @@ namespace
 #else
 		try
 		{
-			val = std::stof(value_str);
+			val = std::stof(std::string(value_str));
 			return true;
 		}
 		catch (...)
@@ -259,9 +255,9 @@ namespace
 #endif
 	}
 
-	bool TryConvertStringToValue(std::string const& value_str, bool& val)
+	bool TryConvertStringToValue(std::string_view value_str, bool& val)
 	{
-		std::string lower_value_str = value_str;
+		std::string lower_value_str(value_str);
 		StringUtil::ToLower(lower_value_str);
 		if ((lower_value_str == "true") || (lower_value_str == "1"))
 		{
@@ -278,6 +274,18 @@ namespace
 			return false;
 		}
 	}
+
+	// rapidxml parses in place, so the buffer is always a mutable copy, with a null terminator
+	std::unique_ptr<char[]> ReadXmlSource(ResIdentifier& source)
+	{
+		source.seekg(0, std::ios_base::end);
+		size_t const len = static_cast<size_t>(source.tellg());
+		source.seekg(0, std::ios_base::beg);
+		auto xml_src = MakeUniquePtr<char[]>(len + 1);
+		source.read(&xml_src[0], len);
+		xml_src[len] = 0;
+		return xml_src;
+	}
 } // namespace
 
 namespace KlayGE
@@ -1270,14 +1278,521 @@ namespace KlayGE
 	}
 
 
+	std::string_view XMLNodeView::Name() const noexcept
+	{
+		return name_;
+	}
+
+	XMLNodeType XMLNodeView::Type() const noexcept
+	{
+		return type_;
+	}
+
+	XMLNodeView const* XMLNodeView::Parent() const noexcept
+	{
+		return parent_;
+	}
+
+	XMLAttributeView const* XMLNodeView::FirstAttrib(std::string_view name) const noexcept
+	{
+		for (auto* attr = first_attr_; attr; attr = attr->NextAttrib())
+		{
+			if (attr->Name() == name)
+			{
+				return attr;
+			}
+		}
+		return nullptr;
+	}
+
+	XMLAttributeView const* XMLNodeView::NextAttrib(XMLAttributeView const& attrib, std::string_view name) const noexcept
+	{
+		BOOST_ASSERT(attrib.Parent() == this);
+		return attrib.NextAttrib(name);
+	}
+
+	XMLAttributeView const* XMLNodeView::LastAttrib(std::string_view name) const noexcept
+	{
+		XMLAttributeView const* ret = nullptr;
+		for (auto* attr = first_attr_; attr; attr = attr->NextAttrib())
+		{
+			if (attr->Name() == name)
+			{
+				ret = attr;
+			}
+		}
+		return ret;
+	}
+
+	XMLAttributeView const* XMLNodeView::FirstAttrib() const noexcept
+	{
+		return first_attr_;
+	}
+
+	XMLAttributeView const* XMLNodeView::NextAttrib(XMLAttributeView const& attrib) const noexcept
+	{
+		BOOST_ASSERT(attrib.Parent() == this);
+		return attrib.NextAttrib();
+	}
+
+	XMLAttributeView const* XMLNodeView::LastAttrib() const noexcept
+	{
+		return last_attr_;
+	}
+
+	XMLAttributeView const* XMLNodeView::Attrib(std::string_view name) const noexcept
+	{
+		return this->FirstAttrib(name);
+	}
+
+	bool XMLNodeView::TryConvertAttrib(std::string_view name, bool& val, bool default_val) const
+	{
+		val = default_val;
+
+		auto attr = this->Attrib(std::move(name));
+		return attr ? attr->TryConvertValue(val) : true;
+	}
+
+	bool XMLNodeView::TryConvertAttrib(std::string_view name, int32_t& val, int32_t default_val) const
+	{
+		val = default_val;
+
+		auto attr = this->Attrib(std::move(name));
+		return attr ? attr->TryConvertValue(val) : true;
+	}
+
+	bool XMLNodeView::TryConvertAttrib(std::string_view name, uint32_t& val, uint32_t default_val) const
+	{
+		val = default_val;
+
+		auto attr = this->Attrib(std::move(name));
+		return attr ? attr->TryConvertValue(val) : true;
+	}
+
+	bool XMLNodeView::TryConvertAttrib(std::string_view name, float& val, float default_val) const
+	{
+		val = default_val;
+
+		auto attr = this->Attrib(std::move(name));
+		return attr ? attr->TryConvertValue(val) : true;
+	}
+
+	bool XMLNodeView::AttribBool(std::string_view name, bool default_val) const
+	{
+		auto attr = this->Attrib(std::move(name));
+		return attr ? attr->ValueBool() : default_val;
+	}
+
+	int32_t XMLNodeView::AttribInt(std::string_view name, int32_t default_val) const
+	{
+		auto attr = this->Attrib(std::move(name));
+		return attr ? attr->ValueInt() : default_val;
+	}
+
+	uint32_t XMLNodeView::AttribUInt(std::string_view name, uint32_t default_val) const
+	{
+		auto attr = this->Attrib(std::move(name));
+		return attr ? attr->ValueUInt() : default_val;
+	}
+
+	float XMLNodeView::AttribFloat(std::string_view name, float default_val) const
+	{
+		auto attr = this->Attrib(std::move(name));
+		return attr ? attr->ValueFloat() : default_val;
+	}
+
+	std::string_view XMLNodeView::AttribString(std::string_view name, std::string_view default_val) const noexcept
+	{
+		auto attr = this->Attrib(std::move(name));
+		return attr ? attr->ValueString() : default_val;
+	}
+
+	XMLNodeView const* XMLNodeView::FirstNode(std::string_view name) const noexcept
+	{
+		auto const* slot = this->FindChildSlot(name);
+		return slot ? slot->first : nullptr;
+	}
+
+	XMLNodeView const* XMLNodeView::LastNode(std::string_view name) const noexcept
+	{
+		auto const* slot = this->FindChildSlot(name);
+		return slot ? slot->last : nullptr;
+	}
+
+	XMLNodeView const* XMLNodeView::FirstNode() const noexcept
+	{
+		return first_child_;
+	}
+
+	XMLNodeView const* XMLNodeView::LastNode() const noexcept
+	{
+		return last_child_;
+	}
+
+	XMLNodeView const* XMLNodeView::PrevSibling(std::string_view name) const noexcept
+	{
+		if (name == name_)
+		{
+			return prev_same_name_;
+		}
+
+		for (auto* node = prev_sibling_; node; node = node->prev_sibling_)
+		{
+			if (node->name_ == name)
+			{
+				return node;
+			}
+		}
+		return nullptr;
+	}
+
+	XMLNodeView const* XMLNodeView::NextSibling(std::string_view name) const noexcept
+	{
+		if (name == name_)
+		{
+			return next_same_name_;
+		}
+
+		for (auto* node = next_sibling_; node; node = node->next_sibling_)
+		{
+			if (node->name_ == name)
+			{
+				return node;
+			}
+		}
+		return nullptr;
+	}
+
+	XMLNodeView const* XMLNodeView::PrevSibling() const noexcept
+	{
+		return prev_sibling_;
+	}
+
+	XMLNodeView const* XMLNodeView::NextSibling() const noexcept
+	{
+		return next_sibling_;
+	}
+
+	bool XMLNodeView::TryConvertValue(bool& val) const
+	{
+		return TryConvertStringToValue(value_, val);
+	}
+
+	bool XMLNodeView::TryConvertValue(int32_t& val) const
+	{
+		return TryConvertStringToValue(value_, val);
+	}
+
+	bool XMLNodeView::TryConvertValue(uint32_t& val) const
+	{
+		return TryConvertStringToValue(value_, val);
+	}
+
+	bool XMLNodeView::TryConvertValue(float& val) const
+	{
+		return TryConvertStringToValue(value_, val);
+	}
+
+	bool XMLNodeView::ValueBool() const
+	{
+		bool val = false;
+		this->TryConvertValue(val);
+		return val;
+	}
+
+	int32_t XMLNodeView::ValueInt() const
+	{
+		int32_t val = 0;
+		this->TryConvertValue(val);
+		return val;
+	}
+
+	uint32_t XMLNodeView::ValueUInt() const
+	{
+		uint32_t val = 0;
+		this->TryConvertValue(val);
+		return val;
+	}
+
+	float XMLNodeView::ValueFloat() const
+	{
+		float val = 0;
+		this->TryConvertValue(val);
+		return val;
+	}
+
+	std::string_view XMLNodeView::ValueString() const noexcept
+	{
+		return value_;
+	}
+
+	XMLNodeView::ChildSlot const* XMLNodeView::FindChildSlot(std::string_view name) const noexcept
+	{
+		if (child_slots_ == nullptr)
+		{
+			return nullptr;
+		}
+
+		size_t const name_hash = HashValue(name);
+		for (uint32_t i = static_cast<uint32_t>(name_hash) & child_slot_mask_;; i = (i + 1) & child_slot_mask_)
+		{
+			auto const& slot = child_slots_[i];
+			if (slot.first == nullptr)
+			{
+				return nullptr;
+			}
+			if ((slot.name_hash == name_hash) && (slot.first->name_ == name))
+			{
+				return &slot;
+			}
+		}
+	}
+
+
+	std::string_view XMLAttributeView::Name() const noexcept
+	{
+		return name_;
+	}
+
+	XMLNodeView const* XMLAttributeView::Parent() const noexcept
+	{
+		return parent_;
+	}
+
+	XMLAttributeView const* XMLAttributeView::NextAttrib(std::string_view name) const noexcept
+	{
+		for (auto* attr = next_; attr; attr = attr->next_)
+		{
+			if (attr->name_ == name)
+			{
+				return attr;
+			}
+		}
+		return nullptr;
+	}
+
+	XMLAttributeView const* XMLAttributeView::NextAttrib() const noexcept
+	{
+		return next_;
+	}
+
+	bool XMLAttributeView::TryConvertValue(bool& val) const
+	{
+		return TryConvertStringToValue(value_, val);
+	}
+
+	bool XMLAttributeView::TryConvertValue(int32_t& val) const
+	{
+		return TryConvertStringToValue(value_, val);
+	}
+
+	bool XMLAttributeView::TryConvertValue(uint32_t& val) const
+	{
+		return TryConvertStringToValue(value_, val);
+	}
+
+	bool XMLAttributeView::TryConvertValue(float& val) const
+	{
+		return TryConvertStringToValue(value_, val);
+	}
+
+	bool XMLAttributeView::ValueBool() const
+	{
+		bool val = false;
+		this->TryConvertValue(val);
+		return val;
+	}
+
+	int32_t XMLAttributeView::ValueInt() const
+	{
+		int32_t val = 0;
+		this->TryConvertValue(val);
+		return val;
+	}
+
+	uint32_t XMLAttributeView::ValueUInt() const
+	{
+		uint32_t val = 0;
+		this->TryConvertValue(val);
+		return val;
+	}
+
+	float XMLAttributeView::ValueFloat() const
+	{
+		float val = 0;
+		this->TryConvertValue(val);
+		return val;
+	}
+
+	std::string_view XMLAttributeView::ValueString() const noexcept
+	{
+		return value_;
+	}
+
+
+	class XMLDocument::Impl final
+	{
+	public:
+		explicit Impl(ResIdentifier& source) : xml_src_(ReadXmlSource(source))
+		{
+			rapidxml::xml_document<char> doc;
+			doc.parse<0>(xml_src_.get());
+
+			auto const* root = doc.first_node();
+			if (root != nullptr)
+			{
+				// Counted first, so the arrays are allocated once and never move
+				uint32_t num_nodes = 0;
+				uint32_t num_attrs = 0;
+				uint32_t num_child_slots = 0;
+				CountNodes(*root, num_nodes, num_attrs, num_child_slots);
+
+				nodes_.reserve(num_nodes);
+				attrs_.reserve(num_attrs);
+				child_slots_.reserve(num_child_slots);
+
+				this->BuildNode(*root, nullptr);
+			}
+		}
+
+		XMLNodeView const* Root() const noexcept
+		{
+			return nodes_.empty() ? nullptr : &nodes_[0];
+		}
+
+	private:
+		// The table of a node is at most half full
+		static uint32_t NumChildSlots(uint32_t num_children) noexcept
+		{
+			return (num_children == 0) ? 0 : std::bit_ceil(num_children * 2);
+		}
+
+		static void CountNodes(
+			rapidxml::xml_node<char> const& node, uint32_t& num_nodes, uint32_t& num_attrs, uint32_t& num_child_slots) noexcept
+		{
+			++num_nodes;
+			for (auto* attr = node.first_attribute(); attr; attr = attr->next_attribute())
+			{
+				++num_attrs;
+			}
+
+			uint32_t num_children = 0;
+			for (auto* child = node.first_node(); child; child = child->next_sibling())
+			{
+				CountNodes(*child, num_nodes, num_attrs, num_child_slots);
+				++num_children;
+			}
+			num_child_slots += NumChildSlots(num_children);
+		}
+
+		XMLNodeView& BuildNode(rapidxml::xml_node<char> const& src_node, XMLNodeView const* parent)
+		{
+			XMLNodeView& node = nodes_.emplace_back();
+			node.type_ = XmlNodeTypeFromRapidXmlNodeType(src_node.type());
+			node.name_ = std::string_view(src_node.name(), src_node.name_size());
+			node.value_ = std::string_view(src_node.value(), src_node.value_size());
+			node.parent_ = parent;
+
+			XMLAttributeView* prev_attr = nullptr;
+			for (auto* src_attr = src_node.first_attribute(); src_attr; src_attr = src_attr->next_attribute())
+			{
+				XMLAttributeView& attr = attrs_.emplace_back();
+				attr.name_ = std::string_view(src_attr->name(), src_attr->name_size());
+				attr.value_ = std::string_view(src_attr->value(), src_attr->value_size());
+				attr.parent_ = &node;
+
+				if (prev_attr)
+				{
+					prev_attr->next_ = &attr;
+				}
+				else
+				{
+					node.first_attr_ = &attr;
+				}
+				prev_attr = &attr;
+			}
+			node.last_attr_ = prev_attr;
+
+			uint32_t num_children = 0;
+			for (auto* child = src_node.first_node(); child; child = child->next_sibling())
+			{
+				++num_children;
+			}
+			if (num_children == 0)
+			{
+				return node;
+			}
+
+			uint32_t const num_child_slots = NumChildSlots(num_children);
+			size_t const slot_offset = child_slots_.size();
+			child_slots_.resize(slot_offset + num_child_slots, XMLNodeView::ChildSlot{0, nullptr, nullptr});
+			auto* slots = &child_slots_[slot_offset];
+			node.child_slots_ = slots;
+			node.child_slot_mask_ = num_child_slots - 1;
+
+			XMLNodeView* prev_child = nullptr;
+			for (auto* src_child = src_node.first_node(); src_child; src_child = src_child->next_sibling())
+			{
+				XMLNodeView& child = this->BuildNode(*src_child, &node);
+
+				if (prev_child)
+				{
+					prev_child->next_sibling_ = &child;
+					child.prev_sibling_ = prev_child;
+				}
+				else
+				{
+					node.first_child_ = &child;
+				}
+				prev_child = &child;
+
+				size_t const name_hash = HashValue(child.name_);
+				for (uint32_t i = static_cast<uint32_t>(name_hash) & node.child_slot_mask_;; i = (i + 1) & node.child_slot_mask_)
+				{
+					auto& slot = slots[i];
+					if (slot.first == nullptr)
+					{
+						slot = XMLNodeView::ChildSlot{name_hash, &child, &child};
+						break;
+					}
+					if ((slot.name_hash == name_hash) && (slot.first->name_ == child.name_))
+					{
+						// Only the last node of a name is written to, the earlier ones are already built
+						auto& last = nodes_[slot.last - nodes_.data()];
+						last.next_same_name_ = &child;
+						child.prev_same_name_ = &last;
+						slot.last = &child;
+						break;
+					}
+				}
+			}
+			node.last_child_ = prev_child;
+
+			return node;
+		}
+
+	private:
+		std::unique_ptr<char[]> xml_src_;
+		std::vector<XMLNodeView> nodes_;
+		std::vector<XMLAttributeView> attrs_;
+		std::vector<XMLNodeView::ChildSlot> child_slots_;
+	};
+
+	XMLDocument::XMLDocument(ResIdentifier& source) : pimpl_(MakeUniquePtr<Impl>(source))
+	{
+	}
+
+	XMLDocument::~XMLDocument() noexcept = default;
+
+	XMLNodeView const* XMLDocument::Root() const noexcept
+	{
+		return pimpl_->Root();
+	}
+
+
 	XMLNode LoadXml(ResIdentifier& source)
 	{
-		source.seekg(0, std::ios_base::end);
-		size_t const len = static_cast<size_t>(source.tellg());
-		source.seekg(0, std::ios_base::beg);
-		auto xml_src = MakeUniquePtr<char[]>(len + 1);
-		source.read(&xml_src[0], len);
-		xml_src[len] = 0;
+		auto xml_src = ReadXmlSource(source);
 
 		rapidxml::xml_document<char> doc;
 		doc.parse<0>(xml_src.get());
@@ -47,7 +47,7 @@ namespace KlayGE
 		{
 			if (e < -10)
 			{
-				value_ = 0;
+				value_ = static_cast<uint16_t>(s);
 			}
 			else
 			{
@@ -66,6 +66,10 @@ namespace KlayGE
 			if (0xFF - (127 - 15) == e)
 			{
 				e = 31;
+				if (m != 0)
+				{
+					m |= 0x00400000;	// keep NaNs NaN when the low significand bits are dropped
+				}
 			}
 			else
 			{
@@ -79,6 +83,12 @@ namespace KlayGE
 						e += 1;		// adjust exponent
 					}
 				}
+
+				if (e > 30)
+				{
+					e = 31;		// overflow to infinity
+					m = 0;
+				}
 			}
 
 			value_ = static_cast<uint16_t>(s | (e << 10) | (m >> 13));
@@ -108,16 +118,18 @@ namespace KlayGE
 				e += 1;
 				m &= ~0x00000400;
 			}
+			else
+			{
+				// Zero
+				return std::bit_cast<float>(s);
+			}
 		}
 		else
 		{
 			if (31 == e)
 			{
-				if (m != 0)
-				{
-					// Nan -- preserve sign and significand bits
-					e = 0xFF - (127 - 15);
-				}
+				// Inf or Nan -- preserve sign and significand bits
+				e = 0xFF - (127 - 15);
 			}
 		}
 
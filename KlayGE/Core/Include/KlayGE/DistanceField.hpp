@@ -35,6 +35,8 @@
 
 #include <vector>
 
+#include <KFL/CXX20/span.hpp>
+
 namespace KlayGE
 {
 	template <typename T>
@@ -43,6 +45,20 @@ namespace KlayGE
 
 	KLAYGE_CORE_API void ComputeDistance(std::vector<float> const & aa_2x_data, uint32_t input_width, uint32_t input_height,
 		std::vector<float>& dist_data);
+
+	// Exact squared Euclidean distance transform of a sampled function, in voxels. Feature samples are usually 0, the rest has to be
+	// infinity. It runs in place, and leaves infinity where there is no feature at all. If nearest isn't empty, it receives the
+	// linear index of the sample each distance is measured to, or -1.
+	KLAYGE_CORE_API void SquaredDistanceTransform(std::span<float> sq_dist, std::span<int32_t> nearest,
+		uint32_t width, uint32_t height, uint32_t depth);
+
+	// Euclidean distance from every voxel to the nearest non-zero one of the volume, in voxels
+	KLAYGE_CORE_API void ComputeBinaryDistance(std::span<uint8_t const> volume, uint32_t width, uint32_t height, uint32_t depth,
+		std::vector<float>& dist_data);
+
+	// Maps distances in [0, max_dist] to the full range of the output, truncating
+	KLAYGE_CORE_API void QuantizeDistance(std::span<float const> dist, float max_dist, std::span<uint8_t> output);
+	KLAYGE_CORE_API void QuantizeDistance(std::span<float const> dist, float max_dist, std::span<uint16_t> output);
 }
 
 #endif		// _KLAYGE_DISTANCE_FIELD_HPP
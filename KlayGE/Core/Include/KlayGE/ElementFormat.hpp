@@ -672,6 +672,10 @@ namespace KlayGE
 
 	KLAYGE_CORE_API void ConvertToABGR32F(ElementFormat fmt, void const * input, uint32_t num_elems, Color* output);
 	KLAYGE_CORE_API void ConvertFromABGR32F(ElementFormat fmt, Color const * input, uint32_t num_elems, void* output);
+	// Same result as ConvertToABGR32F followed by ConvertFromABGR32F. Formats that only differ in channel order or color space
+	// convert directly, the others go through a small buffer of colors.
+	KLAYGE_CORE_API void ConvertFormat(ElementFormat src_fmt, void const * input, ElementFormat dst_fmt, void* output,
+		uint32_t num_elems);
 
 
 	enum ElementAccessHint
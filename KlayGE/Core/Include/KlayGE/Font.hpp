@@ -38,16 +38,83 @@
 
 #include <KFL/Noncopyable.hpp>
 #include <KFL/Rect.hpp>
+#include <KFL/Vector.hpp>
 #include <KlayGE/Renderable.hpp>
 
+#include <array>
 #include <list>
 #include <memory>
+#include <optional>
+#include <unordered_map>
 #include <vector>
 
 namespace KlayGE
 {
 	class FontRenderable;
 
+	// Places glyphs in a square distance texture. Slots have one of GLYPH_SIZE_CLASSES sizes in each dimension, with a texel to
+	// spare, so freed slots are reused without searching. New slots are packed on shelves, one open shelf per height. When the
+	// texture is full, the least recently used glyphs are evicted.
+	class KLAYGE_CORE_API GlyphAtlas final
+	{
+	public:
+		static uint32_t constexpr GLYPH_SIZE_CLASSES = 4;
+
+		struct Glyph
+		{
+			Rect rc;
+
+			int2 slot;
+			uint32_t w_class;
+			uint32_t h_class;
+		};
+
+	public:
+		GlyphAtlas(uint32_t tex_size, uint32_t char_size);
+
+		// Glyphs touched or inserted since the last call are in use by the current text, and are never evicted for it
+		void BeginText();
+
+		Glyph const* Find(wchar_t ch) const;
+		// Marks a resident glyph as used by the current text. Returns nullptr if it isn't resident.
+		Glyph const* Touch(wchar_t ch);
+		// Returns nullptr if the glyph doesn't fit, even after evicting all glyphs that aren't used by the current text.
+		// evicted is set when some glyphs were evicted to make room.
+		Glyph const* Insert(wchar_t ch, uint32_t width, uint32_t height, bool& evicted);
+
+		uint32_t SlotSize(uint32_t size_class) const noexcept;
+		uint32_t SlotSizeClass(uint32_t glyph_size) const noexcept;
+
+		uint32_t NumGlyphs() const noexcept
+		{
+			return static_cast<uint32_t>(glyphs_.size());
+		}
+
+	private:
+		bool AllocSlot(Glyph& glyph);
+		void Reset();
+
+	private:
+		struct Entry
+		{
+			Glyph glyph;
+			uint64_t tick;
+			std::list<wchar_t>::iterator lru_iter;
+		};
+
+		uint32_t tex_size_;
+		uint32_t char_size_;
+
+		std::unordered_map<wchar_t, Entry> glyphs_;
+		// Most recently used first
+		std::list<wchar_t> lru_;
+		uint64_t tick_ = 0;
+
+		std::array<std::array<std::vector<int2>, GLYPH_SIZE_CLASSES>, GLYPH_SIZE_CLASSES> free_slots_;
+		std::array<std::optional<int2>, GLYPH_SIZE_CLASSES> open_shelves_;
+		uint32_t next_shelf_y_ = 0;
+	};
+
 	// 3Dл
 	/////////////////////////////////////////////////////////////////////////////////
 	class KLAYGE_CORE_API Font final
@@ -86,9 +153,16 @@ namespace KlayGE
 			std::wstring_view text, float font_size, uint32_t align);
 		void RenderText(float4x4 const & mvp, Color const & clr, std::wstring_view text, float font_size);
 
+		// Starts decoding the glyphs of a text that is going to be rendered, so the first RenderText of it doesn't wait for them
+		void Prefetch(std::wstring_view text);
+
+	private:
+		void AddToOverlay();
+
 	private:
 		std::shared_ptr<FontRenderable> font_renderable_;
 		uint32_t fsn_attrib_;
+		std::shared_ptr<SceneNode> overlay_node_;
 	};
 
 	using FontPtr = std::shared_ptr<Font>;
@@ -57,6 +57,15 @@ namespace KlayGE
 		void Decode(std::vector<uint8_t>& output, ResIdentifierPtr const & res, uint64_t len, uint64_t original_len);
 		void Decode(std::vector<uint8_t>& output, std::span<uint8_t const> input, uint64_t original_len);
 		void Decode(void* output, std::span<uint8_t const> input, uint64_t original_len);
+
+		// Framed streams start with a table of frame offsets, followed by independent LZMA frames of frame_size bytes each. Frames are
+		// encoded and decoded in parallel on the thread pool, and a range of the original data only needs the frames that cover it.
+		static constexpr uint32_t DEFAULT_FRAME_SIZE = 1U << 20;
+
+		void EncodeFramed(std::vector<uint8_t>& output, std::span<uint8_t const> input, uint32_t frame_size = DEFAULT_FRAME_SIZE);
+		static uint64_t FramedOriginalLength(std::span<uint8_t const> input);
+		void DecodeFramed(std::vector<uint8_t>& output, std::span<uint8_t const> input);
+		void DecodeFramed(void* output, std::span<uint8_t const> input, uint64_t offset, uint64_t len);
 	};
 }
 
@@ -29,6 +29,7 @@
 
 #include <KlayGE/Renderable.hpp>
 #include <KlayGE/RenderLayout.hpp>
+#include <KFL/CXX20/span.hpp>
 #include <KFL/Math.hpp>
 #include <KFL/Noncopyable.hpp>
 #include <KlayGE/SceneNode.hpp>
@@ -49,6 +50,8 @@ namespace KlayGE
 	using RenderModelPtr = std::shared_ptr<RenderModel>;
 	class StaticMesh;
 	using StaticMeshPtr = std::shared_ptr<StaticMesh>;
+	class ModelLodStreamer;
+	using ModelLodStreamerPtr = std::shared_ptr<ModelLodStreamer>;
 
 	template <typename T>
 	inline StaticMeshPtr CreateMeshFactory(std::wstring_view name)
@@ -81,6 +84,18 @@ namespace KlayGE
 
 		void NumLods(uint32_t lods) override;
 		using Renderable::NumLods;
+		uint32_t StreamLod(uint32_t lod) override;
+
+		// The finest lod that has its streams bound. Finer lods of a streamed model are bound once the streamer loaded them.
+		uint32_t ResidentLod() const
+		{
+			return resident_lod_;
+		}
+		ModelLodStreamerPtr const & LodStreamer() const
+		{
+			return lod_streamer_;
+		}
+		void LodStreamer(ModelLodStreamerPtr const & streamer, uint32_t resident_lod);
 
 		virtual void PosBound(AABBox const & aabb);
 		using Renderable::PosBound;
@@ -158,6 +173,9 @@ namespace KlayGE
 		int32_t mtl_id_;
 
 		bool hw_res_ready_;
+
+		uint32_t resident_lod_;
+		ModelLodStreamerPtr lod_streamer_;
 	};
 
 	class KLAYGE_CORE_API RenderModel
@@ -302,6 +320,58 @@ namespace KlayGE
 		std::tuple<Quaternion, Quaternion, float> Frame(float frame) const;
 	};
 
+	// Key frame sets of all joints in flat arrays. Every key also keeps the screw motion to its next key, so a sample is a sin/cos and
+	// two dual quaternion products, done for 4 tracks at a time.
+	//
+	// Quantized tracks take 16 bytes a key instead. The rotation keeps its smallest three components, the translation and the scale are
+	// normalized to the range of the track, all in 16 bits. Keys are blended with nlerp and lerp, not sclerp.
+	class KLAYGE_CORE_API KeyFrameTracks final
+	{
+	public:
+		KeyFrameTracks();
+		explicit KeyFrameTracks(std::span<KeyFrameSet const> kfs, bool quantize = false);
+
+		uint32_t NumTracks() const noexcept
+		{
+			return static_cast<uint32_t>(track_first_keys_.size() - 1);
+		}
+		bool Quantized() const noexcept
+		{
+			return quantized_;
+		}
+
+		// Without quantizing, gives the same result as KeyFrameSet::Frame of every track. A frame before the first key holds the first
+		// key. cursors has one entry per track. It starts from 0 and keeps the key last sampled, so playing forward doesn't search.
+		void Sample(float frame, std::span<uint32_t> cursors, std::span<Quaternion> reals, std::span<Quaternion> duals,
+			std::span<float> scales) const;
+
+		std::vector<KeyFrameSet> ToKeyFrameSets() const;
+
+		// Only quantized tracks are streamed. Full precision ones are stored as key frame sets.
+		void StreamIn(ResIdentifier& res);
+		void StreamOut(std::ostream& os) const;
+
+		// The blend of quantized tracks, for tools to measure the error of dropping keys
+		static std::tuple<Quaternion, Quaternion, float> QuantizedBlend(Quaternion const& real0, Quaternion const& dual0, float scale0,
+			Quaternion const& real1, Quaternion const& dual1, float scale1, float factor);
+
+	private:
+		void QuantizeTrack(uint32_t track, KeyFrameSet const& kf);
+		uint32_t FindKey(uint32_t track, float frame, uint32_t& cursor, float& factor) const noexcept;
+		void SampleQuantized(float frame, std::span<uint32_t> cursors, std::span<Quaternion> reals, std::span<Quaternion> duals,
+			std::span<float> scales) const;
+
+	private:
+		std::vector<uint32_t> track_first_keys_;
+		std::vector<uint32_t> frame_ids_;
+		std::vector<float> key_data_;
+
+		bool quantized_ = false;
+		// Translation and scale of each track: minimums, then steps of one in 16 bits
+		std::vector<float> track_ranges_;
+		std::vector<uint16_t> quantized_keys_;
+	};
+
 	struct KLAYGE_CORE_API AABBKeyFrameSet
 	{
 		std::vector<uint32_t> frame_id;
@@ -348,16 +418,19 @@ namespace KlayGE
 		void AssignJoints(ForwardIterator first, ForwardIterator last)
 		{
 			joints_.assign(first, last);
+			parent_joint_indices_.clear();
 			this->UpdateBinds();
 		}
-		void AttachKeyFrameSets(std::shared_ptr<std::vector<KeyFrameSet>> const & kf)
-		{
-			key_frame_sets_ = kf;
-		}
-		std::shared_ptr<std::vector<KeyFrameSet>> const & GetKeyFrameSets() const
+		// The sets can't be edited after being attached, a copy with the edits is attached instead
+		void AttachKeyFrameSets(std::shared_ptr<std::vector<KeyFrameSet> const> const & kf);
+		std::shared_ptr<std::vector<KeyFrameSet> const> GetKeyFrameSets() const;
+		void AttachKeyFrameTracks(std::shared_ptr<KeyFrameTracks const> const& tracks);
+		std::shared_ptr<KeyFrameTracks const> const& GetKeyFrameTracks() const;
+		bool QuantizeKeyFrames() const
 		{
-			return key_frame_sets_;
+			return quantize_key_frames_;
 		}
+		void QuantizeKeyFrames(bool quantize);
 		uint32_t NumFrames() const
 		{
 			return num_frames_;
@@ -377,6 +450,9 @@ namespace KlayGE
 
 		float GetFrame() const;
 		void SetFrame(float frame);
+		// SetFrame on many models. The bones are built in parallel, one model per task, and only the effects are set on the
+		// calling thread. A model can't appear twice.
+		static void SetFrames(std::span<SkinnedModel* const> models, std::span<float const> frames);
 
 		void RebindJoints();
 		void UnbindJoints();
@@ -396,14 +472,29 @@ namespace KlayGE
 		void UpdateBinds();
 		void SetToEffect();
 
+	private:
+		void PoseJoints(float frame);
+		void ComputeBinds();
+
 	protected:
 		std::vector<JointComponentPtr> joints_;
 		std::vector<float4> bind_reals_;
 		std::vector<float4> bind_duals_;
 
-		std::shared_ptr<std::vector<KeyFrameSet>> key_frame_sets_;
+		// The tracks are made when the sets are attached. Models loaded with quantized key frames only have the tracks, and decode the
+		// sets on each query.
+		std::shared_ptr<std::vector<KeyFrameSet> const> key_frame_sets_;
+		std::shared_ptr<KeyFrameTracks const> key_frame_tracks_;
+		bool quantize_key_frames_;
 		float last_frame_;
 
+		std::vector<uint32_t> key_frame_cursors_;
+		std::vector<Quaternion> key_reals_;
+		std::vector<Quaternion> key_duals_;
+		std::vector<float> key_scales_;
+		// Index of the parent joint of every joint, or -1 for roots
+		std::vector<int32_t> parent_joint_indices_;
+
 		uint32_t num_frames_;
 		uint32_t frame_rate_;
 
@@ -441,7 +532,8 @@ namespace KlayGE
 		std::function<void(RenderModel&)> OnFinishLoading = nullptr,
 		std::function<RenderModelPtr(std::wstring_view, uint32_t)> CreateModelFactoryFunc = CreateModelFactory<RenderModel>,
 		std::function<StaticMeshPtr(std::wstring_view)> CreateMeshFactoryFunc = CreateMeshFactory<StaticMesh>);
-	KLAYGE_CORE_API RenderModelPtr LoadSoftwareModel(std::string_view model_name);
+	// With stream_lods, meshes start with the coarsest lod they all have. Finer lods are loaded by the mesh's LodStreamer on demand.
+	KLAYGE_CORE_API RenderModelPtr LoadSoftwareModel(std::string_view model_name, bool stream_lods = false);
 
 	KLAYGE_CORE_API void SaveModel(RenderModel const & model, std::string_view model_name);
 
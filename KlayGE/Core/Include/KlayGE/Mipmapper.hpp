@@ -49,6 +49,10 @@ namespace KlayGE
 		void BuildSubLevels(
 			TexturePtr const& texture, uint32_t array_index, uint32_t start_level, uint32_t num_levels, TextureFilter filter) const;
 
+	private:
+		void BuildSubLevelsOnCpu(
+			TexturePtr const& texture, uint32_t array_index, uint32_t start_level, uint32_t num_levels, TextureFilter filter) const;
+
 	private:
 		static uint32_t constexpr MAX_LEVELS = 6;
 
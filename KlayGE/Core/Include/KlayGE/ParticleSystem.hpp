@@ -33,10 +33,12 @@
 
 #pragma once
 
+#include <KFL/CXX20/span.hpp>
 #include <KFL/Math.hpp>
 #include <KFL/Noncopyable.hpp>
 #include <KlayGE/SceneNode.hpp>
 
+#include <future>
 #include <memory>
 #include <mutex>
 #include <random>
@@ -63,6 +65,54 @@ namespace KlayGE
 		float init_life;
 	};
 
+	// A run of particles stored attribute by attribute
+	struct ParticleBatch
+	{
+		std::span<float> pos_x;
+		std::span<float> pos_y;
+		std::span<float> pos_z;
+		std::span<float> vel_x;
+		std::span<float> vel_y;
+		std::span<float> vel_z;
+		std::span<float> life;
+		std::span<float> spin;
+		std::span<float> size;
+		std::span<float> alpha;
+		std::span<float> init_life;
+
+		uint32_t Size() const noexcept
+		{
+			return static_cast<uint32_t>(life.size());
+		}
+
+		Particle Get(uint32_t i) const noexcept
+		{
+			Particle par;
+			par.pos = float3(pos_x[i], pos_y[i], pos_z[i]);
+			par.vel = float3(vel_x[i], vel_y[i], vel_z[i]);
+			par.life = life[i];
+			par.spin = spin[i];
+			par.size = size[i];
+			par.alpha = alpha[i];
+			par.init_life = init_life[i];
+			return par;
+		}
+		void Set(uint32_t i, Particle const & par) const noexcept
+		{
+			pos_x[i] = par.pos.x();
+			pos_y[i] = par.pos.y();
+			pos_z[i] = par.pos.z();
+			vel_x[i] = par.vel.x();
+			vel_y[i] = par.vel.y();
+			vel_z[i] = par.vel.z();
+			life[i] = par.life;
+			spin[i] = par.spin;
+			size[i] = par.size;
+			alpha[i] = par.alpha;
+			init_life[i] = par.init_life;
+		}
+	};
+
 	class KLAYGE_CORE_API ParticleEmitter
 	{
 		KLAYGE_NONCOPYABLE(ParticleEmitter);
@@ -224,6 +274,8 @@ namespace KlayGE
 		virtual ParticleUpdaterPtr Clone() = 0;
 
 		virtual void Update(Particle& par, float elapse_time) = 0;
+		// Updates a run of particles at once. By default it calls the per-particle Update on each of them.
+		virtual void Update(ParticleBatch const & pars, float elapse_time);
 		virtual void SnapParams() = 0;
 
 	protected:
@@ -237,6 +289,7 @@ namespace KlayGE
 	{
 	public:
 		explicit ParticleSystem(uint32_t max_num_particles, bool sort_particles = false);
+		~ParticleSystem() noexcept;
 
 		ParticleSystemPtr Clone();
 
@@ -301,20 +354,11 @@ namespace KlayGE
 
 		uint32_t NumParticles() const
 		{
-			return static_cast<uint32_t>(particles_.size());
+			return max_num_particles_;
 		}
 		uint32_t NumActiveParticles() const;
 		uint32_t GetActiveParticleIndex(uint32_t i) const;
-		Particle const & GetParticle(uint32_t i) const
-		{
-			BOOST_ASSERT(i < particles_.size());
-			return particles_[i];
-		}
-		Particle& GetParticle(uint32_t i)
-		{
-			BOOST_ASSERT(i < particles_.size());
-			return particles_[i];
-		}
+		Particle GetParticle(uint32_t i) const;
 		void ClearParticles();
 
 		void ParticleAlphaFromTex(std::string const & tex_name);
@@ -341,6 +385,10 @@ namespace KlayGE
 		void SceneDepthTexture(TexturePtr const & depth_tex);
 
 	private:
+		ParticleBatch Particles(uint32_t first, uint32_t count);
+		uint32_t CompactParticles(uint32_t num_particles);
+
+		void WaitForUpdate();
 		void UpdateParticlesNoLock(float elapsed_time);
 		void UpdateParticleBufferNoLock();
 
@@ -351,10 +399,18 @@ namespace KlayGE
 		std::vector<ParticleEmitterPtr> emitters_;
 		std::vector<ParticleUpdaterPtr> updaters_;
 
-		std::vector<Particle> particles_;
-		std::vector<std::pair<uint32_t, float>> actived_particles_;
+		// Live particles are packed at the front of each attribute array
+		uint32_t max_num_particles_;
+		uint32_t num_live_particles_ = 0;
+		std::vector<float> particle_attribs_;
+
+		std::vector<uint32_t> actived_particles_;
+		std::vector<std::pair<uint32_t, uint32_t>> sort_items_;
+		std::vector<std::pair<uint32_t, uint32_t>> sort_scratch_;
 		mutable std::mutex actived_particles_mutex_;
 
+		std::future<void> update_future_;
+
 		float gravity_;
 		float3 force_;
 		float media_density_;
@@ -430,6 +486,7 @@ namespace KlayGE
 		}
 
 		void Update(Particle& par, float elapse_time) override;
+		void Update(ParticleBatch const & pars, float elapse_time) override;
 		void SnapParams() override;
 
 	private:
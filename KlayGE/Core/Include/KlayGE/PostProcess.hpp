@@ -29,6 +29,7 @@
 #include <vector>
 
 #include <KFL/CXX20/span.hpp>
+#include <KFL/Noncopyable.hpp>
 #include <KlayGE/RenderFactory.hpp>
 #include <KlayGE/FrameBuffer.hpp>
 #include <KlayGE/RenderableHelper.hpp>
@@ -198,6 +199,32 @@ namespace KlayGE
 	KLAYGE_CORE_API PostProcessPtr SyncLoadPostProcess(std::string_view ppml_name, std::string_view pp_name);
 	KLAYGE_CORE_API PostProcessPtr ASyncLoadPostProcess(std::string_view ppml_name, std::string_view pp_name);
 
+	// Loads a group of post processes on the loading threads at the same time, instead of one after another.
+	// The post processes are only assigned to the outputs in Join().
+	class KLAYGE_CORE_API PostProcessBatchLoader final
+	{
+		KLAYGE_NONCOPYABLE(PostProcessBatchLoader);
+
+	public:
+		PostProcessBatchLoader();
+		~PostProcessBatchLoader() noexcept;
+
+		// pp has to stay alive until Join() returns
+		void Add(std::string_view ppml_name, std::string_view pp_name, PostProcessPtr& pp);
+		// Runs the main thread stages of the loads until all of them are done
+		void Join();
+
+		uint32_t NumPostProcesses() const noexcept;
+		std::string const & PpmlName(uint32_t index) const noexcept;
+		std::string const & PostProcessName(uint32_t index) const noexcept;
+		// In seconds, from the creation of the loader. Valid after Join().
+		double ReadyTime(uint32_t index) const noexcept;
+
+	private:
+		class Impl;
+		std::unique_ptr<Impl> pimpl_;
+	};
+
 
 	class KLAYGE_CORE_API PostProcessChain : public PostProcess
 	{
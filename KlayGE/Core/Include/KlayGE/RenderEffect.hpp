@@ -57,6 +57,7 @@
 #include <KFL/CXX20/span.hpp>
 
 #include <algorithm>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -80,6 +81,11 @@ namespace KlayGE
 	class RenderPass;
 	using RenderPassPtr = std::shared_ptr<RenderPass>;
 
+#if KLAYGE_IS_DEV_PLATFORM
+	// A shader stage waiting to be compiled. See RenderEffect::CompileShaders.
+	using ShaderCompileJob = std::pair<ShaderStage, std::function<void()>>;
+#endif
+
 	enum RenderEffectDataType
 	{
 		REDT_bool = 0,
@@ -711,10 +717,15 @@ namespace KlayGE
 
 		void Load(std::span<std::string const> names);
 #if KLAYGE_IS_DEV_PLATFORM
-		void CompileShaders();
+		// Up to num_jobs shader stages are compiled at the same time, 0 means one per hardware thread
+		void CompileShaders(uint32_t num_jobs = 0);
 #endif
 		void CreateHwShaders();
 
+		// Counts the kfx files that were loaded as they are, and the ones that had to be rebuilt from their fxml sources
+		static uint32_t NumKfxCacheHits() noexcept;
+		static uint32_t NumKfxCacheMisses() noexcept;
+
 		RenderEffectPtr Clone();
 		void CloneInPlace(RenderEffect& dst_effect);
 		void Reclone(RenderEffect& dst_effect);
@@ -738,6 +749,9 @@ namespace KlayGE
 		RenderEffectParameter const* ParameterBySemantic(std::string_view semantic) const noexcept;
 		RenderEffectParameter* ParameterByName(std::string_view name) noexcept;
 		RenderEffectParameter const* ParameterByName(std::string_view name) const noexcept;
+		// Takes the hash of the name, usually a CtHash, so no string is hashed at runtime
+		RenderEffectParameter* ParameterByNameHash(size_t name_hash) noexcept;
+		RenderEffectParameter const* ParameterByNameHash(size_t name_hash) const noexcept;
 		RenderEffectParameter* ParameterByIndex(uint32_t n) noexcept;
 		RenderEffectParameter const* ParameterByIndex(uint32_t n) const noexcept;
 
@@ -746,6 +760,7 @@ namespace KlayGE
 			return static_cast<uint32_t>(cbuffers_.size());
 		}
 		RenderEffectConstantBuffer* CBufferByName(std::string_view name) const noexcept;
+		RenderEffectConstantBuffer* CBufferByNameHash(size_t name_hash) const noexcept;
 		RenderEffectConstantBuffer* CBufferByIndex(uint32_t index) const noexcept;
 		uint32_t FindCBuffer(std::string_view name) const noexcept;
 
@@ -761,6 +776,7 @@ namespace KlayGE
 
 		uint32_t NumTechniques() const noexcept;
 		RenderTechnique* TechniqueByName(std::string_view name) const noexcept;
+		RenderTechnique* TechniqueByNameHash(size_t name_hash) const noexcept;
 		RenderTechnique* TechniqueByIndex(uint32_t n) const noexcept;
 
 		uint32_t NumShaderFragments() const noexcept
@@ -798,7 +814,7 @@ namespace KlayGE
 
 #if KLAYGE_IS_DEV_PLATFORM
 		void PreprocessIncludes(XMLNode& root, std::vector<std::string>& include_names);
-		void RecursiveIncludeNode(XMLNode const& root, std::vector<std::string>& include_names) const;
+		bool DependenciesUpToDate() const;
 
 		XMLNode ResolveInheritTechNode(XMLNode& root, XMLNode const* tech_node);
 		void ResolveOverrideTechs(XMLNode& root);
@@ -807,6 +823,23 @@ namespace KlayGE
 #endif
 
 	private:
+		// Flat open addressing table from name hashes to indices
+		class NameHashIndex final
+		{
+		public:
+			void Clear() noexcept;
+			void Build(std::span<size_t const> name_hashes);
+
+			bool Built() const noexcept
+			{
+				return !slots_.empty();
+			}
+			uint32_t Find(size_t name_hash) const noexcept;
+
+		private:
+			std::vector<std::pair<size_t, uint32_t>> slots_;
+		};
+
 		struct Immutable final
 		{
 			KLAYGE_NONCOPYABLE(Immutable);
@@ -816,7 +849,14 @@ namespace KlayGE
 			std::string res_name;
 			size_t res_name_hash;
 #if KLAYGE_IS_DEV_PLATFORM
-			uint64_t timestamp;
+			// Every fxml the effect is built from, with the timestamp and content hash it had when the kfx was made
+			struct Dependency
+			{
+				std::string name;
+				uint64_t timestamp;
+				uint64_t content_hash;
+			};
+			std::vector<Dependency> dependencies;
 
 			std::string kfx_name;
 			bool need_compile;
@@ -835,14 +875,25 @@ namespace KlayGE
 			std::vector<ShaderDesc> shader_descs;
 
 			std::vector<RenderShaderGraphNode> shader_graph_nodes;
+
+			// Techniques are shared by clones, so is their index
+			NameHashIndex tech_index;
 		};
 
+		void BuildNameHashIndices();
+		template <typename T>
+		static uint32_t FindByNameHash(NameHashIndex const* index, std::vector<T> const& items, size_t name_hash) noexcept;
+
 		std::shared_ptr<Immutable> immutable_;
 
 		std::vector<RenderEffectParameter> params_;
 		std::vector<RenderEffectConstantBufferPtr> cbuffers_;
 		std::vector<ShaderObjectPtr> shader_objs_;
 
+		// Each effect indexes its own parameters and cbuffers. A clone of an effect that is loaded again keeps its old ones.
+		NameHashIndex param_index_;
+		NameHashIndex cbuffer_index_;
+
 		mutable bool hw_res_ready_ = false;
 	};
 
@@ -857,7 +908,7 @@ namespace KlayGE
 
 #if KLAYGE_IS_DEV_PLATFORM
 		void Load(RenderEffect& effect, XMLNode const& node, uint32_t tech_index);
-		void CompileShaders(RenderEffect& effect, uint32_t tech_index);
+		void CompileShaders(RenderEffect& effect, uint32_t tech_index, std::vector<ShaderCompileJob>& jobs);
 #endif
 		void CreateHwShaders(RenderEffect& effect, uint32_t tech_index);
 
@@ -932,12 +983,12 @@ namespace KlayGE
 		std::shared_ptr<std::vector<RenderEffectAnnotationPtr>> annotations_;
 		std::shared_ptr<std::vector<std::pair<std::string, std::string>>> macros_;
 
-		float weight_;
-		bool transparent_;
+		float weight_ = 1;
+		bool transparent_ = false;
 
-		bool is_validate_;
-		bool has_discard_;
-		bool has_tessellation_;
+		bool is_validate_ = false;
+		bool has_discard_ = false;
+		bool has_tessellation_ = false;
 	};
 
 	class KLAYGE_CORE_API RenderPass final
@@ -950,7 +1001,7 @@ namespace KlayGE
 #if KLAYGE_IS_DEV_PLATFORM
 		void Load(RenderEffect& effect, XMLNode const& node, uint32_t tech_index, uint32_t pass_index, RenderPass const* inherit_pass);
 		void Load(RenderEffect& effect, uint32_t tech_index, uint32_t pass_index, RenderPass const* inherit_pass);
-		void CompileShaders(RenderEffect& effect, uint32_t tech_index, uint32_t pass_index);
+		void CompileShaders(RenderEffect& effect, uint32_t tech_index, uint32_t pass_index, std::vector<ShaderCompileJob>& jobs);
 #endif
 		void CreateHwShaders(RenderEffect& effect, uint32_t tech_index, uint32_t pass_index);
 
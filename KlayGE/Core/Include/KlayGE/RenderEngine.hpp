@@ -78,6 +78,7 @@
 #include <KlayGE/RenderSettings.hpp>
 #include <KlayGE/Mipmapper.hpp>
 #include <KFL/Color.hpp>
+#include <KFL/Timer.hpp>
 
 #include <memory>
 #include <string_view>
@@ -416,6 +417,9 @@ namespace KlayGE
 		PerfRegion* resize_pp_perf_;
 		PerfRegion* hdr_display_pp_perf_;
 		PerfRegion* stereoscopic_pp_perf_;
+
+		Timer startup_timer_;
+		bool first_frame_reported_ = true;
 #endif
 
 		mutable RenderMaterialPtr default_material_;
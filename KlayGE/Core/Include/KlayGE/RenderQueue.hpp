@@ -0,0 +1,94 @@
+/**
+ * @file RenderQueue.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#ifndef _RENDERQUEUE_HPP
+#define _RENDERQUEUE_HPP
+
+#pragma once
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <KFL/CXX20/span.hpp>
+#include <KFL/Noncopyable.hpp>
+#include <KFL/Vector.hpp>
+
+namespace KlayGE
+{
+	class Renderable;
+	class RenderTechnique;
+
+	// Orders the renderables of a pass by a 64-bit key per draw. From high to low bits the key holds the technique weight,
+	// a per-frame technique index, and a coarse view depth for techniques that benefit from front-to-back order.
+	class KLAYGE_CORE_API RenderQueue final
+	{
+		KLAYGE_NONCOPYABLE(RenderQueue);
+
+	public:
+		RenderQueue();
+
+		void Clear();
+		bool Empty() const noexcept
+		{
+			return renderables_.empty();
+		}
+		size_t Size() const noexcept
+		{
+			return renderables_.size();
+		}
+
+		// The renderable must have a technique. Its instances may still change until Sort() is called.
+		void Add(Renderable* renderable);
+
+		// view_mat_z is the 3rd column of the view matrix. Without it, draws of a technique keep the order they were added.
+		void Sort(std::optional<float4> const & view_mat_z);
+		std::span<Renderable* const> SortedRenderables() const noexcept
+		{
+			return sorted_renderables_;
+		}
+
+	private:
+		void CalcKeys(std::optional<float4> const & view_mat_z);
+
+	private:
+		std::vector<Renderable*> renderables_;
+		std::vector<uint32_t> tech_indices_;
+
+		std::vector<RenderTechnique const *> techs_;
+		std::unordered_map<RenderTechnique const *, uint32_t> tech_index_map_;
+
+		std::vector<std::pair<uint64_t, uint32_t>> keys_;
+		std::vector<std::pair<uint64_t, uint32_t>> keys_scratch_;
+		std::vector<Renderable*> sorted_renderables_;
+	};
+}
+
+#endif		// _RENDERQUEUE_HPP
@@ -181,6 +181,11 @@ namespace KlayGE
 		}
 		virtual RenderLayout& GetRenderLayout() const;
 		virtual RenderLayout& GetRenderLayout(uint32_t lod) const;
+		// Returns the lod that is drawn when lod is wanted. Renderables that stream in their finer lods draw a coarser one meanwhile.
+		virtual uint32_t StreamLod(uint32_t lod)
+		{
+			return lod;
+		}
 		virtual std::wstring const & Name() const;
 
 		virtual void OnRenderBegin();
@@ -33,6 +33,7 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include <KFL/ResIdentifier.hpp>
 #include <KFL/Noncopyable.hpp>
@@ -60,6 +61,8 @@ namespace KlayGE
 
 		virtual bool HasSubThreadStage() const = 0;
 
+		// Must be consistent with Match(). Two descs that match each other have to return the same hash.
+		virtual size_t Hash() const;
 		virtual bool Match(ResLoadingDesc const & rhs) const = 0;
 		virtual void CopyDataFrom(ResLoadingDesc const & rhs) = 0;
 		virtual std::shared_ptr<void> CloneResourceFrom(std::shared_ptr<void> const & resource) = 0;
@@ -69,6 +72,31 @@ namespace KlayGE
 
 	using ResLoadingDescPtr = std::shared_ptr<ResLoadingDesc>;
 
+	enum class ResLoadingPriority : uint32_t
+	{
+		Low = 0,
+		Normal,
+		High,
+		Immediate
+	};
+
+	struct ResLoadingStatistics
+	{
+		uint64_t type;
+
+		uint32_t num_loaded;
+		uint32_t num_cancelled;
+		uint32_t num_deduplicated;
+
+		double sub_thread_time;
+		double main_thread_time;
+
+		double Throughput() const noexcept
+		{
+			return sub_thread_time + main_thread_time > 0 ? num_loaded / (sub_thread_time + main_thread_time) : 0;
+		}
+	};
+
 	class KLAYGE_CORE_API ResLoader final
 	{
 		friend class Context;
@@ -96,7 +124,9 @@ namespace KlayGE
 		std::string AbsPath(std::string_view path);
 
 		std::shared_ptr<void> SyncQuery(ResLoadingDescPtr const & res_desc);
-		std::shared_ptr<void> ASyncQuery(ResLoadingDescPtr const & res_desc);
+		std::shared_ptr<void> ASyncQuery(ResLoadingDescPtr const & res_desc,
+			ResLoadingPriority priority = ResLoadingPriority::Normal);
+		bool Cancel(std::shared_ptr<void> const & res);
 		void Unload(std::shared_ptr<void> const & res);
 
 		template <typename T>
@@ -106,9 +136,16 @@ namespace KlayGE
 		}
 
 		template <typename T>
-		std::shared_ptr<T> ASyncQueryT(ResLoadingDescPtr const & res_desc)
+		std::shared_ptr<T> ASyncQueryT(ResLoadingDescPtr const & res_desc,
+			ResLoadingPriority priority = ResLoadingPriority::Normal)
+		{
+			return std::static_pointer_cast<T>(this->ASyncQuery(res_desc, priority));
+		}
+
+		template <typename T>
+		bool Cancel(std::shared_ptr<T> const & res)
 		{
-			return std::static_pointer_cast<T>(this->ASyncQuery(res_desc));
+			return this->Cancel(std::static_pointer_cast<void>(res));
 		}
 
 		template <typename T>
@@ -121,6 +158,12 @@ namespace KlayGE
 
 		uint32_t NumLoadingResources() const noexcept;
 
+		uint32_t NumLoadingThreads() const noexcept;
+		void NumLoadingThreads(uint32_t num);
+
+		std::vector<ResLoadingStatistics> Statistics() const;
+		void ResetStatistics();
+
 	private:
 		void Init(ThreadPool& tp);
 		void Destroy() noexcept;
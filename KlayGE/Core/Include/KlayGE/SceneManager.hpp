@@ -23,6 +23,7 @@
 
 #include <KlayGE/SceneNode.hpp>
 #include <KlayGE/Renderable.hpp>
+#include <KlayGE/RenderQueue.hpp>
 #include <KFL/Frustum.hpp>
 #include <KFL/Thread.hpp>
 #include <KFL/Noncopyable.hpp>
@@ -49,6 +50,8 @@ namespace KlayGE
 		void Resume();
 
 		void SmallObjectThreshold(float area);
+		// Scenes whose spatial structure has fewer nodes than this are culled on the calling thread
+		void ParallelCullingThreshold(uint32_t num_nodes);
 		void SceneUpdateElapse(float elapse);
 		virtual void ClipScene();
 
@@ -130,6 +133,7 @@ namespace KlayGE
 			visible_marks_map_;
 
 		float small_obj_threshold_;
+		uint32_t parallel_culling_threshold_;
 		float update_elapse_;
 
 		std::vector<SceneNode*> all_scene_nodes_;
@@ -141,7 +145,7 @@ namespace KlayGE
 	private:
 		uint32_t urt_;
 
-		std::vector<std::pair<RenderTechnique const *, std::vector<Renderable*>>> render_queue_;
+		RenderQueue render_queue_;
 
 		uint32_t num_objects_rendered_;
 		uint32_t num_renderables_rendered_;
@@ -34,6 +34,7 @@
 #pragma once
 
 #include <array>
+#include <functional>
 #include <memory>
 
 #include <KFL/Noncopyable.hpp>
@@ -72,6 +73,18 @@ namespace KlayGE
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) = 0;
 		virtual void DecodeBlock(void* output, void const * input) = 0;
 
+		// Encodes num_blocks consecutive uncompressed blocks into consecutive compressed blocks. Codecs with a SIMD batch path
+		// override it, the output must be bit-identical to calling EncodeBlock on each block.
+		virtual void EncodeBlocks(void* output, void const * input, uint32_t num_blocks, TexCompressionMethod method);
+
+		// Codecs keep per-block scratch state, so each worker of EncodeMem/DecodeMem runs on its own clone.
+		virtual std::unique_ptr<TexCompression> Clone() const = 0;
+
+		// Number of threads EncodeMem/DecodeMem split block rows across. 0 means one per hardware thread.
+		// Every block is coded independently, so the output doesn't depend on this value.
+		uint32_t NumThreads() const noexcept;
+		void NumThreads(uint32_t num) noexcept;
+
 		virtual void EncodeMem(uint32_t width, uint32_t height, 
 			void* output, uint32_t out_row_pitch, uint32_t out_slice_pitch,
 			void const * input, uint32_t in_row_pitch, uint32_t in_slice_pitch,
@@ -83,8 +96,13 @@ namespace KlayGE
 		virtual void EncodeTex(TexturePtr const & out_tex, TexturePtr const & in_tex, TexCompressionMethod method);
 		virtual void DecodeTex(TexturePtr const & out_tex, TexturePtr const & in_tex);
 
+	protected:
+		void ParallelForBlockRows(uint32_t width, uint32_t height,
+			std::function<void(TexCompression& codec, uint32_t row_begin, uint32_t row_end)> const & func);
+
 	protected:
 		ElementFormat compression_format_;
+		uint32_t num_threads_ = 0;
 	};
 
 	class ARGBColor32 final
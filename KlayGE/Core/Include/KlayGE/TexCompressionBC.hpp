@@ -81,8 +81,14 @@ namespace KlayGE
 
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
+		virtual void EncodeBlocks(void* output, void const * input, uint32_t num_blocks, TexCompressionMethod method) override;
+
+		virtual std::unique_ptr<TexCompression> Clone() const override;
 
 		void EncodeBC1Internal(BC1Block& bc1, ARGBColor32 const * argb, bool alpha, TexCompressionMethod method) const;
+		// Encodes num_blocks blocks of 16 pixels each, 4 (SSE2) or 8 (AVX2) at a time.
+		void EncodeBC1InternalBatch(BC1Block* const * bc1, ARGBColor32 const * argb, bool const * alpha, uint32_t num_blocks,
+			TexCompressionMethod method) const;
 
 	private:
 		ARGBColor32 RGB565To888(uint16_t rgb) const;
@@ -90,6 +96,8 @@ namespace KlayGE
 		uint32_t MatchColorsBlock(ARGBColor32 const * argb, ARGBColor32 const & min_clr, ARGBColor32 const & max_clr, bool alpha) const;
 		void OptimizeColorsBlock(ARGBColor32 const * argb, ARGBColor32& min_clr, ARGBColor32& max_clr, TexCompressionMethod method) const;
 		bool RefineBlock(ARGBColor32 const * argb, ARGBColor32& min_clr, ARGBColor32& max_clr, uint32_t mask) const;
+		bool SolveRefinedColors(int akku, int3 const & at1, int3 const & at2, ARGBColor32& min_clr, ARGBColor32& max_clr) const;
+		void PackBC1Block(BC1Block& bc1, uint32_t mask, uint16_t max16, uint16_t min16, bool alpha) const;
 	};
 
 	class KLAYGE_CORE_API TexCompressionBC2 final : public TexCompression
@@ -99,6 +107,9 @@ namespace KlayGE
 
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
+		virtual void EncodeBlocks(void* output, void const * input, uint32_t num_blocks, TexCompressionMethod method) override;
+
+		virtual std::unique_ptr<TexCompression> Clone() const override;
 
 	private:
 		TexCompressionBC1 bc1_codec_;
@@ -111,6 +122,8 @@ namespace KlayGE
 
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
+
+		virtual std::unique_ptr<TexCompression> Clone() const override;
 	};
 
 	class KLAYGE_CORE_API TexCompressionBC3 final : public TexCompression
@@ -120,6 +133,9 @@ namespace KlayGE
 
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
+		virtual void EncodeBlocks(void* output, void const * input, uint32_t num_blocks, TexCompressionMethod method) override;
+
+		virtual std::unique_ptr<TexCompression> Clone() const override;
 
 	private:
 		TexCompressionBC1 bc1_codec_;
@@ -134,6 +150,8 @@ namespace KlayGE
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
 
+		virtual std::unique_ptr<TexCompression> Clone() const override;
+
 	private:
 		TexCompressionBC4 bc4_codec_;
 	};
@@ -146,6 +164,8 @@ namespace KlayGE
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
 
+		virtual std::unique_ptr<TexCompression> Clone() const override;
+
 		void DecodeBC6Internal(void* output, void const * input, bool signed_fmt);
 
 	private:
@@ -207,6 +227,8 @@ namespace KlayGE
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
 
+		virtual std::unique_ptr<TexCompression> Clone() const override;
+
 	private:
 		TexCompressionBC6U bc6u_codec_;
 	};
@@ -272,6 +294,8 @@ namespace KlayGE
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
 
+		virtual std::unique_ptr<TexCompression> Clone() const override;
+
 	private:
 		void PackBC7UniformBlock(void* output, ARGBColor32 const & pixel);
 		void PackBC7Block(int mode, CompressParams& params, void* output);
@@ -79,6 +79,11 @@ namespace KlayGE
 	{
 		Point,
 		Linear,
+
+		// Only resampled on the CPU. GPU blits use Linear for them.
+		Box,
+		Kaiser,
+		Lanczos,
 	};
 
 	// Abstract class representing a Texture resource.
@@ -396,6 +401,11 @@ namespace KlayGE
 		uint32_t src_width, uint32_t src_height, uint32_t src_depth,
 		TextureFilter filter);
 
+	// Fills levels 1 to level_data.size() - 1 of a 1D or 2D mip chain from level 0, in one streaming pass. Each level is filtered
+	// from the previous one at float precision, in linear space for sRGB formats, and only keeps the few rows its filter needs.
+	KLAYGE_CORE_API void BuildMipChain(std::span<void* const> level_data, std::span<uint32_t const> level_row_pitches,
+		ElementFormat format, uint32_t width, uint32_t height, TextureFilter filter);
+
 	// return the lookat and up vector in cubemap view
 	//////////////////////////////////////////////////////////////////////////////////
 	template <typename T>
@@ -33,8 +33,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <deque>
+#include <mutex>
 #include <vector>
-#include <list>
 
 #include <KFL/Noncopyable.hpp>
 
@@ -55,23 +57,14 @@ namespace KlayGE
 		}
 	};
 
+	// A ring of frame-lifetime allocations. Alloc only moves the head of the ring forward, and the space of a frame is taken
+	// back as a whole once the GPU can't be using it any more. Data is written to a CPU copy and uploaded in EnsureDataReady.
+	//
+	// Alloc can be called from many threads at the same time. The other member functions must not run concurrently with it.
 	class KLAYGE_CORE_API TransientBuffer final
 	{
 		KLAYGE_NONCOPYABLE(TransientBuffer);
 
-		// Frames that have ended
-		struct RetiredFrame
-		{
-			// Sub allocs that are unuseful and will be freed at the end of the frame
-			std::list<SubAlloc> pending_frees_;
-			uint32_t frame_id;
-
-			explicit RetiredFrame(uint32_t id)
-				: frame_id(id)
-			{
-			}
-		};
-
 	public:
 		enum BindFlag
 		{
@@ -79,15 +72,25 @@ namespace KlayGE
 			BF_Index
 		};
 
+		struct Statistics
+		{
+			uint32_t capacity;
+			// Most bytes in flight at once, including the frames not retired yet. The capacity it needs to never grow.
+			uint32_t high_water_mark;
+			// Most bytes allocated in one frame
+			uint32_t frame_high_water_mark;
+			uint32_t num_grows;
+			uint64_t num_allocs;
+		};
+
 	public:
 		TransientBuffer(uint32_t size_in_byte, BindFlag bind_flag);
 
-		// Allocate a sub space from transient buffer
+		// Allocate a sub space from transient buffer. It is valid until the frame it is allocated in is retired.
 		SubAlloc Alloc(uint32_t size_in_byte, void const * data);
-		// Knowtify transient buffer that this alloc is unused and will be freed at the end of the frame.
-		void Dealloc(SubAlloc const & alloc);
+		// Uploads the data allocated so far. Could create a new buffer, so GetBuffer() has to be called again after it.
 		void EnsureDataReady();
-		// Do with retired frames
+		// Marks the end of the frame's allocations and retires the frames that the GPU is done with
 		void OnPresent();
 
 		GraphicsBufferPtr const & GetBuffer() const
@@ -95,24 +98,58 @@ namespace KlayGE
 			return buffer_;
 		}
 
+		Statistics GetStatistics() const noexcept;
+		void ResetStatistics() noexcept;
+
 	private:
 		GraphicsBufferPtr DoCreateBuffer(BindFlag bind_flag, uint32_t size_in_byte);
-		// Free the sub alloc and return the space allocated back to transient buffer.
-		void DoFree(SubAlloc const & alloc);
+		// Returns the position of the allocation in the ring, or NO_SPACE
+		uint64_t Reserve(uint32_t size_in_byte) noexcept;
+		void Grow(uint32_t size_in_byte, uint32_t old_capacity);
+		void UploadRange(uint8_t* dst, uint64_t begin, uint64_t end) const;
 
 	private:
+		static constexpr uint64_t NO_SPACE = ~0ULL;
+
 		bool use_no_overwrite_;
 		uint32_t num_pre_frames_;
 
 		GraphicsBufferPtr buffer_;
-		std::list<SubAlloc> free_list_;
-		std::list<RetiredFrame> retired_frames_;
 		BindFlag bind_flag_;
 
-		std::vector<uint8_t> simulate_buffer_;
-		uint32_t valid_min_;
-		uint32_t valid_max_;
+		// Positions only increase. position % capacity_ is the offset in the buffer.
+		std::atomic<uint64_t> head_{0};
+		uint64_t tail_ = 0;
+		uint64_t uploaded_ = 0;
+		// Frame id and the head at the end of that frame
+		std::deque<std::pair<uint32_t, uint64_t>> frame_fences_;
+
+		uint32_t capacity_;
+		std::vector<uint8_t> cpu_buffer_;
+
+		// Growing is the only part that waits. Allocs in flight finish before the CPU buffer is reallocated.
+		std::mutex grow_mutex_;
+		std::atomic<bool> growing_{false};
+		std::atomic<uint32_t> num_writers_{0};
+
+		std::atomic<uint64_t> high_water_mark_{0};
+		std::atomic<uint64_t> num_allocs_{0};
+		std::atomic<uint64_t> frame_bytes_{0};
+		uint64_t cur_frame_bytes_ = 0;
+		uint64_t frame_high_water_mark_ = 0;
+		uint32_t num_grows_ = 0;
 	};
+
+	// Quads of 4 vertices each, as in UI and text rendering, all use the same 16-bit indices. Drawn with a start vertex
+	// location at the first vertex of the quads, one immutable index buffer serves every draw.
+	uint32_t constexpr MAX_QUADS_PER_DRAW = 0xFFFF / 4;
+
+	// A triangle strip with primitive restart, or a triangle list, of MAX_QUADS_PER_DRAW quads
+	KLAYGE_CORE_API GraphicsBufferPtr MakeQuadIndexBuffer(bool primitive_restart);
+	inline uint32_t NumIndicesPerQuad(bool primitive_restart) noexcept
+	{
+		return primitive_restart ? 5 : 6;
+	}
 }
 
 #endif
@@ -319,72 +319,73 @@ namespace KlayGE
 			ResIdentifierPtr file = res_loader.Open(cfg_file);
 			if (file)
 			{
-				XMLNode cfg_root = LoadXml(*file);
+				XMLDocument cfg_doc(*file);
+				XMLNodeView const& cfg_root = *cfg_doc.Root();
 
-				XMLNode const* context_node = cfg_root.FirstNode("context");
-				XMLNode const* graphics_node = cfg_root.FirstNode("graphics");
+				XMLNodeView const* context_node = cfg_root.FirstNode("context");
+				XMLNodeView const* graphics_node = cfg_root.FirstNode("graphics");
 
-				if (XMLNode const* rf_node = context_node->FirstNode("render_factory"))
+				if (XMLNodeView const* rf_node = context_node->FirstNode("render_factory"))
 				{
 					rf_name = std::string(rf_node->Attrib("name")->ValueString());
 				}
-				if (XMLNode const* af_node = context_node->FirstNode("audio_factory"))
+				if (XMLNodeView const* af_node = context_node->FirstNode("audio_factory"))
 				{
 					af_name = std::string(af_node->Attrib("name")->ValueString());
 				}
-				if (XMLNode const* if_node = context_node->FirstNode("input_factory"))
+				if (XMLNodeView const* if_node = context_node->FirstNode("input_factory"))
 				{
 					if_name = std::string(if_node->Attrib("name")->ValueString());
 				}
-				if (XMLNode const* sf_node = context_node->FirstNode("show_factory"))
+				if (XMLNodeView const* sf_node = context_node->FirstNode("show_factory"))
 				{
 					sf_name = std::string(sf_node->Attrib("name")->ValueString());
 				}
-				if (XMLNode const* scf_node = context_node->FirstNode("script_factory"))
+				if (XMLNodeView const* scf_node = context_node->FirstNode("script_factory"))
 				{
 					scf_name = std::string(scf_node->Attrib("name")->ValueString());
 				}
-				if (XMLNode const* sm_node = context_node->FirstNode("scene_manager"))
+				if (XMLNodeView const* sm_node = context_node->FirstNode("scene_manager"))
 				{
 					sm_name = std::string(sm_node->Attrib("name")->ValueString());
 				}
-				if (XMLNode const* adsf_node = context_node->FirstNode("audio_data_source_factory"))
+				if (XMLNodeView const* adsf_node = context_node->FirstNode("audio_data_source_factory"))
 				{
 					adsf_name = std::string(adsf_node->Attrib("name")->ValueString());
 				}
-				if (XMLNode const* perf_profiler_node = context_node->FirstNode("perf_profiler"))
+				if (XMLNodeView const* perf_profiler_node = context_node->FirstNode("perf_profiler"))
 				{
 					perf_profiler = perf_profiler_node->Attrib("enabled")->ValueInt() ? true : false;
 				}
-				if (XMLNode const* location_sensor_node = context_node->FirstNode("location_sensor"))
+				if (XMLNodeView const* location_sensor_node = context_node->FirstNode("location_sensor"))
 				{
 					location_sensor = location_sensor_node->Attrib("enabled")->ValueInt() ? true : false;
 				}
 
-				XMLNode const* frame_node = graphics_node->FirstNode("frame");
-				if (XMLAttribute const* attr = frame_node->Attrib("width"))
+				XMLNodeView const* frame_node = graphics_node->FirstNode("frame");
+				if (XMLAttributeView const* attr = frame_node->Attrib("width"))
 				{
 					width = attr->ValueUInt();
 				}
-				if (XMLAttribute const* attr = frame_node->Attrib("height"))
+				if (XMLAttributeView const* attr = frame_node->Attrib("height"))
 				{
 					height = attr->ValueUInt();
 				}
 				std::string color_fmt_str = "ARGB8";
-				if (XMLAttribute const* attr = frame_node->Attrib("color_fmt"))
+				if (XMLAttributeView const* attr = frame_node->Attrib("color_fmt"))
 				{
 					color_fmt_str = std::string(attr->ValueString());
 				}
 				std::string depth_stencil_fmt_str = "D16";
-				if (XMLAttribute const* attr = frame_node->Attrib("depth_stencil_fmt"))
+				if (XMLAttributeView const* attr = frame_node->Attrib("depth_stencil_fmt"))
 				{
 					depth_stencil_fmt_str = std::string(attr->ValueString());
 				}
-				if (XMLAttribute const* attr = frame_node->Attrib("fullscreen"))
+				if (XMLAttributeView const* attr = frame_node->Attrib("fullscreen"))
 				{
 					full_screen = attr->ValueBool();
 				}
-				if (XMLAttribute const* attr = frame_node->Attrib("keep_screen_on"))
+				if (XMLAttributeView const* attr = frame_node->Attrib("keep_screen_on"))
 				{
 					keep_screen_on = attr->ValueBool();
 				}
@@ -425,56 +426,56 @@ namespace KlayGE
 					depth_stencil_fmt = EF_Unknown;
 				}
 
-				XMLNode const* sample_node = frame_node->FirstNode("sample");
-				if (XMLAttribute const* attr = sample_node->Attrib("count"))
+				XMLNodeView const* sample_node = frame_node->FirstNode("sample");
+				if (XMLAttributeView const* attr = sample_node->Attrib("count"))
 				{
 					sample_count = attr->ValueUInt();
 				}
-				if (XMLAttribute const* attr = sample_node->Attrib("quality"))
+				if (XMLAttributeView const* attr = sample_node->Attrib("quality"))
 				{
 					sample_quality = attr->ValueUInt();
 				}
 
-				XMLNode const* sync_interval_node = graphics_node->FirstNode("sync_interval");
-				if (XMLAttribute const* attr = sync_interval_node->Attrib("value"))
+				XMLNodeView const* sync_interval_node = graphics_node->FirstNode("sync_interval");
+				if (XMLAttributeView const* attr = sync_interval_node->Attrib("value"))
 				{
 					sync_interval = attr->ValueUInt();
 				}
 
-				XMLNode const* hdr_node = graphics_node->FirstNode("hdr");
-				if (XMLAttribute const* attr = hdr_node->Attrib("value"))
+				XMLNodeView const* hdr_node = graphics_node->FirstNode("hdr");
+				if (XMLAttributeView const* attr = hdr_node->Attrib("value"))
 				{
 					hdr = attr->ValueBool();
 				}
-				if (XMLAttribute const* attr = hdr_node->Attrib("bloom"))
+				if (XMLAttributeView const* attr = hdr_node->Attrib("bloom"))
 				{
 					bloom = attr->ValueFloat();
 				}
-				if (XMLAttribute const* attr = hdr_node->Attrib("blue_shift"))
+				if (XMLAttributeView const* attr = hdr_node->Attrib("blue_shift"))
 				{
 					blue_shift = attr->ValueBool();
 				}
 
-				XMLNode const* ppaa_node = graphics_node->FirstNode("ppaa");
-				if (XMLAttribute const* attr = ppaa_node->Attrib("value"))
+				XMLNodeView const* ppaa_node = graphics_node->FirstNode("ppaa");
+				if (XMLAttributeView const* attr = ppaa_node->Attrib("value"))
 				{
 					ppaa = attr->ValueBool();
 				}
 
-				XMLNode const* gamma_node = graphics_node->FirstNode("gamma");
-				if (XMLAttribute const* attr = gamma_node->Attrib("value"))
+				XMLNodeView const* gamma_node = graphics_node->FirstNode("gamma");
+				if (XMLAttributeView const* attr = gamma_node->Attrib("value"))
 				{
 					gamma = attr->ValueBool();
 				}
 
-				XMLNode const* color_grading_node = graphics_node->FirstNode("color_grading");
-				if (XMLAttribute const* attr = color_grading_node->Attrib("value"))
+				XMLNodeView const* color_grading_node = graphics_node->FirstNode("color_grading");
+				if (XMLAttributeView const* attr = color_grading_node->Attrib("value"))
 				{
 					color_grading = attr->ValueBool();
 				}
 
-				XMLNode const* stereo_node = graphics_node->FirstNode("stereo");
-				if (XMLAttribute const* attr = stereo_node->Attrib("method"))
+				XMLNodeView const* stereo_node = graphics_node->FirstNode("stereo");
+				if (XMLAttributeView const* attr = stereo_node->Attrib("method"))
 				{
 					size_t const method_str_hash = HashValue(attr->ValueString());
 					if (CtHash("none") == method_str_hash)
@@ -526,13 +527,13 @@ namespace KlayGE
 				{
 					stereo_method = STM_None;
 				}
-				if (XMLAttribute const* attr = stereo_node->Attrib("separation"))
+				if (XMLAttributeView const* attr = stereo_node->Attrib("separation"))
 				{
 					stereo_separation = attr->ValueFloat();
 				}
 
-				XMLNode const* output_node = graphics_node->FirstNode("output");
-				if (XMLAttribute const* attr = output_node->Attrib("method"))
+				XMLNodeView const* output_node = graphics_node->FirstNode("output");
+				if (XMLAttributeView const* attr = output_node->Attrib("method"))
 				{
 					size_t const method_str_hash = HashValue(attr->ValueString());
 					if (CtHash("hdr10") == method_str_hash)
@@ -545,11 +546,11 @@ namespace KlayGE
 					}
 				}
 
-				if (XMLAttribute const* attr = output_node->Attrib("white"))
+				if (XMLAttributeView const* attr = output_node->Attrib("white"))
 				{
 					paper_white = attr->ValueUInt();
 				}
-				if (XMLAttribute const* attr = output_node->Attrib("max_lum"))
+				if (XMLAttributeView const* attr = output_node->Attrib("max_lum"))
 				{
 					display_max_luminance = attr->ValueUInt();
 				}
@@ -563,9 +564,9 @@ namespace KlayGE
 					color_fmt = EF_A2BGR10;
 				}
 
-				if (XMLNode const* options_node = graphics_node->FirstNode("options"))
+				if (XMLNodeView const* options_node = graphics_node->FirstNode("options"))
 				{
-					if (XMLAttribute const* attr = options_node->Attrib("str"))
+					if (XMLAttributeView const* attr = options_node->Attrib("str"))
 					{
 						std::string_view const options_str = attr->ValueString();
 
@@ -581,8 +582,8 @@ namespace KlayGE
 					}
 				}
 
-				XMLNode const* debug_context_node = graphics_node->FirstNode("debug_context");
-				if (XMLAttribute const* attr = debug_context_node->Attrib("value"))
+				XMLNodeView const* debug_context_node = graphics_node->FirstNode("debug_context");
+				if (XMLAttributeView const* attr = debug_context_node->Attrib("value"))
 				{
 					debug_context = attr->ValueBool();
 				}
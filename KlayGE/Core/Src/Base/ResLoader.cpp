@@ -30,16 +30,22 @@
 
 #include <KlayGE/KlayGE.hpp>
 #include <KFL/Hash.hpp>
+#include <KFL/Timer.hpp>
 #include <KFL/Util.hpp>
 #include <KlayGE/Package.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #if defined KLAYGE_PLATFORM_LINUX
 #include <cstring>
 #endif
 #include <filesystem>
 #include <fstream>
 #include <istream>
+#include <queue>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 #if defined KLAYGE_PLATFORM_WINDOWS_DESKTOP
@@ -65,7 +71,6 @@ namespace uwp
 }
 
 #include <KFL/ErrorHandling.hpp>
-#elif defined KLAYGE_PLATFORM_LINUX
 #elif defined KLAYGE_PLATFORM_ANDROID
 #include <android_native_app_glue.h>
 #include <android/asset_manager.h>
@@ -74,6 +79,11 @@ namespace uwp
 #include <mach-o/dyld.h>
 #elif defined KLAYGE_PLATFORM_IOS
 #include <CoreFoundation/CoreFoundation.h>
+#elif defined KLAYGE_PLATFORM_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 #include <KFL/Thread.hpp>
@@ -104,6 +114,56 @@ namespace
 	private:
 		AAsset* asset_;
 	};
+#elif defined KLAYGE_PLATFORM_LINUX
+	// Read-only private mapping of a whole file. Pages are faulted in on demand and shared with the page cache,
+	// so loaders consuming ResIdentifier::Data() don't need a heap copy of the file.
+	class MappedFile final
+	{
+		KLAYGE_NONCOPYABLE(MappedFile);
+
+	public:
+		explicit MappedFile(std::string const & path)
+		{
+			int const fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+			if (fd != -1)
+			{
+				struct stat st;
+				if ((fstat(fd, &st) == 0) && (st.st_size > 0))
+				{
+					void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+					if (p != MAP_FAILED)
+					{
+						data_ = p;
+						size_ = static_cast<size_t>(st.st_size);
+						madvise(data_, size_, MADV_SEQUENTIAL);
+					}
+				}
+				close(fd);
+			}
+		}
+
+		~MappedFile()
+		{
+			if (data_ != nullptr)
+			{
+				munmap(data_, size_);
+			}
+		}
+
+		bool Valid() const noexcept
+		{
+			return data_ != nullptr;
+		}
+
+		std::span<uint8_t const> Data() const noexcept
+		{
+			return std::span<uint8_t const>(static_cast<uint8_t const*>(data_), size_);
+		}
+
+	private:
+		void* data_ = nullptr;
+		size_t size_ = 0;
+	};
 #endif
 }
 
@@ -113,8 +173,60 @@ namespace KlayGE
 	{
 		KLAYGE_NONCOPYABLE(Impl);
 
+	private:
+		enum class LoadingStatus
+		{
+			Loading,
+			Running,
+			Complete,
+			Cancelled,
+			CanBeRemoved
+		};
+
+		struct LoadingState
+		{
+			std::atomic<LoadingStatus> status{LoadingStatus::Loading};
+			std::atomic<ResLoadingPriority> priority{ResLoadingPriority::Normal};
+			uint32_t num_requesters = 1; // Guarded by loading_mutex_
+
+			// Signaled when a loading thread moves the state out of Running
+			std::mutex running_mutex;
+			std::condition_variable running_cv;
+		};
+
+		struct LoadedResource
+		{
+			ResLoadingDescPtr res_desc;
+			std::weak_ptr<void> res;
+		};
+
+		struct LoadingResource
+		{
+			ResLoadingDescPtr res_desc;
+			std::shared_ptr<LoadingState> state;
+		};
+
+		struct LoadingTask
+		{
+			ResLoadingDescPtr res_desc;
+			std::shared_ptr<LoadingState> state;
+			ResLoadingPriority priority;
+			uint64_t sequence;
+
+			// std::priority_queue pops the largest one. Higher priority goes first, FIFO inside the same priority.
+			bool operator<(LoadingTask const& rhs) const noexcept
+			{
+				if (priority != rhs.priority)
+				{
+					return priority < rhs.priority;
+				}
+				return sequence > rhs.sequence;
+			}
+		};
+
 	public:
 		explicit Impl(ThreadPool& tp)
+			: thread_pool_(tp)
 		{
 #if defined KLAYGE_PLATFORM_WINDOWS
 #if defined KLAYGE_PLATFORM_WINDOWS_DESKTOP
@@ -207,19 +319,21 @@ namespace KlayGE
 #endif
 #endif
 
-			loading_thread_ = tp.QueueThread([this] { this->LoadingThreadFunc(); });
+			this->NumLoadingThreads(std::clamp(std::thread::hardware_concurrency() / 2, 1U, 4U));
 		}
 		~Impl()
 		{
-			quit_ = true;
-
 			{
-				std::unique_lock<std::mutex> lock(loading_res_queue_mutex_, std::try_to_lock);
-				non_empty_loading_res_queue_ = true;
-				loading_res_queue_cv_.notify_one();
+				std::lock_guard<std::mutex> lock(loading_res_queue_mutex_);
+				quit_ = true;
 			}
+			loading_res_queue_cv_.notify_all();
 
-			loading_thread_.wait();
+			std::lock_guard<std::mutex> lock(loading_threads_mutex_);
+			for (auto& thread : loading_threads_)
+			{
+				thread.wait();
+			}
 		}
 
 		void Suspend()
@@ -395,6 +509,13 @@ namespace KlayGE
 						if (std::filesystem::exists(res_path))
 						{
 							uint64_t const timestamp = std::filesystem::last_write_time(res_path).time_since_epoch().count();
+#if defined(KLAYGE_PLATFORM_LINUX)
+							auto mapped_file = MakeSharedPtr<MappedFile>(res_name);
+							if (mapped_file->Valid())
+							{
+								return MakeSharedPtr<ResIdentifier>(name, timestamp, mapped_file->Data(), mapped_file);
+							}
+#endif
 							return MakeSharedPtr<ResIdentifier>(
 								name, timestamp, MakeSharedPtr<std::ifstream>(res_name.c_str(), std::ios_base::binary));
 						}
@@ -541,12 +662,14 @@ namespace KlayGE
 
 		std::shared_ptr<void> SyncQuery(ResLoadingDescPtr const& res_desc)
 		{
-			this->RemoveUnrefResources();
+			size_t const hash = res_desc->Hash();
 
-			std::shared_ptr<void> loaded_res = this->FindMatchLoadedResource(res_desc);
+			std::shared_ptr<void> loaded_res = this->FindMatchLoadedResource(hash, *res_desc);
 			std::shared_ptr<void> res;
 			if (loaded_res)
 			{
+				this->AccumulateStatistics(res_desc->Type(), 0, 0, 1, 0, 0);
+
 				if (res_desc->StateLess())
 				{
 					res = loaded_res;
@@ -556,58 +679,63 @@ namespace KlayGE
 					res = res_desc->CloneResourceFrom(loaded_res);
 					if (res != loaded_res)
 					{
-						this->AddLoadedResource(res_desc, res);
+						this->AddLoadedResource(hash, res_desc, res);
 					}
 				}
 			}
 			else
 			{
-				std::shared_ptr<volatile LoadingStatus> async_is_done;
-				bool found = false;
+				auto const loading = this->FindMatchLoadingResource(hash, *res_desc);
+				if (loading.second)
 				{
-					std::lock_guard<std::mutex> lock(loading_mutex_);
-
-					for (auto const& lrq : loading_res_)
+					// Takes it over from the loading threads. If one of them is already running the sub thread stage, waits for it.
+					// Only a pending state is moved to Complete, the loading thread finishes a running one by itself and a state
+					// that Update() has retired stays retired.
+					auto& state = *loading.second;
+					LoadingStatus expected = LoadingStatus::Loading;
+					if (!state.status.compare_exchange_strong(expected, LoadingStatus::Complete)
+						&& (LoadingStatus::Running == expected))
 					{
-						if (lrq.first->Match(*res_desc))
-						{
-							res_desc->CopyDataFrom(*lrq.first);
-							async_is_done = lrq.second;
-							found = true;
-							break;
-						}
+						std::unique_lock<std::mutex> lock(state.running_mutex);
+						state.running_cv.wait(lock, [&state] { return state.status != LoadingStatus::Running; });
 					}
-				}
 
-				if (found)
-				{
-					*async_is_done = LoadingStatus::Complete;
+					this->AccumulateStatistics(res_desc->Type(), 0, 0, 1, 0, 0);
 				}
 				else
 				{
 					res = res_desc->CreateResource();
 				}
 
+				Timer timer;
 				if (res_desc->HasSubThreadStage())
 				{
 					res_desc->SubThreadStage();
 				}
+				double const sub_thread_time = timer.elapsed();
 
+				timer.restart();
 				res_desc->MainThreadStage();
+				double const main_thread_time = timer.elapsed();
+
 				res = res_desc->Resource();
-				this->AddLoadedResource(res_desc, res);
+				this->AddLoadedResource(hash, res_desc, res);
+
+				this->AccumulateStatistics(res_desc->Type(), 1, 0, 0, sub_thread_time, main_thread_time);
 			}
 
 			return res;
 		}
-		std::shared_ptr<void> ASyncQuery(ResLoadingDescPtr const& res_desc)
+		std::shared_ptr<void> ASyncQuery(ResLoadingDescPtr const& res_desc, ResLoadingPriority priority)
 		{
-			this->RemoveUnrefResources();
+			size_t const hash = res_desc->Hash();
 
-			std::shared_ptr<void> loaded_res = this->FindMatchLoadedResource(res_desc);
+			std::shared_ptr<void> loaded_res = this->FindMatchLoadedResource(hash, *res_desc);
 			std::shared_ptr<void> res;
 			if (loaded_res)
 			{
+				this->AccumulateStatistics(res_desc->Type(), 0, 0, 1, 0, 0);
+
 				if (res_desc->StateLess())
 				{
 					res = loaded_res;
@@ -617,37 +745,36 @@ namespace KlayGE
 					res = res_desc->CloneResourceFrom(loaded_res);
 					if (res != loaded_res)
 					{
-						this->AddLoadedResource(res_desc, res);
+						this->AddLoadedResource(hash, res_desc, res);
 					}
 				}
 			}
 			else
 			{
-				std::shared_ptr<volatile LoadingStatus> async_is_done;
-				bool found = false;
+				auto const loading = this->FindMatchLoadingResource(hash, *res_desc, true);
+				if (loading.second)
 				{
-					std::lock_guard<std::mutex> lock(loading_mutex_);
+					this->AccumulateStatistics(res_desc->Type(), 0, 0, 1, 0, 0);
+
+					res = res_desc->Resource();
 
-					for (auto const& lrq : loading_res_)
 					{
-						if (lrq.first->Match(*res_desc))
+						std::lock_guard<std::mutex> lock(loading_mutex_);
+						if (!res_desc->StateLess())
+						{
+							loading_res_.emplace(hash, LoadingResource{res_desc, loading.second});
+						}
+						if (res)
 						{
-							res_desc->CopyDataFrom(*lrq.first);
-							async_is_done = lrq.second;
-							found = true;
-							break;
+							requested_res_.emplace(res.get(), loading.second);
 						}
 					}
-				}
 
-				if (found)
-				{
-					res = res_desc->Resource();
-
-					if (!res_desc->StateLess())
+					// Boosts the pending request. The stale lower priority task is skipped by the loading threads.
+					if (priority > loading.second->priority)
 					{
-						std::lock_guard<std::mutex> lock(loading_mutex_);
-						loading_res_.emplace_back(res_desc, async_is_done);
+						loading.second->priority = priority;
+						this->EnqueueLoadingTask(loading.first, loading.second, priority);
 					}
 				}
 				else
@@ -656,36 +783,68 @@ namespace KlayGE
 					{
 						res = res_desc->CreateResource();
 
-						async_is_done = MakeSharedPtr<LoadingStatus>(LoadingStatus::Loading);
+						auto state = MakeSharedPtr<LoadingState>();
+						state->priority = priority;
 
 						{
 							std::lock_guard<std::mutex> lock(loading_mutex_);
-							loading_res_.emplace_back(res_desc, async_is_done);
-						}
-						{
-							std::unique_lock<std::mutex> lock(loading_res_queue_mutex_, std::try_to_lock);
-							loading_res_queue_.emplace_back(res_desc, async_is_done);
-							non_empty_loading_res_queue_ = true;
-							loading_res_queue_cv_.notify_one();
+							loading_res_.emplace(hash, LoadingResource{res_desc, state});
+							if (res)
+							{
+								requested_res_.emplace(res.get(), state);
+							}
 						}
+						this->EnqueueLoadingTask(res_desc, state, priority);
 					}
 					else
 					{
+						Timer timer;
 						res_desc->MainThreadStage();
+						double const main_thread_time = timer.elapsed();
+
 						res = res_desc->Resource();
-						this->AddLoadedResource(res_desc, res);
+						this->AddLoadedResource(hash, res_desc, res);
+
+						this->AccumulateStatistics(res_desc->Type(), 1, 0, 0, 0, main_thread_time);
 					}
 				}
 			}
 			return res;
 		}
+		bool Cancel(std::shared_ptr<void> const& res)
+		{
+			if (!res)
+			{
+				return false;
+			}
+
+			std::lock_guard<std::mutex> lock(loading_mutex_);
+
+			auto const iter = requested_res_.find(res.get());
+			if (iter == requested_res_.end())
+			{
+				return false;
+			}
+
+			// Drops one request. The load is only stopped when no other ASyncQuery caller still waits for it.
+			auto const state = iter->second;
+			requested_res_.erase(iter);
+			--state->num_requesters;
+			if (state->num_requesters > 0)
+			{
+				return false;
+			}
+
+			LoadingStatus expected = LoadingStatus::Loading;
+			return state->status.compare_exchange_strong(expected, LoadingStatus::Cancelled);
+		}
 		void Unload(std::shared_ptr<void> const& res)
 		{
 			std::lock_guard<std::mutex> lock(loaded_mutex_);
 
 			for (auto iter = loaded_res_.begin(); iter != loaded_res_.end(); ++iter)
 			{
-				if (res == iter->second.lock())
+				if (res == iter->second.res.lock())
 				{
 					loaded_res_.erase(iter);
 					break;
@@ -695,20 +854,21 @@ namespace KlayGE
 
 		void Update()
 		{
-			std::vector<std::pair<ResLoadingDescPtr, std::shared_ptr<volatile LoadingStatus>>> tmp_loading_res;
+			std::vector<std::pair<size_t, LoadingResource>> tmp_loading_res;
 			{
 				std::lock_guard<std::mutex> lock(loading_mutex_);
-				tmp_loading_res = loading_res_;
+				tmp_loading_res.assign(loading_res_.begin(), loading_res_.end());
 			}
 
 			for (auto& lrq : tmp_loading_res)
 			{
-				if (LoadingStatus::Complete == *lrq.second)
+				if (LoadingStatus::Complete == lrq.second.state->status)
 				{
-					ResLoadingDescPtr const& res_desc = lrq.first;
+					size_t const hash = lrq.first;
+					ResLoadingDescPtr const& res_desc = lrq.second.res_desc;
 
 					std::shared_ptr<void> res;
-					std::shared_ptr<void> loaded_res = this->FindMatchLoadedResource(res_desc);
+					std::shared_ptr<void> loaded_res = this->FindMatchLoadedResource(hash, *res_desc);
 					if (loaded_res)
 					{
 						if (!res_desc->StateLess())
@@ -716,23 +876,34 @@ namespace KlayGE
 							res = res_desc->CloneResourceFrom(loaded_res);
 							if (res != loaded_res)
 							{
-								this->AddLoadedResource(res_desc, res);
+								this->AddLoadedResource(hash, res_desc, res);
 							}
 						}
 					}
 					else
 					{
+						Timer timer;
 						res_desc->MainThreadStage();
+						double const main_thread_time = timer.elapsed();
+
 						res = res_desc->Resource();
-						this->AddLoadedResource(res_desc, res);
+						this->AddLoadedResource(hash, res_desc, res);
+
+						this->AccumulateStatistics(res_desc->Type(), 0, 0, 0, 0, main_thread_time);
 					}
 				}
 			}
 			for (auto& lrq : tmp_loading_res)
 			{
-				if (LoadingStatus::Complete == *lrq.second)
+				auto& status = lrq.second.state->status;
+				if (LoadingStatus::Cancelled == status)
 				{
-					*lrq.second = LoadingStatus::CanBeRemoved;
+					this->AccumulateStatistics(lrq.second.res_desc->Type(), 0, 1, 0, 0, 0);
+					status = LoadingStatus::CanBeRemoved;
+				}
+				else if (LoadingStatus::Complete == status)
+				{
+					status = LoadingStatus::CanBeRemoved;
 				}
 			}
 
@@ -740,7 +911,7 @@ namespace KlayGE
 				std::lock_guard<std::mutex> lock(loading_mutex_);
 				for (auto iter = loading_res_.begin(); iter != loading_res_.end();)
 				{
-					if (LoadingStatus::CanBeRemoved == *(iter->second))
+					if (LoadingStatus::CanBeRemoved == iter->second.state->status)
 					{
 						iter = loading_res_.erase(iter);
 					}
@@ -749,6 +920,17 @@ namespace KlayGE
 						++iter;
 					}
 				}
+				for (auto iter = requested_res_.begin(); iter != requested_res_.end();)
+				{
+					if (LoadingStatus::CanBeRemoved == iter->second->status)
+					{
+						iter = requested_res_.erase(iter);
+					}
+					else
+					{
+						++iter;
+					}
+				}
 			}
 		}
 
@@ -757,6 +939,54 @@ namespace KlayGE
 			return static_cast<uint32_t>(loading_res_.size());
 		}
 
+		uint32_t NumLoadingThreads() const noexcept
+		{
+			return num_loading_threads_;
+		}
+		void NumLoadingThreads(uint32_t num)
+		{
+			num = std::max(num, 1U);
+
+			std::lock_guard<std::mutex> lock(loading_threads_mutex_);
+
+			{
+				std::lock_guard<std::mutex> queue_lock(loading_res_queue_mutex_);
+				num_loading_threads_ = num;
+			}
+			loading_res_queue_cv_.notify_all();
+
+			while (loading_threads_.size() > num)
+			{
+				loading_threads_.back().wait();
+				loading_threads_.pop_back();
+			}
+			while (loading_threads_.size() < num)
+			{
+				uint32_t const index = static_cast<uint32_t>(loading_threads_.size());
+				loading_threads_.emplace_back(thread_pool_.QueueThread([this, index] { this->LoadingThreadFunc(index); }));
+			}
+		}
+
+		std::vector<ResLoadingStatistics> Statistics() const
+		{
+			std::lock_guard<std::mutex> lock(statistics_mutex_);
+
+			std::vector<ResLoadingStatistics> ret;
+			ret.reserve(statistics_.size());
+			for (auto const& stat : statistics_)
+			{
+				ret.push_back(stat.second);
+			}
+			std::sort(ret.begin(), ret.end(),
+				[](ResLoadingStatistics const& lhs, ResLoadingStatistics const& rhs) { return lhs.type < rhs.type; });
+			return ret;
+		}
+		void ResetStatistics()
+		{
+			std::lock_guard<std::mutex> lock(statistics_mutex_);
+			statistics_.clear();
+		}
+
 	private:
 		std::filesystem::path RealPath(std::string_view path)
 		{
@@ -858,81 +1088,151 @@ namespace KlayGE
 			}
 		}
 
-		void AddLoadedResource(ResLoadingDescPtr const& res_desc, std::shared_ptr<void> const& res)
+		void AddLoadedResource(size_t hash, ResLoadingDescPtr const& res_desc, std::shared_ptr<void> const& res)
 		{
 			std::lock_guard<std::mutex> lock(loaded_mutex_);
 
 			bool found = false;
-			for (auto& c_desc : loaded_res_)
+			auto const range = loaded_res_.equal_range(hash);
+			for (auto iter = range.first; iter != range.second; ++iter)
 			{
-				if (c_desc.first == res_desc)
+				if (iter->second.res_desc == res_desc)
 				{
-					c_desc.second = std::weak_ptr<void>(res);
+					iter->second.res = std::weak_ptr<void>(res);
 					found = true;
 					break;
 				}
 			}
 			if (!found)
 			{
-				loaded_res_.emplace_back(res_desc, std::weak_ptr<void>(res));
+				loaded_res_.emplace(hash, LoadedResource{res_desc, std::weak_ptr<void>(res)});
+
+				// Sweeps the expired ones when the table doubles, so the cost is amortized O(1) per query
+				if (loaded_res_.size() >= next_sweep_size_)
+				{
+					this->RemoveUnrefResourcesNoLock();
+					next_sweep_size_ = std::max<size_t>(loaded_res_.size() * 2, 64);
+				}
 			}
 		}
-		std::shared_ptr<void> FindMatchLoadedResource(ResLoadingDescPtr const& res_desc)
+		std::shared_ptr<void> FindMatchLoadedResource(size_t hash, ResLoadingDesc const& res_desc)
 		{
 			std::lock_guard<std::mutex> lock(loaded_mutex_);
 
-			std::shared_ptr<void> loaded_res;
-			for (auto const& lr : loaded_res_)
+			auto const range = loaded_res_.equal_range(hash);
+			for (auto iter = range.first; iter != range.second; ++iter)
 			{
-				if (lr.first->Match(*res_desc))
+				if (iter->second.res_desc->Match(res_desc))
 				{
-					loaded_res = lr.second.lock();
-					break;
+					auto loaded_res = iter->second.res.lock();
+					if (loaded_res)
+					{
+						return loaded_res;
+					}
 				}
 			}
-			return loaded_res;
+			return std::shared_ptr<void>();
 		}
-		void RemoveUnrefResources()
+		std::pair<ResLoadingDescPtr, std::shared_ptr<LoadingState>> FindMatchLoadingResource(
+			size_t hash, ResLoadingDesc& res_desc, bool add_requester = false)
 		{
-			std::lock_guard<std::mutex> lock(loaded_mutex_);
+			std::lock_guard<std::mutex> lock(loading_mutex_);
 
+			auto const range = loading_res_.equal_range(hash);
+			for (auto iter = range.first; iter != range.second; ++iter)
+			{
+				auto const& lr = iter->second;
+				if ((lr.state->status != LoadingStatus::Cancelled) && lr.res_desc->Match(res_desc))
+				{
+					res_desc.CopyDataFrom(*lr.res_desc);
+					if (add_requester)
+					{
+						++lr.state->num_requesters;
+					}
+					return {lr.res_desc, lr.state};
+				}
+			}
+			return {};
+		}
+		void RemoveUnrefResourcesNoLock()
+		{
 			for (auto iter = loaded_res_.begin(); iter != loaded_res_.end();)
 			{
-				if (iter->second.lock())
+				if (iter->second.res.expired())
 				{
-					++iter;
+					iter = loaded_res_.erase(iter);
 				}
 				else
 				{
-					iter = loaded_res_.erase(iter);
+					++iter;
 				}
 			}
 		}
 
-		void LoadingThreadFunc()
+		void EnqueueLoadingTask(ResLoadingDescPtr const& res_desc, std::shared_ptr<LoadingState> const& state, ResLoadingPriority priority)
 		{
-			while (!quit_)
 			{
-				std::vector<std::pair<ResLoadingDescPtr, std::shared_ptr<volatile LoadingStatus>>> loading_res_queue_copy;
+				std::lock_guard<std::mutex> lock(loading_res_queue_mutex_);
+				loading_res_queue_.push(LoadingTask{res_desc, state, priority, loading_task_sequence_});
+				++loading_task_sequence_;
+			}
+			loading_res_queue_cv_.notify_one();
+		}
+
+		void AccumulateStatistics(uint64_t type, uint32_t num_loaded, uint32_t num_cancelled, uint32_t num_deduplicated,
+			double sub_thread_time, double main_thread_time)
+		{
+			std::lock_guard<std::mutex> lock(statistics_mutex_);
+
+			auto iter = statistics_.find(type);
+			if (iter == statistics_.end())
+			{
+				iter = statistics_.emplace(type, ResLoadingStatistics{type, 0, 0, 0, 0, 0}).first;
+			}
+
+			auto& stat = iter->second;
+			stat.num_loaded += num_loaded;
+			stat.num_cancelled += num_cancelled;
+			stat.num_deduplicated += num_deduplicated;
+			stat.sub_thread_time += sub_thread_time;
+			stat.main_thread_time += main_thread_time;
+		}
+
+		void LoadingThreadFunc(uint32_t index)
+		{
+			for (;;)
+			{
+				LoadingTask task;
 
 				{
 					std::unique_lock<std::mutex> lock(loading_res_queue_mutex_);
-					loading_res_queue_cv_.wait(lock, [this] { return non_empty_loading_res_queue_; });
+					loading_res_queue_cv_.wait(lock,
+						[this, index] { return quit_ || (index >= num_loading_threads_) || !loading_res_queue_.empty(); });
+					if (quit_ || (index >= num_loading_threads_))
+					{
+						break;
+					}
 
-					loading_res_queue_copy.swap(loading_res_queue_);
-					non_empty_loading_res_queue_ = false;
+					task = loading_res_queue_.top();
+					loading_res_queue_.pop();
 				}
 
-				for (auto& res_pair : loading_res_queue_copy)
+				// Cancelled, taken over by SyncQuery, or already picked up by a task with boosted priority
+				LoadingStatus expected = LoadingStatus::Loading;
+				if (task.state->status.compare_exchange_strong(expected, LoadingStatus::Running))
 				{
-					if (LoadingStatus::Loading == *res_pair.second)
+					Timer timer;
+					task.res_desc->SubThreadStage();
+					double const sub_thread_time = timer.elapsed();
+
 					{
-						res_pair.first->SubThreadStage();
-						*res_pair.second = LoadingStatus::Complete;
+						std::lock_guard<std::mutex> lock(task.state->running_mutex);
+						task.state->status = LoadingStatus::Complete;
 					}
-				}
+					task.state->running_cv.notify_all();
 
-				Sleep(10);
+					this->AccumulateStatistics(task.res_desc->Type(), 1, 0, 0, sub_thread_time, 0);
+				}
 			}
 		}
 
@@ -989,12 +1289,7 @@ namespace KlayGE
 #endif
 
 	private:
-		enum class LoadingStatus
-		{
-			Loading,
-			Complete,
-			CanBeRemoved
-		};
+		ThreadPool& thread_pool_;
 
 		std::string exe_path_;
 		std::string local_path_;
@@ -1009,23 +1304,38 @@ namespace KlayGE
 		std::vector<PathInfo> paths_;
 		std::mutex paths_mutex_;
 
+		// Keyed by ResLoadingDesc::Hash(), Match() is only called inside a bucket
 		std::mutex loaded_mutex_;
 		std::mutex loading_mutex_;
-		std::vector<std::pair<ResLoadingDescPtr, std::weak_ptr<void>>> loaded_res_;
-		std::vector<std::pair<ResLoadingDescPtr, std::shared_ptr<volatile LoadingStatus>>> loading_res_;
+		std::unordered_multimap<size_t, LoadedResource> loaded_res_;
+		std::unordered_multimap<size_t, LoadingResource> loading_res_;
+		// One entry per ASyncQuery request that waits for a load, keyed by the resource handed out. Requests that get a null
+		// resource, such as descs with the default CreateResource(), can't be cancelled and aren't registered.
+		std::unordered_multimap<void const*, std::shared_ptr<LoadingState>> requested_res_;
+		size_t next_sweep_size_ = 64;
 
-		bool non_empty_loading_res_queue_ = false;
 		std::condition_variable loading_res_queue_cv_;
 		std::mutex loading_res_queue_mutex_;
-		std::vector<std::pair<ResLoadingDescPtr, std::shared_ptr<volatile LoadingStatus>>> loading_res_queue_;
+		std::priority_queue<LoadingTask> loading_res_queue_;
+		uint64_t loading_task_sequence_ = 0;
+
+		std::mutex loading_threads_mutex_;
+		std::vector<std::future<void>> loading_threads_;
+		std::atomic<uint32_t> num_loading_threads_{0};
+		bool quit_ = false;
 
-		std::future<void> loading_thread_;
-		volatile bool quit_{false};
+		mutable std::mutex statistics_mutex_;
+		std::unordered_map<uint64_t, ResLoadingStatistics> statistics_;
 	};
 
 	ResLoadingDesc::ResLoadingDesc() noexcept = default;
 	ResLoadingDesc::~ResLoadingDesc() noexcept = default;
 
+	size_t ResLoadingDesc::Hash() const
+	{
+		return static_cast<size_t>(this->Type());
+	}
+
 	ResLoader::ResLoader() noexcept = default;
 	ResLoader::~ResLoader() noexcept = default;
 
@@ -1109,9 +1419,14 @@ namespace KlayGE
 		return pimpl_->SyncQuery(res_desc);
 	}
 
-	std::shared_ptr<void> ResLoader::ASyncQuery(ResLoadingDescPtr const & res_desc)
+	std::shared_ptr<void> ResLoader::ASyncQuery(ResLoadingDescPtr const & res_desc, ResLoadingPriority priority)
+	{
+		return pimpl_->ASyncQuery(res_desc, priority);
+	}
+
+	bool ResLoader::Cancel(std::shared_ptr<void> const & res)
 	{
-		return pimpl_->ASyncQuery(res_desc);
+		return pimpl_->Cancel(res);
 	}
 
 	void ResLoader::Unload(std::shared_ptr<void> const & res)
@@ -1128,4 +1443,24 @@ namespace KlayGE
 	{
 		return pimpl_->NumLoadingResources();
 	}
+
+	uint32_t ResLoader::NumLoadingThreads() const noexcept
+	{
+		return pimpl_->NumLoadingThreads();
+	}
+
+	void ResLoader::NumLoadingThreads(uint32_t num)
+	{
+		pimpl_->NumLoadingThreads(num);
+	}
+
+	std::vector<ResLoadingStatistics> ResLoader::Statistics() const
+	{
+		return pimpl_->Statistics();
+	}
+
+	void ResLoader::ResetStatistics()
+	{
+		pimpl_->ResetStatistics();
+	}
 }
@@ -30,6 +30,9 @@
 
 #include <KlayGE/KlayGE.hpp>
 #include <KFL/ErrorHandling.hpp>
+#include <KFL/Thread.hpp>
+#include <KFL/Util.hpp>
+#include <KlayGE/Context.hpp>
 #include <KlayGE/ResLoader.hpp>
 #include <KFL/DllLoader.hpp>
 
@@ -113,6 +116,77 @@ namespace
 		static std::unique_ptr<LZMALoader> instance_;
 	};
 	std::unique_ptr<LZMALoader> LZMALoader::instance_;
+
+	uint32_t const FRAMED_FOURCC = MakeFourCC<'L', 'Z', 'M', 'F'>::value;
+	uint32_t const FRAMED_HEADER_SIZE = sizeof(uint32_t) * 3 + sizeof(uint64_t);
+
+	struct FramedHeader
+	{
+		uint32_t frame_size;
+		uint64_t original_len;
+		uint32_t num_frames;
+	};
+
+	template <typename T>
+	T ReadLE(uint8_t const * p)
+	{
+		T v;
+		std::memcpy(&v, p, sizeof(v));
+		return LE2Native(v);
+	}
+
+	template <typename T>
+	void WriteLE(uint8_t* p, T v)
+	{
+		v = Native2LE(v);
+		std::memcpy(p, &v, sizeof(v));
+	}
+
+	// In 64 bits, since num_frames comes from the file
+	uint64_t FramedDataOffset(uint32_t num_frames)
+	{
+		return FRAMED_HEADER_SIZE + (static_cast<uint64_t>(num_frames) + 1) * sizeof(uint64_t);
+	}
+
+	FramedHeader ReadFramedHeader(std::span<uint8_t const> input)
+	{
+		Verify(input.size() >= FRAMED_HEADER_SIZE);
+		Verify(ReadLE<uint32_t>(&input[0]) == FRAMED_FOURCC);
+
+		FramedHeader header;
+		header.frame_size = ReadLE<uint32_t>(&input[4]);
+		header.original_len = ReadLE<uint64_t>(&input[8]);
+		header.num_frames = ReadLE<uint32_t>(&input[16]);
+		Verify(header.frame_size > 0);
+		Verify(header.num_frames == header.original_len / header.frame_size + ((header.original_len % header.frame_size) != 0));
+		Verify(input.size() >= FramedDataOffset(header.num_frames));
+		return header;
+	}
+
+	std::span<uint8_t const> FramedFrame(std::span<uint8_t const> input, FramedHeader const & header, uint32_t frame)
+	{
+		uint8_t const * offsets = &input[FRAMED_HEADER_SIZE];
+		uint64_t const begin = ReadLE<uint64_t>(offsets + frame * sizeof(uint64_t));
+		uint64_t const end = ReadLE<uint64_t>(offsets + (frame + 1) * sizeof(uint64_t));
+		Verify(FramedDataOffset(header.num_frames) <= begin);
+		Verify(begin <= end);
+		Verify(end <= input.size());
+		return input.subspan(static_cast<size_t>(begin), static_cast<size_t>(end - begin));
+	}
+
+	// A frame has to decode to exactly the length its header gives it
+	void DecodeFrame(uint8_t* output, std::span<uint8_t const> frame, uint64_t frame_len)
+	{
+		Verify(frame.size() >= LZMA_PROPS_SIZE);
+
+		SizeT s_out_len = static_cast<SizeT>(frame_len);
+
+		SizeT s_src_len = static_cast<SizeT>(frame.size() - LZMA_PROPS_SIZE);
+		int res = LZMALoader::Instance().LzmaUncompress(static_cast<Byte*>(output), &s_out_len, &frame[LZMA_PROPS_SIZE], &s_src_len,
+			&frame[0], LZMA_PROPS_SIZE);
+		Verify(0 == res);
+		Verify(s_out_len == frame_len);
+	}
 }
 
 namespace KlayGE
@@ -199,16 +273,110 @@ namespace KlayGE
 
 	void LZMACodec::Decode(void* output, std::span<uint8_t const> input, uint64_t original_len)
 	{
+		// Decodes straight from the input, which can be a memory mapped file
 		uint8_t const * p = static_cast<uint8_t const *>(input.data());
 
-		auto in_data = MakeUniquePtr<uint8_t[]>(static_cast<size_t>(input.size()));
-		std::memcpy(in_data.get(), p, static_cast<std::streamsize>(input.size()));
-
 		SizeT s_out_len = static_cast<SizeT>(original_len);
 
 		SizeT s_src_len = static_cast<SizeT>(input.size() - LZMA_PROPS_SIZE);
-		int res = LZMALoader::Instance().LzmaUncompress(static_cast<Byte*>(output), &s_out_len, &in_data[LZMA_PROPS_SIZE], &s_src_len,
-			&in_data[0], LZMA_PROPS_SIZE);
+		int res = LZMALoader::Instance().LzmaUncompress(static_cast<Byte*>(output), &s_out_len, &p[LZMA_PROPS_SIZE], &s_src_len,
+			&p[0], LZMA_PROPS_SIZE);
 		Verify(0 == res);
 	}
+
+	void LZMACodec::EncodeFramed(std::vector<uint8_t>& output, std::span<uint8_t const> input, uint32_t frame_size)
+	{
+		BOOST_ASSERT(frame_size > 0);
+
+		uint32_t const num_frames = static_cast<uint32_t>((input.size() + frame_size - 1) / frame_size);
+
+		// Loads the DLL before the workers need it
+		LZMALoader::Instance();
+
+		std::vector<std::vector<uint8_t>> frames(num_frames);
+		ParallelFor(Context::Instance().ThreadPoolInstance(), num_frames, 1,
+			[&frames, input, frame_size](uint32_t frame_begin, uint32_t frame_end)
+			{
+				LZMACodec lzma;
+				for (uint32_t frame = frame_begin; frame < frame_end; ++ frame)
+				{
+					size_t const offset = static_cast<size_t>(frame) * frame_size;
+					lzma.Encode(frames[frame], input.subspan(offset, std::min<size_t>(frame_size, input.size() - offset)));
+				}
+			});
+
+		uint64_t offset = FramedDataOffset(num_frames);
+		output.resize(static_cast<size_t>(offset));
+		WriteLE(&output[0], FRAMED_FOURCC);
+		WriteLE(&output[4], frame_size);
+		WriteLE(&output[8], static_cast<uint64_t>(input.size()));
+		WriteLE(&output[16], num_frames);
+		for (uint32_t frame = 0; frame <= num_frames; ++ frame)
+		{
+			WriteLE(&output[FRAMED_HEADER_SIZE + frame * sizeof(uint64_t)], offset);
+			if (frame < num_frames)
+			{
+				offset += frames[frame].size();
+			}
+		}
+
+		output.reserve(static_cast<size_t>(offset));
+		for (auto const & frame : frames)
+		{
+			output.insert(output.end(), frame.begin(), frame.end());
+		}
+	}
+
+	uint64_t LZMACodec::FramedOriginalLength(std::span<uint8_t const> input)
+	{
+		return ReadFramedHeader(input).original_len;
+	}
+
+	void LZMACodec::DecodeFramed(std::vector<uint8_t>& output, std::span<uint8_t const> input)
+	{
+		uint64_t const original_len = FramedOriginalLength(input);
+		output.resize(static_cast<size_t>(original_len));
+		this->DecodeFramed(output.data(), input, 0, original_len);
+	}
+
+	void LZMACodec::DecodeFramed(void* output, std::span<uint8_t const> input, uint64_t offset, uint64_t len)
+	{
+		FramedHeader const header = ReadFramedHeader(input);
+		Verify((offset <= header.original_len) && (len <= header.original_len - offset));
+		if (len == 0)
+		{
+			return;
+		}
+
+		uint32_t const first_frame = static_cast<uint32_t>(offset / header.frame_size);
+		uint32_t const last_frame = static_cast<uint32_t>((offset + len - 1) / header.frame_size) + 1;
+
+		LZMALoader::Instance();
+
+		// Whole frames are decoded straight into the output. Partially covered ones at both ends go through a temporary buffer.
+		uint8_t* dst = static_cast<uint8_t*>(output);
+		ParallelFor(Context::Instance().ThreadPoolInstance(), last_frame - first_frame, 1,
+			[dst, input, offset, len, &header, first_frame](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t frame = first_frame + begin; frame < first_frame + end; ++ frame)
+				{
+					uint64_t const frame_begin = static_cast<uint64_t>(frame) * header.frame_size;
+					uint64_t const frame_len = std::min<uint64_t>(header.frame_size, header.original_len - frame_begin);
+					uint64_t const copy_begin = std::max(frame_begin, offset);
+					uint64_t const copy_end = std::min(frame_begin + frame_len, offset + len);
+
+					if ((copy_begin == frame_begin) && (copy_end == frame_begin + frame_len))
+					{
+						DecodeFrame(dst + (frame_begin - offset), FramedFrame(input, header, frame), frame_len);
+					}
+					else
+					{
+						std::vector<uint8_t> decoded(static_cast<size_t>(frame_len));
+						DecodeFrame(decoded.data(), FramedFrame(input, header, frame), frame_len);
+						std::memcpy(dst + (copy_begin - offset), &decoded[static_cast<size_t>(copy_begin - frame_begin)],
+							static_cast<size_t>(copy_end - copy_begin));
+					}
+				}
+			});
+	}
 }
@@ -44,8 +44,8 @@
 #include <KFL/DllLoader.hpp>
 
 #include <algorithm>
-#include <sstream>
 #include <string>
+#include <vector>
 
 #include <boost/assert.hpp>
 
@@ -188,12 +188,21 @@ namespace KlayGE
 		uint32_t real_index = this->Find(extract_file_path);
 		if (real_index != 0xFFFFFFFF)
 		{
-			auto decoded_file = MakeSharedPtr<std::stringstream>();
-			com_ptr<IOutStream> out_stream(new OutStream(decoded_file), false);
+			PROPVARIANT prop;
+			prop.vt = VT_EMPTY;
+			TIFHR(archive_->GetProperty(real_index, kpidSize, &prop));
+
+			// Extracts into one contiguous buffer, so the item can be consumed in place through ResIdentifier::Data()
+			auto decoded_file = MakeSharedPtr<std::vector<uint8_t>>();
+			if (prop.vt == VT_UI8)
+			{
+				decoded_file->reserve(static_cast<size_t>(prop.uhVal.QuadPart));
+			}
+
+			com_ptr<IOutStream> out_stream(new MemOutStream(decoded_file), false);
 			com_ptr<IArchiveExtractCallback> ecb(new ArchiveExtractCallback(password_, out_stream.get()), false);
 			TIFHR(archive_->Extract(&real_index, 1, false, ecb.get()));
 
-			PROPVARIANT prop;
 			prop.vt = VT_EMPTY;
 			TIFHR(archive_->GetProperty(real_index, kpidMTime, &prop));
 			uint64_t mtime;
@@ -208,7 +217,7 @@ namespace KlayGE
 				mtime = archive_is_->Timestamp();
 			}
 
-			return MakeSharedPtr<ResIdentifier>(res_name, mtime, decoded_file);
+			return MakeSharedPtr<ResIdentifier>(res_name, mtime, std::span<uint8_t const>(*decoded_file), decoded_file);
 		}
 		return ResIdentifierPtr();
 	}
@@ -33,6 +33,8 @@
 #include <KFL/Uuid.hpp>
 #include <KlayGE/ResLoader.hpp>
 
+#include <cstring>
+
 #include <boost/assert.hpp>
 
 #ifdef KLAYGE_PLATFORM_WINDOWS
@@ -224,4 +226,100 @@ namespace KlayGE
 	{
 		return E_NOTIMPL;
 	}
+
+	MemOutStream::MemOutStream(std::shared_ptr<std::vector<uint8_t>> const & buff) noexcept
+		: buff_(buff)
+	{
+	}
+
+	MemOutStream::~MemOutStream() noexcept = default;
+
+	STDMETHODIMP_(ULONG) MemOutStream::AddRef() noexcept
+	{
+		++ ref_count_;
+		return ref_count_;
+	}
+
+	STDMETHODIMP_(ULONG) MemOutStream::Release() noexcept
+	{
+		-- ref_count_;
+		if (0 == ref_count_)
+		{
+			delete this;
+			return 0;
+		}
+		return ref_count_;
+	}
+
+	STDMETHODIMP MemOutStream::QueryInterface(REFGUID iid, void** out_object) noexcept
+	{
+		if (UuidOf<IOutStream>() == reinterpret_cast<Uuid const&>(iid))
+		{
+			*out_object = static_cast<void*>(this);
+			this->AddRef();
+			return S_OK;
+		}
+		else
+		{
+			return E_NOINTERFACE;
+		}
+	}
+
+	STDMETHODIMP MemOutStream::Write(void const * data, UInt32 size, UInt32* processed_size) noexcept
+	{
+		if (pos_ + size > buff_->size())
+		{
+			buff_->resize(static_cast<size_t>(pos_ + size));
+		}
+		std::memcpy(buff_->data() + pos_, data, size);
+		pos_ += size;
+
+		if (processed_size)
+		{
+			*processed_size = size;
+		}
+
+		return S_OK;
+	}
+
+	STDMETHODIMP MemOutStream::Seek(Int64 offset, UInt32 seek_origin, UInt64* new_position) noexcept
+	{
+		int64_t base;
+		switch (seek_origin)
+		{
+		case 0:
+			base = 0;
+			break;
+
+		case 1:
+			base = static_cast<int64_t>(pos_);
+			break;
+
+		case 2:
+			base = static_cast<int64_t>(buff_->size());
+			break;
+
+		default:
+			return STG_E_INVALIDFUNCTION;
+		}
+
+		if (base + offset < 0)
+		{
+			return E_FAIL;
+		}
+
+		pos_ = static_cast<uint64_t>(base + offset);
+		if (new_position)
+		{
+			*new_position = pos_;
+		}
+
+		return S_OK;
+	}
+
+	STDMETHODIMP MemOutStream::SetSize(UInt64 new_size) noexcept
+	{
+		buff_->resize(static_cast<size_t>(new_size));
+		return S_OK;
+	}
 }
@@ -99,14 +99,14 @@ namespace KlayGE
 		if ((Texture::TT_Cube == src->Type()) || (src->ArraySize() > 1))
 		{
 			*src_2d_tex_array_param_ = srv;
-			tech = (filter == TextureFilter::Linear) ? blit_linear_2d_array_tech_ : blit_point_2d_array_tech_;
+			tech = (filter != TextureFilter::Point) ? blit_linear_2d_array_tech_ : blit_point_2d_array_tech_;
 		}
 		else
 		{
 			BOOST_ASSERT(0 == src_array_index);
 
 			*src_2d_tex_param_ = srv;
-			tech = (filter == TextureFilter::Linear) ? blit_linear_2d_tech_ : blit_point_2d_tech_;
+			tech = (filter != TextureFilter::Point) ? blit_linear_2d_tech_ : blit_point_2d_tech_;
 		}
 
 		FrameBufferPtr curr_fb = re.CurFrameBuffer();
@@ -138,7 +138,7 @@ namespace KlayGE
 		*src_scale_param_ = float3(src_width / src_w, src_height / src_h, src_depth / src_d);
 
 		*src_3d_tex_param_ = rf.MakeTextureSrv(src, src_array_index, 1, src_level, 1);
-		RenderTechnique* tech = (filter == TextureFilter::Linear) ? blit_linear_3d_tech_ : blit_point_3d_tech_;
+		RenderTechnique* tech = (filter != TextureFilter::Point) ? blit_linear_3d_tech_ : blit_point_3d_tech_;
 
 		FrameBufferPtr curr_fb = re.CurFrameBuffer();
 		for (uint32_t z = 0; z < dst_depth; ++ z)
@@ -31,6 +31,7 @@
 #include <KlayGE/KlayGE.hpp>
 
 #include <KFL/ErrorHandling.hpp>
+#include <KFL/Hash.hpp>
 #include <KFL/Log.hpp>
 #include <KFL/Util.hpp>
 #include <KFL/Math.hpp>
@@ -337,51 +338,51 @@ namespace
 				break;
 
 			case DeferredRenderingLayer::DT_Position:
-				technique_ = effect_->TechniqueByName("ShowPosition");
+				technique_ = effect_->TechniqueByNameHash(CtHash("ShowPosition"));
 				break;
 
 			case DeferredRenderingLayer::DT_Normal:
-				technique_ = effect_->TechniqueByName("ShowNormal");
+				technique_ = effect_->TechniqueByNameHash(CtHash("ShowNormal"));
 				break;
 
 			case DeferredRenderingLayer::DT_Depth:
-				technique_ = effect_->TechniqueByName("ShowDepth");
+				technique_ = effect_->TechniqueByNameHash(CtHash("ShowDepth"));
 				break;
 
 			case DeferredRenderingLayer::DT_Diffuse:
-				technique_ = effect_->TechniqueByName("ShowDiffuse");
+				technique_ = effect_->TechniqueByNameHash(CtHash("ShowDiffuse"));
 				break;
 
 			case DeferredRenderingLayer::DT_Specular:
-				technique_ = effect_->TechniqueByName("ShowSpecular");
+				technique_ = effect_->TechniqueByNameHash(CtHash("ShowSpecular"));
 				break;
 
 			case DeferredRenderingLayer::DT_Shininess:
-				technique_ = effect_->TechniqueByName("ShowShininess");
+				technique_ = effect_->TechniqueByNameHash(CtHash("ShowShininess"));
 				break;
 
 			case DeferredRenderingLayer::DT_MotionVec:
-				technique_ = effect_->TechniqueByName("ShowMotionVec");
+				technique_ = effect_->TechniqueByNameHash(CtHash("ShowMotionVec"));
 				break;
 
 			case DeferredRenderingLayer::DT_Occlusion:
-				technique_ = effect_->TechniqueByName("ShowOcclusion");
+				technique_ = effect_->TechniqueByNameHash(CtHash("ShowOcclusion"));
 				break;
 
 			case DeferredRenderingLayer::DT_Edge:
 				break;
 
 			case DeferredRenderingLayer::DT_SSVO:
-				technique_ = effect_->TechniqueByName("ShowSSVO");
+				technique_ = effect_->TechniqueByNameHash(CtHash("ShowSSVO"));
 				break;
 
 #if DEFAULT_DEFERRED == TRIDITIONAL_DEFERRED
 			case DeferredRenderingLayer::DT_DiffuseLighting:
-				technique_ = effect_->TechniqueByName("ShowDiffuseLighting");
+				technique_ = effect_->TechniqueByNameHash(CtHash("ShowDiffuseLighting"));
 				break;
 
 			case DeferredRenderingLayer::DT_SpecularLighting:
-				technique_ = effect_->TechniqueByName("ShowSpecularLighting");
+				technique_ = effect_->TechniqueByNameHash(CtHash("ShowSpecularLighting"));
 				break;
 #endif
 
@@ -395,8 +396,9 @@ namespace
 			PostProcess::OnRenderBegin();
 
 			Camera const & camera = Context::Instance().AppInstance().ActiveCamera();
-			*(effect_->ParameterByName("inv_proj")) = camera.InverseProjMatrix();
-			*(effect_->ParameterByName("depth_near_far_invfar")) = float3(camera.NearPlane(), camera.FarPlane(), 1 / camera.FarPlane());
+			*(effect_->ParameterByNameHash(CtHash("inv_proj"))) = camera.InverseProjMatrix();
+			*(effect_->ParameterByNameHash(CtHash("depth_near_far_invfar"))) =
+				float3(camera.NearPlane(), camera.FarPlane(), 1 / camera.FarPlane());
 		}
 	};
 }
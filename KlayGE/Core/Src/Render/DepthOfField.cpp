@@ -32,6 +32,7 @@
 #include <KFL/CXX20/span.hpp>
 
 #include <KFL/ErrorHandling.hpp>
+#include <KFL/Hash.hpp>
 #include <KlayGE/PostProcess.hpp>
 #include <KlayGE/RenderEffect.hpp>
 #include <KlayGE/SATPostProcess.hpp>
@@ -266,11 +267,11 @@ namespace KlayGE
 			uint32_t const out_height = in_height;
 			if (!bokeh_tex_ || (bokeh_tex_->Width(0) != out_width) || (bokeh_tex_->Height(0) != out_height))
 			{
-				*(effect_->ParameterByName("in_width_height")) =
+				*(effect_->ParameterByNameHash(CtHash("in_width_height"))) =
 					float4(static_cast<float>(in_width), static_cast<float>(in_height), 1.0f / in_width, 1.0f / in_height);
-				*(effect_->ParameterByName("bokeh_width_height")) =
+				*(effect_->ParameterByNameHash(CtHash("bokeh_width_height"))) =
 					float4(static_cast<float>(out_width), static_cast<float>(out_height), 1.0f / out_width, 1.0f / out_height);
-				*(effect_->ParameterByName("background_offset")) = static_cast<float>(in_width + max_radius_ * 4);
+				*(effect_->ParameterByNameHash(CtHash("background_offset"))) = static_cast<float>(in_width + max_radius_ * 4);
 
 				RenderFactory& rf = Context::Instance().RenderFactoryInstance();
 				RenderDeviceCaps const& caps = rf.RenderEngineInstance().DeviceCaps();
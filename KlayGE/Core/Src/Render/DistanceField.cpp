@@ -29,6 +29,19 @@
  */
 
 #include <KlayGE/KlayGE.hpp>
+#include <KFL/Thread.hpp>
+#include <KlayGE/Context.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(KLAYGE_SSE2_SUPPORT)
+#include <emmintrin.h>
+#elif defined(KLAYGE_NEON_SUPPORT) && defined(KLAYGE_CPU_ARM64)
+#include <arm_neon.h>
+#endif
+
 #include <KlayGE/DistanceField.hpp>
 
 namespace
@@ -67,127 +80,283 @@ namespace
 		return df;
 	}
 
-	float AADist(std::vector<float> const & img, std::vector<float2> const & grad,
-		int width, int offset_addr, int2 const & offset_dist_xy, float2 const & new_dist)
+	float const INFINITE_DISTANCE = std::numeric_limits<float>::infinity();
+
+	// Felzenszwalb and Huttenlocher, "Distance Transforms of Sampled Functions". The lower envelope of the parabolas rooted at
+	// the finite samples of a line is built in one pass and sampled in the next, so a line takes O(n).
+	class LowerEnvelope
 	{
-		int closest = offset_addr - offset_dist_xy.y() * width - offset_dist_xy.x(); // Index to the edge pixel pointed to from c
-		float val = MathLib::clamp(img[closest], 0.0f, 1.0f);
-		if (0 == val)
+	public:
+		explicit LowerEnvelope(uint32_t length)
+			: roots_(length), bounds_(length + 1)
 		{
-			return 1e10f;
 		}
 
-		float di = MathLib::length(new_dist);
-		float df;
-		if (0 == di)
-		{
-			df = EdgeDistance(grad[closest], val);
-		}
-		else
+		// Transforms a line in place. nearest can be null.
+		void Transform(float* sq_dist, int32_t* nearest, uint32_t length)
 		{
-			df = EdgeDistance(new_dist, val);
-		}
-		return di + df;
-	}
+			int32_t k = -1;
+			for (uint32_t q = 0; q < length; ++ q)
+			{
+				if (!(sq_dist[q] < INFINITE_DISTANCE))
+				{
+					continue;
+				}
 
-	bool UpdateDistance(int x, int y, int dx, int dy, std::vector<float> const & img, int width,
-		std::vector<float2> const & grad, std::vector<int2>& dist_xy, std::vector<float>& dist)
-	{
-		float const EPSILON = 1e-3f;
+				// Intersections are in double, they lose too much for big distances in float
+				double const fq = sq_dist[q] + static_cast<double>(q) * q;
+				double s = 0;
+				while (k >= 0)
+				{
+					Root const & root = roots_[k];
+					s = (fq - (root.value + static_cast<double>(root.pos) * root.pos)) / (2.0 * (q - root.pos));
+					if (s > bounds_[k])
+					{
+						break;
+					}
+					-- k;
+				}
 
-		bool changed = false;
-		int addr = y * width + x;
-		float old_dist = dist[addr];
-		if (old_dist > 0)
-		{
-			int offset_addr = (y + dy) * width + (x + dx);
-			int2 new_dist_xy = dist_xy[offset_addr] - int2(dx, dy);
-			float new_dist = AADist(img, grad, width, offset_addr, dist_xy[offset_addr], new_dist_xy);
-			if (new_dist < old_dist - EPSILON)
+				++ k;
+				roots_[k].pos = q;
+				roots_[k].value = sq_dist[q];
+				roots_[k].nearest = nearest ? nearest[q] : -1;
+				bounds_[k] = (k == 0) ? -std::numeric_limits<double>::infinity() : s;
+			}
+
+			if (k < 0)
 			{
-				dist_xy[addr] = new_dist_xy;
-				dist[addr] = new_dist;
-				changed = true;
+				return;
+			}
+
+			bounds_[k + 1] = std::numeric_limits<double>::infinity();
+			int32_t j = 0;
+			for (uint32_t q = 0; q < length; ++ q)
+			{
+				while (bounds_[j + 1] < q)
+				{
+					++ j;
+				}
+
+				float const d = static_cast<float>(static_cast<int32_t>(q - roots_[j].pos));
+				sq_dist[q] = d * d + roots_[j].value;
+				if (nearest)
+				{
+					nearest[q] = roots_[j].nearest;
+				}
 			}
 		}
 
-		return changed;
+	private:
+		struct Root
+		{
+			uint32_t pos;
+			float value;
+			int32_t nearest;
+		};
+
+		std::vector<Root> roots_;
+		std::vector<double> bounds_;
+	};
+
+	uint32_t const LINE_GROUP = 16;
+
+	// Line x of outer starts at outer * outer_stride + x, for x in [0, width), and has length samples stride apart. Groups of
+	// adjacent lines are gathered together, so every sample step reads and writes one run of memory.
+	void TransformAxis(std::span<float> sq_dist, std::span<int32_t> nearest, uint32_t width, uint32_t num_outers,
+		uint32_t outer_stride, uint32_t length, uint32_t stride)
+	{
+		uint32_t const groups_per_outer = (width + LINE_GROUP - 1) / LINE_GROUP;
+		uint32_t const min_groups_per_task = std::max(65536 / (std::min(width, LINE_GROUP) * length), 1U);
+		ParallelFor(Context::Instance().ThreadPoolInstance(), num_outers * groups_per_outer, min_groups_per_task,
+			[&](uint32_t begin, uint32_t end)
+			{
+				LowerEnvelope envelope(length);
+				std::vector<float> lines;
+				std::vector<int32_t> line_nearest;
+				if (stride != 1)
+				{
+					lines.resize(LINE_GROUP * length);
+					line_nearest.resize(nearest.empty() ? 0 : LINE_GROUP * length);
+				}
+
+				for (uint32_t group = begin; group < end; ++ group)
+				{
+					uint32_t const x_begin = (group % groups_per_outer) * LINE_GROUP;
+					uint32_t const num_lines = std::min(width - x_begin, LINE_GROUP);
+					size_t const start = static_cast<size_t>(group / groups_per_outer) * outer_stride + x_begin;
+
+					if (stride == 1)
+					{
+						BOOST_ASSERT(1 == width);
+						envelope.Transform(&sq_dist[start], nearest.empty() ? nullptr : &nearest[start], length);
+						continue;
+					}
+
+					for (uint32_t i = 0; i < length; ++ i)
+					{
+						for (uint32_t l = 0; l < num_lines; ++ l)
+						{
+							lines[l * length + i] = sq_dist[start + i * stride + l];
+						}
+					}
+					if (!nearest.empty())
+					{
+						for (uint32_t i = 0; i < length; ++ i)
+						{
+							for (uint32_t l = 0; l < num_lines; ++ l)
+							{
+								line_nearest[l * length + i] = nearest[start + i * stride + l];
+							}
+						}
+					}
+
+					for (uint32_t l = 0; l < num_lines; ++ l)
+					{
+						envelope.Transform(&lines[l * length], nearest.empty() ? nullptr : &line_nearest[l * length], length);
+					}
+
+					for (uint32_t i = 0; i < length; ++ i)
+					{
+						for (uint32_t l = 0; l < num_lines; ++ l)
+						{
+							sq_dist[start + i * stride + l] = lines[l * length + i];
+						}
+					}
+					if (!nearest.empty())
+					{
+						for (uint32_t i = 0; i < length; ++ i)
+						{
+							for (uint32_t l = 0; l < num_lines; ++ l)
+							{
+								nearest[start + i * stride + l] = line_nearest[l * length + i];
+							}
+						}
+					}
+				}
+			});
 	}
 
-	void AAEuclideanDistance(std::vector<float> const & img, std::vector<float2> const & grad,
-		int width, int height, std::vector<float>& dist)
+	template <typename T>
+	void QuantizeDistanceImpl(std::span<float const> dist, float max_dist, std::span<T> output)
 	{
-		std::vector<int2> dist_xy(img.size(), int2(0, 0));
+		BOOST_ASSERT(dist.size() == output.size());
 
-		for (size_t i = 0; i < img.size(); ++ i)
+		float const inv_max_dist = 1 / max_dist;
+		float const scale = std::numeric_limits<T>::max();
+
+		size_t i = 0;
+#if defined(KLAYGE_SSE2_SUPPORT)
+		__m128 const inv_max_dist_4 = _mm_set1_ps(inv_max_dist);
+		__m128 const scale_4 = _mm_set1_ps(scale);
+		__m128 const zero_4 = _mm_setzero_ps();
+		__m128 const one_4 = _mm_set1_ps(1);
+		for (; i + 8 <= dist.size(); i += 8)
 		{
-			if (img[i] <= 0)
+			__m128i const q0 = _mm_cvttps_epi32(
+				_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(&dist[i + 0]), inv_max_dist_4), zero_4), one_4), scale_4));
+			__m128i const q1 = _mm_cvttps_epi32(
+				_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(&dist[i + 4]), inv_max_dist_4), zero_4), one_4), scale_4));
+			if constexpr (sizeof(T) == 1)
+			{
+				__m128i const q16 = _mm_packs_epi32(q0, q1);
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(&output[i]), _mm_packus_epi16(q16, q16));
+			}
+			else
 			{
-				dist[i] = 1e10f;
+				// No unsigned saturation before SSE4.1, so go through the signed range
+				__m128i const bias = _mm_set1_epi32(0x8000);
+				__m128i const q16 = _mm_packs_epi32(_mm_sub_epi32(q0, bias), _mm_sub_epi32(q1, bias));
+				__m128i const unbias = _mm_set1_epi16(static_cast<short>(0x8000));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(&output[i]), _mm_xor_si128(q16, unbias));
 			}
-			else if (img[i] < 1)
+		}
+#elif defined(KLAYGE_NEON_SUPPORT) && defined(KLAYGE_CPU_ARM64)
+		float32x4_t const inv_max_dist_4 = vdupq_n_f32(inv_max_dist);
+		float32x4_t const scale_4 = vdupq_n_f32(scale);
+		float32x4_t const zero_4 = vdupq_n_f32(0);
+		float32x4_t const one_4 = vdupq_n_f32(1);
+		for (; i + 8 <= dist.size(); i += 8)
+		{
+			uint32x4_t const q0 = vcvtq_u32_f32(
+				vmulq_f32(vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(&dist[i + 0]), inv_max_dist_4), zero_4), one_4), scale_4));
+			uint32x4_t const q1 = vcvtq_u32_f32(
+				vmulq_f32(vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(&dist[i + 4]), inv_max_dist_4), zero_4), one_4), scale_4));
+			uint16x8_t const q16 = vcombine_u16(vmovn_u32(q0), vmovn_u32(q1));
+			if constexpr (sizeof(T) == 1)
 			{
-				dist[i] = EdgeDistance(grad[i], img[i]);
+				vst1_u8(&output[i], vmovn_u16(q16));
 			}
 			else
 			{
-				dist[i] = 0;
+				vst1q_u16(&output[i], q16);
 			}
 		}
-
-		bool changed;
-		do
+#endif
+		for (; i < dist.size(); ++ i)
 		{
-			changed = false;
+			output[i] = static_cast<T>(MathLib::clamp(dist[i] * inv_max_dist, 0.0f, 1.0f) * scale);
+		}
+	}
 
-			for (int y = 1; y < height; ++ y)
-			{
-				// Scan right, propagate distances from above & left
-				for (int x = 0; x < width; ++ x)
-				{
-					if (x > 0)
-					{
-						changed |= UpdateDistance(x, y, -1, +0, img, width, grad, dist_xy, dist);
-						changed |= UpdateDistance(x, y, -1, -1, img, width, grad, dist_xy, dist);
-					}
-					changed |= UpdateDistance(x, y, +0, -1, img, width, grad, dist_xy, dist);
-					if (x < width - 1)
-					{
-						changed |= UpdateDistance(x, y, +1, -1, img, width, grad, dist_xy, dist);
-					}
-				}
+	// Covered pixels are split by coverage, so the edges of the ones in a bin are about as far from their centers
+	int const NUM_COVERAGE_BINS = 4;
 
-				// Scan left, propagate distance from right
-				for (int x = width - 2; x >= 0; -- x)
+	void AAEuclideanDistance(std::vector<float> const & img, std::vector<float2> const & grad,
+		int width, int height, std::vector<float>& dist)
+	{
+		// Every covered pixel is a candidate for the edge. The nearest center isn't always the nearest edge, a far pixel covered
+		// more can be nearer. So the exact transform finds the nearest pixel of every coverage bin, and the coverage of each tells
+		// how far the edge is from its center.
+		std::vector<int32_t> nearest(img.size() * NUM_COVERAGE_BINS);
+		{
+			std::vector<float> sq_dist(img.size());
+			for (int bin = 0; bin < NUM_COVERAGE_BINS; ++ bin)
+			{
+				float const min_coverage = static_cast<float>(bin) / NUM_COVERAGE_BINS;
+				float const max_coverage = (bin == NUM_COVERAGE_BINS - 1) ? 1e10f : static_cast<float>(bin + 1) / NUM_COVERAGE_BINS;
+				for (size_t i = 0; i < img.size(); ++ i)
 				{
-					changed |= UpdateDistance(x, y, +1, +0, img, width, grad, dist_xy, dist);
+					sq_dist[i] = ((img[i] > min_coverage) && (img[i] <= max_coverage)) ? 0 : INFINITE_DISTANCE;
 				}
+				SquaredDistanceTransform(sq_dist, std::span(nearest).subspan(bin * img.size(), img.size()), width, height, 1);
 			}
+		}
 
-			for (int y = height - 2; y >= 0; -- y)
+		ParallelFor(Context::Instance().ThreadPoolInstance(), height, 16,
+			[&img, &grad, width, &dist, &nearest](uint32_t begin, uint32_t end)
 			{
-				// Scan left, propagate distances from below & right
-				for (int x = width - 1; x >= 0; -- x)
+				for (int y = begin; y < static_cast<int>(end); ++ y)
 				{
-					if (x < width - 1)
-					{
-						changed |= UpdateDistance(x, y, +1, +0, img, width, grad, dist_xy, dist);
-						changed |= UpdateDistance(x, y, +1, +1, img, width, grad, dist_xy, dist);
-					}
-					changed |= UpdateDistance(x, y, +0, +1, img, width, grad, dist_xy, dist);
-					if (x > 0)
+					for (int x = 0; x < width; ++ x)
 					{
-						changed |= UpdateDistance(x, y, -1, +1, img, width, grad, dist_xy, dist);
+						int const addr = y * width + x;
+						if (img[addr] >= 1)
+						{
+							dist[addr] = 0;
+						}
+						else if (img[addr] > 0)
+						{
+							dist[addr] = EdgeDistance(grad[addr], img[addr]);
+						}
+						else
+						{
+							float min_dist = 1e10f;
+							for (int bin = 0; bin < NUM_COVERAGE_BINS; ++ bin)
+							{
+								int const closest = nearest[bin * img.size() + addr];
+								if (closest >= 0)
+								{
+									float2 const offset(static_cast<float>(x - closest % width), static_cast<float>(y - closest / width));
+									float const candidate = MathLib::length(offset) + EdgeDistance(offset, std::min(img[closest], 1.0f));
+									min_dist = std::min(min_dist, candidate);
+								}
+							}
+							dist[addr] = min_dist;
+						}
 					}
 				}
-
-				// Scan right, propagate distance from left
-				for (int x = 1; x < width; ++ x)
-				{
-					changed |= UpdateDistance(x, y, -1, +0, img, width, grad, dist_xy, dist);
-				}
-			}
-		} while (changed);
+			});
 	}
 
 	void ComputeGradient(std::vector<float> const& img, int w, int h, std::vector<float2>& grad)
@@ -283,4 +452,96 @@ namespace KlayGE
 			dist_data[i] = inside[i] - outside[i];
 		}
 	}
+
+	void SquaredDistanceTransform(std::span<float> sq_dist, std::span<int32_t> nearest,
+		uint32_t width, uint32_t height, uint32_t depth)
+	{
+		BOOST_ASSERT(sq_dist.size() == static_cast<size_t>(width) * height * depth);
+		BOOST_ASSERT(nearest.empty() || (nearest.size() == sq_dist.size()));
+
+		for (size_t i = 0; i < nearest.size(); ++ i)
+		{
+			nearest[i] = (sq_dist[i] < INFINITE_DISTANCE) ? static_cast<int32_t>(i) : -1;
+		}
+
+		// Separable, one axis after another. Lines along an axis are independent of each other.
+		TransformAxis(sq_dist, nearest, 1, height * depth, width, width, 1);
+		if (height > 1)
+		{
+			TransformAxis(sq_dist, nearest, width, depth, width * height, height, width);
+		}
+		if (depth > 1)
+		{
+			TransformAxis(sq_dist, nearest, width, height, width, depth, width * height);
+		}
+	}
+
+	void ComputeBinaryDistance(std::span<uint8_t const> volume, uint32_t width, uint32_t height, uint32_t depth,
+		std::vector<float>& dist_data)
+	{
+		BOOST_ASSERT(volume.size() == static_cast<size_t>(width) * height * depth);
+
+		dist_data.resize(volume.size());
+
+		size_t i = 0;
+#if defined(KLAYGE_SSE2_SUPPORT)
+		__m128i const zero = _mm_setzero_si128();
+		__m128i const inf = _mm_castps_si128(_mm_set1_ps(INFINITE_DISTANCE));
+		for (; i + 16 <= volume.size(); i += 16)
+		{
+			__m128i const empty8 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(&volume[i])), zero);
+			__m128i const empty16_lo = _mm_unpacklo_epi8(empty8, empty8);
+			__m128i const empty16_hi = _mm_unpackhi_epi8(empty8, empty8);
+			_mm_storeu_ps(&dist_data[i + 0], _mm_castsi128_ps(_mm_and_si128(_mm_unpacklo_epi16(empty16_lo, empty16_lo), inf)));
+			_mm_storeu_ps(&dist_data[i + 4], _mm_castsi128_ps(_mm_and_si128(_mm_unpackhi_epi16(empty16_lo, empty16_lo), inf)));
+			_mm_storeu_ps(&dist_data[i + 8], _mm_castsi128_ps(_mm_and_si128(_mm_unpacklo_epi16(empty16_hi, empty16_hi), inf)));
+			_mm_storeu_ps(&dist_data[i + 12], _mm_castsi128_ps(_mm_and_si128(_mm_unpackhi_epi16(empty16_hi, empty16_hi), inf)));
+		}
+#elif defined(KLAYGE_NEON_SUPPORT) && defined(KLAYGE_CPU_ARM64)
+		uint32x4_t const inf = vreinterpretq_u32_f32(vdupq_n_f32(INFINITE_DISTANCE));
+		for (; i + 16 <= volume.size(); i += 16)
+		{
+			uint8x16_t const v = vld1q_u8(&volume[i]);
+			uint16x8_t const v16_lo = vmovl_u8(vget_low_u8(v));
+			uint16x8_t const v16_hi = vmovl_high_u8(v);
+			vst1q_f32(&dist_data[i + 0], vreinterpretq_f32_u32(vandq_u32(vceqzq_u32(vmovl_u16(vget_low_u16(v16_lo))), inf)));
+			vst1q_f32(&dist_data[i + 4], vreinterpretq_f32_u32(vandq_u32(vceqzq_u32(vmovl_high_u16(v16_lo)), inf)));
+			vst1q_f32(&dist_data[i + 8], vreinterpretq_f32_u32(vandq_u32(vceqzq_u32(vmovl_u16(vget_low_u16(v16_hi))), inf)));
+			vst1q_f32(&dist_data[i + 12], vreinterpretq_f32_u32(vandq_u32(vceqzq_u32(vmovl_high_u16(v16_hi)), inf)));
+		}
+#endif
+		for (; i < volume.size(); ++ i)
+		{
+			dist_data[i] = (volume[i] != 0) ? 0 : INFINITE_DISTANCE;
+		}
+
+		SquaredDistanceTransform(dist_data, {}, width, height, depth);
+
+		i = 0;
+#if defined(KLAYGE_SSE2_SUPPORT)
+		for (; i + 4 <= dist_data.size(); i += 4)
+		{
+			_mm_storeu_ps(&dist_data[i], _mm_sqrt_ps(_mm_loadu_ps(&dist_data[i])));
+		}
+#elif defined(KLAYGE_NEON_SUPPORT) && defined(KLAYGE_CPU_ARM64)
+		for (; i + 4 <= dist_data.size(); i += 4)
+		{
+			vst1q_f32(&dist_data[i], vsqrtq_f32(vld1q_f32(&dist_data[i])));
+		}
+#endif
+		for (; i < dist_data.size(); ++ i)
+		{
+			dist_data[i] = std::sqrt(dist_data[i]);
+		}
+	}
+
+	void QuantizeDistance(std::span<float const> dist, float max_dist, std::span<uint8_t> output)
+	{
+		QuantizeDistanceImpl(dist, max_dist, output);
+	}
+
+	void QuantizeDistance(std::span<float const> dist, float max_dist, std::span<uint16_t> output)
+	{
+		QuantizeDistanceImpl(dist, max_dist, output);
+	}
 }
@@ -35,9 +35,638 @@
 
 #include <boost/assert.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#if defined(KLAYGE_SSE2_SUPPORT)
+#include <emmintrin.h>
+#elif defined(KLAYGE_NEON_SUPPORT) && defined(KLAYGE_CPU_ARM64)
+#include <arm_neon.h>
+#endif
+
 #include <KFL/Math.hpp>
 #include <KFL/Half.hpp>
 
+namespace
+{
+	using namespace KlayGE;
+
+	// Element formats with four 8-bit channels that differ only in the channel order and the color space. Converting
+	// between them never needs a float in between.
+	bool IsUNorm8x4Format(ElementFormat fmt) noexcept
+	{
+		return (fmt == EF_ABGR8) || (fmt == EF_ARGB8) || (fmt == EF_ABGR8_SRGB) || (fmt == EF_ARGB8_SRGB);
+	}
+
+	class UNorm8Tables final
+	{
+	public:
+		UNorm8Tables()
+		{
+			for (uint32_t i = 0; i < 256; ++ i)
+			{
+				unorm_to_float_[i] = i / 255.0f;
+				srgb_to_linear_float_[i] = MathLib::srgb_to_linear(i / 255.0f);
+			}
+
+			// linear_to_srgb is monotonic, so the code of a value is the number of thresholds not above it. Each threshold is the
+			// smallest float that reaches its code, found by a binary search over the bit patterns of non-negative floats.
+			for (uint32_t code = 1; code < 256; ++ code)
+			{
+				uint32_t lo = 0;
+				uint32_t hi = std::bit_cast<uint32_t>(2.0f);
+				while (lo < hi)
+				{
+					uint32_t const mid = lo + (hi - lo) / 2;
+					if (LinearToSrgbUNorm8Slow(std::bit_cast<float>(mid)) >= code)
+					{
+						hi = mid;
+					}
+					else
+					{
+						lo = mid + 1;
+					}
+				}
+				linear_to_srgb_thresholds_[code - 1] = std::bit_cast<float>(lo);
+			}
+			linear_to_srgb_thresholds_[255] = std::numeric_limits<float>::infinity();
+
+			// Buckets of the top 17 bits of floats between the first and the last threshold. Each one starts with the code of its
+			// first value, and rarely has a threshold inside.
+			first_bucket_ = std::bit_cast<uint32_t>(linear_to_srgb_thresholds_[0]) >> 15;
+			uint32_t const last_bucket = std::bit_cast<uint32_t>(linear_to_srgb_thresholds_[254]) >> 15;
+			bucket_codes_.resize(last_bucket - first_bucket_ + 1);
+			uint32_t code = 0;
+			for (uint32_t i = 0; i < bucket_codes_.size(); ++ i)
+			{
+				float const bucket_start = std::bit_cast<float>((first_bucket_ + i) << 15);
+				while (linear_to_srgb_thresholds_[code] <= bucket_start)
+				{
+					++ code;
+				}
+				bucket_codes_[i] = static_cast<uint8_t>(code);
+			}
+
+			for (uint32_t i = 0; i < 256; ++ i)
+			{
+				srgb_to_linear_unorm_[i] = FloatToUNorm8(srgb_to_linear_float_[i]);
+				linear_to_srgb_unorm_[i] = this->LinearToSrgbUNorm8(unorm_to_float_[i]);
+			}
+		}
+
+		float UNormToFloat(uint8_t v) const noexcept
+		{
+			return unorm_to_float_[v];
+		}
+		float SrgbToLinearFloat(uint8_t v) const noexcept
+		{
+			return srgb_to_linear_float_[v];
+		}
+		std::array<uint8_t, 256> const & SrgbToLinearUNormTable() const noexcept
+		{
+			return srgb_to_linear_unorm_;
+		}
+		std::array<uint8_t, 256> const & LinearToSrgbUNormTable() const noexcept
+		{
+			return linear_to_srgb_unorm_;
+		}
+
+		// Same result as LinearToSrgbUNorm8Slow for finite inputs, without a pow
+		uint8_t LinearToSrgbUNorm8(float v) const noexcept
+		{
+			if (!(v >= linear_to_srgb_thresholds_[0]))
+			{
+				return 0;
+			}
+			if (v >= linear_to_srgb_thresholds_[254])
+			{
+				return 255;
+			}
+
+			uint32_t code = bucket_codes_[(std::bit_cast<uint32_t>(v) >> 15) - first_bucket_];
+			while (linear_to_srgb_thresholds_[code] <= v)
+			{
+				++ code;
+			}
+			return static_cast<uint8_t>(code);
+		}
+
+		static uint8_t FloatToUNorm8(float v) noexcept
+		{
+			return static_cast<uint8_t>(MathLib::clamp(static_cast<int>(v * 255.0f + 0.5f), 0, 255));
+		}
+		static uint8_t LinearToSrgbUNorm8Slow(float v) noexcept
+		{
+			return FloatToUNorm8(MathLib::linear_to_srgb(v));
+		}
+
+	private:
+		std::array<float, 256> unorm_to_float_;
+		std::array<float, 256> srgb_to_linear_float_;
+		std::array<float, 256> linear_to_srgb_thresholds_;
+		uint32_t first_bucket_;
+		std::vector<uint8_t> bucket_codes_;
+		std::array<uint8_t, 256> srgb_to_linear_unorm_;
+		std::array<uint8_t, 256> linear_to_srgb_unorm_;
+	};
+
+	UNorm8Tables const & GetUNorm8Tables()
+	{
+		static UNorm8Tables const tables;
+		return tables;
+	}
+
+	uint32_t SwapRB(uint32_t v) noexcept
+	{
+		return (v & 0xFF00FF00U) | ((v & 0x000000FFU) << 16) | ((v >> 16) & 0x000000FFU);
+	}
+
+	// Clamped before the truncation, which is undefined for floats out of the int range. NaNs become 0, the same as the SIMD
+	// path.
+	uint32_t FloatToUNorm(float v, float max_value) noexcept
+	{
+		return static_cast<uint32_t>(std::min(std::max(0.0f, v * max_value + 0.5f), max_value));
+	}
+
+#if defined(KLAYGE_SSE2_SUPPORT)
+	__m128i SwapRB(__m128i v) noexcept
+	{
+		__m128i const rb = _mm_and_si128(v, _mm_set1_epi32(0x00FF00FF));
+		return _mm_or_si128(_mm_and_si128(v, _mm_set1_epi32(static_cast<int>(0xFF00FF00U))),
+			_mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16)));
+	}
+
+	// Four packed 4x8-bit elements to four colors. Integers convert to float exactly and _mm_div_ps rounds like the scalar
+	// division, so the results are bit identical.
+	void UNorm8x4ToColors(__m128i packed, Color* output) noexcept
+	{
+		__m128i const zero = _mm_setzero_si128();
+		__m128 const scale = _mm_set1_ps(255.0f);
+		__m128i const lo = _mm_unpacklo_epi8(packed, zero);
+		__m128i const hi = _mm_unpackhi_epi8(packed, zero);
+		_mm_storeu_ps(&output[0].r(), _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+		_mm_storeu_ps(&output[1].r(), _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+		_mm_storeu_ps(&output[2].r(), _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+		_mm_storeu_ps(&output[3].r(), _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+	}
+
+	// Four colors to four packed 4x8-bit elements. The two saturating packs clamp the truncated integers to [0, 255], the same
+	// as MathLib::clamp in the scalar path.
+	__m128i ColorsToUNorm8x4(Color const * input) noexcept
+	{
+		__m128 const scale = _mm_set1_ps(255.0f);
+		__m128 const bias = _mm_set1_ps(0.5f);
+		__m128i const c0 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&input[0].r()), scale), bias));
+		__m128i const c1 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&input[1].r()), scale), bias));
+		__m128i const c2 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&input[2].r()), scale), bias));
+		__m128i const c3 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&input[3].r()), scale), bias));
+		return _mm_packus_epi16(_mm_packs_epi32(c0, c1), _mm_packs_epi32(c2, c3));
+	}
+
+	// Four halves in the low 16 bits of each lane to floats. Handles zeros, denormals, infinities and NaNs like half::operator float.
+	__m128 HalfToFloat4(__m128i h) noexcept
+	{
+		__m128i const e = _mm_and_si128(h, _mm_set1_epi32(0x7C00));
+		__m128i const m = _mm_and_si128(h, _mm_set1_epi32(0x03FF));
+		__m128i const sign = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16);
+
+		// Normal, infinity and NaN: rebias the exponent, infinity and NaN get the maximum float exponent
+		__m128i const is_inf_nan = _mm_cmpeq_epi32(e, _mm_set1_epi32(0x7C00));
+		__m128i bits = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x7FFF)), 13);
+		bits = _mm_add_epi32(bits, _mm_set1_epi32((127 - 15) << 23));
+		bits = _mm_or_si128(bits, _mm_and_si128(is_inf_nan, _mm_set1_epi32(0x7F800000)));
+
+		// Zero and denormal: m * 2^-24 is exact
+		__m128i const is_denorm = _mm_cmpeq_epi32(e, _mm_setzero_si128());
+		__m128 const denorm = _mm_mul_ps(_mm_cvtepi32_ps(m), _mm_set1_ps(1.0f / (1 << 24)));
+
+		bits = _mm_or_si128(_mm_andnot_si128(is_denorm, bits), _mm_and_si128(is_denorm, _mm_castps_si128(denorm)));
+		return _mm_castsi128_ps(_mm_or_si128(bits, sign));
+	}
+
+	// Four floats to halves in the low 16 bits of each lane. Rounds, overflows and underflows like half::half(float).
+	__m128i FloatToHalf4(__m128 v) noexcept
+	{
+		__m128i const i = _mm_castps_si128(v);
+		__m128i const sign = _mm_and_si128(_mm_srli_epi32(i, 16), _mm_set1_epi32(0x8000));
+		__m128i const e = _mm_srli_epi32(_mm_and_si128(i, _mm_set1_epi32(0x7F800000)), 23);
+		__m128i const m = _mm_and_si128(i, _mm_set1_epi32(0x007FFFFF));
+
+		// Normal: drop 13 significand bits and round up on the highest dropped one. A carry moves into the exponent.
+		// Everything above the half range saturates to infinity.
+		__m128i normal = _mm_or_si128(_mm_slli_epi32(_mm_sub_epi32(e, _mm_set1_epi32(127 - 15)), 10), _mm_srli_epi32(m, 13));
+		normal = _mm_add_epi32(normal, _mm_and_si128(_mm_srli_epi32(m, 12), _mm_set1_epi32(1)));
+		__m128i const overflow = _mm_cmpgt_epi32(normal, _mm_set1_epi32(0x7C00));
+		normal = _mm_or_si128(_mm_andnot_si128(overflow, normal), _mm_and_si128(overflow, _mm_set1_epi32(0x7C00)));
+
+		// Infinity and NaN. NaNs stay NaNs.
+		__m128i const is_inf_nan = _mm_cmpeq_epi32(e, _mm_set1_epi32(0xFF));
+		__m128i const nan_bit = _mm_andnot_si128(_mm_cmpeq_epi32(m, _mm_setzero_si128()), _mm_set1_epi32(0x0200));
+		__m128i const inf_nan = _mm_or_si128(_mm_set1_epi32(0x7C00), _mm_or_si128(_mm_srli_epi32(m, 13), nan_bit));
+
+		// Denormal and zero: the result is |v| * 2^24 rounded half up. The scaling is exact, and so is the fraction left after
+		// truncation.
+		__m128 const abs_v = _mm_castsi128_ps(_mm_and_si128(i, _mm_set1_epi32(0x7FFFFFFF)));
+		__m128 const scaled = _mm_mul_ps(abs_v, _mm_set1_ps(static_cast<float>(1 << 24)));
+		__m128i denorm = _mm_cvttps_epi32(scaled);
+		__m128 const frac = _mm_sub_ps(scaled, _mm_cvtepi32_ps(denorm));
+		denorm = _mm_sub_epi32(denorm, _mm_castps_si128(_mm_cmpge_ps(frac, _mm_set1_ps(0.5f))));
+
+		__m128i const is_denorm = _mm_cmplt_epi32(e, _mm_set1_epi32(127 - 15 + 1));
+		__m128i bits = _mm_or_si128(_mm_andnot_si128(is_inf_nan, normal), _mm_and_si128(is_inf_nan, inf_nan));
+		bits = _mm_or_si128(_mm_andnot_si128(is_denorm, bits), _mm_and_si128(is_denorm, denorm));
+		return _mm_or_si128(bits, sign);
+	}
+
+	__m128i LoadHalf4(void const * p) noexcept
+	{
+		return _mm_unpacklo_epi16(_mm_loadl_epi64(static_cast<__m128i const *>(p)), _mm_setzero_si128());
+	}
+
+	// Two sets of four halves to eight packed ones. Sign extension keeps the signed saturation of _mm_packs_epi32 from
+	// touching the bits.
+	__m128i PackHalf8(__m128i lo, __m128i hi) noexcept
+	{
+		return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(lo, 16), 16), _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16));
+	}
+
+	// B10G11R11F channel with 5-bit exponent and M-bit mantissa, already shifted to the bottom of each lane, to floats
+	template <int M>
+	__m128 SmallFloatToFloat4(__m128i v) noexcept
+	{
+		__m128i const e = _mm_and_si128(v, _mm_set1_epi32(0x1F << M));
+		__m128i const m = _mm_and_si128(v, _mm_set1_epi32((1 << M) - 1));
+
+		__m128i const is_inf_nan = _mm_cmpeq_epi32(e, _mm_set1_epi32(0x1F << M));
+		__m128i bits = _mm_add_epi32(_mm_slli_epi32(v, 23 - M), _mm_set1_epi32((127 - 15) << 23));
+		bits = _mm_or_si128(bits, _mm_and_si128(is_inf_nan, _mm_set1_epi32(0x7F800000)));
+
+		__m128i const is_denorm = _mm_cmpeq_epi32(e, _mm_setzero_si128());
+		__m128 const denorm = _mm_mul_ps(_mm_cvtepi32_ps(m), _mm_set1_ps(1.0f / (1 << (14 + M))));
+
+		bits = _mm_or_si128(_mm_andnot_si128(is_denorm, bits), _mm_and_si128(is_denorm, _mm_castps_si128(denorm)));
+		return _mm_castsi128_ps(bits);
+	}
+#elif defined(KLAYGE_NEON_SUPPORT) && defined(KLAYGE_CPU_ARM64)
+	uint32x4_t SwapRB(uint32x4_t v) noexcept
+	{
+		uint32x4_t const rb = vandq_u32(v, vdupq_n_u32(0x00FF00FF));
+		return vorrq_u32(vandq_u32(v, vdupq_n_u32(0xFF00FF00U)), vorrq_u32(vshlq_n_u32(rb, 16), vshrq_n_u32(rb, 16)));
+	}
+
+	void UNorm8x4ToColors(uint8x16_t packed, Color* output) noexcept
+	{
+		float32x4_t const scale = vdupq_n_f32(255.0f);
+		uint16x8_t const lo = vmovl_u8(vget_low_u8(packed));
+		uint16x8_t const hi = vmovl_u8(vget_high_u8(packed));
+		vst1q_f32(&output[0].r(), vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo))), scale));
+		vst1q_f32(&output[1].r(), vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo))), scale));
+		vst1q_f32(&output[2].r(), vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi))), scale));
+		vst1q_f32(&output[3].r(), vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi))), scale));
+	}
+
+	// fcvtzs truncates and saturates like the scalar conversion on this architecture, the narrowing moves clamp to [0, 255]
+	uint8x16_t ColorsToUNorm8x4(Color const * input) noexcept
+	{
+		float32x4_t const scale = vdupq_n_f32(255.0f);
+		float32x4_t const bias = vdupq_n_f32(0.5f);
+		int32x4_t const c0 = vcvtq_s32_f32(vaddq_f32(vmulq_f32(vld1q_f32(&input[0].r()), scale), bias));
+		int32x4_t const c1 = vcvtq_s32_f32(vaddq_f32(vmulq_f32(vld1q_f32(&input[1].r()), scale), bias));
+		int32x4_t const c2 = vcvtq_s32_f32(vaddq_f32(vmulq_f32(vld1q_f32(&input[2].r()), scale), bias));
+		int32x4_t const c3 = vcvtq_s32_f32(vaddq_f32(vmulq_f32(vld1q_f32(&input[3].r()), scale), bias));
+		return vcombine_u8(vqmovn_u16(vcombine_u16(vqmovun_s32(c0), vqmovun_s32(c1))),
+			vqmovn_u16(vcombine_u16(vqmovun_s32(c2), vqmovun_s32(c3))));
+	}
+#endif
+
+	// Converts the leading elements of formats that have a faster path than the per-channel scalar code. Returns how many were
+	// converted.
+	uint32_t ConvertToABGR32FFast(ElementFormat fmt, uint8_t const * p, uint32_t num_elems, Color* output)
+	{
+		switch (fmt)
+		{
+		case EF_R8:
+		case EF_GR8:
+			{
+				// A table lookup per channel is cheaper than both the division and the shuffles to widen 1 or 2 channels
+				auto const & tables = GetUNorm8Tables();
+				if (fmt == EF_R8)
+				{
+					for (uint32_t i = 0; i < num_elems; ++ i)
+					{
+						output[i] = Color(tables.UNormToFloat(p[i]), 0, 0, 1);
+					}
+				}
+				else
+				{
+					for (uint32_t i = 0; i < num_elems; ++ i)
+					{
+						output[i] = Color(tables.UNormToFloat(p[i * 2 + 0]), tables.UNormToFloat(p[i * 2 + 1]), 0, 1);
+					}
+				}
+				return num_elems;
+			}
+
+		case EF_ARGB8_SRGB:
+		case EF_ABGR8_SRGB:
+			{
+				auto const & tables = GetUNorm8Tables();
+				uint32_t const r = (fmt == EF_ARGB8_SRGB) ? 2 : 0;
+				for (uint32_t i = 0; i < num_elems; ++ i, p += 4)
+				{
+					output[i] = Color(tables.SrgbToLinearFloat(p[r]), tables.SrgbToLinearFloat(p[1]),
+						tables.SrgbToLinearFloat(p[2 - r]), tables.SrgbToLinearFloat(p[3]));
+				}
+				return num_elems;
+			}
+
+#if defined(KLAYGE_SSE2_SUPPORT)
+		case EF_ABGR8:
+		case EF_ARGB8:
+			{
+				uint32_t const num_simd = num_elems & ~3U;
+				for (uint32_t i = 0; i < num_simd; i += 4)
+				{
+					__m128i packed = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p + i * 4));
+					if (fmt == EF_ARGB8)
+					{
+						packed = SwapRB(packed);
+					}
+					UNorm8x4ToColors(packed, output + i);
+				}
+				return num_simd;
+			}
+
+		case EF_A2BGR10:
+			{
+				__m128 const scale_rgb = _mm_set1_ps(1023.0f);
+				__m128 const scale_a = _mm_set1_ps(3.0f);
+				__m128i const mask = _mm_set1_epi32(0x03FF);
+				uint32_t const num_simd = num_elems & ~3U;
+				for (uint32_t i = 0; i < num_simd; i += 4)
+				{
+					// Channel per register, then transposed to a color per register
+					__m128i const s = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p + i * 4));
+					__m128 r = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(s, mask)), scale_rgb);
+					__m128 g = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(s, 10), mask)), scale_rgb);
+					__m128 b = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(s, 20), mask)), scale_rgb);
+					__m128 a = _mm_div_ps(_mm_cvtepi32_ps(_mm_srli_epi32(s, 30)), scale_a);
+					_MM_TRANSPOSE4_PS(r, g, b, a);
+					_mm_storeu_ps(&output[i + 0].r(), r);
+					_mm_storeu_ps(&output[i + 1].r(), g);
+					_mm_storeu_ps(&output[i + 2].r(), b);
+					_mm_storeu_ps(&output[i + 3].r(), a);
+				}
+				return num_simd;
+			}
+
+		case EF_B10G11R11F:
+			{
+				__m128i const mask11 = _mm_set1_epi32(0x07FF);
+				uint32_t const num_simd = num_elems & ~3U;
+				for (uint32_t i = 0; i < num_simd; i += 4)
+				{
+					__m128i const s = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p + i * 4));
+					__m128 r = SmallFloatToFloat4<6>(_mm_and_si128(s, mask11));
+					__m128 g = SmallFloatToFloat4<6>(_mm_and_si128(_mm_srli_epi32(s, 11), mask11));
+					__m128 b = SmallFloatToFloat4<5>(_mm_srli_epi32(s, 22));
+					__m128 a = _mm_set1_ps(1.0f);
+					_MM_TRANSPOSE4_PS(r, g, b, a);
+					_mm_storeu_ps(&output[i + 0].r(), r);
+					_mm_storeu_ps(&output[i + 1].r(), g);
+					_mm_storeu_ps(&output[i + 2].r(), b);
+					_mm_storeu_ps(&output[i + 3].r(), a);
+				}
+				return num_simd;
+			}
+
+		case EF_R16F:
+			{
+				__m128 const zero_one = _mm_setr_ps(0, 0, 0, 1);
+				uint32_t const num_simd = num_elems & ~3U;
+				for (uint32_t i = 0; i < num_simd; i += 4)
+				{
+					__m128 const v = HalfToFloat4(LoadHalf4(p + i * 2));
+					_mm_storeu_ps(&output[i + 0].r(), _mm_move_ss(zero_one, v));
+					_mm_storeu_ps(&output[i + 1].r(), _mm_move_ss(zero_one, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+					_mm_storeu_ps(&output[i + 2].r(), _mm_move_ss(zero_one, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+					_mm_storeu_ps(&output[i + 3].r(), _mm_move_ss(zero_one, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+				}
+				return num_simd;
+			}
+
+		case EF_GR16F:
+			{
+				__m128 const zero_one = _mm_setr_ps(0, 1, 0, 1);
+				uint32_t const num_simd = num_elems & ~1U;
+				for (uint32_t i = 0; i < num_simd; i += 2)
+				{
+					__m128 const v = HalfToFloat4(LoadHalf4(p + i * 4));
+					_mm_storeu_ps(&output[i + 0].r(), _mm_movelh_ps(v, zero_one));
+					_mm_storeu_ps(&output[i + 1].r(), _mm_shuffle_ps(v, zero_one, _MM_SHUFFLE(1, 0, 3, 2)));
+				}
+				return num_simd;
+			}
+
+		case EF_ABGR16F:
+			for (uint32_t i = 0; i < num_elems; ++ i)
+			{
+				_mm_storeu_ps(&output[i].r(), HalfToFloat4(LoadHalf4(p + i * 8)));
+			}
+			return num_elems;
+#elif defined(KLAYGE_NEON_SUPPORT) && defined(KLAYGE_CPU_ARM64)
+		case EF_ABGR8:
+		case EF_ARGB8:
+			{
+				uint32_t const num_simd = num_elems & ~3U;
+				for (uint32_t i = 0; i < num_simd; i += 4)
+				{
+					uint32x4_t packed = vld1q_u32(reinterpret_cast<uint32_t const *>(p + i * 4));
+					if (fmt == EF_ARGB8)
+					{
+						packed = SwapRB(packed);
+					}
+					UNorm8x4ToColors(vreinterpretq_u8_u32(packed), output + i);
+				}
+				return num_simd;
+			}
+
+		case EF_ABGR16F:
+			// Widening a half to a float is exact, so the hardware conversion gives the same floats as the scalar code
+			for (uint32_t i = 0; i < num_elems; ++ i)
+			{
+				vst1q_f32(&output[i].r(), vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(reinterpret_cast<uint16_t const *>(p + i * 8)))));
+			}
+			return num_elems;
+#endif
+
+		default:
+			return 0;
+		}
+	}
+
+	// The counterpart of ConvertToABGR32FFast
+	uint32_t ConvertFromABGR32FFast(ElementFormat fmt, Color const * input, uint32_t num_elems, uint8_t* p)
+	{
+		switch (fmt)
+		{
+		case EF_ARGB8_SRGB:
+		case EF_ABGR8_SRGB:
+			{
+				auto const & tables = GetUNorm8Tables();
+				uint32_t const r = (fmt == EF_ARGB8_SRGB) ? 2 : 0;
+				for (uint32_t i = 0; i < num_elems; ++ i, p += 4)
+				{
+					p[r] = tables.LinearToSrgbUNorm8(input[i].r());
+					p[1] = tables.LinearToSrgbUNorm8(input[i].g());
+					p[2 - r] = tables.LinearToSrgbUNorm8(input[i].b());
+					p[3] = tables.LinearToSrgbUNorm8(input[i].a());
+				}
+				return num_elems;
+			}
+
+#if defined(KLAYGE_SSE2_SUPPORT)
+		case EF_ABGR8:
+		case EF_ARGB8:
+			{
+				uint32_t const num_simd = num_elems & ~3U;
+				for (uint32_t i = 0; i < num_simd; i += 4)
+				{
+					__m128i packed = ColorsToUNorm8x4(input + i);
+					if (fmt == EF_ARGB8)
+					{
+						packed = SwapRB(packed);
+					}
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(p + i * 4), packed);
+				}
+				return num_simd;
+			}
+
+		case EF_R8:
+			{
+				uint32_t const num_simd = num_elems & ~3U;
+				for (uint32_t i = 0; i < num_simd; i += 4)
+				{
+					// Only the R byte of each packed element survives
+					__m128i const r = _mm_and_si128(ColorsToUNorm8x4(input + i), _mm_set1_epi32(0xFF));
+					__m128i const packed = _mm_packus_epi16(_mm_packs_epi32(r, r), r);
+					*reinterpret_cast<uint32_t*>(p + i) = static_cast<uint32_t>(_mm_cvtsi128_si32(packed));
+				}
+				return num_simd;
+			}
+
+		case EF_GR8:
+			{
+				uint32_t const num_simd = num_elems & ~3U;
+				for (uint32_t i = 0; i < num_simd; i += 4)
+				{
+					// Keeps the 16-bit GR half of each packed element
+					__m128i gr = ColorsToUNorm8x4(input + i);
+					gr = _mm_shufflelo_epi16(gr, _MM_SHUFFLE(3, 1, 2, 0));
+					gr = _mm_shufflehi_epi16(gr, _MM_SHUFFLE(3, 1, 2, 0));
+					gr = _mm_shuffle_epi32(gr, _MM_SHUFFLE(3, 1, 2, 0));
+					_mm_storel_epi64(reinterpret_cast<__m128i*>(p + i * 2), gr);
+				}
+				return num_simd;
+			}
+
+		case EF_A2BGR10:
+			{
+				__m128 const scale_rgb = _mm_set1_ps(1023.0f);
+				__m128 const scale_a = _mm_set1_ps(3.0f);
+				__m128 const bias = _mm_set1_ps(0.5f);
+				__m128 const zero = _mm_setzero_ps();
+				uint32_t const num_simd = num_elems & ~3U;
+				for (uint32_t i = 0; i < num_simd; i += 4)
+				{
+					__m128 r = _mm_loadu_ps(&input[i + 0].r());
+					__m128 g = _mm_loadu_ps(&input[i + 1].r());
+					__m128 b = _mm_loadu_ps(&input[i + 2].r());
+					__m128 a = _mm_loadu_ps(&input[i + 3].r());
+					_MM_TRANSPOSE4_PS(r, g, b, a);
+
+					// Clamped before the truncation, like FloatToUNorm. _mm_max_ps returns its second operand for NaNs, which
+					// then become 0 like in the scalar path.
+					r = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(r, scale_rgb), bias), zero), scale_rgb);
+					g = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(g, scale_rgb), bias), zero), scale_rgb);
+					b = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(b, scale_rgb), bias), zero), scale_rgb);
+					a = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(a, scale_a), bias), zero), scale_a);
+
+					__m128i s = _mm_cvttps_epi32(r);
+					s = _mm_or_si128(s, _mm_slli_epi32(_mm_cvttps_epi32(g), 10));
+					s = _mm_or_si128(s, _mm_slli_epi32(_mm_cvttps_epi32(b), 20));
+					s = _mm_or_si128(s, _mm_slli_epi32(_mm_cvttps_epi32(a), 30));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(p + i * 4), s);
+				}
+				return num_simd;
+			}
+
+		case EF_R16F:
+			{
+				uint32_t const num_simd = num_elems & ~3U;
+				for (uint32_t i = 0; i < num_simd; i += 4)
+				{
+					__m128 const c0 = _mm_loadu_ps(&input[i + 0].r());
+					__m128 const c1 = _mm_loadu_ps(&input[i + 1].r());
+					__m128 const c2 = _mm_loadu_ps(&input[i + 2].r());
+					__m128 const c3 = _mm_loadu_ps(&input[i + 3].r());
+					__m128 const r = _mm_movelh_ps(_mm_unpacklo_ps(c0, c1), _mm_unpacklo_ps(c2, c3));
+					__m128i const h = FloatToHalf4(r);
+					_mm_storel_epi64(reinterpret_cast<__m128i*>(p + i * 2), PackHalf8(h, h));
+				}
+				return num_simd;
+			}
+
+		case EF_GR16F:
+			{
+				uint32_t const num_simd = num_elems & ~3U;
+				for (uint32_t i = 0; i < num_simd; i += 4)
+				{
+					__m128 const gr01 = _mm_movelh_ps(_mm_loadu_ps(&input[i + 0].r()), _mm_loadu_ps(&input[i + 1].r()));
+					__m128 const gr23 = _mm_movelh_ps(_mm_loadu_ps(&input[i + 2].r()), _mm_loadu_ps(&input[i + 3].r()));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(p + i * 4), PackHalf8(FloatToHalf4(gr01), FloatToHalf4(gr23)));
+				}
+				return num_simd;
+			}
+
+		case EF_ABGR16F:
+			{
+				uint32_t const num_simd = num_elems & ~1U;
+				for (uint32_t i = 0; i < num_simd; i += 2)
+				{
+					__m128i const h0 = FloatToHalf4(_mm_loadu_ps(&input[i + 0].r()));
+					__m128i const h1 = FloatToHalf4(_mm_loadu_ps(&input[i + 1].r()));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(p + i * 8), PackHalf8(h0, h1));
+				}
+				return num_simd;
+			}
+#elif defined(KLAYGE_NEON_SUPPORT) && defined(KLAYGE_CPU_ARM64)
+		case EF_ABGR8:
+		case EF_ARGB8:
+			{
+				uint32_t const num_simd = num_elems & ~3U;
+				for (uint32_t i = 0; i < num_simd; i += 4)
+				{
+					uint32x4_t packed = vreinterpretq_u32_u8(ColorsToUNorm8x4(input + i));
+					if (fmt == EF_ARGB8)
+					{
+						packed = SwapRB(packed);
+					}
+					vst1q_u32(reinterpret_cast<uint32_t*>(p + i * 4), packed);
+				}
+				return num_simd;
+			}
+#endif
+
+		default:
+			return 0;
+		}
+	}
+}
+
 namespace KlayGE
 {
 	void ConvertToABGR32F(ElementFormat fmt, void const * input, uint32_t num_elems, Color* output)
@@ -45,6 +674,12 @@ namespace KlayGE
 		uint8_t const * p = static_cast<uint8_t const *>(input);
 		uint32_t const elem_size = NumFormatBytes(fmt);
 
+		// The fast path takes the leading elements, the switch below the rest
+		uint32_t const num_fast = ConvertToABGR32FFast(fmt, p, num_elems, output);
+		p += num_fast * elem_size;
+		output += num_fast;
+		num_elems -= num_fast;
+
 		switch (fmt)
 		{
 		case EF_A8:
@@ -578,7 +1213,7 @@ namespace KlayGE
 
 					if (0x1F == exponent) // INF or NAN
 					{
-						result[0] = 0x7F800000 | (mantissa << 17);
+						result[j] = 0x7F800000 | (mantissa << 17);
 					}
 					else
 					{
@@ -612,12 +1247,12 @@ namespace KlayGE
 				}
 
 				// Z Channel (5-bit mantissa)
-				mantissa = (s >> 22) & 0x3F;
+				mantissa = (s >> 22) & 0x1F;
 				exponent = (s >> 27) & 0x1F;
 
 				if (0x1F == exponent) // INF or NAN
 				{
-					result[2] = 0x7F800000 | (mantissa << 17);
+					result[2] = 0x7F800000 | (mantissa << 18);
 				}
 				else
 				{
@@ -752,6 +1387,11 @@ namespace KlayGE
 		uint8_t* p = static_cast<uint8_t*>(output);
 		uint32_t const elem_size = NumFormatBytes(fmt);
 
+		uint32_t const num_fast = ConvertFromABGR32FFast(fmt, input, num_elems, p);
+		p += num_fast * elem_size;
+		input += num_fast;
+		num_elems -= num_fast;
+
 		switch (fmt)
 		{
 		case EF_A8:
@@ -870,10 +1510,10 @@ namespace KlayGE
 		case EF_A2BGR10:
 			for (uint32_t i = 0; i < num_elems; ++ i, ++ input, p += elem_size)
 			{
-				int r = MathLib::clamp(static_cast<int>(input->r() * 1023.0f + 0.5f), 0, 1023);
-				int g = MathLib::clamp(static_cast<int>(input->g() * 1023.0f + 0.5f), 0, 1023);
-				int b = MathLib::clamp(static_cast<int>(input->b() * 1023.0f + 0.5f), 0, 1023);
-				int a = MathLib::clamp(static_cast<int>(input->a() * 3.0f + 0.5f), 0, 3);
+				uint32_t const r = FloatToUNorm(input->r(), 1023.0f);
+				uint32_t const g = FloatToUNorm(input->g(), 1023.0f);
+				uint32_t const b = FloatToUNorm(input->b(), 1023.0f);
+				uint32_t const a = FloatToUNorm(input->a(), 3.0f);
 
 				*reinterpret_cast<uint32_t*>(p) = r | (g << 10) | (b << 20) | (a << 30);
 			}
@@ -1553,4 +2193,72 @@ namespace KlayGE
 			KFL_UNREACHABLE("Not supported element format");
 		}
 	}
+
+	void ConvertFormat(ElementFormat src_fmt, void const * input, ElementFormat dst_fmt, void* output, uint32_t num_elems)
+	{
+		if (src_fmt == dst_fmt)
+		{
+			std::memcpy(output, input, num_elems * NumFormatBytes(src_fmt));
+		}
+		else if (IsUNorm8x4Format(src_fmt) && IsUNorm8x4Format(dst_fmt))
+		{
+			bool const swap_rb = ((src_fmt == EF_ARGB8) || (src_fmt == EF_ARGB8_SRGB)) != ((dst_fmt == EF_ARGB8) || (dst_fmt == EF_ARGB8_SRGB));
+			if (IsSRGB(src_fmt) == IsSRGB(dst_fmt))
+			{
+				BOOST_ASSERT(swap_rb);
+
+				uint32_t const * src = static_cast<uint32_t const *>(input);
+				uint32_t* dst = static_cast<uint32_t*>(output);
+				uint32_t i = 0;
+#if defined(KLAYGE_SSE2_SUPPORT)
+				for (; i + 4 <= num_elems; i += 4)
+				{
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+						SwapRB(_mm_loadu_si128(reinterpret_cast<__m128i const *>(src + i))));
+				}
+#elif defined(KLAYGE_NEON_SUPPORT) && defined(KLAYGE_CPU_ARM64)
+				for (; i + 4 <= num_elems; i += 4)
+				{
+					vst1q_u32(dst + i, SwapRB(vld1q_u32(src + i)));
+				}
+#endif
+				for (; i < num_elems; ++ i)
+				{
+					dst[i] = SwapRB(src[i]);
+				}
+			}
+			else
+			{
+				// Every channel goes through the color space conversion, alpha included, the same as with a Color in between
+				auto const & tables = GetUNorm8Tables();
+				auto const & lut = IsSRGB(dst_fmt) ? tables.LinearToSrgbUNormTable() : tables.SrgbToLinearUNormTable();
+				uint8_t const * src_bytes = static_cast<uint8_t const *>(input);
+				uint8_t* dst_bytes = static_cast<uint8_t*>(output);
+				uint32_t const r = swap_rb ? 2 : 0;
+				for (uint32_t i = 0; i < num_elems; ++ i, src_bytes += 4, dst_bytes += 4)
+				{
+					dst_bytes[0] = lut[src_bytes[r]];
+					dst_bytes[1] = lut[src_bytes[1]];
+					dst_bytes[2] = lut[src_bytes[2 - r]];
+					dst_bytes[3] = lut[src_bytes[3]];
+				}
+			}
+		}
+		else
+		{
+			// A small buffer of colors at a time instead of one for the whole input
+			uint8_t const * src = static_cast<uint8_t const *>(input);
+			uint8_t* dst = static_cast<uint8_t*>(output);
+			uint32_t const src_elem_size = NumFormatBytes(src_fmt);
+			uint32_t const dst_elem_size = NumFormatBytes(dst_fmt);
+
+			std::array<Color, 256> buffer;
+			for (uint32_t i = 0; i < num_elems; i += static_cast<uint32_t>(buffer.size()))
+			{
+				uint32_t const n = std::min(num_elems - i, static_cast<uint32_t>(buffer.size()));
+				ConvertToABGR32F(src_fmt, src + i * src_elem_size, n, buffer.data());
+				ConvertFromABGR32F(dst_fmt, buffer.data(), n, dst + i * dst_elem_size);
+			}
+		}
+	}
 }
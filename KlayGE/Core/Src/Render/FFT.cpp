@@ -16,6 +16,7 @@
 #include <KlayGE/RenderFactory.hpp>
 #include <KlayGE/RenderEngine.hpp>
 #include <KFL/Half.hpp>
+#include <KFL/Hash.hpp>
 #include <KlayGE/RenderEffect.hpp>
 #include <KlayGE/FrameBuffer.hpp>
 
@@ -302,16 +303,16 @@ namespace KlayGE
 		uint32_t pstride = width_;
 		float phase_base = -PI2 / (width_ * height_);
 
-		*(effect_->ParameterByName("thread_count")) = thread_count;
+		*(effect_->ParameterByNameHash(CtHash("thread_count"))) = thread_count;
 
 		// X direction
 		
-		*(effect_->ParameterByName("ostride")) = ostride;
-		*(effect_->ParameterByName("pstride")) = pstride;
+		*(effect_->ParameterByNameHash(CtHash("ostride"))) = ostride;
+		*(effect_->ParameterByNameHash(CtHash("pstride"))) = pstride;
 
-		*(effect_->ParameterByName("istride")) = istride;
-		*(effect_->ParameterByName("istride3")) = uint2(0, istride3);
-		*(effect_->ParameterByName("phase_base")) = phase_base;
+		*(effect_->ParameterByNameHash(CtHash("istride"))) = istride;
+		*(effect_->ParameterByNameHash(CtHash("istride3"))) = uint2(0, istride3);
+		*(effect_->ParameterByNameHash(CtHash("phase_base"))) = phase_base;
 		this->Radix008A(tmp_buffer_uav_, src_srv_, thread_count, istride, true);
 
 		ShaderResourceViewPtr srvs[2] = { dst_srv_, tmp_buffer_srv_ };
@@ -324,9 +325,9 @@ namespace KlayGE
 			istride /= 8;
 			istride3 /= 8;
 			phase_base *= 8.0f;
-			*(effect_->ParameterByName("istride")) = istride;
-			*(effect_->ParameterByName("istride3")) = uint2(0, istride3);
-			*(effect_->ParameterByName("phase_base")) = phase_base;
+			*(effect_->ParameterByNameHash(CtHash("istride"))) = istride;
+			*(effect_->ParameterByNameHash(CtHash("istride3"))) = uint2(0, istride3);
+			*(effect_->ParameterByNameHash(CtHash("phase_base"))) = phase_base;
 			this->Radix008A(uavs[index], srvs[!index], thread_count, istride, false);
 			index = !index;
 
@@ -337,15 +338,15 @@ namespace KlayGE
 		
 		ostride = height_ / 8;
 		pstride = 1;
-		*(effect_->ParameterByName("ostride")) = ostride;
-		*(effect_->ParameterByName("pstride")) = pstride;
+		*(effect_->ParameterByNameHash(CtHash("ostride"))) = ostride;
+		*(effect_->ParameterByNameHash(CtHash("pstride"))) = pstride;
 
 		istride /= 8;
 		istride3 /= 8;
 		phase_base *= 8.0f;
-		*(effect_->ParameterByName("istride")) = istride;
-		*(effect_->ParameterByName("istride3")) = uint2(istride3, 0);
-		*(effect_->ParameterByName("phase_base")) = phase_base;
+		*(effect_->ParameterByNameHash(CtHash("istride"))) = istride;
+		*(effect_->ParameterByNameHash(CtHash("istride3"))) = uint2(istride3, 0);
+		*(effect_->ParameterByNameHash(CtHash("phase_base"))) = phase_base;
 		this->Radix008A(uavs[index], srvs[!index], thread_count, istride, false);
 		index = !index;
 
@@ -355,9 +356,9 @@ namespace KlayGE
 			istride /= 8;
 			istride3 /= 8;
 			phase_base *= 8.0f;
-			*(effect_->ParameterByName("istride")) = istride;
-			*(effect_->ParameterByName("istride3")) = uint2(istride3, 0);
-			*(effect_->ParameterByName("phase_base")) = phase_base;
+			*(effect_->ParameterByNameHash(CtHash("istride"))) = istride;
+			*(effect_->ParameterByNameHash(CtHash("istride3"))) = uint2(istride3, 0);
+			*(effect_->ParameterByNameHash(CtHash("phase_base"))) = phase_base;
 			this->Radix008A(uavs[index], srvs[!index], thread_count, istride, false);
 			index = !index;
 
@@ -447,11 +448,11 @@ namespace KlayGE
 			uint32_t istride = width_ / 8;
 			float phase_base = -PI2 / width_;
 
-			*(effect_->ParameterByName("ostride2")) = uint2(width_ / 8, 0);
-			*(effect_->ParameterByName("iscale2")) = uint2(8, 1);
+			*(effect_->ParameterByNameHash(CtHash("ostride2"))) = uint2(width_ / 8, 0);
+			*(effect_->ParameterByNameHash(CtHash("iscale2"))) = uint2(8, 1);
 
-			*(effect_->ParameterByName("istride2")) = uint4(istride, 0, istride - 1, static_cast<uint32_t>(-1));
-			*(effect_->ParameterByName("phase_base2")) = phase_base;
+			*(effect_->ParameterByNameHash(CtHash("istride2"))) = uint4(istride, 0, istride - 1, static_cast<uint32_t>(-1));
+			*(effect_->ParameterByNameHash(CtHash("phase_base2"))) = phase_base;
 			this->Radix008A(tmp_real_tex_[index], tmp_imag_tex_[index], in_real, in_imag, width_ / 8, height_, 1 == istride, false);
 			index = !index;
 
@@ -460,8 +461,8 @@ namespace KlayGE
 			{
 				istride /= 8;
 				phase_base *= 8;
-				*(effect_->ParameterByName("istride2")) = uint4(istride, 0, istride - 1, static_cast<uint32_t>(-1));
-				*(effect_->ParameterByName("phase_base2")) = phase_base;
+				*(effect_->ParameterByNameHash(CtHash("istride2"))) = uint4(istride, 0, istride - 1, static_cast<uint32_t>(-1));
+				*(effect_->ParameterByNameHash(CtHash("phase_base2"))) = phase_base;
 				this->Radix008A(tmp_real_tex_[index], tmp_imag_tex_[index], tmp_real_srv_[!index], tmp_imag_srv_[!index], width_ / 8, height_, 1 == istride, false);
 				index = !index;
 
@@ -475,11 +476,11 @@ namespace KlayGE
 			uint32_t istride = height_ / 8;
 			float phase_base = -PI2 / height_;
 
-			*(effect_->ParameterByName("ostride2")) = uint2(0, height_ / 8);
-			*(effect_->ParameterByName("iscale2")) = uint2(1, 8);
+			*(effect_->ParameterByNameHash(CtHash("ostride2"))) = uint2(0, height_ / 8);
+			*(effect_->ParameterByNameHash(CtHash("iscale2"))) = uint2(1, 8);
 
-			*(effect_->ParameterByName("istride2")) = uint4(0, istride, static_cast<uint32_t>(-1), istride - 1);
-			*(effect_->ParameterByName("phase_base2")) = phase_base;
+			*(effect_->ParameterByNameHash(CtHash("istride2"))) = uint4(0, istride, static_cast<uint32_t>(-1), istride - 1);
+			*(effect_->ParameterByNameHash(CtHash("phase_base2"))) = phase_base;
 			if (1 == istride)
 			{
 				this->Radix008A(out_real, out_imag, tmp_real_srv_[!index], tmp_imag_srv_[!index], width_, height_ / 8, false, 1 == istride);
@@ -495,8 +496,8 @@ namespace KlayGE
 			{
 				istride /= 8;
 				phase_base *= 8;
-				*(effect_->ParameterByName("istride2")) = uint4(0, istride, static_cast<uint32_t>(-1), istride - 1);
-				*(effect_->ParameterByName("phase_base2")) = phase_base;
+				*(effect_->ParameterByNameHash(CtHash("istride2"))) = uint4(0, istride, static_cast<uint32_t>(-1), istride - 1);
+				*(effect_->ParameterByNameHash(CtHash("phase_base2"))) = phase_base;
 				if (1 == istride)
 				{
 					this->Radix008A(out_real, out_imag, tmp_real_srv_[!index], tmp_imag_srv_[!index], width_, height_ / 8, false, 1 == istride);
@@ -48,14 +48,20 @@
 #include <KlayGE/LZMACodec.hpp>
 #include <KlayGE/TransientBuffer.hpp>
 #include <KFL/Hash.hpp>
+#include <KFL/CXX20/bit.hpp>
+#include <KFL/Thread.hpp>
 #include <KlayGE/App3D.hpp>
 #include <KlayGE/Window.hpp>
 
 #include <algorithm>
+#include <array>
 #include <vector>
 #include <cstring>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <list>
+#include <optional>
 #include <unordered_map>
 #include <tuple>
 #include <type_traits>
@@ -67,21 +73,177 @@
 
 namespace KlayGE
 {
+	GlyphAtlas::GlyphAtlas(uint32_t tex_size, uint32_t char_size)
+		: tex_size_(tex_size), char_size_(char_size)
+	{
+	}
+
+	void GlyphAtlas::BeginText()
+	{
+		++ tick_;
+	}
+
+	GlyphAtlas::Glyph const* GlyphAtlas::Find(wchar_t ch) const
+	{
+		auto const iter = glyphs_.find(ch);
+		return (iter != glyphs_.end()) ? &iter->second.glyph : nullptr;
+	}
+
+	GlyphAtlas::Glyph const* GlyphAtlas::Touch(wchar_t ch)
+	{
+		auto const iter = glyphs_.find(ch);
+		if (iter == glyphs_.end())
+		{
+			return nullptr;
+		}
+
+		iter->second.tick = tick_;
+		lru_.splice(lru_.begin(), lru_, iter->second.lru_iter);
+		return &iter->second.glyph;
+	}
+
+	GlyphAtlas::Glyph const* GlyphAtlas::Insert(wchar_t ch, uint32_t width, uint32_t height, bool& evicted)
+	{
+		BOOST_ASSERT(glyphs_.find(ch) == glyphs_.end());
+
+		evicted = false;
+
+		Glyph glyph;
+		glyph.w_class = this->SlotSizeClass(width);
+		glyph.h_class = this->SlotSizeClass(height);
+		bool placed = this->AllocSlot(glyph);
+		while (!placed)
+		{
+			if (lru_.empty())
+			{
+				// Everything is evicted, but the free slots are all too small
+				this->Reset();
+				placed = this->AllocSlot(glyph);
+				break;
+			}
+
+			auto const lru_iter = glyphs_.find(lru_.back());
+			if (lru_iter->second.tick == tick_)
+			{
+				break;
+			}
+
+			free_slots_[lru_iter->second.glyph.h_class][lru_iter->second.glyph.w_class].push_back(lru_iter->second.glyph.slot);
+			lru_.pop_back();
+			glyphs_.erase(lru_iter);
+			evicted = true;
+
+			placed = this->AllocSlot(glyph);
+		}
+		if (!placed)
+		{
+			return nullptr;
+		}
+
+		glyph.rc.left()		= static_cast<float>(glyph.slot.x()) / tex_size_;
+		glyph.rc.top()		= static_cast<float>(glyph.slot.y()) / tex_size_;
+		glyph.rc.right()	= glyph.rc.left() + static_cast<float>(width) / tex_size_;
+		glyph.rc.bottom()	= glyph.rc.top() + static_cast<float>(height) / tex_size_;
+
+		lru_.push_front(ch);
+		auto const iter = glyphs_.emplace(ch, Entry{glyph, tick_, lru_.begin()}).first;
+		return &iter->second.glyph;
+	}
+
+	uint32_t GlyphAtlas::SlotSize(uint32_t size_class) const noexcept
+	{
+		return ((size_class + 1) * char_size_ + GLYPH_SIZE_CLASSES - 1) / GLYPH_SIZE_CLASSES;
+	}
+
+	uint32_t GlyphAtlas::SlotSizeClass(uint32_t glyph_size) const noexcept
+	{
+		uint32_t const size = std::min(glyph_size + 1, char_size_);
+		return std::max((size * GLYPH_SIZE_CLASSES + char_size_ - 1) / char_size_, 1U) - 1;
+	}
+
+	// Takes a free slot of the same size, or a new one from the shelf of its height, or a larger free slot
+	bool GlyphAtlas::AllocSlot(Glyph& glyph)
+	{
+		auto& same_size_slots = free_slots_[glyph.h_class][glyph.w_class];
+		if (!same_size_slots.empty())
+		{
+			glyph.slot = same_size_slots.back();
+			same_size_slots.pop_back();
+			return true;
+		}
+
+		uint32_t const width = this->SlotSize(glyph.w_class);
+		uint32_t const height = this->SlotSize(glyph.h_class);
+
+		auto& shelf = open_shelves_[glyph.h_class];
+		if (shelf && (static_cast<uint32_t>(shelf->x()) + width > tex_size_))
+		{
+			shelf.reset();
+		}
+		if (!shelf && (next_shelf_y_ + height <= tex_size_))
+		{
+			shelf = int2(0, next_shelf_y_);
+			next_shelf_y_ += height;
+		}
+		if (shelf)
+		{
+			glyph.slot = *shelf;
+			shelf->x() += width;
+			return true;
+		}
+
+		for (uint32_t h_class = glyph.h_class; h_class < GLYPH_SIZE_CLASSES; ++ h_class)
+		{
+			for (uint32_t w_class = glyph.w_class; w_class < GLYPH_SIZE_CLASSES; ++ w_class)
+			{
+				auto& slots = free_slots_[h_class][w_class];
+				if (!slots.empty())
+				{
+					glyph.slot = slots.back();
+					glyph.w_class = w_class;
+					glyph.h_class = h_class;
+					slots.pop_back();
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	void GlyphAtlas::Reset()
+	{
+		BOOST_ASSERT(glyphs_.empty());
+
+		for (auto& slots : free_slots_)
+		{
+			for (auto& same_size_slots : slots)
+			{
+				same_size_slots.clear();
+			}
+		}
+		for (auto& shelf : open_shelves_)
+		{
+			shelf.reset();
+		}
+		next_shelf_y_ = 0;
+	}
+
 	class FontRenderable : public Renderable
 	{
 	public:
 		explicit FontRenderable(std::shared_ptr<KFont> const & kfl)
 				: Renderable(L"Font"),
 					three_dim_(false),
-					kfont_loader_(kfl),
-					tick_(0)
+					kfont_loader_(kfl)
 		{
 			RenderFactory& rf = Context::Instance().RenderFactoryInstance();
 
-			restart_ = rf.RenderEngineInstance().DeviceCaps().primitive_restart_support;
+			bool const restart = rf.RenderEngineInstance().DeviceCaps().primitive_restart_support;
+			index_per_char_ = NumIndicesPerQuad(restart);
 
 			rls_[0] = rf.MakeRenderLayout();
-			if (restart_)
+			if (restart)
 			{
 				rls_[0]->TopologyType(RenderLayout::TT_TriangleStrip);
 			}
@@ -96,9 +258,8 @@ namespace KlayGE
 			RenderDeviceCaps const & caps = renderEngine.DeviceCaps();
 			uint32_t size = std::min(2048U, std::min(caps.max_texture_width, caps.max_texture_height)) / kfont_char_size * kfont_char_size;
 			dist_texture_ = rf.MakeTexture2D(size, size, 1, 1, EF_R8, 1, 0, EAH_GPU_Read);
-			a_char_data_.resize(kfont_char_size * kfont_char_size);
-
-			char_free_list_.emplace_back(0, size * size / kfont_char_size / kfont_char_size);
+			atlas_ = MakeUniquePtr<GlyphAtlas>(size, kfont_char_size);
+			max_pending_glyphs_ = (size / kfont_char_size) * (size / kfont_char_size);
 
 			effect_ = SyncLoadRenderEffect("Font.fxml");
 			*(effect_->ParameterByName("distance_tex")) = dist_texture_;
@@ -108,19 +269,26 @@ namespace KlayGE
 			dpi_scale_ep_ = effect_->ParameterByName("dpi_scale");
 			mvp_ep_ = effect_->ParameterByName("mvp");
 
-			uint32_t const INDEX_PER_CHAR = restart_ ? 5 : 6;
 			uint32_t const INIT_NUM_CHAR = 1024;
 			tb_vb_ = MakeUniquePtr<TransientBuffer>(static_cast<uint32_t>(INIT_NUM_CHAR * 4 * sizeof(FontVert)), TransientBuffer::BF_Vertex);
-			tb_ib_ = MakeUniquePtr<TransientBuffer>(static_cast<uint32_t>(INIT_NUM_CHAR * INDEX_PER_CHAR * sizeof(uint16_t)), TransientBuffer::BF_Index);
 
 			rls_[0]->BindVertexStream(tb_vb_->GetBuffer(), MakeSpan({VertexElement(VEU_Position, 0, EF_BGR32F),
 				VertexElement(VEU_Diffuse, 0, EF_ABGR8), VertexElement(VEU_TextureCoord, 0, EF_GR32F)}));
-			rls_[0]->BindIndexStream(tb_ib_->GetBuffer(), EF_R16UI);
+			rls_[0]->BindIndexStream(MakeQuadIndexBuffer(restart), EF_R16UI);
 
 			pos_aabb_ = AABBox(float3(0, 0, 0), float3(0, 0, 0));
 			tc_aabb_ = AABBox(float3(0, 0, 0), float3(0, 0, 0));
 		}
 
+		~FontRenderable() override
+		{
+			// Decode jobs own their data, but shouldn't outlive the font
+			for (auto const & pending : pending_glyphs_)
+			{
+				pending.second.decoded.wait();
+			}
+		}
+
 		RenderTechnique* GetRenderTechnique() const override
 		{
 			if (three_dim_)
@@ -144,59 +312,56 @@ namespace KlayGE
 				*half_width_height_ep_ = float2(half_width, half_height);
 				*dpi_scale_ep_ = Context::Instance().AppInstance().MainWnd()->DPIScale();
 			}
-
-			tb_vb_->EnsureDataReady();
-			tb_ib_->EnsureDataReady();
-
-			rls_[0]->SetVertexStream(0, tb_vb_->GetBuffer());
-			rls_[0]->BindIndexStream(tb_ib_->GetBuffer(), EF_R16UI);
 		}
 
 		void OnRenderEnd() override
 		{
 			pos_aabb_ = AABBox(float3(0, 0, 0), float3(0, 0, 0));
 
-			tb_vb_sub_allocs_.clear();
-			tb_ib_sub_allocs_.clear();
-
+			frame_vertices_.clear();
 			tb_vb_->OnPresent();
-			tb_ib_->OnPresent();
+
+			// Texts that were not drawn in this frame are dropped
+			++ render_count_;
+			for (auto iter = text_geometries_.begin(); iter != text_geometries_.end();)
+			{
+				if (iter->second.last_used + 1 < render_count_)
+				{
+					iter = text_geometries_.erase(iter);
+				}
+				else
+				{
+					++ iter;
+				}
+			}
 		}
 
 		void Render() override
 		{
 			RenderEngine& re = Context::Instance().RenderFactoryInstance().RenderEngineInstance();
 
-			this->OnRenderBegin();
-
-			BOOST_ASSERT(tb_vb_sub_allocs_.size() == tb_ib_sub_allocs_.size());
-
-			for (size_t i = 0; i < tb_vb_sub_allocs_.size(); ++ i)
+			if (!frame_vertices_.empty())
 			{
-				uint32_t vert_length = tb_vb_sub_allocs_[i].length_;
-				uint32_t const ind_offset = tb_ib_sub_allocs_[i].offset_;
-				uint32_t ind_length = tb_ib_sub_allocs_[i].length_;
-
-				while ((i + 1 < tb_vb_sub_allocs_.size())
-					&& (tb_vb_sub_allocs_[i].offset_ + tb_vb_sub_allocs_[i].length_ == tb_vb_sub_allocs_[i + 1].offset_)
-					&& (tb_ib_sub_allocs_[i].offset_ + tb_ib_sub_allocs_[i].length_ == tb_ib_sub_allocs_[i + 1].offset_))
-				{
-					vert_length += tb_vb_sub_allocs_[i + 1].length_;
-					ind_length += tb_ib_sub_allocs_[i + 1].length_;
-					++ i;
-				}
+				this->OnRenderBegin();
 
-				rls_[0]->NumVertices(vert_length / sizeof(FontVert));
-				rls_[0]->StartIndexLocation(ind_offset / sizeof(uint16_t));
-				rls_[0]->NumIndices(ind_length / sizeof(uint16_t));
+				// All texts of the frame are in one allocation
+				SubAlloc const vb_alloc = tb_vb_->Alloc(static_cast<uint32_t>(frame_vertices_.size() * sizeof(frame_vertices_[0])),
+					frame_vertices_.data());
+				tb_vb_->EnsureDataReady();
+				rls_[0]->SetVertexStream(0, tb_vb_->GetBuffer());
 
-				re.Render(*this->GetRenderEffect(), *this->GetRenderTechnique(), *rls_[0]);
-			}
+				uint32_t const start_vertex = vb_alloc.offset_ / sizeof(FontVert);
+				uint32_t const num_chars = static_cast<uint32_t>(frame_vertices_.size() / 4);
+				for (uint32_t first = 0; first < num_chars; first += MAX_QUADS_PER_DRAW)
+				{
+					uint32_t const n = std::min(num_chars - first, MAX_QUADS_PER_DRAW);
+					rls_[0]->StartVertexLocation(start_vertex + first * 4);
+					rls_[0]->NumVertices(n * 4);
+					rls_[0]->StartIndexLocation(0);
+					rls_[0]->NumIndices(n * index_per_char_);
 
-			for (size_t i = 0; i < tb_vb_sub_allocs_.size(); ++ i)
-			{
-				tb_vb_->Dealloc(tb_vb_sub_allocs_[i]);
-				tb_ib_->Dealloc(tb_ib_sub_allocs_[i]);
+					re.Render(*this->GetRenderEffect(), *this->GetRenderTechnique(), *rls_[0]);
+				}
 			}
 
 			this->OnRenderEnd();
@@ -254,16 +419,63 @@ namespace KlayGE
 		}
 
 	private:
+		struct FontVert
+		{
+			float3 pos;
+			uint32_t clr;
+			float2 tex;
+
+			FontVert()
+			{
+			}
+			FontVert(float3 const & p, uint32_t c, float2 const & t)
+				: pos(p), clr(c), tex(t)
+			{
+			}
+		};
+		static_assert(sizeof(FontVert) == 24);
+
+		struct TextGeometry
+		{
+			std::wstring text;
+			std::array<float, 8> params;
+			uint32_t clr;
+			uint32_t align;
+
+			std::vector<FontVert> vertices;
+			AABBox bound;
+			uint32_t last_used;
+		};
+
 		void AddText(Rect const & rc, float sz,
 			float xScale, float yScale, Color const & clr, std::wstring_view text, float font_size, uint32_t align)
 		{
-			this->UpdateTexture(text);
+			bool const all_resident = this->UpdateTexture(text);
+
+			uint32_t const clr32 = clr.ABGR();
+			auto const [geometry, hit] = this->FindTextGeometry(text,
+				{{rc.left(), rc.top(), rc.right(), rc.bottom(), sz, xScale, yScale, font_size}}, clr32, align);
+			if (!hit)
+			{
+				this->BuildText(*geometry, rc, sz, xScale, yScale, clr32, text, font_size, align);
+			}
+
+			frame_vertices_.insert(frame_vertices_.end(), geometry->vertices.begin(), geometry->vertices.end());
+			pos_aabb_ |= geometry->bound;
+
+			if (!all_resident)
+			{
+				// Built without some glyphs, so it's rebuilt next time
+				geometry->text.clear();
+			}
+		}
 
+		void BuildText(TextGeometry& geometry, Rect const & rc, float sz,
+			float xScale, float yScale, uint32_t clr32, std::wstring_view text, float font_size, uint32_t align)
+		{
 			KFont const & kl = *kfont_loader_;
-			auto const & cim = char_info_map_;
 
-			std::vector<FontVert> vertices;
-			std::vector<uint16_t> indices;
+			auto& vertices = geometry.vertices;
 
 			float const h = font_size * yScale;
 			float const rel_size = font_size / kl.CharSize();
@@ -330,15 +542,12 @@ namespace KlayGE
 				}
 			}
 
-			uint32_t const index_per_char = restart_ ? 5 : 6;
-
-			uint32_t const clr32 = clr.ABGR();
 			for (size_t i = 0; i < sx.size(); ++ i)
 			{
 				size_t const maxSize = lines[i].second.length();
 				float x = sx[i], y = sy[i];
 
-				vertices.reserve(maxSize * 4);
+				vertices.reserve(vertices.size() + maxSize * 4);
 
 				for (auto const & ch : lines[i].second)
 				{
@@ -352,13 +561,14 @@ namespace KlayGE
 						float width = ci.width * rel_size_x;
 						float height = ci.height * rel_size_y;
 
-						auto cmiter = cim.find(ch);
-						Rect const & texRect(cmiter->second.rc);
+						GlyphAtlas::Glyph const* glyph = atlas_->Find(ch);
 
 						Rect pos_rc(x + left, y + top, x + left + width, y + top + height);
 						Rect intersect_rc = pos_rc & rc;
-						if ((intersect_rc.Width() > 0) && (intersect_rc.Height() > 0))
+						if ((glyph != nullptr) && (intersect_rc.Width() > 0) && (intersect_rc.Height() > 0))
 						{
+							Rect const & texRect(glyph->rc);
+
 							vertices.push_back(FontVert(float3(pos_rc.left(), pos_rc.top(), sz),
 													clr32,
 													float2(texRect.left(), texRect.top())));
@@ -378,49 +588,47 @@ namespace KlayGE
 					y += (offset_adv.second >> 16) * rel_size_y;
 				}
 
-				tb_vb_sub_allocs_.push_back(tb_vb_->Alloc(static_cast<uint32_t>(vertices.size() * sizeof(vertices[0])), &vertices[0]));
-
-				uint16_t last_index = static_cast<uint16_t>(tb_vb_sub_allocs_.back().offset_ / sizeof(FontVert));
-				uint32_t const num_chars = static_cast<uint32_t>(vertices.size() / 4);
-				indices.reserve(num_chars * index_per_char);
-				for (uint32_t c = 0; c < num_chars; ++ c)
+				AABBox const line_bound(float3(sx[i], sy[i], sz), float3(sx[i] + lines[i].first, sy[i] + h, sz + 0.1f));
+				if (i == 0)
 				{
-					indices.push_back(last_index + 0);
-					indices.push_back(last_index + 1);
-					if (restart_)
-					{
-						indices.push_back(last_index + 3);
-						indices.push_back(last_index + 2);
-						indices.push_back(0xFFFF);
-					}
-					else
-					{
-						indices.push_back(last_index + 2);
-						indices.push_back(last_index + 2);
-						indices.push_back(last_index + 3);
-						indices.push_back(last_index + 0);
-					}
-					last_index += 4;
+					geometry.bound = line_bound;
+				}
+				else
+				{
+					geometry.bound |= line_bound;
 				}
-				BOOST_ASSERT(last_index + 3 <= 0xFFFF);
-				tb_ib_sub_allocs_.push_back(tb_ib_->Alloc(static_cast<uint32_t>(indices.size() * sizeof(indices[0])), &indices[0]));
-
-				pos_aabb_ |= AABBox(float3(sx[i], sy[i], sz), float3(sx[i] + lines[i].first, sy[i] + h, sz + 0.1f));
 			}
 		}
 
 		void AddText(float sx, float sy, float sz,
 			float xScale, float yScale, Color const & clr, std::wstring_view text, float font_size)
 		{
-			this->UpdateTexture(text);
+			bool const all_resident = this->UpdateTexture(text);
 
+			// Not aligned in a rectangle. An invalid align tells it from the rectangle version.
+			uint32_t const clr32 = clr.ABGR();
+			auto const [geometry, hit] = this->FindTextGeometry(text, {{sx, sy, 0, 0, sz, xScale, yScale, font_size}}, clr32, ~0U);
+			if (!hit)
+			{
+				this->BuildText(*geometry, sx, sy, sz, xScale, yScale, clr32, text, font_size);
+			}
+
+			frame_vertices_.insert(frame_vertices_.end(), geometry->vertices.begin(), geometry->vertices.end());
+			pos_aabb_ |= geometry->bound;
+
+			if (!all_resident)
+			{
+				geometry->text.clear();
+			}
+		}
+
+		void BuildText(TextGeometry& geometry, float sx, float sy, float sz,
+			float xScale, float yScale, uint32_t clr32, std::wstring_view text, float font_size)
+		{
 			KFont const & kl = *kfont_loader_;
-			auto const & cim = char_info_map_;
 
-			std::vector<FontVert> vertices;
-			std::vector<uint16_t> indices;
+			auto& vertices = geometry.vertices;
 
-			uint32_t const clr32 = clr.ABGR();
 			float const h = font_size * yScale;
 			float const rel_size = font_size / kl.CharSize();
 			float const rel_size_x = rel_size * xScale;
@@ -429,8 +637,6 @@ namespace KlayGE
 			float x = sx, y = sy;
 			float maxx = sx, maxy = sy;
 
-			uint32_t const index_per_char = restart_ ? 5 : 6;
-
 			vertices.reserve(maxSize * 4);
 
 			for (auto const & ch : text)
@@ -447,10 +653,10 @@ namespace KlayGE
 						float width = ci.width * rel_size_x;
 						float height = ci.height * rel_size_y;
 
-						auto cmiter = cim.find(ch);
-						if (cmiter != cim.end())
+						GlyphAtlas::Glyph const* glyph = atlas_->Find(ch);
+						if (glyph != nullptr)
 						{
-							Rect const & texRect(cmiter->second.rc);
+							Rect const & texRect(glyph->rc);
 							Rect pos_rc(x + left, y + top, x + left + width, y + top + height);
 
 							vertices.push_back(FontVert(float3(pos_rc.left(), pos_rc.top(), sz),
@@ -488,216 +694,198 @@ namespace KlayGE
 				}
 			}
 
-			tb_vb_sub_allocs_.push_back(tb_vb_->Alloc(static_cast<uint32_t>(vertices.size() * sizeof(vertices[0])), &vertices[0]));
+			geometry.bound = AABBox(float3(sx, sy, sz), float3(maxx, maxy, sz + 0.1f));
+		}
 
-			uint16_t last_index = static_cast<uint16_t>(tb_vb_sub_allocs_.back().offset_ / sizeof(FontVert));
-			uint32_t const num_chars = static_cast<uint32_t>(vertices.size() / 4);
-			indices.reserve(num_chars * index_per_char);
-			for (uint32_t c = 0; c < num_chars; ++ c)
+		// Returns the cached geometry of a text drawn in the last frame with the same parameters. On a miss, returns an empty
+		// entry to build the geometry in.
+		std::pair<TextGeometry*, bool> FindTextGeometry(std::wstring_view text, std::array<float, 8> const & params,
+			uint32_t clr32, uint32_t align)
+		{
+			size_t seed = HashValue(text);
+			for (float const param : params)
 			{
-				indices.push_back(last_index + 0);
-				indices.push_back(last_index + 1);
-				if (restart_)
-				{
-					indices.push_back(last_index + 3);
-					indices.push_back(last_index + 2);
-					indices.push_back(0xFFFF);
-				}
-				else
-				{
-					indices.push_back(last_index + 2);
-					indices.push_back(last_index + 2);
-					indices.push_back(last_index + 3);
-					indices.push_back(last_index + 0);
-				}
-				last_index += 4;
+				HashCombine(seed, std::bit_cast<uint32_t>(param));
 			}
-			tb_ib_sub_allocs_.push_back(tb_ib_->Alloc(static_cast<uint32_t>(indices.size() * sizeof(indices[0])), &indices[0]));
-
-			pos_aabb_ |= AABBox(float3(sx, sy, sz), float3(maxx, maxy, sz + 0.1f));
+			HashCombine(seed, clr32);
+			HashCombine(seed, align);
+
+			// Different texts with the same hash just replace each other
+			auto& geometry = text_geometries_[seed];
+			geometry.last_used = render_count_;
+			bool const hit = (geometry.text == text) && (geometry.params == params) && (geometry.clr == clr32)
+				&& (geometry.align == align) && !geometry.vertices.empty();
+			if (!hit)
+			{
+				geometry.text = std::wstring(text);
+				geometry.params = params;
+				geometry.clr = clr32;
+				geometry.align = align;
+				geometry.vertices.clear();
+			}
+			return std::make_pair(&geometry, hit);
 		}
 
-		// ʹLRU㷨
-		/////////////////////////////////////////////////////////////////////////////////
-		void UpdateTexture(std::wstring_view text)
+	public:
+		// Reads the compressed distance data of glyphs that are neither in the texture nor being decoded yet, and decodes them on
+		// the thread pool. Reading stays on this thread, since the font file is a single stream.
+		void DecodeGlyphs(std::wstring_view text)
 		{
-			++ tick_;
-
-			uint32_t const tex_size = dist_texture_->Width(0);
+			KFont const & kl = *kfont_loader_;
+			uint32_t const char_size_sq = kl.CharSize() * kl.CharSize();
 
-			KFont& kl = *kfont_loader_;
-			auto& cim = char_info_map_;
+			std::vector<std::vector<uint8_t>> lzma_data;
+			std::vector<wchar_t> chars;
+			auto queue_job = [this, &lzma_data, &chars, char_size_sq]()
+			{
+				std::shared_future<std::vector<uint8_t>> decoded = Context::Instance().ThreadPoolInstance().QueueThread(
+					[lzma_data = std::move(lzma_data), char_size_sq]()
+					{
+						std::vector<uint8_t> dist_data(lzma_data.size() * char_size_sq);
+						LZMACodec lzma;
+						for (size_t i = 0; i < lzma_data.size(); ++ i)
+						{
+							lzma.Decode(&dist_data[i * char_size_sq], lzma_data[i], char_size_sq);
+						}
+						return dist_data;
+					}).share();
 
-			uint32_t const kfont_char_size = kl.CharSize();
+				for (uint32_t i = 0; i < chars.size(); ++ i)
+				{
+					pending_order_.push_back(chars[i]);
+					pending_glyphs_.emplace(chars[i], PendingGlyph{decoded, i, std::prev(pending_order_.end())});
+				}
 
-			uint32_t const num_chars_a_row = tex_size / kfont_char_size;
-			uint32_t const num_total_chars = num_chars_a_row * num_chars_a_row;
+				lzma_data.clear();
+				chars.clear();
+			};
 
 			for (auto const & ch : text)
 			{
-				int32_t offset = kl.CharIndex(ch);
-				if (offset != -1)
+				int32_t const offset = kl.CharIndex(ch);
+				if ((offset == -1) || (atlas_->Find(ch) != nullptr)
+					|| (pending_glyphs_.find(ch) != pending_glyphs_.end())
+					|| (std::find(chars.begin(), chars.end(), ch) != chars.end()))
 				{
-					auto cmiter = cim.find(ch);
-					if (cmiter != cim.end())
-					{
-						// ҵ
-
-						cmiter->second.tick = tick_;
-					}
-					else
-					{
-						// ҲԵ
+					continue;
+				}
 
-						KFont::font_info const & ci = kl.CharInfo(offset);
+				uint32_t size;
+				kl.GetLZMADistanceData(nullptr, size, offset);
+				auto& data = lzma_data.emplace_back(size);
+				kl.GetLZMADistanceData(data.data(), size, offset);
+				chars.push_back(ch);
 
-						uint32_t width = ci.width;
-						uint32_t height = ci.height;
+				if (chars.size() == GLYPHS_PER_DECODE_JOB)
+				{
+					queue_job();
+				}
+			}
+			if (!chars.empty())
+			{
+				queue_job();
+			}
 
-						int2 char_pos;
-						CharInfo charInfo;
-						if (cim.size() < num_total_chars)
-						{
-							// пռ
+			// Glyphs that are prefetched but never drawn would pile up. Beyond what the texture holds, the oldest ones are dropped,
+			// and decoded again if they are drawn later.
+			while (pending_glyphs_.size() > max_pending_glyphs_)
+			{
+				auto const pending_iter = pending_glyphs_.find(pending_order_.front());
+				// Jobs are queued in this order, so the oldest one has most likely finished
+				pending_iter->second.decoded.wait();
+				pending_glyphs_.erase(pending_iter);
+				pending_order_.pop_front();
+			}
+		}
 
-							uint32_t const s = char_free_list_.front().first;
-						
-							char_pos.y() = s / num_chars_a_row;
-							char_pos.x() = s - char_pos.y() * num_chars_a_row;
+	private:
+		// Makes the glyphs of the text resident in the distance texture, evicting the least recently used ones. Returns false if
+		// some glyphs don't fit, which only happens when one text has more glyphs than the texture holds.
+		bool UpdateTexture(std::wstring_view text)
+		{
+			atlas_->BeginText();
 
-							char_pos.x() *= kfont_char_size;
-							char_pos.y() *= kfont_char_size;
+			this->DecodeGlyphs(text);
 
-							charInfo.rc.left() = static_cast<float>(char_pos.x()) / tex_size;
-							charInfo.rc.top() = static_cast<float>(char_pos.y()) / tex_size;
+			KFont const & kl = *kfont_loader_;
+			uint32_t const kfont_char_size = kl.CharSize();
 
-							++ char_free_list_.front().first;
-							if (char_free_list_.front().first == char_free_list_.front().second)
-							{
-								char_free_list_.pop_front();
-							}
-						}
-						else
-						{
-							// ҵʹʱûʹõ
-
-							uint64_t min_tick = cim.begin()->second.tick;
-							auto min_chiter = cim.begin();
-							for (auto chiter = cim.begin(); chiter != cim.end(); ++ chiter)
-							{
-								if (chiter->second.tick < min_tick)
-								{
-									min_tick = chiter->second.tick;
-									min_chiter = chiter;
-								}
-							}
-
-							char_pos.x() = static_cast<int32_t>(min_chiter->second.rc.left() * tex_size);
-							char_pos.y() = static_cast<int32_t>(min_chiter->second.rc.top() * tex_size);
-							charInfo.rc.left() = min_chiter->second.rc.left();
-							charInfo.rc.top() = min_chiter->second.rc.top();
-
-							for (auto chiter = cim.begin(); chiter != cim.end(); ++ chiter)
-							{
-								if (chiter->second.tick == min_tick)
-								{
-									uint32_t const x = static_cast<int32_t>(chiter->second.rc.left() * tex_size);
-									uint32_t const y = static_cast<int32_t>(chiter->second.rc.top() * tex_size);
-									uint32_t const id = y * num_chars_a_row + x;
-									auto freeiter = char_free_list_.begin();
-									while ((freeiter != char_free_list_.end()) && (freeiter->second <= id))
-									{
-										++ freeiter;
-									}
-									char_free_list_.emplace(freeiter, id, id + 1);
-
-									cim.erase(chiter);
-									break;
-								}
-							}
-							for (auto freeiter = char_free_list_.begin(); freeiter != char_free_list_.end();)
-							{
-								auto nextiter = freeiter;
-								++ nextiter;
-
-								if (nextiter != char_free_list_.end())
-								{
-									if (freeiter->second == nextiter->first)
-									{
-										freeiter->second = nextiter->second;
-										char_free_list_.erase(nextiter);
-									}
-									else
-									{
-										++ freeiter;
-									}
-								}
-								else
-								{
-									break;
-								}
-							}
-						}
+			bool all_resident = true;
+			for (auto const & ch : text)
+			{
+				if (atlas_->Touch(ch) != nullptr)
+				{
+					continue;
+				}
 
-						charInfo.rc.right()		= charInfo.rc.left() + static_cast<float>(width) / tex_size;
-						charInfo.rc.bottom()	= charInfo.rc.top() + static_cast<float>(height) / tex_size;
-						charInfo.tick			= tick_;
+				auto const pending_iter = pending_glyphs_.find(ch);
+				if (pending_iter == pending_glyphs_.end())
+				{
+					// Not in the font
+					continue;
+				}
 
-						kl.GetDistanceData(&a_char_data_[0], kfont_char_size, offset);
-						dist_texture_->UpdateSubresource2D(0, 0, char_pos.x(), char_pos.y(), kfont_char_size, kfont_char_size,
-							&a_char_data_[0], kfont_char_size);
+				KFont::font_info const & ci = kl.CharInfo(kl.CharIndex(ch));
 
-						cim.emplace(ch, charInfo);
-					}
+				bool evicted;
+				GlyphAtlas::Glyph const* glyph = atlas_->Insert(ch, ci.width, ci.height, evicted);
+				if (evicted)
+				{
+					// Cached texts could be using the glyphs that are replaced
+					text_geometries_.clear();
+				}
+				if (glyph == nullptr)
+				{
+					all_resident = false;
+					continue;
 				}
+
+				// The slot is uploaded as a whole. Texels around the glyph keep bilinear filtering from reaching the neighbors.
+				std::vector<uint8_t> const & dist_data = pending_iter->second.decoded.get();
+				dist_texture_->UpdateSubresource2D(0, 0, glyph->slot.x(), glyph->slot.y(),
+					atlas_->SlotSize(glyph->w_class), atlas_->SlotSize(glyph->h_class),
+					&dist_data[pending_iter->second.index * kfont_char_size * kfont_char_size], kfont_char_size);
+				pending_order_.erase(pending_iter->second.order_iter);
+				pending_glyphs_.erase(pending_iter);
 			}
+
+			return all_resident;
 		}
 
 	private:
-		struct CharInfo
-		{
-			Rect rc;
-			uint64_t tick;
-		};
-
-		struct FontVert
-		{
-			float3 pos;
-			uint32_t clr;
-			float2 tex;
+		static uint32_t constexpr GLYPHS_PER_DECODE_JOB = 32;
 
-			FontVert()
-			{
-			}
-			FontVert(float3 const & p, uint32_t c, float2 const & t)
-				: pos(p), clr(c), tex(t)
-			{
-			}
-		};
-		static_assert(sizeof(FontVert) == 24);
+		uint32_t index_per_char_;
 
-		bool restart_;
+		std::unique_ptr<GlyphAtlas> atlas_;
 
-		std::unordered_map<wchar_t, CharInfo> char_info_map_;
-		std::list<std::pair<uint32_t, uint32_t>> char_free_list_;
+		struct PendingGlyph
+		{
+			// Decoded distance data of a decode job, and the index of the glyph in it
+			std::shared_future<std::vector<uint8_t>> decoded;
+			uint32_t index;
+			std::list<wchar_t>::iterator order_iter;
+		};
+		std::unordered_map<wchar_t, PendingGlyph> pending_glyphs_;
+		// Oldest first
+		std::list<wchar_t> pending_order_;
+		uint32_t max_pending_glyphs_;
 
 		bool three_dim_;
 
 		std::unique_ptr<TransientBuffer> tb_vb_;
-		std::unique_ptr<TransientBuffer> tb_ib_;
-		std::vector<SubAlloc> tb_vb_sub_allocs_;
-		std::vector<SubAlloc> tb_ib_sub_allocs_;
+		std::vector<FontVert> frame_vertices_;
+
+		std::unordered_map<size_t, TextGeometry> text_geometries_;
+		uint32_t render_count_ = 0;
 
 		TexturePtr		dist_texture_;
-		std::vector<uint8_t> a_char_data_;
 
 		RenderEffectParameter* half_width_height_ep_;
 		RenderEffectParameter* dpi_scale_ep_;
 		RenderEffectParameter* mvp_ep_;
 
 		std::shared_ptr<KFont> kfont_loader_;
-
-		uint64_t tick_;
 	};
 }
 
@@ -768,6 +956,13 @@ namespace
 			return true;
 		}
 
+		size_t Hash() const override
+		{
+			size_t seed = HashValue(font_desc_.res_name);
+			HashCombine(seed, font_desc_.flag);
+			return seed;
+		}
+
 		bool Match(ResLoadingDesc const & rhs) const override
 		{
 			if (this->Type() == rhs.Type())
@@ -866,9 +1061,8 @@ namespace KlayGE
 	{
 		if (!text.empty())
 		{
-			auto font_node = MakeSharedPtr<SceneNode>(MakeSharedPtr<RenderableComponent>(font_renderable_), fsn_attrib_);
 			font_renderable_->AddText2D(x, y, z, xScale, yScale, clr, text, font_size);
-			Context::Instance().SceneManagerInstance().OverlayRootNode().AddChild(font_node);
+			this->AddToOverlay();
 		}
 	}
 
@@ -880,9 +1074,8 @@ namespace KlayGE
 	{
 		if (!text.empty())
 		{
-			auto font_node = MakeSharedPtr<SceneNode>(MakeSharedPtr<RenderableComponent>(font_renderable_), fsn_attrib_);
 			font_renderable_->AddText2D(rc, z, xScale, yScale, clr, text, font_size, align);
-			Context::Instance().SceneManagerInstance().OverlayRootNode().AddChild(font_node);
+			this->AddToOverlay();
 		}
 	}
 
@@ -899,6 +1092,23 @@ namespace KlayGE
 	}
 
 
+	void Font::Prefetch(std::wstring_view text)
+	{
+		font_renderable_->DecodeGlyphs(text);
+	}
+
+
+	void Font::AddToOverlay()
+	{
+		// The overlay is cleared every frame. All texts of the font go to one node, which is added back when needed.
+		if (!overlay_node_)
+		{
+			overlay_node_ = MakeSharedPtr<SceneNode>(MakeSharedPtr<RenderableComponent>(font_renderable_), fsn_attrib_);
+		}
+		Context::Instance().SceneManagerInstance().OverlayRootNode().AddChild(overlay_node_);
+	}
+
+
 	FontPtr SyncLoadFont(std::string_view font_name, uint32_t flags)
 	{
 		return Context::Instance().ResLoaderInstance().SyncQueryT<Font>(MakeSharedPtr<FontLoadingDesc>(font_name, flags));
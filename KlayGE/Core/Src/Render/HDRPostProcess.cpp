@@ -15,6 +15,7 @@
 
 #include <KlayGE/KlayGE.hpp>
 #include <KFL/Util.hpp>
+#include <KFL/Hash.hpp>
 #include <KlayGE/Context.hpp>
 #include <KFL/Math.hpp>
 #include <KlayGE/ResLoader.hpp>
@@ -95,7 +96,7 @@ namespace KlayGE
 		re.BindFrameBuffer(re.DefaultFrameBuffer());
 		re.DefaultFrameBuffer()->Discard(FrameBuffer::CBM_Color);
 
-		*(effect_->ParameterByName("dst_tex_dim")) = int2(64, 64);
+		*(effect_->ParameterByNameHash(CtHash("dst_tex_dim"))) = int2(64, 64);
 
 		this->OnRenderBegin();
 		re.Dispatch(*effect_, *technique_, 2, 2, 1);
@@ -122,6 +122,11 @@ namespace KlayGE
 			return true;
 		}
 
+		size_t Hash() const override
+		{
+			return HashValue(imposter_desc_.res_name);
+		}
+
 		bool Match(ResLoadingDesc const & rhs) const override
 		{
 			if (this->Type() == rhs.Type())
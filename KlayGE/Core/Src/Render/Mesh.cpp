@@ -24,6 +24,8 @@
 #include <KFL/ErrorHandling.hpp>
 #include <KFL/Log.hpp>
 #include <KFL/Math.hpp>
+#include <KFL/SIMDMath.hpp>
+#include <KFL/Thread.hpp>
 #include <KlayGE/Context.hpp>
 #include <KlayGE/RenderFactory.hpp>
 #include <KlayGE/Texture.hpp>
@@ -40,9 +42,14 @@
 #include <KlayGE/SceneManager.hpp>
 
 #include <algorithm>
+#include <array>
 #include <filesystem>
 #include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
 #include <cstring>
 
 #include <KlayGE/Mesh.hpp>
@@ -51,7 +58,565 @@ namespace
 {
 	using namespace KlayGE;
 
-	uint32_t const MODEL_BIN_VERSION = 19;
+	uint32_t const MODEL_BIN_VERSION = 21;
+
+	// A model_bin starts with a table of contents. Every chunk in it is compressed on its own, so a lod can be loaded without the others.
+	uint32_t const MODEL_CHUNK_META = MakeFourCC<'M', 'E', 'T', 'A'>::value;
+	uint32_t const MODEL_CHUNK_VERTICES = MakeFourCC<'V', 'E', 'R', 'T'>::value;
+	uint32_t const MODEL_CHUNK_INDICES = MakeFourCC<'I', 'N', 'D', 'X'>::value;
+	uint32_t const MODEL_CHUNK_ANIMATION = MakeFourCC<'A', 'N', 'I', 'M'>::value;
+
+	// Chunk data starts at this alignment, stored vertex streams of a mapped file can be used in place
+	uint32_t const MODEL_CHUNK_ALIGNMENT = 16;
+	uint32_t const MODEL_CHUNK_ENTRY_SIZE = sizeof(uint32_t) * 4 + sizeof(uint64_t) * 3;
+
+	enum class ModelChunkCodec : uint32_t
+	{
+		Stored = 0,
+		LZMA,
+		LZMAFramed
+	};
+
+	struct ModelBinChunk
+	{
+		uint32_t type;
+		uint32_t lod;
+		uint32_t stream;
+		ModelChunkCodec codec;
+		uint64_t offset;
+		uint64_t len;
+		uint64_t original_len;
+	};
+
+	struct ModelLodBuffers
+	{
+		std::vector<GraphicsBufferPtr> vbs;
+		GraphicsBufferPtr ib;
+	};
+
+	// One past the last vertex and index the meshes of a lod use
+	struct ModelLodRange
+	{
+		uint64_t num_vertices = 0;
+		uint64_t num_indices = 0;
+	};
+
+	uint64_t StreamSize(ResIdentifier& res)
+	{
+		uint64_t size = res.Data().size();
+		if (size == 0)
+		{
+			int64_t const pos = res.tellg();
+			res.seekg(0, std::ios_base::end);
+			size = static_cast<uint64_t>(res.tellg());
+			res.seekg(pos, std::ios_base::beg);
+		}
+		return size;
+	}
+
+	// The table is checked against the file size, so a truncated or corrupted file can't make the decoder read out of bounds
+	std::vector<ModelBinChunk> ReadModelBinToc(ResIdentifier& file)
+	{
+		uint64_t const file_size = StreamSize(file);
+
+		uint32_t num_chunks;
+		file.read(&num_chunks, sizeof(num_chunks));
+		num_chunks = LE2Native(num_chunks);
+		Verify(num_chunks <= file_size / MODEL_CHUNK_ENTRY_SIZE);
+
+		std::vector<ModelBinChunk> chunks(num_chunks);
+		for (auto& chunk : chunks)
+		{
+			file.read(&chunk.type, sizeof(chunk.type));
+			chunk.type = LE2Native(chunk.type);
+			file.read(&chunk.lod, sizeof(chunk.lod));
+			chunk.lod = LE2Native(chunk.lod);
+			file.read(&chunk.stream, sizeof(chunk.stream));
+			chunk.stream = LE2Native(chunk.stream);
+			uint32_t codec;
+			file.read(&codec, sizeof(codec));
+			chunk.codec = static_cast<ModelChunkCodec>(LE2Native(codec));
+			file.read(&chunk.offset, sizeof(chunk.offset));
+			chunk.offset = LE2Native(chunk.offset);
+			file.read(&chunk.len, sizeof(chunk.len));
+			chunk.len = LE2Native(chunk.len);
+			file.read(&chunk.original_len, sizeof(chunk.original_len));
+			chunk.original_len = LE2Native(chunk.original_len);
+
+			Verify(file.gcount() == sizeof(chunk.original_len));
+			Verify(chunk.codec <= ModelChunkCodec::LZMAFramed);
+			Verify((chunk.offset <= file_size) && (chunk.len <= file_size - chunk.offset));
+			Verify((chunk.codec != ModelChunkCodec::Stored) || (chunk.len == chunk.original_len));
+		}
+		return chunks;
+	}
+
+	ModelBinChunk const * FindModelBinChunk(std::span<ModelBinChunk const> chunks, uint32_t type, uint32_t lod, uint32_t stream)
+	{
+		for (auto const & chunk : chunks)
+		{
+			if ((chunk.type == type) && (chunk.lod == lod) && (chunk.stream == stream))
+			{
+				return &chunk;
+			}
+		}
+		return nullptr;
+	}
+
+	ModelBinChunk const * FindRequiredModelBinChunk(std::span<ModelBinChunk const> chunks, uint32_t type, uint32_t lod, uint32_t stream)
+	{
+		auto const * chunk = FindModelBinChunk(chunks, type, lod, stream);
+		if (chunk == nullptr)
+		{
+			TMSG("A chunk the model needs is missing from the model_bin");
+		}
+		return chunk;
+	}
+
+	// Stored chunks of a memory mapped file are referenced in place, others end up in storage. Whole-chunk LZMA streams are decoded
+	// in parallel with each other. Framed ones already spread their frames over the thread pool, so they are decoded one at a time
+	// afterwards instead of nesting a fan-out inside the per-chunk one.
+	std::vector<std::span<uint8_t const>> DecodeModelBinChunks(ResIdentifier& file, std::span<ModelBinChunk const * const> chunks,
+		std::vector<std::vector<uint8_t>>& storage)
+	{
+		uint32_t const num_chunks = static_cast<uint32_t>(chunks.size());
+
+		auto const file_data = file.Data();
+		storage.resize(num_chunks);
+		std::vector<std::vector<uint8_t>> packed_storage(num_chunks);
+		std::vector<std::span<uint8_t const>> packed(num_chunks);
+		for (uint32_t i = 0; i < num_chunks; ++ i)
+		{
+			auto const & chunk = *chunks[i];
+			if (file_data.empty())
+			{
+				auto& buff = (chunk.codec == ModelChunkCodec::Stored) ? storage[i] : packed_storage[i];
+				buff.resize(static_cast<size_t>(chunk.len));
+				file.seekg(static_cast<int64_t>(chunk.offset), std::ios_base::beg);
+				file.read(buff.data(), buff.size());
+				Verify(file.gcount() == static_cast<int64_t>(buff.size()));
+				packed[i] = buff;
+			}
+			else
+			{
+				packed[i] = file_data.subspan(static_cast<size_t>(chunk.offset), static_cast<size_t>(chunk.len));
+			}
+		}
+
+		std::vector<std::span<uint8_t const>> decoded(num_chunks);
+		ParallelFor(Context::Instance().ThreadPoolInstance(), num_chunks, 1,
+			[&chunks, &storage, &packed, &decoded](uint32_t begin, uint32_t end)
+			{
+				LZMACodec lzma;
+				for (uint32_t i = begin; i < end; ++ i)
+				{
+					auto const & chunk = *chunks[i];
+					if (chunk.codec == ModelChunkCodec::LZMA)
+					{
+						lzma.Decode(storage[i], packed[i], chunk.original_len);
+						decoded[i] = storage[i];
+					}
+					else if (chunk.codec == ModelChunkCodec::Stored)
+					{
+						decoded[i] = packed[i];
+					}
+				}
+			});
+
+		LZMACodec lzma;
+		for (uint32_t i = 0; i < num_chunks; ++ i)
+		{
+			if (chunks[i]->codec == ModelChunkCodec::LZMAFramed)
+			{
+				lzma.DecodeFramed(storage[i], packed[i]);
+				Verify(storage[i].size() == chunks[i]->original_len);
+				decoded[i] = storage[i];
+			}
+		}
+
+		return decoded;
+	}
+
+	// Decoded data of a lod is its vertex streams followed by its indices. They have to cover every mesh of the lod before layouts
+	// are built on them.
+	void VerifyModelLodData(std::span<std::span<uint8_t const> const> lod_data, std::span<VertexElement const> ves,
+		ElementFormat index_format, ModelLodRange const & range)
+	{
+		Verify(lod_data.size() == ves.size() + 1);
+		for (size_t i = 0; i < ves.size(); ++ i)
+		{
+			Verify(lod_data[i].size() >= range.num_vertices * ves[i].element_size());
+		}
+		Verify(lod_data.back().size() >= range.num_indices * NumFormatBytes(index_format));
+	}
+
+	// Vertex formats the device can't fetch are converted before the buffer is created
+	void CreateModelVertexBuffer(GraphicsBuffer& vb, VertexElement ve, void const * data)
+	{
+		auto const & caps = Context::Instance().RenderFactoryInstance().RenderEngineInstance().DeviceCaps();
+
+		uint32_t const num_vertices = vb.Size() / sizeof(uint32_t);
+
+		std::vector<uint8_t> buff;
+		if (!caps.VertexFormatSupport(ve.format))
+		{
+			buff.resize(vb.Size());
+
+			uint32_t const * src = static_cast<uint32_t const *>(data);
+			uint32_t* dst = reinterpret_cast<uint32_t*>(buff.data());
+			data = buff.data();
+
+			if (ve.format == EF_A2BGR10)
+			{
+				ve.format = caps.BestMatchVertexFormat(MakeSpan({EF_ARGB8, EF_ABGR8}));
+
+				if (ve.format == EF_ARGB8)
+				{
+					for (uint32_t j = 0; j < num_vertices; ++ j)
+					{
+						float x = ((src[j] >> 0) & 0x3FF) / 1023.0f;
+						float y = ((src[j] >> 10) & 0x3FF) / 1023.0f;
+						float z = ((src[j] >> 20) & 0x3FF) / 1023.0f;
+						float w = ((src[j] >> 30) & 0x3) / 3.0f;
+
+						dst[j] = (MathLib::clamp(static_cast<uint32_t>(x * 255), 0U, 255U) << 16)
+							| (MathLib::clamp(static_cast<uint32_t>(y * 255), 0U, 255U) << 8)
+							| (MathLib::clamp(static_cast<uint32_t>(z * 255), 0U, 255U) << 0)
+							| (MathLib::clamp(static_cast<uint32_t>(w * 255), 0U, 255U) << 24);
+					}
+				}
+				else
+				{
+					for (uint32_t j = 0; j < num_vertices; ++ j)
+					{
+						float x = ((src[j] >> 0) & 0x3FF) / 1023.0f;
+						float y = ((src[j] >> 10) & 0x3FF) / 1023.0f;
+						float z = ((src[j] >> 20) & 0x3FF) / 1023.0f;
+						float w = ((src[j] >> 30) & 0x3) / 3.0f;
+
+						dst[j] = (MathLib::clamp(static_cast<uint32_t>(x * 255), 0U, 255U) << 0)
+							| (MathLib::clamp(static_cast<uint32_t>(y * 255), 0U, 255U) << 8)
+							| (MathLib::clamp(static_cast<uint32_t>(z * 255), 0U, 255U) << 16)
+							| (MathLib::clamp(static_cast<uint32_t>(w * 255), 0U, 255U) << 24);
+					}
+				}
+			}
+			else if (ve.format == EF_ARGB8)
+			{
+				BOOST_ASSERT(caps.VertexFormatSupport(EF_ABGR8));
+
+				ve.format = EF_ABGR8;
+
+				for (uint32_t j = 0; j < num_vertices; ++ j)
+				{
+					float x = ((src[j] >> 16) & 0xFF) / 255.0f;
+					float y = ((src[j] >> 8) & 0xFF) / 255.0f;
+					float z = ((src[j] >> 0) & 0xFF) / 255.0f;
+					float w = ((src[j] >> 24) & 0xFF) / 255.0f;
+
+					dst[j] = (MathLib::clamp(static_cast<uint32_t>(x * 255), 0U, 255U) << 0)
+						| (MathLib::clamp(static_cast<uint32_t>(y * 255), 0U, 255U) << 8)
+						| (MathLib::clamp(static_cast<uint32_t>(z * 255), 0U, 255U) << 16)
+						| (MathLib::clamp(static_cast<uint32_t>(w * 255), 0U, 255U) << 24);
+				}
+			}
+			else
+			{
+				KFL_UNREACHABLE("Invalid vertex format");
+			}
+		}
+
+		vb.CreateHWResource(data);
+	}
+
+	// Data of a key in KeyFrameTracks: real, dual, (screw direction, half angle), (screw moment, half pitch),
+	// (scale, scale of the next key, 0, 0). The screw is the motion to the next key.
+	uint32_t const KEY_DATA_STRIDE = 20;
+
+	// 4 quaternions, one component in each vector
+	using QuaternionX4 = std::array<SIMDVectorF4, 4>;
+
+	QuaternionX4 MulQuaternionX4(QuaternionX4 const& lhs, QuaternionX4 const& rhs)
+	{
+		// Same as MathLib::mul
+		return QuaternionX4{lhs[0] * rhs[3] - lhs[1] * rhs[2] + lhs[2] * rhs[1] + lhs[3] * rhs[0],
+			lhs[0] * rhs[2] + lhs[1] * rhs[3] - lhs[2] * rhs[0] + lhs[3] * rhs[1],
+			lhs[1] * rhs[0] - lhs[0] * rhs[1] + lhs[2] * rhs[3] + lhs[3] * rhs[2],
+			lhs[3] * rhs[3] - lhs[0] * rhs[0] - lhs[1] * rhs[1] - lhs[2] * rhs[2]};
+	}
+
+	// Only for |x| <= pi / 2. The half angle between two sign corrected keys, scaled by a factor in [-1, 1], is always in it.
+	void SinCosX4(SIMDVectorF4 const& x, SIMDVectorF4& s, SIMDVectorF4& c)
+	{
+		SIMDVectorF4 const x2 = x * x;
+		s = x * (1 + x2 * (-1.0f / 6 + x2 * (1.0f / 120 + x2 * (-1.0f / 5040 + x2 * (1.0f / 362880 + x2 * (-1.0f / 39916800))))));
+		c = 1
+			+ x2 * (-1.0f / 2 + x2 * (1.0f / 24 + x2 * (-1.0f / 720 + x2 * (1.0f / 40320 + x2 * (-1.0f / 3628800 + x2 * (1.0f / 479001600))))));
+	}
+
+	// A quantized key: the 3 smallest rotation components, (index of the largest | sign of it << 2), translation xyz and scale.
+	// Components other than the largest are in [-1/sqrt(2), 1/sqrt(2)], centered at QUANTIZED_ROTATION_ZERO.
+	uint32_t const QUANTIZED_KEY_STRIDE = 8;
+	uint32_t const QUANTIZED_RANGE_STRIDE = 8;
+	float const QUANTIZED_ROTATION_STEP = 1.414213562f / 65535;
+	float const QUANTIZED_ROTATION_ZERO = 32767.5f;
+
+	uint16_t QuantizeToUInt16(float v)
+	{
+		return static_cast<uint16_t>(MathLib::clamp(v + 0.5f, 0.0f, 65535.0f));
+	}
+
+	// The raw rotation of a quantized key, with a raw 0 in the slot of the largest component, and the mask of that slot, signed
+	void UnpackQuantizedRotation(uint16_t const* key, float* raw, float* mask)
+	{
+		uint32_t const largest = key[3] & 3;
+		float const sign = (key[3] & 4) ? -1.0f : 1.0f;
+		for (uint32_t i = 0, j = 0; i < 4; ++i)
+		{
+			if (i == largest)
+			{
+				raw[i] = QUANTIZED_ROTATION_ZERO;
+				mask[i] = sign;
+			}
+			else
+			{
+				raw[i] = key[j];
+				mask[i] = 0;
+				++j;
+			}
+		}
+	}
+
+	std::tuple<Quaternion, float3, float> DequantizeKey(uint16_t const* key, float const* range)
+	{
+		float raw[4];
+		float mask[4];
+		UnpackQuantizedRotation(key, raw, mask);
+
+		Quaternion real;
+		float sum_sq = 0;
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			real[i] = (raw[i] - QUANTIZED_ROTATION_ZERO) * QUANTIZED_ROTATION_STEP;
+			sum_sq += real[i] * real[i];
+		}
+		float const largest = std::sqrt(std::max(1 - sum_sq, 0.0f));
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			real[i] += largest * mask[i];
+		}
+
+		float3 const trans(range[0] + key[4] * range[4], range[1] + key[5] * range[5], range[2] + key[6] * range[6]);
+		return std::make_tuple(real, trans, range[3] + key[7] * range[7]);
+	}
+}
+
+namespace KlayGE
+{
+	// Loads the lods of a model that were left out when it was loaded, and hands them to the meshes that ask for them.
+	// All clones of the model share the loaded buffers.
+	class ModelLodStreamer final : public std::enable_shared_from_this<ModelLodStreamer>
+	{
+		KLAYGE_NONCOPYABLE(ModelLodStreamer);
+
+	public:
+		ModelLodStreamer(std::string_view runtime_name, std::vector<ModelBinChunk> chunks, std::vector<VertexElement> ves,
+			ElementFormat index_format, std::vector<ModelLodRange> lod_ranges)
+			: runtime_name_(runtime_name), chunks_(std::move(chunks)), ves_(std::move(ves)), index_format_(index_format),
+				lod_ranges_(std::move(lod_ranges)), lods_(lod_ranges_.size()), requested_(lod_ranges_.size())
+		{
+		}
+
+		std::string const & RuntimeName() const
+		{
+			return runtime_name_;
+		}
+		std::span<ModelBinChunk const> Chunks() const
+		{
+			return chunks_;
+		}
+		std::span<VertexElement const> VertexElements() const
+		{
+			return ves_;
+		}
+		ElementFormat IndexFormat() const
+		{
+			return index_format_;
+		}
+		ModelLodRange const & LodRange(uint32_t lod) const
+		{
+			return lod_ranges_[lod];
+		}
+
+		void AccessHint(uint32_t access_hint)
+		{
+			access_hint_ = access_hint;
+		}
+		uint32_t AccessHint() const
+		{
+			return access_hint_;
+		}
+
+		// Queues the lods in [first, last) that haven't been asked for yet, coarser ones first
+		void Request(uint32_t first, uint32_t last);
+		std::shared_ptr<ModelLodBuffers> SyncLoad(uint32_t lod);
+		void OnLoaded(uint32_t lod, std::shared_ptr<ModelLodBuffers> const & buffers);
+
+		// Returns false if the lod hasn't arrived yet
+		bool Bind(StaticMesh& mesh, uint32_t lod);
+
+	private:
+		std::string const runtime_name_;
+		std::vector<ModelBinChunk> const chunks_;
+		std::vector<VertexElement> const ves_;
+		ElementFormat const index_format_;
+		std::vector<ModelLodRange> const lod_ranges_;
+		uint32_t access_hint_ = EAH_GPU_Read | EAH_Immutable;
+
+		std::mutex mutex_;
+		std::vector<std::shared_ptr<ModelLodBuffers>> lods_;
+		std::vector<bool> requested_;
+	};
+}
+
+namespace
+{
+	class ModelLodLoadingDesc : public ResLoadingDesc
+	{
+	public:
+		ModelLodLoadingDesc(ModelLodStreamerPtr const & streamer, uint32_t lod)
+			: streamer_(streamer), lod_(lod)
+		{
+		}
+
+		uint64_t Type() const override
+		{
+			return CtHash("ModelLodLoadingDesc");
+		}
+
+		size_t Hash() const override
+		{
+			size_t seed = HashValue(streamer_->RuntimeName());
+			HashCombine(seed, streamer_->AccessHint());
+			HashCombine(seed, lod_);
+			return seed;
+		}
+
+		bool StateLess() const override
+		{
+			return false;
+		}
+
+		std::shared_ptr<void> CreateResource() override
+		{
+			buffers_ = MakeSharedPtr<ModelLodBuffers>();
+			return buffers_;
+		}
+
+		void SubThreadStage() override
+		{
+			std::lock_guard<std::mutex> lock(main_thread_stage_mutex_);
+
+			auto const ves = streamer_->VertexElements();
+			std::vector<ModelBinChunk const *> chunks;
+			for (uint32_t i = 0; i < ves.size(); ++ i)
+			{
+				chunks.push_back(FindRequiredModelBinChunk(streamer_->Chunks(), MODEL_CHUNK_VERTICES, lod_, i));
+			}
+			chunks.push_back(FindRequiredModelBinChunk(streamer_->Chunks(), MODEL_CHUNK_INDICES, lod_, 0));
+
+			file_ = Context::Instance().ResLoaderInstance().Open(streamer_->RuntimeName());
+			data_ = DecodeModelBinChunks(*file_, chunks, storage_);
+			VerifyModelLodData(data_, ves, streamer_->IndexFormat(), streamer_->LodRange(lod_));
+
+			if (!buffers_)
+			{
+				buffers_ = MakeSharedPtr<ModelLodBuffers>();
+			}
+
+			RenderFactory& rf = Context::Instance().RenderFactoryInstance();
+			uint32_t const access_hint = streamer_->AccessHint();
+			buffers_->vbs.resize(ves.size());
+			for (uint32_t i = 0; i < ves.size(); ++ i)
+			{
+				buffers_->vbs[i] = rf.MakeDelayCreationVertexBuffer(BU_Static, access_hint, static_cast<uint32_t>(data_[i].size()));
+			}
+			buffers_->ib = rf.MakeDelayCreationIndexBuffer(BU_Static, access_hint, static_cast<uint32_t>(data_.back().size()));
+
+			RenderDeviceCaps const & caps = rf.RenderEngineInstance().DeviceCaps();
+			if (caps.multithread_res_creating_support)
+			{
+				this->MainThreadStageNoLock();
+			}
+		}
+
+		void MainThreadStage() override
+		{
+			std::lock_guard<std::mutex> lock(main_thread_stage_mutex_);
+			this->MainThreadStageNoLock();
+		}
+
+		bool HasSubThreadStage() const override
+		{
+			return true;
+		}
+
+		bool Match([[maybe_unused]] ResLoadingDesc const & rhs) const override
+		{
+			return false;
+		}
+
+		void CopyDataFrom(ResLoadingDesc const & rhs) override
+		{
+			BOOST_ASSERT(this->Type() == rhs.Type());
+
+			ModelLodLoadingDesc const & mlld = static_cast<ModelLodLoadingDesc const &>(rhs);
+			streamer_ = mlld.streamer_;
+			lod_ = mlld.lod_;
+			buffers_ = mlld.buffers_;
+		}
+
+		std::shared_ptr<void> CloneResourceFrom(std::shared_ptr<void> const & resource) override
+		{
+			return resource;
+		}
+
+		std::shared_ptr<void> Resource() const override
+		{
+			return buffers_;
+		}
+
+	private:
+		void MainThreadStageNoLock()
+		{
+			if (file_)
+			{
+				auto const ves = streamer_->VertexElements();
+				for (uint32_t i = 0; i < ves.size(); ++ i)
+				{
+					CreateModelVertexBuffer(*buffers_->vbs[i], ves[i], data_[i].data());
+				}
+				buffers_->ib->CreateHWResource(data_.back().data());
+
+				data_.clear();
+				storage_.clear();
+				file_.reset();
+
+				streamer_->OnLoaded(lod_, buffers_);
+			}
+		}
+
+	private:
+		ModelLodStreamerPtr streamer_;
+		uint32_t lod_;
+
+		ResIdentifierPtr file_;
+		std::vector<std::vector<uint8_t>> storage_;
+		std::vector<std::span<uint8_t const>> data_;
+
+		std::shared_ptr<ModelLodBuffers> buffers_;
+		std::mutex main_thread_stage_mutex_;
+	};
 
 	class RenderModelLoadingDesc : public ResLoadingDesc
 	{
@@ -61,17 +626,20 @@ namespace
 			std::string res_name;
 			uint32_t access_hint;
 			uint32_t node_attrib;
+			bool stream_lods;
 			std::function<void(RenderModel&)> OnFinishLoading;
 			std::function<RenderModelPtr(std::wstring_view, uint32_t)> CreateModelFactoryFunc;
 			std::function<StaticMeshPtr(std::wstring_view)> CreateMeshFactoryFunc;
 
 			RenderModelPtr sw_model;
+			std::vector<std::tuple<GraphicsBufferPtr, GraphicsBufferPtr, VertexElement>> vb_creations;
+			std::vector<std::pair<GraphicsBufferPtr, GraphicsBufferPtr>> ib_creations;
 
 			std::shared_ptr<RenderModelPtr> model;
 		};
 
 	public:
-		RenderModelLoadingDesc(std::string_view res_name, uint32_t access_hint, uint32_t node_attrib,
+		RenderModelLoadingDesc(std::string_view res_name, uint32_t access_hint, uint32_t node_attrib, bool stream_lods,
 			std::function<void(RenderModel&)> OnFinishLoading,
 			std::function<RenderModelPtr(std::wstring_view, uint32_t)> CreateModelFactoryFunc,
 			std::function<StaticMeshPtr(std::wstring_view)> CreateMeshFactoryFunc)
@@ -79,6 +647,7 @@ namespace
 			model_desc_.res_name = std::string(res_name);
 			model_desc_.access_hint = access_hint;
 			model_desc_.node_attrib = node_attrib;
+			model_desc_.stream_lods = stream_lods;
 			model_desc_.OnFinishLoading = OnFinishLoading;
 			model_desc_.CreateModelFactoryFunc = CreateModelFactoryFunc;
 			model_desc_.CreateMeshFactoryFunc = CreateMeshFactoryFunc;
@@ -92,6 +661,13 @@ namespace
 			return CtHash("RenderModelLoadingDesc");
 		}
 
+		size_t Hash() const override
+		{
+			size_t seed = HashValue(model_desc_.res_name);
+			HashCombine(seed, model_desc_.access_hint);
+			return seed;
+		}
+
 		bool StateLess() const override
 		{
 			return false;
@@ -114,7 +690,7 @@ namespace
 				return;
 			}
 
-			model_desc_.sw_model = LoadSoftwareModel(model_desc_.res_name);
+			model_desc_.sw_model = LoadSoftwareModel(model_desc_.res_name, model_desc_.stream_lods);
 
 			RenderFactory& rf = Context::Instance().RenderFactoryInstance();
 			RenderDeviceCaps const & caps = rf.RenderEngineInstance().DeviceCaps();
@@ -147,6 +723,7 @@ namespace
 			RenderModelLoadingDesc const & rmld = static_cast<RenderModelLoadingDesc const &>(rhs);
 			model_desc_.res_name = rmld.model_desc_.res_name;
 			model_desc_.access_hint = rmld.model_desc_.access_hint;
+			model_desc_.stream_lods = rmld.model_desc_.stream_lods;
 			model_desc_.sw_model = rmld.model_desc_.sw_model;
 			model_desc_.model = rmld.model_desc_.model;
 		}
@@ -184,26 +761,42 @@ namespace
 
 			model->CloneDataFrom(sw_model, model_desc_.CreateMeshFactoryFunc);
 
+			// Each lod has its own vertex and index buffers, shared by all meshes that have the lod
 			RenderFactory& rf = Context::Instance().RenderFactoryInstance();
-			auto const & sw_rl = checked_pointer_cast<StaticMesh>(sw_model.Mesh(0))->GetRenderLayout(0);
-
-			std::vector<GraphicsBufferPtr> merged_vbs(sw_rl.NumVertexStreams());
-			for (uint32_t i = 0; i < sw_rl.NumVertexStreams(); ++ i)
-			{
-				merged_vbs[i] = rf.MakeDelayCreationVertexBuffer(BU_Static, model_desc_.access_hint, sw_rl.GetVertexStream(i)->Size());
-			}
-			auto merged_ib = rf.MakeDelayCreationIndexBuffer(BU_Static, model_desc_.access_hint, sw_rl.GetIndexStream()->Size());
-
+			std::map<GraphicsBuffer const *, GraphicsBufferPtr> hw_buffers;
 			for (uint32_t mesh_index = 0; mesh_index < model->NumMeshes(); ++ mesh_index)
 			{
-				for (uint32_t lod = 0; lod < model->Mesh(mesh_index)->NumLods(); ++ lod)
+				auto& mesh = checked_cast<StaticMesh&>(*model->Mesh(mesh_index));
+				if (mesh.LodStreamer())
+				{
+					mesh.LodStreamer()->AccessHint(model_desc_.access_hint);
+				}
+
+				for (uint32_t lod = mesh.ResidentLod(); lod < mesh.NumLods(); ++ lod)
 				{
-					auto& rl = model->Mesh(mesh_index)->GetRenderLayout(lod);
-					for (uint32_t i = 0; i < sw_rl.NumVertexStreams(); ++ i)
+					auto& rl = mesh.GetRenderLayout(lod);
+					for (uint32_t i = 0; i < rl.NumVertexStreams(); ++ i)
 					{
-						rl.SetVertexStream(i, merged_vbs[i]);
+						auto const & sw_vb = rl.GetVertexStream(i);
+						auto iter = hw_buffers.find(sw_vb.get());
+						if (iter == hw_buffers.end())
+						{
+							auto vb = rf.MakeDelayCreationVertexBuffer(BU_Static, model_desc_.access_hint, sw_vb->Size());
+							model_desc_.vb_creations.emplace_back(sw_vb, vb, rl.VertexStreamFormat(i)[0]);
+							iter = hw_buffers.emplace(sw_vb.get(), vb).first;
+						}
+						rl.SetVertexStream(i, iter->second);
+					}
+
+					auto const & sw_ib = rl.GetIndexStream();
+					auto iter = hw_buffers.find(sw_ib.get());
+					if (iter == hw_buffers.end())
+					{
+						auto ib = rf.MakeDelayCreationIndexBuffer(BU_Static, model_desc_.access_hint, sw_ib->Size());
+						model_desc_.ib_creations.emplace_back(sw_ib, ib);
+						iter = hw_buffers.emplace(sw_ib.get(), ib).first;
 					}
-					rl.BindIndexStream(merged_ib, rl.IndexStreamFormat());
+					rl.BindIndexStream(iter->second, rl.IndexStreamFormat());
 				}
 			}
 		}
@@ -219,107 +812,29 @@ namespace
 				if (!sub_path.empty())
 				{
 					res_loader.AddPath(sub_path);
-				}
-			}
-		}
-
-		void MainThreadStageNoLock()
-		{
-			RenderModelPtr const & model = *model_desc_.model;
-			if (!model || !model->HWResourceReady())
-			{
-				this->FillModel();
-
-				auto const & sw_model = *model_desc_.sw_model;
-
-				auto const & caps = Context::Instance().RenderFactoryInstance().RenderEngineInstance().DeviceCaps();
-				auto const & rl = checked_pointer_cast<StaticMesh>(model->Mesh(0))->GetRenderLayout();
-				auto const & sw_rl = checked_pointer_cast<StaticMesh>(sw_model.Mesh(0))->GetRenderLayout();
-
-				for (uint32_t i = 0; i < rl.NumVertexStreams(); ++ i)
-				{
-					GraphicsBuffer::Mapper mapper(*sw_rl.GetVertexStream(i), BA_Read_Only);
-
-					uint32_t const num_vertices = sw_rl.GetVertexStream(i)->Size() / sizeof(uint32_t);
-
-					void* ptr = mapper.Pointer<void>();
-					auto ve = sw_rl.VertexStreamFormat(i)[0];
-
-					std::vector<uint8_t> buff;
-					if (!caps.VertexFormatSupport(ve.format))
-					{
-						buff.resize(sw_rl.GetVertexStream(i)->Size());
-						ptr = buff.data();
-
-						uint32_t const * src = mapper.Pointer<uint32_t>();
-						uint32_t* dst = static_cast<uint32_t*>(ptr);
-
-						if (ve.format == EF_A2BGR10)
-						{
-							ve.format = caps.BestMatchVertexFormat(MakeSpan({EF_ARGB8, EF_ABGR8}));
-
-							if (ve.format == EF_ARGB8)
-							{
-								for (uint32_t j = 0; j < num_vertices; ++ j)
-								{
-									float x = ((src[j] >> 0) & 0x3FF) / 1023.0f;
-									float y = ((src[j] >> 10) & 0x3FF) / 1023.0f;
-									float z = ((src[j] >> 20) & 0x3FF) / 1023.0f;
-									float w = ((src[j] >> 30) & 0x3) / 3.0f;
-
-									dst[j] = (MathLib::clamp(static_cast<uint32_t>(x * 255), 0U, 255U) << 16)
-										| (MathLib::clamp(static_cast<uint32_t>(y * 255), 0U, 255U) << 8)
-										| (MathLib::clamp(static_cast<uint32_t>(z * 255), 0U, 255U) << 0)
-										| (MathLib::clamp(static_cast<uint32_t>(w * 255), 0U, 255U) << 24);
-								}
-							}
-							else
-							{
-								for (uint32_t j = 0; j < num_vertices; ++ j)
-								{
-									float x = ((src[j] >> 0) & 0x3FF) / 1023.0f;
-									float y = ((src[j] >> 10) & 0x3FF) / 1023.0f;
-									float z = ((src[j] >> 20) & 0x3FF) / 1023.0f;
-									float w = ((src[j] >> 30) & 0x3) / 3.0f;
-
-									dst[j] = (MathLib::clamp(static_cast<uint32_t>(x * 255), 0U, 255U) << 0)
-										| (MathLib::clamp(static_cast<uint32_t>(y * 255), 0U, 255U) << 8)
-										| (MathLib::clamp(static_cast<uint32_t>(z * 255), 0U, 255U) << 16)
-										| (MathLib::clamp(static_cast<uint32_t>(w * 255), 0U, 255U) << 24);
-								}
-							}
-						}
-						else if (ve.format == EF_ARGB8)
-						{
-							BOOST_ASSERT(caps.VertexFormatSupport(EF_ABGR8));
-
-							ve.format = EF_ABGR8;
+				}
+			}
+		}
 
-							for (uint32_t j = 0; j < num_vertices; ++ j)
-							{
-								float x = ((src[j] >> 16) & 0xFF) / 255.0f;
-								float y = ((src[j] >> 8) & 0xFF) / 255.0f;
-								float z = ((src[j] >> 0) & 0xFF) / 255.0f;
-								float w = ((src[j] >> 24) & 0xFF) / 255.0f;
-
-								dst[j] = (MathLib::clamp(static_cast<uint32_t>(x * 255), 0U, 255U) << 0)
-									| (MathLib::clamp(static_cast<uint32_t>(y * 255), 0U, 255U) << 8)
-									| (MathLib::clamp(static_cast<uint32_t>(z * 255), 0U, 255U) << 16)
-									| (MathLib::clamp(static_cast<uint32_t>(w * 255), 0U, 255U) << 24);
-							}
-						}
-						else
-						{
-							KFL_UNREACHABLE("Invalid vertex format");
-						}
-					}
+		void MainThreadStageNoLock()
+		{
+			RenderModelPtr const & model = *model_desc_.model;
+			if (!model || !model->HWResourceReady())
+			{
+				this->FillModel();
 
-					rl.GetVertexStream(i)->CreateHWResource(ptr);
+				for (auto const & [sw_vb, vb, ve] : model_desc_.vb_creations)
+				{
+					GraphicsBuffer::Mapper mapper(*sw_vb, BA_Read_Only);
+					CreateModelVertexBuffer(*vb, ve, mapper.Pointer<void>());
 				}
+				for (auto const & [sw_ib, ib] : model_desc_.ib_creations)
 				{
-					GraphicsBuffer::Mapper mapper(*sw_rl.GetIndexStream(), BA_Read_Only);
-					rl.GetIndexStream()->CreateHWResource(mapper.Pointer<void>());
+					GraphicsBuffer::Mapper mapper(*sw_ib, BA_Read_Only);
+					ib->CreateHWResource(mapper.Pointer<void>());
 				}
+				model_desc_.vb_creations.clear();
+				model_desc_.ib_creations.clear();
 
 				model->BuildModelInfo();
 				for (uint32_t i = 0; i < model->NumMeshes(); ++ i)
@@ -344,6 +859,69 @@ namespace
 
 namespace KlayGE
 {
+	void ModelLodStreamer::Request(uint32_t first, uint32_t last)
+	{
+		for (uint32_t lod = last; lod > first; -- lod)
+		{
+			bool needs_loading;
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				needs_loading = !requested_[lod - 1];
+				requested_[lod - 1] = true;
+			}
+			if (needs_loading)
+			{
+				Context::Instance().ResLoaderInstance().ASyncQuery(MakeSharedPtr<ModelLodLoadingDesc>(this->shared_from_this(), lod - 1));
+			}
+		}
+	}
+
+	std::shared_ptr<ModelLodBuffers> ModelLodStreamer::SyncLoad(uint32_t lod)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (lods_[lod])
+			{
+				return lods_[lod];
+			}
+		}
+
+		Context::Instance().ResLoaderInstance().SyncQuery(MakeSharedPtr<ModelLodLoadingDesc>(this->shared_from_this(), lod));
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		return lods_[lod];
+	}
+
+	void ModelLodStreamer::OnLoaded(uint32_t lod, std::shared_ptr<ModelLodBuffers> const & buffers)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (!lods_[lod])
+		{
+			lods_[lod] = buffers;
+		}
+		requested_[lod] = true;
+	}
+
+	bool ModelLodStreamer::Bind(StaticMesh& mesh, uint32_t lod)
+	{
+		std::shared_ptr<ModelLodBuffers> buffers;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			buffers = lods_[lod];
+		}
+
+		if (buffers)
+		{
+			for (uint32_t i = 0; i < ves_.size(); ++ i)
+			{
+				mesh.AddVertexStream(lod, buffers->vbs[i], ves_[i]);
+			}
+			mesh.AddIndexStream(lod, buffers->ib, index_format_);
+		}
+		return static_cast<bool>(buffers);
+	}
+
+
 	void AddToSceneHelper(SceneNode& node, RenderModel& model)
 	{
 		auto& scene_mgr = Context::Instance().SceneManagerInstance();
@@ -469,13 +1047,17 @@ namespace KlayGE
 					{
 						mesh.AddVertexStream(lod, src_rl.GetVertexStream(ve_index), src_rl.VertexStreamFormat(ve_index)[0]);
 					}
-					mesh.AddIndexStream(lod, src_rl.GetIndexStream(), src_rl.IndexStreamFormat());
+					if (src_rl.GetIndexStream())
+					{
+						mesh.AddIndexStream(lod, src_rl.GetIndexStream(), src_rl.IndexStreamFormat());
+					}
 
 					mesh.NumVertices(lod, src_mesh.NumVertices(lod));
 					mesh.NumIndices(lod, src_mesh.NumIndices(lod));
 					mesh.StartVertexLocation(lod, src_mesh.StartVertexLocation(lod));
 					mesh.StartIndexLocation(lod, src_mesh.StartIndexLocation(lod));
 				}
+				mesh.LodStreamer(src_mesh.LodStreamer(), src_mesh.ResidentLod());
 			}
 
 			this->AssignMeshes(meshes.begin(), meshes.end());
@@ -537,7 +1119,7 @@ namespace KlayGE
 
 	StaticMesh::StaticMesh(std::wstring_view name)
 		: Renderable(name),
-			hw_res_ready_(false)
+			hw_res_ready_(false), resident_lod_(0)
 	{
 	}
 	
@@ -568,12 +1150,34 @@ namespace KlayGE
 		}
 	}
 
+	uint32_t StaticMesh::StreamLod(uint32_t lod)
+	{
+		if ((lod < resident_lod_) && lod_streamer_)
+		{
+			while ((resident_lod_ > lod) && lod_streamer_->Bind(*this, resident_lod_ - 1))
+			{
+				-- resident_lod_;
+			}
+			if (resident_lod_ > lod)
+			{
+				lod_streamer_->Request(lod, resident_lod_);
+			}
+		}
+		return std::max(lod, resident_lod_);
+	}
+
+	void StaticMesh::LodStreamer(ModelLodStreamerPtr const & streamer, uint32_t resident_lod)
+	{
+		lod_streamer_ = streamer;
+		resident_lod_ = resident_lod;
+	}
+
 	void StaticMesh::DoBuildMeshInfo(RenderModel const & model)
 	{
 		bool is_skinned = false;
-		for (uint32_t i = 0; !is_skinned && (i < rls_[0]->NumVertexStreams()); ++i)
+		for (uint32_t i = 0; !is_skinned && (i < rls_[resident_lod_]->NumVertexStreams()); ++i)
 		{
-			auto const& vertex_stream_fmt = rls_[0]->VertexStreamFormat(i);
+			auto const& vertex_stream_fmt = rls_[resident_lod_]->VertexStreamFormat(i);
 			for (auto const& vertex_elem : vertex_stream_fmt)
 			{
 				if ((vertex_elem.usage == VEU_BlendIndex) || (vertex_elem.usage == VEU_BlendWeight))
@@ -646,29 +1250,534 @@ namespace KlayGE
 			auto dq = MathLib::sclerp(bind_real[index0], bind_dual[index0], bind_real[index1], bind_dual[index1], factor);
 			ret = std::make_tuple(dq.first, dq.second, MathLib::lerp(bind_scale[index0], bind_scale[index1], factor));
 		}
-		return ret;
-	}
+		return ret;
+	}
+
+	AABBox AABBKeyFrameSet::Frame(float frame) const
+	{
+		if (frame_id.size() == 1)
+		{
+			return bb[0];
+		}
+		else
+		{
+			frame = std::fmod(frame, static_cast<float>(frame_id.back() + 1));
+
+			auto iter = std::upper_bound(frame_id.begin(), frame_id.end(), frame);
+			int index = static_cast<int>(iter - frame_id.begin());
+
+			int index0 = index - 1;
+			int index1 = index % frame_id.size();
+			int frame0 = frame_id[index0];
+			int frame1 = frame_id[index1];
+			float factor = (frame - frame0) / (frame1 - frame0);
+			return AABBox(MathLib::lerp(bb[index0].Min(), bb[index1].Min(), factor),
+				MathLib::lerp(bb[index0].Max(), bb[index1].Max(), factor));
+		}
+	}
+
+
+	KeyFrameTracks::KeyFrameTracks() : track_first_keys_(1, 0)
+	{
+	}
+
+	KeyFrameTracks::KeyFrameTracks(std::span<KeyFrameSet const> kfs, bool quantize)
+	{
+		size_t num_keys = 0;
+		for (auto const& kf : kfs)
+		{
+			num_keys += kf.frame_id.size();
+		}
+
+		quantized_ = quantize;
+		track_first_keys_.resize(kfs.size() + 1);
+		frame_ids_.reserve(num_keys);
+		if (quantize)
+		{
+			track_ranges_.resize(kfs.size() * QUANTIZED_RANGE_STRIDE);
+			quantized_keys_.resize(num_keys * QUANTIZED_KEY_STRIDE);
+		}
+		else
+		{
+			key_data_.assign(num_keys * KEY_DATA_STRIDE, 0);
+		}
+
+		track_first_keys_[0] = 0;
+		for (size_t track = 0; track < kfs.size(); ++track)
+		{
+			auto const& kf = kfs[track];
+			uint32_t const first_key = track_first_keys_[track];
+			uint32_t const num_track_keys = static_cast<uint32_t>(kf.frame_id.size());
+			BOOST_ASSERT(num_track_keys > 0);
+
+			track_first_keys_[track + 1] = first_key + num_track_keys;
+			frame_ids_.insert(frame_ids_.end(), kf.frame_id.begin(), kf.frame_id.end());
+
+			if (quantize)
+			{
+				this->QuantizeTrack(static_cast<uint32_t>(track), kf);
+				continue;
+			}
+
+			for (uint32_t key = 0; key < num_track_keys; ++key)
+			{
+				uint32_t const next_key = (key + 1) % num_track_keys;
+				float* data = &key_data_[(first_key + key) * KEY_DATA_STRIDE];
+
+				std::copy(kf.bind_real[key].begin(), kf.bind_real[key].end(), &data[0]);
+				std::copy(kf.bind_dual[key].begin(), kf.bind_dual[key].end(), &data[4]);
+				data[16] = kf.bind_scale[key];
+				data[17] = kf.bind_scale[next_key];
+
+				if (num_track_keys > 1)
+				{
+					// The part of MathLib::sclerp that doesn't depend on the factor
+					Quaternion next_real = kf.bind_real[next_key];
+					Quaternion next_dual = kf.bind_dual[next_key];
+					if (MathLib::dot(kf.bind_real[key], next_real) < 0)
+					{
+						next_real = -next_real;
+						next_dual = -next_dual;
+					}
+
+					auto dif_dq = MathLib::inverse(kf.bind_real[key], kf.bind_dual[key]);
+					dif_dq.second = MathLib::mul_dual(dif_dq.first, dif_dq.second, next_real, next_dual);
+					dif_dq.first = MathLib::mul_real(dif_dq.first, next_real);
+
+					float angle, pitch;
+					float3 dir, moment;
+					MathLib::udq_to_screw(angle, pitch, dir, moment, dif_dq.first, dif_dq.second);
+
+					std::copy(dir.begin(), dir.end(), &data[8]);
+					data[11] = angle * 0.5f;
+					std::copy(moment.begin(), moment.end(), &data[12]);
+					data[15] = pitch * 0.5f;
+				}
+			}
+		}
+	}
+
+	void KeyFrameTracks::QuantizeTrack(uint32_t track, KeyFrameSet const& kf)
+	{
+		uint32_t const first_key = track_first_keys_[track];
+		uint32_t const num_track_keys = track_first_keys_[track + 1] - first_key;
+
+		std::vector<float4> trans_scales(num_track_keys);
+		float4 min_trans_scale(+1e10f, +1e10f, +1e10f, +1e10f);
+		float4 max_trans_scale(-1e10f, -1e10f, -1e10f, -1e10f);
+		for (uint32_t key = 0; key < num_track_keys; ++key)
+		{
+			float3 const trans = MathLib::udq_to_trans(kf.bind_real[key], kf.bind_dual[key]);
+			trans_scales[key] = float4(trans.x(), trans.y(), trans.z(), kf.bind_scale[key]);
+			min_trans_scale = MathLib::minimize(min_trans_scale, trans_scales[key]);
+			max_trans_scale = MathLib::maximize(max_trans_scale, trans_scales[key]);
+		}
+
+		float* range = &track_ranges_[track * QUANTIZED_RANGE_STRIDE];
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			range[i] = min_trans_scale[i];
+			range[4 + i] = (max_trans_scale[i] - min_trans_scale[i]) / 65535;
+		}
+
+		for (uint32_t key = 0; key < num_track_keys; ++key)
+		{
+			uint16_t* data = &quantized_keys_[(first_key + key) * QUANTIZED_KEY_STRIDE];
+
+			Quaternion const& real = kf.bind_real[key];
+			uint32_t largest = 0;
+			for (uint32_t i = 1; i < 4; ++i)
+			{
+				if (std::abs(real[i]) > std::abs(real[largest]))
+				{
+					largest = i;
+				}
+			}
+			for (uint32_t i = 0, j = 0; i < 4; ++i)
+			{
+				if (i != largest)
+				{
+					data[j] = QuantizeToUInt16(real[i] / QUANTIZED_ROTATION_STEP + QUANTIZED_ROTATION_ZERO);
+					++j;
+				}
+			}
+			data[3] = static_cast<uint16_t>(largest | ((real[largest] < 0) ? 4 : 0));
+
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				data[4 + i] = (range[4 + i] > 0) ? QuantizeToUInt16((trans_scales[key][i] - range[i]) / range[4 + i]) : 0;
+			}
+		}
+	}
+
+	uint32_t KeyFrameTracks::FindKey(uint32_t track, float frame, uint32_t& cursor, float& factor) const noexcept
+	{
+		uint32_t const first_key = track_first_keys_[track];
+		uint32_t const num_keys = track_first_keys_[track + 1] - first_key;
+
+		factor = 0;
+		if (num_keys == 1)
+		{
+			return first_key;
+		}
+
+		uint32_t const* ids = &frame_ids_[first_key];
+		float const length = static_cast<float>(ids[num_keys - 1] + 1);
+		if ((frame < 0) || (frame >= length))
+		{
+			frame = std::fmod(frame, length);
+		}
+		if (frame < ids[0])
+		{
+			cursor = 0;
+			return first_key;
+		}
+
+		// The key is the last one not after the frame, as the upper_bound in KeyFrameSet::Frame finds. Try the cursor and the
+		// key after it before searching.
+		auto const is_key_of = [ids, num_keys, frame](uint32_t key) {
+			return (ids[key] <= frame) && ((key + 1 == num_keys) || (frame < ids[key + 1]));
+		};
+		uint32_t key = std::min(cursor, num_keys - 1);
+		if (!is_key_of(key))
+		{
+			key = (key + 1) % num_keys;
+			if (!is_key_of(key))
+			{
+				key = static_cast<uint32_t>(std::upper_bound(ids, ids + num_keys, frame) - ids) - 1;
+			}
+		}
+		cursor = key;
+
+		int const frame0 = ids[key];
+		int const frame1 = ids[(key + 1) % num_keys];
+		factor = (frame - frame0) / (frame1 - frame0);
+		return first_key + key;
+	}
+
+	void KeyFrameTracks::Sample(float frame, std::span<uint32_t> cursors, std::span<Quaternion> reals, std::span<Quaternion> duals,
+		std::span<float> scales) const
+	{
+		uint32_t const num_tracks = this->NumTracks();
+		BOOST_ASSERT(cursors.size() == num_tracks);
+		BOOST_ASSERT(reals.size() == num_tracks);
+		BOOST_ASSERT(duals.size() == num_tracks);
+		BOOST_ASSERT(scales.size() == num_tracks);
+
+		if (quantized_)
+		{
+			this->SampleQuantized(frame, cursors, reals, duals, scales);
+			return;
+		}
+
+		for (uint32_t first_track = 0; first_track < num_tracks; first_track += 4)
+		{
+			uint32_t const num_lanes = std::min(num_tracks - first_track, 4U);
+
+			float factors[4];
+			float const* keys[4];
+			for (uint32_t lane = 0; lane < num_lanes; ++lane)
+			{
+				uint32_t const track = first_track + lane;
+				keys[lane] = &key_data_[this->FindKey(track, frame, cursors[track], factors[lane]) * KEY_DATA_STRIDE];
+			}
+			for (uint32_t lane = num_lanes; lane < 4; ++lane)
+			{
+				keys[lane] = keys[num_lanes - 1];
+				factors[lane] = factors[num_lanes - 1];
+			}
+
+			SIMDMatrixF4 key_data[KEY_DATA_STRIDE / 4];
+			for (uint32_t i = 0; i < std::size(key_data); ++i)
+			{
+				key_data[i] = SIMDMathLib::Transpose(SIMDMatrixF4(SIMDMathLib::LoadVector4(keys[0] + i * 4),
+					SIMDMathLib::LoadVector4(keys[1] + i * 4), SIMDMathLib::LoadVector4(keys[2] + i * 4),
+					SIMDMathLib::LoadVector4(keys[3] + i * 4)));
+			}
+			QuaternionX4 const key_real = {key_data[0].Row(0), key_data[0].Row(1), key_data[0].Row(2), key_data[0].Row(3)};
+			QuaternionX4 const key_dual = {key_data[1].Row(0), key_data[1].Row(1), key_data[1].Row(2), key_data[1].Row(3)};
+			SIMDMatrixF4 const& dir = key_data[2];
+			SIMDMatrixF4 const& moment = key_data[3];
+
+			// MathLib::udq_from_screw of the screw scaled by the factors, then multiplied to the keys
+			SIMDVectorF4 const factor = SIMDMathLib::SetVector(factors[0], factors[1], factors[2], factors[3]);
+			SIMDVectorF4 sa, ca;
+			SinCosX4(dir.Row(3) * factor, sa, ca);
+			SIMDVectorF4 const half_pitch = moment.Row(3) * factor;
+			SIMDVectorF4 const half_pitch_ca = half_pitch * ca;
+
+			QuaternionX4 const dif_real = {dir.Row(0) * sa, dir.Row(1) * sa, dir.Row(2) * sa, ca};
+			QuaternionX4 const dif_dual = {sa * moment.Row(0) + half_pitch_ca * dir.Row(0), sa * moment.Row(1) + half_pitch_ca * dir.Row(1),
+				sa * moment.Row(2) + half_pitch_ca * dir.Row(2), -(half_pitch * sa)};
+
+			QuaternionX4 const real = MulQuaternionX4(key_real, dif_real);
+			QuaternionX4 dual = MulQuaternionX4(key_real, dif_dual);
+			QuaternionX4 const dual_rhs = MulQuaternionX4(key_dual, dif_real);
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				dual[i] += dual_rhs[i];
+			}
+			SIMDVectorF4 const scale = key_data[4].Row(0) + (key_data[4].Row(1) - key_data[4].Row(0)) * factor;
+
+			SIMDMatrixF4 const lane_reals = SIMDMathLib::Transpose(SIMDMatrixF4(real[0], real[1], real[2], real[3]));
+			SIMDMatrixF4 const lane_duals = SIMDMathLib::Transpose(SIMDMatrixF4(dual[0], dual[1], dual[2], dual[3]));
+			float4 lane_scales;
+			SIMDMathLib::StoreVector4(lane_scales, scale);
+			for (uint32_t lane = 0; lane < num_lanes; ++lane)
+			{
+				float4 tmp;
+				SIMDMathLib::StoreVector4(tmp, lane_reals.Row(lane));
+				reals[first_track + lane] = Quaternion(&tmp[0]);
+				SIMDMathLib::StoreVector4(tmp, lane_duals.Row(lane));
+				duals[first_track + lane] = Quaternion(&tmp[0]);
+				scales[first_track + lane] = lane_scales[lane];
+			}
+		}
+	}
+
+	void KeyFrameTracks::SampleQuantized(float frame, std::span<uint32_t> cursors, std::span<Quaternion> reals,
+		std::span<Quaternion> duals, std::span<float> scales) const
+	{
+		uint32_t const num_tracks = this->NumTracks();
+		for (uint32_t first_track = 0; first_track < num_tracks; first_track += 4)
+		{
+			uint32_t const num_lanes = std::min(num_tracks - first_track, 4U);
+
+			// Per lane: raw rotations and masks of the 2 keys, raw translations and scales of the 2 keys, then the range
+			float factors[4];
+			alignas(16) float lane_data[4][32];
+			for (uint32_t lane = 0; lane < num_lanes; ++lane)
+			{
+				uint32_t const track = first_track + lane;
+				uint32_t const key = this->FindKey(track, frame, cursors[track], factors[lane]);
+				uint32_t const next_key = (key + 1 == track_first_keys_[track + 1]) ? track_first_keys_[track] : key + 1;
+				uint16_t const* key0 = &quantized_keys_[key * QUANTIZED_KEY_STRIDE];
+				uint16_t const* key1 = &quantized_keys_[next_key * QUANTIZED_KEY_STRIDE];
+
+				float* data = lane_data[lane];
+				UnpackQuantizedRotation(key0, &data[0], &data[4]);
+				UnpackQuantizedRotation(key1, &data[8], &data[12]);
+				for (uint32_t i = 0; i < 4; ++i)
+				{
+					data[16 + i] = key0[4 + i];
+					data[20 + i] = key1[4 + i];
+				}
+				std::copy_n(&track_ranges_[track * QUANTIZED_RANGE_STRIDE], QUANTIZED_RANGE_STRIDE, &data[24]);
+			}
+			for (uint32_t lane = num_lanes; lane < 4; ++lane)
+			{
+				std::copy_n(lane_data[num_lanes - 1], std::size(lane_data[lane]), lane_data[lane]);
+				factors[lane] = factors[num_lanes - 1];
+			}
+
+			SIMDMatrixF4 key_data[8];
+			for (uint32_t i = 0; i < std::size(key_data); ++i)
+			{
+				key_data[i] = SIMDMathLib::Transpose(SIMDMatrixF4(SIMDMathLib::LoadVector4(&lane_data[0][i * 4]),
+					SIMDMathLib::LoadVector4(&lane_data[1][i * 4]), SIMDMathLib::LoadVector4(&lane_data[2][i * 4]),
+					SIMDMathLib::LoadVector4(&lane_data[3][i * 4])));
+			}
+
+			SIMDVectorF4 const zero = SIMDMathLib::SetVector(0.0f);
+			SIMDVectorF4 const one = SIMDMathLib::SetVector(1.0f);
+
+			auto const dequantize_rotation = [&zero, &one](SIMDMatrixF4 const& raw, SIMDMatrixF4 const& mask) {
+				QuaternionX4 ret;
+				SIMDVectorF4 sum_sq = zero;
+				for (uint32_t i = 0; i < 4; ++i)
+				{
+					ret[i] = (raw.Row(i) - QUANTIZED_ROTATION_ZERO) * QUANTIZED_ROTATION_STEP;
+					sum_sq += ret[i] * ret[i];
+				}
+				SIMDVectorF4 const largest = SIMDMathLib::Sqrt(SIMDMathLib::Maximize(one - sum_sq, zero));
+				for (uint32_t i = 0; i < 4; ++i)
+				{
+					ret[i] += largest * mask.Row(i);
+				}
+				return ret;
+			};
+			QuaternionX4 const real0 = dequantize_rotation(key_data[0], key_data[1]);
+			QuaternionX4 real1 = dequantize_rotation(key_data[2], key_data[3]);
+
+			// nlerp on the shorter arc, the same side MathLib::sclerp takes
+			SIMDVectorF4 const factor = SIMDMathLib::SetVector(factors[0], factors[1], factors[2], factors[3]);
+			SIMDVectorF4 const side =
+				SIMDMathLib::Sgn(real0[0] * real1[0] + real0[1] * real1[1] + real0[2] * real1[2] + real0[3] * real1[3] +
+								 std::numeric_limits<float>::min());
+			QuaternionX4 real;
+			SIMDVectorF4 len_sq = zero;
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				real[i] = real0[i] + (real1[i] * side - real0[i]) * factor;
+				len_sq += real[i] * real[i];
+			}
+			SIMDVectorF4 const inv_len = one / SIMDMathLib::Sqrt(len_sq);
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				real[i] *= inv_len;
+			}
+
+			SIMDMatrixF4 const& min_trans_scale = key_data[6];
+			SIMDMatrixF4 const& step_trans_scale = key_data[7];
+			SIMDVectorF4 trans_scale[4];
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				SIMDVectorF4 const raw = key_data[4].Row(i) + (key_data[5].Row(i) - key_data[4].Row(i)) * factor;
+				trans_scale[i] = min_trans_scale.Row(i) + raw * step_trans_scale.Row(i);
+			}
+
+			// MathLib::quat_trans_to_udq
+			QuaternionX4 const half_trans = {trans_scale[0] * 0.5f, trans_scale[1] * 0.5f, trans_scale[2] * 0.5f, zero};
+			QuaternionX4 const dual = MulQuaternionX4(real, half_trans);
+
+			SIMDMatrixF4 const lane_reals = SIMDMathLib::Transpose(SIMDMatrixF4(real[0], real[1], real[2], real[3]));
+			SIMDMatrixF4 const lane_duals = SIMDMathLib::Transpose(SIMDMatrixF4(dual[0], dual[1], dual[2], dual[3]));
+			float4 lane_scales;
+			SIMDMathLib::StoreVector4(lane_scales, trans_scale[3]);
+			for (uint32_t lane = 0; lane < num_lanes; ++lane)
+			{
+				float4 tmp;
+				SIMDMathLib::StoreVector4(tmp, lane_reals.Row(lane));
+				reals[first_track + lane] = Quaternion(&tmp[0]);
+				SIMDMathLib::StoreVector4(tmp, lane_duals.Row(lane));
+				duals[first_track + lane] = Quaternion(&tmp[0]);
+				scales[first_track + lane] = lane_scales[lane];
+			}
+		}
+	}
+
+	std::tuple<Quaternion, Quaternion, float> KeyFrameTracks::QuantizedBlend(Quaternion const& real0, Quaternion const& dual0,
+		float scale0, Quaternion const& real1, Quaternion const& dual1, float scale1, float factor)
+	{
+		Quaternion const side_real1 = (MathLib::dot(real0, real1) < 0) ? -real1 : real1;
+		Quaternion const real = MathLib::normalize(real0 + (side_real1 - real0) * factor);
+		float3 const trans = MathLib::lerp(MathLib::udq_to_trans(real0, dual0), MathLib::udq_to_trans(real1, dual1), factor);
+		return std::make_tuple(real, MathLib::quat_trans_to_udq(real, trans), MathLib::lerp(scale0, scale1, factor));
+	}
+
+	std::vector<KeyFrameSet> KeyFrameTracks::ToKeyFrameSets() const
+	{
+		uint32_t const num_tracks = this->NumTracks();
+		std::vector<KeyFrameSet> kfs(num_tracks);
+		for (uint32_t track = 0; track < num_tracks; ++track)
+		{
+			uint32_t const first_key = track_first_keys_[track];
+			uint32_t const num_track_keys = track_first_keys_[track + 1] - first_key;
+
+			auto& kf = kfs[track];
+			kf.frame_id.assign(frame_ids_.begin() + first_key, frame_ids_.begin() + first_key + num_track_keys);
+			kf.bind_real.resize(num_track_keys);
+			kf.bind_dual.resize(num_track_keys);
+			kf.bind_scale.resize(num_track_keys);
+			for (uint32_t key = 0; key < num_track_keys; ++key)
+			{
+				if (quantized_)
+				{
+					float3 trans;
+					std::tie(kf.bind_real[key], trans, kf.bind_scale[key]) = DequantizeKey(
+						&quantized_keys_[(first_key + key) * QUANTIZED_KEY_STRIDE], &track_ranges_[track * QUANTIZED_RANGE_STRIDE]);
+					kf.bind_dual[key] = MathLib::quat_trans_to_udq(kf.bind_real[key], trans);
+				}
+				else
+				{
+					float const* data = &key_data_[(first_key + key) * KEY_DATA_STRIDE];
+					kf.bind_real[key] = Quaternion(&data[0]);
+					kf.bind_dual[key] = Quaternion(&data[4]);
+					kf.bind_scale[key] = data[16];
+				}
+			}
+		}
+		return kfs;
+	}
+
+	void KeyFrameTracks::StreamIn(ResIdentifier& res)
+	{
+		// Counts are checked against what is left of the stream before anything is allocated
+		uint64_t const size_left = StreamSize(res) - static_cast<uint64_t>(res.tellg());
+		uint32_t const key_size = sizeof(frame_ids_[0]) + QUANTIZED_KEY_STRIDE * sizeof(quantized_keys_[0]);
+
+		uint32_t num_tracks;
+		res.read(&num_tracks, sizeof(num_tracks));
+		Verify(res.gcount() == sizeof(num_tracks));
+		num_tracks = LE2Native(num_tracks);
+		// A track has its key count, its range and at least one key
+		Verify(num_tracks <= size_left / (sizeof(uint32_t) + QUANTIZED_RANGE_STRIDE * sizeof(track_ranges_[0]) + key_size));
+
+		quantized_ = true;
+		key_data_.clear();
+		track_first_keys_.resize(num_tracks + 1);
+		track_first_keys_[0] = 0;
+		for (uint32_t track = 0; track < num_tracks; ++track)
+		{
+			uint32_t num_track_keys;
+			res.read(&num_track_keys, sizeof(num_track_keys));
+			Verify(res.gcount() == sizeof(num_track_keys));
+			num_track_keys = LE2Native(num_track_keys);
+			Verify((num_track_keys > 0) && (num_track_keys <= size_left / key_size - track_first_keys_[track]));
+			track_first_keys_[track + 1] = track_first_keys_[track] + num_track_keys;
+		}
+		uint32_t const num_keys = track_first_keys_.back();
+
+		frame_ids_.resize(num_keys);
+		res.read(frame_ids_.data(), frame_ids_.size() * sizeof(frame_ids_[0]));
+		Verify(res.gcount() == static_cast<int64_t>(frame_ids_.size() * sizeof(frame_ids_[0])));
+		for (auto& id : frame_ids_)
+		{
+			id = LE2Native(id);
+		}
+		for (uint32_t track = 0; track < num_tracks; ++track)
+		{
+			// Keys are searched by frame
+			for (uint32_t key = track_first_keys_[track] + 1; key < track_first_keys_[track + 1]; ++key)
+			{
+				Verify(frame_ids_[key - 1] < frame_ids_[key]);
+			}
+		}
 
-	AABBox AABBKeyFrameSet::Frame(float frame) const
-	{
-		if (frame_id.size() == 1)
+		track_ranges_.resize(num_tracks * QUANTIZED_RANGE_STRIDE);
+		res.read(track_ranges_.data(), track_ranges_.size() * sizeof(track_ranges_[0]));
+		Verify(res.gcount() == static_cast<int64_t>(track_ranges_.size() * sizeof(track_ranges_[0])));
+		for (auto& range : track_ranges_)
 		{
-			return bb[0];
+			range = LE2Native(range);
 		}
-		else
+
+		quantized_keys_.resize(num_keys * QUANTIZED_KEY_STRIDE);
+		res.read(quantized_keys_.data(), quantized_keys_.size() * sizeof(quantized_keys_[0]));
+		Verify(res.gcount() == static_cast<int64_t>(quantized_keys_.size() * sizeof(quantized_keys_[0])));
+		for (auto& value : quantized_keys_)
 		{
-			frame = std::fmod(frame, static_cast<float>(frame_id.back() + 1));
+			value = LE2Native(value);
+		}
+	}
 
-			auto iter = std::upper_bound(frame_id.begin(), frame_id.end(), frame);
-			int index = static_cast<int>(iter - frame_id.begin());
+	void KeyFrameTracks::StreamOut(std::ostream& os) const
+	{
+		BOOST_ASSERT(quantized_);
 
-			int index0 = index - 1;
-			int index1 = index % frame_id.size();
-			int frame0 = frame_id[index0];
-			int frame1 = frame_id[index1];
-			float factor = (frame - frame0) / (frame1 - frame0);
-			return AABBox(MathLib::lerp(bb[index0].Min(), bb[index1].Min(), factor),
-				MathLib::lerp(bb[index0].Max(), bb[index1].Max(), factor));
+		uint32_t const num_tracks = this->NumTracks();
+		uint32_t tmp = Native2LE(num_tracks);
+		os.write(reinterpret_cast<char const*>(&tmp), sizeof(tmp));
+		for (uint32_t track = 0; track < num_tracks; ++track)
+		{
+			tmp = Native2LE(track_first_keys_[track + 1] - track_first_keys_[track]);
+			os.write(reinterpret_cast<char const*>(&tmp), sizeof(tmp));
+		}
+
+		for (uint32_t id : frame_ids_)
+		{
+			id = Native2LE(id);
+			os.write(reinterpret_cast<char const*>(&id), sizeof(id));
+		}
+		for (float range : track_ranges_)
+		{
+			range = Native2LE(range);
+			os.write(reinterpret_cast<char const*>(&range), sizeof(range));
+		}
+		for (uint16_t value : quantized_keys_)
+		{
+			value = Native2LE(value);
+			os.write(reinterpret_cast<char const*>(&value), sizeof(value));
 		}
 	}
 
@@ -711,7 +1820,7 @@ namespace KlayGE
 
 	SkinnedModel::SkinnedModel(SceneNodePtr const & root_node)
 		: RenderModel(root_node),
-			last_frame_(0),
+			quantize_key_frames_(false), last_frame_(0),
 			num_frames_(0), frame_rate_(0)
 	{
 	}
@@ -723,51 +1832,87 @@ namespace KlayGE
 
 	void SkinnedModel::BuildBones(float frame)
 	{
-		for (size_t i = 0; i < joints_.size(); ++ i)
+		this->PoseJoints(frame);
+		this->UpdateBinds();
+	}
+
+	void SkinnedModel::PoseJoints(float frame)
+	{
+		auto const& tracks = *this->GetKeyFrameTracks();
+		BOOST_ASSERT(tracks.NumTracks() >= joints_.size());
+
+		uint32_t const num_tracks = tracks.NumTracks();
+		if (key_frame_cursors_.size() != num_tracks)
 		{
-			auto& joint = *joints_[i];
-			KeyFrameSet const & kf = (*key_frame_sets_)[i];
+			key_frame_cursors_.assign(num_tracks, 0);
+			key_reals_.resize(num_tracks);
+			key_duals_.resize(num_tracks);
+			key_scales_.resize(num_tracks);
+		}
+		tracks.Sample(frame, key_frame_cursors_, key_reals_, key_duals_, key_scales_);
 
-			std::tuple<Quaternion, Quaternion, float> key_dq = kf.Frame(frame);
+		if (parent_joint_indices_.size() != joints_.size())
+		{
+			std::unordered_map<JointComponent const*, int32_t> joint_indices;
+			for (size_t i = 0; i < joints_.size(); ++i)
+			{
+				joint_indices.emplace(joints_[i].get(), static_cast<int32_t>(i));
+			}
 
-			bool is_root = false;
-			auto* parent_node = joint.BoundSceneNode()->Parent();
-			if (parent_node)
+			parent_joint_indices_.assign(joints_.size(), -1);
+			for (size_t i = 0; i < joints_.size(); ++i)
 			{
-				auto* parent_joint = parent_node->FirstComponentOfType<JointComponent>();
-				if (parent_joint == nullptr)
+				auto* parent_node = joints_[i]->BoundSceneNode()->Parent();
+				if (parent_node)
 				{
-					is_root = true;
+					auto* parent_joint = parent_node->FirstComponentOfType<JointComponent>();
+					if (parent_joint != nullptr)
+					{
+						auto iter = joint_indices.find(parent_joint);
+						BOOST_ASSERT(iter != joint_indices.end());
+						if (iter != joint_indices.end())
+						{
+							parent_joint_indices_[i] = iter->second;
+						}
+					}
 				}
 			}
+		}
+
+		for (size_t i = 0; i < joints_.size(); ++ i)
+		{
+			auto& joint = *joints_[i];
+
+			Quaternion key_real = key_reals_[i];
+			Quaternion key_dual = key_duals_[i];
+			float const key_scale = key_scales_[i];
 
-			if (is_root)
+			int32_t const parent_index = parent_joint_indices_[i];
+			if (parent_index < 0)
 			{
-				joint.BindParams(std::get<0>(key_dq), std::get<1>(key_dq), std::get<2>(key_dq));
+				joint.BindParams(key_real, key_dual, key_scale);
 			}
 			else
 			{
-				auto const& parent = *parent_node->FirstComponentOfType<JointComponent>();
+				auto const& parent = *joints_[parent_index];
 
-				if (MathLib::dot(std::get<0>(key_dq), parent.BindReal()) < 0)
+				if (MathLib::dot(key_real, parent.BindReal()) < 0)
 				{
-					std::get<0>(key_dq) = -std::get<0>(key_dq);
-					std::get<1>(key_dq) = -std::get<1>(key_dq);
+					key_real = -key_real;
+					key_dual = -key_dual;
 				}
 
-				if ((MathLib::SignBit(std::get<2>(key_dq)) > 0) && (MathLib::SignBit(parent.BindScale()) > 0))
+				if ((MathLib::SignBit(key_scale) > 0) && (MathLib::SignBit(parent.BindScale()) > 0))
 				{
-					joint.BindParams(MathLib::mul_real(std::get<0>(key_dq), parent.BindReal()),
-						MathLib::mul_dual(
-							std::get<0>(key_dq), std::get<1>(key_dq) * parent.BindScale(), parent.BindReal(), parent.BindDual()),
-						std::get<2>(key_dq) * parent.BindScale());
+					joint.BindParams(MathLib::mul_real(key_real, parent.BindReal()),
+						MathLib::mul_dual(key_real, key_dual * parent.BindScale(), parent.BindReal(), parent.BindDual()),
+						key_scale * parent.BindScale());
 				}
 				else
 				{
-					float const key_scale = std::get<2>(key_dq);
 					float4x4 tmp_mat = MathLib::scaling(MathLib::abs(key_scale), MathLib::abs(key_scale), key_scale)
-						* MathLib::to_matrix(std::get<0>(key_dq))
-						* MathLib::translation(MathLib::udq_to_trans(std::get<0>(key_dq), std::get<1>(key_dq)))
+						* MathLib::to_matrix(key_real)
+						* MathLib::translation(MathLib::udq_to_trans(key_real, key_dual))
 						* MathLib::scaling(MathLib::abs(parent.BindScale()), MathLib::abs(parent.BindScale()), parent.BindScale())
 						* MathLib::to_matrix(parent.BindReal())
 						* MathLib::translation(MathLib::udq_to_trans(parent.BindReal(), parent.BindDual()));
@@ -793,11 +1938,15 @@ namespace KlayGE
 				}
 			}
 		}
-
-		this->UpdateBinds();
 	}
 
 	void SkinnedModel::UpdateBinds()
+	{
+		this->ComputeBinds();
+		this->SetToEffect();
+	}
+
+	void SkinnedModel::ComputeBinds()
 	{
 		bind_reals_.resize(joints_.size());
 		bind_duals_.resize(joints_.size());
@@ -860,8 +2009,6 @@ namespace KlayGE
 			bind_reals_[i] = float4(bind_real.x(), bind_real.y(), bind_real.z(), bind_real.w()) * bind_scale;
 			bind_duals_[i] = float4(bind_dual.x(), bind_dual.y(), bind_dual.z(), bind_dual.w());
 		}
-
-		this->SetToEffect();
 	}
 
 	float SkinnedModel::GetFrame() const
@@ -879,6 +2026,39 @@ namespace KlayGE
 		}
 	}
 
+	void SkinnedModel::SetFrames(std::span<SkinnedModel* const> models, std::span<float const> frames)
+	{
+		BOOST_ASSERT(models.size() == frames.size());
+
+		// Not vector<bool>, the tasks write to it at the same time
+		std::vector<uint8_t> changed(models.size(), 0);
+		ParallelFor(Context::Instance().ThreadPoolInstance(), static_cast<uint32_t>(models.size()), 4,
+			[models, frames, &changed](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t i = begin; i < end; ++i)
+				{
+					auto& model = *models[i];
+					if (model.last_frame_ != frames[i])
+					{
+						model.last_frame_ = frames[i];
+
+						model.PoseJoints(frames[i]);
+						model.ComputeBinds();
+						changed[i] = 1;
+					}
+				}
+			});
+
+		// Effects are shared between models, setting them isn't thread safe
+		for (size_t i = 0; i < models.size(); ++i)
+		{
+			if (changed[i])
+			{
+				models[i]->SetToEffect();
+			}
+		}
+	}
+
 	void SkinnedModel::RebindJoints()
 	{
 		this->BuildBones(last_frame_);
@@ -923,6 +2103,49 @@ namespace KlayGE
 		return pos_aabb;
 	}
 
+	void SkinnedModel::AttachKeyFrameSets(std::shared_ptr<std::vector<KeyFrameSet> const> const & kf)
+	{
+		key_frame_sets_ = kf;
+		if (kf)
+		{
+			key_frame_tracks_ = MakeSharedPtr<KeyFrameTracks>(*kf, quantize_key_frames_);
+		}
+		else
+		{
+			key_frame_tracks_.reset();
+		}
+	}
+
+	std::shared_ptr<std::vector<KeyFrameSet> const> SkinnedModel::GetKeyFrameSets() const
+	{
+		if (!key_frame_sets_ && key_frame_tracks_)
+		{
+			return MakeSharedPtr<std::vector<KeyFrameSet>>(key_frame_tracks_->ToKeyFrameSets());
+		}
+		return key_frame_sets_;
+	}
+
+	void SkinnedModel::AttachKeyFrameTracks(std::shared_ptr<KeyFrameTracks const> const& tracks)
+	{
+		key_frame_sets_.reset();
+		key_frame_tracks_ = tracks;
+		quantize_key_frames_ = tracks && tracks->Quantized();
+	}
+
+	std::shared_ptr<KeyFrameTracks const> const& SkinnedModel::GetKeyFrameTracks() const
+	{
+		return key_frame_tracks_;
+	}
+
+	void SkinnedModel::QuantizeKeyFrames(bool quantize)
+	{
+		if (quantize_key_frames_ != quantize)
+		{
+			quantize_key_frames_ = quantize;
+			this->AttachKeyFrameSets(this->GetKeyFrameSets());
+		}
+	}
+
 	void SkinnedModel::AttachAnimations(std::shared_ptr<std::vector<Animation>> const & animations)
 	{
 		animations_ = animations;
@@ -969,7 +2192,9 @@ namespace KlayGE
 				joints[i] = checked_pointer_cast<JointComponent>(src_skinned_model.GetJoint(i)->Clone());
 			}
 			skinned_model.AssignJoints(joints.begin(), joints.end());
-			skinned_model.AttachKeyFrameSets(src_skinned_model.GetKeyFrameSets());
+			skinned_model.key_frame_sets_ = src_skinned_model.key_frame_sets_;
+			skinned_model.key_frame_tracks_ = src_skinned_model.key_frame_tracks_;
+			skinned_model.quantize_key_frames_ = src_skinned_model.quantize_key_frames_;
 
 			auto& root_node = *skinned_model.RootNode();
 			for (uint32_t i = 0; i < root_node.NumComponents(); ++i)
@@ -1043,7 +2268,7 @@ namespace KlayGE
 		BOOST_ASSERT(CreateMeshFactoryFunc);
 
 		return Context::Instance().ResLoaderInstance().SyncQueryT<RenderModel>(MakeSharedPtr<RenderModelLoadingDesc>(model_name,
-			access_hint, node_attrib, OnFinishLoading, CreateModelFactoryFunc, CreateMeshFactoryFunc));
+			access_hint, node_attrib, false, OnFinishLoading, CreateModelFactoryFunc, CreateMeshFactoryFunc));
 	}
 
 	RenderModelPtr ASyncLoadModel(std::string_view model_name, uint32_t access_hint, uint32_t node_attrib,
@@ -1061,7 +2286,7 @@ namespace KlayGE
 		if (caps.multithread_res_creating_support)
 		{
 			return Context::Instance().ResLoaderInstance().ASyncQueryT<RenderModel>(MakeSharedPtr<RenderModelLoadingDesc>(model_name,
-				access_hint, node_attrib, OnFinishLoading, CreateModelFactoryFunc, CreateMeshFactoryFunc));
+				access_hint, node_attrib, true, OnFinishLoading, CreateModelFactoryFunc, CreateMeshFactoryFunc));
 		}
 		else
 		{
@@ -1069,7 +2294,7 @@ namespace KlayGE
 		}
 	}
 
-	RenderModelPtr LoadSoftwareModel(std::string_view model_name)
+	RenderModelPtr LoadSoftwareModel(std::string_view model_name, bool stream_lods)
 	{
 		char const * JIT_EXT_NAME = ".model_bin";
 
@@ -1137,8 +2362,6 @@ namespace KlayGE
 		std::vector<RenderMaterialPtr> mtls;
 		std::vector<VertexElement> merged_ves;
 		char all_is_index_16_bit;
-		std::vector<std::vector<uint8_t>> merged_buff;
-		std::vector<uint8_t> merged_indices;
 		std::vector<std::string> mesh_names;
 		std::vector<int32_t> mtl_ids;
 		std::vector<uint32_t> mesh_lods;
@@ -1152,6 +2375,7 @@ namespace KlayGE
 		std::vector<JointComponentPtr> joints;
 		std::shared_ptr<std::vector<Animation>> animations;
 		std::shared_ptr<std::vector<KeyFrameSet>> kfs;
+		std::shared_ptr<KeyFrameTracks> quantized_kf_tracks;
 		uint32_t num_frames = 0;
 		uint32_t frame_rate = 0;
 		std::vector<std::shared_ptr<AABBKeyFrameSet>> frame_pos_bbs;
@@ -1161,25 +2385,26 @@ namespace KlayGE
 		uint32_t fourcc;
 		runtime_file->read(&fourcc, sizeof(fourcc));
 		fourcc = LE2Native(fourcc);
-		BOOST_ASSERT((fourcc == MakeFourCC<'K', 'L', 'M', ' '>::value));
+		Verify(fourcc == MakeFourCC<'K', 'L', 'M', ' '>::value);
 
 		uint32_t ver;
 		runtime_file->read(&ver, sizeof(ver));
 		ver = LE2Native(ver);
-		BOOST_ASSERT(MODEL_BIN_VERSION == ver);
+		Verify(ver == MODEL_BIN_VERSION);
 
-		std::shared_ptr<std::stringstream> ss = MakeSharedPtr<std::stringstream>();
+		std::vector<ModelBinChunk> chunks = ReadModelBinToc(*runtime_file);
 
-		uint64_t original_len, len;
-		runtime_file->read(&original_len, sizeof(original_len));
-		original_len = LE2Native(original_len);
-		runtime_file->read(&len, sizeof(len));
-		len = LE2Native(len);
-
-		LZMACodec lzma;
-		lzma.Decode(*ss, runtime_file, len, original_len);
+		// Descriptions and animations are decoded together, the geometry once it's known which lods are needed
+		std::vector<ModelBinChunk const *> desc_chunks(1, FindRequiredModelBinChunk(chunks, MODEL_CHUNK_META, 0, 0));
+		if (auto const * anim_chunk = FindModelBinChunk(chunks, MODEL_CHUNK_ANIMATION, 0, 0))
+		{
+			desc_chunks.push_back(anim_chunk);
+		}
+		std::vector<std::vector<uint8_t>> desc_storage;
+		auto const desc_data = DecodeModelBinChunks(*runtime_file, desc_chunks, desc_storage);
 
-		ResIdentifierPtr decoded = MakeSharedPtr<ResIdentifier>(runtime_file->ResName(), runtime_file->Timestamp(), ss);
+		ResIdentifierPtr decoded = MakeSharedPtr<ResIdentifier>(
+			runtime_file->ResName(), runtime_file->Timestamp(), desc_data[0], std::shared_ptr<void>());
 
 		uint32_t num_mtls;
 		decoded->read(&num_mtls, sizeof(num_mtls));
@@ -1314,24 +2539,8 @@ namespace KlayGE
 			merged_ves[i].format = LE2Native(merged_ves[i].format);
 		}
 
-		uint32_t all_num_vertices;
-		uint32_t all_num_indices;
-		decoded->read(&all_num_vertices, sizeof(all_num_vertices));
-		all_num_vertices = LE2Native(all_num_vertices);
-		decoded->read(&all_num_indices, sizeof(all_num_indices));
-		all_num_indices = LE2Native(all_num_indices);
 		decoded->read(&all_is_index_16_bit, sizeof(all_is_index_16_bit));
-
-		int const index_elem_size = all_is_index_16_bit ? 2 : 4;
-
-		merged_buff.resize(merged_ves.size());
-		for (size_t i = 0; i < merged_buff.size(); ++ i)
-		{
-			merged_buff[i].resize(all_num_vertices * merged_ves[i].element_size());
-			decoded->read(&merged_buff[i][0], merged_buff[i].size() * sizeof(merged_buff[i][0]));
-		}
-		merged_indices.resize(all_num_indices * index_elem_size);
-		decoded->read(&merged_indices[0], merged_indices.size() * sizeof(merged_indices[0]));
+		ElementFormat const index_format = all_is_index_16_bit ? EF_R16UI : EF_R32UI;
 
 		mesh_names.resize(num_meshes);
 		mtl_ids.resize(num_meshes);
@@ -1496,51 +2705,69 @@ namespace KlayGE
 
 		if (num_kfs > 0)
 		{
-			decoded->read(&num_frames, sizeof(num_frames));
+			BOOST_ASSERT(desc_data.size() > 1);
+			ResIdentifierPtr anim = MakeSharedPtr<ResIdentifier>(
+				runtime_file->ResName(), runtime_file->Timestamp(), desc_data[1], std::shared_ptr<void>());
+
+			anim->read(&num_frames, sizeof(num_frames));
 			num_frames = LE2Native(num_frames);
-			decoded->read(&frame_rate, sizeof(frame_rate));
+			anim->read(&frame_rate, sizeof(frame_rate));
 			frame_rate = LE2Native(frame_rate);
 
-			kfs = MakeSharedPtr<std::vector<KeyFrameSet>>(joints.size());
-			for (uint32_t kf_index = 0; kf_index < num_kfs; ++ kf_index)
-			{
-				uint32_t joint_index = kf_index;
-
-				uint32_t num_kf;
-				decoded->read(&num_kf, sizeof(num_kf));
-				num_kf = LE2Native(num_kf);
+			uint32_t quantized;
+			anim->read(&quantized, sizeof(quantized));
+			quantized = LE2Native(quantized);
 
-				KeyFrameSet kf;
-				kf.frame_id.resize(num_kf);
-				kf.bind_real.resize(num_kf);
-				kf.bind_dual.resize(num_kf);
-				kf.bind_scale.resize(num_kf);
-				for (uint32_t k_index = 0; k_index < num_kf; ++ k_index)
+			if (quantized)
+			{
+				quantized_kf_tracks = MakeSharedPtr<KeyFrameTracks>();
+				quantized_kf_tracks->StreamIn(*anim);
+				// Tracks are sampled into the joints by index
+				Verify(quantized_kf_tracks->NumTracks() == num_joints);
+			}
+			else
+			{
+				kfs = MakeSharedPtr<std::vector<KeyFrameSet>>(joints.size());
+				for (uint32_t kf_index = 0; kf_index < num_kfs; ++ kf_index)
 				{
-					decoded->read(&kf.frame_id[k_index], sizeof(kf.frame_id[k_index]));
-					kf.frame_id[k_index] = LE2Native(kf.frame_id[k_index]);
-					decoded->read(&kf.bind_real[k_index], sizeof(kf.bind_real[k_index]));
-					kf.bind_real[k_index][0] = LE2Native(kf.bind_real[k_index][0]);
-					kf.bind_real[k_index][1] = LE2Native(kf.bind_real[k_index][1]);
-					kf.bind_real[k_index][2] = LE2Native(kf.bind_real[k_index][2]);
-					kf.bind_real[k_index][3] = LE2Native(kf.bind_real[k_index][3]);
-					decoded->read(&kf.bind_dual[k_index], sizeof(kf.bind_dual[k_index]));
-					kf.bind_dual[k_index][0] = LE2Native(kf.bind_dual[k_index][0]);
-					kf.bind_dual[k_index][1] = LE2Native(kf.bind_dual[k_index][1]);
-					kf.bind_dual[k_index][2] = LE2Native(kf.bind_dual[k_index][2]);
-					kf.bind_dual[k_index][3] = LE2Native(kf.bind_dual[k_index][3]);
-
-					float flip = MathLib::SignBit(kf.bind_real[k_index].w());
-
-					kf.bind_scale[k_index] = MathLib::length(kf.bind_real[k_index]);
-					kf.bind_real[k_index] /= kf.bind_scale[k_index];
-
-					kf.bind_scale[k_index] *= flip;
-				}
+					uint32_t joint_index = kf_index;
+
+					uint32_t num_kf;
+					anim->read(&num_kf, sizeof(num_kf));
+					num_kf = LE2Native(num_kf);
+
+					KeyFrameSet kf;
+					kf.frame_id.resize(num_kf);
+					kf.bind_real.resize(num_kf);
+					kf.bind_dual.resize(num_kf);
+					kf.bind_scale.resize(num_kf);
+					for (uint32_t k_index = 0; k_index < num_kf; ++ k_index)
+					{
+						anim->read(&kf.frame_id[k_index], sizeof(kf.frame_id[k_index]));
+						kf.frame_id[k_index] = LE2Native(kf.frame_id[k_index]);
+						anim->read(&kf.bind_real[k_index], sizeof(kf.bind_real[k_index]));
+						kf.bind_real[k_index][0] = LE2Native(kf.bind_real[k_index][0]);
+						kf.bind_real[k_index][1] = LE2Native(kf.bind_real[k_index][1]);
+						kf.bind_real[k_index][2] = LE2Native(kf.bind_real[k_index][2]);
+						kf.bind_real[k_index][3] = LE2Native(kf.bind_real[k_index][3]);
+						anim->read(&kf.bind_dual[k_index], sizeof(kf.bind_dual[k_index]));
+						kf.bind_dual[k_index][0] = LE2Native(kf.bind_dual[k_index][0]);
+						kf.bind_dual[k_index][1] = LE2Native(kf.bind_dual[k_index][1]);
+						kf.bind_dual[k_index][2] = LE2Native(kf.bind_dual[k_index][2]);
+						kf.bind_dual[k_index][3] = LE2Native(kf.bind_dual[k_index][3]);
+
+						float flip = MathLib::SignBit(kf.bind_real[k_index].w());
+
+						kf.bind_scale[k_index] = MathLib::length(kf.bind_real[k_index]);
+						kf.bind_real[k_index] /= kf.bind_scale[k_index];
+
+						kf.bind_scale[k_index] *= flip;
+					}
 
-				if (joint_index < num_joints)
-				{
-					(*kfs)[joint_index] = kf;
+					if (joint_index < num_joints)
+					{
+						(*kfs)[joint_index] = kf;
+					}
 				}
 			}
 
@@ -1548,7 +2775,7 @@ namespace KlayGE
 			for (uint32_t mesh_index = 0; mesh_index < num_meshes; ++ mesh_index)
 			{
 				uint32_t num_bb_kf;
-				decoded->read(&num_bb_kf, sizeof(num_bb_kf));
+				anim->read(&num_bb_kf, sizeof(num_bb_kf));
 				num_bb_kf = LE2Native(num_bb_kf);
 
 				frame_pos_bbs[mesh_index] = MakeSharedPtr<AABBKeyFrameSet>();
@@ -1557,15 +2784,15 @@ namespace KlayGE
 
 				for (uint32_t bb_k_index = 0; bb_k_index < num_bb_kf; ++ bb_k_index)
 				{
-					decoded->read(&frame_pos_bbs[mesh_index]->frame_id[bb_k_index], sizeof(frame_pos_bbs[mesh_index]->frame_id[bb_k_index]));
+					anim->read(&frame_pos_bbs[mesh_index]->frame_id[bb_k_index], sizeof(frame_pos_bbs[mesh_index]->frame_id[bb_k_index]));
 					frame_pos_bbs[mesh_index]->frame_id[bb_k_index] = LE2Native(frame_pos_bbs[mesh_index]->frame_id[bb_k_index]);
 
 					float3 bb_min, bb_max;
-					decoded->read(&bb_min, sizeof(bb_min));
+					anim->read(&bb_min, sizeof(bb_min));
 					bb_min[0] = LE2Native(bb_min[0]);
 					bb_min[1] = LE2Native(bb_min[1]);
 					bb_min[2] = LE2Native(bb_min[2]);
-					decoded->read(&bb_max, sizeof(bb_max));
+					anim->read(&bb_max, sizeof(bb_max));
 					bb_max[0] = LE2Native(bb_max[0]);
 					bb_max[1] = LE2Native(bb_max[1]);
 					bb_max[2] = LE2Native(bb_max[2]);
@@ -1579,17 +2806,17 @@ namespace KlayGE
 				for (uint32_t animation_index = 0; animation_index < num_animations; ++animation_index)
 				{
 					Animation animation;
-					animation.name = ReadShortString(*decoded);
-					decoded->read(&animation.start_frame, sizeof(animation.start_frame));
+					animation.name = ReadShortString(*anim);
+					anim->read(&animation.start_frame, sizeof(animation.start_frame));
 					animation.start_frame = LE2Native(animation.start_frame);
-					decoded->read(&animation.end_frame, sizeof(animation.end_frame));
+					anim->read(&animation.end_frame, sizeof(animation.end_frame));
 					animation.end_frame = LE2Native(animation.end_frame);
 					(*animations)[animation_index] = animation;
 				}
 			}
 		}
 
-		bool const skinned = kfs && !kfs->empty();
+		bool const skinned = (num_kfs > 0) && !joints.empty();
 
 		RenderModelPtr model;
 		if (skinned)
@@ -1607,16 +2834,68 @@ namespace KlayGE
 			model->GetMaterial(mtl_index) = mtls[mtl_index];
 		}
 
-		std::vector<GraphicsBufferPtr> merged_vbs(merged_buff.size());
-		for (size_t i = 0; i < merged_buff.size(); ++ i)
+		// Streaming starts with the finest lod every mesh has. Finer ones are loaded when a mesh is drawn with them.
+		uint32_t num_lods = 0;
+		uint32_t first_lod = stream_lods ? std::numeric_limits<uint32_t>::max() : 0;
+		for (uint32_t const lods : mesh_lods)
+		{
+			num_lods = std::max(num_lods, lods);
+			first_lod = std::min(first_lod, lods - 1);
+		}
+		first_lod = std::min(first_lod, num_lods);
+
+		std::vector<ModelLodRange> lod_ranges(num_lods);
+		for (uint32_t mesh_index = 0, mesh_lod_index = 0; mesh_index < num_meshes; ++ mesh_index)
+		{
+			for (uint32_t lod = 0; lod < mesh_lods[mesh_index]; ++ lod, ++ mesh_lod_index)
+			{
+				auto& range = lod_ranges[lod];
+				range.num_vertices = std::max(range.num_vertices,
+					static_cast<uint64_t>(mesh_base_vertices[mesh_lod_index]) + mesh_num_vertices[mesh_lod_index]);
+				range.num_indices = std::max(range.num_indices,
+					static_cast<uint64_t>(mesh_start_indices[mesh_lod_index]) + mesh_num_indices[mesh_lod_index]);
+			}
+		}
+
+		uint32_t const num_chunks_per_lod = static_cast<uint32_t>(merged_ves.size() + 1);
+		std::vector<ModelBinChunk const *> geometry_chunks;
+		for (uint32_t lod = first_lod; lod < num_lods; ++ lod)
+		{
+			for (uint32_t i = 0; i < merged_ves.size(); ++ i)
+			{
+				geometry_chunks.push_back(FindRequiredModelBinChunk(chunks, MODEL_CHUNK_VERTICES, lod, i));
+			}
+			geometry_chunks.push_back(FindRequiredModelBinChunk(chunks, MODEL_CHUNK_INDICES, lod, 0));
+		}
+		std::vector<std::vector<uint8_t>> geometry_storage;
+		auto const geometry_data = DecodeModelBinChunks(*runtime_file, geometry_chunks, geometry_storage);
+
+		std::vector<ModelLodBuffers> lod_buffers(num_lods);
+		for (uint32_t lod = first_lod; lod < num_lods; ++ lod)
 		{
-			auto vb = MakeSharedPtr<SoftwareGraphicsBuffer>(static_cast<uint32_t>(merged_buff[i].size()), false);
-			vb->CreateHWResource(merged_buff[i].data());
+			auto const lod_data = std::span(geometry_data).subspan((lod - first_lod) * num_chunks_per_lod, num_chunks_per_lod);
+			VerifyModelLodData(lod_data, merged_ves, index_format, lod_ranges[lod]);
+			auto& buffers = lod_buffers[lod];
+
+			buffers.vbs.resize(merged_ves.size());
+			for (size_t i = 0; i < merged_ves.size(); ++ i)
+			{
+				auto vb = MakeSharedPtr<SoftwareGraphicsBuffer>(static_cast<uint32_t>(lod_data[i].size()), false);
+				vb->CreateHWResource(lod_data[i].data());
+
+				buffers.vbs[i] = vb;
+			}
+			auto ib = MakeSharedPtr<SoftwareGraphicsBuffer>(static_cast<uint32_t>(lod_data[merged_ves.size()].size()), false);
+			ib->CreateHWResource(lod_data[merged_ves.size()].data());
+			buffers.ib = ib;
+		}
 
-			merged_vbs[i] = vb;
+		ModelLodStreamerPtr lod_streamer;
+		if (first_lod > 0)
+		{
+			lod_streamer =
+				MakeSharedPtr<ModelLodStreamer>(runtime_name, std::move(chunks), merged_ves, index_format, std::move(lod_ranges));
 		}
-		auto merged_ib = MakeSharedPtr<SoftwareGraphicsBuffer>(static_cast<uint32_t>(merged_indices.size()), false);
-		merged_ib->CreateHWResource(merged_indices.data());
 
 		uint32_t mesh_lod_index = 0;
 		std::vector<StaticMeshPtr> meshes(num_meshes);
@@ -1643,27 +2922,38 @@ namespace KlayGE
 			mesh->NumLods(lods);
 			for (uint32_t lod = 0; lod < lods; ++ lod, ++ mesh_lod_index)
 			{
-				for (uint32_t ve_index = 0; ve_index < merged_buff.size(); ++ ve_index)
+				if (lod >= first_lod)
 				{
-					mesh->AddVertexStream(lod, merged_vbs[ve_index], merged_ves[ve_index]);
+					for (uint32_t ve_index = 0; ve_index < merged_ves.size(); ++ ve_index)
+					{
+						mesh->AddVertexStream(lod, lod_buffers[lod].vbs[ve_index], merged_ves[ve_index]);
+					}
+					mesh->AddIndexStream(lod, lod_buffers[lod].ib, index_format);
 				}
-				mesh->AddIndexStream(lod, merged_ib, all_is_index_16_bit ? EF_R16UI : EF_R32UI);
 
 				mesh->NumVertices(lod, mesh_num_vertices[mesh_lod_index]);
 				mesh->NumIndices(lod, mesh_num_indices[mesh_lod_index]);
 				mesh->StartVertexLocation(lod, mesh_base_vertices[mesh_lod_index]);
 				mesh->StartIndexLocation(lod, mesh_start_indices[mesh_lod_index]);
 			}
+			mesh->LodStreamer(lod_streamer, first_lod);
 		}
 
-		if (kfs && !kfs->empty())
+		if (num_kfs > 0)
 		{
 			if (!joints.empty())
 			{
 				SkinnedModelPtr skinned_model = checked_pointer_cast<SkinnedModel>(model);
 
 				skinned_model->AssignJoints(joints.begin(), joints.end());
-				skinned_model->AttachKeyFrameSets(kfs);
+				if (quantized_kf_tracks)
+				{
+					skinned_model->AttachKeyFrameTracks(quantized_kf_tracks);
+				}
+				else
+				{
+					skinned_model->AttachKeyFrameSets(kfs);
+				}
 
 				skinned_model->NumFrames(num_frames);
 				skinned_model->FrameRate(frame_rate);
@@ -1701,6 +2991,14 @@ namespace KlayGE
 
 namespace
 {
+	struct ModelLodGeometry
+	{
+		uint32_t num_vertices = 0;
+		uint32_t num_indices = 0;
+		std::vector<std::vector<uint8_t>> vertex_streams;
+		std::vector<uint8_t> indices;
+	};
+
 	void WriteMaterialsChunk(std::vector<RenderMaterialPtr> const & mtls, std::ostream& os)
 	{
 		for (size_t i = 0; i < mtls.size(); ++ i)
@@ -1782,9 +3080,7 @@ namespace
 		std::vector<AABBox> const & pos_bbs, std::vector<AABBox> const & tc_bbs,
 		std::vector<uint32_t> const & mesh_num_vertices, std::vector<uint32_t> const & mesh_base_vertices,
 		std::vector<uint32_t> const & mesh_num_indices, std::vector<uint32_t> const & mesh_start_indices,
-		std::vector<VertexElement> const & merged_ves,
-		std::vector<std::vector<uint8_t>> const & merged_vertices, std::vector<uint8_t> const & merged_indices,
-		char is_index_16_bit, std::ostream& os)
+		std::vector<VertexElement> const & merged_ves, char is_index_16_bit, std::ostream& os)
 	{
 		uint32_t num_merged_ves = Native2LE(static_cast<uint32_t>(merged_ves.size()));
 		os.write(reinterpret_cast<char*>(&num_merged_ves), sizeof(num_merged_ves));
@@ -1796,18 +3092,8 @@ namespace
 			os.write(reinterpret_cast<char*>(&ve), sizeof(ve));
 		}
 
-		uint32_t num_vertices = Native2LE(mesh_base_vertices.back());
-		os.write(reinterpret_cast<char*>(&num_vertices), sizeof(num_vertices));
-		uint32_t num_indices = Native2LE(mesh_start_indices.back());
-		os.write(reinterpret_cast<char*>(&num_indices), sizeof(num_indices));
 		os.write(&is_index_16_bit, sizeof(is_index_16_bit));
 
-		for (size_t i = 0; i < merged_vertices.size(); ++ i)
-		{
-			os.write(reinterpret_cast<char const *>(&merged_vertices[i][0]), merged_vertices[i].size() * sizeof(merged_vertices[i][0]));
-		}
-		os.write(reinterpret_cast<char const *>(&merged_indices[0]), merged_indices.size() * sizeof(merged_indices[0]));
-
 		uint32_t mesh_lod_index = 0;
 		for (uint32_t mesh_index = 0; mesh_index < mesh_names.size(); ++ mesh_index)
 		{
@@ -1981,13 +3267,15 @@ namespace
 		}
 	}
 
-	void WriteKeyFramesChunk(uint32_t num_frames, uint32_t frame_rate, std::vector<KeyFrameSet>& kfs,
+	void WriteKeyFramesChunk(uint32_t num_frames, uint32_t frame_rate, std::vector<KeyFrameSet> const & kfs,
 		std::ostream& os)
 	{
 		num_frames = Native2LE(num_frames);
 		os.write(reinterpret_cast<char*>(&num_frames), sizeof(num_frames));
 		frame_rate = Native2LE(frame_rate);
 		os.write(reinterpret_cast<char*>(&frame_rate), sizeof(frame_rate));
+		uint32_t quantized = Native2LE(0U);
+		os.write(reinterpret_cast<char*>(&quantized), sizeof(quantized));
 
 		for (size_t i = 0; i < kfs.size(); ++ i)
 		{
@@ -2017,6 +3305,18 @@ namespace
 		}
 	}
 
+	void WriteQuantizedKeyFramesChunk(uint32_t num_frames, uint32_t frame_rate, KeyFrameTracks const & kf_tracks, std::ostream& os)
+	{
+		num_frames = Native2LE(num_frames);
+		os.write(reinterpret_cast<char*>(&num_frames), sizeof(num_frames));
+		frame_rate = Native2LE(frame_rate);
+		os.write(reinterpret_cast<char*>(&frame_rate), sizeof(frame_rate));
+		uint32_t quantized = Native2LE(1U);
+		os.write(reinterpret_cast<char*>(&quantized), sizeof(quantized));
+
+		kf_tracks.StreamOut(os);
+	}
+
 	void WriteBBKeyFramesChunk(std::vector<std::shared_ptr<AABBKeyFrameSet>> const & frame_pos_bbs, std::ostream& os)
 	{
 		for (size_t i = 0; i < frame_pos_bbs.size(); ++ i)
@@ -2059,17 +3359,19 @@ namespace
 	}
 
 	void SaveModel(std::string const & jit_name, std::vector<RenderMaterialPtr> const & mtls,
-		std::vector<VertexElement> const & merged_ves, char all_is_index_16_bit,
-		std::vector<std::vector<uint8_t>> const & merged_buffs, std::vector<uint8_t> const & merged_indices,
+		std::vector<VertexElement> const & merged_ves, char all_is_index_16_bit, std::vector<ModelLodGeometry> const & lod_geometries,
 		std::vector<std::string> const & mesh_names, std::vector<int32_t> const & mtl_ids, std::vector<uint32_t> const & mesh_lods,
 		std::vector<AABBox> const & pos_bbs, std::vector<AABBox> const & tc_bbs,
 		std::vector<uint32_t> const & mesh_num_vertices, std::vector<uint32_t> const & mesh_base_vertices,
 		std::vector<uint32_t> const & mesh_num_indices, std::vector<uint32_t> const & mesh_base_indices,
 		std::vector<SceneNode const *> const & nodes, std::vector<Renderable const *> const & renderables,
 		std::vector<JointComponent const*> const & joints, std::shared_ptr<std::vector<Animation>> const & animations,
-		std::shared_ptr<std::vector<KeyFrameSet>> const & kfs, uint32_t num_frames, uint32_t frame_rate,
-		std::vector<std::shared_ptr<AABBKeyFrameSet>> const & frame_pos_bbs)
+		std::shared_ptr<std::vector<KeyFrameSet> const> const & kfs, std::shared_ptr<KeyFrameTracks const> const & quantized_kf_tracks,
+		uint32_t num_frames, uint32_t frame_rate, std::vector<std::shared_ptr<AABBKeyFrameSet>> const & frame_pos_bbs)
 	{
+		// Quantized key frames are saved as they are, instead of quantizing the key frame sets decoded from them again
+		uint32_t const num_kfs = quantized_kf_tracks ? quantized_kf_tracks->NumTracks() : (kfs ? static_cast<uint32_t>(kfs->size()) : 0);
+
 		std::ostringstream ss;
 
 		{
@@ -2085,8 +3387,8 @@ namespace
 			uint32_t num_joints = Native2LE(static_cast<uint32_t>(joints.size()));
 			ss.write(reinterpret_cast<char*>(&num_joints), sizeof(num_joints));
 
-			uint32_t num_kfs = Native2LE(kfs ? static_cast<uint32_t>(kfs->size()) : 0);
-			ss.write(reinterpret_cast<char*>(&num_kfs), sizeof(num_kfs));
+			uint32_t num_kfs_le = Native2LE(num_kfs);
+			ss.write(reinterpret_cast<char*>(&num_kfs_le), sizeof(num_kfs_le));
 
 			uint32_t num_animations = Native2LE(animations ? std::max(static_cast<uint32_t>(animations->size()), 1U) : 0);
 			ss.write(reinterpret_cast<char*>(&num_animations), sizeof(num_animations));
@@ -2101,7 +3403,7 @@ namespace
 		{
 			WriteMeshesChunk(mesh_names, mtl_ids, mesh_lods, pos_bbs, tc_bbs,
 				mesh_num_vertices, mesh_base_vertices, mesh_num_indices, mesh_base_indices,
-				merged_ves, merged_buffs, merged_indices, all_is_index_16_bit, ss);
+				merged_ves, all_is_index_16_bit, ss);
 		}
 
 		if (!nodes.empty())
@@ -2114,13 +3416,82 @@ namespace
 			WriteBonesChunk(joints, ss);
 		}
 
-		if (kfs && !kfs->empty())
+		std::ostringstream anim_ss;
+		if (num_kfs > 0)
+		{
+			if (quantized_kf_tracks)
+			{
+				WriteQuantizedKeyFramesChunk(num_frames, frame_rate, *quantized_kf_tracks, anim_ss);
+			}
+			else
+			{
+				WriteKeyFramesChunk(num_frames, frame_rate, *kfs, anim_ss);
+			}
+
+			WriteBBKeyFramesChunk(frame_pos_bbs, anim_ss);
+
+			WriteAnimationsChunk(*animations, anim_ss);
+		}
+
+		auto const & ss_str = ss.str();
+		auto const & anim_ss_str = anim_ss.str();
+
+		std::vector<ModelBinChunk> chunks;
+		std::vector<std::span<uint8_t const>> chunk_data;
+		auto add_chunk = [&chunks, &chunk_data](uint32_t type, uint32_t lod, uint32_t stream, std::span<uint8_t const> data)
+		{
+			chunks.push_back({type, lod, stream, ModelChunkCodec::Stored, 0, 0, data.size()});
+			chunk_data.push_back(data);
+		};
+
+		add_chunk(MODEL_CHUNK_META, 0, 0, MakeSpan(reinterpret_cast<uint8_t const *>(ss_str.c_str()), ss_str.size()));
+		for (uint32_t lod = 0; lod < lod_geometries.size(); ++ lod)
+		{
+			auto const & geometry = lod_geometries[lod];
+			for (uint32_t i = 0; i < geometry.vertex_streams.size(); ++ i)
+			{
+				add_chunk(MODEL_CHUNK_VERTICES, lod, i, geometry.vertex_streams[i]);
+			}
+			add_chunk(MODEL_CHUNK_INDICES, lod, 0, geometry.indices);
+		}
+		if (!anim_ss_str.empty())
 		{
-			WriteKeyFramesChunk(num_frames, frame_rate, *kfs, ss);
+			add_chunk(MODEL_CHUNK_ANIMATION, 0, 0, MakeSpan(reinterpret_cast<uint8_t const *>(anim_ss_str.c_str()), anim_ss_str.size()));
+		}
 
-			WriteBBKeyFramesChunk(frame_pos_bbs, ss);
+		// Chunks that LZMA barely shrinks are stored as they are. They cost a bit of space but load without a decoding pass.
+		// Chunks larger than a frame are split into frames, so that a single big vertex stream still decodes on several threads.
+		std::vector<std::vector<uint8_t>> encoded(chunks.size());
+		uint64_t offset = sizeof(uint32_t) * 3
+			+ chunks.size() * (sizeof(uint32_t) * 4 + sizeof(uint64_t) * 3);
+		LZMACodec lzma;
+		for (size_t i = 0; i < chunks.size(); ++ i)
+		{
+			auto& chunk = chunks[i];
+			bool const framed = chunk.original_len > LZMACodec::DEFAULT_FRAME_SIZE;
+			if (framed)
+			{
+				lzma.EncodeFramed(encoded[i], chunk_data[i]);
+			}
+			else if (chunk.original_len > 0)
+			{
+				lzma.Encode(encoded[i], chunk_data[i]);
+			}
+			if ((chunk.original_len > 0) && (encoded[i].size() < chunk.original_len - chunk.original_len / 8))
+			{
+				chunk.codec = framed ? ModelChunkCodec::LZMAFramed : ModelChunkCodec::LZMA;
+				chunk.len = encoded[i].size();
+			}
+			else
+			{
+				chunk.codec = ModelChunkCodec::Stored;
+				chunk.len = chunk.original_len;
+				encoded[i].clear();
+			}
 
-			WriteAnimationsChunk(*animations, ss);
+			offset = (offset + MODEL_CHUNK_ALIGNMENT - 1) & ~static_cast<uint64_t>(MODEL_CHUNK_ALIGNMENT - 1);
+			chunk.offset = offset;
+			offset += chunk.len;
 		}
 
 		std::ofstream ofs(jit_name.c_str(), std::ios_base::binary);
@@ -2131,20 +3502,34 @@ namespace
 		uint32_t ver = Native2LE(MODEL_BIN_VERSION);
 		ofs.write(reinterpret_cast<char*>(&ver), sizeof(ver));
 
-		auto const & ss_str = ss.str();
-		uint64_t original_len = Native2LE(static_cast<uint64_t>(ss_str.size()));
-		ofs.write(reinterpret_cast<char*>(&original_len), sizeof(original_len));
-
-		std::ofstream::pos_type p = ofs.tellp();
-		uint64_t len = 0;
-		ofs.write(reinterpret_cast<char*>(&len), sizeof(len));
+		uint32_t num_chunks = Native2LE(static_cast<uint32_t>(chunks.size()));
+		ofs.write(reinterpret_cast<char*>(&num_chunks), sizeof(num_chunks));
+		for (auto const & chunk : chunks)
+		{
+			uint32_t type = Native2LE(chunk.type);
+			ofs.write(reinterpret_cast<char*>(&type), sizeof(type));
+			uint32_t lod = Native2LE(chunk.lod);
+			ofs.write(reinterpret_cast<char*>(&lod), sizeof(lod));
+			uint32_t stream = Native2LE(chunk.stream);
+			ofs.write(reinterpret_cast<char*>(&stream), sizeof(stream));
+			uint32_t codec = Native2LE(static_cast<uint32_t>(chunk.codec));
+			ofs.write(reinterpret_cast<char*>(&codec), sizeof(codec));
+			uint64_t chunk_offset = Native2LE(chunk.offset);
+			ofs.write(reinterpret_cast<char*>(&chunk_offset), sizeof(chunk_offset));
+			uint64_t len = Native2LE(chunk.len);
+			ofs.write(reinterpret_cast<char*>(&len), sizeof(len));
+			uint64_t original_len = Native2LE(chunk.original_len);
+			ofs.write(reinterpret_cast<char*>(&original_len), sizeof(original_len));
+		}
 
-		LZMACodec lzma;
-		len = lzma.Encode(ofs, MakeSpan(reinterpret_cast<uint8_t const *>(ss_str.c_str()), ss_str.size()));
+		for (size_t i = 0; i < chunks.size(); ++ i)
+		{
+			char const padding[MODEL_CHUNK_ALIGNMENT] = {};
+			ofs.write(padding, chunks[i].offset - static_cast<uint64_t>(ofs.tellp()));
 
-		ofs.seekp(p, std::ios_base::beg);
-		len = Native2LE(len);
-		ofs.write(reinterpret_cast<char*>(&len), sizeof(len));
+			auto const data = encoded[i].empty() ? chunk_data[i] : std::span<uint8_t const>(encoded[i]);
+			ofs.write(reinterpret_cast<char const *>(data.data()), data.size());
+		}
 	}
 } // namespace
 
@@ -2171,9 +3556,8 @@ namespace KlayGE
 		}
 
 		std::vector<VertexElement> merged_ves;
-		std::vector<std::vector<uint8_t>> merged_buffs;
-		char all_is_index_16_bit = false;
-		std::vector<uint8_t> merged_indices;
+		char all_is_index_16_bit = true;
+		std::vector<ModelLodGeometry> lod_geometries;
 		std::vector<std::string> mesh_names(model.NumMeshes());
 		std::vector<int32_t> mtl_ids(mesh_names.size());
 		std::vector<uint32_t> mesh_lods(mesh_names.size());
@@ -2185,71 +3569,98 @@ namespace KlayGE
 		std::vector<uint32_t> mesh_base_indices;
 		if (!mesh_names.empty())
 		{
+			struct MeshLodStreams
 			{
-				auto const& mesh = checked_cast<StaticMesh&>(*model.Mesh(0));
-
-				RenderLayout const & rl = mesh.GetRenderLayout();
-				merged_ves.resize(rl.NumVertexStreams());
-				for (uint32_t j = 0; j < rl.NumVertexStreams(); ++ j)
-				{
-					merged_ves[j] = rl.VertexStreamFormat(j)[0];
-				}
+				std::vector<GraphicsBufferPtr> vbs;
+				GraphicsBufferPtr ib;
+				ElementFormat index_format;
+			};
 
-				merged_buffs.resize(merged_ves.size());
-				for (uint32_t j = 0; j < rl.NumVertexStreams(); ++ j)
+			// Lods that haven't been streamed in yet are loaded here
+			std::vector<MeshLodStreams> mesh_lod_streams;
+			for (uint32_t mesh_index = 0; mesh_index < mesh_names.size(); ++ mesh_index)
+			{
+				auto const& mesh = checked_cast<StaticMesh&>(*model.Mesh(mesh_index));
+				for (uint32_t lod = 0; lod < mesh.NumLods(); ++ lod)
 				{
-					GraphicsBufferPtr const & vb = rl.GetVertexStream(j);
-					uint32_t size = vb->Size();
-					GraphicsBufferPtr vb_cpu;
-					if (vb->AccessHint() & EAH_CPU_Read)
+					MeshLodStreams streams;
+					if (lod < mesh.ResidentLod())
 					{
-						vb_cpu = vb;
+						auto const buffers = mesh.LodStreamer()->SyncLoad(lod);
+						streams.vbs = buffers->vbs;
+						streams.ib = buffers->ib;
+						streams.index_format = mesh.LodStreamer()->IndexFormat();
 					}
 					else
 					{
-						auto& rf = Context::Instance().RenderFactoryInstance();
-						vb_cpu = rf.MakeVertexBuffer(BU_Static, EAH_CPU_Read, size, nullptr);
-						vb->CopyToBuffer(*vb_cpu);
+						RenderLayout const & rl = mesh.GetRenderLayout(lod);
+						for (uint32_t j = 0; j < rl.NumVertexStreams(); ++ j)
+						{
+							streams.vbs.push_back(rl.GetVertexStream(j));
+						}
+						streams.ib = rl.GetIndexStream();
+						streams.index_format = rl.IndexStreamFormat();
 					}
 
-					merged_buffs[j].resize(size);
+					if (EF_R16UI != streams.index_format)
+					{
+						BOOST_ASSERT(EF_R32UI == streams.index_format);
+						all_is_index_16_bit = false;
+					}
 
-					GraphicsBuffer::Mapper mapper(*vb_cpu, BA_Read_Only);
-					std::memcpy(&merged_buffs[j][0], mapper.Pointer<uint8_t>(), size);
+					mesh_lod_streams.push_back(std::move(streams));
 				}
+			}
 
-				if (EF_R16UI == rl.IndexStreamFormat())
-				{
-					all_is_index_16_bit = true;
-				}
-				else
+			{
+				auto const& mesh = checked_cast<StaticMesh&>(*model.Mesh(0));
+
+				RenderLayout const & rl = mesh.GetRenderLayout(mesh.ResidentLod());
+				merged_ves.resize(rl.NumVertexStreams());
+				for (uint32_t j = 0; j < rl.NumVertexStreams(); ++ j)
 				{
-					BOOST_ASSERT(EF_R32UI == rl.IndexStreamFormat());
-					all_is_index_16_bit = false;
+					merged_ves[j] = rl.VertexStreamFormat(j)[0];
 				}
+			}
 
+			// Buffers shared by several meshes or lods are read back once
+			std::map<GraphicsBuffer const *, std::vector<uint8_t>> buffer_data;
+			auto read_back = [&buffer_data](GraphicsBufferPtr const & buffer, bool is_index) -> std::vector<uint8_t> const &
+			{
+				auto iter = buffer_data.find(buffer.get());
+				if (iter == buffer_data.end())
 				{
-					GraphicsBufferPtr const & ib = rl.GetIndexStream();
-					uint32_t size = ib->Size();
-					GraphicsBufferPtr ib_cpu;
-					if (ib->AccessHint() & EAH_CPU_Read)
+					uint32_t const size = buffer->Size();
+					GraphicsBufferPtr buffer_cpu;
+					if (buffer->AccessHint() & EAH_CPU_Read)
 					{
-						ib_cpu = ib;
+						buffer_cpu = buffer;
 					}
 					else
 					{
 						auto& rf = Context::Instance().RenderFactoryInstance();
-						ib_cpu = rf.MakeIndexBuffer(BU_Static, EAH_CPU_Read, size, nullptr);
-						ib->CopyToBuffer(*ib_cpu);
+						if (is_index)
+						{
+							buffer_cpu = rf.MakeIndexBuffer(BU_Static, EAH_CPU_Read, size, nullptr);
+						}
+						else
+						{
+							buffer_cpu = rf.MakeVertexBuffer(BU_Static, EAH_CPU_Read, size, nullptr);
+						}
+						buffer->CopyToBuffer(*buffer_cpu);
 					}
 
-					merged_indices.resize(size);
+					std::vector<uint8_t> data(size);
+					GraphicsBuffer::Mapper mapper(*buffer_cpu, BA_Read_Only);
+					std::memcpy(data.data(), mapper.Pointer<uint8_t>(), size);
 
-					GraphicsBuffer::Mapper mapper(*ib_cpu, BA_Read_Only);
-					std::memcpy(&merged_indices[0], mapper.Pointer<uint8_t>(), size);
+					iter = buffer_data.emplace(buffer.get(), std::move(data)).first;
 				}
-			}
+				return iter->second;
+			};
 
+			// Each lod gets its own vertex and index streams. Indices are relative to the base vertex, so they are copied as they are.
+			uint32_t mesh_lod_index = 0;
 			for (uint32_t mesh_index = 0; mesh_index < mesh_names.size(); ++ mesh_index)
 			{
 				auto const& mesh = checked_cast<StaticMesh&>(*model.Mesh(mesh_index));
@@ -2262,17 +3673,56 @@ namespace KlayGE
 				pos_bbs[mesh_index] = mesh.PosBound();
 				tc_bbs[mesh_index] = mesh.TexcoordBound();
 
-				for (uint32_t lod = 0; lod < mesh_lods[mesh_index]; ++ lod)
+				if (lod_geometries.size() < mesh_lods[mesh_index])
 				{
-					mesh_num_vertices.push_back(mesh.NumVertices(lod));
-					mesh_base_vertices.push_back(mesh.StartVertexLocation(lod));
-					mesh_num_indices.push_back(mesh.NumIndices(lod));
-					mesh_base_indices.push_back(mesh.StartIndexLocation(lod));
+					lod_geometries.resize(mesh_lods[mesh_index]);
 				}
-			}
+				for (uint32_t lod = 0; lod < mesh_lods[mesh_index]; ++ lod, ++ mesh_lod_index)
+				{
+					auto const & streams = mesh_lod_streams[mesh_lod_index];
+					auto& geometry = lod_geometries[lod];
+					geometry.vertex_streams.resize(merged_ves.size());
+
+					uint32_t const num_vertices = mesh.NumVertices(lod);
+					uint32_t const base_vertex = mesh.StartVertexLocation(lod);
+					for (size_t j = 0; j < merged_ves.size(); ++ j)
+					{
+						uint32_t const elem_size = merged_ves[j].element_size();
+						auto const & src = read_back(streams.vbs[j], false);
+						geometry.vertex_streams[j].insert(geometry.vertex_streams[j].end(),
+							src.begin() + base_vertex * elem_size, src.begin() + (base_vertex + num_vertices) * elem_size);
+					}
+
+					uint32_t const num_indices = mesh.NumIndices(lod);
+					uint32_t const start_index = mesh.StartIndexLocation(lod);
+					auto const & src_indices = read_back(streams.ib, true);
+					if ((EF_R16UI == streams.index_format) && !all_is_index_16_bit)
+					{
+						for (uint32_t j = 0; j < num_indices; ++ j)
+						{
+							uint16_t index_16;
+							std::memcpy(&index_16, &src_indices[(start_index + j) * sizeof(uint16_t)], sizeof(index_16));
+							uint32_t const index_32 = Native2LE(static_cast<uint32_t>(LE2Native(index_16)));
+							uint8_t const * p = reinterpret_cast<uint8_t const *>(&index_32);
+							geometry.indices.insert(geometry.indices.end(), p, p + sizeof(index_32));
+						}
+					}
+					else
+					{
+						uint32_t const index_size = all_is_index_16_bit ? sizeof(uint16_t) : sizeof(uint32_t);
+						geometry.indices.insert(geometry.indices.end(),
+							src_indices.begin() + start_index * index_size, src_indices.begin() + (start_index + num_indices) * index_size);
+					}
+
+					mesh_num_vertices.push_back(num_vertices);
+					mesh_base_vertices.push_back(geometry.num_vertices);
+					mesh_num_indices.push_back(num_indices);
+					mesh_base_indices.push_back(geometry.num_indices);
 
-			mesh_base_vertices.push_back(mesh_base_vertices.back() + mesh_num_vertices.back());
-			mesh_base_indices.push_back(mesh_base_indices.back() + mesh_num_indices.back());
+					geometry.num_vertices += num_vertices;
+					geometry.num_indices += num_indices;
+				}
+			}
 		}
 
 		std::vector<SceneNode const *> nodes;
@@ -2290,7 +3740,8 @@ namespace KlayGE
 
 		std::vector<JointComponent const*> joints;
 		std::shared_ptr<std::vector<Animation>> animations;
-		std::shared_ptr<std::vector<KeyFrameSet>> kfs;
+		std::shared_ptr<std::vector<KeyFrameSet> const> kfs;
+		std::shared_ptr<KeyFrameTracks const> quantized_kf_tracks;
 		uint32_t num_frame = 0;
 		uint32_t frame_rate = 0;
 		std::vector<std::shared_ptr<AABBKeyFrameSet>> frame_pos_bbs;
@@ -2310,7 +3761,14 @@ namespace KlayGE
 			num_frame = skinned_model.NumFrames();
 			frame_rate = skinned_model.FrameRate();
 
-			kfs = skinned_model.GetKeyFrameSets();
+			if (skinned_model.QuantizeKeyFrames())
+			{
+				quantized_kf_tracks = skinned_model.GetKeyFrameTracks();
+			}
+			else
+			{
+				kfs = skinned_model.GetKeyFrameSets();
+			}
 
 			frame_pos_bbs.resize(mesh_names.size());
 			for (uint32_t mesh_index = 0; mesh_index < mesh_names.size(); ++ mesh_index)
@@ -2320,11 +3778,11 @@ namespace KlayGE
 			}
 		}
 
-		::SaveModel(output_path.string(), mtls, merged_ves, all_is_index_16_bit, merged_buffs, merged_indices,
+		::SaveModel(output_path.string(), mtls, merged_ves, all_is_index_16_bit, lod_geometries,
 			mesh_names, mtl_ids, mesh_lods, pos_bbs, tc_bbs,
 			mesh_num_vertices, mesh_base_vertices, mesh_num_indices, mesh_base_indices,
 			nodes, renderables,
-			joints, animations, kfs, num_frame, frame_rate, frame_pos_bbs);
+			joints, animations, kfs, quantized_kf_tracks, num_frame, frame_rate, frame_pos_bbs);
 
 #if KLAYGE_IS_DEV_PLATFORM
 		if (need_conversion)
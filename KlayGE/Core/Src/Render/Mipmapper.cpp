@@ -77,7 +77,12 @@ namespace KlayGE
 	void Mipmapper::BuildSubLevels(
 		TexturePtr const& texture, uint32_t array_index, uint32_t start_level, uint32_t num_levels, TextureFilter filter) const
 	{
-		if (!effect_ || IsSRGB(texture->Format()) || (texture->Type() == Texture::TT_3D) || !(texture->AccessHint() & EAH_GPU_Unordered))
+		if ((filter != TextureFilter::Point) && (filter != TextureFilter::Linear))
+		{
+			// Kernels wider than a bilinear tap only run on the CPU
+			this->BuildSubLevelsOnCpu(texture, array_index, start_level, num_levels, filter);
+		}
+		else if (!effect_ || IsSRGB(texture->Format()) || (texture->Type() == Texture::TT_3D) || !(texture->AccessHint() & EAH_GPU_Unordered))
 		{
 			for (uint32_t mip = start_level + 1; mip < start_level + num_levels; ++mip)
 			{
@@ -190,4 +195,87 @@ namespace KlayGE
 			}
 		}
 	}
+
+	void Mipmapper::BuildSubLevelsOnCpu(
+		TexturePtr const& texture, uint32_t array_index, uint32_t start_level, uint32_t num_levels, TextureFilter filter) const
+	{
+		auto& rf = Context::Instance().RenderFactoryInstance();
+
+		uint32_t const width = texture->Width(start_level);
+		uint32_t const height = texture->Height(start_level);
+		uint32_t const depth = texture->Depth(start_level);
+		ElementFormat const format = texture->Format();
+		uint32_t const access_hint = EAH_CPU_Read | EAH_CPU_Write;
+
+		TexturePtr cpu_texture;
+		switch (texture->Type())
+		{
+		case Texture::TT_1D:
+			cpu_texture = rf.MakeTexture1D(width, num_levels, 1, format, 1, 0, access_hint);
+			texture->CopyToSubTexture1D(*cpu_texture, 0, 0, 0, width, array_index, start_level, 0, width, TextureFilter::Point);
+			break;
+
+		case Texture::TT_2D:
+			cpu_texture = rf.MakeTexture2D(width, height, num_levels, 1, format, 1, 0, access_hint);
+			texture->CopyToSubTexture2D(
+				*cpu_texture, 0, 0, 0, 0, width, height, array_index, start_level, 0, 0, width, height, TextureFilter::Point);
+			break;
+
+		case Texture::TT_3D:
+			cpu_texture = rf.MakeTexture3D(width, height, depth, num_levels, 1, format, 1, 0, access_hint);
+			texture->CopyToSubTexture3D(*cpu_texture, 0, 0, 0, 0, 0, width, height, depth, array_index, start_level, 0, 0, 0, width,
+				height, depth, TextureFilter::Point);
+			break;
+
+		case Texture::TT_Cube:
+			cpu_texture = rf.MakeTextureCube(width, num_levels, 1, format, 1, 0, access_hint);
+			for (uint32_t f = 0; f < 6; ++f)
+			{
+				auto face = static_cast<Texture::CubeFaces>(f);
+				texture->CopyToSubTextureCube(
+					*cpu_texture, 0, face, 0, 0, 0, width, height, array_index, face, start_level, 0, 0, width, height, TextureFilter::Point);
+			}
+			break;
+
+		default:
+			KFL_UNREACHABLE("Invalid texture type");
+		}
+
+		cpu_texture->BuildMipSubLevels(filter);
+
+		for (uint32_t level = 1; level < num_levels; ++level)
+		{
+			uint32_t const mip = start_level + level;
+			switch (texture->Type())
+			{
+			case Texture::TT_1D:
+				cpu_texture->CopyToSubTexture1D(
+					*texture, array_index, mip, 0, texture->Width(mip), 0, level, 0, cpu_texture->Width(level), TextureFilter::Point);
+				break;
+
+			case Texture::TT_2D:
+				cpu_texture->CopyToSubTexture2D(*texture, array_index, mip, 0, 0, texture->Width(mip), texture->Height(mip), 0, level, 0, 0,
+					cpu_texture->Width(level), cpu_texture->Height(level), TextureFilter::Point);
+				break;
+
+			case Texture::TT_3D:
+				cpu_texture->CopyToSubTexture3D(*texture, array_index, mip, 0, 0, 0, texture->Width(mip), texture->Height(mip),
+					texture->Depth(mip), 0, level, 0, 0, 0, cpu_texture->Width(level), cpu_texture->Height(level),
+					cpu_texture->Depth(level), TextureFilter::Point);
+				break;
+
+			case Texture::TT_Cube:
+				for (uint32_t f = 0; f < 6; ++f)
+				{
+					auto face = static_cast<Texture::CubeFaces>(f);
+					cpu_texture->CopyToSubTextureCube(*texture, array_index, face, mip, 0, 0, texture->Width(mip), texture->Height(mip), 0,
+						face, level, 0, 0, cpu_texture->Width(level), cpu_texture->Height(level), TextureFilter::Point);
+				}
+				break;
+
+			default:
+				KFL_UNREACHABLE("Invalid texture type");
+			}
+		}
+	}
 } // namespace KlayGE
@@ -45,9 +45,19 @@
 #include <KFL/XMLDom.hpp>
 #include <KlayGE/DeferredRenderingLayer.hpp>
 #include <KFL/Hash.hpp>
+#include <KFL/RadixSort.hpp>
+#include <KFL/Thread.hpp>
 
+#include <deque>
 #include <fstream>
+#include <functional>
+#include <numeric>
 #include <string>
+#include <thread>
+
+#if defined(KLAYGE_SSE_SUPPORT)
+#include <xmmintrin.h>
+#endif
 
 #include <KlayGE/ParticleSystem.hpp>
 
@@ -57,6 +67,123 @@ namespace
 
 	uint32_t const NUM_PARTICLES = 4096;
 
+	enum ParticleAttrib
+	{
+		PA_PosX = 0,
+		PA_PosY,
+		PA_PosZ,
+		PA_VelX,
+		PA_VelY,
+		PA_VelZ,
+		PA_Life,
+		PA_Spin,
+		PA_Size,
+		PA_Alpha,
+		PA_InitLife,
+
+		PA_NumAttribs
+	};
+
+	// Runs the updates of all particle systems on at most one pool thread per core. Every system queues itself from its scene
+	// node's sub thread update, so the systems of one scene traversal are updated in parallel.
+	class ParticleUpdateScheduler final
+	{
+	public:
+		static ParticleUpdateScheduler& Instance()
+		{
+			static ParticleUpdateScheduler scheduler;
+			return scheduler;
+		}
+
+		std::future<void> Queue(std::function<void()> job)
+		{
+			std::packaged_task<void()> task(std::move(job));
+			auto ret = task.get_future();
+
+			bool new_worker = false;
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				tasks_.push_back(std::move(task));
+				if (num_workers_ < max_num_workers_)
+				{
+					++ num_workers_;
+					new_worker = true;
+				}
+			}
+			if (new_worker)
+			{
+				Context::Instance().ThreadPoolInstance().QueueThread([this] { this->WorkerFunc(); });
+			}
+
+			return ret;
+		}
+
+	private:
+		ParticleUpdateScheduler()
+			: max_num_workers_(std::max(std::thread::hardware_concurrency(), 1U))
+		{
+		}
+
+		void WorkerFunc()
+		{
+			for (;;)
+			{
+				std::packaged_task<void()> task;
+				{
+					std::lock_guard<std::mutex> lock(mutex_);
+					if (tasks_.empty())
+					{
+						-- num_workers_;
+						return;
+					}
+					task = std::move(tasks_.front());
+					tasks_.pop_front();
+				}
+				task();
+			}
+		}
+
+	private:
+		std::mutex mutex_;
+		std::deque<std::packaged_task<void()>> tasks_;
+		uint32_t num_workers_ = 0;
+		uint32_t const max_num_workers_;
+	};
+
+	float PolylineValue(std::vector<float2> const & ctrl_pts, float pos)
+	{
+		float ret = ctrl_pts.back().y();
+		for (auto iter = std::next(ctrl_pts.begin()); iter != ctrl_pts.end(); ++ iter)
+		{
+			if (iter->x() >= pos)
+			{
+				float2 const & prev = *std::prev(iter);
+				float const s = (pos - prev.x()) / (iter->x() - prev.x());
+				ret = MathLib::lerp(prev.y(), iter->y(), s);
+				break;
+			}
+		}
+		return ret;
+	}
+
+#if defined(KLAYGE_SSE_SUPPORT)
+	// 4 lanes of PolylineValue. Walking the segments backward leaves each lane with the first one that covers it.
+	__m128 PolylineValue(std::vector<float2> const & ctrl_pts, __m128 pos)
+	{
+		__m128 ret = _mm_set1_ps(ctrl_pts.back().y());
+		for (size_t i = ctrl_pts.size() - 1; i > 0; -- i)
+		{
+			float2 const & prev = ctrl_pts[i - 1];
+			float2 const & curr = ctrl_pts[i];
+			__m128 const s = _mm_div_ps(_mm_sub_ps(pos, _mm_set1_ps(prev.x())), _mm_set1_ps(curr.x() - prev.x()));
+			__m128 const value = _mm_add_ps(_mm_set1_ps(prev.y()), _mm_mul_ps(_mm_set1_ps(curr.y() - prev.y()), s));
+			__m128 const covered = _mm_cmpge_ps(_mm_set1_ps(curr.x()), pos);
+			ret = _mm_or_ps(_mm_and_ps(covered, value), _mm_andnot_ps(covered, ret));
+		}
+		return ret;
+	}
+#endif
+
 	class ParticleSystemLoadingDesc : public ResLoadingDesc
 	{
 	private:
@@ -324,6 +451,11 @@ namespace
 			return true;
 		}
 
+		size_t Hash() const override
+		{
+			return HashValue(ps_desc_.res_name);
+		}
+
 		bool Match(ResLoadingDesc const & rhs) const override
 		{
 			if (this->Type() == rhs.Type())
@@ -570,6 +702,16 @@ namespace KlayGE
 
 	ParticleUpdater::~ParticleUpdater() noexcept = default;
 
+	void ParticleUpdater::Update(ParticleBatch const & pars, float elapse_time)
+	{
+		for (uint32_t i = 0; i < pars.Size(); ++ i)
+		{
+			Particle par = pars.Get(i);
+			this->Update(par, elapse_time);
+			pars.Set(i, par);
+		}
+	}
+
 	void ParticleUpdater::DoClone(ParticleUpdaterPtr const & rhs)
 	{
 		rhs->ps_ = ps_;
@@ -578,7 +720,7 @@ namespace KlayGE
 
 	ParticleSystem::ParticleSystem(uint32_t max_num_particles, bool sort_particles)
 		: root_node_(MakeSharedPtr<SceneNode>(L"ParticleSystemRootNode", SceneNode::SOA_Moveable | SceneNode::SOA_NotCastShadow)),
-			particles_(max_num_particles),
+			max_num_particles_(max_num_particles), particle_attribs_(PA_NumAttribs * max_num_particles),
 			gravity_(0.5f), force_(0, 0, 0), media_density_(0.0f),
 			sort_particles_(sort_particles)
 	{
@@ -592,6 +734,8 @@ namespace KlayGE
 		root_node_->OnMainThreadUpdate().Connect(
 			[this, &rf]([[maybe_unused]] SceneNode& node, [[maybe_unused]] float app_time, [[maybe_unused]] float elapsed_time)
 			{
+				this->WaitForUpdate();
+
 				auto const& caps = rf.RenderEngineInstance().DeviceCaps();
 				if (!caps.arbitrary_multithread_rendering_support)
 				{
@@ -601,18 +745,31 @@ namespace KlayGE
 			});
 		root_node_->OnSubThreadUpdate().Connect([this, &rf]([[maybe_unused]] SceneNode& node, [[maybe_unused]] float app_time, float elapsed_time)
 			{
-				std::lock_guard<std::mutex> lock(actived_particles_mutex_);
+				this->WaitForUpdate();
 
-				this->UpdateParticlesNoLock(elapsed_time);
+				update_future_ = ParticleUpdateScheduler::Instance().Queue([this, &rf, elapsed_time]
+					{
+						std::lock_guard<std::mutex> lock(actived_particles_mutex_);
 
-				auto const& caps = rf.RenderEngineInstance().DeviceCaps();
-				if (caps.arbitrary_multithread_rendering_support)
-				{
-					this->UpdateParticleBufferNoLock();
-				}
+						this->UpdateParticlesNoLock(elapsed_time);
+
+						auto const& caps = rf.RenderEngineInstance().DeviceCaps();
+						if (caps.arbitrary_multithread_rendering_support)
+						{
+							this->UpdateParticleBufferNoLock();
+						}
+					});
 			});
 	}
 
+	ParticleSystem::~ParticleSystem() noexcept
+	{
+		if (update_future_.valid())
+		{
+			update_future_.wait();
+		}
+	}
+
 	ParticleSystemPtr ParticleSystem::Clone()
 	{
 		ParticleSystemPtr ret = MakeSharedPtr<ParticleSystem>(NUM_PARTICLES);
@@ -718,105 +875,158 @@ namespace KlayGE
 	uint32_t ParticleSystem::GetActiveParticleIndex(uint32_t i) const
 	{
 		std::lock_guard<std::mutex> lock(actived_particles_mutex_);
-		return actived_particles_[i].first;
+		return actived_particles_[i];
 	}
 
-	void ParticleSystem::ClearParticles()
+	Particle ParticleSystem::GetParticle(uint32_t i) const
 	{
-		for (auto& particle : particles_)
+		BOOST_ASSERT(i < max_num_particles_);
+
+		auto attrib = [this, i](ParticleAttrib pa)
 		{
-			particle.life = 0;
-		}
+			return particle_attribs_[pa * max_num_particles_ + i];
+		};
+
+		Particle par;
+		par.pos = float3(attrib(PA_PosX), attrib(PA_PosY), attrib(PA_PosZ));
+		par.vel = float3(attrib(PA_VelX), attrib(PA_VelY), attrib(PA_VelZ));
+		par.life = attrib(PA_Life);
+		par.spin = attrib(PA_Spin);
+		par.size = attrib(PA_Size);
+		par.alpha = attrib(PA_Alpha);
+		par.init_life = attrib(PA_InitLife);
+		return par;
 	}
 
-	void ParticleSystem::UpdateParticlesNoLock(float elapsed_time)
+	void ParticleSystem::ClearParticles()
 	{
-		auto emitter_iter = emitters_.begin();
-		uint32_t new_particle = (*emitter_iter)->Update(elapsed_time);
+		num_live_particles_ = 0;
+	}
 
-		auto& re = Context::Instance().RenderFactoryInstance().RenderEngineInstance();
-		auto const& camera = *re.DefaultFrameBuffer()->Viewport()->Camera();
-		float4x4 const& view_mat = camera.ViewMatrix();
+	ParticleBatch ParticleSystem::Particles(uint32_t first, uint32_t count)
+	{
+		BOOST_ASSERT(first + count <= max_num_particles_);
 
-		actived_particles_.clear();
+		auto attrib = [this, first, count](ParticleAttrib pa)
+		{
+			return std::span<float>(&particle_attribs_[pa * max_num_particles_ + first], count);
+		};
 
-		float3 min_bb(+1e10f, +1e10f, +1e10f);
-		float3 max_bb(-1e10f, -1e10f, -1e10f);
+		ParticleBatch ret;
+		ret.pos_x = attrib(PA_PosX);
+		ret.pos_y = attrib(PA_PosY);
+		ret.pos_z = attrib(PA_PosZ);
+		ret.vel_x = attrib(PA_VelX);
+		ret.vel_y = attrib(PA_VelY);
+		ret.vel_z = attrib(PA_VelZ);
+		ret.life = attrib(PA_Life);
+		ret.spin = attrib(PA_Spin);
+		ret.size = attrib(PA_Size);
+		ret.alpha = attrib(PA_Alpha);
+		ret.init_life = attrib(PA_InitLife);
+		return ret;
+	}
 
+	// Moves the particles still alive to the front, keeping their order
+	uint32_t ParticleSystem::CompactParticles(uint32_t num_particles)
+	{
+		ParticleBatch const pars = this->Particles(0, num_particles);
+		uint32_t num_live = 0;
+		for (uint32_t i = 0; i < num_particles; ++ i)
+		{
+			if (pars.life[i] > 0)
+			{
+				if (num_live != i)
+				{
+					pars.Set(num_live, pars.Get(i));
+				}
+				++ num_live;
+			}
+		}
+		return num_live;
+	}
+
+	void ParticleSystem::WaitForUpdate()
+	{
+		if (update_future_.valid())
+		{
+			update_future_.get();
+		}
+	}
+
+	void ParticleSystem::UpdateParticlesNoLock(float elapsed_time)
+	{
 		for (auto const & updater : updaters_)
 		{
 			updater->SnapParams();
 		}
 
-		for (uint32_t i = 0; i < particles_.size(); ++ i)
+		ParticleBatch const live_pars = this->Particles(0, num_live_particles_);
+		for (auto const & updater : updaters_)
 		{
-			Particle& particle = particles_[i];
+			updater->Update(live_pars, elapsed_time);
+		}
 
-			if (particle.life > 0)
+		uint32_t num_particles = num_live_particles_;
+		for (auto const & emitter : emitters_)
+		{
+			uint32_t const num_new_particles = std::min(emitter->Update(elapsed_time), max_num_particles_ - num_particles);
+			ParticleBatch const new_pars = this->Particles(num_particles, num_new_particles);
+			for (uint32_t i = 0; i < num_new_particles; ++ i)
 			{
-				for (auto const & updater : updaters_)
-				{
-					updater->Update(particle, elapsed_time);
-				}
+				Particle par;
+				emitter->Emit(par);
+				new_pars.Set(i, par);
 			}
-			else
+			for (auto const & updater : updaters_)
 			{
-				if (new_particle > 0)
-				{
-					(*emitter_iter)->Emit(particle);
-					for (auto const & updater : updaters_)
-					{
-						updater->Update(particle, 0);
-					}
-					-- new_particle;
-				}
-				else
-				{
-					if (emitter_iter != emitters_.end())
-					{
-						++ emitter_iter;
-						if (emitter_iter != emitters_.end())
-						{
-							new_particle = (*emitter_iter)->Update(elapsed_time);
-						}
-					}
-				}
+				updater->Update(new_pars, 0);
 			}
+			num_particles += num_new_particles;
+		}
+
+		num_live_particles_ = this->CompactParticles(num_particles);
 
-			if (particle.life > 0)
+		actived_particles_.resize(num_live_particles_);
+		if (num_live_particles_ > 0)
+		{
+			ParticleBatch const pars = this->Particles(0, num_live_particles_);
+
+			float3 min_bb(+1e10f, +1e10f, +1e10f);
+			float3 max_bb(-1e10f, -1e10f, -1e10f);
+			for (uint32_t i = 0; i < num_live_particles_; ++ i)
 			{
-				float3 const & pos = particle.pos;
+				float3 const pos(pars.pos_x[i], pars.pos_y[i], pars.pos_z[i]);
+				min_bb = MathLib::minimize(min_bb, pos);
+				max_bb = MathLib::maximize(max_bb, pos);
+			}
 
-				float depth_es;
-				if (sort_particles_)
+			if (sort_particles_)
+			{
+				auto& re = Context::Instance().RenderFactoryInstance().RenderEngineInstance();
+				auto const& camera = *re.DefaultFrameBuffer()->Viewport()->Camera();
+				float4x4 const& view_mat = camera.ViewMatrix();
+				float4 const z_row = view_mat.Col(2);
+				float4 const w_row = view_mat.Col(3);
+
+				// Back to front. Inverting the key turns the ascending radix sort into a descending one.
+				sort_items_.resize(num_live_particles_);
+				for (uint32_t i = 0; i < num_live_particles_; ++ i)
 				{
-					float4 const pos4(pos.x(), pos.y(), pos.z(), 1);
-					float4 const z_row = view_mat.Col(2);
-					float4 const w_row = view_mat.Col(3);
-
-					depth_es = MathLib::dot(pos4, z_row) / MathLib::dot(pos4, w_row);
+					float4 const pos4(pars.pos_x[i], pars.pos_y[i], pars.pos_z[i], 1);
+					float const depth_es = MathLib::dot(pos4, z_row) / MathLib::dot(pos4, w_row);
+					sort_items_[i] = std::make_pair(~RadixSortKey(depth_es), i);
 				}
-				else
+				RadixSort(sort_items_, sort_scratch_);
+
+				for (uint32_t i = 0; i < num_live_particles_; ++ i)
 				{
-					depth_es = 0;
+					actived_particles_[i] = sort_items_[i].second;
 				}
-
-				actived_particles_.emplace_back(i, depth_es);
-
-				min_bb = MathLib::minimize(min_bb, pos);
-				max_bb = MathLib::maximize(min_bb, pos);
 			}
-		}
-
-		if (!actived_particles_.empty())
-		{
-			if (sort_particles_)
+			else
 			{
-				std::sort(actived_particles_.begin(), actived_particles_.end(),
-					[](std::pair<uint32_t, float> const & lhs, std::pair<uint32_t, float> const & rhs)
-					{
-						return lhs.second > rhs.second;
-					});
+				std::iota(actived_particles_.begin(), actived_particles_.end(), 0U);
 			}
 
 			checked_cast<RenderParticles&>(*render_particles_).PosBound(AABBox(min_bb, max_bb));
@@ -872,9 +1082,10 @@ namespace KlayGE
 			{
 				GraphicsBuffer::Mapper mapper(*instance_gb, BA_Write_Only);
 				ParticleInstance* instance_data = mapper.Pointer<ParticleInstance>();
+				ParticleBatch const pars = this->Particles(0, num_live_particles_);
 				for (uint32_t i = 0; i < num_active_particles; ++ i, ++ instance_data)
 				{
-					Particle const & par = particles_[actived_particles_[i].first];
+					Particle const par = pars.Get(actived_particles_[i]);
 					instance_data->pos = par.pos;
 					instance_data->life = par.life;
 					instance_data->spin = par.spin;
@@ -1135,41 +1346,9 @@ namespace KlayGE
 
 		float pos = (par.init_life - par.life) / par.init_life;
 
-		float cur_size = this_frame_size_over_life_.back().y();
-		for (auto iter = std::next(this_frame_size_over_life_.begin()); iter != this_frame_size_over_life_.end(); ++ iter)
-		{
-			if (iter->x() >= pos)
-			{
-				float2 const & prev = *std::prev(iter);
-				float const s = (pos - prev.x()) / (iter->x() - prev.x());
-				cur_size = MathLib::lerp(prev.y(), iter->y(), s);
-				break;
-			}
-		}
-
-		float cur_mass = this_frame_mass_over_life_.back().y();
-		for (auto iter = std::next(this_frame_mass_over_life_.begin()); iter != this_frame_mass_over_life_.end(); ++ iter)
-		{
-			if (iter->x() >= pos)
-			{
-				float2 const & prev = *std::prev(iter);
-				float const s = (pos - prev.x()) / (iter->x() - prev.x());
-				cur_mass = MathLib::lerp(prev.y(), iter->y(), s);
-				break;
-			}
-		}
-
-		float cur_alpha = this_frame_opacity_over_life_.back().y();
-		for (auto iter = std::next(this_frame_opacity_over_life_.begin()); iter != this_frame_opacity_over_life_.end(); ++ iter)
-		{
-			if (iter->x() >= pos)
-			{
-				float2 const & prev = *std::prev(iter);
-				float const s = (pos - prev.x()) / (iter->x() - prev.x());
-				cur_alpha = MathLib::lerp(prev.y(), iter->y(), s);
-				break;
-			}
-		}
+		float cur_size = PolylineValue(this_frame_size_over_life_, pos);
+		float cur_mass = PolylineValue(this_frame_mass_over_life_, pos);
+		float cur_alpha = PolylineValue(this_frame_opacity_over_life_, pos);
 
 		ParticleSystemPtr ps = ps_.lock();
 		float buoyancy = 4.0f / 3 * PI * MathLib::cube(cur_size) * ps->MediaDensity() * ps->Gravity();
@@ -1182,6 +1361,71 @@ namespace KlayGE
 		par.alpha = cur_alpha;
 	}
 
+	void PolylineParticleUpdater::Update(ParticleBatch const & pars, float elapse_time)
+	{
+		BOOST_ASSERT(!this_frame_size_over_life_.empty());
+		BOOST_ASSERT(!this_frame_mass_over_life_.empty());
+		BOOST_ASSERT(!this_frame_opacity_over_life_.empty());
+
+		uint32_t const num_pars = pars.Size();
+		uint32_t i = 0;
+
+#if defined(KLAYGE_SSE_SUPPORT)
+		ParticleSystemPtr ps = ps_.lock();
+		float const gravity = ps->Gravity();
+		float3 const & force = ps->Force();
+
+		__m128 const buoyancy_scale = _mm_set1_ps(4.0f / 3 * PI);
+		__m128 const density = _mm_set1_ps(ps->MediaDensity());
+		__m128 const gravity4 = _mm_set1_ps(gravity);
+		__m128 const force_x = _mm_set1_ps(force.x());
+		__m128 const force_y = _mm_set1_ps(force.y());
+		__m128 const force_z = _mm_set1_ps(force.z());
+		__m128 const dt = _mm_set1_ps(elapse_time);
+		__m128 const one = _mm_set1_ps(1.0f);
+		__m128 const spin_step = _mm_set1_ps(0.001f);
+		for (; i + 4 <= num_pars; i += 4)
+		{
+			__m128 const life = _mm_loadu_ps(&pars.life[i]);
+			__m128 const init_life = _mm_loadu_ps(&pars.init_life[i]);
+			__m128 const pos = _mm_div_ps(_mm_sub_ps(init_life, life), init_life);
+
+			__m128 const cur_size = PolylineValue(this_frame_size_over_life_, pos);
+			__m128 const cur_mass = PolylineValue(this_frame_mass_over_life_, pos);
+			__m128 const cur_alpha = PolylineValue(this_frame_opacity_over_life_, pos);
+
+			__m128 const buoyancy = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(buoyancy_scale,
+				_mm_mul_ps(_mm_mul_ps(cur_size, cur_size), cur_size)), density), gravity4);
+			__m128 const inv_mass = _mm_div_ps(one, cur_mass);
+			__m128 const accel_x = _mm_mul_ps(force_x, inv_mass);
+			__m128 const accel_y = _mm_sub_ps(_mm_mul_ps(_mm_add_ps(force_y, buoyancy), inv_mass), gravity4);
+			__m128 const accel_z = _mm_mul_ps(force_z, inv_mass);
+
+			__m128 const vel_x = _mm_add_ps(_mm_loadu_ps(&pars.vel_x[i]), _mm_mul_ps(accel_x, dt));
+			__m128 const vel_y = _mm_add_ps(_mm_loadu_ps(&pars.vel_y[i]), _mm_mul_ps(accel_y, dt));
+			__m128 const vel_z = _mm_add_ps(_mm_loadu_ps(&pars.vel_z[i]), _mm_mul_ps(accel_z, dt));
+			_mm_storeu_ps(&pars.vel_x[i], vel_x);
+			_mm_storeu_ps(&pars.vel_y[i], vel_y);
+			_mm_storeu_ps(&pars.vel_z[i], vel_z);
+			_mm_storeu_ps(&pars.pos_x[i], _mm_add_ps(_mm_loadu_ps(&pars.pos_x[i]), _mm_mul_ps(vel_x, dt)));
+			_mm_storeu_ps(&pars.pos_y[i], _mm_add_ps(_mm_loadu_ps(&pars.pos_y[i]), _mm_mul_ps(vel_y, dt)));
+			_mm_storeu_ps(&pars.pos_z[i], _mm_add_ps(_mm_loadu_ps(&pars.pos_z[i]), _mm_mul_ps(vel_z, dt)));
+
+			_mm_storeu_ps(&pars.life[i], _mm_sub_ps(life, dt));
+			_mm_storeu_ps(&pars.spin[i], _mm_add_ps(_mm_loadu_ps(&pars.spin[i]), spin_step));
+			_mm_storeu_ps(&pars.size[i], cur_size);
+			_mm_storeu_ps(&pars.alpha[i], cur_alpha);
+		}
+#endif
+
+		for (; i < num_pars; ++ i)
+		{
+			Particle par = pars.Get(i);
+			this->Update(par, elapse_time);
+			pars.Set(i, par);
+		}
+	}
+
 	void PolylineParticleUpdater::SnapParams()
 	{
 		std::lock_guard<std::mutex> lock(update_mutex_);
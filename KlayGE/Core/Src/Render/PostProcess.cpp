@@ -33,8 +33,11 @@
 #include <KlayGE/ResLoader.hpp>
 #include <KlayGE/Camera.hpp>
 #include <KFL/Hash.hpp>
+#include <KFL/Timer.hpp>
 
 #include <cstring>
+#include <exception>
+#include <future>
 #include <mutex>
 
 #include <KlayGE/PostProcess.hpp>
@@ -67,6 +70,29 @@ namespace
 			std::shared_ptr<PostProcessData> pp_data;
 
 			std::shared_ptr<PostProcessPtr> pp;
+
+			// Shared by the descs that share a load, so any of them can wait for the one doing the work
+			struct SubThreadStageSignal
+			{
+				std::once_flag once;
+				std::promise<void> promise;
+				std::shared_future<void> future = promise.get_future().share();
+
+				void Finish(std::exception_ptr const & ex)
+				{
+					std::call_once(once, [this, &ex] {
+						if (ex)
+						{
+							promise.set_exception(ex);
+						}
+						else
+						{
+							promise.set_value();
+						}
+					});
+				}
+			};
+			std::shared_ptr<SubThreadStageSignal> sub_thread_stage_done;
 		};
 
 	public:
@@ -76,6 +102,7 @@ namespace
 			pp_desc_.pp_name = std::string(pp_name);
 			pp_desc_.pp_data = MakeSharedPtr<PostProcessDesc::PostProcessData>();
 			pp_desc_.pp = MakeSharedPtr<PostProcessPtr>();
+			pp_desc_.sub_thread_stage_done = MakeSharedPtr<PostProcessDesc::SubThreadStageSignal>();
 		}
 
 		uint64_t Type() const override
@@ -91,6 +118,21 @@ namespace
 		void SubThreadStage() override
 		{
 			std::lock_guard<std::mutex> lock(main_thread_stage_mutex_);
+			try
+			{
+				this->SubThreadStageNoLock();
+			}
+			catch (...)
+			{
+				pp_desc_.sub_thread_stage_done->Finish(std::current_exception());
+				throw;
+			}
+			pp_desc_.sub_thread_stage_done->Finish(nullptr);
+		}
+
+	private:
+		void SubThreadStageNoLock()
+		{
 			if (*pp_desc_.pp)
 			{
 				return;
@@ -172,6 +214,7 @@ namespace
 			}
 		}
 
+	public:
 		void MainThreadStage() override
 		{
 			std::lock_guard<std::mutex> lock(main_thread_stage_mutex_);
@@ -183,6 +226,13 @@ namespace
 			return true;
 		}
 
+		size_t Hash() const override
+		{
+			size_t seed = HashValue(pp_desc_.res_name);
+			HashCombine(seed, HashValue(pp_desc_.pp_name));
+			return seed;
+		}
+
 		bool Match(ResLoadingDesc const & rhs) const override
 		{
 			if (this->Type() == rhs.Type())
@@ -202,6 +252,7 @@ namespace
 			pp_desc_.res_name = ppld.pp_desc_.res_name;
 			pp_desc_.pp_name = ppld.pp_desc_.pp_name;
 			pp_desc_.pp_data = ppld.pp_desc_.pp_data;
+			pp_desc_.sub_thread_stage_done = ppld.pp_desc_.sub_thread_stage_done;
 		}
 
 		std::shared_ptr<void> CloneResourceFrom(std::shared_ptr<void> const & resource) override
@@ -215,6 +266,13 @@ namespace
 			return *pp_desc_.pp;
 		}
 
+		// Blocks until a loading thread, or a SyncQuery that took the load over, has run the sub thread stage of this load.
+		// Rethrows what the sub thread stage threw.
+		void WaitForSubThreadStage() const
+		{
+			pp_desc_.sub_thread_stage_done->future.get();
+		}
+
 	private:
 		void MainThreadStageNoLock()
 		{
@@ -235,7 +293,7 @@ namespace
 
 	private:
 		PostProcessDesc pp_desc_;
-		std::mutex main_thread_stage_mutex_;
+		mutable std::mutex main_thread_stage_mutex_;
 	};
 }
 
@@ -280,7 +338,7 @@ namespace KlayGE
 	PostProcessPtr PostProcess::Clone()
 	{
 		RenderEffectPtr effect = effect_->Clone();
-		RenderTechnique* tech = effect->TechniqueByName(technique_->Name());
+		RenderTechnique* tech = effect->TechniqueByNameHash(technique_->NameHash());
 
 		std::vector<std::string> param_names(params_.size());
 		for (size_t i = 0; i < param_names.size(); ++ i)
@@ -324,7 +382,7 @@ namespace KlayGE
 
 			if (volumetric_)
 			{
-				pp_mvp_param_ = effect_->ParameterByName("pp_mvp");
+				pp_mvp_param_ = effect_->ParameterByNameHash(CtHash("pp_mvp"));
 			}
 			else
 			{
@@ -366,8 +424,8 @@ namespace KlayGE
 				params_[i].second = effect_->ParameterByName(params_[i].first);
 			}
 
-			width_height_ep_ = effect_->ParameterByName("width_height");
-			inv_width_height_ep_ = effect_->ParameterByName("inv_width_height");
+			width_height_ep_ = effect_->ParameterByNameHash(CtHash("width_height"));
+			inv_width_height_ep_ = effect_->ParameterByNameHash(CtHash("inv_width_height"));
 		}
 	}
 
@@ -895,6 +953,112 @@ namespace KlayGE
 	}
 
 
+	class PostProcessBatchLoader::Impl
+	{
+	public:
+		struct Request
+		{
+			std::string ppml_name;
+			std::string pp_name;
+			std::shared_ptr<PostProcessLoadingDesc> desc;
+			PostProcessPtr pp;
+			std::vector<PostProcessPtr*> outputs;
+			double ready_time = -1;
+		};
+
+	public:
+		void Ready(Request& request, PostProcessPtr const & pp)
+		{
+			request.pp = pp;
+			request.ready_time = timer_.elapsed();
+		}
+
+	public:
+		Timer timer_;
+		std::vector<Request> requests_;
+	};
+
+	PostProcessBatchLoader::PostProcessBatchLoader()
+		: pimpl_(MakeUniquePtr<Impl>())
+	{
+	}
+
+	PostProcessBatchLoader::~PostProcessBatchLoader() noexcept = default;
+
+	void PostProcessBatchLoader::Add(std::string_view ppml_name, std::string_view pp_name, PostProcessPtr& pp)
+	{
+		for (auto& request : pimpl_->requests_)
+		{
+			if ((request.ppml_name == ppml_name) && (request.pp_name == pp_name))
+			{
+				request.outputs.push_back(&pp);
+				return;
+			}
+		}
+
+		auto& request = pimpl_->requests_.emplace_back();
+		request.ppml_name = std::string(ppml_name);
+		request.pp_name = std::string(pp_name);
+		request.desc = MakeSharedPtr<PostProcessLoadingDesc>(ppml_name, pp_name);
+		request.outputs.push_back(&pp);
+
+		// Already loaded ones come back right away
+		auto res = Context::Instance().ResLoaderInstance().ASyncQueryT<PostProcess>(request.desc);
+		if (res)
+		{
+			pimpl_->Ready(request, res);
+		}
+	}
+
+	void PostProcessBatchLoader::Join()
+	{
+		// The loading threads work on all of them at the same time. Waits for each one and runs its main thread stage here.
+		for (auto& request : pimpl_->requests_)
+		{
+			if (!request.pp)
+			{
+				request.desc->WaitForSubThreadStage();
+				request.desc->MainThreadStage();
+				pimpl_->Ready(request, std::static_pointer_cast<PostProcess>(request.desc->Resource()));
+			}
+		}
+
+		// Hands the finished loads over to the loaded resources
+		Context::Instance().ResLoaderInstance().Update();
+
+		for (auto& request : pimpl_->requests_)
+		{
+			// Post processes have states. Every output except the first one gets its own copy.
+			*request.outputs[0] = request.pp;
+			for (size_t i = 1; i < request.outputs.size(); ++ i)
+			{
+				*request.outputs[i] = request.pp->Clone();
+			}
+			request.outputs.clear();
+		}
+	}
+
+	uint32_t PostProcessBatchLoader::NumPostProcesses() const noexcept
+	{
+		return static_cast<uint32_t>(pimpl_->requests_.size());
+	}
+
+	std::string const & PostProcessBatchLoader::PpmlName(uint32_t index) const noexcept
+	{
+		return pimpl_->requests_[index].ppml_name;
+	}
+
+	std::string const & PostProcessBatchLoader::PostProcessName(uint32_t index) const noexcept
+	{
+		return pimpl_->requests_[index].pp_name;
+	}
+
+	double PostProcessBatchLoader::ReadyTime(uint32_t index) const noexcept
+	{
+		return pimpl_->requests_[index].ready_time;
+	}
+
+
 	PostProcessChain::PostProcessChain(std::wstring const & name)
 			: PostProcess(name, false)
 	{
@@ -46,11 +46,13 @@
 
 #include <KlayGE/KlayGE.hpp>
 
+#include <KFL/CXX20/bit.hpp>
 #include <KFL/CXX20/format.hpp>
 #include <KFL/CXX23/utility.hpp>
 #include <KFL/ErrorHandling.hpp>
 #include <KFL/Log.hpp>
 #include <KFL/StringUtil.hpp>
+#include <KFL/Thread.hpp>
 #include <KFL/Util.hpp>
 #include <KlayGE/ResLoader.hpp>
 #include <KlayGE/Context.hpp>
@@ -63,15 +65,18 @@
 #include <KFL/XMLDom.hpp>
 #include <KFL/Hash.hpp>
 
+#include <atomic>
 #ifdef KLAYGE_CXX17_LIBRARY_CHARCONV_SUPPORT
 #include <charconv>
 #endif
 #include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <iterator>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <variant>
 
 #include <boost/assert.hpp>
@@ -82,7 +87,67 @@ namespace
 {
 	using namespace KlayGE;
 
-	uint32_t const KFX_VERSION = 0x0151;
+	uint32_t const KFX_VERSION = 0x0152;
+
+	std::atomic<uint32_t> kfx_cache_hits(0);
+	std::atomic<uint32_t> kfx_cache_misses(0);
+
+	uint32_t const INVALID_INDEX = static_cast<uint32_t>(-1);
+
+	size_t NameHashOf(RenderEffectParameter const& param) noexcept
+	{
+		return param.NameHash();
+	}
+
+	size_t NameHashOf(RenderEffectConstantBufferPtr const& cbuffer) noexcept
+	{
+		return cbuffer->NameHash();
+	}
+
+	size_t NameHashOf(RenderTechnique const& tech) noexcept
+	{
+		return tech.NameHash();
+	}
+
+#if KLAYGE_IS_DEV_PLATFORM
+	uint64_t ContentHash(ResIdentifier& source)
+	{
+		auto const data = source.Data();
+		if (!data.empty())
+		{
+			return HashRange(data.begin(), data.end());
+		}
+
+		source.seekg(0, std::ios_base::end);
+		std::vector<uint8_t> buff(static_cast<size_t>(source.tellg()));
+		source.seekg(0, std::ios_base::beg);
+		source.read(buff.data(), buff.size());
+		return HashRange(buff.begin(), buff.end());
+	}
+
+	// Jobs are picked in order by up to num_threads threads. The calling thread is one of them.
+	void RunShaderCompileJobs(std::span<std::function<void()> const> jobs, uint32_t num_threads)
+	{
+		num_threads = std::min(num_threads, static_cast<uint32_t>(jobs.size()));
+
+		std::atomic<uint32_t> next_job(0);
+		auto run_jobs = [jobs, &next_job]
+		{
+			for (uint32_t i = next_job++; i < jobs.size(); i = next_job++)
+			{
+				jobs[i]();
+			}
+		};
+
+		// One task per thread, each of them pulling jobs until none are left
+		ParallelFor(Context::Instance().ThreadPoolInstance(), num_threads, 1,
+			[&run_jobs]([[maybe_unused]] uint32_t begin, [[maybe_unused]] uint32_t end)
+			{
+				run_jobs();
+			},
+			num_threads);
+	}
+#endif
 
 #if KLAYGE_IS_DEV_PLATFORM
 	std::unique_ptr<RenderVariable> LoadVariable(
@@ -4106,6 +4171,16 @@ namespace KlayGE
 			return true;
 		}
 
+		size_t Hash() const override
+		{
+			size_t seed = 0;
+			for (auto const& name : effect_desc_.res_name)
+			{
+				HashCombine(seed, HashValue(name));
+			}
+			return seed;
+		}
+
 		bool Match(ResLoadingDesc const & rhs) const override
 		{
 			if (this->Type() == rhs.Type())
@@ -4311,6 +4386,50 @@ namespace KlayGE
 
 
 	RenderEffect::Immutable::Immutable() = default;
+
+	void RenderEffect::NameHashIndex::Clear() noexcept
+	{
+		slots_.clear();
+	}
+
+	void RenderEffect::NameHashIndex::Build(std::span<size_t const> name_hashes)
+	{
+		// At most half full. Never empty, so a built index can be told from one that isn't.
+		uint32_t const num_slots = std::bit_ceil(std::max(static_cast<uint32_t>(name_hashes.size() * 2), 1U));
+		uint32_t const mask = num_slots - 1;
+		slots_.assign(num_slots, std::make_pair(size_t(0), INVALID_INDEX));
+		for (uint32_t i = 0; i < name_hashes.size(); ++i)
+		{
+			for (uint32_t slot = static_cast<uint32_t>(name_hashes[i]) & mask;; slot = (slot + 1) & mask)
+			{
+				if (slots_[slot].second == INVALID_INDEX)
+				{
+					slots_[slot] = std::make_pair(name_hashes[i], i);
+					break;
+				}
+				if (slots_[slot].first == name_hashes[i])
+				{
+					// Same as the linear search, the first one of a name wins
+					break;
+				}
+			}
+		}
+	}
+
+	uint32_t RenderEffect::NameHashIndex::Find(size_t name_hash) const noexcept
+	{
+		BOOST_ASSERT(this->Built());
+
+		uint32_t const mask = static_cast<uint32_t>(slots_.size() - 1);
+		for (uint32_t slot = static_cast<uint32_t>(name_hash) & mask;; slot = (slot + 1) & mask)
+		{
+			if ((slots_[slot].second == INVALID_INDEX) || (slots_[slot].first == name_hash))
+			{
+				return slots_[slot].second;
+			}
+		}
+	}
+
 	RenderEffect::RenderEffect() = default;
 
 	void RenderEffect::Load(std::span<std::string const> names)
@@ -4320,6 +4439,11 @@ namespace KlayGE
 			immutable_ = MakeSharedPtr<Immutable>();
 		}
 
+		// Lookups during loading search linearly until the indices are built
+		param_index_.Clear();
+		cbuffer_index_.Clear();
+		immutable_->tech_index.Clear();
+
 		auto& res_loader = Context::Instance().ResLoaderInstance();
 
 		std::filesystem::path first_fxml_path(res_loader.Locate(*names.begin()));
@@ -4343,35 +4467,20 @@ namespace KlayGE
 
 		immutable_->res_name = (first_fxml_directory / (connected_name + ".fxml")).string();
 		immutable_->res_name_hash = HashValue(immutable_->res_name);
-#if KLAYGE_IS_DEV_PLATFORM
-		for (auto const& name : names)
-		{
-			immutable_->timestamp = 0;
-
-			ResIdentifierPtr source = res_loader.Open(name);
-			if (source)
-			{
-				immutable_->timestamp = std::max(immutable_->timestamp, source->Timestamp());
-
-				XMLNode root = LoadXml(*source);
-
-				std::vector<std::string> include_names;
-				this->RecursiveIncludeNode(root, include_names);
-
-				for (auto const& include_name : include_names)
-				{
-					immutable_->timestamp = std::max(immutable_->timestamp, res_loader.Timestamp(include_name));
-				}
-			}
-		}
-#endif
 
 #if KLAYGE_IS_DEV_PLATFORM
 		immutable_->need_compile = false;
 #endif
+		// The kfx lists the fxml files it was built from, so checking it doesn't need to parse any of them
 		ResIdentifierPtr kfx_source = res_loader.Open(kfx_name);
-		if (!kfx_source || !this->StreamIn(*kfx_source))
+		if (kfx_source && this->StreamIn(*kfx_source))
+		{
+			++ kfx_cache_hits;
+		}
+		else
 		{
+			++ kfx_cache_misses;
+
 #if KLAYGE_IS_DEV_PLATFORM
 			params_.clear();
 			cbuffers_.clear();
@@ -4414,25 +4523,103 @@ namespace KlayGE
 
 				this->Load(root);
 
+				immutable_->dependencies.clear();
+				for (auto const& dependency_names : {std::span<std::string const>(names), std::span<std::string const>(include_names)})
+				{
+					for (auto const& name : dependency_names)
+					{
+						ResIdentifierPtr source = res_loader.Open(name);
+						if (source)
+						{
+							immutable_->dependencies.push_back({name, res_loader.Timestamp(name), ContentHash(*source)});
+						}
+					}
+				}
+
 				immutable_->kfx_name = kfx_name;
 				immutable_->need_compile = true;
 			}
 #endif
 		}
+
+		this->BuildNameHashIndices();
+
+		std::vector<size_t> tech_name_hashes(immutable_->techniques.size());
+		for (size_t i = 0; i < immutable_->techniques.size(); ++i)
+		{
+			tech_name_hashes[i] = immutable_->techniques[i].NameHash();
+		}
+		immutable_->tech_index.Build(tech_name_hashes);
+	}
+
+	void RenderEffect::BuildNameHashIndices()
+	{
+		std::vector<size_t> name_hashes(params_.size());
+		for (size_t i = 0; i < params_.size(); ++i)
+		{
+			name_hashes[i] = params_[i].NameHash();
+		}
+		param_index_.Build(name_hashes);
+
+		name_hashes.resize(cbuffers_.size());
+		for (size_t i = 0; i < cbuffers_.size(); ++i)
+		{
+			name_hashes[i] = cbuffers_[i]->NameHash();
+		}
+		cbuffer_index_.Build(name_hashes);
+	}
+
+	template <typename T>
+	uint32_t RenderEffect::FindByNameHash(NameHashIndex const* index, std::vector<T> const& items, size_t name_hash) noexcept
+	{
+		// No index for an effect that hasn't been loaded or cloned from a loaded one
+		if ((index != nullptr) && index->Built())
+		{
+			uint32_t const i = index->Find(name_hash);
+			BOOST_ASSERT((i == INVALID_INDEX) || (i < items.size()));
+			return (i < items.size()) ? i : INVALID_INDEX;
+		}
+
+		for (uint32_t i = 0; i < items.size(); ++i)
+		{
+			if (name_hash == NameHashOf(items[i]))
+			{
+				return i;
+			}
+		}
+		return INVALID_INDEX;
 	}
 
 #if KLAYGE_IS_DEV_PLATFORM
-	void RenderEffect::CompileShaders()
+	void RenderEffect::CompileShaders(uint32_t num_jobs)
 	{
 		if (immutable_->need_compile)
 		{
+			std::vector<ShaderCompileJob> jobs;
 			uint32_t tech_index = 0;
 			for (auto& tech : immutable_->techniques)
 			{
-				tech.CompileShaders(*this, tech_index);
+				tech.CompileShaders(*this, tech_index, jobs);
 				++tech_index;
 			}
 
+			// Some backends read the hull shader when compiling a domain shader, which can belong to another pass. So domain shaders
+			// wait for all other stages. The results stay in the stage objects, the kfx is written in the same order either way.
+			std::vector<std::function<void()>> waves[2];
+			for (auto& job : jobs)
+			{
+				waves[job.first == ShaderStage::Domain].push_back(std::move(job.second));
+			}
+
+			if (num_jobs == 0)
+			{
+				num_jobs = std::max(std::thread::hardware_concurrency(), 1U);
+			}
+			for (auto const& wave : waves)
+			{
+				RunShaderCompileJobs(wave, num_jobs);
+			}
+
 			std::ofstream ofs(immutable_->kfx_name.c_str(), std::ios_base::binary | std::ios_base::out);
 			this->StreamOut(ofs);
 		}
@@ -4449,6 +4636,16 @@ namespace KlayGE
 		}
 	}
 
+	uint32_t RenderEffect::NumKfxCacheHits() noexcept
+	{
+		return kfx_cache_hits;
+	}
+
+	uint32_t RenderEffect::NumKfxCacheMisses() noexcept
+	{
+		return kfx_cache_misses;
+	}
+
 	RenderEffectPtr RenderEffect::Clone()
 	{
 		RenderEffectPtr ret = MakeSharedPtr<RenderEffect>();
@@ -4472,6 +4669,9 @@ namespace KlayGE
 			dst_effect.cbuffers_[i] = cbuffers_[i]->Clone(dst_effect);
 		}
 
+		dst_effect.param_index_ = param_index_;
+		dst_effect.cbuffer_index_ = cbuffer_index_;
+
 		dst_effect.shader_objs_.resize(shader_objs_.size());
 		for (size_t i = 0; i < shader_objs_.size(); ++i)
 		{
@@ -4489,6 +4689,9 @@ namespace KlayGE
 			cbuffers_[i]->Reclone(*dst_effect.cbuffers_[i], dst_effect);
 		}
 
+		// The clone could be made before this effect finished loading
+		dst_effect.BuildNameHashIndices();
+
 		for (size_t i = 0; i < shader_objs_.size(); ++i)
 		{
 			if (shader_objs_[i]->HWResourceReady())
@@ -4540,28 +4743,24 @@ namespace KlayGE
 
 	RenderEffectParameter* RenderEffect::ParameterByName(std::string_view name) noexcept
 	{
-		size_t const name_hash = HashValue(std::move(name));
-		for (auto& param : params_)
-		{
-			if (name_hash == param.NameHash())
-			{
-				return &param;
-			}
-		}
-		return nullptr;
+		return this->ParameterByNameHash(HashValue(std::move(name)));
 	}
 
 	RenderEffectParameter const* RenderEffect::ParameterByName(std::string_view name) const noexcept
 	{
-		size_t const name_hash = HashValue(std::move(name));
-		for (auto const& param : params_)
-		{
-			if (name_hash == param.NameHash())
-			{
-				return &param;
-			}
-		}
-		return nullptr;
+		return this->ParameterByNameHash(HashValue(std::move(name)));
+	}
+
+	RenderEffectParameter* RenderEffect::ParameterByNameHash(size_t name_hash) noexcept
+	{
+		uint32_t const index = FindByNameHash(&param_index_, params_, name_hash);
+		return (index != INVALID_INDEX) ? &params_[index] : nullptr;
+	}
+
+	RenderEffectParameter const* RenderEffect::ParameterByNameHash(size_t name_hash) const noexcept
+	{
+		uint32_t const index = FindByNameHash(&param_index_, params_, name_hash);
+		return (index != INVALID_INDEX) ? &params_[index] : nullptr;
 	}
 
 	RenderEffectParameter* RenderEffect::ParameterByIndex(uint32_t n) noexcept
@@ -4578,15 +4777,13 @@ namespace KlayGE
 
 	RenderEffectConstantBuffer* RenderEffect::CBufferByName(std::string_view name) const noexcept
 	{
-		uint32_t index = this->FindCBuffer(name);
-		if (index != static_cast<uint32_t>(-1))
-		{
-			return this->CBufferByIndex(index);
-		}
-		else
-		{
-			return nullptr;
-		}
+		return this->CBufferByNameHash(HashValue(std::move(name)));
+	}
+
+	RenderEffectConstantBuffer* RenderEffect::CBufferByNameHash(size_t name_hash) const noexcept
+	{
+		uint32_t const index = FindByNameHash(&cbuffer_index_, cbuffers_, name_hash);
+		return (index != INVALID_INDEX) ? this->CBufferByIndex(index) : nullptr;
 	}
 
 	RenderEffectConstantBuffer* RenderEffect::CBufferByIndex(uint32_t index) const noexcept
@@ -4597,15 +4794,7 @@ namespace KlayGE
 
 	uint32_t RenderEffect::FindCBuffer(std::string_view name) const noexcept
 	{
-		size_t const name_hash = HashValue(std::move(name));
-		for (uint32_t i = 0; i < cbuffers_.size(); ++i)
-		{
-			if (name_hash == cbuffers_[i]->NameHash())
-			{
-				return i;
-			}
-		}
-		return static_cast<uint32_t>(-1);
+		return FindByNameHash(&cbuffer_index_, cbuffers_, HashValue(std::move(name)));
 	}
 
 	void RenderEffect::BindCBufferByName(std::string_view name, RenderEffectConstantBufferPtr const& cbuff) noexcept
@@ -4654,15 +4843,18 @@ namespace KlayGE
 
 	RenderTechnique* RenderEffect::TechniqueByName(std::string_view name) const noexcept
 	{
-		size_t const name_hash = HashValue(std::move(name));
-		for (auto& tech : immutable_->techniques)
+		return this->TechniqueByNameHash(HashValue(std::move(name)));
+	}
+
+	RenderTechnique* RenderEffect::TechniqueByNameHash(size_t name_hash) const noexcept
+	{
+		if (!immutable_)
 		{
-			if (name_hash == tech.NameHash())
-			{
-				return &tech;
-			}
+			return nullptr;
 		}
-		return nullptr;
+
+		uint32_t const index = FindByNameHash(&immutable_->tech_index, immutable_->techniques, name_hash);
+		return (index != INVALID_INDEX) ? &immutable_->techniques[index] : nullptr;
 	}
 
 	RenderTechnique* RenderEffect::TechniqueByIndex(uint32_t n) const noexcept
@@ -4755,34 +4947,23 @@ namespace KlayGE
 		}
 	}
 
-	void RenderEffect::RecursiveIncludeNode(XMLNode const& root, std::vector<std::string>& include_names) const
+	bool RenderEffect::DependenciesUpToDate() const
 	{
+		// A newer file only invalidates the kfx if its content changed, too. A file that can't be found any more always does.
 		auto& res_loader = Context::Instance().ResLoaderInstance();
-		for (XMLNode const* node = root.FirstNode("include"); node; node = node->NextSibling("include"))
+		for (auto const& dependency : immutable_->dependencies)
 		{
-			XMLAttribute const* attr = node->Attrib("name");
-			BOOST_ASSERT(attr);
-
-			std::string_view const include_name = attr->ValueString();
-
-			XMLNode include_root = LoadXml(*res_loader.Open(include_name));
-			this->RecursiveIncludeNode(include_root, include_names);
-
-			bool found = false;
-			for (size_t i = 0; i < include_names.size(); ++ i)
+			uint64_t const timestamp = res_loader.Timestamp(dependency.name);
+			if ((timestamp == 0) || (timestamp > dependency.timestamp))
 			{
-				if (include_name == include_names[i])
+				ResIdentifierPtr source = res_loader.Open(dependency.name);
+				if (!source || (ContentHash(*source) != dependency.content_hash))
 				{
-					found = true;
-					break;
+					return false;
 				}
 			}
-
-			if (!found)
-			{
-				include_names.emplace_back(include_name);
-			}
 		}
+		return true;
 	}
 
 	XMLNode RenderEffect::ResolveInheritTechNode(XMLNode& root, XMLNode const* tech_node)
@@ -5071,11 +5252,26 @@ namespace KlayGE
 			if ((re.NativeShaderFourCC() == shader_fourcc) && (re.NativeShaderVersion() == shader_ver)
 				&& (re.NativeShaderPlatformName() == shader_platform_name))
 			{
-				uint64_t timestamp;
-				source.read(&timestamp, sizeof(timestamp));
+				uint16_t num_dependencies;
+				source.read(&num_dependencies, sizeof(num_dependencies));
+				num_dependencies = LE2Native(num_dependencies);
 #if KLAYGE_IS_DEV_PLATFORM
-				timestamp = LE2Native(timestamp);
-				if (immutable_->timestamp <= timestamp)
+				immutable_->dependencies.resize(num_dependencies);
+				for (auto& dependency : immutable_->dependencies)
+				{
+					dependency.name = ReadShortString(source);
+					source.read(&dependency.timestamp, sizeof(dependency.timestamp));
+					dependency.timestamp = LE2Native(dependency.timestamp);
+					source.read(&dependency.content_hash, sizeof(dependency.content_hash));
+					dependency.content_hash = LE2Native(dependency.content_hash);
+				}
+				if (this->DependenciesUpToDate())
+#else
+				for (uint32_t i = 0; i < num_dependencies; ++ i)
+				{
+					ReadShortString(source);
+					source.seekg(sizeof(uint64_t) * 2, std::ios_base::cur);
+				}
 #endif
 				{
 					immutable_->shader_descs.resize(1);
@@ -5213,8 +5409,19 @@ namespace KlayGE
 		os.write(reinterpret_cast<char const *>(&shader_platform_name_len), sizeof(shader_platform_name_len));
 		os.write(&re.NativeShaderPlatformName()[0], shader_platform_name_len);
 
-		uint64_t timestamp = Native2LE(immutable_->timestamp);
-		os.write(reinterpret_cast<char const *>(&timestamp), sizeof(timestamp));
+		{
+			uint16_t num_dependencies = Native2LE(static_cast<uint16_t>(immutable_->dependencies.size()));
+			os.write(reinterpret_cast<char const *>(&num_dependencies), sizeof(num_dependencies));
+
+			for (auto const& dependency : immutable_->dependencies)
+			{
+				WriteShortString(os, dependency.name);
+				uint64_t timestamp = Native2LE(dependency.timestamp);
+				os.write(reinterpret_cast<char const *>(&timestamp), sizeof(timestamp));
+				uint64_t content_hash = Native2LE(dependency.content_hash);
+				os.write(reinterpret_cast<char const *>(&content_hash), sizeof(content_hash));
+			}
+		}
 
 		{
 			uint16_t num_macros = Native2LE(static_cast<uint16_t>(immutable_->macros.size()));
@@ -5876,7 +6083,7 @@ namespace KlayGE
 		}
 	}
 
-	void RenderTechnique::CompileShaders(RenderEffect& effect, uint32_t tech_index)
+	void RenderTechnique::CompileShaders(RenderEffect& effect, uint32_t tech_index, std::vector<ShaderCompileJob>& jobs)
 	{
 		RenderEngine& render_eng = Context::Instance().RenderFactoryInstance().RenderEngineInstance();
 		const auto& caps = render_eng.DeviceCaps();
@@ -5889,7 +6096,7 @@ namespace KlayGE
 		uint32_t pass_index = 0;
 		for (auto& pass : passes_)
 		{
-			pass->CompileShaders(effect, tech_index, pass_index);
+			pass->CompileShaders(effect, tech_index, pass_index, jobs);
 			++pass_index;
 		}
 	}
@@ -6600,7 +6807,7 @@ namespace KlayGE
 		}
 	}
 
-	void RenderPass::CompileShaders(RenderEffect& effect, uint32_t tech_index, uint32_t pass_index)
+	void RenderPass::CompileShaders(RenderEffect& effect, uint32_t tech_index, uint32_t pass_index, std::vector<ShaderCompileJob>& jobs)
 	{
 		auto const & shader_obj = this->GetShaderObject(effect);
 		for (uint32_t stage_index = 0; stage_index < NumShaderStages; ++stage_index)
@@ -6612,7 +6819,10 @@ namespace KlayGE
 				if (sd.tech_pass_type == (tech_index << 16) + (pass_index << 8) + stage_index)
 				{
 					auto const & tech = *effect.TechniqueByIndex(tech_index);
-					shader_obj->Stage(stage)->CompileShader(effect, tech, *this, shader_desc_ids_);
+					jobs.emplace_back(stage, [&effect, &tech, this, shader_stage = shader_obj->Stage(stage).get()]
+						{
+							shader_stage->CompileShader(effect, tech, *this, shader_desc_ids_);
+						});
 				}
 			}
 		}
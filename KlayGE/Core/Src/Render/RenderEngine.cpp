@@ -40,6 +40,7 @@
 
 #include <KFL/CXX20/format.hpp>
 #include <KFL/ErrorHandling.hpp>
+#include <KFL/Log.hpp>
 #include <KFL/Util.hpp>
 #include <KFL/Math.hpp>
 #include <KlayGE/Context.hpp>
@@ -72,6 +73,58 @@ namespace
 	std::mutex model_cb_instance_mutex;
 	std::mutex camera_cb_instance_mutex;
 	std::mutex mipmapper_instance_mutex;
+
+	char const* StereoscopicPostProcessName(KlayGE::StereoMethod method)
+	{
+		using namespace KlayGE;
+
+		switch (method)
+		{
+		case STM_ColorAnaglyph_RedCyan:
+			return "stereoscopic_red_cyan";
+
+		case STM_ColorAnaglyph_YellowBlue:
+			return "stereoscopic_yellow_blue";
+
+		case STM_ColorAnaglyph_GreenRed:
+			return "stereoscopic_green_red";
+
+		case STM_HorizontalInterlacing:
+			return "stereoscopic_hor_interlacing";
+
+		case STM_VerticalInterlacing:
+			return "stereoscopic_ver_interlacing";
+
+		case STM_Horizontal:
+			return "stereoscopic_horizontal";
+
+		case STM_Vertical:
+			return "stereoscopic_vertical";
+
+		case STM_LCDShutter:
+			return "stereoscopic_lcd_shutter";
+
+		case STM_OculusVR:
+			return "stereoscopic_oculus_vr";
+
+		default:
+			KFL_UNREACHABLE("Invalid stereo method");
+		}
+	}
+
+	char const* DisplayOutputPostProcessName(KlayGE::DisplayOutputMethod method)
+	{
+		using namespace KlayGE;
+
+		switch (method)
+		{
+		case DOM_HDR10:
+			return "DisplayHDR10";
+
+		default:
+			KFL_UNREACHABLE("Invalid display output method");
+		}
+	}
 }
 
 namespace KlayGE
@@ -83,6 +136,7 @@ namespace KlayGE
 			num_draws_just_called_(0), num_dispatches_just_called_(0),
 			default_fov_(PI / 4), default_render_width_scale_(1), default_render_height_scale_(1),
 			stereo_method_(STM_None), stereo_separation_(0),
+			display_output_method_(DOM_sRGB),
 			fb_stage_(0), force_line_mode_(false)
 	{
 	}
@@ -128,6 +182,11 @@ namespace KlayGE
 		{
 			stereo_separation_ = settings.stereo_separation;
 		}
+#ifndef KLAYGE_SHIP
+		startup_timer_.restart();
+		first_frame_reported_ = false;
+#endif
+
 		this->DoCreateRenderWindow(name, settings);
 		this->CheckConfig(settings);
 		RenderDeviceCaps const & caps = this->DeviceCaps();
@@ -194,18 +253,21 @@ namespace KlayGE
 		uint32_t const render_width = static_cast<uint32_t>(settings.width * default_render_width_scale_ + 0.5f);
 		uint32_t const render_height = static_cast<uint32_t>(settings.height * default_render_height_scale_ + 0.5f);
 
+		// None of the post processes depends on another one. All of them are loaded at the same time, and waited for right
+		// before they are used.
+		PostProcessBatchLoader pp_loader;
+
 		hdr_enabled_ = settings.hdr;
 		if (settings.hdr)
 		{
-			hdr_pp_ = MakeSharedPtr<HDRPostProcess>(settings.fft_lens_effects);
-			skip_hdr_pp_ = SyncLoadPostProcess("ToneMapping.ppml", "skip_tone_mapping");
+			pp_loader.Add("ToneMapping.ppml", "skip_tone_mapping", skip_hdr_pp_);
 		}
 
 		ppaa_enabled_ = settings.ppaa ? 1 : 0;
 		if (settings.ppaa)
 		{
-			smaa_edge_detection_pp_ = SyncLoadPostProcess("SMAA.ppml", "luma_edge_detection");
-			smaa_blending_weight_pp_ = SyncLoadPostProcess("SMAA.ppml", "blending_weight_calculation");
+			pp_loader.Add("SMAA.ppml", "luma_edge_detection", smaa_edge_detection_pp_);
+			pp_loader.Add("SMAA.ppml", "blending_weight_calculation", smaa_blending_weight_pp_);
 		}
 
 		gamma_enabled_ = settings.gamma;
@@ -214,9 +276,50 @@ namespace KlayGE
 		{
 			for (size_t i = 0; i < 12; ++ i)
 			{
-				post_tone_mapping_pps_[i] = SyncLoadPostProcess("PostToneMapping.ppml", std::format("PostToneMapping{}", i));
+				pp_loader.Add("PostToneMapping.ppml", std::format("PostToneMapping{}", i), post_tone_mapping_pps_[i]);
 			}
+		}
+
+		if (!settings.hide_win)
+		{
+			pp_loader.Add("Resizer.ppml", "bilinear", resize_pps_[0]);
+		}
+
+		// Stereo() and DisplayOutput() below keep these ones instead of loading them again
+		stereo_method_ = settings.stereo_method;
+		display_output_method_ = settings.display_output_method;
+		if (settings.stereo_method != STM_None)
+		{
+			pp_loader.Add("Stereoscopic.ppml", StereoscopicPostProcessName(settings.stereo_method), stereoscopic_pp_);
+		}
+		if (settings.display_output_method != DOM_sRGB)
+		{
+			pp_loader.Add("HDRDisplay.ppml", DisplayOutputPostProcessName(settings.display_output_method), hdr_display_pp_);
+		}
 
+		// These ones load their own post processes synchronously, while the ones above are loading in the background
+		if (settings.hdr)
+		{
+			hdr_pp_ = MakeSharedPtr<HDRPostProcess>(settings.fft_lens_effects);
+		}
+		if (!settings.hide_win)
+		{
+			resize_pps_[1] = MakeSharedPtr<BicubicFilteringPostProcess>();
+		}
+
+		pp_loader.Join();
+
+#ifndef KLAYGE_SHIP
+		for (uint32_t i = 0; i < pp_loader.NumPostProcesses(); ++ i)
+		{
+			LogInfo() << "Post process " << pp_loader.PpmlName(i) << ':' << pp_loader.PostProcessName(i) << " ready in "
+				<< pp_loader.ReadyTime(i) * 1000 << " ms" << std::endl;
+		}
+		LogInfo() << "Startup post processes ready in " << startup_timer_.elapsed() * 1000 << " ms" << std::endl;
+#endif
+
+		if (settings.ppaa || settings.color_grading || settings.gamma)
+		{
 			post_tone_mapping_pp_ = post_tone_mapping_pps_[ppaa_enabled_ * 4 + gamma_enabled_ * 2 + color_grading_enabled_];
 		}
 
@@ -225,9 +328,6 @@ namespace KlayGE
 		{
 			need_resize = ((render_width != screen_width) || (render_height != screen_height));
 
-			resize_pps_[0] = SyncLoadPostProcess("Resizer.ppml", "bilinear");
-			resize_pps_[1] = MakeSharedPtr<BicubicFilteringPostProcess>();
-
 			float const scale_x = static_cast<float>(screen_width) / render_width;
 			float const scale_y = static_cast<float>(screen_height) / render_height;
 
@@ -1062,6 +1162,13 @@ namespace KlayGE
 
 #ifndef KLAYGE_SHIP
 			context.PerfProfilerInstance().CollectData();
+
+			if (!first_frame_reported_)
+			{
+				LogInfo() << "First frame rendered " << startup_timer_.elapsed() * 1000 << " ms after creating the render window"
+					<< std::endl;
+				first_frame_reported_ = true;
+			}
 #endif
 		}
 	}
@@ -1164,53 +1271,11 @@ namespace KlayGE
 
 	void RenderEngine::Stereo(StereoMethod method)
 	{
+		bool const reload = (method != stereo_method_) || !stereoscopic_pp_;
 		stereo_method_ = method;
-		if (stereo_method_ != STM_None)
+		if ((stereo_method_ != STM_None) && reload)
 		{
-			std::string pp_name;
-			switch (stereo_method_)
-			{
-			case STM_ColorAnaglyph_RedCyan:
-				pp_name = "stereoscopic_red_cyan";
-				break;
-
-			case STM_ColorAnaglyph_YellowBlue:
-				pp_name = "stereoscopic_yellow_blue";
-				break;
-
-			case STM_ColorAnaglyph_GreenRed:
-				pp_name = "stereoscopic_green_red";
-				break;
-
-			case STM_HorizontalInterlacing:
-				pp_name = "stereoscopic_hor_interlacing";
-				break;
-
-			case STM_VerticalInterlacing:
-				pp_name = "stereoscopic_ver_interlacing";
-				break;
-
-			case STM_Horizontal:
-				pp_name = "stereoscopic_horizontal";
-				break;
-
-			case STM_Vertical:
-				pp_name = "stereoscopic_vertical";
-				break;
-
-			case STM_LCDShutter:
-				pp_name = "stereoscopic_lcd_shutter";
-				break;
-
-			case STM_OculusVR:
-				pp_name = "stereoscopic_oculus_vr";
-				break;
-
-			default:
-				KFL_UNREACHABLE("Invalid stereo method");
-			}
-
-			stereoscopic_pp_ = SyncLoadPostProcess("Stereoscopic.ppml", pp_name);
+			stereoscopic_pp_ = SyncLoadPostProcess("Stereoscopic.ppml", StereoscopicPostProcessName(stereo_method_));
 		}
 
 		pp_chain_dirty_ = true;
@@ -1218,21 +1283,15 @@ namespace KlayGE
 
 	void RenderEngine::DisplayOutput(DisplayOutputMethod method)
 	{
+		bool const reload = (method != display_output_method_) || !hdr_display_pp_;
 		display_output_method_ = method;
 
 		if (display_output_method_ != DOM_sRGB)
 		{
-			std::string pp_name;
-			switch (display_output_method_)
+			if (reload)
 			{
-			case DOM_HDR10:
-				pp_name = "DisplayHDR10";
-				break;
-
-			default:
-				KFL_UNREACHABLE("Invalid display output method");
+				hdr_display_pp_ = SyncLoadPostProcess("HDRDisplay.ppml", DisplayOutputPostProcessName(display_output_method_));
 			}
-			hdr_display_pp_ = SyncLoadPostProcess("HDRDisplay.ppml", pp_name);
 
 			hdr_enabled_ = true;
 			gamma_enabled_ = false;
@@ -277,7 +277,7 @@ namespace KlayGE
 		{
 			lod = active_lod_;
 		}
-		RenderLayout const & layout = this->GetRenderLayout(lod);
+		RenderLayout const & layout = this->GetRenderLayout(this->StreamLod(lod));
 		GraphicsBufferPtr const & inst_stream = layout.InstanceStream();
 		RenderTechnique const & tech = *this->GetRenderTechnique();
 		auto const & effect = *this->GetRenderEffect();
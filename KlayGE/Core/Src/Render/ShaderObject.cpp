@@ -42,9 +42,11 @@
 #include <KlayGE/RenderEngine.hpp>
 #include <KlayGE/ResLoader.hpp>
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include <map>
+#include <mutex>
 #include <sstream>
 #include <fstream>
 
@@ -151,7 +153,9 @@ namespace
 			}
 			return hr;
 #else
-			std::string mark = std::to_string(reinterpret_cast<uint64_t>(src_data.c_str()));
+			// Shaders can be compiled concurrently, so every call needs its own temporary files
+			static std::atomic<uint32_t> compile_count(0);
+			std::string mark = std::to_string(reinterpret_cast<uint64_t>(src_data.c_str())) + "_" + std::to_string(compile_count++);
 			std::string compile_input_file = entry_point + mark + "Input.tmp";
 			std::string compile_output_file = entry_point + mark + "Output.tmp";
 
@@ -189,15 +193,13 @@ namespace
 #ifdef KLAYGE_PLATFORM_WINDOWS
 			ss << d3dcompiler_wrapper_name << ".exe";
 #else
-			static bool first = true;
-			if (first)
-			{
-				ss << KFL_STRINGIZE(WINE_PATH) << "wineserver -p";
-				[[maybe_unused]] int err = system(ss.str().c_str());
-				// We should hold on a persistant wineserver, or XCode will lost connection after wineserver instance close and wine may not be able to find '.exe.so' file
-				first = false;
-				ss.str(std::string());
-			}
+			static std::once_flag wineserver_flag;
+			std::call_once(wineserver_flag, []
+				{
+					std::string const cmd = std::string(KFL_STRINGIZE(WINE_PATH)) + "wineserver -p";
+					[[maybe_unused]] int err = system(cmd.c_str());
+					// We should hold on a persistant wineserver, or XCode will lost connection after wineserver instance close and wine may not be able to find '.exe.so' file
+				});
 			d3dcompiler_wrapper_name += ".exe.so";
 			std::string wrapper_path = Context::Instance().ResLoaderInstance().Locate(d3dcompiler_wrapper_name);
 			ss << KFL_STRINGIZE(WINE_PATH) << "wine " << wrapper_path;
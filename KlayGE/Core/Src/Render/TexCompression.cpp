@@ -29,6 +29,7 @@
 */
 
 #include <KlayGE/KlayGE.hpp>
+#include <KFL/Thread.hpp>
 #include <KlayGE/Context.hpp>
 #include <KlayGE/RenderFactory.hpp>
 #include <KlayGE/Texture.hpp>
@@ -278,6 +279,61 @@ namespace KlayGE
 	TexCompression::TexCompression() noexcept = default;
 	TexCompression::~TexCompression() noexcept = default;
 
+	void TexCompression::EncodeBlocks(void* output, void const * input, uint32_t num_blocks, TexCompressionMethod method)
+	{
+		uint32_t const in_block_bytes = BlockWidth(compression_format_) * BlockHeight(compression_format_)
+			* NumFormatBytes(DecodedFormat(compression_format_));
+		uint32_t const out_block_bytes = BlockBytes(compression_format_);
+
+		uint8_t* dst = static_cast<uint8_t*>(output);
+		uint8_t const * src = static_cast<uint8_t const *>(input);
+		for (uint32_t i = 0; i < num_blocks; ++ i)
+		{
+			this->EncodeBlock(dst, src, method);
+			dst += out_block_bytes;
+			src += in_block_bytes;
+		}
+	}
+
+	uint32_t TexCompression::NumThreads() const noexcept
+	{
+		return num_threads_;
+	}
+
+	void TexCompression::NumThreads(uint32_t num) noexcept
+	{
+		num_threads_ = num;
+	}
+
+	void TexCompression::ParallelForBlockRows(uint32_t width, uint32_t height,
+		std::function<void(TexCompression& codec, uint32_t row_begin, uint32_t row_end)> const & func)
+	{
+		// Below this a worker costs more to wake up than the blocks it would code
+		uint32_t const MIN_BLOCKS_PER_THREAD = 256;
+
+		uint32_t const block_width = BlockWidth(compression_format_);
+		uint32_t const block_height = BlockHeight(compression_format_);
+		uint32_t const num_block_cols = (width + block_width - 1) / block_width;
+		uint32_t const num_block_rows = (height + block_height - 1) / block_height;
+
+		// Clones are made on the workers, and only when the rows are actually split, so *this is left untouched while they run
+		uint32_t const min_rows_per_task = std::max((MIN_BLOCKS_PER_THREAD + num_block_cols - 1) / std::max(num_block_cols, 1U), 1U);
+		ParallelFor(Context::Instance().ThreadPoolInstance(), num_block_rows, min_rows_per_task,
+			[this, &func, num_block_rows](uint32_t row_begin, uint32_t row_end)
+			{
+				if ((row_begin == 0) && (row_end == num_block_rows))
+				{
+					func(*this, row_begin, row_end);
+				}
+				else
+				{
+					auto codec = this->Clone();
+					func(*codec, row_begin, row_end);
+				}
+			},
+			num_threads_);
+	}
+
 	void TexCompression::EncodeMem(uint32_t width, uint32_t height,
 		void* output, uint32_t out_row_pitch, [[maybe_unused]] uint32_t out_slice_pitch,
 		void const * input, uint32_t in_row_pitch, [[maybe_unused]] uint32_t in_slice_pitch,
@@ -286,39 +342,47 @@ namespace KlayGE
 		uint32_t const elem_size = NumFormatBytes(DecodedFormat(compression_format_));
 		uint32_t const block_width = BlockWidth(compression_format_);
 		uint32_t const block_height = BlockHeight(compression_format_);
-		uint32_t const block_bytes = BlockBytes(compression_format_);
+		uint32_t const in_block_bytes = block_width * block_height * elem_size;
+		uint32_t const num_block_cols = (width + block_width - 1) / block_width;
 
 		uint8_t const * src = static_cast<uint8_t const *>(input);
 
-		std::vector<uint8_t> uncompressed(block_width * block_height * elem_size);
-		for (uint32_t y_base = 0; y_base < height; y_base += block_height)
-		{
-			uint8_t* dst = static_cast<uint8_t*>(output) + (y_base / block_height) * out_row_pitch;
-
-			for (uint32_t x_base = 0; x_base < width; x_base += block_width)
+		this->ParallelForBlockRows(width, height,
+			[=](TexCompression& codec, uint32_t row_begin, uint32_t row_end)
 			{
-				for (uint32_t y = 0; y < block_height; ++ y)
+				// Gathers a whole row of blocks so batch encoders see as many blocks as possible per call
+				std::vector<uint8_t> uncompressed(num_block_cols * in_block_bytes);
+				for (uint32_t y_base = row_begin * block_height; y_base < std::min(row_end * block_height, height);
+					y_base += block_height)
 				{
-					for (uint32_t x = 0; x < block_width; ++ x)
+					uint8_t* block = uncompressed.data();
+					for (uint32_t x_base = 0; x_base < width; x_base += block_width)
 					{
-						if ((x_base + x < width) && (y_base + y < height))
-						{
-							memcpy(&uncompressed[(y * block_width + x) * elem_size],
-								&src[(y_base + y) * in_row_pitch + (x_base + x) * elem_size],
-								elem_size);
-						}
-						else
+						for (uint32_t y = 0; y < block_height; ++ y)
 						{
-							memset(&uncompressed[(y * block_width + x) * elem_size],
-								0, elem_size);
+							for (uint32_t x = 0; x < block_width; ++ x)
+							{
+								if ((x_base + x < width) && (y_base + y < height))
+								{
+									memcpy(&block[(y * block_width + x) * elem_size],
+										&src[(y_base + y) * in_row_pitch + (x_base + x) * elem_size],
+										elem_size);
+								}
+								else
+								{
+									memset(&block[(y * block_width + x) * elem_size],
+										0, elem_size);
+								}
+							}
 						}
+
+						block += in_block_bytes;
 					}
-				}
 
-				this->EncodeBlock(dst, &uncompressed[0], method);
-				dst += block_bytes;
-			}
-		}
+					uint8_t* dst = static_cast<uint8_t*>(output) + (y_base / block_height) * out_row_pitch;
+					codec.EncodeBlocks(dst, uncompressed.data(), num_block_cols, method);
+				}
+			});
 	}
 
 	void TexCompression::DecodeMem(uint32_t width, uint32_t height,
@@ -332,29 +396,34 @@ namespace KlayGE
 
 		uint8_t * dst = static_cast<uint8_t*>(output);
 
-		std::vector<uint8_t> uncompressed(block_width * block_height * elem_size);
-		for (uint32_t y_base = 0; y_base < height; y_base += block_height)
-		{
-			uint8_t const * src = static_cast<uint8_t const *>(input) + in_row_pitch * (y_base / block_height);
-
-			uint32_t const block_h = std::min(block_height, height - y_base);
-			for (uint32_t x_base = 0; x_base < width; x_base += block_width)
+		this->ParallelForBlockRows(width, height,
+			[=](TexCompression& codec, uint32_t row_begin, uint32_t row_end)
 			{
-				uint32_t const block_w = std::min(block_width, width - x_base);
-
-				this->DecodeBlock(&uncompressed[0], src);
-				src += block_bytes;
-
-				for (uint32_t y = 0; y < block_h; ++ y)
+				std::vector<uint8_t> uncompressed(block_width * block_height * elem_size);
+				for (uint32_t y_base = row_begin * block_height; y_base < std::min(row_end * block_height, height);
+					y_base += block_height)
 				{
-					for (uint32_t x = 0; x < block_w; ++ x)
+					uint8_t const * src = static_cast<uint8_t const *>(input) + in_row_pitch * (y_base / block_height);
+
+					uint32_t const block_h = std::min(block_height, height - y_base);
+					for (uint32_t x_base = 0; x_base < width; x_base += block_width)
 					{
-						memcpy(&dst[(y_base + y) * out_row_pitch + (x_base + x) * elem_size],
-							&uncompressed[(y * block_width + x) * elem_size], elem_size);
+						uint32_t const block_w = std::min(block_width, width - x_base);
+
+						codec.DecodeBlock(&uncompressed[0], src);
+						src += block_bytes;
+
+						for (uint32_t y = 0; y < block_h; ++ y)
+						{
+							for (uint32_t x = 0; x < block_w; ++ x)
+							{
+								memcpy(&dst[(y_base + y) * out_row_pitch + (x_base + x) * elem_size],
+									&uncompressed[(y * block_width + x) * elem_size], elem_size);
+							}
+						}
 					}
 				}
-			}
-		}
+			});
 	}
 
 	void TexCompression::EncodeTex(TexturePtr const & out_tex, TexturePtr const & in_tex, TexCompressionMethod method)
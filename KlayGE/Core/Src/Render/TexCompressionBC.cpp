@@ -43,6 +43,12 @@
 #include <vector>
 #include <boost/assert.hpp>
 
+#if defined(KLAYGE_AVX2_SUPPORT)
+#include <immintrin.h>
+#elif defined(KLAYGE_SSE2_SUPPORT)
+#include <emmintrin.h>
+#endif
+
 #include <KlayGE/TexCompressionBC.hpp>
 #include "../Base/TableGen/Tables.hpp"
 
@@ -843,6 +849,537 @@ namespace
 		std::uniform_int_distribution<int> random_dis(0, RAND_MAX);
 		return random_dis(gen);
 	}
+
+#if defined(KLAYGE_AVX2_SUPPORT) || defined(KLAYGE_SSE2_SUPPORT)
+	#define KLAYGE_BC1_BATCH
+
+	// Each lane holds the same pixel of a different block. All integer math in the BC1 encoder stays below 2^24, so it is
+	// exact in float lanes. Float math is done in the same order as the scalar code to keep the output bit-identical.
+#if defined(KLAYGE_AVX2_SUPPORT)
+	using BatchF = __m256;
+	using BatchI = __m256i;
+	uint32_t constexpr BC1_BATCH_SIZE = 8;
+
+	BatchF BatchSet(float v)
+	{
+		return _mm256_set1_ps(v);
+	}
+	BatchF BatchLoad(float const * p)
+	{
+		return _mm256_loadu_ps(p);
+	}
+	void BatchStore(float* p, BatchF v)
+	{
+		_mm256_storeu_ps(p, v);
+	}
+	BatchF BatchAdd(BatchF lhs, BatchF rhs)
+	{
+		return _mm256_add_ps(lhs, rhs);
+	}
+	BatchF BatchSub(BatchF lhs, BatchF rhs)
+	{
+		return _mm256_sub_ps(lhs, rhs);
+	}
+	BatchF BatchMul(BatchF lhs, BatchF rhs)
+	{
+		return _mm256_mul_ps(lhs, rhs);
+	}
+	BatchF BatchDiv(BatchF lhs, BatchF rhs)
+	{
+		return _mm256_div_ps(lhs, rhs);
+	}
+	BatchF BatchMin(BatchF lhs, BatchF rhs)
+	{
+		return _mm256_min_ps(lhs, rhs);
+	}
+	BatchF BatchMax(BatchF lhs, BatchF rhs)
+	{
+		return _mm256_max_ps(lhs, rhs);
+	}
+	BatchF BatchLess(BatchF lhs, BatchF rhs)
+	{
+		return _mm256_cmp_ps(lhs, rhs, _CMP_LT_OQ);
+	}
+	BatchF BatchGreater(BatchF lhs, BatchF rhs)
+	{
+		return _mm256_cmp_ps(lhs, rhs, _CMP_GT_OQ);
+	}
+	BatchF BatchEqual(BatchF lhs, BatchF rhs)
+	{
+		return _mm256_cmp_ps(lhs, rhs, _CMP_EQ_OQ);
+	}
+	// mask ? lhs : rhs
+	BatchF BatchSelect(BatchF mask, BatchF lhs, BatchF rhs)
+	{
+		return _mm256_blendv_ps(rhs, lhs, mask);
+	}
+	BatchF BatchAbs(BatchF v)
+	{
+		return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v);
+	}
+	// Truncates toward zero, like static_cast<int>
+	BatchF BatchTrunc(BatchF v)
+	{
+		return _mm256_cvtepi32_ps(_mm256_cvttps_epi32(v));
+	}
+	BatchI BatchToInt(BatchF v)
+	{
+		return _mm256_cvttps_epi32(v);
+	}
+	BatchF BatchFromInt(BatchI v)
+	{
+		return _mm256_cvtepi32_ps(v);
+	}
+	BatchI BatchLoadInt(uint32_t const * p)
+	{
+		return _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p));
+	}
+	void BatchStoreInt(uint32_t* p, BatchI v)
+	{
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+	}
+	BatchI BatchSetInt(uint32_t v)
+	{
+		return _mm256_set1_epi32(static_cast<int>(v));
+	}
+	BatchI BatchOrInt(BatchI lhs, BatchI rhs)
+	{
+		return _mm256_or_si256(lhs, rhs);
+	}
+	BatchI BatchAndInt(BatchI lhs, BatchI rhs)
+	{
+		return _mm256_and_si256(lhs, rhs);
+	}
+	BatchI BatchShiftLeftInt(BatchI v, int shift)
+	{
+		return _mm256_sll_epi32(v, _mm_cvtsi32_si128(shift));
+	}
+	BatchI BatchShiftRightInt(BatchI v, int shift)
+	{
+		return _mm256_srl_epi32(v, _mm_cvtsi32_si128(shift));
+	}
+#else
+	using BatchF = __m128;
+	using BatchI = __m128i;
+	uint32_t constexpr BC1_BATCH_SIZE = 4;
+
+	BatchF BatchSet(float v)
+	{
+		return _mm_set1_ps(v);
+	}
+	BatchF BatchLoad(float const * p)
+	{
+		return _mm_loadu_ps(p);
+	}
+	void BatchStore(float* p, BatchF v)
+	{
+		_mm_storeu_ps(p, v);
+	}
+	BatchF BatchAdd(BatchF lhs, BatchF rhs)
+	{
+		return _mm_add_ps(lhs, rhs);
+	}
+	BatchF BatchSub(BatchF lhs, BatchF rhs)
+	{
+		return _mm_sub_ps(lhs, rhs);
+	}
+	BatchF BatchMul(BatchF lhs, BatchF rhs)
+	{
+		return _mm_mul_ps(lhs, rhs);
+	}
+	BatchF BatchDiv(BatchF lhs, BatchF rhs)
+	{
+		return _mm_div_ps(lhs, rhs);
+	}
+	BatchF BatchMin(BatchF lhs, BatchF rhs)
+	{
+		return _mm_min_ps(lhs, rhs);
+	}
+	BatchF BatchMax(BatchF lhs, BatchF rhs)
+	{
+		return _mm_max_ps(lhs, rhs);
+	}
+	BatchF BatchLess(BatchF lhs, BatchF rhs)
+	{
+		return _mm_cmplt_ps(lhs, rhs);
+	}
+	BatchF BatchGreater(BatchF lhs, BatchF rhs)
+	{
+		return _mm_cmpgt_ps(lhs, rhs);
+	}
+	BatchF BatchEqual(BatchF lhs, BatchF rhs)
+	{
+		return _mm_cmpeq_ps(lhs, rhs);
+	}
+	// mask ? lhs : rhs
+	BatchF BatchSelect(BatchF mask, BatchF lhs, BatchF rhs)
+	{
+		return _mm_or_ps(_mm_and_ps(mask, lhs), _mm_andnot_ps(mask, rhs));
+	}
+	BatchF BatchAbs(BatchF v)
+	{
+		return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+	}
+	// Truncates toward zero, like static_cast<int>
+	BatchF BatchTrunc(BatchF v)
+	{
+		return _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+	}
+	BatchI BatchToInt(BatchF v)
+	{
+		return _mm_cvttps_epi32(v);
+	}
+	BatchF BatchFromInt(BatchI v)
+	{
+		return _mm_cvtepi32_ps(v);
+	}
+	BatchI BatchLoadInt(uint32_t const * p)
+	{
+		return _mm_loadu_si128(reinterpret_cast<__m128i const *>(p));
+	}
+	void BatchStoreInt(uint32_t* p, BatchI v)
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+	}
+	BatchI BatchSetInt(uint32_t v)
+	{
+		return _mm_set1_epi32(static_cast<int>(v));
+	}
+	BatchI BatchOrInt(BatchI lhs, BatchI rhs)
+	{
+		return _mm_or_si128(lhs, rhs);
+	}
+	BatchI BatchAndInt(BatchI lhs, BatchI rhs)
+	{
+		return _mm_and_si128(lhs, rhs);
+	}
+	BatchI BatchShiftLeftInt(BatchI v, int shift)
+	{
+		return _mm_sll_epi32(v, _mm_cvtsi32_si128(shift));
+	}
+	BatchI BatchShiftRightInt(BatchI v, int shift)
+	{
+		return _mm_srl_epi32(v, _mm_cvtsi32_si128(shift));
+	}
+#endif
+
+	// Structure-of-arrays view of BC1_BATCH_SIZE blocks. channel[i * BC1_BATCH_SIZE + lane] is pixel i of block lane.
+	struct BC1BlockBatch
+	{
+		std::array<float, 16 * BC1_BATCH_SIZE> r;
+		std::array<float, 16 * BC1_BATCH_SIZE> g;
+		std::array<float, 16 * BC1_BATCH_SIZE> b;
+		std::array<float, 16 * BC1_BATCH_SIZE> a;
+
+		explicit BC1BlockBatch(ARGBColor32 const * argb)
+		{
+			for (uint32_t lane = 0; lane < BC1_BATCH_SIZE; ++ lane)
+			{
+				for (uint32_t i = 0; i < 16; ++ i)
+				{
+					ARGBColor32 const & pixel = argb[lane * 16 + i];
+					r[i * BC1_BATCH_SIZE + lane] = pixel.r();
+					g[i * BC1_BATCH_SIZE + lane] = pixel.g();
+					b[i * BC1_BATCH_SIZE + lane] = pixel.b();
+					a[i * BC1_BATCH_SIZE + lane] = pixel.a();
+				}
+			}
+		}
+
+		BatchF R(uint32_t i) const
+		{
+			return BatchLoad(&r[i * BC1_BATCH_SIZE]);
+		}
+		BatchF G(uint32_t i) const
+		{
+			return BatchLoad(&g[i * BC1_BATCH_SIZE]);
+		}
+		BatchF B(uint32_t i) const
+		{
+			return BatchLoad(&b[i * BC1_BATCH_SIZE]);
+		}
+		BatchF A(uint32_t i) const
+		{
+			return BatchLoad(&a[i * BC1_BATCH_SIZE]);
+		}
+	};
+
+	// Batch version of TexCompressionBC1::OptimizeColorsBlock
+	void OptimizeColorsBatch(BC1BlockBatch const & batch, ARGBColor32 const * argb,
+		std::array<ARGBColor32, BC1_BATCH_SIZE>& min_clr, std::array<ARGBColor32, BC1_BATCH_SIZE>& max_clr,
+		TexCompressionMethod method)
+	{
+		BatchF min_index = BatchSet(0);
+		BatchF max_index = BatchSet(0);
+		if (method != TCM_Quality)
+		{
+			// Same evaluation order as MathLib::dot(Color(argb.ARGB()), LUM_WEIGHT)
+			BatchF const rcp = BatchSet(1 / 255.0f);
+			auto luminance = [&batch, rcp](uint32_t i)
+			{
+				BatchF const r = BatchMul(rcp, batch.R(i));
+				BatchF const g = BatchMul(rcp, batch.G(i));
+				BatchF const b = BatchMul(rcp, batch.B(i));
+				BatchF const a = BatchMul(rcp, batch.A(i));
+				return BatchAdd(BatchMul(r, BatchSet(0.2126f)),
+					BatchAdd(BatchMul(g, BatchSet(0.7152f)), BatchAdd(BatchMul(b, BatchSet(0.0722f)), BatchMul(a, BatchSet(0)))));
+			};
+
+			BatchF min_lum = luminance(0);
+			BatchF max_lum = min_lum;
+			for (uint32_t i = 1; i < 16; ++ i)
+			{
+				BatchF const lum = luminance(i);
+				BatchF const index = BatchSet(static_cast<float>(i));
+
+				BatchF const less = BatchLess(lum, min_lum);
+				min_lum = BatchSelect(less, lum, min_lum);
+				min_index = BatchSelect(less, index, min_index);
+
+				BatchF const greater = BatchGreater(lum, max_lum);
+				max_lum = BatchSelect(greater, lum, max_lum);
+				max_index = BatchSelect(greater, index, max_index);
+			}
+		}
+		else
+		{
+			static int const ITER_POWER = 4;
+
+			// determine color distribution
+			BatchF sum_r = batch.R(0);
+			BatchF sum_g = batch.G(0);
+			BatchF sum_b = batch.B(0);
+			BatchF min_r = sum_r, max_r = sum_r;
+			BatchF min_g = sum_g, max_g = sum_g;
+			BatchF min_b = sum_b, max_b = sum_b;
+			for (uint32_t i = 1; i < 16; ++ i)
+			{
+				BatchF const r = batch.R(i);
+				BatchF const g = batch.G(i);
+				BatchF const b = batch.B(i);
+				sum_r = BatchAdd(sum_r, r);
+				sum_g = BatchAdd(sum_g, g);
+				sum_b = BatchAdd(sum_b, b);
+				min_r = BatchMin(min_r, r);
+				min_g = BatchMin(min_g, g);
+				min_b = BatchMin(min_b, b);
+				max_r = BatchMax(max_r, r);
+				max_g = BatchMax(max_g, g);
+				max_b = BatchMax(max_b, b);
+			}
+
+			// (sum + 8) >> 4, the sums are non-negative
+			BatchF const mu_r = BatchTrunc(BatchMul(BatchAdd(sum_r, BatchSet(8)), BatchSet(1 / 16.0f)));
+			BatchF const mu_g = BatchTrunc(BatchMul(BatchAdd(sum_g, BatchSet(8)), BatchSet(1 / 16.0f)));
+			BatchF const mu_b = BatchTrunc(BatchMul(BatchAdd(sum_b, BatchSet(8)), BatchSet(1 / 16.0f)));
+
+			// determine covariance matrix
+			std::array<BatchF, 6> cov;
+			cov.fill(BatchSet(0));
+			for (uint32_t i = 0; i < 16; ++ i)
+			{
+				BatchF const r = BatchSub(batch.R(i), mu_r);
+				BatchF const g = BatchSub(batch.G(i), mu_g);
+				BatchF const b = BatchSub(batch.B(i), mu_b);
+
+				cov[0] = BatchAdd(cov[0], BatchMul(r, r));
+				cov[1] = BatchAdd(cov[1], BatchMul(r, g));
+				cov[2] = BatchAdd(cov[2], BatchMul(r, b));
+				cov[3] = BatchAdd(cov[3], BatchMul(g, g));
+				cov[4] = BatchAdd(cov[4], BatchMul(g, b));
+				cov[5] = BatchAdd(cov[5], BatchMul(b, b));
+			}
+
+			// convert covariance matrix to float, find principal axis via power iter
+			for (auto& c : cov)
+			{
+				c = BatchDiv(c, BatchSet(255.0f));
+			}
+
+			BatchF vfr = BatchSub(max_r, min_r);
+			BatchF vfg = BatchSub(max_g, min_g);
+			BatchF vfb = BatchSub(max_b, min_b);
+			for (int iter = 0; iter < ITER_POWER; ++ iter)
+			{
+				BatchF const r = BatchAdd(BatchAdd(BatchMul(vfr, cov[0]), BatchMul(vfg, cov[1])), BatchMul(vfb, cov[2]));
+				BatchF const g = BatchAdd(BatchAdd(BatchMul(vfr, cov[1]), BatchMul(vfg, cov[3])), BatchMul(vfb, cov[4]));
+				BatchF const b = BatchAdd(BatchAdd(BatchMul(vfr, cov[2]), BatchMul(vfg, cov[4])), BatchMul(vfb, cov[5]));
+
+				vfr = r;
+				vfg = g;
+				vfb = b;
+			}
+
+			BatchF const magn = BatchMax(BatchMax(BatchAbs(vfr), BatchAbs(vfg)), BatchAbs(vfb));
+			BatchF const too_small = BatchLess(magn, BatchSet(4.0f)); // default to luminance
+			BatchF const scale = BatchDiv(BatchSet(512.0f), magn);
+			BatchF const v_r = BatchSelect(too_small, BatchSet(148), BatchTrunc(BatchMul(vfr, scale)));
+			BatchF const v_g = BatchSelect(too_small, BatchSet(300), BatchTrunc(BatchMul(vfg, scale)));
+			BatchF const v_b = BatchSelect(too_small, BatchSet(58), BatchTrunc(BatchMul(vfb, scale)));
+
+			// Pick colors at extreme points
+			BatchF min_d = BatchSet(std::numeric_limits<float>::max());
+			BatchF max_d = BatchSet(std::numeric_limits<float>::lowest());
+			for (uint32_t i = 0; i < 16; ++ i)
+			{
+				BatchF const dot = BatchAdd(BatchAdd(BatchMul(batch.R(i), v_r), BatchMul(batch.G(i), v_g)), BatchMul(batch.B(i), v_b));
+				BatchF const index = BatchSet(static_cast<float>(i));
+
+				BatchF const less = BatchLess(dot, min_d);
+				min_d = BatchSelect(less, dot, min_d);
+				min_index = BatchSelect(less, index, min_index);
+
+				BatchF const greater = BatchGreater(dot, max_d);
+				max_d = BatchSelect(greater, dot, max_d);
+				max_index = BatchSelect(greater, index, max_index);
+			}
+		}
+
+		std::array<float, BC1_BATCH_SIZE> min_indices;
+		std::array<float, BC1_BATCH_SIZE> max_indices;
+		BatchStore(min_indices.data(), min_index);
+		BatchStore(max_indices.data(), max_index);
+		for (uint32_t lane = 0; lane < BC1_BATCH_SIZE; ++ lane)
+		{
+			min_clr[lane] = argb[lane * 16 + static_cast<uint32_t>(min_indices[lane])];
+			max_clr[lane] = argb[lane * 16 + static_cast<uint32_t>(max_indices[lane])];
+		}
+	}
+
+	// Batch version of TexCompressionBC1::MatchColorsBlock
+	void MatchColorsBatch(BC1BlockBatch const & batch, std::array<ARGBColor32, BC1_BATCH_SIZE> const & min_clr,
+		std::array<ARGBColor32, BC1_BATCH_SIZE> const & max_clr, bool const * alpha, std::array<uint32_t, BC1_BATCH_SIZE>& mask)
+	{
+		// The stops involve integer divisions, they are set up per block as the scalar code does
+		std::array<float, BC1_BATCH_SIZE> dir_r, dir_g, dir_b;
+		std::array<float, BC1_BATCH_SIZE> c0_points, half_points, c3_points;
+		std::array<float, BC1_BATCH_SIZE> alpha_lanes;
+		for (uint32_t lane = 0; lane < BC1_BATCH_SIZE; ++ lane)
+		{
+			std::array<ARGBColor32, 4> color;
+			color[0] = max_clr[lane];
+			color[1] = min_clr[lane];
+
+			int const dirr = color[0].r() - color[1].r();
+			int const dirg = color[0].g() - color[1].g();
+			int const dirb = color[0].b() - color[1].b();
+
+			if (alpha[lane])
+			{
+				std::array<int, 2> stops;
+				for (int i = 0; i < 2; ++ i)
+				{
+					stops[i] = color[i].r() * dirr + color[i].g() * dirg + color[i].b() * dirb;
+				}
+
+				c0_points[lane] = static_cast<float>((stops[0] + stops[1] * 2) / 3);
+				half_points[lane] = 0;
+				c3_points[lane] = static_cast<float>((stops[0] * 2 + stops[1]) / 3);
+			}
+			else
+			{
+				color[2].r() = (color[0].r() * 2 + color[1].r()) / 3;
+				color[2].g() = (color[0].g() * 2 + color[1].g()) / 3;
+				color[2].b() = (color[0].b() * 2 + color[1].b()) / 3;
+				color[3].r() = (color[0].r() + color[1].r() * 2) / 3;
+				color[3].g() = (color[0].g() + color[1].g() * 2) / 3;
+				color[3].b() = (color[0].b() + color[1].b() * 2) / 3;
+
+				std::array<int, 4> stops;
+				for (int i = 0; i < 4; ++ i)
+				{
+					stops[i] = color[i].r() * dirr + color[i].g() * dirg + color[i].b() * dirb;
+				}
+
+				c0_points[lane] = static_cast<float>((stops[1] + stops[3]) >> 1);
+				half_points[lane] = static_cast<float>((stops[3] + stops[2]) >> 1);
+				c3_points[lane] = static_cast<float>((stops[2] + stops[0]) >> 1);
+			}
+
+			dir_r[lane] = static_cast<float>(dirr);
+			dir_g[lane] = static_cast<float>(dirg);
+			dir_b[lane] = static_cast<float>(dirb);
+			alpha_lanes[lane] = alpha[lane] ? 1.0f : 0.0f;
+		}
+
+		BatchF const dr = BatchLoad(dir_r.data());
+		BatchF const dg = BatchLoad(dir_g.data());
+		BatchF const db = BatchLoad(dir_b.data());
+		BatchF const c0_point = BatchLoad(c0_points.data());
+		BatchF const half_point = BatchLoad(half_points.data());
+		BatchF const c3_point = BatchLoad(c3_points.data());
+		BatchF const alpha_lane = BatchGreater(BatchLoad(alpha_lanes.data()), BatchSet(0.5f));
+
+		BatchI mask_v = BatchSetInt(0);
+		for (int i = 15; i >= 0; -- i)
+		{
+			BatchF const dot = BatchAdd(BatchAdd(BatchMul(batch.R(i), dr), BatchMul(batch.G(i), dg)), BatchMul(batch.B(i), db));
+			BatchF const below_c0 = BatchLess(dot, c0_point);
+			BatchF const below_c3 = BatchLess(dot, c3_point);
+
+			BatchF const opaque_code = BatchSelect(BatchLess(dot, half_point),
+				BatchSelect(below_c0, BatchSet(1), BatchSet(3)),
+				BatchSelect(below_c3, BatchSet(2), BatchSet(0)));
+			BatchF const alpha_code = BatchSelect(BatchEqual(batch.A(i), BatchSet(0)), BatchSet(3),
+				BatchSelect(below_c0, BatchSet(0), BatchSelect(below_c3, BatchSet(2), BatchSet(1))));
+
+			mask_v = BatchOrInt(BatchShiftLeftInt(mask_v, 2), BatchToInt(BatchSelect(alpha_lane, alpha_code, opaque_code)));
+		}
+
+		BatchStoreInt(mask.data(), mask_v);
+	}
+
+	// The accumulating loop of TexCompressionBC1::RefineBlock
+	void AccumulateRefineBatch(BC1BlockBatch const & batch, std::array<uint32_t, BC1_BATCH_SIZE> const & mask,
+		std::array<int, BC1_BATCH_SIZE>& akku, std::array<int3, BC1_BATCH_SIZE>& at1, std::array<int3, BC1_BATCH_SIZE>& at2)
+	{
+		// w1Tab = { 3, 0, 2, 1 }, prods = { 0x090000, 0x000900, 0x040102, 0x010402 }
+		BatchI const mask_v = BatchLoadInt(mask.data());
+
+		BatchF akku_v = BatchSet(0);
+		BatchF at1_r = BatchSet(0), at1_g = BatchSet(0), at1_b = BatchSet(0);
+		BatchF at2_r = BatchSet(0), at2_g = BatchSet(0), at2_b = BatchSet(0);
+		for (uint32_t i = 0; i < 16; ++ i)
+		{
+			BatchF const step = BatchFromInt(BatchAndInt(BatchShiftRightInt(mask_v, i * 2), BatchSetInt(3)));
+			BatchF const step0 = BatchEqual(step, BatchSet(0));
+			BatchF const step1 = BatchEqual(step, BatchSet(1));
+			BatchF const step2 = BatchEqual(step, BatchSet(2));
+
+			BatchF const w1 = BatchSelect(step0, BatchSet(3),
+				BatchSelect(step1, BatchSet(0), BatchSelect(step2, BatchSet(2), BatchSet(1))));
+			BatchF const prod = BatchSelect(step0, BatchSet(0x090000),
+				BatchSelect(step1, BatchSet(0x000900), BatchSelect(step2, BatchSet(0x040102), BatchSet(0x010402))));
+
+			BatchF const r = batch.R(i);
+			BatchF const g = batch.G(i);
+			BatchF const b = batch.B(i);
+
+			akku_v = BatchAdd(akku_v, prod);
+			at1_r = BatchAdd(at1_r, BatchMul(w1, r));
+			at1_g = BatchAdd(at1_g, BatchMul(w1, g));
+			at1_b = BatchAdd(at1_b, BatchMul(w1, b));
+			at2_r = BatchAdd(at2_r, r);
+			at2_g = BatchAdd(at2_g, g);
+			at2_b = BatchAdd(at2_b, b);
+		}
+
+		std::array<std::array<float, BC1_BATCH_SIZE>, 7> sums;
+		BatchStore(sums[0].data(), akku_v);
+		BatchStore(sums[1].data(), at1_r);
+		BatchStore(sums[2].data(), at1_g);
+		BatchStore(sums[3].data(), at1_b);
+		BatchStore(sums[4].data(), at2_r);
+		BatchStore(sums[5].data(), at2_g);
+		BatchStore(sums[6].data(), at2_b);
+		for (uint32_t lane = 0; lane < BC1_BATCH_SIZE; ++ lane)
+		{
+			akku[lane] = static_cast<int>(sums[0][lane]);
+			at1[lane] = int3(static_cast<int>(sums[1][lane]), static_cast<int>(sums[2][lane]), static_cast<int>(sums[3][lane]));
+			at2[lane] = int3(static_cast<int>(sums[4][lane]), static_cast<int>(sums[5][lane]), static_cast<int>(sums[6][lane]));
+		}
+	}
+#endif
 }
 
 namespace KlayGE
@@ -854,6 +1391,11 @@ namespace KlayGE
 		compression_format_ = EF_BC1;
 	}
 
+	std::unique_ptr<TexCompression> TexCompressionBC1::Clone() const
+	{
+		return MakeUniquePtr<TexCompressionBC1>();
+	}
+
 	void TexCompressionBC1::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
 	{
 		BOOST_ASSERT(output);
@@ -880,6 +1422,38 @@ namespace KlayGE
 		this->EncodeBC1Internal(bc1, &tmp_argb[0], alpha, method);
 	}
 
+	void TexCompressionBC1::EncodeBlocks(void* output, void const * input, uint32_t num_blocks, TexCompressionMethod method)
+	{
+		BOOST_ASSERT(output);
+		BOOST_ASSERT(input);
+
+		BC1Block* bc1 = static_cast<BC1Block*>(output);
+		ARGBColor32 const * argb = static_cast<ARGBColor32 const *>(input);
+
+		std::vector<ARGBColor32> tmp_argb(num_blocks * 16);
+		std::vector<BC1Block*> bc1_blocks(num_blocks);
+		auto alpha = MakeUniquePtr<bool[]>(num_blocks);
+		for (uint32_t block = 0; block < num_blocks; ++ block)
+		{
+			for (uint32_t i = 0; i < 16; ++ i)
+			{
+				if (argb[block * 16 + i].a() < 0x80)
+				{
+					tmp_argb[block * 16 + i] = ARGBColor32(0, 0, 0, 0);
+					alpha[block] = true;
+				}
+				else
+				{
+					tmp_argb[block * 16 + i] = argb[block * 16 + i];
+				}
+			}
+
+			bc1_blocks[block] = &bc1[block];
+		}
+
+		this->EncodeBC1InternalBatch(bc1_blocks.data(), tmp_argb.data(), alpha.get(), num_blocks, method);
+	}
+
 	void TexCompressionBC1::DecodeBlock(void* output, void const * input)
 	{
 		BOOST_ASSERT(output);
@@ -1186,9 +1760,18 @@ namespace KlayGE
 			At2_b += b;
 		}
 
-		At2_r = 3 * At2_r - At1_r;
-		At2_g = 3 * At2_g - At1_g;
-		At2_b = 3 * At2_b - At1_b;
+		return this->SolveRefinedColors(akku, int3(At1_r, At1_g, At1_b), int3(At2_r, At2_g, At2_b), min_clr, max_clr);
+	}
+
+	bool TexCompressionBC1::SolveRefinedColors(int akku, int3 const & at1, int3 const & at2,
+			ARGBColor32& min_clr, ARGBColor32& max_clr) const
+	{
+		int const At1_r = at1.x();
+		int const At1_g = at1.y();
+		int const At1_b = at1.z();
+		int const At2_r = 3 * at2.x() - At1_r;
+		int const At2_g = 3 * at2.y() - At1_g;
+		int const At2_b = 3 * at2.z() - At1_b;
 
 		// extract solutions and decide solvability
 		int xx = akku >> 16;
@@ -1298,6 +1881,11 @@ namespace KlayGE
 			}
 		}
 
+		this->PackBC1Block(bc1, mask, max16, min16, alpha);
+	}
+
+	void TexCompressionBC1::PackBC1Block(BC1Block& bc1, uint32_t mask, uint16_t max16, uint16_t min16, bool alpha) const
+	{
 		if (alpha)
 		{
 			if (max16 < min16)
@@ -1335,12 +1923,132 @@ namespace KlayGE
 		std::memcpy(bc1.bitmap, &mask, sizeof(mask));
 	}
 
+	void TexCompressionBC1::EncodeBC1InternalBatch(BC1Block* const * bc1, ARGBColor32 const * argb, bool const * alpha,
+			uint32_t num_blocks, TexCompressionMethod method) const
+	{
+		BOOST_ASSERT(bc1);
+		BOOST_ASSERT(argb);
+		BOOST_ASSERT(alpha);
+
+		uint32_t block = 0;
+#ifdef KLAYGE_BC1_BATCH
+		for (; block + BC1_BATCH_SIZE <= num_blocks; block += BC1_BATCH_SIZE)
+		{
+			ARGBColor32 const * batch_argb = argb + block * 16;
+			bool const * batch_alpha = alpha + block;
+
+			// Constant blocks are table lookups, leaves them to the scalar path
+			std::array<bool, BC1_BATCH_SIZE> constant;
+			bool any_varying = false;
+			for (uint32_t lane = 0; lane < BC1_BATCH_SIZE; ++ lane)
+			{
+				ARGBColor32 const * lane_argb = batch_argb + lane * 16;
+				uint32_t min32, max32;
+				min32 = max32 = lane_argb[0].ARGB();
+				for (int i = 1; i < 16; ++ i)
+				{
+					min32 = std::min(min32, lane_argb[i].ARGB());
+					max32 = std::max(max32, lane_argb[i].ARGB());
+				}
+
+				constant[lane] = (min32 == max32);
+				if (constant[lane])
+				{
+					this->EncodeBC1Internal(*bc1[block + lane], lane_argb, batch_alpha[lane], method);
+				}
+				else
+				{
+					any_varying = true;
+				}
+			}
+			if (!any_varying)
+			{
+				continue;
+			}
+
+			BC1BlockBatch const batch(batch_argb);
+
+			std::array<ARGBColor32, BC1_BATCH_SIZE> min_clr, max_clr;
+			OptimizeColorsBatch(batch, batch_argb, min_clr, max_clr, method);
+
+			std::array<uint16_t, BC1_BATCH_SIZE> max16, min16;
+			for (uint32_t lane = 0; lane < BC1_BATCH_SIZE; ++ lane)
+			{
+				max16[lane] = this->RGB888To565(max_clr[lane]);
+				min16[lane] = this->RGB888To565(min_clr[lane]);
+			}
+
+			std::array<uint32_t, BC1_BATCH_SIZE> mask;
+			MatchColorsBatch(batch, min_clr, max_clr, batch_alpha, mask);
+			for (uint32_t lane = 0; lane < BC1_BATCH_SIZE; ++ lane)
+			{
+				if (max16[lane] == min16[lane])
+				{
+					mask[lane] = 0;
+				}
+			}
+
+			if (method != TCM_Speed)
+			{
+				std::array<int, BC1_BATCH_SIZE> akku;
+				std::array<int3, BC1_BATCH_SIZE> at1, at2;
+				AccumulateRefineBatch(batch, mask, akku, at1, at2);
+
+				std::array<bool, BC1_BATCH_SIZE> refined;
+				bool any_refined = false;
+				for (uint32_t lane = 0; lane < BC1_BATCH_SIZE; ++ lane)
+				{
+					refined[lane] = !constant[lane] && !batch_alpha[lane]
+						&& this->SolveRefinedColors(akku[lane], at1[lane], at2[lane], min_clr[lane], max_clr[lane]);
+					if (refined[lane])
+					{
+						max16[lane] = this->RGB888To565(max_clr[lane]);
+						min16[lane] = this->RGB888To565(min_clr[lane]);
+						any_refined = true;
+					}
+				}
+
+				if (any_refined)
+				{
+					std::array<uint32_t, BC1_BATCH_SIZE> refined_mask;
+					MatchColorsBatch(batch, min_clr, max_clr, batch_alpha, refined_mask);
+					for (uint32_t lane = 0; lane < BC1_BATCH_SIZE; ++ lane)
+					{
+						if (refined[lane])
+						{
+							mask[lane] = (max16[lane] != min16[lane]) ? refined_mask[lane] : 0;
+						}
+					}
+				}
+			}
+
+			for (uint32_t lane = 0; lane < BC1_BATCH_SIZE; ++ lane)
+			{
+				if (!constant[lane])
+				{
+					this->PackBC1Block(*bc1[block + lane], mask[lane], max16[lane], min16[lane], batch_alpha[lane]);
+				}
+			}
+		}
+#endif
+
+		for (; block < num_blocks; ++ block)
+		{
+			this->EncodeBC1Internal(*bc1[block], argb + block * 16, alpha[block], method);
+		}
+	}
+
 
 	TexCompressionBC2::TexCompressionBC2()
 	{
 		compression_format_ = EF_BC2;
 	}
 
+	std::unique_ptr<TexCompression> TexCompressionBC2::Clone() const
+	{
+		return MakeUniquePtr<TexCompressionBC2>();
+	}
+
 	void TexCompressionBC2::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
 	{
 		BOOST_ASSERT(output);
@@ -1367,6 +2075,37 @@ namespace KlayGE
 		}
 	}
 
+	void TexCompressionBC2::EncodeBlocks(void* output, void const * input, uint32_t num_blocks, TexCompressionMethod method)
+	{
+		BOOST_ASSERT(output);
+		BOOST_ASSERT(input);
+
+		BC2Block* bc2 = static_cast<BC2Block*>(output);
+		ARGBColor32 const * argb = static_cast<ARGBColor32 const *>(input);
+
+		std::vector<ARGBColor32> xrgb(num_blocks * 16);
+		std::vector<BC1Block*> bc1_blocks(num_blocks);
+		auto const alpha = MakeUniquePtr<bool[]>(num_blocks);
+		for (uint32_t block = 0; block < num_blocks; ++ block)
+		{
+			ARGBColor32 const * block_argb = argb + block * 16;
+			for (uint32_t i = 0; i < 16; ++ i)
+			{
+				xrgb[block * 16 + i] = block_argb[i];
+				xrgb[block * 16 + i].a() = 255;
+			}
+			for (int i = 0; i < 4; ++ i)
+			{
+				bc2[block].alpha[i] = ((block_argb[i * 4 + 0].a() >> 4) << 0) | ((block_argb[i * 4 + 1].a() >> 4) << 4)
+					| ((block_argb[i * 4 + 2].a() >> 4) << 8) | ((block_argb[i * 4 + 3].a() >> 4) << 12);
+			}
+
+			bc1_blocks[block] = &bc2[block].bc1;
+		}
+
+		bc1_codec_.EncodeBC1InternalBatch(bc1_blocks.data(), xrgb.data(), alpha.get(), num_blocks, method);
+	}
+
 	void TexCompressionBC2::DecodeBlock(void* output, void const * input)
 	{
 		BOOST_ASSERT(output);
@@ -1392,6 +2131,11 @@ namespace KlayGE
 		compression_format_ = EF_BC3;
 	}
 
+	std::unique_ptr<TexCompression> TexCompressionBC3::Clone() const
+	{
+		return MakeUniquePtr<TexCompressionBC3>();
+	}
+
 	void TexCompressionBC3::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
 	{
 		BOOST_ASSERT(output);
@@ -1413,6 +2157,34 @@ namespace KlayGE
 		bc4_codec_.EncodeBlock(&bc3.alpha, &alpha[0], method);
 	}
 
+	void TexCompressionBC3::EncodeBlocks(void* output, void const * input, uint32_t num_blocks, TexCompressionMethod method)
+	{
+		BOOST_ASSERT(output);
+		BOOST_ASSERT(input);
+
+		BC3Block* bc3 = static_cast<BC3Block*>(output);
+		ARGBColor32 const * argb = static_cast<ARGBColor32 const *>(input);
+
+		std::vector<ARGBColor32> xrgb(num_blocks * 16);
+		std::vector<BC1Block*> bc1_blocks(num_blocks);
+		auto const alpha = MakeUniquePtr<bool[]>(num_blocks);
+		for (uint32_t block = 0; block < num_blocks; ++ block)
+		{
+			std::array<uint8_t, 16> block_alpha;
+			for (uint32_t i = 0; i < 16; ++ i)
+			{
+				xrgb[block * 16 + i] = argb[block * 16 + i];
+				xrgb[block * 16 + i].a() = 255;
+				block_alpha[i] = argb[block * 16 + i].a();
+			}
+			bc4_codec_.EncodeBlock(&bc3[block].alpha, &block_alpha[0], method);
+
+			bc1_blocks[block] = &bc3[block].bc1;
+		}
+
+		bc1_codec_.EncodeBC1InternalBatch(bc1_blocks.data(), xrgb.data(), alpha.get(), num_blocks, method);
+	}
+
 	void TexCompressionBC3::DecodeBlock(void* output, void const * input)
 	{
 		BOOST_ASSERT(output);
@@ -1438,6 +2210,11 @@ namespace KlayGE
 		compression_format_ = EF_BC4;
 	}
 
+	std::unique_ptr<TexCompression> TexCompressionBC4::Clone() const
+	{
+		return MakeUniquePtr<TexCompressionBC4>();
+	}
+
 	// Alpha block compression (this is easy for a change)
 	void TexCompressionBC4::EncodeBlock(void* output, void const * input, [[maybe_unused]] TexCompressionMethod method)
 	{
@@ -1542,6 +2319,11 @@ namespace KlayGE
 		compression_format_ = EF_BC5;
 	}
 
+	std::unique_ptr<TexCompression> TexCompressionBC5::Clone() const
+	{
+		return MakeUniquePtr<TexCompressionBC5>();
+	}
+
 	void TexCompressionBC5::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
 	{
 		BOOST_ASSERT(output);
@@ -1842,6 +2624,11 @@ namespace KlayGE
 		compression_format_ = EF_BC6;
 	}
 
+	std::unique_ptr<TexCompression> TexCompressionBC6U::Clone() const
+	{
+		return MakeUniquePtr<TexCompressionBC6U>();
+	}
+
 	void TexCompressionBC6U::EncodeBlock(
 		[[maybe_unused]] void* output, [[maybe_unused]] void const* input, [[maybe_unused]] TexCompressionMethod method)
 	{
@@ -2090,6 +2877,11 @@ namespace KlayGE
 		compression_format_ = EF_SIGNED_BC6;
 	}
 
+	std::unique_ptr<TexCompression> TexCompressionBC6S::Clone() const
+	{
+		return MakeUniquePtr<TexCompressionBC6S>();
+	}
+
 	void TexCompressionBC6S::EncodeBlock(
 		[[maybe_unused]] void* output, [[maybe_unused]] void const* input, [[maybe_unused]] TexCompressionMethod method)
 	{
@@ -2129,6 +2921,11 @@ namespace KlayGE
 		compression_format_ = EF_BC7;
 	}
 
+	std::unique_ptr<TexCompression> TexCompressionBC7::Clone() const
+	{
+		return MakeUniquePtr<TexCompressionBC7>();
+	}
+
 	void TexCompressionBC7::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
 	{
 		BOOST_ASSERT(output);
@@ -41,7 +41,10 @@
 #include <KlayGE/DevHelper.hpp>
 #include <KFL/Half.hpp>
 #include <KFL/Hash.hpp>
+#include <KFL/Thread.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
@@ -49,6 +52,12 @@
 #include <mutex>
 #include <system_error>
 
+#if defined(KLAYGE_SSE2_SUPPORT)
+#include <emmintrin.h>
+#elif defined(KLAYGE_NEON_SUPPORT) && defined(KLAYGE_CPU_ARM64)
+#include <arm_neon.h>
+#endif
+
 #include <KlayGE/Texture.hpp>
 
 namespace
@@ -1070,6 +1079,10 @@ namespace
 	}
 
 
+	std::span<uint8_t const> ReadDdsFile(ResIdentifierPtr const & tex_res, Texture::TextureType& type,
+		uint32_t& width, uint32_t& height, uint32_t& depth, uint32_t& num_mipmaps, uint32_t& array_size,
+		ElementFormat& format, std::vector<ElementInitData>& init_data, std::vector<uint8_t>& data_block);
+
 	class TextureLoadingDesc : public ResLoadingDesc
 	{
 	private:
@@ -1089,6 +1102,10 @@ namespace
 				ElementFormat format;
 				std::vector<ElementInitData> init_data;
 				std::vector<uint8_t> data_block;
+
+				// When init_data points into a memory mapped file, keeps the mapping alive until the HW resource is created
+				ResIdentifierPtr mapped_res;
+				std::span<uint8_t const> mapped_payload;
 			};
 			std::shared_ptr<TexData> tex_data;
 
@@ -1296,6 +1313,13 @@ namespace
 			return true;
 		}
 
+		size_t Hash() const override
+		{
+			size_t seed = HashValue(tex_desc_.res_name);
+			HashCombine(seed, tex_desc_.access_hint);
+			return seed;
+		}
+
 		bool Match(ResLoadingDesc const & rhs) const override
 		{
 			if (this->Type() == rhs.Type())
@@ -1329,28 +1353,35 @@ namespace
 		}
 
 	private:
+		// Converting in place can't write into a read-only mapping, copies the payload into data_block first.
+		void MakeInitDataWritable(TexDesc::TexData& tex_data)
+		{
+			if (tex_data.mapped_res)
+			{
+				tex_data.data_block.assign(tex_data.mapped_payload.begin(), tex_data.mapped_payload.end());
+				for (auto& init_data : tex_data.init_data)
+				{
+					size_t const offset = static_cast<uint8_t const *>(init_data.data) - tex_data.mapped_payload.data();
+					init_data.data = tex_data.data_block.data() + offset;
+				}
+
+				tex_data.mapped_payload = {};
+				tex_data.mapped_res.reset();
+			}
+		}
+
 		void LoadDDS()
 		{
 			TexDesc::TexData& tex_data = *tex_desc_.tex_data;
 
 			{
-				TexturePtr tex = LoadSoftwareTexture(tex_desc_.runtime_name);
-				tex_data.type = tex->Type();
-				tex_data.width = tex->Width(0);
-				tex_data.height = tex->Height(0);
-				tex_data.depth = tex->Depth(0);
-				tex_data.num_mipmaps = tex->NumMipMaps();
-				tex_data.array_size = tex->ArraySize();
-				tex_data.format = tex->Format();
-
-				auto& sw_tex = checked_cast<SoftwareTexture&>(*tex);
-				tex_data.init_data = sw_tex.SubresourceData();
-				tex_data.data_block = sw_tex.DataBlock();
-
-				for (size_t i = 0; i < tex_data.init_data.size(); ++ i)
+				ResIdentifierPtr tex_res = Context::Instance().ResLoaderInstance().Open(tex_desc_.runtime_name);
+				auto const payload = ReadDdsFile(tex_res, tex_data.type, tex_data.width, tex_data.height, tex_data.depth,
+					tex_data.num_mipmaps, tex_data.array_size, tex_data.format, tex_data.init_data, tex_data.data_block);
+				if (tex_data.data_block.empty())
 				{
-					size_t const offset = static_cast<uint8_t const *>(tex_data.init_data[i].data) - sw_tex.DataBlock().data();
-					tex_data.init_data[i].data = tex_data.data_block.data() + offset;
+					tex_data.mapped_res = tex_res;
+					tex_data.mapped_payload = payload;
 				}
 			}
 
@@ -1374,6 +1405,8 @@ namespace
 			if (((EF_BC5 == tex_data.format) && !caps.TextureFormatSupport(EF_BC5))
 				|| ((EF_BC5_SRGB == tex_data.format) && !caps.TextureFormatSupport(EF_BC5_SRGB)))
 			{
+				this->MakeInitDataWritable(tex_data);
+
 				BC1Block tmp;
 				for (size_t i = 0; i < tex_data.init_data.size(); ++ i)
 				{
@@ -1398,6 +1431,8 @@ namespace
 			if (((EF_BC4 == tex_data.format) && !caps.TextureFormatSupport(EF_BC4))
 				|| ((EF_BC4_SRGB == tex_data.format) && !caps.TextureFormatSupport(EF_BC4_SRGB)))
 			{
+				this->MakeInitDataWritable(tex_data);
+
 				BC1Block tmp;
 				for (size_t i = 0; i < tex_data.init_data.size(); ++ i)
 				{
@@ -1469,6 +1504,10 @@ namespace
 
 						std::vector<uint8_t> new_data_block;
 						std::vector<uint32_t> new_sub_res_start;
+						if (!needs_new_data_block)
+						{
+							this->MakeInitDataWritable(tex_data);
+						}
 						if (needs_new_data_block)
 						{
 							uint32_t new_data_block_size = 0;
@@ -2084,6 +2123,89 @@ namespace
 			}
 		}
 	}
+
+	// Returns the payload of all subresources. If the resource is memory mapped, init_data points into the mapping and
+	// data_block is left empty. Otherwise the payload is read into data_block in one go.
+	std::span<uint8_t const> ReadDdsFile(ResIdentifierPtr const & tex_res, Texture::TextureType& type,
+		uint32_t& width, uint32_t& height, uint32_t& depth, uint32_t& num_mipmaps, uint32_t& array_size,
+		ElementFormat& format, std::vector<ElementInitData>& init_data, std::vector<uint8_t>& data_block)
+	{
+		uint32_t row_pitch, slice_pitch;
+		ReadDdsFileHeader(tex_res, type, width, height, depth, num_mipmaps, array_size, format,
+			row_pitch, slice_pitch);
+
+		uint32_t const fmt_size = NumFormatBytes(format);
+		bool padding = false;
+		if (!IsCompressedFormat(format))
+		{
+			if (row_pitch != width * fmt_size)
+			{
+				BOOST_ASSERT(row_pitch == ((width + 3) & ~3) * fmt_size);
+				padding = true;
+			}
+		}
+
+		uint32_t const num_faces = (Texture::TT_Cube == type) ? 6 : 1;
+		init_data.resize(array_size * num_faces * num_mipmaps);
+		std::vector<size_t> base(init_data.size());
+		size_t payload_size = 0;
+		for (uint32_t array_index = 0; array_index < array_size; ++ array_index)
+		{
+			for (uint32_t face = 0; face < num_faces; ++ face)
+			{
+				uint32_t the_width = width;
+				uint32_t the_height = (Texture::TT_1D == type) ? 1 : height;
+				uint32_t the_depth = (Texture::TT_3D == type) ? depth : 1;
+				for (uint32_t level = 0; level < num_mipmaps; ++ level)
+				{
+					size_t const index = (array_index * num_faces + face) * num_mipmaps + level;
+					if (IsCompressedFormat(format))
+					{
+						uint32_t const block_size = fmt_size * 4;
+						init_data[index].row_pitch = (the_width + 3) / 4 * block_size;
+						init_data[index].slice_pitch = (the_height + 3) / 4 * init_data[index].row_pitch;
+					}
+					else
+					{
+						init_data[index].row_pitch = (padding ? ((the_width + 3) & ~3) : the_width) * fmt_size;
+						init_data[index].slice_pitch = init_data[index].row_pitch * the_height;
+					}
+
+					base[index] = payload_size;
+					payload_size += init_data[index].slice_pitch * the_depth;
+
+					the_width = std::max(the_width / 2, 1U);
+					the_height = std::max(the_height / 2, 1U);
+					the_depth = std::max(the_depth / 2, 1U);
+				}
+			}
+		}
+
+		uint8_t const * payload;
+		auto const mapped = tex_res->Data();
+		if (mapped.empty())
+		{
+			data_block.resize(payload_size);
+			tex_res->read(data_block.data(), payload_size);
+			Verify(tex_res->gcount() == static_cast<int64_t>(payload_size));
+			payload = data_block.data();
+		}
+		else
+		{
+			int64_t const offset = tex_res->tellg();
+			Verify((offset >= 0) && (static_cast<size_t>(offset) + payload_size <= mapped.size()));
+			data_block.clear();
+			payload = mapped.data() + offset;
+			tex_res->seekg(static_cast<int64_t>(payload_size), std::ios_base::cur);
+		}
+
+		for (size_t i = 0; i < base.size(); ++ i)
+		{
+			init_data[i].data = payload + base[i];
+		}
+
+		return std::span<uint8_t const>(payload, payload_size);
+	}
 } // namespace
 
 namespace KlayGE
@@ -2132,196 +2254,7 @@ namespace KlayGE
 		ElementFormat format;
 		std::vector<ElementInitData> init_data;
 		std::vector<uint8_t> data_block;
-
-		uint32_t row_pitch, slice_pitch;
-		ReadDdsFileHeader(tex_res, type, width, height, depth, num_mipmaps, array_size, format,
-			row_pitch, slice_pitch);
-
-		uint32_t const fmt_size = NumFormatBytes(format);
-		bool padding = false;
-		if (!IsCompressedFormat(format))
-		{
-			if (row_pitch != width * fmt_size)
-			{
-				BOOST_ASSERT(row_pitch == ((width + 3) & ~3) * fmt_size);
-				padding = true;
-			}
-		}
-
-		std::vector<size_t> base;
-		switch (type)
-		{
-		case Texture::TT_1D:
-			{
-				init_data.resize(array_size * num_mipmaps);
-				base.resize(array_size * num_mipmaps);
-				for (uint32_t array_index = 0; array_index < array_size; ++ array_index)
-				{
-					uint32_t the_width = width;
-					for (uint32_t level = 0; level < num_mipmaps; ++ level)
-					{
-						size_t const index = array_index * num_mipmaps + level;
-						uint32_t image_size;
-						if (IsCompressedFormat(format))
-						{
-							uint32_t const block_size = NumFormatBytes(format) * 4;
-							image_size = ((the_width + 3) / 4) * block_size;
-						}
-						else
-						{
-							image_size = (padding ? ((the_width + 3) & ~3) : the_width) * fmt_size;
-						}
-
-						base[index] = data_block.size();
-						data_block.resize(base[index] + image_size);
-						init_data[index].row_pitch = image_size;
-						init_data[index].slice_pitch = image_size;
-
-						tex_res->read(&data_block[base[index]], static_cast<std::streamsize>(image_size));
-						BOOST_ASSERT(tex_res->gcount() == static_cast<int>(image_size));
-
-						the_width = std::max(the_width / 2, 1U);
-					}
-				}
-			}
-			break;
-
-		case Texture::TT_2D:
-			{
-				init_data.resize(array_size * num_mipmaps);
-				base.resize(array_size * num_mipmaps);
-				for (uint32_t array_index = 0; array_index < array_size; ++ array_index)
-				{
-					uint32_t the_width = width;
-					uint32_t the_height = height;
-					for (uint32_t level = 0; level < num_mipmaps; ++ level)
-					{
-						size_t const index = array_index * num_mipmaps + level;
-						if (IsCompressedFormat(format))
-						{
-							uint32_t const block_size = NumFormatBytes(format) * 4;
-							uint32_t image_size = ((the_width + 3) / 4) * ((the_height + 3) / 4) * block_size;
-
-							base[index] = data_block.size();
-							data_block.resize(base[index] + image_size);
-							init_data[index].row_pitch = (the_width + 3) / 4 * block_size;
-							init_data[index].slice_pitch = image_size;
-
-							tex_res->read(&data_block[base[index]], static_cast<std::streamsize>(image_size));
-							BOOST_ASSERT(tex_res->gcount() == static_cast<int>(image_size));
-						}
-						else
-						{
-							init_data[index].row_pitch = (padding ? ((the_width + 3) & ~3) : the_width) * fmt_size;
-							init_data[index].slice_pitch = init_data[index].row_pitch * the_height;
-							base[index] = data_block.size();
-							data_block.resize(base[index] + init_data[index].slice_pitch);
-
-							tex_res->read(&data_block[base[index]], static_cast<std::streamsize>(init_data[index].slice_pitch));
-							BOOST_ASSERT(tex_res->gcount() == static_cast<int>(init_data[index].slice_pitch));
-						}
-
-						the_width = std::max(the_width / 2, 1U);
-						the_height = std::max(the_height / 2, 1U);
-					}
-				}
-			}
-			break;
-
-		case Texture::TT_3D:
-			{
-				init_data.resize(array_size * num_mipmaps);
-				base.resize(array_size * num_mipmaps);
-				for (uint32_t array_index = 0; array_index < array_size; ++ array_index)
-				{
-					uint32_t the_width = width;
-					uint32_t the_height = height;
-					uint32_t the_depth = depth;
-					for (uint32_t level = 0; level < num_mipmaps; ++ level)
-					{
-						size_t const index = array_index * num_mipmaps + level;
-						if (IsCompressedFormat(format))
-						{
-							uint32_t const block_size = NumFormatBytes(format) * 4;
-							uint32_t image_size = ((the_width + 3) / 4) * ((the_height + 3) / 4) * the_depth * block_size;
-
-							base[index] = data_block.size();
-							data_block.resize(base[index] + image_size);
-							init_data[index].row_pitch = (the_width + 3) / 4 * block_size;
-							init_data[index].slice_pitch = ((the_width + 3) / 4) * ((the_height + 3) / 4) * block_size;
-
-							tex_res->read(&data_block[base[index]], static_cast<std::streamsize>(image_size));
-							BOOST_ASSERT(tex_res->gcount() == static_cast<int>(image_size));
-						}
-						else
-						{
-							init_data[index].row_pitch = (padding ? ((the_width + 3) & ~3) : the_width) * fmt_size;
-							init_data[index].slice_pitch = init_data[index].row_pitch * the_height;
-							base[index] = data_block.size();
-							data_block.resize(base[index] + init_data[index].slice_pitch * the_depth);
-
-							tex_res->read(&data_block[base[index]], static_cast<std::streamsize>(init_data[index].slice_pitch * the_depth));
-							BOOST_ASSERT(tex_res->gcount() == static_cast<int>(init_data[index].slice_pitch * the_depth));
-						}
-
-						the_width = std::max(the_width / 2, 1U);
-						the_height = std::max(the_height / 2, 1U);
-						the_depth = std::max(the_depth / 2, 1U);
-					}
-				}
-			}
-			break;
-
-		case Texture::TT_Cube:
-			{
-				init_data.resize(array_size * 6 * num_mipmaps);
-				base.resize(array_size * 6 * num_mipmaps);
-				for (uint32_t array_index = 0; array_index < array_size; ++ array_index)
-				{
-					for (uint32_t face = Texture::CF_Positive_X; face <= Texture::CF_Negative_Z; ++ face)
-					{
-						uint32_t the_width = width;
-						uint32_t the_height = height;
-						for (uint32_t level = 0; level < num_mipmaps; ++ level)
-						{
-							size_t const index = (array_index * 6 + face - Texture::CF_Positive_X) * num_mipmaps + level;
-							if (IsCompressedFormat(format))
-							{
-								uint32_t const block_size = NumFormatBytes(format) * 4;
-								uint32_t image_size = ((the_width + 3) / 4) * ((the_height + 3) / 4) * block_size;
-
-								base[index] = data_block.size();
-								data_block.resize(base[index] + image_size);
-								init_data[index].row_pitch = (the_width + 3) / 4 * block_size;
-								init_data[index].slice_pitch = image_size;
-
-								tex_res->read(&data_block[base[index]], static_cast<std::streamsize>(image_size));
-								BOOST_ASSERT(tex_res->gcount() == static_cast<int>(image_size));
-							}
-							else
-							{
-								init_data[index].row_pitch = (padding ? ((the_width + 3) & ~3) : the_width) * fmt_size;
-								init_data[index].slice_pitch = init_data[index].row_pitch * the_width;
-								base[index] = data_block.size();
-								data_block.resize(base[index] + init_data[index].slice_pitch);
-
-								tex_res->read(&data_block[base[index]], static_cast<std::streamsize>(init_data[index].slice_pitch));
-								BOOST_ASSERT(tex_res->gcount() == static_cast<int>(init_data[index].slice_pitch));
-							}
-
-							the_width = std::max(the_width / 2, 1U);
-							the_height = std::max(the_height / 2, 1U);
-						}
-					}
-				}
-			}
-			break;
-		}
-
-		for (size_t i = 0; i < base.size(); ++ i)
-		{
-			init_data[i].data = &data_block[base[i]];
-		}
+		ReadDdsFile(tex_res, type, width, height, depth, num_mipmaps, array_size, format, init_data, data_block);
 
 		auto ret = MakeSharedPtr<SoftwareTexture>(type, width, height, depth,
 			num_mipmaps, array_size, format, false);
@@ -3171,6 +3104,55 @@ namespace KlayGE
 				auto const& mipmapper = re.MipmapperInstance();
 				mipmapper.BuildSubLevels(this->shared_from_this(), filter);
 			}
+			else if ((type_ != TT_3D) && (access_hint_ & EAH_CPU_Read) && (access_hint_ & EAH_CPU_Write))
+			{
+				// Every surface streams its whole chain from the top level, on the thread pool
+				uint32_t const num_faces = (type_ == TT_Cube) ? 6 : 1;
+				uint32_t const num_levels = this->NumMipMaps();
+				std::vector<std::unique_ptr<Mapper>> mappers;
+				std::vector<void*> level_data(this->ArraySize() * num_faces * num_levels);
+				std::vector<uint32_t> level_row_pitches(level_data.size());
+				for (uint32_t index = 0; index < this->ArraySize(); ++index)
+				{
+					for (uint32_t f = 0; f < num_faces; ++f)
+					{
+						for (uint32_t level = 0; level < num_levels; ++level)
+						{
+							TextureMapAccess const tma = (level == 0) ? TMA_Read_Only : TMA_Write_Only;
+							switch (type_)
+							{
+							case TextureType::TT_1D:
+								mappers.push_back(MakeUniquePtr<Mapper>(*this, index, level, tma, 0, this->Width(level)));
+								break;
+
+							case TextureType::TT_2D:
+								mappers.push_back(
+									MakeUniquePtr<Mapper>(*this, index, level, tma, 0, 0, this->Width(level), this->Height(level)));
+								break;
+
+							default:
+								mappers.push_back(MakeUniquePtr<Mapper>(
+									*this, index, static_cast<CubeFaces>(f), level, tma, 0, 0, this->Width(level), this->Height(level)));
+								break;
+							}
+
+							level_data[mappers.size() - 1] = mappers.back()->Pointer<void>();
+							level_row_pitches[mappers.size() - 1] = mappers.back()->RowPitch();
+						}
+					}
+				}
+
+				ParallelFor(Context::Instance().ThreadPoolInstance(), this->ArraySize() * num_faces, 1,
+					[this, &level_data, &level_row_pitches, num_levels, filter](uint32_t begin, uint32_t end)
+					{
+						for (uint32_t surface = begin; surface < end; ++surface)
+						{
+							BuildMipChain(std::span(level_data).subspan(surface * num_levels, num_levels),
+								std::span(level_row_pitches).subspan(surface * num_levels, num_levels), format_, this->Width(0),
+								this->Height(0), filter);
+						}
+					});
+			}
 			else
 			{
 				switch (type_)
@@ -3536,7 +3518,489 @@ namespace KlayGE
 		}
 	}
 
+} // namespace KlayGE
+
+namespace
+{
+	using namespace KlayGE;
+
+	// Below this many rows, a task costs more to hand to a worker than it takes to filter
+	uint32_t const MIN_ROWS_PER_TASK = 8;
+
+	// Rows of the top level a mip chain converts and filters in parallel before passing them down the chain
+	uint32_t const MIP_CHAIN_BATCH_ROWS = 64;
+
+	double Sinc(double x)
+	{
+		if (std::abs(x) < 1e-6)
+		{
+			return 1;
+		}
+		x *= PI;
+		return std::sin(x) / x;
+	}
+
+	// Zeroth order modified Bessel function of the first kind
+	double BesselI0(double x)
+	{
+		double const quarter_x_sq = x * x / 4;
+		double sum = 1;
+		double term = 1;
+		for (int k = 1; (k < 32) && (term > sum * 1e-12); ++ k)
+		{
+			term *= quarter_x_sq / (k * k);
+			sum += term;
+		}
+		return sum;
+	}
+
+	double FilterRadius(TextureFilter filter)
+	{
+		switch (filter)
+		{
+		case TextureFilter::Box:
+			return 0.5;
+
+		case TextureFilter::Linear:
+			return 1;
 
+		case TextureFilter::Kaiser:
+		case TextureFilter::Lanczos:
+			return 3;
+
+		default:
+			KFL_UNREACHABLE("Point sampling has no filter kernel");
+		}
+	}
+
+	double FilterWeight(TextureFilter filter, double x)
+	{
+		x = std::abs(x);
+		switch (filter)
+		{
+		case TextureFilter::Box:
+			return (x < 0.5) ? 1 : ((x == 0.5) ? 0.5 : 0);
+
+		case TextureFilter::Linear:
+			return std::max(1 - x, 0.0);
+
+		case TextureFilter::Kaiser:
+			if (x < 3)
+			{
+				double constexpr ALPHA = 4;
+				double const t = x / 3;
+				return Sinc(x) * BesselI0(ALPHA * std::sqrt(1 - t * t)) / BesselI0(ALPHA);
+			}
+			return 0;
+
+		case TextureFilter::Lanczos:
+			return (x < 3) ? Sinc(x) * Sinc(x / 3) : 0;
+
+		default:
+			KFL_UNREACHABLE("Point sampling has no filter kernel");
+		}
+	}
+
+	// The filter bank of one axis, one phase per output pixel. Output pixel i blends count[i] source pixels from first[i] on,
+	// with the weights from weights[i * stride]. Taps past the edges are folded onto the edge pixels, which clamps the addressing.
+	struct AxisFilter
+	{
+		std::vector<uint32_t> first;
+		std::vector<uint32_t> count;
+		std::vector<float> weights;
+		uint32_t stride;
+		uint32_t max_count = 0;
+
+		AxisFilter(TextureFilter filter, uint32_t src_size, uint32_t dst_size)
+			: first(dst_size), count(dst_size)
+		{
+			double const scale = static_cast<double>(src_size) / dst_size;
+			// Minifying stretches the kernel over all the source pixels an output pixel covers. Linear stays a bilinear tap,
+			// which is what the GPU does.
+			double const kernel_scale = (filter == TextureFilter::Linear) ? 1 : std::max(scale, 1.0);
+			double const support = FilterRadius(filter) * kernel_scale;
+
+			stride = std::min(static_cast<uint32_t>(std::ceil(support * 2)) + 2, src_size);
+			weights.assign(dst_size * stride, 0.0f);
+
+			int32_t const last_pixel = static_cast<int32_t>(src_size - 1);
+			std::vector<double> taps(stride);
+			for (uint32_t i = 0; i < dst_size; ++ i)
+			{
+				// Source pixel j is centered at j + 0.5
+				double const center = (i + 0.5) * scale;
+				int32_t const lo = static_cast<int32_t>(std::floor(center - support));
+				int32_t const hi = static_cast<int32_t>(std::ceil(center + support));
+				int32_t const clamped_lo = std::clamp(lo, 0, last_pixel);
+				int32_t const clamped_hi = std::clamp(hi - 1, 0, last_pixel);
+				uint32_t const num_taps = static_cast<uint32_t>(clamped_hi - clamped_lo + 1);
+
+				std::fill(taps.begin(), taps.begin() + num_taps, 0.0);
+				double sum = 0;
+				for (int32_t j = lo; j < hi; ++ j)
+				{
+					double const w = FilterWeight(filter, (j + 0.5 - center) / kernel_scale);
+					taps[std::clamp(j, 0, last_pixel) - clamped_lo] += w;
+					sum += w;
+				}
+				if (std::abs(sum) < 1e-8)
+				{
+					taps[std::clamp(static_cast<int32_t>(center), clamped_lo, clamped_hi) - clamped_lo] = 1;
+					sum = 1;
+				}
+
+				uint32_t begin = 0;
+				uint32_t end = num_taps;
+				while ((begin + 1 < end) && (taps[begin] == 0))
+				{
+					++ begin;
+				}
+				while ((end - 1 > begin) && (taps[end - 1] == 0))
+				{
+					-- end;
+				}
+
+				first[i] = clamped_lo + begin;
+				count[i] = end - begin;
+				for (uint32_t k = begin; k < end; ++ k)
+				{
+					weights[i * stride + k - begin] = static_cast<float>(taps[k] / sum);
+				}
+				max_count = std::max(max_count, count[i]);
+			}
+		}
+
+		uint32_t DstSize() const noexcept
+		{
+			return static_cast<uint32_t>(first.size());
+		}
+
+		// One past the last source pixel of output pixel i
+		uint32_t End(uint32_t i) const noexcept
+		{
+			return first[i] + count[i];
+		}
+
+		float const* Weights(uint32_t i) const noexcept
+		{
+			return &weights[i * stride];
+		}
+	};
+
+	void FilterRow(AxisFilter const& filter, Color const* src, Color* dst)
+	{
+		for (uint32_t x = 0; x < filter.DstSize(); ++ x)
+		{
+			Color const* s = src + filter.first[x];
+			float const* w = filter.Weights(x);
+			uint32_t const n = filter.count[x];
+#if defined(KLAYGE_SSE2_SUPPORT)
+			__m128 sum = _mm_mul_ps(_mm_loadu_ps(&s[0].r()), _mm_set1_ps(w[0]));
+			for (uint32_t k = 1; k < n; ++ k)
+			{
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(&s[k].r()), _mm_set1_ps(w[k])));
+			}
+			_mm_storeu_ps(&dst[x].r(), sum);
+#elif defined(KLAYGE_NEON_SUPPORT) && defined(KLAYGE_CPU_ARM64)
+			float32x4_t sum = vmulq_n_f32(vld1q_f32(&s[0].r()), w[0]);
+			for (uint32_t k = 1; k < n; ++ k)
+			{
+				sum = vmlaq_n_f32(sum, vld1q_f32(&s[k].r()), w[k]);
+			}
+			vst1q_f32(&dst[x].r(), sum);
+#else
+			Color sum = s[0];
+			sum *= w[0];
+			for (uint32_t k = 1; k < n; ++ k)
+			{
+				Color c = s[k];
+				c *= w[k];
+				sum += c;
+			}
+			dst[x] = sum;
+#endif
+		}
+	}
+
+	// dst[x] is the sum of weights[k] * rows[k][x]
+	void BlendRows(Color const* const* rows, float const* weights, uint32_t num_rows, uint32_t width, Color* dst)
+	{
+		for (uint32_t x = 0; x < width; ++ x)
+		{
+#if defined(KLAYGE_SSE2_SUPPORT)
+			__m128 sum = _mm_mul_ps(_mm_loadu_ps(&rows[0][x].r()), _mm_set1_ps(weights[0]));
+			for (uint32_t k = 1; k < num_rows; ++ k)
+			{
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(&rows[k][x].r()), _mm_set1_ps(weights[k])));
+			}
+			_mm_storeu_ps(&dst[x].r(), sum);
+#elif defined(KLAYGE_NEON_SUPPORT) && defined(KLAYGE_CPU_ARM64)
+			float32x4_t sum = vmulq_n_f32(vld1q_f32(&rows[0][x].r()), weights[0]);
+			for (uint32_t k = 1; k < num_rows; ++ k)
+			{
+				sum = vmlaq_n_f32(sum, vld1q_f32(&rows[k][x].r()), weights[k]);
+			}
+			vst1q_f32(&dst[x].r(), sum);
+#else
+			Color sum = rows[0][x];
+			sum *= weights[0];
+			for (uint32_t k = 1; k < num_rows; ++ k)
+			{
+				Color c = rows[k][x];
+				c *= weights[k];
+				sum += c;
+			}
+			dst[x] = sum;
+#endif
+		}
+	}
+
+	// Resamples a stream of source rows. Source rows are filtered horizontally as they are pushed, into a ring that holds
+	// the rows the vertical filter still needs, plus extra_rows to let a batch be pushed ahead. Pushing different rows and
+	// emitting output rows may run in parallel, as long as no pushed row overwrites one still to be read.
+	class RowResampler final
+	{
+		KLAYGE_NONCOPYABLE(RowResampler);
+
+	public:
+		RowResampler(AxisFilter const& filter_x, AxisFilter const& filter_y, uint32_t extra_rows)
+			: filter_x_(filter_x), filter_y_(filter_y),
+				num_ring_rows_(filter_y.max_count + extra_rows), ring_(num_ring_rows_ * filter_x.DstSize())
+		{
+		}
+
+		void Push(uint32_t src_y, Color const* src_row)
+		{
+			FilterRow(filter_x_, src_row, this->RingRow(src_y));
+		}
+
+		void Emit(uint32_t dst_y, Color* dst_row) const
+		{
+			uint32_t const first = filter_y_.first[dst_y];
+			uint32_t const count = filter_y_.count[dst_y];
+			std::vector<Color const*> rows(count);
+			for (uint32_t k = 0; k < count; ++ k)
+			{
+				rows[k] = this->RingRow(first + k);
+			}
+			BlendRows(rows.data(), filter_y_.Weights(dst_y), count, filter_x_.DstSize(), dst_row);
+		}
+
+	private:
+		Color* RingRow(uint32_t src_y) noexcept
+		{
+			return &ring_[(src_y % num_ring_rows_) * filter_x_.DstSize()];
+		}
+		Color const* RingRow(uint32_t src_y) const noexcept
+		{
+			return &ring_[(src_y % num_ring_rows_) * filter_x_.DstSize()];
+		}
+
+	private:
+		AxisFilter const& filter_x_;
+		AxisFilter const& filter_y_;
+		uint32_t const num_ring_rows_;
+		std::vector<Color> ring_;
+	};
+
+	// Separable resampling of uncompressed images. Each slice is resized in bands of output rows on the thread pool, each
+	// band streaming only the source rows it needs. A change of depth is filtered last, from a window of resized slices.
+	void ResampleImage(uint8_t* dst, uint32_t dst_row_pitch, uint32_t dst_slice_pitch, ElementFormat dst_format,
+		uint32_t dst_width, uint32_t dst_height, uint32_t dst_depth,
+		uint8_t const* src, uint32_t src_row_pitch, uint32_t src_slice_pitch, ElementFormat src_format,
+		uint32_t src_width, uint32_t src_height, uint32_t src_depth,
+		TextureFilter filter)
+	{
+		auto& tp = Context::Instance().ThreadPoolInstance();
+		AxisFilter const filter_x(filter, src_width, dst_width);
+		AxisFilter const filter_y(filter, src_height, dst_height);
+
+		auto resize_slice = [&](uint8_t const* src_slice, auto const& emit_row)
+		{
+			ParallelFor(tp, dst_height, MIN_ROWS_PER_TASK, [&](uint32_t y_begin, uint32_t y_end)
+				{
+					RowResampler resampler(filter_x, filter_y, 0);
+					std::vector<Color> src_row(src_width);
+					std::vector<Color> dst_row(dst_width);
+					uint32_t sy = 0;
+					for (uint32_t y = y_begin; y < y_end; ++ y)
+					{
+						// Rows between two windows are skipped
+						for (sy = std::max(sy, filter_y.first[y]); sy < filter_y.End(y); ++ sy)
+						{
+							ConvertToABGR32F(src_format, src_slice + sy * src_row_pitch, src_width, src_row.data());
+							resampler.Push(sy, src_row.data());
+						}
+
+						resampler.Emit(y, dst_row.data());
+						emit_row(y, dst_row.data());
+					}
+				});
+		};
+
+		if (src_depth == dst_depth)
+		{
+			for (uint32_t z = 0; z < dst_depth; ++ z)
+			{
+				uint8_t* dst_slice = dst + z * dst_slice_pitch;
+				resize_slice(src + z * src_slice_pitch, [dst_slice, dst_row_pitch, dst_format, dst_width](uint32_t y, Color const* row)
+					{
+						ConvertFromABGR32F(dst_format, row, dst_width, dst_slice + y * dst_row_pitch);
+					});
+			}
+		}
+		else
+		{
+			AxisFilter const filter_z(filter, src_depth, dst_depth);
+			uint32_t const num_planes = filter_z.max_count;
+			uint32_t const plane_size = dst_width * dst_height;
+			std::vector<Color> planes(num_planes * plane_size);
+
+			uint32_t sz = 0;
+			for (uint32_t z = 0; z < dst_depth; ++ z)
+			{
+				for (sz = std::max(sz, filter_z.first[z]); sz < filter_z.End(z); ++ sz)
+				{
+					Color* plane = &planes[(sz % num_planes) * plane_size];
+					resize_slice(src + sz * src_slice_pitch, [plane, dst_width](uint32_t y, Color const* row)
+						{
+							std::copy(row, row + dst_width, plane + y * dst_width);
+						});
+				}
+
+				uint8_t* dst_slice = dst + z * dst_slice_pitch;
+				ParallelFor(tp, dst_height, MIN_ROWS_PER_TASK, [&, z](uint32_t y_begin, uint32_t y_end)
+					{
+						uint32_t const count = filter_z.count[z];
+						std::vector<Color const*> rows(count);
+						std::vector<Color> dst_row(dst_width);
+						for (uint32_t y = y_begin; y < y_end; ++ y)
+						{
+							for (uint32_t k = 0; k < count; ++ k)
+							{
+								rows[k] = &planes[((filter_z.first[z] + k) % num_planes) * plane_size + y * dst_width];
+							}
+							BlendRows(rows.data(), filter_z.Weights(z), count, dst_width, dst_row.data());
+							ConvertFromABGR32F(dst_format, dst_row.data(), dst_width, dst_slice + y * dst_row_pitch);
+						}
+					});
+			}
+		}
+	}
+
+	// One level below the top of a streamed mip chain. It gets the rows of the level above in order, at float precision.
+	struct MipChainLevel
+	{
+		uint32_t width;
+		uint32_t height;
+		AxisFilter filter_x;
+		AxisFilter filter_y;
+		RowResampler resampler;
+
+		uint8_t* data;
+		uint32_t row_pitch;
+
+		uint32_t next_y = 0;
+		std::vector<Color> row;
+
+		MipChainLevel(TextureFilter filter, uint32_t src_width, uint32_t src_height, uint32_t dst_width, uint32_t dst_height,
+			uint32_t extra_rows, uint8_t* dst_data, uint32_t dst_row_pitch)
+			: width(dst_width), height(dst_height),
+				filter_x(filter, src_width, dst_width), filter_y(filter, src_height, dst_height),
+				resampler(filter_x, filter_y, extra_rows),
+				data(dst_data), row_pitch(dst_row_pitch),
+				row(dst_width)
+		{
+		}
+
+		bool Ready(uint32_t num_pushed_rows) const noexcept
+		{
+			return (next_y < height) && (filter_y.End(next_y) <= num_pushed_rows);
+		}
+	};
+
+	// Hands row src_y of the level above levels[index] down, emitting every row of this and the lower levels it completes
+	void PushMipChainRow(std::vector<std::unique_ptr<MipChainLevel>>& levels, size_t index, ElementFormat format,
+		uint32_t src_y, Color const* src_row)
+	{
+		auto& level = *levels[index];
+		level.resampler.Push(src_y, src_row);
+		while (level.Ready(src_y + 1))
+		{
+			level.resampler.Emit(level.next_y, level.row.data());
+			ConvertFromABGR32F(format, level.row.data(), level.width, level.data + level.next_y * level.row_pitch);
+			if (index + 1 < levels.size())
+			{
+				PushMipChainRow(levels, index + 1, format, level.next_y, level.row.data());
+			}
+			++ level.next_y;
+		}
+	}
+
+	void BuildUncompressedMipChain(std::span<uint8_t* const> level_data, std::span<uint32_t const> level_row_pitches,
+		ElementFormat format, uint32_t width, uint32_t height, TextureFilter filter)
+	{
+		auto& tp = Context::Instance().ThreadPoolInstance();
+		uint32_t const num_levels = static_cast<uint32_t>(level_data.size());
+
+		// Level 1 lets a whole batch of level 0 rows be pushed ahead, the others go row by row
+		std::vector<std::unique_ptr<MipChainLevel>> levels;
+		for (uint32_t i = 1; i < num_levels; ++ i)
+		{
+			levels.push_back(MakeUniquePtr<MipChainLevel>(filter, std::max(width >> (i - 1), 1U), std::max(height >> (i - 1), 1U),
+				std::max(width >> i, 1U), std::max(height >> i, 1U), (i == 1) ? MIP_CHAIN_BATCH_ROWS : 0,
+				level_data[i], level_row_pitches[i]));
+		}
+
+		auto& level1 = *levels[0];
+		std::vector<uint32_t> batch_ys;
+		std::vector<Color> batch_rows;
+		for (uint32_t batch_begin = 0; batch_begin < height; batch_begin += MIP_CHAIN_BATCH_ROWS)
+		{
+			uint32_t const batch_end = std::min(batch_begin + MIP_CHAIN_BATCH_ROWS, height);
+
+			// Converting and filtering the top level rows horizontally is most of the work
+			ParallelFor(tp, batch_end - batch_begin, MIN_ROWS_PER_TASK, [&](uint32_t begin, uint32_t end)
+				{
+					std::vector<Color> src_row(width);
+					for (uint32_t sy = batch_begin + begin; sy < batch_begin + end; ++ sy)
+					{
+						ConvertToABGR32F(format, level_data[0] + sy * level_row_pitches[0], width, src_row.data());
+						level1.resampler.Push(sy, src_row.data());
+					}
+				});
+
+			batch_ys.clear();
+			for (; level1.Ready(batch_end); ++ level1.next_y)
+			{
+				batch_ys.push_back(level1.next_y);
+			}
+			uint32_t const num_batch_ys = static_cast<uint32_t>(batch_ys.size());
+			batch_rows.resize(num_batch_ys * level1.width);
+
+			ParallelFor(tp, num_batch_ys, MIN_ROWS_PER_TASK, [&](uint32_t begin, uint32_t end)
+				{
+					for (uint32_t i = begin; i < end; ++ i)
+					{
+						Color* row = &batch_rows[i * level1.width];
+						level1.resampler.Emit(batch_ys[i], row);
+						ConvertFromABGR32F(format, row, level1.width, level1.data + batch_ys[i] * level1.row_pitch);
+					}
+				});
+
+			if (levels.size() > 1)
+			{
+				for (uint32_t i = 0; i < num_batch_ys; ++ i)
+				{
+					PushMipChainRow(levels, 1, format, batch_ys[i], &batch_rows[i * level1.width]);
+				}
+			}
+		}
+	}
+} // namespace
+
+namespace KlayGE
+{
 	void ResizeTexture(void* dst_data, uint32_t dst_row_pitch, uint32_t dst_slice_pitch, ElementFormat dst_format, uint32_t dst_width,
 		uint32_t dst_height, uint32_t dst_depth, void const* src_data, uint32_t src_row_pitch, uint32_t src_slice_pitch,
 		ElementFormat src_format, uint32_t src_width, uint32_t src_height, uint32_t src_depth, TextureFilter filter)
@@ -3626,7 +4090,7 @@ namespace KlayGE
 				KFL_UNREACHABLE("Invalid destination format");
 			}
 
-			dst_cpu_row_pitch = dst_width * NumFormatBytes(src_cpu_format);
+			dst_cpu_row_pitch = dst_width * NumFormatBytes(dst_cpu_format);
 			dst_cpu_slice_pitch = dst_cpu_row_pitch * dst_height;
 			dst_cpu_data_block.resize(dst_depth * dst_cpu_slice_pitch);
 			dst_cpu_data = &dst_cpu_data_block[0];
@@ -3642,11 +4106,17 @@ namespace KlayGE
 		uint8_t const * src_ptr = static_cast<uint8_t const *>(src_cpu_data);
 		uint8_t* dst_ptr = static_cast<uint8_t*>(dst_cpu_data);
 		uint32_t const src_elem_size = NumFormatBytes(src_cpu_format);
-		uint32_t const dst_elem_size = NumFormatBytes(dst_cpu_format);
 
-		if (((filter == TextureFilter::Point) || ((src_width == dst_width) && (src_height == dst_height) && (src_depth == dst_depth))) &&
-			(src_cpu_format == dst_cpu_format))
+		bool const same_size = (src_width == dst_width) && (src_height == dst_height) && (src_depth == dst_depth);
+		if ((filter == TextureFilter::Point) || same_size)
 		{
+			// Whole pixels are picked, and only the picked ones are converted
+			std::vector<uint8_t> picked_row;
+			if ((src_width != dst_width) && (src_cpu_format != dst_cpu_format))
+			{
+				picked_row.resize(dst_width * src_elem_size);
+			}
+
 			for (uint32_t z = 0; z < dst_depth; ++ z)
 			{
 				float fz = static_cast<float>(z + 0.5f) / dst_depth * src_depth;
@@ -3662,15 +4132,20 @@ namespace KlayGE
 
 					if (src_width == dst_width)
 					{
-						std::memcpy(dst_p, src_p, src_width * src_elem_size);
+						ConvertFormat(src_cpu_format, src_p, dst_cpu_format, dst_p, src_width);
 					}
 					else
 					{
-						for (uint32_t x = 0; x < dst_width; ++ x, dst_p += dst_elem_size)
+						uint8_t* picked_p = picked_row.empty() ? dst_p : picked_row.data();
+						for (uint32_t x = 0; x < dst_width; ++ x)
 						{
 							float fx = static_cast<float>(x + 0.5f) / dst_width * src_width;
 							uint32_t sx = std::min(static_cast<uint32_t>(fx), src_width - 1);
-							std::memcpy(dst_p, src_p + sx * src_elem_size, src_elem_size);
+							std::memcpy(picked_p + x * src_elem_size, src_p + sx * src_elem_size, src_elem_size);
+						}
+						if (!picked_row.empty())
+						{
+							ConvertFormat(src_cpu_format, picked_row.data(), dst_cpu_format, dst_p, dst_width);
 						}
 					}
 				}
@@ -3678,95 +4153,83 @@ namespace KlayGE
 		}
 		else
 		{
-			std::vector<Color> src_32f(src_width * src_height * src_depth);
-			{
-				for (uint32_t z = 0; z < src_depth; ++ z)
-				{
-					for (uint32_t y = 0; y < src_height; ++ y)
-					{
-						ConvertToABGR32F(src_cpu_format, src_ptr + z * src_cpu_slice_pitch + y * src_cpu_row_pitch,
-							src_width, &src_32f[(z * src_height + y) * src_width]);
-					}
-				}
-			}
+			ResampleImage(dst_ptr, dst_cpu_row_pitch, dst_cpu_slice_pitch, dst_cpu_format, dst_width, dst_height, dst_depth,
+				src_ptr, src_cpu_row_pitch, src_cpu_slice_pitch, src_cpu_format, src_width, src_height, src_depth,
+				filter);
+		}
 
-			std::vector<Color> dst_32f(dst_width * dst_height * dst_depth);
-			if (filter == TextureFilter::Linear)
+		if (IsCompressedFormat(dst_format))
+		{
+			EncodeTexture(dst_data, dst_row_pitch, dst_slice_pitch, dst_format,
+				dst_cpu_data, dst_cpu_row_pitch, dst_cpu_slice_pitch, dst_cpu_format,
+				dst_width, dst_height, dst_depth);
+		}
+	}
+
+	void BuildMipChain(std::span<void* const> level_data, std::span<uint32_t const> level_row_pitches,
+		ElementFormat format, uint32_t width, uint32_t height, TextureFilter filter)
+	{
+		BOOST_ASSERT(level_data.size() == level_row_pitches.size());
+
+		uint32_t const num_levels = static_cast<uint32_t>(level_data.size());
+		bool const compressed = IsCompressedFormat(format);
+		auto level_slice_pitch = [&](uint32_t level)
+		{
+			uint32_t const level_height = std::max(height >> level, 1U);
+			return level_row_pitches[level] * (compressed ? (level_height + 3) / 4 : level_height);
+		};
+
+		if (filter == TextureFilter::Point)
+		{
+			// Point sampling picks whole pixels, there is no precision to keep between levels
+			for (uint32_t i = 1; i < num_levels; ++ i)
 			{
-				for (uint32_t z = 0; z < dst_depth; ++ z)
-				{
-					float fz = static_cast<float>(z + 0.5f) / dst_depth * src_depth;
-					uint32_t sz0 = static_cast<uint32_t>(fz - 0.5f);
-					uint32_t sz1 = MathLib::clamp(sz0 + 1, 0U, src_depth - 1);
-					float weight_z = fz - sz0 - 0.5f;
-							
-					for (uint32_t y = 0; y < dst_height; ++ y)
-					{
-						float fy = static_cast<float>(y + 0.5f) / dst_height * src_height;
-						uint32_t sy0 = static_cast<uint32_t>(fy - 0.5f);
-						uint32_t sy1 = MathLib::clamp(sy0 + 1, 0U, src_height - 1);
-						float weight_y = fy - sy0 - 0.5f;
-							
-						for (uint32_t x = 0; x < dst_width; ++ x)
-						{
-							float fx = static_cast<float>(x + 0.5f) / dst_width * src_width;
-							uint32_t sx0 = static_cast<uint32_t>(fx - 0.5f);
-							uint32_t sx1 = MathLib::clamp(sx0 + 1, 0U, src_width - 1);
-							float weight_x = fx - sx0 - 0.5f;
-							Color clr_x00 = MathLib::lerp(src_32f[(sz0 * src_height + sy0) * src_width + sx0],
-								src_32f[(sz0 * src_height + sy0) * src_width + sx1], weight_x);
-							Color clr_x01 = MathLib::lerp(src_32f[(sz0 * src_height + sy1) * src_width + sx0],
-								src_32f[(sz0 * src_height + sy1) * src_width + sx1], weight_x);
-							Color clr_y0 = MathLib::lerp(clr_x00, clr_x01, weight_y);
-							Color clr_x10 = MathLib::lerp(src_32f[(sz1 * src_height + sy0) * src_width + sx0],
-								src_32f[(sz1 * src_height + sy0) * src_width + sx1], weight_x);
-							Color clr_x11 = MathLib::lerp(src_32f[(sz1 * src_height + sy1) * src_width + sx0],
-								src_32f[(sz1 * src_height + sy1) * src_width + sx1], weight_x);
-							Color clr_y1 = MathLib::lerp(clr_x10, clr_x11, weight_y);
-							dst_32f[(z * dst_height + y) * dst_width + x] = MathLib::lerp(clr_y0, clr_y1, weight_z);
-						}
-					}
-				}
+				ResizeTexture(level_data[i], level_row_pitches[i], level_slice_pitch(i), format,
+					std::max(width >> i, 1U), std::max(height >> i, 1U), 1,
+					level_data[i - 1], level_row_pitches[i - 1], level_slice_pitch(i - 1), format,
+					std::max(width >> (i - 1), 1U), std::max(height >> (i - 1), 1U), 1,
+					filter);
 			}
-			else
+		}
+		else if (num_levels > 1)
+		{
+			std::vector<uint8_t*> cpu_level_data(num_levels);
+			std::vector<uint32_t> cpu_level_row_pitches(num_levels);
+			if (compressed)
 			{
-				for (uint32_t z = 0; z < dst_depth; ++ z)
+				// Streams through uncompressed levels, and compresses each of them at the end
+				std::vector<std::vector<uint8_t>> cpu_levels(num_levels);
+				uint32_t cpu_slice_pitch;
+				ElementFormat cpu_format;
+				DecodeTexture(cpu_levels[0], cpu_level_row_pitches[0], cpu_slice_pitch, cpu_format,
+					level_data[0], level_row_pitches[0], level_slice_pitch(0), format, width, height, 1);
+				cpu_level_data[0] = cpu_levels[0].data();
+				for (uint32_t i = 1; i < num_levels; ++ i)
 				{
-					float fz = static_cast<float>(z + 0.5f) / dst_depth * src_depth;
-					uint32_t sz = std::min(static_cast<uint32_t>(fz), src_depth - 1);
+					cpu_level_row_pitches[i] = std::max(width >> i, 1U) * NumFormatBytes(cpu_format);
+					cpu_levels[i].resize(cpu_level_row_pitches[i] * std::max(height >> i, 1U));
+					cpu_level_data[i] = cpu_levels[i].data();
+				}
 
-					for (uint32_t y = 0; y < dst_height; ++ y)
-					{
-						float fy = static_cast<float>(y + 0.5f) / dst_height * src_height;
-						uint32_t sy = std::min(static_cast<uint32_t>(fy), src_height - 1);
+				BuildUncompressedMipChain(cpu_level_data, cpu_level_row_pitches, cpu_format, width, height, filter);
 
-						for (uint32_t x = 0; x < dst_width; ++ x)
-						{
-							float fx = static_cast<float>(x + 0.5f) / dst_width * src_width;
-							uint32_t sx = std::min(static_cast<uint32_t>(fx), src_width - 1);
-							dst_32f[(z * dst_height + y) * dst_width + x] = src_32f[(sz * src_height + sy) * src_width + sx];
-						}
-					}
+				for (uint32_t i = 1; i < num_levels; ++ i)
+				{
+					uint32_t const level_height = std::max(height >> i, 1U);
+					EncodeTexture(level_data[i], level_row_pitches[i], level_slice_pitch(i), format,
+						cpu_level_data[i], cpu_level_row_pitches[i], cpu_level_row_pitches[i] * level_height, cpu_format,
+						std::max(width >> i, 1U), level_height, 1);
 				}
 			}
-
+			else
 			{
-				for (uint32_t z = 0; z < dst_depth; ++ z)
+				for (uint32_t i = 0; i < num_levels; ++ i)
 				{
-					for (uint32_t y = 0; y < dst_height; ++ y)
-					{
-						ConvertFromABGR32F(dst_cpu_format, &dst_32f[(z * dst_height + y) * dst_width], dst_width, dst_ptr + z * dst_cpu_slice_pitch + y * dst_cpu_row_pitch);
-					}
+					cpu_level_data[i] = static_cast<uint8_t*>(level_data[i]);
 				}
+				BuildUncompressedMipChain(cpu_level_data, level_row_pitches, format, width, height, filter);
 			}
 		}
-
-		if (IsCompressedFormat(dst_format))
-		{
-			EncodeTexture(dst_data, dst_row_pitch, dst_slice_pitch, dst_format,
-				dst_cpu_data, dst_cpu_row_pitch, dst_cpu_slice_pitch, dst_cpu_format,
-				dst_width, dst_height, dst_depth);
-		}
 	}
 
 
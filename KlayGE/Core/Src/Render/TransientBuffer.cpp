@@ -34,14 +34,16 @@
 #include <KlayGE/RenderEngine.hpp>
 #include <KlayGE/App3D.hpp>
 
+#include <algorithm>
 #include <cstring>
+#include <thread>
 
 #include <KlayGE/TransientBuffer.hpp>
 
 namespace KlayGE
 {
 	TransientBuffer::TransientBuffer(uint32_t size_in_byte, TransientBuffer::BindFlag bind_flag)
-		: bind_flag_(bind_flag)
+		: bind_flag_(bind_flag), capacity_(size_in_byte)
 	{
 		RenderFactory& rf = Context::Instance().RenderFactoryInstance();
 		RenderEngine const & re = rf.RenderEngineInstance();
@@ -56,15 +58,9 @@ namespace KlayGE
 		else
 		{
 			num_pre_frames_ = 1;
-			simulate_buffer_.resize(buffer_->Size());
-			valid_min_ = 0;
-			valid_max_ = 0;
 		}
 
-		free_list_.emplace_back(0, size_in_byte);
-
-		App3DFramework const & app = Context::Instance().AppInstance();
-		retired_frames_.push_back(RetiredFrame(app.TotalNumFrames() + 1));
+		cpu_buffer_.resize(capacity_);
 	}
 
 	GraphicsBufferPtr TransientBuffer::DoCreateBuffer(TransientBuffer::BindFlag bind_flag, uint32_t size_in_byte)
@@ -89,205 +85,219 @@ namespace KlayGE
 
 	SubAlloc TransientBuffer::Alloc(uint32_t size_in_byte, void const * data)
 	{
-		SubAlloc ret;
-
-		// Use first fit method to find a free sub alloc
-		bool found = false;
-		auto iter = free_list_.begin();
-		auto first_fit_iter = iter;
-		for (; iter != free_list_.end(); ++ iter)
+		for (;;)
 		{
-			if (iter->length_ >= size_in_byte)
+			++ num_writers_;
+			if (!growing_)
 			{
-				first_fit_iter = iter;
-				found = true;
-				break;
+				uint32_t const capacity = capacity_;
+				uint64_t const pos = this->Reserve(size_in_byte);
+				if (pos != NO_SPACE)
+				{
+					uint32_t const offset = static_cast<uint32_t>(pos % capacity);
+					memcpy(&cpu_buffer_[offset], data, size_in_byte);
+					-- num_writers_;
+
+					++ num_allocs_;
+					return SubAlloc(offset, size_in_byte);
+				}
+
+				-- num_writers_;
+				this->Grow(size_in_byte, capacity);
+			}
+			else
+			{
+				-- num_writers_;
+
+				// Waits for the other thread to finish growing
+				std::lock_guard<std::mutex> lock(grow_mutex_);
 			}
 		}
+	}
 
-		// If there is not enough space, reallocate a larger buffer.
-		if (!found)
+	uint64_t TransientBuffer::Reserve(uint32_t size_in_byte) noexcept
+	{
+		uint64_t const capacity = capacity_;
+		uint64_t head = head_;
+		for (;;)
 		{
-			uint32_t const old_buffer_size = buffer_->Size();
-			uint32_t larger_buffer_size = std::max(old_buffer_size * 2, old_buffer_size + size_in_byte);
-			GraphicsBufferPtr larger_buffer = this->DoCreateBuffer(bind_flag_, larger_buffer_size);
-			SubAlloc alloc(old_buffer_size, larger_buffer_size - old_buffer_size);
-			if (!free_list_.empty() && (free_list_.back().offset_ + free_list_.back().length_ == alloc.offset_))
-			{
-				free_list_.back().length_ += alloc.length_;
-			}
-			else
+			uint64_t begin = head;
+			uint64_t const offset = begin % capacity;
+			if (offset + size_in_byte > capacity)
 			{
-				free_list_.push_back(alloc);
+				// An allocation is never split. Skips the rest of the ring if it doesn't fit there.
+				begin += capacity - offset;
 			}
-			first_fit_iter = free_list_.end();
-			-- first_fit_iter;
-			if (use_no_overwrite_)
+			uint64_t const end = begin + size_in_byte;
+			uint64_t const in_flight = end - tail_;
+			if (in_flight > capacity)
 			{
-				buffer_->CopyToBuffer(*larger_buffer);
+				return NO_SPACE;
 			}
-			else
+
+			if (head_.compare_exchange_weak(head, end))
 			{
-				simulate_buffer_.resize(larger_buffer_size);
+				frame_bytes_ += end - head;
+
+				uint64_t hwm = high_water_mark_;
+				while ((in_flight > hwm) && !high_water_mark_.compare_exchange_weak(hwm, in_flight))
+				{
+				}
+
+				return begin;
 			}
-			buffer_ = larger_buffer;
 		}
+	}
 
-		uint32_t left_size = first_fit_iter->length_ - size_in_byte;
-		ret.length_ = size_in_byte;
-		ret.offset_ = first_fit_iter->offset_;
-		if (0 == left_size)
-		{
-			free_list_.erase(first_fit_iter);
-		}
-		else
+	void TransientBuffer::Grow(uint32_t size_in_byte, uint32_t old_capacity)
+	{
+		std::lock_guard<std::mutex> lock(grow_mutex_);
+		if (capacity_ != old_capacity)
 		{
-			first_fit_iter->length_ = left_size;
-			first_fit_iter->offset_ += size_in_byte;
+			// Another thread has grown it
+			return;
 		}
 
-		if (use_no_overwrite_)
+		growing_ = true;
+		while (num_writers_ != 0)
 		{
-			GraphicsBuffer::Mapper mapper(*buffer_, BA_Write_No_Overwrite);
-			uint8_t* buffer_data = mapper.Pointer<uint8_t>();
-			memcpy(buffer_data + ret.offset_, data, ret.length_);
+			std::this_thread::yield();
 		}
-		else
+
+		uint32_t const new_capacity = std::max(old_capacity * 2, old_capacity + size_in_byte);
+		cpu_buffer_.resize(new_capacity);
+
+		// Allocations in flight keep their offsets, which are all in [0, old_capacity). The ring continues right after them,
+		// and the whole old range stays in flight until the current frame is retired.
+		uint64_t const new_head = (head_ / new_capacity + 1) * new_capacity + old_capacity;
+		tail_ = new_head - old_capacity;
+		for (auto& fence : frame_fences_)
 		{
-			memcpy(&simulate_buffer_[ret.offset_], data, ret.length_);
-			valid_min_ = std::min(valid_min_, ret.offset_);
-			valid_max_ = std::max(valid_max_, ret.offset_ + ret.length_);
+			fence.second = tail_;
 		}
+		head_ = new_head;
+		capacity_ = new_capacity;
+		++ num_grows_;
 
-		return ret;
+		growing_ = false;
 	}
 
-	void TransientBuffer::Dealloc(SubAlloc const & alloc)
+	void TransientBuffer::OnPresent()
 	{
-		if ((alloc.length_ > 0) && !retired_frames_.empty())
+		App3DFramework const & app = Context::Instance().AppInstance();
+		uint32_t const frame_id = app.TotalNumFrames();
+
+		uint64_t const head = head_;
+		uint64_t const bytes = frame_bytes_.exchange(0);
+		if (!frame_fences_.empty() && (frame_fences_.back().first == frame_id))
+		{
+			// Presented more than once in a frame
+			frame_fences_.back().second = head;
+			cur_frame_bytes_ += bytes;
+		}
+		else
 		{
-			RetiredFrame& frame = retired_frames_.back();
-			frame.pending_frees_.push_back(alloc);
+			frame_fences_.emplace_back(frame_id, head);
+			cur_frame_bytes_ = bytes;
+		}
+		frame_high_water_mark_ = std::max(frame_high_water_mark_, cur_frame_bytes_);
 
-			if (!use_no_overwrite_)
-			{
-				if (alloc.offset_ == valid_min_)
-				{
-					valid_min_ += alloc.length_;
-				}
-				if (alloc.offset_ + alloc.length_ == valid_max_)
-				{
-					valid_max_ -= alloc.length_;
-				}
-			}
+		while (!frame_fences_.empty() && (frame_fences_.front().first + num_pre_frames_ <= frame_id))
+		{
+			tail_ = std::max(tail_, frame_fences_.front().second);
+			frame_fences_.pop_front();
 		}
 	}
 
-	void TransientBuffer::OnPresent()
+	void TransientBuffer::EnsureDataReady()
 	{
-		if (!retired_frames_.empty())
+		if (buffer_->Size() < capacity_)
 		{
-			App3DFramework const & app = Context::Instance().AppInstance();
-			uint32_t const frame_id = app.TotalNumFrames();
+			buffer_ = this->DoCreateBuffer(bind_flag_, capacity_);
+			uploaded_ = tail_;
+		}
 
-			// First, deal with deletes from this frame
-			RetiredFrame& ret_frame = retired_frames_.back();
-			if (!ret_frame.pending_frees_.empty()) 
+		uint64_t const head = head_;
+		if (use_no_overwrite_)
+		{
+			uint64_t const begin = std::max(uploaded_, tail_);
+			if (head > begin)
 			{
-				// Append a new (empty) RetiredFrame to retired_frames_
-				retired_frames_.push_back(RetiredFrame(frame_id + 1));
+				GraphicsBuffer::Mapper mapper(*buffer_, BA_Write_No_Overwrite);
+				this->UploadRange(mapper.Pointer<uint8_t>(), begin, head);
 			}
-			// Second, return pending frees to free_list
-			auto frame_iter = retired_frames_.begin();
-			for (; frame_iter != retired_frames_.end();)
+		}
+		else
+		{
+			// The map discards the whole buffer, so everything in flight is uploaded again
+			if (head > tail_)
 			{
-				if (frame_iter->frame_id + num_pre_frames_ <= frame_id)
-				{
-					auto iter = frame_iter->pending_frees_.begin();
-					for (; iter != frame_iter->pending_frees_.end(); ++ iter)
-					{
-						this->DoFree(*iter);
-					}
-					frame_iter = retired_frames_.erase(frame_iter);
-				}
-				else
-				{
-					++ frame_iter;
-				}
+				GraphicsBuffer::Mapper mapper(*buffer_, BA_Write_Only);
+				this->UploadRange(mapper.Pointer<uint8_t>(), tail_, head);
 			}
 		}
+		uploaded_ = head;
 	}
 
-	void TransientBuffer::DoFree(SubAlloc const & alloc)
+	void TransientBuffer::UploadRange(uint8_t* dst, uint64_t begin, uint64_t end) const
 	{
-		if (free_list_.empty())
+		uint32_t const begin_offset = static_cast<uint32_t>(begin % capacity_);
+		uint32_t const size = static_cast<uint32_t>(end - begin);
+		uint32_t const first_size = std::min(size, capacity_ - begin_offset);
+		memcpy(dst + begin_offset, &cpu_buffer_[begin_offset], first_size);
+		if (size > first_size)
 		{
-			free_list_.push_back(alloc);
+			// Wraps around the end of the ring
+			memcpy(dst, &cpu_buffer_[0], size - first_size);
 		}
-		else
-		{
-			// Find where to insert the alloc
-			auto insert_position = free_list_.begin();
-			while (insert_position != free_list_.end())
-			{
-				if (insert_position->offset_ > alloc.offset_)
-				{
-					break;
-				}
-				++ insert_position;
-			}
+	}
 
-			bool left_merged = false;
-			// If the alloc is adjacent to previous alloc, merge them.
-			auto previous = insert_position;
-			if (insert_position != free_list_.begin())
-			{
-				-- previous;
-				if (previous->offset_ + previous->length_ == alloc.offset_)
-				{
-					previous->length_ += alloc.length_;
-					left_merged = true;
-				}
-			}
+	TransientBuffer::Statistics TransientBuffer::GetStatistics() const noexcept
+	{
+		Statistics stats;
+		stats.capacity = capacity_;
+		stats.high_water_mark = static_cast<uint32_t>(high_water_mark_);
+		stats.frame_high_water_mark = static_cast<uint32_t>(frame_high_water_mark_);
+		stats.num_grows = num_grows_;
+		stats.num_allocs = num_allocs_;
+		return stats;
+	}
 
-			bool right_merged = false;
-			// If the alloc is adjecent to next alloc, merge them.
-			auto next = insert_position;
-			if (insert_position != free_list_.end())
+	void TransientBuffer::ResetStatistics() noexcept
+	{
+		high_water_mark_ = 0;
+		num_allocs_ = 0;
+		frame_high_water_mark_ = 0;
+		num_grows_ = 0;
+	}
+
+
+	GraphicsBufferPtr MakeQuadIndexBuffer(bool primitive_restart)
+	{
+		std::vector<uint16_t> indices;
+		indices.reserve(MAX_QUADS_PER_DRAW * NumIndicesPerQuad(primitive_restart));
+		for (uint32_t i = 0; i < MAX_QUADS_PER_DRAW; ++ i)
+		{
+			uint16_t const base = static_cast<uint16_t>(i * 4);
+			indices.push_back(base + 0);
+			indices.push_back(base + 1);
+			if (primitive_restart)
 			{
-				if (left_merged)
-				{
-					if (previous->offset_ + previous->length_ == next->offset_)
-					{
-						previous->length_ += next->length_;
-						free_list_.erase(next);
-						right_merged = true;
-					}
-				}
-				else
-				{
-					if (alloc.offset_ + alloc.length_ == next->offset_)
-					{
-						next->offset_ -= alloc.length_;
-						next->length_ += alloc.length_;
-						right_merged = true;
-					}
-				}
+				indices.push_back(base + 3);
+				indices.push_back(base + 2);
+				indices.push_back(0xFFFF);
 			}
-			if (!(left_merged || right_merged))
+			else
 			{
-				free_list_.emplace(insert_position, alloc);
+				indices.push_back(base + 2);
+				indices.push_back(base + 2);
+				indices.push_back(base + 3);
+				indices.push_back(base + 0);
 			}
 		}
-	}
 
-	void TransientBuffer::EnsureDataReady()
-	{
-		if (!use_no_overwrite_)
-		{
-			GraphicsBuffer::Mapper mapper(*buffer_, BA_Write_Only);
-			memcpy(mapper.Pointer<uint8_t>() + valid_min_, &simulate_buffer_[valid_min_],
-				valid_max_ - valid_min_);
-		}
+		RenderFactory& rf = Context::Instance().RenderFactoryInstance();
+		return rf.MakeIndexBuffer(BU_Static, EAH_GPU_Read | EAH_Immutable,
+			static_cast<uint32_t>(indices.size() * sizeof(indices[0])), indices.data());
 	}
 }
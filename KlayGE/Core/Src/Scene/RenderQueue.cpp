@@ -0,0 +1,148 @@
+/**
+ * @file RenderQueue.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Math.hpp>
+#include <KFL/RadixSort.hpp>
+#include <KFL/Thread.hpp>
+#include <KlayGE/Context.hpp>
+#include <KlayGE/Renderable.hpp>
+#include <KlayGE/RenderEffect.hpp>
+#include <KlayGE/SceneNode.hpp>
+
+#include <algorithm>
+
+#include <KlayGE/RenderQueue.hpp>
+
+namespace
+{
+	using namespace KlayGE;
+
+	// Technique indices above this share the last one. Such draws are still grouped by weight, only the depth order mixes them.
+	uint32_t const MAX_TECH_INDEX = 0xFFFF;
+
+	// A key is a handful of multiply-adds, so smaller queues are keyed on the calling thread
+	uint32_t const MIN_KEYS_PER_TASK = 2048;
+
+	float MinViewDepth(Renderable const & renderable, float4 const & view_mat_z)
+	{
+		AABBox const & box = renderable.PosBound();
+		uint32_t const num = renderable.NumInstances();
+		float md = 1e10f;
+		for (uint32_t i = 0; i < num; ++ i)
+		{
+			float4x4 const & mat = renderable.GetInstance(i)->TransformToWorld();
+			float4 const zvec(MathLib::dot(mat.Row(0), view_mat_z),
+				MathLib::dot(mat.Row(1), view_mat_z), MathLib::dot(mat.Row(2), view_mat_z),
+				MathLib::dot(mat.Row(3), view_mat_z));
+			for (int k = 0; k < 8; ++ k)
+			{
+				float3 const v = box.Corner(k);
+				md = std::min(md, v.x() * zvec.x() + v.y() * zvec.y() + v.z() * zvec.z() + zvec.w());
+			}
+		}
+		return md;
+	}
+}
+
+namespace KlayGE
+{
+	RenderQueue::RenderQueue() = default;
+
+	void RenderQueue::Clear()
+	{
+		renderables_.clear();
+		tech_indices_.clear();
+		techs_.clear();
+		tech_index_map_.clear();
+		sorted_renderables_.clear();
+	}
+
+	void RenderQueue::Add(Renderable* renderable)
+	{
+		RenderTechnique const * tech = renderable->GetRenderTechnique();
+		BOOST_ASSERT(tech);
+
+		auto const result = tech_index_map_.try_emplace(tech, static_cast<uint32_t>(techs_.size()));
+		if (result.second)
+		{
+			techs_.push_back(tech);
+		}
+
+		renderables_.push_back(renderable);
+		tech_indices_.push_back(result.first->second);
+	}
+
+	void RenderQueue::Sort(std::optional<float4> const & view_mat_z)
+	{
+		this->CalcKeys(view_mat_z);
+		RadixSort(keys_, keys_scratch_);
+
+		sorted_renderables_.resize(keys_.size());
+		for (size_t i = 0; i < keys_.size(); ++ i)
+		{
+			sorted_renderables_[i] = renderables_[keys_[i].second];
+		}
+	}
+
+	void RenderQueue::CalcKeys(std::optional<float4> const & view_mat_z)
+	{
+		// The high 48 bits only depend on the technique
+		std::vector<uint64_t> tech_keys(techs_.size());
+		std::vector<bool> depth_sorted(techs_.size());
+		for (size_t i = 0; i < techs_.size(); ++ i)
+		{
+			RenderTechnique const & tech = *techs_[i];
+			tech_keys[i] = (static_cast<uint64_t>(RadixSortKey(tech.Weight())) << 32)
+				| (static_cast<uint64_t>(std::min(static_cast<uint32_t>(i), MAX_TECH_INDEX)) << 16);
+			depth_sorted[i] = view_mat_z && !tech.Transparent() && !tech.HasDiscard();
+		}
+
+		uint32_t const num_keys = static_cast<uint32_t>(renderables_.size());
+		keys_.resize(num_keys);
+
+		auto calc_range = [this, &tech_keys, &depth_sorted, &view_mat_z](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t i = begin; i < end; ++ i)
+			{
+				uint32_t const tech_index = tech_indices_[i];
+				uint64_t key = tech_keys[tech_index];
+				if (depth_sorted[tech_index])
+				{
+					// Only the top bits of the depth go into the key. Front-to-back order only has to be roughly right.
+					key |= RadixSortKey(MinViewDepth(*renderables_[i], *view_mat_z)) >> 16;
+				}
+				keys_[i] = std::make_pair(key, i);
+			}
+		};
+
+		ParallelFor(Context::Instance().ThreadPoolInstance(), num_keys, MIN_KEYS_PER_TASK, calc_range);
+	}
+}
@@ -36,6 +36,7 @@
 #include <KlayGE/App3D.hpp>
 #include <KlayGE/Window.hpp>
 
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <iterator>
@@ -69,19 +70,21 @@ namespace
 
 namespace KlayGE
 {
-	class UIRectRenderable : public Renderable
+	// All UI quads of a frame go into one vertex stream with a single allocation. Quads of the same texture are drawn
+	// together, in the order they were added.
+	class UIBatchRenderable : public Renderable
 	{
 	public:
-		UIRectRenderable(TexturePtr const & texture, RenderEffectPtr const & effect)
-			: Renderable(L"UIRect"),
-				texture_(texture)
+		explicit UIBatchRenderable(RenderEffectPtr const & effect)
+			: Renderable(L"UIBatch")
 		{
 			RenderFactory& rf = Context::Instance().RenderFactoryInstance();
 
-			restart_ = rf.RenderEngineInstance().DeviceCaps().primitive_restart_support;
+			bool const restart = rf.RenderEngineInstance().DeviceCaps().primitive_restart_support;
+			index_per_quad_ = NumIndicesPerQuad(restart);
 
 			rls_[0] = rf.MakeRenderLayout();
-			if (restart_)
+			if (restart)
 			{
 				rls_[0]->TopologyType(RenderLayout::TT_TriangleStrip);
 			}
@@ -90,24 +93,17 @@ namespace KlayGE
 				rls_[0]->TopologyType(RenderLayout::TT_TriangleList);
 			}
 
-			uint32_t const INDEX_PER_QUAD = restart_ ? 5 : 6;
 			uint32_t const INIT_NUM_QUAD = 1024;
 			tb_vb_ = MakeUniquePtr<TransientBuffer>(static_cast<uint32_t>(INIT_NUM_QUAD * 4 * sizeof(UIManager::VertexFormat)), TransientBuffer::BF_Vertex);
-			tb_ib_ = MakeUniquePtr<TransientBuffer>(static_cast<uint32_t>(INIT_NUM_QUAD * INDEX_PER_QUAD * sizeof(uint16_t)), TransientBuffer::BF_Index);
 
 			rls_[0]->BindVertexStream(tb_vb_->GetBuffer(), MakeSpan({VertexElement(VEU_Position, 0, EF_BGR32F),
 				VertexElement(VEU_Diffuse, 0, EF_ABGR32F), VertexElement(VEU_TextureCoord, 0, EF_GR32F)}));
-			rls_[0]->BindIndexStream(tb_ib_->GetBuffer(), EF_R16UI);
+			rls_[0]->BindIndexStream(MakeQuadIndexBuffer(restart), EF_R16UI);
 
 			effect_ = effect;
-			if (texture)
-			{
-				technique_ = effect->TechniqueByName("UITec");
-			}
-			else
-			{
-				technique_ = effect->TechniqueByName("UITecNoTex");
-			}
+			tex_tech_ = effect->TechniqueByName("UITec");
+			no_tex_tech_ = effect->TechniqueByName("UITecNoTex");
+			technique_ = tex_tech_;
 
 			ui_tex_ep_ = effect->ParameterByName("ui_tex");
 			half_width_height_ep_ = effect->ParameterByName("half_width_height");
@@ -116,117 +112,126 @@ namespace KlayGE
 
 		bool Empty() const
 		{
-			return tb_ib_sub_allocs_.empty();
+			return num_quads_ == 0;
 		}
 
-		void OnRenderBegin()
+		void OnRenderBegin() override
 		{
-			RenderFactory& rf = Context::Instance().RenderFactoryInstance();
-
-			*ui_tex_ep_ = texture_;
-
-			RenderEngine& re = rf.RenderEngineInstance();
+			RenderEngine& re = Context::Instance().RenderFactoryInstance().RenderEngineInstance();
 			float const half_width = re.CurFrameBuffer()->Width() / 2.0f;
 			float const half_height = re.CurFrameBuffer()->Height() / 2.0f;
 
 			*half_width_height_ep_ = float2(half_width, half_height);
 			*dpi_scale_ep_ = Context::Instance().AppInstance().MainWnd()->DPIScale();
-
-			tb_vb_->EnsureDataReady();
-			tb_ib_->EnsureDataReady();
-
-			rls_[0]->SetVertexStream(0, tb_vb_->GetBuffer());
-			rls_[0]->BindIndexStream(tb_ib_->GetBuffer(), EF_R16UI);
 		}
-		
-		void OnRenderEnd()
+
+		void OnRenderEnd() override
 		{
 			tb_vb_->OnPresent();
-			tb_ib_->OnPresent();
 
-			tb_vb_sub_allocs_.clear();
-			tb_ib_sub_allocs_.clear();
+			// Textures not drawn in this frame are released. The others keep the capacity of their vertices.
+			batches_.erase(std::remove_if(batches_.begin(), batches_.end(),
+				[](Batch const & batch) { return batch.vertices.empty(); }), batches_.end());
+			for (auto& batch : batches_)
+			{
+				batch.vertices.clear();
+			}
+			last_batch_ = 0;
+			num_quads_ = 0;
 		}
 
-		void Render()
+		void Render() override
 		{
 			RenderEngine& re = Context::Instance().RenderFactoryInstance().RenderEngineInstance();
 
-			this->OnRenderBegin();
-
-			BOOST_ASSERT(tb_vb_sub_allocs_.size() == tb_ib_sub_allocs_.size());
-
-			for (size_t i = 0; i < tb_vb_sub_allocs_.size(); ++ i)
+			if (num_quads_ > 0)
 			{
-				uint32_t vert_length = tb_vb_sub_allocs_[i].length_;
-				uint32_t const ind_offset = tb_ib_sub_allocs_[i].offset_;
-				uint32_t ind_length = tb_ib_sub_allocs_[i].length_;
+				this->OnRenderBegin();
 
-				while ((i + 1 < tb_vb_sub_allocs_.size())
-					&& (tb_vb_sub_allocs_[i].offset_ + tb_vb_sub_allocs_[i].length_ == tb_vb_sub_allocs_[i + 1].offset_)
-					&& (tb_ib_sub_allocs_[i].offset_ + tb_ib_sub_allocs_[i].length_ == tb_ib_sub_allocs_[i + 1].offset_))
+				frame_vertices_.clear();
+				for (auto const & batch : batches_)
 				{
-					vert_length += tb_vb_sub_allocs_[i + 1].length_;
-					ind_length += tb_ib_sub_allocs_[i + 1].length_;
-					++ i;
+					frame_vertices_.insert(frame_vertices_.end(), batch.vertices.begin(), batch.vertices.end());
 				}
 
-				rls_[0]->NumVertices(vert_length / sizeof(UIManager::VertexFormat));
-				rls_[0]->StartIndexLocation(ind_offset / sizeof(uint16_t));
-				rls_[0]->NumIndices(ind_length / sizeof(uint16_t));
+				SubAlloc const vb_alloc = tb_vb_->Alloc(static_cast<uint32_t>(frame_vertices_.size() * sizeof(frame_vertices_[0])),
+					frame_vertices_.data());
+				tb_vb_->EnsureDataReady();
+				rls_[0]->SetVertexStream(0, tb_vb_->GetBuffer());
 
-				re.Render(*this->GetRenderEffect(), *this->GetRenderTechnique(), *rls_[0]);
-			}
+				uint32_t start_vertex = vb_alloc.offset_ / sizeof(UIManager::VertexFormat);
+				for (auto const & batch : batches_)
+				{
+					if (batch.vertices.empty())
+					{
+						continue;
+					}
 
-			for (size_t i = 0; i < tb_vb_sub_allocs_.size(); ++ i)
-			{
-				tb_vb_->Dealloc(tb_vb_sub_allocs_[i]);
-				tb_ib_->Dealloc(tb_ib_sub_allocs_[i]);
+					*ui_tex_ep_ = batch.texture;
+					RenderTechnique const & tech = batch.texture ? *tex_tech_ : *no_tex_tech_;
+
+					uint32_t const num_quads = static_cast<uint32_t>(batch.vertices.size() / 4);
+					for (uint32_t first = 0; first < num_quads; first += MAX_QUADS_PER_DRAW)
+					{
+						uint32_t const n = std::min(num_quads - first, MAX_QUADS_PER_DRAW);
+						rls_[0]->StartVertexLocation(start_vertex + first * 4);
+						rls_[0]->NumVertices(n * 4);
+						rls_[0]->StartIndexLocation(0);
+						rls_[0]->NumIndices(n * index_per_quad_);
+
+						re.Render(*effect_, tech, *rls_[0]);
+					}
+
+					start_vertex += num_quads * 4;
+				}
 			}
 
 			this->OnRenderEnd();
 		}
 
-		void AddQuad(std::vector<UIManager::VertexFormat> const & vertices)
+		void AddQuad(TexturePtr const & texture, UIManager::VertexFormat const * vertices)
 		{
-			tb_vb_sub_allocs_.push_back(tb_vb_->Alloc(static_cast<uint32_t>(vertices.size() * sizeof(vertices[0])), &vertices[0]));
-			
-			uint16_t const last_index = static_cast<uint16_t>(tb_vb_sub_allocs_.back().offset_ / sizeof(UIManager::VertexFormat));
-			std::vector<uint16_t> indices;
-			indices.resize(restart_ ? 5 : 6);
-			indices[0] = last_index + 0;
-			indices[1] = last_index + 1;
-			if (restart_)
-			{
-				indices[2] = last_index + 3;
-				indices[3] = last_index + 2;
-				indices[4] = 0xFFFF;
-			}
-			else
+			// There are only a few textures in a UI. Quads of the same texture usually come one after another.
+			if ((last_batch_ >= batches_.size()) || (batches_[last_batch_].texture != texture))
 			{
-				indices[2] = last_index + 2;
-				indices[3] = last_index + 2;
-				indices[4] = last_index + 3;
-				indices[5] = last_index + 0;
+				last_batch_ = 0;
+				while ((last_batch_ < batches_.size()) && (batches_[last_batch_].texture != texture))
+				{
+					++ last_batch_;
+				}
+				if (last_batch_ == batches_.size())
+				{
+					batches_.emplace_back().texture = texture;
+				}
 			}
-			BOOST_ASSERT(last_index + 3 <= 0xFFFF);
 
-			tb_ib_sub_allocs_.push_back(tb_ib_->Alloc(static_cast<uint32_t>(indices.size() * sizeof(indices[0])), &indices[0]));
+			auto& batch_vertices = batches_[last_batch_].vertices;
+			batch_vertices.insert(batch_vertices.end(), vertices, vertices + 4);
+			++ num_quads_;
 		}
 
 	private:
-		bool restart_;
+		struct Batch
+		{
+			TexturePtr texture;
+			std::vector<UIManager::VertexFormat> vertices;
+		};
+
+		uint32_t index_per_quad_;
+
+		RenderTechnique* tex_tech_;
+		RenderTechnique* no_tex_tech_;
 
 		RenderEffectParameter* dpi_scale_ep_;
 		RenderEffectParameter* ui_tex_ep_;
 		RenderEffectParameter* half_width_height_ep_;
 
-		TexturePtr texture_;
-
 		std::unique_ptr<TransientBuffer> tb_vb_;
-		std::unique_ptr<TransientBuffer> tb_ib_;
-		std::vector<SubAlloc> tb_vb_sub_allocs_;
-		std::vector<SubAlloc> tb_ib_sub_allocs_;
+
+		std::vector<Batch> batches_;
+		size_t last_batch_ = 0;
+		uint32_t num_quads_ = 0;
+		std::vector<UIManager::VertexFormat> frame_vertices_;
 	};
 
 
@@ -784,13 +789,9 @@ namespace KlayGE
 				dialog->Render();
 			}
 
-			for (auto const& rect : rects_)
+			if (batch_ && !batch_->Empty())
 			{
-				if (!checked_pointer_cast<UIRectRenderable>(rect.second)->Empty())
-				{
-					auto ui_rect_obj = MakeSharedPtr<SceneNode>(MakeSharedPtr<RenderableComponent>(rect.second), SceneNode::SOA_Overlay);
-					Context::Instance().SceneManagerInstance().OverlayRootNode().AddChild(ui_rect_obj);
-				}
+				Context::Instance().SceneManagerInstance().OverlayRootNode().AddChild(batch_node_);
 			}
 			for (auto const& str : strings_)
 			{
@@ -815,51 +816,27 @@ namespace KlayGE
 				texcoord = Rect(0, 0, 0, 0);
 			}
 
-			std::shared_ptr<UIRectRenderable> renderable;
-			if (rects_.find(texture) == rects_.end())
-			{
-				renderable = MakeSharedPtr<UIRectRenderable>(texture, effect_);
-				rects_[texture] = renderable;
-			}
-			else
+			VertexFormat const vertices[] =
 			{
-				renderable = checked_pointer_cast<UIRectRenderable>(rects_[texture]);
-			}
-			BOOST_ASSERT(renderable);
-
-			std::vector<VertexFormat> vertices(4);
-			vertices[0] = VertexFormat(pos + float3(0, 0, 0), clrs[0], float2(texcoord.left(), texcoord.top()));
-			vertices[1] = VertexFormat(pos + float3(width, 0, 0), clrs[1], float2(texcoord.right(), texcoord.top()));
-			vertices[2] = VertexFormat(pos + float3(width, height, 0), clrs[2], float2(texcoord.right(), texcoord.bottom()));
-			vertices[3] = VertexFormat(pos + float3(0, height, 0), clrs[3], float2(texcoord.left(), texcoord.bottom()));
+				VertexFormat(pos + float3(0, 0, 0), clrs[0], float2(texcoord.left(), texcoord.top())),
+				VertexFormat(pos + float3(width, 0, 0), clrs[1], float2(texcoord.right(), texcoord.top())),
+				VertexFormat(pos + float3(width, height, 0), clrs[2], float2(texcoord.right(), texcoord.bottom())),
+				VertexFormat(pos + float3(0, height, 0), clrs[3], float2(texcoord.left(), texcoord.bottom()))
+			};
 
-			renderable->AddQuad(vertices);
+			this->Batch().AddQuad(texture, vertices);
 		}
 		void DrawQuad(float3 const& offset, VertexFormat const* vertices, TexturePtr const& texture)
 		{
-			std::shared_ptr<UIRectRenderable> renderable;
-			if (rects_.find(texture) == rects_.end())
-			{
-				renderable = MakeSharedPtr<UIRectRenderable>(texture, effect_);
-				rects_[texture] = renderable;
-			}
-			else
+			VertexFormat const verts[] =
 			{
-				renderable = checked_pointer_cast<UIRectRenderable>(rects_[texture]);
-			}
-			BOOST_ASSERT(renderable);
-
-			std::vector<VertexFormat> verts(4);
-			verts[0] = VertexFormat(offset + vertices[0].pos,
-				vertices[0].clr, vertices[0].tex);
-			verts[1] = VertexFormat(offset + vertices[1].pos,
-				vertices[1].clr, vertices[1].tex);
-			verts[2] = VertexFormat(offset + vertices[2].pos,
-				vertices[2].clr, vertices[2].tex);
-			verts[3] = VertexFormat(offset + vertices[3].pos,
-				vertices[3].clr, vertices[3].tex);
+				VertexFormat(offset + vertices[0].pos, vertices[0].clr, vertices[0].tex),
+				VertexFormat(offset + vertices[1].pos, vertices[1].clr, vertices[1].tex),
+				VertexFormat(offset + vertices[2].pos, vertices[2].clr, vertices[2].tex),
+				VertexFormat(offset + vertices[3].pos, vertices[3].clr, vertices[3].tex)
+			};
 
-			renderable->AddQuad(verts);
+			this->Batch().AddQuad(texture, verts);
 		}
 		void DrawString(std::wstring const& strText, uint32_t font_index, IRect const& rc, float depth, Color const& clr, uint32_t align)
 		{
@@ -1140,6 +1117,17 @@ namespace KlayGE
 			}
 		}
 
+	private:
+		UIBatchRenderable& Batch()
+		{
+			if (!batch_)
+			{
+				batch_ = MakeSharedPtr<UIBatchRenderable>(effect_);
+				batch_node_ = MakeSharedPtr<SceneNode>(MakeSharedPtr<RenderableComponent>(batch_), SceneNode::SOA_Overlay);
+			}
+			return *batch_;
+		}
+
 	private:
 		// Shared between all dialogs
 		RenderEffectPtr effect_;
@@ -1151,7 +1139,8 @@ namespace KlayGE
 
 		std::array<std::vector<IRect>, UICT_Num_Control_Types> elem_texture_rcs_;
 
-		std::map<TexturePtr, RenderablePtr> rects_;
+		std::shared_ptr<UIBatchRenderable> batch_;
+		SceneNodePtr batch_node_;
 
 		struct StringCache
 		{
@@ -112,6 +112,24 @@ namespace KlayGE
 			flip_winding_order_ = flip_winding_order;
 		}
 
+		// Largest error of a key frame component that dropping keys may cause
+		float AnimationTolerance() const
+		{
+			return animation_tolerance_;
+		}
+		void AnimationTolerance(float tolerance)
+		{
+			animation_tolerance_ = tolerance;
+		}
+		bool QuantizeAnimation() const
+		{
+			return quantize_animation_;
+		}
+		void QuantizeAnimation(bool quantize)
+		{
+			quantize_animation_ = quantize;
+		}
+
 		uint32_t NumLods() const;
 		void NumLods(uint32_t lods);
 		std::string_view LodFileName(uint32_t lod) const;
@@ -142,6 +160,8 @@ namespace KlayGE
 		float3 scale_ = float3(1, 1, 1);
 		uint8_t axis_mapping_[3] = { 0, 1, 2 };
 		bool flip_winding_order_ = false;
+		float animation_tolerance_ = 1e-3f;
+		bool quantize_animation_ = false;
 		std::vector<std::string> lod_file_names_;
 		std::vector<std::string> material_file_names_;
 
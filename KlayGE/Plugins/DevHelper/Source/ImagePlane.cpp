@@ -780,39 +780,6 @@ namespace KlayGE
 
 		std::vector<uint8_t> new_tex_data(slice_pitch);
 
-		CpuInfo cpu;
-		uint32_t const num_threads = cpu.NumHWThreads();
-		ThreadPool tp(1, num_threads);
-		std::vector<std::future<void>> joiners(num_threads);
-
-		uint32_t const tex_region_height = ((tex_height + num_threads - 1) / num_threads + block_height - 1) & ~(block_height - 1);
-		std::vector<TexturePtr> new_tex_regions(num_threads);
-		for (uint32_t i = 0; i < num_threads; ++ i)
-		{
-			joiners[i] = tp.QueueThread(
-				[block_height, tex_width, tex_height, tex_region_height, i, format, row_pitch,
-					&new_tex_data, &new_tex_regions, this]
-				{
-					uint32_t const this_tex_region_height = MathLib::clamp(static_cast<int>(tex_height - i * tex_region_height),
-						0, static_cast<int>(tex_region_height));
-					if (this_tex_region_height > 0)
-					{
-						new_tex_regions[i] = MakeSharedPtr<SoftwareTexture>(Texture::TT_2D, tex_width, this_tex_region_height,
-							1, 1, 1, format, true);
-
-						ElementInitData init_data;
-						init_data.data = new_tex_data.data() + i * tex_region_height / block_height * row_pitch;
-						init_data.row_pitch = row_pitch;
-						init_data.slice_pitch = (this_tex_region_height + block_height - 1) / block_height * row_pitch;
-
-						new_tex_regions[i]->CreateHWResource(MakeSpan<1>(init_data), nullptr);
-
-						uncompressed_tex_->CopyToSubTexture2D(*new_tex_regions[i], 0, 0, 0, 0, tex_width, this_tex_region_height,
-							0, 0, 0, i * tex_region_height, tex_width, this_tex_region_height, TextureFilter::Point);
-					}
-				});
-		}
-
 		TexturePtr new_tex = MakeSharedPtr<SoftwareTexture>(Texture::TT_2D, uncompressed_tex_->Width(0), uncompressed_tex_->Height(0),
 			1, 1, 1, format, false);
 		ElementInitData init_data;
@@ -820,12 +787,53 @@ namespace KlayGE
 		init_data.row_pitch = row_pitch;
 		init_data.slice_pitch = slice_pitch;
 
-		for (uint32_t i = 0; i < num_threads; ++ i)
+		if (IsCompressedFormat(format))
 		{
-			joiners[i].wait();
+			// The codec splits block rows across threads itself
+			new_tex->CreateHWResource(MakeSpan<1>(init_data), nullptr);
+			uncompressed_tex_->CopyToTexture(*new_tex, TextureFilter::Point);
 		}
+		else
+		{
+			CpuInfo cpu;
+			uint32_t const num_threads = cpu.NumHWThreads();
+			ThreadPool tp(1, num_threads);
+			std::vector<std::future<void>> joiners(num_threads);
+
+			uint32_t const tex_region_height = (tex_height + num_threads - 1) / num_threads;
+			std::vector<TexturePtr> new_tex_regions(num_threads);
+			for (uint32_t i = 0; i < num_threads; ++ i)
+			{
+				joiners[i] = tp.QueueThread(
+					[tex_width, tex_height, tex_region_height, i, format, row_pitch, &new_tex_data, &new_tex_regions, this]
+					{
+						uint32_t const this_tex_region_height = MathLib::clamp(static_cast<int>(tex_height - i * tex_region_height),
+							0, static_cast<int>(tex_region_height));
+						if (this_tex_region_height > 0)
+						{
+							new_tex_regions[i] = MakeSharedPtr<SoftwareTexture>(Texture::TT_2D, tex_width, this_tex_region_height,
+								1, 1, 1, format, true);
+
+							ElementInitData init_data;
+							init_data.data = new_tex_data.data() + i * tex_region_height * row_pitch;
+							init_data.row_pitch = row_pitch;
+							init_data.slice_pitch = this_tex_region_height * row_pitch;
+
+							new_tex_regions[i]->CreateHWResource(MakeSpan<1>(init_data), nullptr);
+
+							uncompressed_tex_->CopyToSubTexture2D(*new_tex_regions[i], 0, 0, 0, 0, tex_width, this_tex_region_height,
+								0, 0, 0, i * tex_region_height, tex_width, this_tex_region_height, TextureFilter::Point);
+						}
+					});
+			}
+
+			for (uint32_t i = 0; i < num_threads; ++ i)
+			{
+				joiners[i].wait();
+			}
 
-		new_tex->CreateHWResource(MakeSpan<1>(init_data), nullptr);
+			new_tex->CreateHWResource(MakeSpan<1>(init_data), nullptr);
+		}
 
 		if (IsCompressedFormat(format))
 		{
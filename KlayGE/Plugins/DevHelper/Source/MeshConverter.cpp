@@ -316,6 +316,9 @@ namespace
 		bool has_texcoord_;
 		bool has_diffuse_;
 		bool has_specular_;
+
+		float animation_tolerance_;
+		bool quantize_animation_;
 	};
 
 	class MeshSaver
@@ -1372,7 +1375,7 @@ namespace
 				KlayGE::Convert(name, mesh.Name());
 				ai_mesh.mName.Set(name.c_str());
 
-				auto const & rl = mesh.GetRenderLayout();
+				auto const & rl = mesh.GetRenderLayout(lod);
 
 				ai_mesh.mNumVertices = mesh.NumVertices(lod);
 				uint32_t const start_vertex = mesh.StartVertexLocation(lod);
@@ -1778,6 +1781,7 @@ namespace
 			if (skinned)
 			{
 				SkinnedModel const& skinned_model = checked_cast<SkinnedModel const&>(model);
+				auto const kfs = skinned_model.GetKeyFrameSets();
 
 				ai_scene.mNumAnimations = skinned_model.NumAnimations();
 				ai_scene.mAnimations = new aiAnimation*[ai_scene.mNumAnimations];
@@ -1795,7 +1799,7 @@ namespace
 					std::vector<uint32_t> non_trivial_joint_indices;
 					for (uint32_t ji = 0; ji < skinned_model.NumJoints(); ++ji)
 					{
-						auto& key_frame_set = (*skinned_model.GetKeyFrameSets())[ji];
+						auto const& key_frame_set = (*kfs)[ji];
 						if (key_frame_set.frame_id.size() > 1)
 						{
 							non_trivial_joint_indices.push_back(ji);
@@ -1823,7 +1827,7 @@ namespace
 					for (size_t ci = 0; ci < non_trivial_joint_indices.size(); ++ci)
 					{
 						uint32_t const ji = non_trivial_joint_indices[ci];
-						auto& key_frame_set = (*skinned_model.GetKeyFrameSets())[ji];
+						auto const& key_frame_set = (*kfs)[ji];
 						ai_scene.mAnimations[ai]->mChannels[ci] = new aiNodeAnim;
 						auto& node_anim = *ai_scene.mAnimations[ai]->mChannels[ci];
 
@@ -3199,11 +3203,11 @@ namespace
 			this->CompileKeyFramesChunk(*key_frames_chunk);
 
 			auto& skinned_model = checked_cast<SkinnedModel&>(*render_model_);
-			auto& kfs = *skinned_model.GetKeyFrameSets();
+			auto kfs = MakeSharedPtr<std::vector<KeyFrameSet>>(*skinned_model.GetKeyFrameSets());
 
-			for (size_t i = 0; i < kfs.size(); ++ i)
+			for (size_t i = 0; i < kfs->size(); ++ i)
 			{
-				auto& kf = kfs[i];
+				auto& kf = (*kfs)[i];
 				if (kf.frame_id.empty())
 				{
 					auto const& joint = *joints_[i].joint;
@@ -3231,6 +3235,7 @@ namespace
 					kf.bind_scale.push_back(joint.BindScale() * inv_parent_scale);
 				}
 			}
+			skinned_model.AttachKeyFrameSets(kfs);
 
 			XMLNode const* bb_kfs_chunk = root.FirstNode("bb_key_frames_chunk");
 			for (uint32_t mesh_index = 0; mesh_index < skinned_model.NumMeshes(); ++ mesh_index)
@@ -3288,7 +3293,7 @@ namespace
 		}
 
 		auto& skinned_model = checked_cast<SkinnedModel&>(*render_model_);
-		auto& kfs = *skinned_model.GetKeyFrameSets();
+		auto kfs = MakeSharedPtr<std::vector<KeyFrameSet>>(*skinned_model.GetKeyFrameSets());
 
 		for (uint32_t ji = 0; ji < joints_.size(); ++ ji)
 		{
@@ -3296,7 +3301,7 @@ namespace
 			{
 				BOOST_ASSERT(joint_mapping[ji] <= ji);
 				joints_[joint_mapping[ji]] = joints_[ji];
-				kfs[joint_mapping[ji]] = kfs[ji];
+				(*kfs)[joint_mapping[ji]] = (*kfs)[ji];
 			}
 			else
 			{
@@ -3304,7 +3309,8 @@ namespace
 			}
 		}
 		joints_.resize(new_joint_id);
-		kfs.resize(joints_.size());
+		kfs->resize(joints_.size());
+		skinned_model.AttachKeyFrameSets(kfs);
 
 		for (auto& mesh : meshes_)
 		{
@@ -3356,54 +3362,115 @@ namespace
 
 	void MeshLoader::CompressKeyFrameSet(KeyFrameSet& kf)
 	{
-		float const THRESHOLD = 1e-3f;
+		// Longest run of keys replaced by one blend, to bound the time of checking a run
+		int const MAX_KEY_SPAN = 128;
 
 		BOOST_ASSERT((kf.bind_real.size() == kf.bind_dual.size())
 			&& (kf.frame_id.size() == kf.bind_scale.size())
 			&& (kf.frame_id.size() == kf.bind_real.size()));
 
-		int base = 0;
-		while (base < static_cast<int>(kf.frame_id.size() - 2))
+		int const num_keys = static_cast<int>(kf.frame_id.size());
+		if (num_keys < 2)
 		{
-			int const frame0 = kf.frame_id[base + 0];
-			int const frame1 = kf.frame_id[base + 1];
-			int const frame2 = kf.frame_id[base + 2];
-			float const factor = static_cast<float>(frame1 - frame0) / (frame2 - frame0);
-			Quaternion interpolate_real;
-			Quaternion interpolate_dual;
-			std::tie(interpolate_real, interpolate_dual) = MathLib::sclerp(kf.bind_real[base + 0], kf.bind_dual[base + 0],
-				kf.bind_real[base + 2], kf.bind_dual[base + 2], factor);
-			float const scale = MathLib::lerp(kf.bind_scale[base + 0], kf.bind_scale[base + 2], factor);
+			return;
+		}
 
-			if (MathLib::dot(kf.bind_real[base + 1], interpolate_real) < 0)
+		float const tolerance = animation_tolerance_;
+		auto const is_close = [tolerance](Quaternion const & real, Quaternion const & dual, float scale,
+			Quaternion approx_real, Quaternion approx_dual, float approx_scale)
+		{
+			if (MathLib::dot(real, approx_real) < 0)
 			{
-				interpolate_real = -interpolate_real;
-				interpolate_dual = -interpolate_dual;
+				approx_real = -approx_real;
+				approx_dual = -approx_dual;
 			}
 
 			Quaternion diff_real;
 			Quaternion diff_dual;
-			std::tie(diff_real, diff_dual) = MathLib::inverse(kf.bind_real[base + 1], kf.bind_dual[base + 1]);
-			diff_dual = MathLib::mul_dual(diff_real, diff_dual * scale, interpolate_real, interpolate_dual);
-			diff_real = MathLib::mul_real(diff_real, interpolate_real);
-			float diff_scale = scale * kf.bind_scale[base + 1];
-
-			if ((MathLib::abs(diff_real.x()) < THRESHOLD) && (MathLib::abs(diff_real.y()) < THRESHOLD)
-				&& (MathLib::abs(diff_real.z()) < THRESHOLD) && (MathLib::abs(diff_real.w() - 1) < THRESHOLD)
-				&& (MathLib::abs(diff_dual.x()) < THRESHOLD) && (MathLib::abs(diff_dual.y()) < THRESHOLD)
-				&& (MathLib::abs(diff_dual.z()) < THRESHOLD) && (MathLib::abs(diff_dual.w()) < THRESHOLD)
-				&& (MathLib::abs(diff_scale - 1) < THRESHOLD))
-			{
-				kf.frame_id.erase(kf.frame_id.begin() + base + 1);
-				kf.bind_real.erase(kf.bind_real.begin() + base + 1);
-				kf.bind_dual.erase(kf.bind_dual.begin() + base + 1);
-				kf.bind_scale.erase(kf.bind_scale.begin() + base + 1);
+			std::tie(diff_real, diff_dual) = MathLib::inverse(real, dual);
+			diff_dual = MathLib::mul_dual(diff_real, diff_dual, approx_real, approx_dual);
+			diff_real = MathLib::mul_real(diff_real, approx_real);
+
+			return (MathLib::abs(diff_real.x()) < tolerance) && (MathLib::abs(diff_real.y()) < tolerance)
+				&& (MathLib::abs(diff_real.z()) < tolerance) && (MathLib::abs(diff_real.w() - 1) < tolerance)
+				&& (MathLib::abs(diff_dual.x()) < tolerance) && (MathLib::abs(diff_dual.y()) < tolerance)
+				&& (MathLib::abs(diff_dual.z()) < tolerance) && (MathLib::abs(diff_dual.w()) < tolerance)
+				&& (MathLib::abs(approx_scale - scale) < tolerance * MathLib::abs(scale));
+		};
+
+		// A track that doesn't move needs only one key
+		bool constant = true;
+		for (int i = 1; (i < num_keys) && constant; ++ i)
+		{
+			constant = is_close(kf.bind_real[i], kf.bind_dual[i], kf.bind_scale[i],
+				kf.bind_real[0], kf.bind_dual[0], kf.bind_scale[0]);
+		}
+		if (constant)
+		{
+			kf.frame_id.resize(1);
+			kf.bind_real.resize(1);
+			kf.bind_dual.resize(1);
+			kf.bind_scale.resize(1);
+			return;
+		}
+
+		// Extends every run of dropped keys as long as all of them, in the source keys, are still within the tolerance of the blend
+		// of the keys around the run. The blend is the one used in playing, but the keys around the run are checked before quantizing,
+		// so a quantized track can be off by another half step of 16 bits, in the rotation and in the range of the track.
+		bool const quantize = quantize_animation_;
+		auto const within_tolerance = [&kf, &is_close, quantize](int key0, int key1)
+		{
+			for (int i = key0 + 1; i < key1; ++ i)
+			{
+				float const factor = static_cast<float>(kf.frame_id[i] - kf.frame_id[key0]) / (kf.frame_id[key1] - kf.frame_id[key0]);
+
+				Quaternion approx_real;
+				Quaternion approx_dual;
+				float approx_scale;
+				if (quantize)
+				{
+					std::tie(approx_real, approx_dual, approx_scale) = KeyFrameTracks::QuantizedBlend(kf.bind_real[key0],
+						kf.bind_dual[key0], kf.bind_scale[key0], kf.bind_real[key1], kf.bind_dual[key1], kf.bind_scale[key1], factor);
+				}
+				else
+				{
+					std::tie(approx_real, approx_dual) = MathLib::sclerp(kf.bind_real[key0], kf.bind_dual[key0],
+						kf.bind_real[key1], kf.bind_dual[key1], factor);
+					approx_scale = MathLib::lerp(kf.bind_scale[key0], kf.bind_scale[key1], factor);
+				}
+
+				if (!is_close(kf.bind_real[i], kf.bind_dual[i], kf.bind_scale[i], approx_real, approx_dual, approx_scale))
+				{
+					return false;
+				}
 			}
-			else
+			return true;
+		};
+
+		std::vector<int> kept_keys(1, 0);
+		int key = 0;
+		while (key < num_keys - 1)
+		{
+			int next_key = key + 1;
+			while ((next_key + 1 < num_keys) && (next_key + 1 - key <= MAX_KEY_SPAN) && within_tolerance(key, next_key + 1))
 			{
-				++ base;
+				++ next_key;
 			}
+			kept_keys.push_back(next_key);
+			key = next_key;
+		}
+
+		for (size_t i = 0; i < kept_keys.size(); ++ i)
+		{
+			kf.frame_id[i] = kf.frame_id[kept_keys[i]];
+			kf.bind_real[i] = kf.bind_real[kept_keys[i]];
+			kf.bind_dual[i] = kf.bind_dual[kept_keys[i]];
+			kf.bind_scale[i] = kf.bind_scale[kept_keys[i]];
 		}
+		kf.frame_id.resize(kept_keys.size());
+		kf.bind_real.resize(kept_keys.size());
+		kf.bind_dual.resize(kept_keys.size());
+		kf.bind_scale.resize(kept_keys.size());
 	}
 
 
@@ -3435,11 +3502,23 @@ namespace
 		has_texcoord_ = false;
 		has_diffuse_ = false;
 		has_specular_ = false;
+		animation_tolerance_ = metadata.AnimationTolerance();
+		quantize_animation_ = metadata.QuantizeAnimation();
 
 		auto const input_ext = input_path.extension();
 		if (input_ext == ".model_bin")
 		{
 			render_model_ = LoadSoftwareModel(input_name_str);
+			if (render_model_ && render_model_->IsSkinned())
+			{
+				checked_cast<SkinnedModel&>(*render_model_).QuantizeKeyFrames(quantize_animation_);
+			}
+
+			if (!in_path)
+			{
+				res_loader.DelPath(in_folder);
+			}
+
 			return render_model_;
 		}
 		else if (input_ext == ".meshml")
@@ -3853,6 +3932,11 @@ namespace
 		nodes_[0].node->UpdatePosBoundSubtree();
 		nodes_[0].node->TransformToParent(nodes_[0].node->TransformToParent() * global_transform);
 
+		if (skinned)
+		{
+			checked_cast<SkinnedModel&>(*render_model_).QuantizeKeyFrames(quantize_animation_);
+		}
+
 		if (!in_path)
 		{
 			Context::Instance().ResLoaderInstance().DelPath(in_folder);
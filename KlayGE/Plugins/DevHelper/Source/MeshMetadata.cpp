@@ -130,6 +130,16 @@ namespace KlayGE
 				new_metadata.flip_winding_order_ = flip_winding_order_val->ValueBool();
 			}
 
+			if (auto const* animation_tolerance_val = root_value.Member("animation_tolerance"))
+			{
+				new_metadata.animation_tolerance_ = GetFloat(*animation_tolerance_val);
+			}
+
+			if (auto const* quantize_animation_val = root_value.Member("quantize_animation"))
+			{
+				new_metadata.quantize_animation_ = quantize_animation_val->ValueBool();
+			}
+
 			if (auto const* materials_val = root_value.Member("materials"))
 			{
 				auto const& values = materials_val->ValueArray();
@@ -252,6 +262,16 @@ namespace KlayGE
 			root_value.AppendValue("flip_winding_order", JsonValue(flip_winding_order_));
 		}
 
+		if (!MathLib::equal(animation_tolerance_, 1e-3f))
+		{
+			root_value.AppendValue("animation_tolerance", JsonValue(animation_tolerance_));
+		}
+
+		if (quantize_animation_)
+		{
+			root_value.AppendValue("quantize_animation", JsonValue(quantize_animation_));
+		}
+
 		if (!material_file_names_.empty())
 		{
 			JsonValue material_file_names_val(JsonValueType::Array);
@@ -23,11 +23,13 @@
 //////////////////////////////////////////////////////////////////////////////////
 
 #include <KlayGE/KlayGE.hpp>
+#include <KFL/CXX20/span.hpp>
 #include <KFL/Util.hpp>
 #include <KFL/Math.hpp>
 #include <KFL/Vector.hpp>
 #include <KFL/Matrix.hpp>
 #include <KFL/Plane.hpp>
+#include <KFL/Thread.hpp>
 #include <KlayGE/SceneNode.hpp>
 #include <KlayGE/Camera.hpp>
 #include <KlayGE/App3D.hpp>
@@ -40,6 +42,10 @@
 #include <algorithm>
 #include <boost/assert.hpp>
 
+#if defined(KLAYGE_SSE_SUPPORT)
+#include <xmmintrin.h>
+#endif
+
 #ifdef KLAYGE_DRAW_NODES
 #include <KlayGE/RenderEffect.hpp>
 #endif
@@ -118,6 +124,7 @@ namespace KlayGE
 		if (rebuild_tree_)
 		{
 			octree_.resize(1);
+			std::vector<std::vector<SceneNode*>> node_objs(1);
 			AABBox bb_root(float3(0, 0, 0), float3(0, 0, 0));
 			octree_[0].first_child_index = -1;
 			octree_[0].visible = BoundOverlap::No;
@@ -128,7 +135,7 @@ namespace KlayGE
 				if (node.Updated() && (attr & SceneNode::SOA_Cullable) && !(attr & SceneNode::SOA_Moveable))
 				{
 					bb_root |= node.PosBoundWS();
-					octree_[0].node_ptrs.push_back(sn);
+					node_objs[0].push_back(sn);
 				}
 			}
 			float3 const & center = bb_root.Center();
@@ -137,7 +144,15 @@ namespace KlayGE
 			float3 new_extent(longest_dim, longest_dim, longest_dim);
 			octree_[0].bb = AABBox(center - new_extent, center + new_extent);
 
-			this->DivideNode(0, 1);
+			this->DivideNode(0, 1, node_objs);
+
+			octree_objs_.clear();
+			for (size_t i = 0; i < octree_.size(); ++ i)
+			{
+				octree_[i].first_obj_index = static_cast<uint32_t>(octree_objs_.size());
+				octree_[i].num_objs = static_cast<uint32_t>(node_objs[i].size());
+				octree_objs_.insert(octree_objs_.end(), node_objs[i].begin(), node_objs[i].end());
+			}
 
 			rebuild_tree_ = false;
 		}
@@ -152,6 +167,7 @@ namespace KlayGE
 
 		if (!octree_.empty())
 		{
+			this->UpdateFrustumPackets();
 			this->NodeVisible(0);
 		}
 
@@ -259,6 +275,7 @@ namespace KlayGE
 		SceneManager::ClearObject();
 
 		octree_.clear();
+		octree_objs_.clear();
 		rebuild_tree_ = true;
 	}
 
@@ -277,9 +294,9 @@ namespace KlayGE
 		// TODO
 	}
 
-	void OCTree::DivideNode(size_t index, uint32_t curr_depth)
+	void OCTree::DivideNode(size_t index, uint32_t curr_depth, std::vector<std::vector<SceneNode*>>& node_objs)
 	{
-		if (octree_[index].node_ptrs.size() > 1)
+		if (node_objs[index].size() > 1)
 		{
 			size_t const this_size = octree_.size();
 			AABBox const parent_bb = octree_[index].bb;
@@ -288,7 +305,8 @@ namespace KlayGE
 			octree_[index].visible = BoundOverlap::No;
 
 			octree_.resize(this_size + 8);
-			for (auto* node : octree_[index].node_ptrs)
+			node_objs.resize(this_size + 8);
+			for (auto* node : node_objs[index])
 			{
 				AABBox const & aabb = node->PosBoundWS();
 				int mark[6];
@@ -304,7 +322,7 @@ namespace KlayGE
 						+ ((j & 2) ? mark[4] : mark[1])
 						+ ((j & 4) ? mark[5] : mark[2]))
 					{
-						octree_[this_size + j].node_ptrs.push_back(node);
+						node_objs[this_size + j].push_back(node);
 					}
 				}
 			}
@@ -322,13 +340,141 @@ namespace KlayGE
 
 				if (curr_depth < max_tree_depth_)
 				{
-					this->DivideNode(this_size + j, curr_depth + 1);
+					this->DivideNode(this_size + j, curr_depth + 1, node_objs);
+				}
+			}
+
+			node_objs[index].clear();
+			node_objs[index].shrink_to_fit();
+		}
+	}
+
+	void OCTree::UpdateFrustumPackets()
+	{
+		uint32_t const num_frustums = static_cast<uint32_t>(camera_frustums_.size());
+		frustum_packets_.resize((num_frustums + 3) / 4);
+		for (uint32_t i = 0; i < frustum_packets_.size() * 4; ++ i)
+		{
+			auto& packet = frustum_packets_[i / 4];
+			uint32_t const lane = i & 3;
+			for (uint32_t p = 0; p < 6; ++ p)
+			{
+				if (i < num_frustums)
+				{
+					Plane const & plane = camera_frustums_[i]->FrustumPlane(p);
+					packet.planes[p][0][lane] = plane.a();
+					packet.planes[p][1][lane] = plane.b();
+					packet.planes[p][2][lane] = plane.c();
+					packet.planes[p][3][lane] = plane.d();
 				}
+				else
+				{
+					// Padding lanes reject every box, so they never raise the result
+					packet.planes[p][0][lane] = 0;
+					packet.planes[p][1][lane] = 0;
+					packet.planes[p][2][lane] = 0;
+					packet.planes[p][3][lane] = -1;
+				}
+			}
+		}
+	}
+
+	// Same as SceneManager::AABBVisible, but tests 4 frustums at a time. Every lane does the exact operations of
+	// MathLib::intersect_aabb_frustum, so the results are identical.
+	BoundOverlap OCTree::PacketAABBVisible(AABBox const & aabb) const
+	{
+		if (frustum_packets_.empty())
+		{
+			return BoundOverlap::Yes;
+		}
+
+		float3 const & min_pt = aabb.Min();
+		float3 const & max_pt = aabb.Max();
+
+		BoundOverlap ret = BoundOverlap::No;
+#if defined(KLAYGE_SSE_SUPPORT)
+		__m128 const zero = _mm_setzero_ps();
+		__m128 const min_x = _mm_set1_ps(min_pt.x());
+		__m128 const min_y = _mm_set1_ps(min_pt.y());
+		__m128 const min_z = _mm_set1_ps(min_pt.z());
+		__m128 const max_x = _mm_set1_ps(max_pt.x());
+		__m128 const max_y = _mm_set1_ps(max_pt.y());
+		__m128 const max_z = _mm_set1_ps(max_pt.z());
+		for (auto const & packet : frustum_packets_)
+		{
+			__m128 outside = zero;
+			__m128 intersect = zero;
+			for (int i = 0; i < 6; ++ i)
+			{
+				__m128 const a = _mm_load_ps(packet.planes[i][0]);
+				__m128 const b = _mm_load_ps(packet.planes[i][1]);
+				__m128 const c = _mm_load_ps(packet.planes[i][2]);
+				__m128 const d = _mm_load_ps(packet.planes[i][3]);
+				__m128 const neg_a = _mm_cmplt_ps(a, zero);
+				__m128 const neg_b = _mm_cmplt_ps(b, zero);
+				__m128 const neg_c = _mm_cmplt_ps(c, zero);
+
+				// v1 is diagonally opposed to v0
+				__m128 const v0_x = _mm_or_ps(_mm_and_ps(neg_a, min_x), _mm_andnot_ps(neg_a, max_x));
+				__m128 const v0_y = _mm_or_ps(_mm_and_ps(neg_b, min_y), _mm_andnot_ps(neg_b, max_y));
+				__m128 const v0_z = _mm_or_ps(_mm_and_ps(neg_c, min_z), _mm_andnot_ps(neg_c, max_z));
+				__m128 const v1_x = _mm_or_ps(_mm_and_ps(neg_a, max_x), _mm_andnot_ps(neg_a, min_x));
+				__m128 const v1_y = _mm_or_ps(_mm_and_ps(neg_b, max_y), _mm_andnot_ps(neg_b, min_y));
+				__m128 const v1_z = _mm_or_ps(_mm_and_ps(neg_c, max_z), _mm_andnot_ps(neg_c, min_z));
+
+				__m128 const dist0 = _mm_add_ps(
+					_mm_add_ps(_mm_add_ps(_mm_mul_ps(a, v0_x), _mm_mul_ps(b, v0_y)), _mm_mul_ps(c, v0_z)), d);
+				__m128 const dist1 = _mm_add_ps(
+					_mm_add_ps(_mm_add_ps(_mm_mul_ps(a, v1_x), _mm_mul_ps(b, v1_y)), _mm_mul_ps(c, v1_z)), d);
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(dist0, zero));
+				intersect = _mm_or_ps(intersect, _mm_cmplt_ps(dist1, zero));
 			}
 
-			octree_[index].node_ptrs.clear();
-			octree_[index].node_ptrs.shrink_to_fit();
+			int const outside_mask = _mm_movemask_ps(outside);
+			int const intersect_mask = _mm_movemask_ps(intersect);
+			if (~(outside_mask | intersect_mask) & 0xF)
+			{
+				return BoundOverlap::Yes;
+			}
+			if (~outside_mask & 0xF)
+			{
+				ret = BoundOverlap::Partial;
+			}
 		}
+#else
+		for (auto const & packet : frustum_packets_)
+		{
+			for (uint32_t lane = 0; lane < 4; ++ lane)
+			{
+				bool outside = false;
+				bool intersect = false;
+				for (int i = 0; i < 6; ++ i)
+				{
+					float const a = packet.planes[i][0][lane];
+					float const b = packet.planes[i][1][lane];
+					float const c = packet.planes[i][2][lane];
+					float const d = packet.planes[i][3][lane];
+
+					// v1 is diagonally opposed to v0
+					float3 const v0((a < 0) ? min_pt.x() : max_pt.x(), (b < 0) ? min_pt.y() : max_pt.y(), (c < 0) ? min_pt.z() : max_pt.z());
+					float3 const v1((a < 0) ? max_pt.x() : min_pt.x(), (b < 0) ? max_pt.y() : min_pt.y(), (c < 0) ? max_pt.z() : min_pt.z());
+
+					outside |= (a * v0.x() + b * v0.y() + c * v0.z() + d < 0);
+					intersect |= (a * v1.x() + b * v1.y() + c * v1.z() + d < 0);
+				}
+
+				if (!outside)
+				{
+					if (!intersect)
+					{
+						return BoundOverlap::Yes;
+					}
+					ret = BoundOverlap::Partial;
+				}
+			}
+		}
+#endif
+		return ret;
 	}
 
 	void OCTree::NodeVisible(size_t index)
@@ -363,14 +509,32 @@ namespace KlayGE
 
 		if (large_enough)
 		{
-			octree_node.visible = SceneManager::AABBVisible(octree_node.bb);
+			octree_node.visible = this->PacketAABBVisible(octree_node.bb);
 			if (BoundOverlap::Partial == octree_node.visible)
 			{
-				if (octree_node.first_child_index != -1)
+				int const first_child_index = octree_node.first_child_index;
+				if (first_child_index != -1)
 				{
-					for (int i = 0; i < 8; ++ i)
+#ifndef KLAYGE_DRAW_NODES
+					if ((index == 0) && (octree_.size() >= parallel_culling_threshold_))
+					{
+						// Subtrees write to disjoint nodes
+						ParallelFor(Context::Instance().ThreadPoolInstance(), 8, 1,
+							[this, first_child_index](uint32_t begin, uint32_t end)
+							{
+								for (uint32_t i = begin; i < end; ++ i)
+								{
+									this->NodeVisible(first_child_index + i);
+								}
+							});
+					}
+					else
+#endif
 					{
-						this->NodeVisible(octree_node.first_child_index + i);
+						for (int i = 0; i < 8; ++ i)
+						{
+							this->NodeVisible(first_child_index + i);
+						}
 					}
 				}
 			}
@@ -400,7 +564,7 @@ namespace KlayGE
 		auto const & octree_node = octree_[index];
 		if ((octree_node.visible != BoundOverlap::No) || force)
 		{
-			for (auto* node : octree_node.node_ptrs)
+			for (auto* node : std::span(octree_objs_).subspan(octree_node.first_obj_index, octree_node.num_objs))
 			{
 				if (node->Visible())
 				{
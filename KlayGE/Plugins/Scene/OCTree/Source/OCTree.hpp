@@ -55,7 +55,9 @@ namespace KlayGE
 		void DoSuspend() override;
 		void DoResume() override;
 
-		void DivideNode(size_t index, uint32_t curr_depth);
+		void DivideNode(size_t index, uint32_t curr_depth, std::vector<std::vector<SceneNode*>>& node_objs);
+		void UpdateFrustumPackets();
+		BoundOverlap PacketAABBVisible(AABBox const & aabb) const;
 		void NodeVisible(size_t index);
 		void MarkNodeObjs(size_t index, bool force);
 
@@ -75,10 +77,21 @@ namespace KlayGE
 			int first_child_index;
 			BoundOverlap visible;
 
-			std::vector<SceneNode*> node_ptrs;
+			uint32_t first_obj_index;
+			uint32_t num_objs;
+		};
+
+		// Planes of 4 camera frustums, stored as [plane][a, b, c, d][camera]
+		struct frustum_packet_t
+		{
+			alignas(16) float planes[6][4][4];
 		};
 
 		std::vector<octree_node_t> octree_;
+		// Scene nodes of all octree nodes, each octree node owns a contiguous range
+		std::vector<SceneNode*> octree_objs_;
+
+		std::vector<frustum_packet_t> frustum_packets_;
 
 		uint32_t max_tree_depth_;
 
@@ -0,0 +1,320 @@
+/**
+ * @file DXBC2GLSLTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KlayGE/KlayGE.hpp>
+#include <DXBC2GLSL/DXBC2GLSL.hpp>
+
+#include <cstring>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "KlayGETests.hpp"
+
+using namespace std;
+
+namespace
+{
+	uint32_t OpcodeToken(ShaderOpcode opcode, uint32_t length)
+	{
+		return opcode | (length << 24);
+	}
+
+	uint32_t OperandToken(ShaderOperandType type, ShaderOperandSelectionMode mode, uint32_t sel, uint32_t num_indices)
+	{
+		return SONC_4 | (mode << 2) | (sel << 4) | (type << 12) | (num_indices << 20);
+	}
+
+	uint32_t ImmediateToken()
+	{
+		return OperandToken(SOT_IMMEDIATE32, SOSM_MASK, 0, 0);
+	}
+
+	uint32_t FloatToken(float value)
+	{
+		uint32_t ret;
+		std::memcpy(&ret, &value, sizeof(ret));
+		return ret;
+	}
+
+	void AppendString(std::vector<uint32_t>& tokens, std::string_view str)
+	{
+		std::vector<uint32_t> str_tokens((str.size() + sizeof(uint32_t)) / sizeof(uint32_t), 0);
+		std::memcpy(str_tokens.data(), str.data(), str.size());
+		tokens.insert(tokens.end(), str_tokens.begin(), str_tokens.end());
+	}
+
+	struct SignatureElement
+	{
+		std::string_view semantic_name;
+		ShaderName system_value_type;
+		uint32_t register_index;
+		uint8_t mask;
+		uint8_t read_write_mask;
+	};
+
+	std::vector<uint32_t> MakeSignature(std::span<SignatureElement const> elements)
+	{
+		// name_offset, semantic_index, system_value_type, component_type, register_num, and the masks
+		uint32_t const element_size = 6;
+
+		std::vector<uint32_t> tokens = {static_cast<uint32_t>(elements.size()), 8};
+		std::vector<uint32_t> names;
+		uint32_t names_offset = static_cast<uint32_t>((tokens.size() + elements.size() * element_size) * sizeof(uint32_t));
+		for (auto const & element : elements)
+		{
+			tokens.push_back(names_offset + static_cast<uint32_t>(names.size() * sizeof(uint32_t)));
+			tokens.push_back(0);
+			tokens.push_back(element.system_value_type);
+			tokens.push_back(SRCT_FLOAT32);
+			tokens.push_back(element.register_index);
+			tokens.push_back(element.mask | (element.read_write_mask << 8));
+			AppendString(names, element.semantic_name);
+		}
+		tokens.insert(tokens.end(), names.begin(), names.end());
+		return tokens;
+	}
+
+	// vs_4_0 that scales and biases the position by literals, and passes a texcoord through:
+	//   mul r0.xyzw, v0.xyzw, l(0.5, 2.0, -1.25, 1.0)
+	//   add o0.xyzw, r0.xyzw, l(0.0, 0.1, 100000.0, 3e-6)
+	//   mov o1.xy, v1.xyxx
+	//   mov o1.zw, l(0.0, 0.0, 1.0, 7.0)
+	std::vector<uint8_t> MakeVertexShaderDXBC()
+	{
+		uint32_t const xyzw = 0xF;
+		uint32_t const swizzle_xyzw = 0 | (1 << 2) | (2 << 4) | (3 << 6);
+		uint32_t const swizzle_xyxx = 0 | (1 << 2);
+
+		std::vector<uint32_t> code =
+		{
+			(ST_VS << 16) | (4 << 4) | 0, 0,
+
+			OpcodeToken(SO_DCL_INPUT, 3), OperandToken(SOT_INPUT, SOSM_MASK, xyzw, 1), 0,
+			OpcodeToken(SO_DCL_INPUT, 3), OperandToken(SOT_INPUT, SOSM_MASK, 0x3, 1), 1,
+			OpcodeToken(SO_DCL_OUTPUT_SIV, 4), OperandToken(SOT_OUTPUT, SOSM_MASK, xyzw, 1), 0, SSV_POSITION,
+			OpcodeToken(SO_DCL_OUTPUT, 3), OperandToken(SOT_OUTPUT, SOSM_MASK, xyzw, 1), 1,
+			OpcodeToken(SO_DCL_TEMPS, 2), 1,
+
+			OpcodeToken(SO_MUL, 10),
+				OperandToken(SOT_TEMP, SOSM_MASK, xyzw, 1), 0,
+				OperandToken(SOT_INPUT, SOSM_SWIZZLE, swizzle_xyzw, 1), 0,
+				ImmediateToken(), FloatToken(0.5f), FloatToken(2.0f), FloatToken(-1.25f), FloatToken(1.0f),
+			OpcodeToken(SO_ADD, 10),
+				OperandToken(SOT_OUTPUT, SOSM_MASK, xyzw, 1), 0,
+				OperandToken(SOT_TEMP, SOSM_SWIZZLE, swizzle_xyzw, 1), 0,
+				ImmediateToken(), FloatToken(0.0f), FloatToken(0.1f), FloatToken(100000.0f), FloatToken(3e-6f),
+			OpcodeToken(SO_MOV, 5),
+				OperandToken(SOT_OUTPUT, SOSM_MASK, 0x3, 1), 1,
+				OperandToken(SOT_INPUT, SOSM_SWIZZLE, swizzle_xyxx, 1), 1,
+			OpcodeToken(SO_MOV, 8),
+				OperandToken(SOT_OUTPUT, SOSM_MASK, 0xC, 1), 1,
+				ImmediateToken(), FloatToken(0.0f), FloatToken(0.0f), FloatToken(1.0f), FloatToken(7.0f),
+			OpcodeToken(SO_RET, 1)
+		};
+		code[1] = static_cast<uint32_t>(code.size());
+
+		SignatureElement const inputs[] =
+		{
+			{"POSITION", SN_UNDEFINED, 0, 0xF, 0xF},
+			{"TEXCOORD", SN_UNDEFINED, 1, 0x3, 0x3}
+		};
+		SignatureElement const outputs[] =
+		{
+			{"SV_Position", SN_POSITION, 0, 0xF, 0},
+			{"TEXCOORD", SN_UNDEFINED, 1, 0xF, 0}
+		};
+
+		std::pair<uint32_t, std::vector<uint32_t>> chunks[] =
+		{
+			{FOURCC_ISGN, MakeSignature(inputs)},
+			{FOURCC_OSGN, MakeSignature(outputs)},
+			{FOURCC_SHDR, code}
+		};
+
+		uint32_t const num_chunks = static_cast<uint32_t>(std::size(chunks));
+		std::vector<uint32_t> tokens(sizeof(DXBCContainerHeader) / sizeof(uint32_t) + num_chunks, 0);
+		for (uint32_t i = 0; i < num_chunks; ++ i)
+		{
+			tokens[sizeof(DXBCContainerHeader) / sizeof(uint32_t) + i] = static_cast<uint32_t>(tokens.size() * sizeof(uint32_t));
+			tokens.push_back(chunks[i].first);
+			tokens.push_back(static_cast<uint32_t>(chunks[i].second.size() * sizeof(uint32_t)));
+			tokens.insert(tokens.end(), chunks[i].second.begin(), chunks[i].second.end());
+		}
+
+		auto& header = *reinterpret_cast<DXBCContainerHeader*>(tokens.data());
+		header.fourcc = FOURCC_DXBC;
+		header.one = 1;
+		header.total_size = static_cast<uint32_t>(tokens.size() * sizeof(uint32_t));
+		header.chunk_count = num_chunks;
+
+		std::vector<uint8_t> ret(tokens.size() * sizeof(uint32_t));
+		std::memcpy(ret.data(), tokens.data(), ret.size());
+		return ret;
+	}
+
+	// Generated before GLSLGen wrote into a StringBuilder instead of a std::ostream. Floats keep the ostream formatting, including
+	// the showpoint that sticks once a float needed it.
+	std::string_view const vertex_shader_glsl_110 = R"(#version 110
+
+attribute vec4 POSITION0;
+attribute vec4 TEXCOORD0;
+
+varying vec4 v_TEXCOORD0;
+
+
+void main()
+{
+vec4 i_REGISTER0;
+vec4 i_REGISTER1;
+i_REGISTER0.xyzw = POSITION0.xyzw;
+i_REGISTER1.xy = TEXCOORD0.xy;
+
+vec4 o_REGISTER0;
+vec4 o_REGISTER1;
+
+vec4 tf0;
+ivec4 ti0;
+ivec4 iTempX[2];
+ivec4 uTempX[2];
+
+tf0.xyzw = vec4(i_REGISTER0.xyzw * vec4(0.500000, 2.00000, -1.25000, 1.00000)).xyzw;
+o_REGISTER0.xyzw = vec4(tf0.xyzw + vec4(0, 0.100000, 100000., 3.00000e-06)).xyzw;
+o_REGISTER1.xy = vec4(i_REGISTER1.xyxx).xy;
+o_REGISTER1.zw = vec4(vec4(0, 0, 1.00000, 7.00000)).zw;
+gl_Position.xyzw = o_REGISTER0.xyzw;
+v_TEXCOORD0.xyzw = o_REGISTER1.xyzw;
+return;
+
+}
+)";
+
+	std::string_view const vertex_shader_glsl_300_es = R"(#version 300 es
+
+precision highp float;
+precision highp int;
+
+layout(location=0) in vec4 POSITION0;
+layout(location=1) in vec4 TEXCOORD0;
+
+smooth out vec4 v_TEXCOORD0;
+
+
+void main()
+{
+vec4 i_REGISTER0;
+vec4 i_REGISTER1;
+i_REGISTER0.xyzw = POSITION0.xyzw;
+i_REGISTER1.xy = TEXCOORD0.xy;
+
+vec4 o_REGISTER0;
+vec4 o_REGISTER1;
+
+vec4 tf0;
+ivec4 ti0;
+ivec4 iTempX[2];
+uvec4 uTempX[2];
+
+tf0.xyzw = vec4(i_REGISTER0.xyzw * vec4(0.500000, 2.00000, -1.25000, 1.00000)).xyzw;
+o_REGISTER0.xyzw = vec4(tf0.xyzw + vec4(0, 0.100000, 100000., 3.00000e-06)).xyzw;
+o_REGISTER1.xy = vec4(i_REGISTER1.xyxx).xy;
+o_REGISTER1.zw = vec4(vec4(0, 0, 1.00000, 7.00000)).zw;
+gl_Position.xyzw = o_REGISTER0.xyzw;
+v_TEXCOORD0.xyzw = o_REGISTER1.xyzw;
+return;
+
+}
+)";
+}
+
+TEST(DXBC2GLSLTest, VertexShader)
+{
+	auto const dxbc = MakeVertexShaderDXBC();
+	DXBC2GLSL::DXBC2GLSL::ClearCache();
+
+	DXBC2GLSL::DXBC2GLSL dxbc2glsl;
+	dxbc2glsl.FeedDXBC(dxbc.data(), false, true, STP_Undefined, STOP_Undefined, GSV_110);
+	EXPECT_EQ(dxbc2glsl.GLSLString(), vertex_shader_glsl_110);
+
+	dxbc2glsl.FeedDXBC(dxbc.data(), false, true, STP_Undefined, STOP_Undefined, GSV_300_ES);
+	EXPECT_EQ(dxbc2glsl.GLSLString(), vertex_shader_glsl_300_es);
+
+	ASSERT_EQ(dxbc2glsl.NumInputParams(), 2U);
+	EXPECT_STREQ(dxbc2glsl.InputParam(0).semantic_name, "POSITION");
+	EXPECT_STREQ(dxbc2glsl.InputParam(1).semantic_name, "TEXCOORD");
+	ASSERT_EQ(dxbc2glsl.NumOutputParams(), 2U);
+	EXPECT_STREQ(dxbc2glsl.OutputParam(0).semantic_name, "SV_Position");
+	EXPECT_EQ(dxbc2glsl.OutputParam(0).system_value_type, SN_POSITION);
+}
+
+TEST(DXBC2GLSLTest, CachedTranslation)
+{
+	auto const dxbc = MakeVertexShaderDXBC();
+	DXBC2GLSL::DXBC2GLSL::ClearCache();
+
+	DXBC2GLSL::DXBC2GLSL dxbc2glsl;
+	dxbc2glsl.FeedDXBC(dxbc.data(), false, true, STP_Undefined, STOP_Undefined, GSV_110);
+
+	// The same blob at another address
+	auto const same_dxbc = dxbc;
+	DXBC2GLSL::DXBC2GLSL cached;
+	cached.FeedDXBC(same_dxbc.data(), false, true, STP_Undefined, STOP_Undefined, GSV_110);
+	EXPECT_EQ(&cached.GLSLString(), &dxbc2glsl.GLSLString());
+
+	// Another version is another translation
+	DXBC2GLSL::DXBC2GLSL other_version;
+	other_version.FeedDXBC(dxbc.data(), false, true, STP_Undefined, STOP_Undefined, GSV_300_ES);
+	EXPECT_NE(&other_version.GLSLString(), &dxbc2glsl.GLSLString());
+	EXPECT_EQ(other_version.GLSLString(), vertex_shader_glsl_300_es);
+
+	DXBC2GLSL::DXBC2GLSL::ClearCache();
+	DXBC2GLSL::DXBC2GLSL translated_again;
+	translated_again.FeedDXBC(dxbc.data(), false, true, STP_Undefined, STOP_Undefined, GSV_110);
+	EXPECT_NE(&translated_again.GLSLString(), &dxbc2glsl.GLSLString());
+	EXPECT_EQ(translated_again.GLSLString(), vertex_shader_glsl_110);
+}
+
+TEST(DXBC2GLSLTest, NotDXBC)
+{
+	auto const dxbc = MakeVertexShaderDXBC();
+
+	DXBC2GLSL::DXBC2GLSL dxbc2glsl;
+	dxbc2glsl.FeedDXBC(dxbc.data(), false, true, STP_Undefined, STOP_Undefined, GSV_110);
+	EXPECT_FALSE(dxbc2glsl.GLSLString().empty());
+
+	// Nothing of the shader fed before is left
+	auto not_dxbc = dxbc;
+	not_dxbc[0] = 'X';
+	dxbc2glsl.FeedDXBC(not_dxbc.data(), false, true, STP_Undefined, STOP_Undefined, GSV_110);
+	EXPECT_TRUE(dxbc2glsl.GLSLString().empty());
+}
@@ -0,0 +1,459 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Math.hpp>
+#include <KFL/Timer.hpp>
+#include <KlayGE/DistanceField.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	uint32_t const NUM_ITERATIONS = 5;
+
+	// What ComputeDistance did before the exact transform, iterating 8-neighbor sweeps until nothing changes
+	namespace sweep
+	{
+		float EdgeDistance(float2 const & grad, float val)
+		{
+			float df;
+			if ((0 == grad.x()) || (0 == grad.y()))
+			{
+				df = 0.5f - val;
+			}
+			else
+			{
+				float2 n_grad = MathLib::abs(MathLib::normalize(grad));
+				if (n_grad.x() < n_grad.y())
+				{
+					std::swap(n_grad.x(), n_grad.y());
+				}
+
+				float v1 = 0.5f * n_grad.y() / n_grad.x();
+				if (val < v1)
+				{
+					df = 0.5f * (n_grad.x() + n_grad.y()) - MathLib::sqrt(2 * n_grad.x() * n_grad.y() * val);
+				}
+				else if (val < 1 - v1)
+				{
+					df = (0.5f - val) * n_grad.x();
+				}
+				else
+				{
+					df = -0.5f * (n_grad.x() + n_grad.y()) + MathLib::sqrt(2 * n_grad.x() * n_grad.y() * (1 - val));
+				}
+			}
+			return df;
+		}
+
+		float AADist(std::vector<float> const & img, std::vector<float2> const & grad,
+			int width, int offset_addr, int2 const & offset_dist_xy, float2 const & new_dist)
+		{
+			int closest = offset_addr - offset_dist_xy.y() * width - offset_dist_xy.x();
+			float val = MathLib::clamp(img[closest], 0.0f, 1.0f);
+			if (0 == val)
+			{
+				return 1e10f;
+			}
+
+			float di = MathLib::length(new_dist);
+			float df;
+			if (0 == di)
+			{
+				df = EdgeDistance(grad[closest], val);
+			}
+			else
+			{
+				df = EdgeDistance(new_dist, val);
+			}
+			return di + df;
+		}
+
+		bool UpdateDistance(int x, int y, int dx, int dy, std::vector<float> const & img, int width,
+			std::vector<float2> const & grad, std::vector<int2>& dist_xy, std::vector<float>& dist)
+		{
+			float const EPSILON = 1e-3f;
+
+			bool changed = false;
+			int addr = y * width + x;
+			float old_dist = dist[addr];
+			if (old_dist > 0)
+			{
+				int offset_addr = (y + dy) * width + (x + dx);
+				int2 new_dist_xy = dist_xy[offset_addr] - int2(dx, dy);
+				float new_dist = AADist(img, grad, width, offset_addr, dist_xy[offset_addr], new_dist_xy);
+				if (new_dist < old_dist - EPSILON)
+				{
+					dist_xy[addr] = new_dist_xy;
+					dist[addr] = new_dist;
+					changed = true;
+				}
+			}
+
+			return changed;
+		}
+
+		void AAEuclideanDistance(std::vector<float> const & img, std::vector<float2> const & grad,
+			int width, int height, std::vector<float>& dist)
+		{
+			std::vector<int2> dist_xy(img.size(), int2(0, 0));
+
+			for (size_t i = 0; i < img.size(); ++ i)
+			{
+				if (img[i] <= 0)
+				{
+					dist[i] = 1e10f;
+				}
+				else if (img[i] < 1)
+				{
+					dist[i] = EdgeDistance(grad[i], img[i]);
+				}
+				else
+				{
+					dist[i] = 0;
+				}
+			}
+
+			bool changed;
+			do
+			{
+				changed = false;
+
+				for (int y = 1; y < height; ++ y)
+				{
+					for (int x = 0; x < width; ++ x)
+					{
+						if (x > 0)
+						{
+							changed |= UpdateDistance(x, y, -1, +0, img, width, grad, dist_xy, dist);
+							changed |= UpdateDistance(x, y, -1, -1, img, width, grad, dist_xy, dist);
+						}
+						changed |= UpdateDistance(x, y, +0, -1, img, width, grad, dist_xy, dist);
+						if (x < width - 1)
+						{
+							changed |= UpdateDistance(x, y, +1, -1, img, width, grad, dist_xy, dist);
+						}
+					}
+
+					for (int x = width - 2; x >= 0; -- x)
+					{
+						changed |= UpdateDistance(x, y, +1, +0, img, width, grad, dist_xy, dist);
+					}
+				}
+
+				for (int y = height - 2; y >= 0; -- y)
+				{
+					for (int x = width - 1; x >= 0; -- x)
+					{
+						if (x < width - 1)
+						{
+							changed |= UpdateDistance(x, y, +1, +0, img, width, grad, dist_xy, dist);
+							changed |= UpdateDistance(x, y, +1, +1, img, width, grad, dist_xy, dist);
+						}
+						changed |= UpdateDistance(x, y, +0, +1, img, width, grad, dist_xy, dist);
+						if (x > 0)
+						{
+							changed |= UpdateDistance(x, y, -1, +1, img, width, grad, dist_xy, dist);
+						}
+					}
+
+					for (int x = 1; x < width; ++ x)
+					{
+						changed |= UpdateDistance(x, y, -1, +0, img, width, grad, dist_xy, dist);
+					}
+				}
+			} while (changed);
+		}
+
+		void ComputeGradient(std::vector<float> const & img, int w, int h, std::vector<float2>& grad)
+		{
+			grad.assign(w * h, float2(0, 0));
+			for (int y = 1; y < h - 1; ++ y)
+			{
+				for (int x = 1; x < w - 1; ++ x)
+				{
+					int addr = y * w + x;
+					if ((img[addr] > 0) && (img[addr] < 1))
+					{
+						float s0 = -img[addr - w - 1] + img[addr + w + 1];
+						float s1 = -img[addr + w - 1] + img[addr - w + 1];
+						grad[addr] = MathLib::normalize(
+							float2(s0 + s1 - SQRT2 * (img[addr - 1] - img[addr + 1]), s0 - s1 - SQRT2 * (img[addr - w] - img[addr + w])));
+					}
+				}
+			}
+		}
+
+		void ComputeDistance(std::vector<float> const & aa_2x_data, uint32_t input_width, uint32_t input_height,
+			std::vector<float>& dist_data)
+		{
+			std::vector<float> aa_data(aa_2x_data.size() / 4);
+			Downsample2x(aa_2x_data, input_width, input_height, aa_data);
+
+			std::vector<float2> grad_2x_data(aa_2x_data.size());
+			ComputeGradient(aa_2x_data, input_width, input_height, grad_2x_data);
+
+			std::vector<float2> grad_data(aa_data.size());
+			Downsample2x(grad_2x_data, input_width, input_height, grad_data);
+
+			std::vector<float> outside(grad_data.size());
+			AAEuclideanDistance(aa_data, grad_data, input_width / 2, input_height / 2, outside);
+
+			for (size_t i = 0; i < grad_data.size(); ++ i)
+			{
+				aa_data[i] = 1 - aa_data[i];
+				grad_data[i] = -grad_data[i];
+			}
+
+			std::vector<float> inside(grad_data.size());
+			AAEuclideanDistance(aa_data, grad_data, input_width / 2, input_height / 2, inside);
+
+			dist_data.resize(outside.size());
+			for (uint32_t i = 0; i < outside.size(); ++ i)
+			{
+				dist_data[i] = std::max(inside[i], 0.0f) - std::max(outside[i], 0.0f);
+			}
+		}
+	}
+
+	// What DistanceMapCreator did before the exact transform, a 3D variant of Danielsson's algorithm
+	namespace danielsson
+	{
+		class DistanceMap
+		{
+		public:
+			DistanceMap(int width, int height, int depth)
+				: data_(width * height * depth * 3), width_(width), height_(height), depth_(depth)
+			{
+			}
+
+			uint16_t& operator()(int x, int y, int z, int i)
+			{
+				return data_[((z * height_ + y) * width_ + x) * 3 + i];
+			}
+
+			bool inside(int x, int y, int z) const
+			{
+				return (0 <= x) && (x < width_) && (0 <= y) && (y < height_) && (0 <= z) && (z < depth_);
+			}
+
+			void combine(int dx, int dy, int dz, int cx, int cy, int cz, int x, int y, int z)
+			{
+				while (inside(x, y, z) && inside(x + dx, y + dy, z + dz))
+				{
+					int d[3] = {abs(dx), abs(dy), abs(dz)};
+
+					uint32_t v1[3], v2[3];
+					for (int i = 0; i < 3; ++ i)
+					{
+						v1[i] = operator()(x, y, z, i);
+						v2[i] = operator()(x + dx, y + dy, z + dz, i) + d[i];
+					}
+
+					if (v1[0] * v1[0] + v1[1] * v1[1] + v1[2] * v1[2] > v2[0] * v2[0] + v2[1] * v2[1] + v2[2] * v2[2])
+					{
+						for (int i = 0; i < 3; ++ i)
+						{
+							operator()(x, y, z, i) = static_cast<uint16_t>(v2[i]);
+						}
+					}
+
+					x += cx;
+					y += cy;
+					z += cz;
+				}
+			}
+
+		private:
+			std::vector<uint16_t> data_;
+			int width_, height_, depth_;
+		};
+
+		void CombinePlane(DistanceMap& dmap, int width, int height, int z, int dz)
+		{
+			for (int y = 0; y < height; ++ y)
+			{
+				dmap.combine(0, 0, dz, 1, 0, 0, 0, y, z);
+			}
+
+			for (int y = 1; y < height; ++ y)
+			{
+				dmap.combine(0, -1, 0, 1, 0, 0, 0, y, z);
+				dmap.combine(-1, 0, 0, 1, 0, 0, 1, y, z);
+				dmap.combine(+1, 0, 0, -1, 0, 0, width - 2, y, z);
+			}
+
+			for (int y = height - 1; y >= 0; -- y)
+			{
+				dmap.combine(0, +1, 0, 1, 0, 0, 0, y, z);
+				dmap.combine(-1, 0, 0, 1, 0, 0, 1, y, z);
+				dmap.combine(+1, 0, 0, -1, 0, 0, width - 1, y, z);
+			}
+		}
+
+		void ComputeDistanceField(std::vector<uint8_t>& distances, int width, int height, int depth, std::vector<uint8_t> const & volume)
+		{
+			DistanceMap dmap(width, height, depth);
+			for (int z = 0; z < depth; ++ z)
+			{
+				for (int y = 0; y < height; ++ y)
+				{
+					for (int x = 0; x < width; ++ x)
+					{
+						for (int i = 0; i < 3; ++ i)
+						{
+							dmap(x, y, z, i) =
+								(volume[(z * height + y) * width + x] != 0) ? 0 : std::numeric_limits<uint16_t>::max();
+						}
+					}
+				}
+			}
+
+			for (int z = 1; z < depth; ++ z)
+			{
+				CombinePlane(dmap, width, height, z, -1);
+			}
+			for (int z = depth - 1; z >= 0; -- z)
+			{
+				CombinePlane(dmap, width, height, z, +1);
+			}
+
+			for (int z = 0; z < depth; ++ z)
+			{
+				for (int y = 0; y < height; ++ y)
+				{
+					for (int x = 0; x < width; ++ x)
+					{
+						float value = 0;
+						for (int i = 0; i < 3; ++ i)
+						{
+							value += dmap(x, y, z, i) * dmap(x, y, z, i);
+						}
+						distances[(z * height + y) * width + x] =
+							static_cast<uint8_t>(MathLib::clamp(sqrt(value) / depth, 0.0f, 1.0f) * 255);
+					}
+				}
+			}
+		}
+	}
+
+	template <typename Func>
+	double Milliseconds(Func&& func)
+	{
+		Timer timer;
+		for (uint32_t i = 0; i < NUM_ITERATIONS; ++ i)
+		{
+			func();
+		}
+		return timer.elapsed() * 1000 / NUM_ITERATIONS;
+	}
+
+	template <typename T>
+	void Report(std::string_view name, double old_ms, double new_ms, std::vector<T> const & old_result, std::vector<T> const & new_result,
+		double tolerance)
+	{
+		double max_diff = 0;
+		double sum_diff = 0;
+		size_t num_diffs = 0;
+		for (size_t i = 0; i < old_result.size(); ++ i)
+		{
+			double const diff = std::abs(static_cast<double>(old_result[i]) - static_cast<double>(new_result[i]));
+			max_diff = std::max(max_diff, diff);
+			sum_diff += diff;
+			num_diffs += (diff > tolerance) ? 1 : 0;
+		}
+
+		cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2)
+			<< std::setw(10) << old_ms << " ms (old)" << std::setw(10) << new_ms << " ms" << std::setw(8) << old_ms / new_ms << "x"
+			<< "    max diff " << std::setprecision(3) << max_diff << ", mean diff " << sum_diff / old_result.size()
+			<< ", " << num_diffs << " of " << old_result.size() << " differ" << endl;
+	}
+
+	// Rings and dots, antialiased at 2x the output size like the glyphs of KFontGen
+	std::vector<float> Glyphs(uint32_t width, uint32_t height)
+	{
+		uint32_t const SAMPLES = 4;
+
+		std::vector<float> aa_2x(width * height);
+		for (uint32_t y = 0; y < height; ++ y)
+		{
+			for (uint32_t x = 0; x < width; ++ x)
+			{
+				float coverage = 0;
+				for (uint32_t sy = 0; sy < SAMPLES; ++ sy)
+				{
+					for (uint32_t sx = 0; sx < SAMPLES; ++ sx)
+					{
+						float2 const pos(x + (sx + 0.5f) / SAMPLES, y + (sy + 0.5f) / SAMPLES);
+						float2 const cell(std::fmod(pos.x(), 128.0f) - 64, std::fmod(pos.y(), 128.0f) - 64);
+						float const r = MathLib::length(cell);
+						coverage += (((r > 30) && (r < 50)) || (r < 8)) ? 1.0f : 0.0f;
+					}
+				}
+				aa_2x[y * width + x] = coverage / (SAMPLES * SAMPLES);
+			}
+		}
+		return aa_2x;
+	}
+
+	// Layers of a height map, the way DistanceMapCreator turns one into a volume
+	std::vector<uint8_t> HeightVolume(uint32_t width, uint32_t height, uint32_t depth)
+	{
+		std::vector<uint8_t> volume(width * height * depth);
+		for (uint32_t z = 0; z < depth; ++ z)
+		{
+			for (uint32_t y = 0; y < height; ++ y)
+			{
+				for (uint32_t x = 0; x < width; ++ x)
+				{
+					float const h = 0.5f + 0.25f * std::sin(x * 0.1f) * std::cos(y * 0.07f) + 0.25f * std::sin((x + y) * 0.031f);
+					volume[(z * height + y) * width + x] = (static_cast<uint32_t>(h * 255) >= z * (256 / depth)) ? 255 : 0;
+				}
+			}
+		}
+		return volume;
+	}
+}
+
+int main()
+{
+	{
+		uint32_t const WIDTH = 512;
+		uint32_t const HEIGHT = 512;
+
+		auto const aa_2x = Glyphs(WIDTH, HEIGHT);
+		std::vector<float> old_dist;
+		std::vector<float> new_dist;
+		double const old_ms = Milliseconds([&] { sweep::ComputeDistance(aa_2x, WIDTH, HEIGHT, old_dist); });
+		double const new_ms = Milliseconds([&] { ComputeDistance(aa_2x, WIDTH, HEIGHT, new_dist); });
+		Report("ComputeDistance 256x256", old_ms, new_ms, old_dist, new_dist, 0.01);
+	}
+
+	for (uint32_t const depth : {16U, 64U})
+	{
+		uint32_t const WIDTH = 256;
+		uint32_t const HEIGHT = 256;
+
+		auto const volume = HeightVolume(WIDTH, HEIGHT, depth);
+		std::vector<uint8_t> old_dist(volume.size());
+		std::vector<uint8_t> new_dist(volume.size());
+		std::vector<float> dist;
+		double const old_ms = Milliseconds([&] { danielsson::ComputeDistanceField(old_dist, WIDTH, HEIGHT, depth, volume); });
+		double const new_ms = Milliseconds([&]
+			{
+				ComputeBinaryDistance(volume, WIDTH, HEIGHT, depth, dist);
+				QuantizeDistance(dist, static_cast<float>(depth), new_dist);
+			});
+		Report("Distance map 256x256x" + std::to_string(depth), old_ms, new_ms, old_dist, new_dist, 0);
+	}
+
+	return 0;
+}
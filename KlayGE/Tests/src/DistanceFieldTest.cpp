@@ -0,0 +1,174 @@
+/**
+ * @file DistanceFieldTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Math.hpp>
+#include <KlayGE/DistanceField.hpp>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "KlayGETests.hpp"
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	std::vector<uint8_t> RandomVolume(uint32_t num_voxels, float density, uint32_t seed)
+	{
+		std::ranlux24_base gen(seed);
+		std::uniform_real_distribution<float> dis(0, 1);
+
+		std::vector<uint8_t> volume(num_voxels);
+		for (auto& voxel : volume)
+		{
+			voxel = (dis(gen) < density) ? 255 : 0;
+		}
+		return volume;
+	}
+
+	int32_t SquaredDistance(uint32_t a, uint32_t b, uint32_t width, uint32_t height)
+	{
+		int32_t const dx = static_cast<int32_t>(a % width) - static_cast<int32_t>(b % width);
+		int32_t const dy = static_cast<int32_t>(a / width % height) - static_cast<int32_t>(b / width % height);
+		int32_t const dz = static_cast<int32_t>(a / (width * height)) - static_cast<int32_t>(b / (width * height));
+		return dx * dx + dy * dy + dz * dz;
+	}
+}
+
+TEST(DistanceFieldTest, MatchesBruteForce)
+{
+	uint32_t const sizes[][3] = {{1, 1, 1}, {17, 1, 1}, {1, 23, 1}, {31, 29, 1}, {40, 3, 1}, {13, 11, 9}, {5, 1, 20}};
+
+	for (auto const & size : sizes)
+	{
+		for (float const density : {0.0f, 0.01f, 0.2f, 0.9f})
+		{
+			uint32_t const num_voxels = size[0] * size[1] * size[2];
+			auto const volume = RandomVolume(num_voxels, density, num_voxels);
+
+			std::vector<float> sq_dist(num_voxels);
+			for (uint32_t i = 0; i < num_voxels; ++ i)
+			{
+				sq_dist[i] = volume[i] ? 0 : std::numeric_limits<float>::infinity();
+			}
+			std::vector<int32_t> nearest(num_voxels);
+			SquaredDistanceTransform(sq_dist, nearest, size[0], size[1], size[2]);
+
+			std::vector<float> dist;
+			ComputeBinaryDistance(volume, size[0], size[1], size[2], dist);
+
+			for (uint32_t i = 0; i < num_voxels; ++ i)
+			{
+				int32_t expected = std::numeric_limits<int32_t>::max();
+				for (uint32_t j = 0; j < num_voxels; ++ j)
+				{
+					if (volume[j])
+					{
+						expected = std::min(expected, SquaredDistance(i, j, size[0], size[1]));
+					}
+				}
+
+				if (expected == std::numeric_limits<int32_t>::max())
+				{
+					EXPECT_EQ(sq_dist[i], std::numeric_limits<float>::infinity());
+					EXPECT_EQ(nearest[i], -1);
+					EXPECT_EQ(dist[i], std::numeric_limits<float>::infinity());
+				}
+				else
+				{
+					EXPECT_EQ(sq_dist[i], static_cast<float>(expected));
+					ASSERT_GE(nearest[i], 0);
+					EXPECT_NE(volume[nearest[i]], 0);
+					EXPECT_EQ(SquaredDistance(i, static_cast<uint32_t>(nearest[i]), size[0], size[1]), expected);
+					EXPECT_FLOAT_EQ(dist[i], std::sqrt(static_cast<float>(expected)));
+				}
+			}
+		}
+	}
+}
+
+TEST(DistanceFieldTest, Quantize)
+{
+	std::vector<float> const dist = {-1, 0, 0.5f, 1, 2, 3.99f, 4, 100, 1.25f, 3, 0.01f};
+
+	std::vector<uint8_t> quantized8(dist.size());
+	QuantizeDistance(dist, 4, quantized8);
+	std::vector<uint16_t> quantized16(dist.size());
+	QuantizeDistance(dist, 4, quantized16);
+	for (size_t i = 0; i < dist.size(); ++ i)
+	{
+		float const v = MathLib::clamp(dist[i] / 4, 0.0f, 1.0f);
+		EXPECT_EQ(quantized8[i], static_cast<uint8_t>(v * 255));
+		EXPECT_EQ(quantized16[i], static_cast<uint16_t>(v * 65535));
+	}
+}
+
+TEST(DistanceFieldTest, AntialiasedDisc)
+{
+	// The signed distance of an antialiased disc has to be close to the analytic one
+	uint32_t const SIZE = 64;
+	float const RADIUS = 40.5f;
+	uint32_t const SAMPLES = 4;
+
+	std::vector<float> aa_2x(SIZE * 2 * SIZE * 2);
+	for (uint32_t y = 0; y < SIZE * 2; ++ y)
+	{
+		for (uint32_t x = 0; x < SIZE * 2; ++ x)
+		{
+			float coverage = 0;
+			for (uint32_t sy = 0; sy < SAMPLES; ++ sy)
+			{
+				for (uint32_t sx = 0; sx < SAMPLES; ++ sx)
+				{
+					float2 const pos(x + (sx + 0.5f) / SAMPLES - SIZE, y + (sy + 0.5f) / SAMPLES - SIZE);
+					coverage += (MathLib::length(pos) < RADIUS) ? 1.0f : 0.0f;
+				}
+			}
+			aa_2x[y * SIZE * 2 + x] = coverage / (SAMPLES * SAMPLES);
+		}
+	}
+
+	std::vector<float> dist;
+	ComputeDistance(aa_2x, SIZE * 2, SIZE * 2, dist);
+	ASSERT_EQ(dist.size(), SIZE * SIZE);
+
+	for (uint32_t y = 0; y < SIZE; ++ y)
+	{
+		for (uint32_t x = 0; x < SIZE; ++ x)
+		{
+			float2 const pos(x + 0.5f - SIZE / 2.0f, y + 0.5f - SIZE / 2.0f);
+			EXPECT_NEAR(dist[y * SIZE + x], RADIUS / 2 - MathLib::length(pos), 0.25f);
+		}
+	}
+}
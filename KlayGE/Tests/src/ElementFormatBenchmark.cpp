@@ -0,0 +1,181 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/ErrorHandling.hpp>
+#include <KFL/Half.hpp>
+#include <KFL/Math.hpp>
+#include <KFL/Timer.hpp>
+#include <KlayGE/ElementFormat.hpp>
+
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	uint32_t const NUM_PIXELS = 1024 * 1024;
+	uint32_t const NUM_ITERATIONS = 20;
+
+	uint8_t ScalarUNorm8(float v)
+	{
+		return static_cast<uint8_t>(MathLib::clamp(static_cast<int>(v * 255.0f + 0.5f), 0, 255));
+	}
+
+	// What ConvertToABGR32F and ConvertFromABGR32F did for every element before the fast paths
+	void ScalarToABGR32F(ElementFormat fmt, uint8_t const * p, uint32_t num_elems, Color* output)
+	{
+		for (uint32_t i = 0; i < num_elems; ++ i, ++ output)
+		{
+			switch (fmt)
+			{
+			case EF_ABGR8:
+				*output = Color(p[i * 4 + 0] / 255.0f, p[i * 4 + 1] / 255.0f, p[i * 4 + 2] / 255.0f, p[i * 4 + 3] / 255.0f);
+				break;
+
+			case EF_ABGR8_SRGB:
+				*output = Color(MathLib::srgb_to_linear(p[i * 4 + 0] / 255.0f), MathLib::srgb_to_linear(p[i * 4 + 1] / 255.0f),
+					MathLib::srgb_to_linear(p[i * 4 + 2] / 255.0f), MathLib::srgb_to_linear(p[i * 4 + 3] / 255.0f));
+				break;
+
+			case EF_A2BGR10:
+				{
+					uint32_t const s = *reinterpret_cast<uint32_t const *>(p + i * 4);
+					*output = Color((s & 0x03FF) / 1023.0f, ((s >> 10) & 0x03FF) / 1023.0f,
+						((s >> 20) & 0x03FF) / 1023.0f, ((s >> 30) & 0x03) / 3.0f);
+				}
+				break;
+
+			case EF_ABGR16F:
+				{
+					half const * s = reinterpret_cast<half const *>(p + i * 8);
+					*output = Color(s[0], s[1], s[2], s[3]);
+				}
+				break;
+
+			default:
+				KFL_UNREACHABLE("Not benchmarked");
+			}
+		}
+	}
+
+	void ScalarFromABGR32F(ElementFormat fmt, Color const * input, uint32_t num_elems, uint8_t* p)
+	{
+		for (uint32_t i = 0; i < num_elems; ++ i, ++ input)
+		{
+			switch (fmt)
+			{
+			case EF_ABGR8:
+				p[i * 4 + 0] = ScalarUNorm8(input->r());
+				p[i * 4 + 1] = ScalarUNorm8(input->g());
+				p[i * 4 + 2] = ScalarUNorm8(input->b());
+				p[i * 4 + 3] = ScalarUNorm8(input->a());
+				break;
+
+			case EF_ABGR8_SRGB:
+				p[i * 4 + 0] = ScalarUNorm8(MathLib::linear_to_srgb(input->r()));
+				p[i * 4 + 1] = ScalarUNorm8(MathLib::linear_to_srgb(input->g()));
+				p[i * 4 + 2] = ScalarUNorm8(MathLib::linear_to_srgb(input->b()));
+				p[i * 4 + 3] = ScalarUNorm8(MathLib::linear_to_srgb(input->a()));
+				break;
+
+			case EF_A2BGR10:
+				{
+					int r = MathLib::clamp(static_cast<int>(input->r() * 1023.0f + 0.5f), 0, 1023);
+					int g = MathLib::clamp(static_cast<int>(input->g() * 1023.0f + 0.5f), 0, 1023);
+					int b = MathLib::clamp(static_cast<int>(input->b() * 1023.0f + 0.5f), 0, 1023);
+					int a = MathLib::clamp(static_cast<int>(input->a() * 3.0f + 0.5f), 0, 3);
+					*reinterpret_cast<uint32_t*>(p + i * 4) = r | (g << 10) | (b << 20) | (a << 30);
+				}
+				break;
+
+			case EF_ABGR16F:
+				{
+					half* s = reinterpret_cast<half*>(p + i * 8);
+					s[0] = half(input->r());
+					s[1] = half(input->g());
+					s[2] = half(input->b());
+					s[3] = half(input->a());
+				}
+				break;
+
+			default:
+				KFL_UNREACHABLE("Not benchmarked");
+			}
+		}
+	}
+
+	template <typename Func>
+	double PixelsPerSecond(Func&& func)
+	{
+		Timer timer;
+		for (uint32_t i = 0; i < NUM_ITERATIONS; ++ i)
+		{
+			func();
+		}
+		return static_cast<double>(NUM_PIXELS) * NUM_ITERATIONS / timer.elapsed();
+	}
+
+	void Report(std::string_view name, double scalar_rate, double fast_rate)
+	{
+		cout << std::left << std::setw(32) << name << std::right << std::fixed << std::setprecision(1)
+			<< std::setw(10) << scalar_rate / 1e6 << " Mpixels/s (scalar)"
+			<< std::setw(10) << fast_rate / 1e6 << " Mpixels/s" << std::setw(8) << fast_rate / scalar_rate << "x" << endl;
+	}
+
+	void Benchmark(std::string_view name, ElementFormat fmt, std::vector<Color> const & colors)
+	{
+		std::vector<uint8_t> packed(NUM_PIXELS * NumFormatBytes(fmt));
+		std::vector<Color> unpacked(NUM_PIXELS);
+
+		double const scalar_from = PixelsPerSecond([&] { ScalarFromABGR32F(fmt, colors.data(), NUM_PIXELS, packed.data()); });
+		double const fast_from = PixelsPerSecond([&] { ConvertFromABGR32F(fmt, colors.data(), NUM_PIXELS, packed.data()); });
+		Report(std::string(name) + " from ABGR32F", scalar_from, fast_from);
+
+		double const scalar_to = PixelsPerSecond([&] { ScalarToABGR32F(fmt, packed.data(), NUM_PIXELS, unpacked.data()); });
+		double const fast_to = PixelsPerSecond([&] { ConvertToABGR32F(fmt, packed.data(), NUM_PIXELS, unpacked.data()); });
+		Report(std::string(name) + " to ABGR32F", scalar_to, fast_to);
+	}
+
+	void BenchmarkDirect(std::string_view name, ElementFormat src_fmt, ElementFormat dst_fmt, std::vector<Color> const & colors)
+	{
+		std::vector<uint8_t> src(NUM_PIXELS * NumFormatBytes(src_fmt));
+		std::vector<uint8_t> dst(NUM_PIXELS * NumFormatBytes(dst_fmt));
+		ConvertFromABGR32F(src_fmt, colors.data(), NUM_PIXELS, src.data());
+
+		// The old way: a whole image of colors in between
+		std::vector<Color> buffer(NUM_PIXELS);
+		double const two_step = PixelsPerSecond([&]
+			{
+				ConvertToABGR32F(src_fmt, src.data(), NUM_PIXELS, buffer.data());
+				ConvertFromABGR32F(dst_fmt, buffer.data(), NUM_PIXELS, dst.data());
+			});
+		double const direct = PixelsPerSecond([&] { ConvertFormat(src_fmt, src.data(), dst_fmt, dst.data(), NUM_PIXELS); });
+		Report(name, two_step, direct);
+	}
+}
+
+int main()
+{
+	std::ranlux24_base gen;
+	std::uniform_real_distribution<float> dis(0, 1);
+	std::vector<Color> colors(NUM_PIXELS);
+	for (auto& color : colors)
+	{
+		color = Color(dis(gen), dis(gen), dis(gen), dis(gen));
+	}
+
+	Benchmark("ABGR8", EF_ABGR8, colors);
+	Benchmark("ABGR8_SRGB", EF_ABGR8_SRGB, colors);
+	Benchmark("A2BGR10", EF_A2BGR10, colors);
+	Benchmark("ABGR16F", EF_ABGR16F, colors);
+
+	BenchmarkDirect("ARGB8 -> ABGR8", EF_ARGB8, EF_ABGR8, colors);
+	BenchmarkDirect("ABGR8_SRGB -> ARGB8", EF_ABGR8_SRGB, EF_ARGB8, colors);
+	BenchmarkDirect("ABGR16F -> ABGR8", EF_ABGR16F, EF_ABGR8, colors);
+
+	return 0;
+}
@@ -0,0 +1,360 @@
+/**
+ * @file ElementFormatTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/CXX20/bit.hpp>
+#include <KFL/Half.hpp>
+#include <KFL/Math.hpp>
+#include <KlayGE/ElementFormat.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "KlayGETests.hpp"
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	// Covers the in-range values densely, plus random bit patterns for the out-of-range, denormal and special ones
+	std::vector<Color> TestColors()
+	{
+		std::ranlux24_base gen;
+		std::uniform_real_distribution<float> dis(-0.5f, 1.5f);
+		std::uniform_int_distribution<uint32_t> bits_dis;
+
+		std::vector<float> values;
+		for (int i = -300; i <= 300; ++ i)
+		{
+			values.push_back(i / 255.0f);
+		}
+		for (int i = 0; i < 4000; ++ i)
+		{
+			values.push_back(dis(gen));
+		}
+		for (int i = 0; i < 4000; ++ i)
+		{
+			float const f = std::bit_cast<float>(bits_dis(gen));
+			if (!(std::abs(f) > 1e5f))
+			{
+				values.push_back(f);
+			}
+		}
+
+		// Odd sizes leave a tail for the scalar code
+		std::vector<Color> colors(values.size() | 1);
+		for (size_t i = 0; i < colors.size(); ++ i)
+		{
+			for (size_t ch = 0; ch < 4; ++ ch)
+			{
+				colors[i][ch] = values[(i * 4 + ch) * 7919 % values.size()];
+			}
+		}
+		return colors;
+	}
+
+	uint8_t FloatToUNorm8(float v)
+	{
+		return static_cast<uint8_t>(MathLib::clamp(static_cast<int>(v * 255.0f + 0.5f), 0, 255));
+	}
+
+	bool BitEqual(float lhs, float rhs)
+	{
+		return (std::bit_cast<uint32_t>(lhs) == std::bit_cast<uint32_t>(rhs)) || ((lhs != lhs) && (rhs != rhs));
+	}
+
+	uint16_t HalfBits(float v)
+	{
+		half const h(v);
+		uint16_t bits;
+		std::memcpy(&bits, &h, sizeof(bits));
+		return bits;
+	}
+}
+
+TEST(ElementFormatTest, UNorm8)
+{
+	auto const colors = TestColors();
+	uint32_t const num = static_cast<uint32_t>(colors.size());
+
+	for (auto const fmt : {EF_ABGR8, EF_ARGB8})
+	{
+		uint32_t const r = (fmt == EF_ARGB8) ? 2 : 0;
+
+		std::vector<uint8_t> packed(num * 4);
+		ConvertFromABGR32F(fmt, colors.data(), num, packed.data());
+		for (uint32_t i = 0; i < num; ++ i)
+		{
+			EXPECT_EQ(packed[i * 4 + r], FloatToUNorm8(colors[i].r()));
+			EXPECT_EQ(packed[i * 4 + 1], FloatToUNorm8(colors[i].g()));
+			EXPECT_EQ(packed[i * 4 + 2 - r], FloatToUNorm8(colors[i].b()));
+			EXPECT_EQ(packed[i * 4 + 3], FloatToUNorm8(colors[i].a()));
+		}
+
+		std::vector<Color> unpacked(num);
+		ConvertToABGR32F(fmt, packed.data(), num, unpacked.data());
+		for (uint32_t i = 0; i < num; ++ i)
+		{
+			EXPECT_EQ(unpacked[i], Color(packed[i * 4 + r] / 255.0f, packed[i * 4 + 1] / 255.0f, packed[i * 4 + 2 - r] / 255.0f,
+				packed[i * 4 + 3] / 255.0f));
+		}
+	}
+
+	std::vector<uint8_t> packed(num * 2);
+	ConvertFromABGR32F(EF_R8, colors.data(), num, packed.data());
+	for (uint32_t i = 0; i < num; ++ i)
+	{
+		EXPECT_EQ(packed[i], FloatToUNorm8(colors[i].r()));
+	}
+	ConvertFromABGR32F(EF_GR8, colors.data(), num, packed.data());
+	for (uint32_t i = 0; i < num; ++ i)
+	{
+		EXPECT_EQ(packed[i * 2 + 0], FloatToUNorm8(colors[i].r()));
+		EXPECT_EQ(packed[i * 2 + 1], FloatToUNorm8(colors[i].g()));
+	}
+
+	std::vector<Color> unpacked(num);
+	ConvertToABGR32F(EF_GR8, packed.data(), num, unpacked.data());
+	for (uint32_t i = 0; i < num; ++ i)
+	{
+		EXPECT_EQ(unpacked[i], Color(packed[i * 2 + 0] / 255.0f, packed[i * 2 + 1] / 255.0f, 0, 1));
+	}
+}
+
+TEST(ElementFormatTest, SRGB8)
+{
+	auto const colors = TestColors();
+	uint32_t const num = static_cast<uint32_t>(colors.size());
+
+	for (auto const fmt : {EF_ABGR8_SRGB, EF_ARGB8_SRGB})
+	{
+		uint32_t const r = (fmt == EF_ARGB8_SRGB) ? 2 : 0;
+
+		std::vector<uint8_t> packed(num * 4);
+		ConvertFromABGR32F(fmt, colors.data(), num, packed.data());
+		for (uint32_t i = 0; i < num; ++ i)
+		{
+			EXPECT_EQ(packed[i * 4 + r], FloatToUNorm8(MathLib::linear_to_srgb(colors[i].r())));
+			EXPECT_EQ(packed[i * 4 + 1], FloatToUNorm8(MathLib::linear_to_srgb(colors[i].g())));
+			EXPECT_EQ(packed[i * 4 + 2 - r], FloatToUNorm8(MathLib::linear_to_srgb(colors[i].b())));
+			EXPECT_EQ(packed[i * 4 + 3], FloatToUNorm8(MathLib::linear_to_srgb(colors[i].a())));
+		}
+
+		std::vector<Color> unpacked(num);
+		ConvertToABGR32F(fmt, packed.data(), num, unpacked.data());
+		for (uint32_t i = 0; i < num; ++ i)
+		{
+			EXPECT_EQ(unpacked[i], Color(MathLib::srgb_to_linear(packed[i * 4 + r] / 255.0f),
+				MathLib::srgb_to_linear(packed[i * 4 + 1] / 255.0f), MathLib::srgb_to_linear(packed[i * 4 + 2 - r] / 255.0f),
+				MathLib::srgb_to_linear(packed[i * 4 + 3] / 255.0f)));
+		}
+	}
+}
+
+TEST(ElementFormatTest, A2BGR10)
+{
+	auto colors = TestColors();
+
+	// Out of the int range once scaled, where the SIMD and scalar paths used to disagree
+	float const big_values[] = {3e9f, -3e9f, 1e30f, -1e30f, std::numeric_limits<float>::infinity(),
+		-std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN()};
+	for (float const v : big_values)
+	{
+		for (size_t ch = 0; ch < 4; ++ ch)
+		{
+			Color clr(0.25f, 0.5f, 0.75f, 1);
+			clr[ch] = v;
+			colors.push_back(clr);
+		}
+	}
+
+	uint32_t const num = static_cast<uint32_t>(colors.size());
+
+	auto to_unorm = [](float v, float max_value)
+	{
+		float const scaled = v * max_value + 0.5f;
+		return (scaled > 0) ? static_cast<uint32_t>(std::min(scaled, max_value)) : 0U;
+	};
+
+	std::vector<uint32_t> packed(num);
+	ConvertFromABGR32F(EF_A2BGR10, colors.data(), num, packed.data());
+	for (uint32_t i = 0; i < num; ++ i)
+	{
+		uint32_t const r = to_unorm(colors[i].r(), 1023.0f);
+		uint32_t const g = to_unorm(colors[i].g(), 1023.0f);
+		uint32_t const b = to_unorm(colors[i].b(), 1023.0f);
+		uint32_t const a = to_unorm(colors[i].a(), 3.0f);
+		EXPECT_EQ(packed[i], r | (g << 10) | (b << 20) | (a << 30));
+
+		// One at a time goes through the scalar code
+		uint32_t single;
+		ConvertFromABGR32F(EF_A2BGR10, &colors[i], 1, &single);
+		EXPECT_EQ(single, packed[i]);
+	}
+
+	std::vector<Color> unpacked(num);
+	ConvertToABGR32F(EF_A2BGR10, packed.data(), num, unpacked.data());
+	for (uint32_t i = 0; i < num; ++ i)
+	{
+		uint32_t const s = packed[i];
+		EXPECT_EQ(unpacked[i], Color((s & 0x03FF) / 1023.0f, ((s >> 10) & 0x03FF) / 1023.0f, ((s >> 20) & 0x03FF) / 1023.0f,
+			(s >> 30) / 3.0f));
+	}
+}
+
+TEST(ElementFormatTest, Half)
+{
+	// Every half, including zeros, denormals, infinities and NaNs
+	std::vector<uint16_t> halves(65536);
+	for (uint32_t i = 0; i < halves.size(); ++ i)
+	{
+		halves[i] = static_cast<uint16_t>(i);
+	}
+	std::vector<Color> unpacked(halves.size() / 4);
+	ConvertToABGR32F(EF_ABGR16F, halves.data(), static_cast<uint32_t>(unpacked.size()), unpacked.data());
+	for (uint32_t i = 0; i < halves.size(); ++ i)
+	{
+		half h;
+		std::memcpy(&h, &halves[i], sizeof(h));
+		EXPECT_TRUE(BitEqual(unpacked[i / 4][i % 4], h));
+	}
+
+	EXPECT_TRUE(BitEqual(half(0.0f), 0.0f));
+	EXPECT_TRUE(BitEqual(half(-0.0f), -0.0f));
+	EXPECT_EQ(static_cast<float>(half::pos_inf()), std::numeric_limits<float>::infinity());
+	EXPECT_EQ(static_cast<float>(half(1e5f)), std::numeric_limits<float>::infinity());
+	EXPECT_EQ(static_cast<float>(half(-1e5f)), -std::numeric_limits<float>::infinity());
+
+	auto const colors = TestColors();
+	uint32_t const num = static_cast<uint32_t>(colors.size());
+	std::vector<uint16_t> packed(num * 4);
+	ConvertFromABGR32F(EF_ABGR16F, colors.data(), num, packed.data());
+	for (uint32_t i = 0; i < num * 4; ++ i)
+	{
+		EXPECT_EQ(packed[i], HalfBits(colors[i / 4][i % 4]));
+	}
+	ConvertFromABGR32F(EF_GR16F, colors.data(), num, packed.data());
+	for (uint32_t i = 0; i < num * 2; ++ i)
+	{
+		EXPECT_EQ(packed[i], HalfBits(colors[i / 2][i % 2]));
+	}
+	ConvertFromABGR32F(EF_R16F, colors.data(), num, packed.data());
+	for (uint32_t i = 0; i < num; ++ i)
+	{
+		EXPECT_EQ(packed[i], HalfBits(colors[i].r()));
+	}
+
+	unpacked.resize(num);
+	ConvertToABGR32F(EF_R16F, packed.data(), num, unpacked.data());
+	for (uint32_t i = 0; i < num; ++ i)
+	{
+		half h;
+		std::memcpy(&h, &packed[i], sizeof(h));
+		EXPECT_TRUE(BitEqual(unpacked[i].r(), h));
+		EXPECT_EQ(unpacked[i].a(), 1);
+	}
+}
+
+TEST(ElementFormatTest, B10G11R11F)
+{
+	std::ranlux24_base gen;
+	std::uniform_int_distribution<uint32_t> dis;
+
+	std::vector<uint32_t> packed(4097);
+	for (auto& s : packed)
+	{
+		s = dis(gen);
+	}
+	packed[0] = (0x1FU << 6) | (0x1FU << 17) | (0x1FU << 27);
+	packed[1] = 0;
+
+	std::vector<Color> unpacked(packed.size());
+	ConvertToABGR32F(EF_B10G11R11F, packed.data(), static_cast<uint32_t>(packed.size()), unpacked.data());
+
+	// Exponent bias of 15 like a half, with 6, 6 and 5 mantissa bits
+	auto decode = [](uint32_t v, uint32_t mantissa_bits)
+	{
+		uint32_t const e = v >> mantissa_bits;
+		uint32_t const m = v & ((1U << mantissa_bits) - 1);
+		if (0 == e)
+		{
+			return std::ldexp(static_cast<float>(m), -14 - static_cast<int>(mantissa_bits));
+		}
+		else if (0x1F == e)
+		{
+			return (0 == m) ? std::numeric_limits<float>::infinity() : std::numeric_limits<float>::quiet_NaN();
+		}
+		else
+		{
+			return std::ldexp(1 + static_cast<float>(m) / (1U << mantissa_bits), static_cast<int>(e) - 15);
+		}
+	};
+	for (size_t i = 0; i < packed.size(); ++ i)
+	{
+		uint32_t const s = packed[i];
+		EXPECT_TRUE(BitEqual(unpacked[i].r(), decode(s & 0x07FF, 6)));
+		EXPECT_TRUE(BitEqual(unpacked[i].g(), decode((s >> 11) & 0x07FF, 6)));
+		EXPECT_TRUE(BitEqual(unpacked[i].b(), decode(s >> 22, 5)));
+		EXPECT_EQ(unpacked[i].a(), 1);
+	}
+}
+
+TEST(ElementFormatTest, ConvertFormat)
+{
+	std::ranlux24_base gen;
+	std::uniform_int_distribution<uint32_t> dis(0, 255);
+
+	uint32_t const num = 1027;
+	std::vector<uint8_t> src(num * 8);
+	for (auto& v : src)
+	{
+		v = static_cast<uint8_t>(dis(gen));
+	}
+
+	for (auto const src_fmt : {EF_ABGR8, EF_ARGB8, EF_ABGR8_SRGB, EF_ARGB8_SRGB, EF_R8, EF_ABGR16F})
+	{
+		for (auto const dst_fmt : {EF_ABGR8, EF_ARGB8, EF_ABGR8_SRGB, EF_ARGB8_SRGB, EF_GR8, EF_A2BGR10, EF_ABGR32F})
+		{
+			std::vector<uint8_t> direct(num * NumFormatBytes(dst_fmt));
+			ConvertFormat(src_fmt, src.data(), dst_fmt, direct.data(), num);
+
+			std::vector<Color> colors(num);
+			std::vector<uint8_t> expected(direct.size());
+			ConvertToABGR32F(src_fmt, src.data(), num, colors.data());
+			ConvertFromABGR32F(dst_fmt, colors.data(), num, expected.data());
+
+			EXPECT_EQ(direct, expected);
+		}
+	}
+}
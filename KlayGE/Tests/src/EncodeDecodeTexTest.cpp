@@ -293,3 +293,128 @@ TEST(EncodeDecodeTexTest, EncodeDecodeETC1)
 {
 	TestEncodeDecodeTex("Lenna.dds", "", EF_ETC1, 4.8f);
 }
+
+TEST(EncodeDecodeTexTest, EncodeMemMultiThreaded)
+{
+	Context::Instance().ResLoaderInstance().AddPath("../../Tests/media/EncodeDecodeTex");
+
+	TexturePtr in_tex = LoadSoftwareTexture("Lenna.dds");
+	uint32_t const width = in_tex->Width(0);
+	uint32_t const height = in_tex->Height(0);
+	auto const & init_data = checked_cast<SoftwareTexture&>(*in_tex).SubresourceData();
+
+	TexCompressionETC1 codec;
+	uint32_t const block_width = BlockWidth(EF_ETC1);
+	uint32_t const block_height = BlockHeight(EF_ETC1);
+	uint32_t const row_pitch = (width + block_width - 1) / block_width * BlockBytes(EF_ETC1);
+	uint32_t const slice_pitch = (height + block_height - 1) / block_height * row_pitch;
+
+	std::vector<uint8_t> single_threaded(slice_pitch);
+	codec.NumThreads(1);
+	codec.EncodeMem(width, height, single_threaded.data(), row_pitch, slice_pitch,
+		init_data[0].data, init_data[0].row_pitch, init_data[0].slice_pitch, TCM_Balanced);
+
+	std::vector<uint8_t> multi_threaded(slice_pitch);
+	codec.NumThreads(4);
+	codec.EncodeMem(width, height, multi_threaded.data(), row_pitch, slice_pitch,
+		init_data[0].data, init_data[0].row_pitch, init_data[0].slice_pitch, TCM_Balanced);
+
+	EXPECT_TRUE(single_threaded == multi_threaded);
+
+	uint32_t const decoded_row_pitch = width * NumFormatBytes(DecodedFormat(EF_ETC1));
+	std::vector<uint8_t> single_threaded_decoded(decoded_row_pitch * height);
+	codec.NumThreads(1);
+	codec.DecodeMem(width, height, single_threaded_decoded.data(), decoded_row_pitch, decoded_row_pitch * height,
+		multi_threaded.data(), row_pitch, slice_pitch);
+
+	std::vector<uint8_t> multi_threaded_decoded(decoded_row_pitch * height);
+	codec.NumThreads(4);
+	codec.DecodeMem(width, height, multi_threaded_decoded.data(), decoded_row_pitch, decoded_row_pitch * height,
+		multi_threaded.data(), row_pitch, slice_pitch);
+
+	EXPECT_TRUE(single_threaded_decoded == multi_threaded_decoded);
+}
+
+void TestEncodeBlocks(std::string_view input_name, ElementFormat bc_fmt)
+{
+	Context::Instance().ResLoaderInstance().AddPath("../../Tests/media/EncodeDecodeTex");
+
+	std::unique_ptr<TexCompression> codec;
+	switch (bc_fmt)
+	{
+	case EF_BC1:
+		codec = MakeUniquePtr<TexCompressionBC1>();
+		break;
+
+	case EF_BC2:
+		codec = MakeUniquePtr<TexCompressionBC2>();
+		break;
+
+	case EF_BC3:
+		codec = MakeUniquePtr<TexCompressionBC3>();
+		break;
+
+	default:
+		KFL_UNREACHABLE("Unsupported compression format");
+	}
+
+	TexturePtr in_tex = LoadSoftwareTexture(input_name);
+	uint32_t const width = in_tex->Width(0);
+	uint32_t const height = in_tex->Height(0);
+	auto const & init_data = checked_cast<SoftwareTexture&>(*in_tex).SubresourceData();
+
+	uint32_t const pixel_size = NumFormatBytes(DecodedFormat(bc_fmt));
+	BOOST_ASSERT(pixel_size == NumFormatBytes(in_tex->Format()));
+
+	uint32_t const block_width = BlockWidth(bc_fmt);
+	uint32_t const block_height = BlockHeight(bc_fmt);
+	uint32_t const block_bytes = BlockBytes(bc_fmt);
+	uint32_t const num_block_cols = (width + block_width - 1) / block_width;
+	uint32_t const num_block_rows = (height + block_height - 1) / block_height;
+	uint32_t const num_blocks = num_block_cols * num_block_rows;
+	uint32_t const uncompressed_block_bytes = block_width * block_height * pixel_size;
+
+	// Blocks are laid out back to back, the layout EncodeBlocks expects
+	std::vector<uint8_t> uncompressed(num_blocks * uncompressed_block_bytes, 0);
+	uint8_t const * src = static_cast<uint8_t const *>(init_data[0].data);
+	for (uint32_t y = 0; y < height; ++ y)
+	{
+		for (uint32_t x = 0; x < width; ++ x)
+		{
+			uint32_t const block = (y / block_height) * num_block_cols + (x / block_width);
+			uint32_t const offset = ((y % block_height) * block_width + (x % block_width)) * pixel_size;
+			memcpy(&uncompressed[block * uncompressed_block_bytes + offset], &src[y * init_data[0].row_pitch + x * pixel_size],
+				pixel_size);
+		}
+	}
+
+	for (auto const method : { TCM_Speed, TCM_Balanced, TCM_Quality })
+	{
+		std::vector<uint8_t> per_block(num_blocks * block_bytes);
+		for (uint32_t block = 0; block < num_blocks; ++ block)
+		{
+			codec->EncodeBlock(&per_block[block * block_bytes], &uncompressed[block * uncompressed_block_bytes], method);
+		}
+
+		std::vector<uint8_t> batched(num_blocks * block_bytes);
+		codec->EncodeBlocks(batched.data(), uncompressed.data(), num_blocks, method);
+
+		EXPECT_TRUE(per_block == batched);
+	}
+}
+
+TEST(EncodeDecodeTexTest, EncodeBlocksBC1)
+{
+	TestEncodeBlocks("Lenna.dds", EF_BC1);
+	TestEncodeBlocks("leaf_v3_green_tex.dds", EF_BC1);
+}
+
+TEST(EncodeDecodeTexTest, EncodeBlocksBC2)
+{
+	TestEncodeBlocks("leaf_v3_green_tex.dds", EF_BC2);
+}
+
+TEST(EncodeDecodeTexTest, EncodeBlocksBC3)
+{
+	TestEncodeBlocks("leaf_v3_green_tex.dds", EF_BC3);
+}
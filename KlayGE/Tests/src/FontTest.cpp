@@ -0,0 +1,191 @@
+/**
+ * @file FontTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KlayGE/KlayGE.hpp>
+#include <KlayGE/Font.hpp>
+
+#include "KlayGETests.hpp"
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	GlyphAtlas::Glyph const* InsertGlyph(GlyphAtlas& atlas, wchar_t ch, uint32_t width, uint32_t height, bool& evicted)
+	{
+		GlyphAtlas::Glyph const* glyph = atlas.Insert(ch, width, height, evicted);
+		EXPECT_EQ(atlas.Find(ch), glyph);
+		return glyph;
+	}
+
+	void ExpectSlot(GlyphAtlas::Glyph const* glyph, int32_t x, int32_t y)
+	{
+		ASSERT_NE(glyph, nullptr);
+		EXPECT_EQ(glyph->slot.x(), x);
+		EXPECT_EQ(glyph->slot.y(), y);
+	}
+}
+
+TEST(FontTest, GlyphAtlasSlotSize)
+{
+	GlyphAtlas atlas(64, 32);
+
+	EXPECT_EQ(atlas.SlotSize(0), 8U);
+	EXPECT_EQ(atlas.SlotSize(3), 32U);
+
+	// A texel to spare
+	EXPECT_EQ(atlas.SlotSizeClass(7), 0U);
+	EXPECT_EQ(atlas.SlotSizeClass(8), 1U);
+	EXPECT_EQ(atlas.SlotSizeClass(31), 3U);
+	EXPECT_EQ(atlas.SlotSizeClass(32), 3U);
+}
+
+TEST(FontTest, GlyphAtlasShelfPacking)
+{
+	GlyphAtlas atlas(64, 32);
+	atlas.BeginText();
+
+	bool evicted;
+	for (int32_t i = 0; i < 8; ++ i)
+	{
+		GlyphAtlas::Glyph const* glyph = InsertGlyph(atlas, static_cast<wchar_t>(L'a' + i), 7, 7, evicted);
+		ExpectSlot(glyph, i * 8, 0);
+		EXPECT_FALSE(evicted);
+		EXPECT_FLOAT_EQ(glyph->rc.left(), i * 8 / 64.0f);
+		EXPECT_FLOAT_EQ(glyph->rc.right(), (i * 8 + 7) / 64.0f);
+	}
+
+	// The shelf is full, so a new one is opened below it
+	ExpectSlot(InsertGlyph(atlas, L'i', 7, 7, evicted), 0, 8);
+	EXPECT_FALSE(evicted);
+
+	// Taller glyphs have their own shelf
+	ExpectSlot(InsertGlyph(atlas, L'j', 15, 15, evicted), 0, 16);
+	ExpectSlot(InsertGlyph(atlas, L'k', 7, 15, evicted), 16, 16);
+	ExpectSlot(InsertGlyph(atlas, L'l', 7, 7, evicted), 8, 8);
+	EXPECT_FALSE(evicted);
+
+	EXPECT_EQ(atlas.NumGlyphs(), 12U);
+}
+
+TEST(FontTest, GlyphAtlasLruEviction)
+{
+	// Holds four 8x8 slots
+	GlyphAtlas atlas(16, 32);
+
+	bool evicted;
+	for (wchar_t ch = L'a'; ch <= L'd'; ++ ch)
+	{
+		atlas.BeginText();
+		InsertGlyph(atlas, ch, 7, 7, evicted);
+		EXPECT_FALSE(evicted);
+	}
+	GlyphAtlas::Glyph const b = *atlas.Find(L'b');
+
+	atlas.BeginText();
+	EXPECT_NE(atlas.Touch(L'a'), nullptr);
+	EXPECT_EQ(atlas.Touch(L'e'), nullptr);
+
+	// 'a' is touched, so 'b' is the least recently used, and its slot is reused
+	ExpectSlot(InsertGlyph(atlas, L'e', 7, 7, evicted), b.slot.x(), b.slot.y());
+	EXPECT_TRUE(evicted);
+	EXPECT_EQ(atlas.Find(L'b'), nullptr);
+	EXPECT_NE(atlas.Find(L'a'), nullptr);
+	EXPECT_EQ(atlas.NumGlyphs(), 4U);
+}
+
+TEST(FontTest, GlyphAtlasCurrentTextNotEvicted)
+{
+	GlyphAtlas atlas(16, 32);
+	atlas.BeginText();
+
+	bool evicted;
+	for (wchar_t ch = L'a'; ch <= L'd'; ++ ch)
+	{
+		InsertGlyph(atlas, ch, 7, 7, evicted);
+	}
+
+	// All glyphs are used by the current text
+	EXPECT_EQ(atlas.Insert(L'e', 7, 7, evicted), nullptr);
+	EXPECT_FALSE(evicted);
+	EXPECT_EQ(atlas.NumGlyphs(), 4U);
+
+	atlas.BeginText();
+	ExpectSlot(InsertGlyph(atlas, L'e', 7, 7, evicted), 0, 0);
+	EXPECT_TRUE(evicted);
+	EXPECT_EQ(atlas.Find(L'a'), nullptr);
+}
+
+TEST(FontTest, GlyphAtlasLargerFreeSlotReused)
+{
+	GlyphAtlas atlas(16, 32);
+
+	bool evicted;
+	atlas.BeginText();
+	ExpectSlot(InsertGlyph(atlas, L'a', 15, 15, evicted), 0, 0);
+
+	// No room on a shelf, so the 16x16 slot of 'a' is freed and taken by a smaller glyph
+	atlas.BeginText();
+	GlyphAtlas::Glyph const* glyph = InsertGlyph(atlas, L'b', 7, 7, evicted);
+	ExpectSlot(glyph, 0, 0);
+	EXPECT_TRUE(evicted);
+	EXPECT_EQ(glyph->w_class, 1U);
+	EXPECT_EQ(glyph->h_class, 1U);
+	EXPECT_FLOAT_EQ(glyph->rc.right(), 7 / 16.0f);
+	EXPECT_FLOAT_EQ(glyph->rc.bottom(), 7 / 16.0f);
+
+	// The slot goes back to the 16x16 free list when evicted
+	atlas.BeginText();
+	ExpectSlot(InsertGlyph(atlas, L'c', 15, 15, evicted), 0, 0);
+	EXPECT_TRUE(evicted);
+	EXPECT_EQ(atlas.NumGlyphs(), 1U);
+}
+
+TEST(FontTest, GlyphAtlasResetWhenFreeSlotsTooSmall)
+{
+	GlyphAtlas atlas(16, 32);
+
+	bool evicted;
+	atlas.BeginText();
+	for (wchar_t ch = L'a'; ch <= L'd'; ++ ch)
+	{
+		InsertGlyph(atlas, ch, 7, 7, evicted);
+	}
+
+	// Evicting all of the 8x8 slots doesn't make a 16x16 one, so the atlas starts over
+	atlas.BeginText();
+	ExpectSlot(InsertGlyph(atlas, L'e', 15, 15, evicted), 0, 0);
+	EXPECT_TRUE(evicted);
+	EXPECT_EQ(atlas.NumGlyphs(), 1U);
+	for (wchar_t ch = L'a'; ch <= L'd'; ++ ch)
+	{
+		EXPECT_EQ(atlas.Find(ch), nullptr);
+	}
+}
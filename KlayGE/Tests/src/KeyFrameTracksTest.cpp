@@ -0,0 +1,374 @@
+/**
+ * @file KeyFrameTracksTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Math.hpp>
+#include <KFL/ResIdentifier.hpp>
+#include <KlayGE/Mesh.hpp>
+#include <KlayGE/SceneNode.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "KlayGETests.hpp"
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	std::vector<KeyFrameSet> RandomKeyFrameSets(uint32_t num_tracks, uint32_t seed)
+	{
+		std::ranlux24_base gen(seed);
+		std::uniform_real_distribution<float> dis(-1, 1);
+		std::uniform_int_distribution<uint32_t> num_keys_dis(1, 12);
+		std::uniform_int_distribution<uint32_t> gap_dis(1, 9);
+
+		std::vector<KeyFrameSet> kfs(num_tracks);
+		for (auto& kf : kfs)
+		{
+			uint32_t const num_keys = num_keys_dis(gen);
+			uint32_t frame = 0;
+			for (uint32_t i = 0; i < num_keys; ++ i)
+			{
+				Quaternion const real = MathLib::normalize(Quaternion(dis(gen), dis(gen), dis(gen), dis(gen)));
+				float3 const trans(dis(gen) * 10, dis(gen) * 10, dis(gen) * 10);
+
+				kf.frame_id.push_back(frame);
+				kf.bind_real.push_back(real);
+				kf.bind_dual.push_back(MathLib::quat_trans_to_udq(real, trans));
+				kf.bind_scale.push_back(1.5f + dis(gen));
+
+				frame += gap_dis(gen);
+			}
+		}
+		return kfs;
+	}
+
+	void ExpectSameAsFrame(std::vector<KeyFrameSet> const & kfs, KeyFrameTracks const & tracks, float frame,
+		std::vector<uint32_t>& cursors)
+	{
+		std::vector<Quaternion> reals(kfs.size());
+		std::vector<Quaternion> duals(kfs.size());
+		std::vector<float> scales(kfs.size());
+		tracks.Sample(frame, cursors, reals, duals, scales);
+
+		for (size_t i = 0; i < kfs.size(); ++ i)
+		{
+			auto const expected = kfs[i].Frame(frame);
+			for (uint32_t j = 0; j < 4; ++ j)
+			{
+				EXPECT_NEAR(reals[i][j], std::get<0>(expected)[j], 1e-5f) << "track " << i << " at frame " << frame;
+				EXPECT_NEAR(duals[i][j], std::get<1>(expected)[j], 1e-4f) << "track " << i << " at frame " << frame;
+			}
+			EXPECT_NEAR(scales[i], std::get<2>(expected), 1e-5f) << "track " << i << " at frame " << frame;
+		}
+	}
+
+	// KeyFrameSet::Frame with the blend of quantized tracks
+	std::tuple<Quaternion, Quaternion, float> QuantizedFrame(KeyFrameSet const & kf, float frame)
+	{
+		if (kf.frame_id.size() == 1)
+		{
+			return std::make_tuple(kf.bind_real[0], kf.bind_dual[0], kf.bind_scale[0]);
+		}
+
+		frame = std::fmod(frame, static_cast<float>(kf.frame_id.back() + 1));
+		size_t const index = std::upper_bound(kf.frame_id.begin(), kf.frame_id.end(), frame) - kf.frame_id.begin();
+		size_t const index0 = index - 1;
+		size_t const index1 = index % kf.frame_id.size();
+		int const frame0 = kf.frame_id[index0];
+		int const frame1 = kf.frame_id[index1];
+		return KeyFrameTracks::QuantizedBlend(kf.bind_real[index0], kf.bind_dual[index0], kf.bind_scale[index0], kf.bind_real[index1],
+			kf.bind_dual[index1], kf.bind_scale[index1], (frame - frame0) / (frame1 - frame0));
+	}
+
+	void ExpectNearQuantizedFrame(std::vector<KeyFrameSet> const & kfs, KeyFrameTracks const & tracks, float frame,
+		std::vector<uint32_t>& cursors)
+	{
+		std::vector<Quaternion> reals(kfs.size());
+		std::vector<Quaternion> duals(kfs.size());
+		std::vector<float> scales(kfs.size());
+		tracks.Sample(frame, cursors, reals, duals, scales);
+
+		// 16 bits for rotations, and for translations in [-10, 10] and scales in [0.5, 2.5]
+		for (size_t i = 0; i < kfs.size(); ++ i)
+		{
+			auto const expected = QuantizedFrame(kfs[i], frame);
+			for (uint32_t j = 0; j < 4; ++ j)
+			{
+				EXPECT_NEAR(reals[i][j], std::get<0>(expected)[j], 1e-4f) << "track " << i << " at frame " << frame;
+				EXPECT_NEAR(duals[i][j], std::get<1>(expected)[j], 1e-3f) << "track " << i << " at frame " << frame;
+			}
+			EXPECT_NEAR(scales[i], std::get<2>(expected), 1e-4f) << "track " << i << " at frame " << frame;
+		}
+	}
+}
+
+TEST(KeyFrameTracksTest, PlayForward)
+{
+	auto const kfs = RandomKeyFrameSets(37, 1);
+	KeyFrameTracks const tracks(kfs);
+	EXPECT_EQ(tracks.NumTracks(), kfs.size());
+
+	// Loops a few times, so the cursors also wrap around
+	std::vector<uint32_t> cursors(kfs.size(), 0);
+	for (float frame = 0; frame < 300; frame += 0.37f)
+	{
+		ExpectSameAsFrame(kfs, tracks, frame, cursors);
+	}
+}
+
+TEST(KeyFrameTracksTest, RandomAccess)
+{
+	auto const kfs = RandomKeyFrameSets(21, 2);
+	KeyFrameTracks const tracks(kfs);
+
+	std::ranlux24_base gen(3);
+	std::uniform_real_distribution<float> dis(0, 200);
+
+	std::vector<uint32_t> cursors(kfs.size(), 0);
+	for (uint32_t i = 0; i < 500; ++ i)
+	{
+		ExpectSameAsFrame(kfs, tracks, dis(gen), cursors);
+	}
+
+	// Exactly on the keys
+	for (uint32_t frame = 0; frame < 120; ++ frame)
+	{
+		ExpectSameAsFrame(kfs, tracks, static_cast<float>(frame), cursors);
+	}
+}
+
+TEST(KeyFrameTracksTest, Quantized)
+{
+	auto const kfs = RandomKeyFrameSets(37, 4);
+	KeyFrameTracks const tracks(kfs, true);
+	EXPECT_TRUE(tracks.Quantized());
+	EXPECT_EQ(tracks.NumTracks(), kfs.size());
+
+	std::vector<uint32_t> cursors(kfs.size(), 0);
+	for (float frame = 0; frame < 300; frame += 0.37f)
+	{
+		ExpectNearQuantizedFrame(kfs, tracks, frame, cursors);
+	}
+
+	auto const decoded_kfs = tracks.ToKeyFrameSets();
+	ASSERT_EQ(decoded_kfs.size(), kfs.size());
+	for (size_t i = 0; i < kfs.size(); ++ i)
+	{
+		EXPECT_EQ(decoded_kfs[i].frame_id, kfs[i].frame_id);
+		for (size_t k = 0; k < kfs[i].frame_id.size(); ++ k)
+		{
+			for (uint32_t j = 0; j < 4; ++ j)
+			{
+				EXPECT_NEAR(decoded_kfs[i].bind_real[k][j], kfs[i].bind_real[k][j], 1e-4f);
+				EXPECT_NEAR(decoded_kfs[i].bind_dual[k][j], kfs[i].bind_dual[k][j], 1e-3f);
+			}
+			EXPECT_NEAR(decoded_kfs[i].bind_scale[k], kfs[i].bind_scale[k], 1e-4f);
+		}
+	}
+}
+
+TEST(KeyFrameTracksTest, QuantizedStream)
+{
+	auto const kfs = RandomKeyFrameSets(9, 5);
+	KeyFrameTracks const tracks(kfs, true);
+
+	std::ostringstream os;
+	tracks.StreamOut(os);
+	std::string const data = os.str();
+
+	ResIdentifier res("tracks", 0, std::span(reinterpret_cast<uint8_t const*>(data.data()), data.size()), nullptr);
+	KeyFrameTracks loaded_tracks;
+	loaded_tracks.StreamIn(res);
+	EXPECT_TRUE(loaded_tracks.Quantized());
+	EXPECT_EQ(loaded_tracks.NumTracks(), tracks.NumTracks());
+
+	std::vector<uint32_t> cursors(kfs.size(), 0);
+	std::vector<uint32_t> loaded_cursors(kfs.size(), 0);
+	std::vector<Quaternion> reals(kfs.size()), loaded_reals(kfs.size());
+	std::vector<Quaternion> duals(kfs.size()), loaded_duals(kfs.size());
+	std::vector<float> scales(kfs.size()), loaded_scales(kfs.size());
+	for (float frame = 0; frame < 100; frame += 0.61f)
+	{
+		tracks.Sample(frame, cursors, reals, duals, scales);
+		loaded_tracks.Sample(frame, loaded_cursors, loaded_reals, loaded_duals, loaded_scales);
+		EXPECT_EQ(loaded_reals, reals);
+		EXPECT_EQ(loaded_duals, duals);
+		EXPECT_EQ(loaded_scales, scales);
+	}
+}
+
+TEST(KeyFrameTracksTest, QuantizedStreamRejectsBadData)
+{
+	auto const kfs = RandomKeyFrameSets(9, 6);
+	KeyFrameTracks const tracks(kfs, true);
+
+	std::ostringstream os;
+	tracks.StreamOut(os);
+	std::string const data = os.str();
+
+	auto stream_in = [](std::string const & bad_data) {
+		ResIdentifier res("tracks", 0, std::span(reinterpret_cast<uint8_t const*>(bad_data.data()), bad_data.size()), nullptr);
+		KeyFrameTracks loaded_tracks;
+		loaded_tracks.StreamIn(res);
+	};
+
+	// Truncated at every section, including in the middle of the counts
+	for (size_t size : {size_t(0), size_t(2), size_t(4), size_t(10), data.size() / 2, data.size() - 1})
+	{
+		EXPECT_ANY_THROW(stream_in(data.substr(0, size))) << "size " << size;
+	}
+
+	// Counts bigger than the stream
+	{
+		std::string bad_data = data;
+		uint32_t const num_tracks = Native2LE(0x10000000U);
+		std::memcpy(&bad_data[0], &num_tracks, sizeof(num_tracks));
+		EXPECT_ANY_THROW(stream_in(bad_data));
+	}
+	{
+		std::string bad_data = data;
+		uint32_t const num_keys = Native2LE(0xFFFFFFFFU);
+		std::memcpy(&bad_data[sizeof(uint32_t)], &num_keys, sizeof(num_keys));
+		EXPECT_ANY_THROW(stream_in(bad_data));
+	}
+
+	// A track without keys
+	{
+		std::string bad_data = data;
+		uint32_t const num_keys = 0;
+		std::memcpy(&bad_data[sizeof(uint32_t)], &num_keys, sizeof(num_keys));
+		EXPECT_ANY_THROW(stream_in(bad_data));
+	}
+
+	// Frames out of order in the first track that has more than one key
+	auto const iter = std::find_if(kfs.begin(), kfs.end(), [](KeyFrameSet const & kf) { return kf.frame_id.size() > 1; });
+	ASSERT_NE(iter, kfs.end());
+	{
+		size_t const num_tracks = kfs.size();
+		size_t first_key = 0;
+		for (auto i = kfs.begin(); i != iter; ++ i)
+		{
+			first_key += i->frame_id.size();
+		}
+
+		std::string bad_data = data;
+		size_t const offset = (1 + num_tracks + first_key) * sizeof(uint32_t);
+		std::swap_ranges(&bad_data[offset], &bad_data[offset + sizeof(uint32_t)], &bad_data[offset + sizeof(uint32_t)]);
+		EXPECT_ANY_THROW(stream_in(bad_data));
+	}
+
+	EXPECT_NO_THROW(stream_in(data));
+}
+
+TEST(KeyFrameTracksTest, SkinnedModelJointChain)
+{
+	uint32_t const num_joints = 6;
+	auto kfs = MakeSharedPtr<std::vector<KeyFrameSet>>(RandomKeyFrameSets(num_joints, 7));
+
+	// Every joint is a child of the one before it
+	auto const make_model = [num_joints, &kfs]() {
+		auto root_node = MakeSharedPtr<SceneNode>(L"root", SceneNode::SOA_Cullable);
+		auto model = MakeSharedPtr<SkinnedModel>(root_node);
+
+		std::vector<JointComponentPtr> joints;
+		SceneNode* parent_node = root_node.get();
+		for (uint32_t i = 0; i < num_joints; ++ i)
+		{
+			auto joint_node = MakeSharedPtr<SceneNode>(L"joint_" + std::to_wstring(i), SceneNode::SOA_Cullable);
+			auto joint = MakeSharedPtr<JointComponent>();
+			joint->BindParams(Quaternion::Identity(), Quaternion(0, 0, 0, 0), 1);
+			joint->InverseOriginParams(Quaternion::Identity(), Quaternion(0, 0, 0, 0), 1);
+			joint_node->AddComponent(joint);
+			parent_node->AddChild(joint_node);
+			parent_node = joint_node.get();
+			joints.push_back(joint);
+		}
+		model->AssignJoints(joints.begin(), joints.end());
+		model->AttachKeyFrameSets(kfs);
+		return model;
+	};
+
+	// KeyFrameSet::Frame of every joint, transformed by its parent as matrices
+	auto const expect_posed = [&kfs](SkinnedModel const & model, float frame) {
+		float4x4 parent_mat = float4x4::Identity();
+		for (uint32_t i = 0; i < model.NumJoints(); ++ i)
+		{
+			auto const key = (*kfs)[i].Frame(frame);
+			float const key_scale = std::get<2>(key);
+			float4x4 const mat = MathLib::scaling(key_scale, key_scale, key_scale)
+				* MathLib::udq_to_matrix(std::get<0>(key), std::get<1>(key)) * parent_mat;
+
+			auto const & joint = *model.GetJoint(i);
+			float4x4 const joint_mat = MathLib::scaling(joint.BindScale(), joint.BindScale(), joint.BindScale())
+				* MathLib::udq_to_matrix(joint.BindReal(), joint.BindDual());
+			for (uint32_t j = 0; j < float4x4::size(); ++ j)
+			{
+				EXPECT_NEAR(joint_mat[j], mat[j], 1e-3f * (1 + std::abs(mat[j]))) << "joint " << i << " at frame " << frame;
+			}
+
+			parent_mat = mat;
+		}
+	};
+
+	auto const model = make_model();
+	for (float frame : {0.5f, 3.25f, 17.0f, 42.7f, 5.5f, 130.1f})
+	{
+		model->SetFrame(frame);
+		expect_posed(*model, frame);
+	}
+
+	// Posing in a batch
+	auto const batch_model0 = make_model();
+	auto const batch_model1 = make_model();
+	SkinnedModel* const batch_models[] = {batch_model0.get(), batch_model1.get()};
+	float const batch_frames[] = {7.3f, 11.6f};
+	SkinnedModel::SetFrames(batch_models, batch_frames);
+	expect_posed(*batch_model0, batch_frames[0]);
+	expect_posed(*batch_model1, batch_frames[1]);
+
+	// Edited key frames take effect once attached again
+	auto edited_kfs = MakeSharedPtr<std::vector<KeyFrameSet>>(*model->GetKeyFrameSets());
+	for (auto& scale : (*edited_kfs)[0].bind_scale)
+	{
+		scale *= 2;
+	}
+	model->AttachKeyFrameSets(edited_kfs);
+	kfs = edited_kfs;
+	model->SetFrame(9.9f);
+	expect_posed(*model, 9.9f);
+}
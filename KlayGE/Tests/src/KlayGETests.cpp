@@ -25,7 +25,8 @@ namespace KlayGE
 
 		virtual uint32_t DoUpdate([[maybe_unused]] uint32_t pass) override
 		{
-			return URV_Finished;
+			// A single pass, so a test that calls SceneManager::Update() gets the scene culled and rendered once
+			return URV_NeedFlush | URV_Finished;
 		}
 	};
 
@@ -0,0 +1,152 @@
+/**
+ * @file LZMACodecTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KlayGE/KlayGE.hpp>
+#include <KlayGE/LZMACodec.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "KlayGETests.hpp"
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	std::vector<uint8_t> TestData(size_t size)
+	{
+		// Compressible, but not trivially so
+		std::ranlux24_base gen;
+		std::uniform_int_distribution<uint32_t> dis(0, 15);
+
+		std::vector<uint8_t> data(size);
+		for (size_t i = 0; i < size; ++ i)
+		{
+			data[i] = static_cast<uint8_t>((i / 64) + dis(gen));
+		}
+		return data;
+	}
+}
+
+TEST(LZMACodecTest, FramedRoundTrip)
+{
+	uint32_t const FRAME_SIZE = 4096;
+
+	for (size_t const size : {0U, 1U, FRAME_SIZE - 1, FRAME_SIZE, FRAME_SIZE * 5 + 17})
+	{
+		auto const data = TestData(size);
+
+		LZMACodec lzma;
+		std::vector<uint8_t> encoded;
+		lzma.EncodeFramed(encoded, data, FRAME_SIZE);
+		EXPECT_EQ(LZMACodec::FramedOriginalLength(encoded), size);
+
+		std::vector<uint8_t> decoded;
+		lzma.DecodeFramed(decoded, encoded);
+		EXPECT_EQ(decoded, data);
+	}
+}
+
+TEST(LZMACodecTest, FramedSubRange)
+{
+	uint32_t const FRAME_SIZE = 4096;
+
+	auto const data = TestData(FRAME_SIZE * 8 + 100);
+
+	LZMACodec lzma;
+	std::vector<uint8_t> encoded;
+	lzma.EncodeFramed(encoded, data, FRAME_SIZE);
+
+	std::pair<uint64_t, uint64_t> const ranges[] = {
+		{0, 1},
+		{0, FRAME_SIZE},
+		{FRAME_SIZE, FRAME_SIZE * 2},
+		{FRAME_SIZE - 10, 20},
+		{123, FRAME_SIZE * 6 + 55},
+		{data.size() - 50, 50},
+	};
+	for (auto const & range : ranges)
+	{
+		std::vector<uint8_t> decoded(static_cast<size_t>(range.second));
+		lzma.DecodeFramed(decoded.data(), encoded, range.first, range.second);
+		EXPECT_TRUE(std::equal(decoded.begin(), decoded.end(), data.begin() + static_cast<size_t>(range.first)));
+	}
+}
+
+TEST(LZMACodecTest, FramedRejectsCorruptStreams)
+{
+	uint32_t const FRAME_SIZE = 4096;
+	uint32_t const FRAMED_HEADER_SIZE = 20;
+
+	auto const data = TestData(FRAME_SIZE * 3 + 5);
+
+	LZMACodec lzma;
+	std::vector<uint8_t> encoded;
+	lzma.EncodeFramed(encoded, data, FRAME_SIZE);
+
+	auto corrupt = [](std::vector<uint8_t> input, size_t offset, auto value)
+	{
+		value = Native2LE(value);
+		std::memcpy(&input[offset], &value, sizeof(value));
+		return input;
+	};
+
+	std::vector<std::vector<uint8_t>> const corrupted = {
+		// Truncated inside the header and inside the offset table
+		std::vector<uint8_t>(encoded.begin(), encoded.begin() + FRAMED_HEADER_SIZE - 1),
+		std::vector<uint8_t>(encoded.begin(), encoded.begin() + FRAMED_HEADER_SIZE + 8),
+		// Zero frame size
+		corrupt(encoded, 4, 0U),
+		// Frame count that doesn't match the length
+		corrupt(encoded, 16, 5U),
+		// Consistent header whose offset table size wraps around in 32-bit math
+		corrupt(corrupt(corrupt(encoded, 4, 1U), 8, static_cast<uint64_t>(0xFFFFFFFFU)), 16, 0xFFFFFFFFU),
+		// Frame offsets going backwards, into the table, and past the end
+		corrupt(encoded, FRAMED_HEADER_SIZE + 8, static_cast<uint64_t>(encoded.size())),
+		corrupt(encoded, FRAMED_HEADER_SIZE, static_cast<uint64_t>(0)),
+		corrupt(encoded, FRAMED_HEADER_SIZE + 3 * 8, static_cast<uint64_t>(encoded.size() + 1)),
+		// Last frame longer in the header than its data decodes to
+		corrupt(encoded, 8, static_cast<uint64_t>(data.size() + 1)),
+		// Empty first frame, too short to have the LZMA properties
+		corrupt(encoded, FRAMED_HEADER_SIZE + 8, static_cast<uint64_t>(FRAMED_HEADER_SIZE + 5 * 8)),
+	};
+	for (auto const & input : corrupted)
+	{
+		std::vector<uint8_t> decoded;
+		EXPECT_ANY_THROW(lzma.DecodeFramed(decoded, input));
+	}
+
+	std::vector<uint8_t> decoded(16);
+	EXPECT_ANY_THROW(lzma.DecodeFramed(decoded.data(), encoded, data.size() - 8, 16));
+	EXPECT_ANY_THROW(lzma.DecodeFramed(decoded.data(), encoded, ~0ULL - 8, 16));
+}
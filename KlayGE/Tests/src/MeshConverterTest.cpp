@@ -37,6 +37,15 @@
 #include <KlayGE/DevHelper/MeshConverter.hpp>
 #include <KlayGE/DevHelper/MeshMetadata.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <tuple>
+#include <vector>
+
 #include "KlayGETests.hpp"
 
 using namespace std;
@@ -711,11 +720,13 @@ public:
 				EXPECT_EQ(end_frame, sanity_end_frame);
 			}
 
-			EXPECT_EQ(skinned_model.GetKeyFrameSets()->size(), sanity_skinned_model.GetKeyFrameSets()->size());
-			for (uint32_t i = 0; i < sanity_skinned_model.GetKeyFrameSets()->size(); ++ i)
+			auto const kfs = skinned_model.GetKeyFrameSets();
+			auto const sanity_kfs = sanity_skinned_model.GetKeyFrameSets();
+			EXPECT_EQ(kfs->size(), sanity_kfs->size());
+			for (uint32_t i = 0; i < sanity_kfs->size(); ++ i)
 			{
-				auto const & key_frames = (*(skinned_model.GetKeyFrameSets()))[i];
-				auto const & sanity_key_frames = (*(sanity_skinned_model.GetKeyFrameSets()))[i];
+				auto const & key_frames = (*kfs)[i];
+				auto const & sanity_key_frames = (*sanity_kfs)[i];
 
 				EXPECT_EQ(key_frames.frame_id.size(), key_frames.bind_real.size());
 				EXPECT_EQ(key_frames.frame_id.size(), key_frames.bind_dual.size());
@@ -818,3 +829,303 @@ TEST_F(MeshConverterTest, StaticMeshML)
 {
 	RunTest("tree2a.lod.meshml", "", "tree2a.lod.meshml");
 }
+
+namespace
+{
+	// Compares the elements a draw of the lod reads
+	bool SameRange(GraphicsBuffer& buff0, uint32_t start0, GraphicsBuffer& buff1, uint32_t start1, uint32_t num, uint32_t elem_size)
+	{
+		GraphicsBuffer::Mapper mapper0(buff0, BA_Read_Only);
+		GraphicsBuffer::Mapper mapper1(buff1, BA_Read_Only);
+		return std::memcmp(mapper0.Pointer<uint8_t>() + start0 * elem_size, mapper1.Pointer<uint8_t>() + start1 * elem_size,
+			num * elem_size) == 0;
+	}
+
+	void ExpectSameGeometry(RenderModel const & model, RenderModel const & sanity_model)
+	{
+		ASSERT_EQ(model.NumMeshes(), sanity_model.NumMeshes());
+		for (uint32_t i = 0; i < sanity_model.NumMeshes(); ++ i)
+		{
+			auto const & mesh = checked_cast<StaticMesh&>(*model.Mesh(i));
+			auto const & sanity_mesh = checked_cast<StaticMesh&>(*sanity_model.Mesh(i));
+
+			ASSERT_EQ(mesh.NumLods(), sanity_mesh.NumLods());
+			for (uint32_t lod = 0; lod < sanity_mesh.NumLods(); ++ lod)
+			{
+				ASSERT_EQ(mesh.NumVertices(lod), sanity_mesh.NumVertices(lod));
+				ASSERT_EQ(mesh.NumIndices(lod), sanity_mesh.NumIndices(lod));
+
+				auto const & rl = mesh.GetRenderLayout(lod);
+				auto const & sanity_rl = sanity_mesh.GetRenderLayout(lod);
+				ASSERT_EQ(rl.NumVertexStreams(), sanity_rl.NumVertexStreams());
+				for (uint32_t j = 0; j < sanity_rl.NumVertexStreams(); ++ j)
+				{
+					auto const & ve = rl.VertexStreamFormat(j)[0];
+					EXPECT_TRUE(ve == sanity_rl.VertexStreamFormat(j)[0]);
+					EXPECT_TRUE(SameRange(*rl.GetVertexStream(j), mesh.StartVertexLocation(lod), *sanity_rl.GetVertexStream(j),
+						sanity_mesh.StartVertexLocation(lod), mesh.NumVertices(lod), ve.element_size()));
+				}
+				ASSERT_EQ(rl.IndexStreamFormat(), sanity_rl.IndexStreamFormat());
+				EXPECT_TRUE(SameRange(*rl.GetIndexStream(), mesh.StartIndexLocation(lod), *sanity_rl.GetIndexStream(),
+					sanity_mesh.StartIndexLocation(lod), mesh.NumIndices(lod), NumFormatBytes(rl.IndexStreamFormat())));
+			}
+		}
+	}
+
+	std::vector<char> ReadFile(std::filesystem::path const & path)
+	{
+		std::ifstream ifs(path, std::ios_base::binary);
+		return std::vector<char>(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+	}
+
+	void WriteFile(std::filesystem::path const & path, std::vector<char> const & data)
+	{
+		std::ofstream ofs(path, std::ios_base::binary);
+		ofs.write(data.data(), static_cast<std::streamsize>(data.size()));
+	}
+
+	RenderModelPtr LoadAnimation(std::string_view input_name, float tolerance, bool quantize)
+	{
+		MeshMetadata metadata(std::string(input_name) + ".kmeta");
+		metadata.AnimationTolerance(tolerance);
+		metadata.QuantizeAnimation(quantize);
+
+		MeshConverter mc;
+		return mc.Load(metadata);
+	}
+
+	size_t NumKeys(std::vector<KeyFrameSet> const & kfs)
+	{
+		size_t num_keys = 0;
+		for (auto const & kf : kfs)
+		{
+			num_keys += kf.frame_id.size();
+		}
+		return num_keys;
+	}
+
+	// Samples the tracks on the frames of the source keys, and measures the error in the transform relative to the source key, as the
+	// converter does in dropping keys. Quantized tracks are also off by a half step of 16 bits in the range of the track.
+	void ExpectNearSourceKeys(SkinnedModel const & model, std::vector<KeyFrameSet> const & source_kfs, float tolerance, bool quantized)
+	{
+		auto const & tracks = *model.GetKeyFrameTracks();
+		ASSERT_EQ(tracks.NumTracks(), source_kfs.size());
+
+		uint32_t const num_tracks = tracks.NumTracks();
+		std::vector<uint32_t> cursors(num_tracks, 0);
+		std::vector<Quaternion> reals(num_tracks);
+		std::vector<Quaternion> duals(num_tracks);
+		std::vector<float> scales(num_tracks);
+		for (uint32_t i = 0; i < num_tracks; ++ i)
+		{
+			auto const & kf = source_kfs[i];
+
+			float real_tolerance = tolerance + 1e-5f;
+			float dual_tolerance = tolerance + 1e-4f;
+			float scale_tolerance = tolerance + 1e-5f;
+			if (quantized)
+			{
+				float3 trans_min(+1e10f, +1e10f, +1e10f);
+				float3 trans_max(-1e10f, -1e10f, -1e10f);
+				for (size_t k = 0; k < kf.frame_id.size(); ++ k)
+				{
+					float3 const trans = MathLib::udq_to_trans(kf.bind_real[k], kf.bind_dual[k]);
+					trans_min = MathLib::minimize(trans_min, trans);
+					trans_max = MathLib::maximize(trans_max, trans);
+				}
+				auto const scale_range = std::minmax_element(kf.bind_scale.begin(), kf.bind_scale.end());
+				float3 const trans_extent = trans_max - trans_min;
+
+				real_tolerance += 1e-4f;
+				dual_tolerance += std::max(std::max(trans_extent.x(), trans_extent.y()), trans_extent.z()) / 65535;
+				scale_tolerance += (*scale_range.second - *scale_range.first) / 65535;
+			}
+
+			for (size_t k = 0; k < kf.frame_id.size(); ++ k)
+			{
+				float const frame = static_cast<float>(kf.frame_id[k]);
+				tracks.Sample(frame, cursors, reals, duals, scales);
+
+				Quaternion real = reals[i];
+				Quaternion dual = duals[i];
+				if (MathLib::dot(kf.bind_real[k], real) < 0)
+				{
+					real = -real;
+					dual = -dual;
+				}
+
+				Quaternion diff_real;
+				Quaternion diff_dual;
+				std::tie(diff_real, diff_dual) = MathLib::inverse(kf.bind_real[k], kf.bind_dual[k]);
+				diff_dual = MathLib::mul_dual(diff_real, diff_dual, real, dual);
+				diff_real = MathLib::mul_real(diff_real, real);
+
+				EXPECT_NEAR(diff_real.x(), 0, real_tolerance) << "track " << i << " at frame " << frame;
+				EXPECT_NEAR(diff_real.y(), 0, real_tolerance) << "track " << i << " at frame " << frame;
+				EXPECT_NEAR(diff_real.z(), 0, real_tolerance) << "track " << i << " at frame " << frame;
+				EXPECT_NEAR(diff_real.w(), 1, real_tolerance) << "track " << i << " at frame " << frame;
+				EXPECT_NEAR(diff_dual.x(), 0, dual_tolerance) << "track " << i << " at frame " << frame;
+				EXPECT_NEAR(diff_dual.y(), 0, dual_tolerance) << "track " << i << " at frame " << frame;
+				EXPECT_NEAR(diff_dual.z(), 0, dual_tolerance) << "track " << i << " at frame " << frame;
+				EXPECT_NEAR(diff_dual.w(), 0, dual_tolerance) << "track " << i << " at frame " << frame;
+				EXPECT_NEAR(scales[i], kf.bind_scale[k], scale_tolerance * std::abs(kf.bind_scale[k]))
+					<< "track " << i << " at frame " << frame;
+			}
+		}
+	}
+}
+
+TEST_F(MeshConverterTest, ModelBinRoundTrip)
+{
+	MeshMetadata metadata("tree2a.lod.kmeta");
+	MeshConverter mc;
+	auto const target = mc.Load(metadata);
+	ASSERT_TRUE(target);
+
+	auto const model_bin_path = std::filesystem::current_path() / "tree2a.roundtrip.model_bin";
+	SaveModel(*target, model_bin_path.string());
+	auto const loaded = LoadSoftwareModel(model_bin_path.string());
+	ASSERT_TRUE(loaded);
+	ASSERT_EQ(loaded->NumMeshes(), target->NumMeshes());
+	for (uint32_t i = 0; i < target->NumMeshes(); ++ i)
+	{
+		auto const & mesh = checked_cast<StaticMesh&>(*loaded->Mesh(i));
+		auto const & sanity_mesh = checked_cast<StaticMesh&>(*target->Mesh(i));
+		ASSERT_EQ(mesh.NumLods(), sanity_mesh.NumLods());
+		for (uint32_t lod = 0; lod < sanity_mesh.NumLods(); ++ lod)
+		{
+			EXPECT_EQ(mesh.NumVertices(lod), sanity_mesh.NumVertices(lod));
+			EXPECT_EQ(mesh.NumIndices(lod), sanity_mesh.NumIndices(lod));
+		}
+	}
+
+	// Saving what was loaded gives the same model again
+	auto const resaved_path = std::filesystem::current_path() / "tree2a.resaved.model_bin";
+	SaveModel(*loaded, resaved_path.string());
+	ExpectSameGeometry(*LoadSoftwareModel(resaved_path.string()), *loaded);
+
+	// A streamed model starts with its coarsest lod. Saving it loads the other lods one at a time through the lod streamer.
+	auto const streamed = LoadSoftwareModel(model_bin_path.string(), true);
+	ASSERT_TRUE(streamed);
+	auto const & streamed_mesh = checked_cast<StaticMesh&>(*streamed->Mesh(0));
+	ASSERT_GT(streamed_mesh.NumLods(), 1U);
+	EXPECT_EQ(streamed_mesh.ResidentLod(), streamed_mesh.NumLods() - 1);
+	EXPECT_TRUE(streamed_mesh.LodStreamer());
+
+	auto const streamed_path = std::filesystem::current_path() / "tree2a.streamed.model_bin";
+	SaveModel(*streamed, streamed_path.string());
+	ExpectSameGeometry(*LoadSoftwareModel(streamed_path.string()), *loaded);
+
+	std::filesystem::remove(streamed_path);
+	std::filesystem::remove(resaved_path);
+	std::filesystem::remove(model_bin_path);
+}
+
+TEST_F(MeshConverterTest, ModelBinRejectsBadFiles)
+{
+	MeshMetadata metadata("tree2a.lod.kmeta");
+	MeshConverter mc;
+	auto const target = mc.Load(metadata);
+	ASSERT_TRUE(target);
+
+	auto const model_bin_path = std::filesystem::current_path() / "tree2a.bad.model_bin";
+	SaveModel(*target, model_bin_path.string());
+	auto const data = ReadFile(model_bin_path);
+	ASSERT_GT(data.size(), 8U);
+
+	// A v20 file, from before the quantized key frame flag, has to be reconverted
+	auto outdated = data;
+	uint32_t const v20 = Native2LE(20U);
+	std::memcpy(&outdated[4], &v20, sizeof(v20));
+	WriteFile(model_bin_path, outdated);
+	EXPECT_ANY_THROW(LoadSoftwareModel(model_bin_path.string()));
+
+	// Chunks past the end of a truncated file
+	WriteFile(model_bin_path, std::vector<char>(data.begin(), data.begin() + data.size() / 2));
+	EXPECT_ANY_THROW(LoadSoftwareModel(model_bin_path.string()));
+
+	std::filesystem::remove(model_bin_path);
+}
+
+TEST_F(MeshConverterTest, AnimationKeyReduction)
+{
+	// Without a tolerance, every source key is kept
+	auto const source = LoadAnimation("anim.fbx", 0, false);
+	ASSERT_TRUE(source && source->IsSkinned());
+	auto const & source_model = checked_cast<SkinnedModel&>(*source);
+	auto const source_kfs = source_model.GetKeyFrameSets();
+
+	float const tolerance = 1e-3f;
+	for (bool quantize : {false, true})
+	{
+		auto const target = LoadAnimation("anim.fbx", tolerance, quantize);
+		ASSERT_TRUE(target && target->IsSkinned());
+		auto const & model = checked_cast<SkinnedModel&>(*target);
+		EXPECT_EQ(model.GetKeyFrameTracks()->Quantized(), quantize);
+		EXPECT_EQ(model.NumFrames(), source_model.NumFrames());
+		EXPECT_EQ(model.NumJoints(), source_model.NumJoints());
+
+		EXPECT_LT(NumKeys(*model.GetKeyFrameSets()), NumKeys(*source_kfs));
+		ExpectNearSourceKeys(model, *source_kfs, tolerance, quantize);
+	}
+}
+
+TEST_F(MeshConverterTest, AnimationModelBinRoundTrip)
+{
+	auto const source = LoadAnimation("anim.fbx", 0, false);
+	ASSERT_TRUE(source && source->IsSkinned());
+	auto const source_kfs = checked_cast<SkinnedModel&>(*source).GetKeyFrameSets();
+
+	auto const target = LoadAnimation("anim.fbx", 1e-3f, true);
+	ASSERT_TRUE(target && target->IsSkinned());
+	auto const & model = checked_cast<SkinnedModel&>(*target);
+
+	// The quantized tracks are saved as they are
+	auto const quantized_path = std::filesystem::current_path() / "anim.quantized.model_bin";
+	SaveModel(*target, quantized_path.string());
+	auto const loaded = LoadSoftwareModel(quantized_path.string());
+	ASSERT_TRUE(loaded && loaded->IsSkinned());
+	auto const & loaded_model = checked_cast<SkinnedModel&>(*loaded);
+	EXPECT_EQ(loaded_model.NumFrames(), model.NumFrames());
+	EXPECT_EQ(loaded_model.FrameRate(), model.FrameRate());
+	ASSERT_EQ(loaded_model.NumJoints(), model.NumJoints());
+
+	auto const & tracks = *model.GetKeyFrameTracks();
+	auto const & loaded_tracks = *loaded_model.GetKeyFrameTracks();
+	EXPECT_TRUE(loaded_tracks.Quantized());
+	ASSERT_EQ(loaded_tracks.NumTracks(), tracks.NumTracks());
+
+	uint32_t const num_tracks = tracks.NumTracks();
+	std::vector<uint32_t> cursors(num_tracks, 0);
+	std::vector<uint32_t> loaded_cursors(num_tracks, 0);
+	std::vector<Quaternion> reals(num_tracks), loaded_reals(num_tracks);
+	std::vector<Quaternion> duals(num_tracks), loaded_duals(num_tracks);
+	std::vector<float> scales(num_tracks), loaded_scales(num_tracks);
+	for (float frame = 0; frame < model.NumFrames(); frame += 0.5f)
+	{
+		tracks.Sample(frame, cursors, reals, duals, scales);
+		loaded_tracks.Sample(frame, loaded_cursors, loaded_reals, loaded_duals, loaded_scales);
+		EXPECT_EQ(loaded_reals, reals);
+		EXPECT_EQ(loaded_duals, duals);
+		EXPECT_EQ(loaded_scales, scales);
+	}
+
+	// A model_bin as the input is quantized, or not, as the metadata says
+	auto const unquantized_path = std::filesystem::current_path() / "anim.unquantized.model_bin";
+	SaveModel(*source, unquantized_path.string());
+	for (auto const & path : {quantized_path, unquantized_path})
+	{
+		for (bool quantize : {false, true})
+		{
+			auto const converted = LoadAnimation(path.string(), 1e-3f, quantize);
+			ASSERT_TRUE(converted && converted->IsSkinned());
+			auto const & converted_model = checked_cast<SkinnedModel&>(*converted);
+			EXPECT_EQ(converted_model.GetKeyFrameTracks()->Quantized(), quantize);
+			bool const was_quantized = (path == quantized_path);
+			ExpectNearSourceKeys(converted_model, *source_kfs, was_quantized ? 1e-3f : 0.0f, was_quantized || quantize);
+		}
+	}
+
+	std::filesystem::remove(unquantized_path);
+	std::filesystem::remove(quantized_path);
+}
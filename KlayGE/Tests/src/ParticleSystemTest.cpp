@@ -0,0 +1,211 @@
+/**
+ * @file ParticleSystemTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Math.hpp>
+#include <KFL/Util.hpp>
+#include <KlayGE/ParticleSystem.hpp>
+#include <KlayGE/SceneNode.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "KlayGETests.hpp"
+
+using namespace KlayGE;
+
+namespace
+{
+	ParticleSystemPtr MakeTestParticleSystem(uint32_t max_num_particles)
+	{
+		auto ps = MakeSharedPtr<ParticleSystem>(max_num_particles);
+		ps->Force(float3(0.1f, 0.2f, -0.3f));
+		ps->MediaDensity(0.5f);
+
+		auto updater = checked_pointer_cast<PolylineParticleUpdater>(ps->MakeUpdater("polyline"));
+		updater->SizeOverLife({float2(0, 0.5f), float2(0.5f, 1.5f), float2(1, 1)});
+		updater->MassOverLife({float2(0, 1), float2(1, 2)});
+		updater->OpacityOverLife({float2(0, 1), float2(0.3f, 0.8f), float2(1, 0)});
+		ps->AddUpdater(updater);
+
+		return ps;
+	}
+
+	ParticleBatch MakeParticleBatch(std::vector<float>& attribs, uint32_t num_pars)
+	{
+		auto attrib = [&attribs, num_pars](uint32_t index) { return std::span<float>(&attribs[index * num_pars], num_pars); };
+
+		ParticleBatch ret;
+		ret.pos_x = attrib(0);
+		ret.pos_y = attrib(1);
+		ret.pos_z = attrib(2);
+		ret.vel_x = attrib(3);
+		ret.vel_y = attrib(4);
+		ret.vel_z = attrib(5);
+		ret.life = attrib(6);
+		ret.spin = attrib(7);
+		ret.size = attrib(8);
+		ret.alpha = attrib(9);
+		ret.init_life = attrib(10);
+		return ret;
+	}
+}
+
+TEST(ParticleSystemTest, BatchUpdateMatchesPerParticle)
+{
+	auto ps = MakeTestParticleSystem(16);
+	auto& updater = *ps->Updater(0);
+	updater.SnapParams();
+
+	std::ranlux24_base gen(0);
+	std::uniform_real_distribution<float> dis(-1, 1);
+
+	// Counts that are not a multiple of 4 leave a tail for the per-particle path
+	for (uint32_t const num_pars : {1U, 3U, 4U, 7U, 13U})
+	{
+		std::vector<float> attribs(11 * num_pars);
+		ParticleBatch const batch = MakeParticleBatch(attribs, num_pars);
+
+		std::vector<Particle> expected(num_pars);
+		for (uint32_t i = 0; i < num_pars; ++ i)
+		{
+			Particle par;
+			par.pos = float3(dis(gen), dis(gen), dis(gen)) * 10.0f;
+			par.vel = float3(dis(gen), dis(gen), dis(gen));
+			par.init_life = 2 + dis(gen);
+			par.life = par.init_life * (0.5f + 0.5f * dis(gen));
+			par.spin = dis(gen);
+			par.size = dis(gen);
+			par.alpha = dis(gen);
+
+			batch.Set(i, par);
+			expected[i] = par;
+		}
+
+		float const elapsed_time = 0.1f;
+		updater.Update(batch, elapsed_time);
+		for (auto& par : expected)
+		{
+			updater.Update(par, elapsed_time);
+		}
+
+		float const tolerance = 1e-5f;
+		for (uint32_t i = 0; i < num_pars; ++ i)
+		{
+			Particle const par = batch.Get(i);
+			for (uint32_t j = 0; j < 3; ++ j)
+			{
+				EXPECT_NEAR(par.pos[j], expected[i].pos[j], tolerance);
+				EXPECT_NEAR(par.vel[j], expected[i].vel[j], tolerance);
+			}
+			EXPECT_FLOAT_EQ(par.life, expected[i].life);
+			EXPECT_FLOAT_EQ(par.spin, expected[i].spin);
+			EXPECT_NEAR(par.size, expected[i].size, tolerance);
+			EXPECT_NEAR(par.alpha, expected[i].alpha, tolerance);
+			EXPECT_FLOAT_EQ(par.init_life, expected[i].init_life);
+		}
+	}
+}
+
+TEST(ParticleSystemTest, EmitAndCompact)
+{
+	uint32_t const max_num_particles = 10;
+	auto ps = MakeTestParticleSystem(max_num_particles);
+
+	uint32_t const emit_counts[] = {7, 5};
+	for (uint32_t const count : emit_counts)
+	{
+		auto emitter = ps->MakeEmitter("point");
+		emitter->Frequency(static_cast<float>(count));
+		emitter->EmitAngle(PI / 3);
+		emitter->MinPosition(float3(-1, -1, -1));
+		emitter->MaxPosition(float3(1, 1, 1));
+		emitter->MinVelocity(0.5f);
+		emitter->MaxVelocity(1);
+		emitter->MinLife(1);
+		emitter->MaxLife(3);
+		emitter->MinSize(0.1f);
+		emitter->MaxSize(0.2f);
+		ps->AddEmitter(emitter);
+	}
+
+	auto live_particles = [&ps]
+	{
+		std::vector<Particle> ret;
+		for (uint32_t i = 0; i < ps->NumActiveParticles(); ++ i)
+		{
+			ret.push_back(ps->GetParticle(ps->GetActiveParticleIndex(i)));
+		}
+		return ret;
+	};
+
+	auto& root_node = *ps->RootNode();
+	float const elapsed_time = 1;
+	for (uint32_t frame = 0; frame < 8; ++ frame)
+	{
+		auto const prev_pars = live_particles();
+
+		root_node.SubThreadUpdate(0, elapsed_time);
+		root_node.MainThreadUpdate(0, elapsed_time);
+
+		// Survivors stay in order at the front, then each emitter appends its own count while there is room
+		std::vector<float> expected_lives;
+		for (auto const& par : prev_pars)
+		{
+			if (par.life - elapsed_time > 0)
+			{
+				expected_lives.push_back(par.life - elapsed_time);
+			}
+		}
+		uint32_t const num_survivors = static_cast<uint32_t>(expected_lives.size());
+		uint32_t num_particles = static_cast<uint32_t>(prev_pars.size());
+		uint32_t num_emitted = 0;
+		for (uint32_t const count : emit_counts)
+		{
+			uint32_t const num_new_particles = std::min(count, max_num_particles - num_particles);
+			num_particles += num_new_particles;
+			num_emitted += num_new_particles;
+		}
+
+		auto const pars = live_particles();
+		ASSERT_EQ(pars.size(), num_survivors + num_emitted);
+		for (uint32_t i = 0; i < num_survivors; ++ i)
+		{
+			EXPECT_FLOAT_EQ(pars[i].life, expected_lives[i]);
+		}
+		for (uint32_t i = num_survivors; i < pars.size(); ++ i)
+		{
+			EXPECT_FLOAT_EQ(pars[i].life, pars[i].init_life);
+			EXPECT_GE(pars[i].life, 1);
+			EXPECT_LE(pars[i].life, 3);
+		}
+	}
+}
@@ -0,0 +1,92 @@
+/**
+ * @file RadixSortTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KFL, a subproject of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/RadixSort.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "KlayGETests.hpp"
+
+using namespace std;
+using namespace KlayGE;
+
+TEST(RadixSortTest, FloatKeyOrder)
+{
+    float const values[] = {-1e10f, -2.5f, -1.0f, -0.0f, 0.0f, 1e-20f, 1.0f, 2.5f, 1e10f};
+    for (size_t i = 1; i < std::size(values); ++ i)
+    {
+        EXPECT_LE(RadixSortKey(values[i - 1]), RadixSortKey(values[i]));
+    }
+}
+
+TEST(RadixSortTest, MatchesStableSort)
+{
+    std::ranlux24_base gen;
+    std::uniform_int_distribution<uint32_t> dis(0, 1000);
+
+    std::vector<std::pair<uint32_t, uint32_t>> items(10000);
+    for (uint32_t i = 0; i < items.size(); ++ i)
+    {
+        items[i] = std::make_pair(dis(gen) << 12, i);
+    }
+
+    auto expected = items;
+    std::stable_sort(expected.begin(), expected.end(),
+        [](std::pair<uint32_t, uint32_t> const & lhs, std::pair<uint32_t, uint32_t> const & rhs)
+        {
+            return lhs.first < rhs.first;
+        });
+
+    std::vector<std::pair<uint32_t, uint32_t>> scratch;
+    RadixSort(items, scratch);
+    EXPECT_EQ(items, expected);
+}
+
+TEST(RadixSortTest, Key64)
+{
+    std::ranlux24_base gen;
+    std::uniform_real_distribution<float> dis(-100, 100);
+
+    std::vector<std::pair<uint64_t, uint32_t>> items(4096);
+    for (uint32_t i = 0; i < items.size(); ++ i)
+    {
+        items[i] = std::make_pair((static_cast<uint64_t>(RadixSortKey(dis(gen))) << 32) | (i & 0xF), i);
+    }
+
+    auto expected = items;
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<std::pair<uint64_t, uint32_t>> scratch;
+    RadixSort(items, scratch);
+    EXPECT_EQ(items, expected);
+}
@@ -0,0 +1,288 @@
+/**
+ * @file RenderEffectTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Hash.hpp>
+#include <KlayGE/RenderEffect.hpp>
+#include <KlayGE/ResLoader.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include "KlayGETests.hpp"
+
+using namespace std;
+using namespace KlayGE;
+
+#if KLAYGE_IS_DEV_PLATFORM
+namespace
+{
+	// Effects are built into a directory of their own, so each test starts without a kfx
+	class RenderEffectKfxCacheTest : public testing::Test
+	{
+	protected:
+		void SetUp() override
+		{
+			dir_ = std::filesystem::current_path() / "RenderEffectKfxCacheTest";
+			std::filesystem::remove_all(dir_);
+			std::filesystem::create_directories(dir_);
+			Context::Instance().ResLoaderInstance().AddPath(dir_.string());
+		}
+
+		void TearDown() override
+		{
+			Context::Instance().ResLoaderInstance().DelPath(dir_.string());
+			std::filesystem::remove_all(dir_);
+		}
+
+		void WriteEffect(std::string_view name, std::string_view param_name, std::string_view include_name = {})
+		{
+			auto const path = dir_ / name;
+			bool const existed = std::filesystem::exists(path);
+			auto const last_write_time = existed ? std::filesystem::last_write_time(path) : std::filesystem::file_time_type();
+
+			{
+				std::ofstream ofs(path);
+				ofs << "<?xml version='1.0'?>\n\n<effect>\n";
+				if (!include_name.empty())
+				{
+					ofs << "\t<include name=\"" << include_name << "\"/>\n";
+				}
+				ofs << "\t<parameter type=\"float\" name=\"" << param_name << "\"/>\n</effect>\n";
+			}
+
+			// Rewriting a file straight away could leave its timestamp where it was
+			if (existed)
+			{
+				std::filesystem::last_write_time(path, last_write_time + std::chrono::seconds(1));
+			}
+		}
+
+		void RemoveEffect(std::string_view name)
+		{
+			std::filesystem::remove(dir_ / name);
+		}
+
+		// Returns whether the kfx was used as it is
+		bool LoadEffect(std::span<std::string const> names, RenderEffect& effect)
+		{
+			uint32_t const hits = RenderEffect::NumKfxCacheHits();
+			uint32_t const misses = RenderEffect::NumKfxCacheMisses();
+
+			effect.Load(names);
+			effect.CompileShaders();
+
+			uint32_t const new_hits = RenderEffect::NumKfxCacheHits() - hits;
+			uint32_t const new_misses = RenderEffect::NumKfxCacheMisses() - misses;
+			EXPECT_EQ(new_hits + new_misses, 1U);
+			return new_hits > 0;
+		}
+
+	private:
+		std::filesystem::path dir_;
+	};
+}
+#endif
+
+TEST(RenderEffectTest, NameHashLookup)
+{
+	auto effect = SyncLoadRenderEffect("RenderToTexture/RenderToTextureTest.fxml");
+	ASSERT_TRUE(effect);
+
+	// Every name resolves to the first item with that name, through the string and the hash paths alike
+	for (uint32_t i = 0; i < effect->NumParameters(); ++i)
+	{
+		auto const& name = effect->ParameterByIndex(i)->Name();
+		auto* param = effect->ParameterByName(name);
+		ASSERT_NE(param, nullptr);
+		EXPECT_EQ(param->Name(), name);
+		EXPECT_EQ(effect->ParameterByNameHash(HashValue(name)), param);
+	}
+	for (uint32_t i = 0; i < effect->NumCBuffers(); ++i)
+	{
+		auto const& name = effect->CBufferByIndex(i)->Name();
+		auto* cbuffer = effect->CBufferByName(name);
+		ASSERT_NE(cbuffer, nullptr);
+		EXPECT_EQ(cbuffer->Name(), name);
+		EXPECT_EQ(effect->CBufferByNameHash(HashValue(name)), cbuffer);
+		EXPECT_EQ(effect->CBufferByIndex(effect->FindCBuffer(name)), cbuffer);
+	}
+	for (uint32_t i = 0; i < effect->NumTechniques(); ++i)
+	{
+		auto const& name = effect->TechniqueByIndex(i)->Name();
+		auto* tech = effect->TechniqueByName(name);
+		ASSERT_NE(tech, nullptr);
+		EXPECT_EQ(tech->Name(), name);
+		EXPECT_EQ(effect->TechniqueByNameHash(HashValue(name)), tech);
+	}
+
+	EXPECT_EQ(effect->ParameterByNameHash(CtHash("src_ms")), effect->ParameterByName("src_ms"));
+	EXPECT_NE(effect->ParameterByNameHash(CtHash("src_ms")), nullptr);
+	EXPECT_EQ(effect->TechniqueByNameHash(CtHash("RenderToTexture")), effect->TechniqueByName("RenderToTexture"));
+	EXPECT_NE(effect->TechniqueByNameHash(CtHash("RenderToTexture")), nullptr);
+
+	EXPECT_EQ(effect->ParameterByNameHash(CtHash("not_a_parameter")), nullptr);
+	EXPECT_EQ(effect->CBufferByNameHash(CtHash("not_a_cbuffer")), nullptr);
+	EXPECT_EQ(effect->FindCBuffer("not_a_cbuffer"), static_cast<uint32_t>(-1));
+	EXPECT_EQ(effect->TechniqueByNameHash(CtHash("NotATechnique")), nullptr);
+}
+
+TEST(RenderEffectTest, NameHashLookupOnClone)
+{
+	auto effect = SyncLoadRenderEffect("RenderToTexture/RenderToTextureTest.fxml");
+	ASSERT_TRUE(effect);
+	auto clone = effect->Clone();
+
+	// The clone has a copy of the index, and hands out its own parameters and cbuffers
+	ASSERT_EQ(clone->NumParameters(), effect->NumParameters());
+	for (uint32_t i = 0; i < clone->NumParameters(); ++i)
+	{
+		auto const& name = clone->ParameterByIndex(i)->Name();
+		auto* param = clone->ParameterByNameHash(HashValue(name));
+		ASSERT_NE(param, nullptr);
+		EXPECT_NE(param, effect->ParameterByNameHash(HashValue(name)));
+		EXPECT_EQ(param->Name(), name);
+	}
+	ASSERT_EQ(clone->NumCBuffers(), effect->NumCBuffers());
+	for (uint32_t i = 0; i < clone->NumCBuffers(); ++i)
+	{
+		auto const& name = clone->CBufferByIndex(i)->Name();
+		EXPECT_EQ(clone->CBufferByNameHash(HashValue(name)), clone->CBufferByName(name));
+	}
+	EXPECT_EQ(clone->TechniqueByNameHash(CtHash("RenderToTexture")), effect->TechniqueByNameHash(CtHash("RenderToTexture")));
+}
+
+TEST(RenderEffectTest, LookupOnUnloadedEffect)
+{
+	RenderEffect effect;
+
+	EXPECT_EQ(effect.ParameterByName("src_ms"), nullptr);
+	EXPECT_EQ(effect.ParameterByNameHash(CtHash("src_ms")), nullptr);
+	EXPECT_EQ(static_cast<RenderEffect const&>(effect).ParameterByName("src_ms"), nullptr);
+	EXPECT_EQ(effect.CBufferByName("global_cb"), nullptr);
+	EXPECT_EQ(effect.CBufferByNameHash(CtHash("global_cb")), nullptr);
+	EXPECT_EQ(effect.FindCBuffer("global_cb"), static_cast<uint32_t>(-1));
+	EXPECT_EQ(effect.TechniqueByName("RenderToTexture"), nullptr);
+	EXPECT_EQ(effect.TechniqueByNameHash(CtHash("RenderToTexture")), nullptr);
+}
+
+#if KLAYGE_IS_DEV_PLATFORM
+TEST_F(RenderEffectKfxCacheTest, HitAndMiss)
+{
+	this->WriteEffect("KfxCacheInclude.fxml", "include_value");
+	this->WriteEffect("KfxCache.fxml", "main_value", "KfxCacheInclude.fxml");
+	std::string const names[] = {"KfxCache.fxml"};
+
+	{
+		RenderEffect effect;
+		EXPECT_FALSE(this->LoadEffect(names, effect));
+		EXPECT_NE(effect.ParameterByName("main_value"), nullptr);
+		EXPECT_NE(effect.ParameterByName("include_value"), nullptr);
+	}
+	{
+		RenderEffect effect;
+		EXPECT_TRUE(this->LoadEffect(names, effect));
+		EXPECT_NE(effect.ParameterByName("main_value"), nullptr);
+		EXPECT_NE(effect.ParameterByName("include_value"), nullptr);
+	}
+}
+
+TEST_F(RenderEffectKfxCacheTest, StaleInclude)
+{
+	this->WriteEffect("KfxCacheInclude.fxml", "include_value");
+	this->WriteEffect("KfxCache.fxml", "main_value", "KfxCacheInclude.fxml");
+	std::string const names[] = {"KfxCache.fxml"};
+
+	{
+		RenderEffect effect;
+		EXPECT_FALSE(this->LoadEffect(names, effect));
+	}
+
+	// A newer include with the same content keeps the kfx
+	this->WriteEffect("KfxCacheInclude.fxml", "include_value");
+	{
+		RenderEffect effect;
+		EXPECT_TRUE(this->LoadEffect(names, effect));
+	}
+
+	this->WriteEffect("KfxCacheInclude.fxml", "changed_value");
+	{
+		RenderEffect effect;
+		EXPECT_FALSE(this->LoadEffect(names, effect));
+		EXPECT_NE(effect.ParameterByName("changed_value"), nullptr);
+		EXPECT_EQ(effect.ParameterByName("include_value"), nullptr);
+	}
+}
+
+TEST_F(RenderEffectKfxCacheTest, MissingDependency)
+{
+	this->WriteEffect("KfxCache.fxml", "main_value");
+	this->WriteEffect("KfxCacheFrag.fxml", "frag_value");
+	std::string const names[] = {"KfxCache.fxml", "KfxCacheFrag.fxml"};
+
+	{
+		RenderEffect effect;
+		EXPECT_FALSE(this->LoadEffect(names, effect));
+		EXPECT_NE(effect.ParameterByName("frag_value"), nullptr);
+	}
+
+	this->RemoveEffect("KfxCacheFrag.fxml");
+	{
+		RenderEffect effect;
+		EXPECT_FALSE(this->LoadEffect(names, effect));
+		EXPECT_NE(effect.ParameterByName("main_value"), nullptr);
+		EXPECT_EQ(effect.ParameterByName("frag_value"), nullptr);
+	}
+}
+
+TEST_F(RenderEffectKfxCacheTest, CloneOfReloadedEffect)
+{
+	this->WriteEffect("KfxCache.fxml", "old_value");
+	std::string const names[] = {"KfxCache.fxml"};
+
+	RenderEffect effect;
+	EXPECT_FALSE(this->LoadEffect(names, effect));
+	auto clone = effect.Clone();
+
+	this->WriteEffect("KfxCache.fxml", "new_value");
+	EXPECT_FALSE(this->LoadEffect(names, effect));
+	EXPECT_NE(effect.ParameterByName("new_value"), nullptr);
+	EXPECT_EQ(effect.ParameterByName("old_value"), nullptr);
+
+	// The clone still looks up the parameters it has
+	auto* param = clone->ParameterByName("old_value");
+	ASSERT_NE(param, nullptr);
+	EXPECT_EQ(param->Name(), "old_value");
+	EXPECT_EQ(clone->ParameterByName("new_value"), nullptr);
+}
+#endif
@@ -0,0 +1,175 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Math.hpp>
+#include <KFL/Timer.hpp>
+#include <KlayGE/Context.hpp>
+#include <KlayGE/RenderEffect.hpp>
+#include <KlayGE/RenderFactory.hpp>
+#include <KlayGE/RenderQueue.hpp>
+#include <KlayGE/Renderable.hpp>
+#include <KlayGE/SceneNode.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	class BenchmarkRenderable : public Renderable
+	{
+	public:
+		BenchmarkRenderable(RenderTechnique* tech, SceneNode const * node)
+		{
+			technique_ = tech;
+			pos_aabb_ = AABBox(float3(-1, -1, -1), float3(1, 1, 1));
+			this->AddInstance(node);
+		}
+	};
+
+	// What SceneManager did before RenderQueue: a linear search for the technique group of every draw,
+	// then a comparison sort of the groups and another one of the draws inside each group.
+	size_t LegacyQueue(std::vector<Renderable*> const & renderables, float4 const & view_mat_z)
+	{
+		std::vector<std::pair<RenderTechnique const *, std::vector<Renderable*>>> render_queue;
+		for (auto* renderable : renderables)
+		{
+			RenderTechnique const * tech = renderable->GetRenderTechnique();
+			auto iter = std::find_if(render_queue.begin(), render_queue.end(),
+				[tech](std::pair<RenderTechnique const *, std::vector<Renderable*>> const & items)
+				{
+					return items.first == tech;
+				});
+			if (iter != render_queue.end())
+			{
+				iter->second.push_back(renderable);
+			}
+			else
+			{
+				render_queue.emplace_back(tech, std::vector<Renderable*>(1, renderable));
+			}
+		}
+
+		std::sort(render_queue.begin(), render_queue.end(),
+			[](std::pair<RenderTechnique const *, std::vector<Renderable*>> const & lhs,
+				std::pair<RenderTechnique const *, std::vector<Renderable*>> const & rhs)
+			{
+				return lhs.first->Weight() < rhs.first->Weight();
+			});
+
+		size_t num_rendered = 0;
+		for (auto& items : render_queue)
+		{
+			std::vector<std::pair<float, Renderable*>> min_depths(items.second.size());
+			for (size_t j = 0; j < min_depths.size(); ++ j)
+			{
+				Renderable* renderable = items.second[j];
+				AABBox const & box = renderable->PosBound();
+				float4x4 const & mat = renderable->GetInstance(0)->TransformToWorld();
+				float4 const zvec(MathLib::dot(mat.Row(0), view_mat_z),
+					MathLib::dot(mat.Row(1), view_mat_z), MathLib::dot(mat.Row(2), view_mat_z),
+					MathLib::dot(mat.Row(3), view_mat_z));
+				float md = 1e10f;
+				for (int k = 0; k < 8; ++ k)
+				{
+					float3 const v = box.Corner(k);
+					md = std::min(md, v.x() * zvec.x() + v.y() * zvec.y() + v.z() * zvec.z() + zvec.w());
+				}
+				min_depths[j] = std::make_pair(md, renderable);
+			}
+			std::sort(min_depths.begin(), min_depths.end(),
+				[](std::pair<float, Renderable*> const & lhs, std::pair<float, Renderable*> const & rhs)
+				{
+					return lhs.first < rhs.first;
+				});
+			num_rendered += min_depths.size();
+		}
+		return num_rendered;
+	}
+
+	size_t KeyedQueue(RenderQueue& render_queue, std::vector<Renderable*> const & renderables, float4 const & view_mat_z)
+	{
+		for (auto* renderable : renderables)
+		{
+			render_queue.Add(renderable);
+		}
+		render_queue.Sort(view_mat_z);
+		size_t const num_rendered = render_queue.SortedRenderables().size();
+		render_queue.Clear();
+		return num_rendered;
+	}
+
+	void Benchmark(uint32_t num_renderables, uint32_t num_techs)
+	{
+		uint32_t const NUM_ITERATIONS = 10;
+
+		std::ranlux24_base gen;
+		std::uniform_real_distribution<float> pos_dis(-1000, 1000);
+		std::uniform_int_distribution<uint32_t> tech_dis(0, num_techs - 1);
+
+		std::vector<RenderTechnique> techs(num_techs);
+		std::vector<std::unique_ptr<SceneNode>> nodes;
+		std::vector<std::unique_ptr<BenchmarkRenderable>> owned_renderables;
+		std::vector<Renderable*> renderables;
+		for (uint32_t i = 0; i < num_renderables; ++ i)
+		{
+			auto& node = nodes.emplace_back(MakeUniquePtr<SceneNode>(0));
+			node->TransformToParent(MathLib::translation(pos_dis(gen), pos_dis(gen), pos_dis(gen)));
+			node->UpdateTransforms();
+
+			auto& renderable = owned_renderables.emplace_back(MakeUniquePtr<BenchmarkRenderable>(&techs[tech_dis(gen)], node.get()));
+			renderables.push_back(renderable.get());
+		}
+
+		float4 const view_mat_z = MathLib::look_at_lh(float3(0, 0, -2000), float3(0, 0, 0)).Col(2);
+
+		size_t num_rendered = 0;
+		Timer timer;
+		for (uint32_t i = 0; i < NUM_ITERATIONS; ++ i)
+		{
+			num_rendered += LegacyQueue(renderables, view_mat_z);
+		}
+		double const legacy_time = timer.elapsed() / NUM_ITERATIONS;
+
+		RenderQueue render_queue;
+		timer.restart();
+		for (uint32_t i = 0; i < NUM_ITERATIONS; ++ i)
+		{
+			num_rendered -= KeyedQueue(render_queue, renderables, view_mat_z);
+		}
+		double const keyed_time = timer.elapsed() / NUM_ITERATIONS;
+		BOOST_ASSERT(0 == num_rendered);
+
+		cout << std::setw(8) << num_renderables << " draws" << std::setw(8) << num_techs << " techniques"
+			<< std::fixed << std::setprecision(3)
+			<< std::setw(12) << legacy_time * 1000 << " ms (linear + std::sort)"
+			<< std::setw(12) << keyed_time * 1000 << " ms (keys + radix sort)" << endl;
+	}
+}
+
+int main()
+{
+	auto& context = Context::Instance();
+	context.LoadCfg("KlayGE.cfg");
+	ContextCfg context_cfg = context.Config();
+	context_cfg.render_factory_name = "NullRender";
+	context_cfg.graphics_cfg.hide_win = true;
+	context.Config(context_cfg);
+	context.RenderFactoryInstance();
+
+	for (uint32_t const num_techs : { 16U, 256U, 4096U })
+	{
+		for (uint32_t const num_renderables : { 1024U, 16384U, 65536U })
+		{
+			Benchmark(num_renderables, num_techs);
+		}
+	}
+
+	Context::Destroy();
+
+	return 0;
+}
@@ -1,10 +1,163 @@
 #include <KlayGE/KlayGE.hpp>
+#include <KFL/Hash.hpp>
 #include <KlayGE/ResLoader.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "KlayGETests.hpp"
 
 using namespace KlayGE;
 
+namespace
+{
+	class TestLoadingDesc : public ResLoadingDesc
+	{
+	public:
+		TestLoadingDesc(std::string_view name, std::atomic<uint32_t>& num_loads,
+			std::function<void(std::string const&)> on_sub_thread_stage = nullptr)
+			: name_(name), num_loads_(num_loads), on_sub_thread_stage_(std::move(on_sub_thread_stage))
+		{
+		}
+
+		uint64_t Type() const override
+		{
+			return CtHash("TestLoadingDesc");
+		}
+
+		bool StateLess() const override
+		{
+			return true;
+		}
+
+		std::shared_ptr<void> CreateResource() override
+		{
+			res_ = MakeSharedPtr<std::string>();
+			return res_;
+		}
+
+		void SubThreadStage() override
+		{
+			if (on_sub_thread_stage_)
+			{
+				on_sub_thread_stage_(name_);
+			}
+			*res_ = name_;
+			++num_loads_;
+		}
+
+		void MainThreadStage() override
+		{
+		}
+
+		bool HasSubThreadStage() const override
+		{
+			return true;
+		}
+
+		size_t Hash() const override
+		{
+			return HashValue(name_);
+		}
+
+		bool Match(ResLoadingDesc const& rhs) const override
+		{
+			if (this->Type() == rhs.Type())
+			{
+				return name_ == static_cast<TestLoadingDesc const&>(rhs).name_;
+			}
+			return false;
+		}
+
+		void CopyDataFrom(ResLoadingDesc const& rhs) override
+		{
+			res_ = static_cast<TestLoadingDesc const&>(rhs).res_;
+		}
+
+		std::shared_ptr<void> CloneResourceFrom(std::shared_ptr<void> const& resource) override
+		{
+			return resource;
+		}
+
+		std::shared_ptr<void> Resource() const override
+		{
+			return res_;
+		}
+
+	private:
+		std::string name_;
+		std::atomic<uint32_t>& num_loads_;
+		std::function<void(std::string const&)> on_sub_thread_stage_;
+		std::shared_ptr<std::string> res_;
+	};
+
+	// Hands out a null resource, like the descs that keep the default CreateResource()
+	class NullHandleLoadingDesc : public TestLoadingDesc
+	{
+	public:
+		using TestLoadingDesc::TestLoadingDesc;
+
+		std::shared_ptr<void> CreateResource() override
+		{
+			TestLoadingDesc::CreateResource();
+			return std::shared_ptr<void>();
+		}
+
+		std::shared_ptr<void> Resource() const override
+		{
+			return std::shared_ptr<void>();
+		}
+	};
+
+	// Runs the loading with a single thread that is held by a gate request until Open() is called, so requests queue up behind it
+	class LoadingGate
+	{
+	public:
+		LoadingGate()
+			: res_loader_(Context::Instance().ResLoaderInstance()), num_threads_(res_loader_.NumLoadingThreads())
+		{
+			res_loader_.NumLoadingThreads(1);
+			gate_ = res_loader_.ASyncQueryT<std::string>(
+				MakeSharedPtr<TestLoadingDesc>("LoadingGate", num_loads_,
+					[this](std::string const&)
+					{
+						while (!open_)
+						{
+							std::this_thread::yield();
+						}
+					}),
+				ResLoadingPriority::Immediate);
+		}
+
+		~LoadingGate()
+		{
+			this->Open();
+			res_loader_.NumLoadingThreads(num_threads_);
+		}
+
+		void Open()
+		{
+			open_ = true;
+			while (res_loader_.NumLoadingResources() > 0)
+			{
+				res_loader_.Update();
+				std::this_thread::yield();
+			}
+		}
+
+	private:
+		ResLoader& res_loader_;
+		uint32_t const num_threads_;
+		std::atomic<bool> open_{false};
+		std::atomic<uint32_t> num_loads_{0};
+		std::shared_ptr<std::string> gate_;
+	};
+}
+
 std::string const sanity_string = "This is a test for ResLoader.";
 
 std::string ReadWholeFile(ResIdentifierPtr const & res)
@@ -107,3 +260,133 @@ TEST(ResLoaderTest, MountUnmountInsideEncrypt7zPath)
 	res_loader.Unmount("ResLoaderTestData", "../../Tests/media/ResLoader/TestPassword.7z|1234/ResLoader");
 	EXPECT_TRUE(res_loader.Locate("ResLoaderTestData/Test.txt").empty());
 }
+
+TEST(ResLoaderTest, ASyncQueryDeduplication)
+{
+	auto& res_loader = Context::Instance().ResLoaderInstance();
+	res_loader.ResetStatistics();
+
+	std::atomic<uint32_t> num_loads{0};
+	auto res0 = res_loader.ASyncQueryT<std::string>(MakeSharedPtr<TestLoadingDesc>("Dedup", num_loads), ResLoadingPriority::High);
+	auto res1 = res_loader.ASyncQueryT<std::string>(MakeSharedPtr<TestLoadingDesc>("Dedup", num_loads));
+	EXPECT_EQ(res0, res1);
+
+	while (res_loader.NumLoadingResources() > 0)
+	{
+		res_loader.Update();
+		std::this_thread::yield();
+	}
+	EXPECT_EQ(num_loads, 1U);
+	EXPECT_EQ(*res0, "Dedup");
+
+	auto res2 = res_loader.SyncQueryT<std::string>(MakeSharedPtr<TestLoadingDesc>("Dedup", num_loads));
+	EXPECT_EQ(res0, res2);
+	EXPECT_EQ(num_loads, 1U);
+
+	auto const stats = res_loader.Statistics();
+	auto iter = std::find_if(
+		stats.begin(), stats.end(), [](ResLoadingStatistics const& stat) { return stat.type == CtHash("TestLoadingDesc"); });
+	ASSERT_TRUE(iter != stats.end());
+	EXPECT_EQ(iter->num_loaded, 1U);
+	EXPECT_EQ(iter->num_deduplicated, 2U);
+}
+
+TEST(ResLoaderTest, ASyncQueryPriority)
+{
+	auto& res_loader = Context::Instance().ResLoaderInstance();
+
+	std::mutex order_mutex;
+	std::vector<std::string> order;
+	auto record = [&order_mutex, &order](std::string const& name)
+	{
+		std::lock_guard<std::mutex> lock(order_mutex);
+		order.push_back(name);
+	};
+
+	std::atomic<uint32_t> num_loads{0};
+	{
+		LoadingGate gate;
+
+		res_loader.ASyncQuery(MakeSharedPtr<TestLoadingDesc>("PriorityLow0", num_loads, record), ResLoadingPriority::Low);
+		res_loader.ASyncQuery(MakeSharedPtr<TestLoadingDesc>("PriorityNormal", num_loads, record), ResLoadingPriority::Normal);
+		res_loader.ASyncQuery(MakeSharedPtr<TestLoadingDesc>("PriorityLow1", num_loads, record), ResLoadingPriority::Low);
+		res_loader.ASyncQuery(MakeSharedPtr<TestLoadingDesc>("PriorityHigh", num_loads, record), ResLoadingPriority::High);
+
+		// A later request with a higher priority boosts the pending one
+		res_loader.ASyncQuery(MakeSharedPtr<TestLoadingDesc>("PriorityBoosted", num_loads, record), ResLoadingPriority::Low);
+		res_loader.ASyncQuery(MakeSharedPtr<TestLoadingDesc>("PriorityBoosted", num_loads, record), ResLoadingPriority::Immediate);
+
+		gate.Open();
+	}
+
+	std::vector<std::string> const expected = {"PriorityBoosted", "PriorityHigh", "PriorityNormal", "PriorityLow0", "PriorityLow1"};
+	EXPECT_EQ(order, expected);
+	EXPECT_EQ(num_loads, 5U);
+}
+
+TEST(ResLoaderTest, Cancel)
+{
+	auto& res_loader = Context::Instance().ResLoaderInstance();
+	res_loader.ResetStatistics();
+
+	std::atomic<uint32_t> num_loads{0};
+	std::shared_ptr<std::string> alone;
+	std::shared_ptr<std::string> shared0;
+	std::shared_ptr<std::string> shared1;
+	std::shared_ptr<std::string> abandoned0;
+	std::shared_ptr<std::string> abandoned1;
+	{
+		LoadingGate gate;
+
+		alone = res_loader.ASyncQueryT<std::string>(MakeSharedPtr<TestLoadingDesc>("CancelAlone", num_loads));
+		EXPECT_TRUE(res_loader.Cancel(alone));
+		EXPECT_FALSE(res_loader.Cancel(alone));
+
+		// Cancelling one request of a shared load doesn't take it away from the other requester
+		shared0 = res_loader.ASyncQueryT<std::string>(MakeSharedPtr<TestLoadingDesc>("CancelShared", num_loads));
+		shared1 = res_loader.ASyncQueryT<std::string>(MakeSharedPtr<TestLoadingDesc>("CancelShared", num_loads));
+		EXPECT_EQ(shared0, shared1);
+		EXPECT_FALSE(res_loader.Cancel(shared0));
+
+		// Once every requester has cancelled, the load is stopped
+		abandoned0 = res_loader.ASyncQueryT<std::string>(MakeSharedPtr<TestLoadingDesc>("CancelAbandoned", num_loads));
+		abandoned1 = res_loader.ASyncQueryT<std::string>(MakeSharedPtr<TestLoadingDesc>("CancelAbandoned", num_loads));
+		EXPECT_FALSE(res_loader.Cancel(abandoned0));
+		EXPECT_TRUE(res_loader.Cancel(abandoned1));
+
+		gate.Open();
+	}
+
+	EXPECT_TRUE(alone->empty());
+	EXPECT_EQ(*shared1, "CancelShared");
+	EXPECT_TRUE(abandoned0->empty());
+	EXPECT_EQ(num_loads, 1U);
+
+	auto const stats = res_loader.Statistics();
+	auto iter = std::find_if(
+		stats.begin(), stats.end(), [](ResLoadingStatistics const& stat) { return stat.type == CtHash("TestLoadingDesc"); });
+	ASSERT_TRUE(iter != stats.end());
+	EXPECT_EQ(iter->num_cancelled, 2U);
+}
+
+TEST(ResLoaderTest, CancelNullHandle)
+{
+	auto& res_loader = Context::Instance().ResLoaderInstance();
+
+	std::atomic<uint32_t> num_loads{0};
+	{
+		LoadingGate gate;
+
+		auto const null0 = res_loader.ASyncQuery(MakeSharedPtr<NullHandleLoadingDesc>("CancelNullHandle0", num_loads));
+		auto const null1 = res_loader.ASyncQuery(MakeSharedPtr<NullHandleLoadingDesc>("CancelNullHandle1", num_loads));
+		EXPECT_FALSE(null0);
+		EXPECT_FALSE(null1);
+
+		// A null handle doesn't identify a load, so it can't cancel any of them
+		EXPECT_FALSE(res_loader.Cancel(null0));
+
+		gate.Open();
+	}
+
+	EXPECT_EQ(num_loads, 2U);
+}
@@ -0,0 +1,229 @@
+/**
+ * @file ResizeTextureTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Color.hpp>
+#include <KlayGE/ElementFormat.hpp>
+#include <KlayGE/Texture.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "KlayGETests.hpp"
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	TextureFilter const RESAMPLING_FILTERS[] = {TextureFilter::Box, TextureFilter::Linear, TextureFilter::Kaiser, TextureFilter::Lanczos};
+
+	std::vector<Color> RandomImage(uint32_t num_pixels, uint32_t seed)
+	{
+		std::ranlux24_base gen(seed);
+		std::uniform_real_distribution<float> dis(0, 1);
+
+		std::vector<Color> image(num_pixels);
+		for (auto& clr : image)
+		{
+			clr = Color(dis(gen), dis(gen), dis(gen), dis(gen));
+		}
+		return image;
+	}
+
+	float MaxDifference(std::vector<Color> const & lhs, std::vector<Color> const & rhs)
+	{
+		float diff = 0;
+		for (size_t i = 0; i < lhs.size(); ++ i)
+		{
+			for (uint32_t ch = 0; ch < 4; ++ ch)
+			{
+				diff = std::max(diff, std::abs(lhs[i][ch] - rhs[i][ch]));
+			}
+		}
+		return diff;
+	}
+
+	std::vector<Color> Resize(std::vector<Color> const & src, uint32_t src_width, uint32_t src_height, uint32_t src_depth,
+		uint32_t dst_width, uint32_t dst_height, uint32_t dst_depth, TextureFilter filter)
+	{
+		uint32_t const elem_size = sizeof(Color);
+		std::vector<Color> dst(dst_width * dst_height * dst_depth);
+		ResizeTexture(dst.data(), dst_width * elem_size, dst_width * dst_height * elem_size, EF_ABGR32F,
+			dst_width, dst_height, dst_depth,
+			src.data(), src_width * elem_size, src_width * src_height * elem_size, EF_ABGR32F,
+			src_width, src_height, src_depth,
+			filter);
+		return dst;
+	}
+}
+
+TEST(ResizeTextureTest, BoxAverages)
+{
+	uint32_t const WIDTH = 12;
+	uint32_t const HEIGHT = 9;
+
+	auto const src = RandomImage(WIDTH * HEIGHT, 1);
+	auto const dst = Resize(src, WIDTH, HEIGHT, 1, WIDTH / 3, HEIGHT / 3, 1, TextureFilter::Box);
+
+	std::vector<Color> expected(dst.size(), Color(0, 0, 0, 0));
+	for (uint32_t y = 0; y < HEIGHT; ++ y)
+	{
+		for (uint32_t x = 0; x < WIDTH; ++ x)
+		{
+			expected[y / 3 * (WIDTH / 3) + x / 3] += src[y * WIDTH + x] / 9.0f;
+		}
+	}
+	EXPECT_LT(MaxDifference(dst, expected), 1e-5f);
+}
+
+TEST(ResizeTextureTest, KeepsConstant)
+{
+	uint32_t const sizes[][6] = {
+		{37, 23, 1, 13, 7, 1},
+		{10, 9, 1, 25, 31, 1},
+		{300, 200, 1, 97, 151, 1},
+		{9, 7, 11, 4, 5, 3},
+		{4, 4, 3, 8, 8, 7},
+	};
+
+	for (auto const filter : RESAMPLING_FILTERS)
+	{
+		for (auto const & size : sizes)
+		{
+			std::vector<Color> const src(size[0] * size[1] * size[2], Color(0.25f, 0.5f, 0.75f, 1));
+			auto const dst = Resize(src, size[0], size[1], size[2], size[3], size[4], size[5], filter);
+			EXPECT_LT(MaxDifference(dst, std::vector<Color>(dst.size(), src[0])), 1e-5f);
+		}
+	}
+}
+
+TEST(ResizeTextureTest, KeepsRamp)
+{
+	// Symmetric normalized kernels reproduce a linear ramp, away from the clamped edges
+	uint32_t const SRC_WIDTH = 256;
+	uint32_t const DST_WIDTH = 64;
+	uint32_t const EDGE = 8;
+
+	std::vector<Color> src(SRC_WIDTH);
+	for (uint32_t x = 0; x < SRC_WIDTH; ++ x)
+	{
+		float const v = (x + 0.5f) / SRC_WIDTH;
+		src[x] = Color(v, 1 - v, v, 1);
+	}
+
+	for (auto const filter : RESAMPLING_FILTERS)
+	{
+		auto const dst = Resize(src, SRC_WIDTH, 1, 1, DST_WIDTH, 1, 1, filter);
+		for (uint32_t x = EDGE; x < DST_WIDTH - EDGE; ++ x)
+		{
+			float const v = (x + 0.5f) / DST_WIDTH;
+			EXPECT_NEAR(dst[x].r(), v, 1e-5f);
+			EXPECT_NEAR(dst[x].g(), 1 - v, 1e-5f);
+		}
+	}
+}
+
+TEST(ResizeTextureTest, SRGBInLinearSpace)
+{
+	// Half black and half white is linear 0.5, which is 188 in sRGB
+	uint32_t src[4 * 4];
+	for (uint32_t y = 0; y < 4; ++ y)
+	{
+		for (uint32_t x = 0; x < 4; ++ x)
+		{
+			src[y * 4 + x] = ((x + y) & 1) ? 0xFFFFFFFF : 0xFF000000;
+		}
+	}
+
+	uint32_t dst[2 * 2];
+	ResizeTexture(dst, 2 * 4, 2 * 2 * 4, EF_ABGR8_SRGB, 2, 2, 1, src, 4 * 4, 4 * 4 * 4, EF_ABGR8_SRGB, 4, 4, 1, TextureFilter::Box);
+	for (auto const clr : dst)
+	{
+		EXPECT_EQ(clr, 0xFFBCBCBCU);
+	}
+
+	std::fill(std::begin(dst), std::end(dst), 0);
+	void* const level_data[] = {src, dst};
+	uint32_t const level_row_pitches[] = {4 * 4, 2 * 4};
+	BuildMipChain(level_data, level_row_pitches, EF_ABGR8_SRGB, 4, 4, TextureFilter::Linear);
+	for (auto const clr : dst)
+	{
+		EXPECT_EQ(clr, 0xFFBCBCBCU);
+	}
+}
+
+TEST(ResizeTextureTest, MipChain)
+{
+	uint32_t const sizes[][2] = {{300, 517}, {256, 256}, {37, 5}, {1, 90}, {64, 1}};
+
+	for (auto const filter : RESAMPLING_FILTERS)
+	{
+		for (auto const & size : sizes)
+		{
+			uint32_t const width = size[0];
+			uint32_t const height = size[1];
+			uint32_t num_levels = 1;
+			while ((std::max(width, height) >> num_levels) > 0)
+			{
+				++ num_levels;
+			}
+
+			// The streamed chain has to match resizing level by level
+			std::vector<std::vector<Color>> chain(num_levels);
+			std::vector<std::vector<Color>> expected(num_levels);
+			std::vector<void*> level_data(num_levels);
+			std::vector<uint32_t> level_row_pitches(num_levels);
+			chain[0] = RandomImage(width * height, width + height);
+			expected[0] = chain[0];
+			for (uint32_t i = 0; i < num_levels; ++ i)
+			{
+				uint32_t const level_width = std::max(width >> i, 1U);
+				uint32_t const level_height = std::max(height >> i, 1U);
+				if (i > 0)
+				{
+					chain[i].resize(level_width * level_height);
+					expected[i] = Resize(expected[i - 1], std::max(width >> (i - 1), 1U), std::max(height >> (i - 1), 1U), 1,
+						level_width, level_height, 1, filter);
+				}
+				level_data[i] = chain[i].data();
+				level_row_pitches[i] = level_width * sizeof(Color);
+			}
+
+			BuildMipChain(level_data, level_row_pitches, EF_ABGR32F, width, height, filter);
+			for (uint32_t i = 1; i < num_levels; ++ i)
+			{
+				EXPECT_LT(MaxDifference(chain[i], expected[i]), 1e-5f);
+			}
+		}
+	}
+}
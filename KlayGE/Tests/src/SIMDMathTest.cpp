@@ -31,3 +31,188 @@ TEST(SIMDMathTest, NormalizeVector4)
 	v = SIMDMathLib::NormalizeVector4(v);
 	EXPECT_LT(MathLib::abs(SIMDMathLib::GetX(SIMDMathLib::LengthVector4(v)) - 1.0f), 1e-3f);
 }
+
+namespace
+{
+	// The same expectations hold on every SIMD backend, they are checked against the scalar MathLib results.
+	void ExpectNear(float4 const & expected, SIMDVectorF4 const & v, float tolerance = 1e-4f)
+	{
+		float4 actual;
+		SIMDMathLib::StoreVector4(actual, v);
+		for (size_t i = 0; i < 4; ++ i)
+		{
+			EXPECT_NEAR(expected[i], actual[i], tolerance) << "component " << i;
+		}
+	}
+
+	void ExpectNear(float4x4 const & expected, SIMDMatrixF4 const & m, float tolerance = 1e-4f)
+	{
+		for (size_t i = 0; i < 4; ++ i)
+		{
+			ExpectNear(expected.Row(i), m.Row(i), tolerance);
+		}
+	}
+
+	float4x4 const test_mat_a(
+		1.0f, 2.0f, 0.5f, 0.0f,
+		-1.0f, 0.5f, 3.0f, 0.0f,
+		0.25f, -2.0f, 1.0f, 0.0f,
+		4.0f, -3.0f, 2.0f, 1.0f);
+	float4x4 const test_mat_b(
+		0.5f, 0.0f, -1.0f, 0.25f,
+		2.0f, 1.5f, 0.0f, -0.5f,
+		-0.75f, 1.0f, 2.0f, 0.0f,
+		1.0f, 0.5f, -2.0f, 1.0f);
+}
+
+TEST(SIMDMathTest, VectorArithmetic)
+{
+	float4 const a(1.0f, -2.0f, 3.5f, 4.0f);
+	float4 const b(0.5f, 4.0f, -1.0f, 2.0f);
+	SIMDVectorF4 const va = SIMDMathLib::LoadVector4(a);
+	SIMDVectorF4 const vb = SIMDMathLib::LoadVector4(b);
+
+	ExpectNear(a + b, SIMDMathLib::Add(va, vb));
+	ExpectNear(a - b, SIMDMathLib::Substract(va, vb));
+	ExpectNear(a * b, SIMDMathLib::Multiply(va, vb));
+	ExpectNear(a / b, SIMDMathLib::Divide(va, vb));
+	ExpectNear(-a, SIMDMathLib::Negative(va));
+	ExpectNear(MathLib::maximize(a, b), SIMDMathLib::Maximize(va, vb));
+	ExpectNear(MathLib::minimize(a, b), SIMDMathLib::Minimize(va, vb));
+	ExpectNear(float4(1, 2, 3.5f, 4), SIMDMathLib::Abs(va));
+	ExpectNear(float4(1, -1, 1, 1), SIMDMathLib::Sgn(va));
+	ExpectNear(float4(0, 0, 0, 0), SIMDMathLib::Sgn(SIMDVectorF4::Zero()));
+	ExpectNear(float4(1, std::sqrt(2.0f), std::sqrt(3.5f), 2), SIMDMathLib::Sqrt(SIMDMathLib::Abs(va)));
+
+	SIMDVectorF4 v = SIMDMathLib::SetVector(1, 2, 3, 4);
+	v = SIMDMathLib::SetZ(v, 7);
+	EXPECT_EQ(SIMDMathLib::GetX(v), 1.0f);
+	EXPECT_EQ(SIMDMathLib::GetY(v), 2.0f);
+	EXPECT_EQ(SIMDMathLib::GetZ(v), 7.0f);
+	EXPECT_EQ(SIMDMathLib::GetW(v), 4.0f);
+	EXPECT_EQ(SIMDMathLib::GetByIndex(SIMDMathLib::SetByIndex(v, 9, 3), 3), 9.0f);
+}
+
+TEST(SIMDMathTest, LoadStore)
+{
+	float const src[] = { 0, 1, 2, 3, 4 };
+	ExpectNear(float4(1, 2, 3, 4), SIMDMathLib::LoadVector4(src + 1));
+	ExpectNear(float4(1, 2, 3, 0), SIMDMathLib::LoadVector3(src + 1));
+	ExpectNear(float4(1, 2, 0, 0), SIMDMathLib::LoadVector2(src + 1));
+	ExpectNear(float4(1, 0, 0, 0), SIMDMathLib::LoadVector1(src[1]));
+
+	SIMDVectorF4 const v = SIMDMathLib::SetVector(5, 6, 7, 8);
+	float3 f3(0, 0, 0);
+	SIMDMathLib::StoreVector3(f3, v);
+	EXPECT_EQ(f3, float3(5, 6, 7));
+	float2 f2(0, 0);
+	SIMDMathLib::StoreVector2(f2, v);
+	EXPECT_EQ(f2, float2(5, 6));
+}
+
+TEST(SIMDMathTest, DotCross)
+{
+	float4 const a(1.0f, -2.0f, 3.5f, 4.0f);
+	float4 const b(0.5f, 4.0f, -1.0f, 2.0f);
+	SIMDVectorF4 const va = SIMDMathLib::LoadVector4(a);
+	SIMDVectorF4 const vb = SIMDMathLib::LoadVector4(b);
+
+	float const dot2 = MathLib::dot(float2(a.x(), a.y()), float2(b.x(), b.y()));
+	float const dot3 = MathLib::dot(float3(a.x(), a.y(), a.z()), float3(b.x(), b.y(), b.z()));
+	float const dot4 = MathLib::dot(a, b);
+	ExpectNear(float4(dot2, dot2, dot2, dot2), SIMDMathLib::DotVector2(va, vb));
+	ExpectNear(float4(dot3, dot3, dot3, dot3), SIMDMathLib::DotVector3(va, vb));
+	ExpectNear(float4(dot4, dot4, dot4, dot4), SIMDMathLib::DotVector4(va, vb));
+
+	float3 const cross = MathLib::cross(float3(a.x(), a.y(), a.z()), float3(b.x(), b.y(), b.z()));
+	SIMDVectorF4 const vc = SIMDMathLib::CrossVector3(va, vb);
+	for (size_t i = 0; i < 3; ++ i)
+	{
+		EXPECT_NEAR(cross[i], SIMDMathLib::GetByIndex(vc, i), 1e-4f);
+	}
+}
+
+TEST(SIMDMathTest, TransformVector)
+{
+	float4 const v(1.5f, -0.5f, 2.0f, 1.0f);
+	SIMDMatrixF4 const mat(test_mat_a.data());
+
+	ExpectNear(MathLib::transform(v, test_mat_a), SIMDMathLib::TransformVector4(SIMDMathLib::LoadVector4(v), mat));
+
+	float3 const v3(v.x(), v.y(), v.z());
+	float3 const coord = MathLib::transform_coord(v3, test_mat_a);
+	SIMDVectorF4 const vcoord = SIMDMathLib::TransformCoordVector3(SIMDMathLib::LoadVector3(v3), mat);
+	float3 const normal = MathLib::transform_normal(v3, test_mat_a);
+	SIMDVectorF4 const vnormal = SIMDMathLib::TransformNormalVector3(SIMDMathLib::LoadVector3(v3), mat);
+	for (size_t i = 0; i < 3; ++ i)
+	{
+		// TransformCoordVector3 uses a reciprocal estimate on SSE
+		EXPECT_NEAR(coord[i], SIMDMathLib::GetByIndex(vcoord, i), 1e-2f);
+		EXPECT_NEAR(normal[i], SIMDMathLib::GetByIndex(vnormal, i), 1e-4f);
+	}
+}
+
+TEST(SIMDMathTest, MatrixOps)
+{
+	SIMDMatrixF4 const a(test_mat_a.data());
+	SIMDMatrixF4 const b(test_mat_b.data());
+
+	ExpectNear(test_mat_a * test_mat_b, SIMDMathLib::Multiply(a, b));
+	ExpectNear(test_mat_a + test_mat_b, SIMDMathLib::Add(a, b));
+	ExpectNear(test_mat_a * 2.0f, SIMDMathLib::Multiply(a, 2.0f));
+	ExpectNear(MathLib::transpose(test_mat_a), SIMDMathLib::Transpose(a));
+	ExpectNear(MathLib::inverse(test_mat_a), SIMDMathLib::Inverse(a), 1e-3f);
+	ExpectNear(test_mat_a, SIMDMathLib::Transpose(SIMDMathLib::Transpose(a)));
+}
+
+TEST(SIMDMathTest, MultiplyQuat)
+{
+	Quaternion const q1 = MathLib::normalize(Quaternion(0.1f, 0.2f, 0.3f, 0.9f));
+	Quaternion const q2 = MathLib::normalize(Quaternion(-0.4f, 0.5f, 0.1f, 0.7f));
+	SIMDVectorF4 const vq1 = SIMDMathLib::SetVector(q1.x(), q1.y(), q1.z(), q1.w());
+	SIMDVectorF4 const vq2 = SIMDMathLib::SetVector(q2.x(), q2.y(), q2.z(), q2.w());
+
+	Quaternion const q = MathLib::mul(q1, q2);
+	ExpectNear(float4(q.x(), q.y(), q.z(), q.w()), SIMDMathLib::MultiplyQuat(vq1, vq2));
+	ExpectNear(float4(-q1.x(), -q1.y(), -q1.z(), q1.w()), SIMDMathLib::Conjugate(vq1));
+}
+
+TEST(SIMDMathTest, BatchTransformVector4)
+{
+	SIMDMatrixF4 const mat(test_mat_a.data());
+
+	// An odd count covers both the paired and the tail paths
+	std::vector<float4> in(7);
+	for (size_t i = 0; i < in.size(); ++ i)
+	{
+		float const f = static_cast<float>(i);
+		in[i] = float4(f, 1 - f, 0.5f * f, 1);
+	}
+
+	std::vector<float4> out(in.size());
+	SIMDMathLib::TransformVector4(out, in, mat);
+	for (size_t i = 0; i < in.size(); ++ i)
+	{
+		ExpectNear(MathLib::transform(in[i], test_mat_a), SIMDMathLib::LoadVector4(out[i]));
+	}
+
+	std::vector<float4> in_place = in;
+	SIMDMathLib::TransformVector4(in_place, in_place, mat);
+	EXPECT_EQ(in_place, out);
+}
+
+TEST(SIMDMathTest, BatchMultiplyMatrix)
+{
+	SIMDMatrixF4 const rhs(test_mat_b.data());
+
+	std::vector<float4x4> lhs(3, test_mat_a);
+	lhs[1] = MathLib::transpose(test_mat_a);
+	lhs[2] = test_mat_b;
+
+	std::vector<float4x4> out(lhs.size());
+	SIMDMathLib::Multiply(out, lhs, rhs);
+	for (size_t i = 0; i < lhs.size(); ++ i)
+	{
+		ExpectNear(lhs[i] * test_mat_b, SIMDMatrixF4(out[i].data()));
+	}
+}
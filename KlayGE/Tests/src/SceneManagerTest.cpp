@@ -0,0 +1,107 @@
+/**
+ * @file SceneManagerTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Color.hpp>
+#include <KFL/Math.hpp>
+#include <KlayGE/App3D.hpp>
+#include <KlayGE/Camera.hpp>
+#include <KlayGE/Context.hpp>
+#include <KlayGE/Renderable.hpp>
+#include <KlayGE/RenderableHelper.hpp>
+#include <KlayGE/SceneManager.hpp>
+#include <KlayGE/SceneNode.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#include "KlayGETests.hpp"
+
+using namespace KlayGE;
+
+TEST(SceneManagerTest, ParallelCulling)
+{
+	auto& context = Context::Instance();
+	auto& scene_mgr = context.SceneManagerInstance();
+	auto& root_node = scene_mgr.SceneRootNode();
+
+	// A grid of static boxes that is large enough to fill the whole tree, and that the frustum cuts through
+	int const grid_size = 16;
+	std::vector<SceneNodePtr> nodes;
+	for (int z = 0; z < grid_size; ++ z)
+	{
+		for (int y = 0; y < grid_size; ++ y)
+		{
+			for (int x = 0; x < grid_size; ++ x)
+			{
+				float3 const center(x * 2.0f - grid_size, y * 2.0f - grid_size, z * 2.0f - grid_size);
+				AABBox const box(center - float3(0.5f, 0.5f, 0.5f), center + float3(0.5f, 0.5f, 0.5f));
+				auto renderable = MakeSharedPtr<RenderableLineBox>(MathLib::convert_to_obbox(box), Color(1, 1, 1, 1));
+				auto node = MakeSharedPtr<SceneNode>(MakeSharedPtr<RenderableComponent>(renderable), SceneNode::SOA_Cullable);
+				root_node.AddChild(node);
+				nodes.push_back(node);
+			}
+		}
+	}
+
+	auto& camera = context.AppInstance().ActiveCamera();
+	camera.BoundSceneNode()->TransformToWorld(MathLib::inverse(MathLib::look_at_lh(float3(-6, 4, -30), float3(4, -2, 0))));
+	camera.ProjParams(PI / 4, 1, 0.1f, 40);
+
+	auto cull = [&scene_mgr, &nodes](uint32_t parallel_culling_threshold)
+	{
+		scene_mgr.ParallelCullingThreshold(parallel_culling_threshold);
+		scene_mgr.Update();
+
+		std::vector<BoundOverlap> visible_marks;
+		for (auto const& node : nodes)
+		{
+			visible_marks.push_back(node->VisibleMark(0));
+		}
+		return visible_marks;
+	};
+
+	// The first update builds the tree
+	cull(~0U);
+
+	auto const serial_marks = cull(~0U);
+	auto const parallel_marks = cull(0);
+	EXPECT_EQ(parallel_marks, serial_marks);
+
+	auto const num_invisible = std::count(serial_marks.begin(), serial_marks.end(), BoundOverlap::No);
+	EXPECT_GT(num_invisible, 0);
+	EXPECT_LT(num_invisible, static_cast<ptrdiff_t>(serial_marks.size()));
+
+	scene_mgr.ParallelCullingThreshold(512);
+	for (auto const& node : nodes)
+	{
+		root_node.RemoveChild(node);
+	}
+}
@@ -0,0 +1,93 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Timer.hpp>
+#include <KlayGE/Context.hpp>
+#include <KlayGE/ResLoader.hpp>
+#include <KlayGE/TexCompressionBC.hpp>
+#include <KlayGE/Texture.hpp>
+
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	// Gathers the texture into 4x4 blocks laid out back to back
+	std::vector<uint8_t> GatherBlocks(std::string_view name, uint32_t& num_blocks)
+	{
+		TexturePtr tex = LoadSoftwareTexture(name);
+		uint32_t const width = tex->Width(0);
+		uint32_t const height = tex->Height(0);
+		uint32_t const pixel_size = NumFormatBytes(tex->Format());
+		BOOST_ASSERT(4 == pixel_size);
+		auto const & init_data = checked_cast<SoftwareTexture&>(*tex).SubresourceData();
+
+		uint32_t const num_block_cols = (width + 3) / 4;
+		num_blocks = num_block_cols * ((height + 3) / 4);
+
+		std::vector<uint8_t> blocks(num_blocks * 16 * pixel_size, 0);
+		uint8_t const * src = static_cast<uint8_t const *>(init_data[0].data);
+		for (uint32_t y = 0; y < height; ++ y)
+		{
+			for (uint32_t x = 0; x < width; ++ x)
+			{
+				uint32_t const block = (y / 4) * num_block_cols + (x / 4);
+				uint32_t const offset = ((y & 3) * 4 + (x & 3)) * pixel_size;
+				memcpy(&blocks[block * 16 * pixel_size + offset], &src[y * init_data[0].row_pitch + x * pixel_size], pixel_size);
+			}
+		}
+
+		return blocks;
+	}
+
+	void Benchmark(std::string_view codec_name, TexCompression& codec, ElementFormat fmt, std::string_view tex_name,
+		TexCompressionMethod method)
+	{
+		uint32_t num_blocks;
+		std::vector<uint8_t> const input = GatherBlocks(tex_name, num_blocks);
+		uint32_t const block_bytes = BlockBytes(fmt);
+		std::vector<uint8_t> output(num_blocks * block_bytes);
+
+		Timer timer;
+		for (uint32_t i = 0; i < num_blocks; ++ i)
+		{
+			codec.EncodeBlock(&output[i * block_bytes], &input[i * 64], method);
+		}
+		double const per_block_time = timer.elapsed();
+
+		timer.restart();
+		codec.EncodeBlocks(output.data(), input.data(), num_blocks, method);
+		double const batch_time = timer.elapsed();
+
+		static char const * method_names[] = { "Speed", "Balanced", "Quality" };
+		cout << std::left << std::setw(6) << codec_name << std::setw(28) << tex_name << std::setw(10) << method_names[method]
+			<< std::right << std::fixed << std::setprecision(0)
+			<< std::setw(14) << num_blocks / per_block_time << " blocks/s"
+			<< std::setw(14) << num_blocks / batch_time << " blocks/s (batched)" << endl;
+	}
+}
+
+int main()
+{
+	Context::Instance().ResLoaderInstance().AddPath("../../Tests/media/EncodeDecodeTex");
+
+	TexCompressionBC1 bc1;
+	TexCompressionBC3 bc3;
+	TexCompressionBC7 bc7;
+
+	for (auto const method : { TCM_Speed, TCM_Balanced, TCM_Quality })
+	{
+		Benchmark("BC1", bc1, EF_BC1, "Lenna.dds", method);
+		Benchmark("BC1", bc1, EF_BC1, "leaf_v3_green_tex.dds", method);
+		Benchmark("BC3", bc3, EF_BC3, "leaf_v3_green_tex.dds", method);
+	}
+	Benchmark("BC7", bc7, EF_BC7, "Lenna.dds", TCM_Speed);
+	Benchmark("BC7", bc7, EF_BC7, "leaf_v3_green_tex.dds", TCM_Speed);
+
+	Context::Destroy();
+
+	return 0;
+}
@@ -0,0 +1,91 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Thread.hpp>
+#include <KlayGE/Context.hpp>
+#include <KlayGE/GraphicsBuffer.hpp>
+#include <KlayGE/RenderFactory.hpp>
+#include <KlayGE/TransientBuffer.hpp>
+
+#include <algorithm>
+#include <future>
+#include <vector>
+
+#include "KlayGETests.hpp"
+
+using namespace KlayGE;
+
+TEST(TransientBufferTest, ConcurrentAlloc)
+{
+	uint32_t const NUM_THREADS = 4;
+	uint32_t const NUM_ALLOCS_PER_THREAD = 256;
+
+	// Small enough to grow while the threads are allocating
+	TransientBuffer tb(1024, TransientBuffer::BF_Vertex);
+
+	std::vector<std::vector<SubAlloc>> sub_allocs(NUM_THREADS);
+	auto alloc = [&tb, &sub_allocs](uint32_t thread)
+	{
+		for (uint32_t i = 0; i < NUM_ALLOCS_PER_THREAD; ++ i)
+		{
+			std::vector<uint8_t> data(16 + (i % 4) * 16, static_cast<uint8_t>(thread * NUM_ALLOCS_PER_THREAD + i));
+			sub_allocs[thread].push_back(tb.Alloc(static_cast<uint32_t>(data.size()), data.data()));
+		}
+	};
+
+	std::vector<std::future<void>> joiners;
+	auto& tp = Context::Instance().ThreadPoolInstance();
+	for (uint32_t thread = 1; thread < NUM_THREADS; ++ thread)
+	{
+		joiners.emplace_back(tp.QueueThread([&alloc, thread] { alloc(thread); }));
+	}
+	alloc(0);
+	for (auto& joiner : joiners)
+	{
+		joiner.wait();
+	}
+
+	tb.EnsureDataReady();
+
+	auto& rf = Context::Instance().RenderFactoryInstance();
+	GraphicsBuffer& buffer = *tb.GetBuffer();
+	auto buffer_cpu = rf.MakeVertexBuffer(BU_Static, EAH_CPU_Read, buffer.Size(), nullptr);
+	buffer.CopyToBuffer(*buffer_cpu);
+
+	std::vector<SubAlloc> all_sub_allocs;
+	{
+		GraphicsBuffer::Mapper mapper(*buffer_cpu, BA_Read_Only);
+		uint8_t const * p = mapper.Pointer<uint8_t>();
+		for (uint32_t thread = 0; thread < NUM_THREADS; ++ thread)
+		{
+			for (uint32_t i = 0; i < NUM_ALLOCS_PER_THREAD; ++ i)
+			{
+				SubAlloc const & sa = sub_allocs[thread][i];
+				EXPECT_EQ(sa.length_, 16 + (i % 4) * 16);
+				EXPECT_LE(sa.offset_ + sa.length_, buffer.Size());
+
+				uint8_t const expected = static_cast<uint8_t>(thread * NUM_ALLOCS_PER_THREAD + i);
+				EXPECT_TRUE(std::all_of(p + sa.offset_, p + sa.offset_ + sa.length_, [expected](uint8_t v) { return v == expected; }));
+
+				all_sub_allocs.push_back(sa);
+			}
+		}
+	}
+
+	// No frame is retired, so none of them can overlap
+	std::sort(all_sub_allocs.begin(), all_sub_allocs.end(),
+		[](SubAlloc const & lhs, SubAlloc const & rhs) { return lhs.offset_ < rhs.offset_; });
+	uint32_t total_size = 0;
+	for (size_t i = 0; i < all_sub_allocs.size(); ++ i)
+	{
+		if (i + 1 < all_sub_allocs.size())
+		{
+			EXPECT_LE(all_sub_allocs[i].offset_ + all_sub_allocs[i].length_, all_sub_allocs[i + 1].offset_);
+		}
+		total_size += all_sub_allocs[i].length_;
+	}
+
+	auto const stats = tb.GetStatistics();
+	EXPECT_EQ(stats.num_allocs, NUM_THREADS * NUM_ALLOCS_PER_THREAD);
+	EXPECT_GT(stats.num_grows, 0U);
+	EXPECT_GE(stats.high_water_mark, total_size);
+	EXPECT_LE(stats.high_water_mark, stats.capacity);
+}
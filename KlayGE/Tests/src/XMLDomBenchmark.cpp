@@ -0,0 +1,140 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/ResIdentifier.hpp>
+#include <KFL/Timer.hpp>
+#include <KFL/XMLDom.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	std::atomic<uint64_t> num_allocs(0);
+}
+
+void* operator new(size_t size)
+{
+	++num_allocs;
+	if (void* p = std::malloc(size ? size : 1))
+	{
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, size_t size) noexcept
+{
+	KFL_UNUSED(size);
+	std::free(p);
+}
+
+namespace
+{
+	// Looks like a big fxml: parameters, then techniques with passes and states
+	std::string GenerateXml(uint32_t num_params, uint32_t num_techs)
+	{
+		std::string xml = "<?xml version=\"1.0\"?>\n<effect>\n";
+		for (uint32_t i = 0; i < num_params; ++ i)
+		{
+			xml += "\t<parameter type=\"float4\" name=\"param_" + std::to_string(i) + "\" value=\"0 0 0 1\"/>\n";
+		}
+		for (uint32_t i = 0; i < num_techs; ++ i)
+		{
+			xml += "\t<technique name=\"tech_" + std::to_string(i) + "\">\n";
+			xml += "\t\t<pass name=\"p0\">\n";
+			xml += "\t\t\t<state name=\"cull_mode\" value=\"back\"/>\n";
+			xml += "\t\t\t<state name=\"depth_enable\" value=\"true\"/>\n";
+			xml += "\t\t\t<state name=\"vertex_shader\" value=\"VS_" + std::to_string(i) + "()\"/>\n";
+			xml += "\t\t\t<state name=\"pixel_shader\" value=\"PS_" + std::to_string(i) + "()\"/>\n";
+			xml += "\t\t</pass>\n";
+			xml += "\t</technique>\n";
+		}
+		xml += "\t<shader>\n\t\t<![CDATA[float4 VS() { return 0; }]]>\n\t</shader>\n";
+		xml += "</effect>\n";
+		return xml;
+	}
+
+	ResIdentifier MakeSource(std::string const & xml)
+	{
+		return ResIdentifier("benchmark.xml", 0, std::span(reinterpret_cast<uint8_t const *>(xml.data()), xml.size()), nullptr);
+	}
+
+	// Walks the children like an effect loader does, the first of a name, then its siblings of the same name
+	template <typename Node>
+	uint32_t CountByName(Node const & root)
+	{
+		uint32_t num = 0;
+		for (auto const * node = root.FirstNode("technique"); node; node = node->NextSibling("technique"))
+		{
+			++ num;
+		}
+		for (auto const * node = root.FirstNode("parameter"); node; node = node->NextSibling("parameter"))
+		{
+			++ num;
+		}
+		if (root.FirstNode("shader"))
+		{
+			++ num;
+		}
+		return num;
+	}
+
+	void Benchmark(uint32_t num_params, uint32_t num_techs)
+	{
+		uint32_t const NUM_ITERATIONS = 10;
+
+		std::string const xml = GenerateXml(num_params, num_techs);
+
+		uint32_t num_found = 0;
+
+		uint64_t allocs = num_allocs;
+		Timer timer;
+		for (uint32_t i = 0; i < NUM_ITERATIONS; ++ i)
+		{
+			ResIdentifier source = MakeSource(xml);
+			XMLNode const root = LoadXml(source);
+			num_found += CountByName(root);
+		}
+		double const node_time = timer.elapsed() / NUM_ITERATIONS;
+		uint64_t const node_allocs = (num_allocs - allocs) / NUM_ITERATIONS;
+
+		allocs = num_allocs;
+		timer.restart();
+		for (uint32_t i = 0; i < NUM_ITERATIONS; ++ i)
+		{
+			ResIdentifier source = MakeSource(xml);
+			XMLDocument const doc(source);
+			num_found -= CountByName(*doc.Root());
+		}
+		double const view_time = timer.elapsed() / NUM_ITERATIONS;
+		uint64_t const view_allocs = (num_allocs - allocs) / NUM_ITERATIONS;
+		BOOST_ASSERT(0 == num_found);
+		KFL_UNUSED(num_found);
+
+		cout << std::setw(8) << xml.size() / 1024 << " KB" << std::fixed << std::setprecision(3)
+			<< std::setw(10) << node_time * 1000 << " ms" << std::setw(10) << node_allocs << " allocs (XMLNode)"
+			<< std::setw(10) << view_time * 1000 << " ms" << std::setw(10) << view_allocs << " allocs (XMLDocument)" << endl;
+	}
+}
+
+int main()
+{
+	for (uint32_t const num_techs : { 16U, 256U, 4096U })
+	{
+		Benchmark(num_techs * 4, num_techs);
+	}
+
+	return 0;
+}
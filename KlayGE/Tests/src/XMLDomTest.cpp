@@ -0,0 +1,163 @@
+/**
+ * @file XMLDomTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/ResIdentifier.hpp>
+#include <KFL/XMLDom.hpp>
+
+#include <string>
+
+#include "KlayGETests.hpp"
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	std::string_view const TEST_XML = R"(<?xml version="1.0"?>
+<effect name="test">
+	<parameter type="float" name="a" value="1.5"/>
+	<technique name="t0">
+		<pass name="p0"/>
+	</technique>
+	<parameter type="int" name="b" value="-3"/>
+	<technique name="t1" weight="2"/>
+	<shader>code &amp; more</shader>
+</effect>
+)";
+
+	ResIdentifier MakeSource(std::string_view xml)
+	{
+		return ResIdentifier("test.xml", 0, std::span(reinterpret_cast<uint8_t const*>(xml.data()), xml.size()), nullptr);
+	}
+
+	void ExpectSameTree(XMLNode const& node, XMLNodeView const& view)
+	{
+		EXPECT_EQ(node.Name(), view.Name());
+		EXPECT_EQ(node.Type(), view.Type());
+		EXPECT_EQ(node.ValueString(), view.ValueString());
+
+		auto const* attr = node.FirstAttrib();
+		auto const* attr_view = view.FirstAttrib();
+		for (; attr && attr_view; attr = attr->NextAttrib(), attr_view = attr_view->NextAttrib())
+		{
+			EXPECT_EQ(attr->Name(), attr_view->Name());
+			EXPECT_EQ(attr->ValueString(), attr_view->ValueString());
+			EXPECT_EQ(attr_view->Parent(), &view);
+		}
+		EXPECT_TRUE(!attr && !attr_view);
+
+		auto const* child = node.FirstNode();
+		auto const* child_view = view.FirstNode();
+		for (; child && child_view; child = child->NextSibling(), child_view = child_view->NextSibling())
+		{
+			EXPECT_EQ(child_view->Parent(), &view);
+			ExpectSameTree(*child, *child_view);
+		}
+		EXPECT_TRUE(!child && !child_view);
+	}
+}
+
+TEST(XMLDomTest, SameAsXMLNode)
+{
+	ResIdentifier source = MakeSource(TEST_XML);
+	XMLNode const root = LoadXml(source);
+
+	ResIdentifier view_source = MakeSource(TEST_XML);
+	XMLDocument const doc(view_source);
+	ASSERT_TRUE(doc.Root() != nullptr);
+	EXPECT_EQ(doc.Root()->Parent(), nullptr);
+
+	ExpectSameTree(root, *doc.Root());
+}
+
+TEST(XMLDomTest, Lookup)
+{
+	ResIdentifier source = MakeSource(TEST_XML);
+	XMLDocument const doc(source);
+	XMLNodeView const& root = *doc.Root();
+
+	XMLNodeView const* param = root.FirstNode("parameter");
+	ASSERT_TRUE(param != nullptr);
+	EXPECT_EQ(param->AttribString("name", ""), "a");
+	EXPECT_EQ(param->AttribFloat("value", 0), 1.5f);
+
+	param = param->NextSibling("parameter");
+	ASSERT_TRUE(param != nullptr);
+	EXPECT_EQ(param->AttribInt("value", 0), -3);
+	EXPECT_EQ(param->NextSibling("parameter"), nullptr);
+	EXPECT_EQ(param, root.LastNode("parameter"));
+
+	XMLNodeView const* tech = root.LastNode("technique");
+	ASSERT_TRUE(tech != nullptr);
+	EXPECT_EQ(tech->AttribUInt("weight", 0), 2U);
+	EXPECT_EQ(tech->PrevSibling("technique"), root.FirstNode("technique"));
+	EXPECT_EQ(tech->PrevSibling("parameter"), param);
+	EXPECT_EQ(root.FirstNode("technique")->FirstNode("pass")->AttribString("name", ""), "p0");
+
+	EXPECT_EQ(root.FirstNode("shader")->ValueString(), "code & more");
+	EXPECT_EQ(root.FirstNode("missing"), nullptr);
+	EXPECT_EQ(root.Attrib("missing"), nullptr);
+	EXPECT_EQ(root.AttribInt("missing", 7), 7);
+}
+
+TEST(XMLDomTest, ManyChildren)
+{
+	uint32_t const NUM_NAMES = 100;
+	uint32_t const NUM_CHILDREN = 1000;
+
+	std::string xml = "<root>";
+	for (uint32_t i = 0; i < NUM_CHILDREN; ++ i)
+	{
+		xml += "<node" + std::to_string(i % NUM_NAMES) + " index=\"" + std::to_string(i) + "\"/>";
+	}
+	xml += "</root>";
+
+	ResIdentifier source = MakeSource(xml);
+	XMLDocument const doc(source);
+	XMLNodeView const& root = *doc.Root();
+
+	for (uint32_t i = 0; i < NUM_NAMES; ++ i)
+	{
+		std::string const name = "node" + std::to_string(i);
+
+		uint32_t expected_index = i;
+		XMLNodeView const* last = nullptr;
+		for (auto const* node = root.FirstNode(name); node; node = node->NextSibling(name))
+		{
+			EXPECT_EQ(node->AttribUInt("index", 0), expected_index);
+			expected_index += NUM_NAMES;
+			last = node;
+		}
+		EXPECT_EQ(expected_index, i + NUM_CHILDREN);
+		EXPECT_EQ(last, root.LastNode(name));
+	}
+}
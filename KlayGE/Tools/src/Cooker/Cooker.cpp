@@ -32,14 +32,23 @@
 #include <KFL/ErrorHandling.hpp>
 #include <KFL/Hash.hpp>
 #include <KFL/StringUtil.hpp>
+#include <KFL/Thread.hpp>
+#include <KFL/Timer.hpp>
 #include <KFL/Util.hpp>
+#include <KlayGE/Context.hpp>
 #include <KlayGE/JudaTexture.hpp>
 #include <KlayGE/RenderDeviceCaps.hpp>
 #include <KlayGE/ResLoader.hpp>
 
+#include <atomic>
+#include <iomanip>
 #include <iostream>
 #include <filesystem>
 #include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <type_traits>
 #include <vector>
 #include <regex>
 
@@ -146,10 +155,313 @@ MeshMetadata LoadMeshMetadata(std::string const & res_name, MeshMetadata const &
 	}
 }
 
+std::string_view TextureSlotName(RenderMaterial::TextureSlot slot)
+{
+	switch (slot)
+	{
+	case RenderMaterial::TS_Albedo:
+		return "albedo";
+	case RenderMaterial::TS_MetalnessGlossiness:
+		return "metalness & glossiness";
+	case RenderMaterial::TS_Emissive:
+		return "emissive";
+	case RenderMaterial::TS_Normal:
+		return "normal";
+	case RenderMaterial::TS_Height:
+		return "height";
+	case RenderMaterial::TS_Occlusion:
+		return "occlusion";
+
+	default:
+		KFL_UNREACHABLE("Invalid texture slot");
+	}
+}
+
+// Bump it when the output of the converters changes, so everything in the build databases is cooked again
+uint32_t const BUILD_DATABASE_VERSION = 1;
+
+// Remembers which source content every output was cooked from. It's a text file with one line per asset,
+// "key\tresource name\toutput name", where the key is a hash of everything the output depends on.
+class BuildDatabase final
+{
+public:
+	// Without load, every asset is cooked again and the database is rebuilt
+	BuildDatabase(std::filesystem::path path, bool load) : path_(std::move(path))
+	{
+		if (!load)
+		{
+			return;
+		}
+
+		std::ifstream ifs(path_);
+		std::string line;
+		if (!std::getline(ifs, line) || (line != this->Header()))
+		{
+			return;
+		}
+
+		while (std::getline(ifs, line))
+		{
+			std::vector<std::string_view> const tokens = StringUtil::Split(line, StringUtil::EqualTo('\t'));
+			if (tokens.size() == 3)
+			{
+				uint64_t const key = std::stoull(std::string(tokens[0]), nullptr, 16);
+				entries_.try_emplace(std::string(tokens[1]), key, std::string(tokens[2]));
+			}
+		}
+	}
+
+	bool UpToDate(std::string const& res_name, uint64_t key, std::string const& output_name) const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto const iter = entries_.find(res_name);
+		return (iter != entries_.end()) && (iter->second.first == key) && (iter->second.second == output_name) &&
+			std::filesystem::exists(output_name);
+	}
+
+	void Update(std::string const& res_name, uint64_t key, std::string const& output_name)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		entries_.insert_or_assign(res_name, std::make_pair(key, output_name));
+	}
+
+	void Save() const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		// Written to a temporary file first, an interrupted build shouldn't leave a broken database behind
+		std::filesystem::path tmp_path = path_;
+		tmp_path += ".tmp";
+		{
+			std::ofstream ofs(tmp_path);
+			ofs << this->Header() << '\n';
+			for (auto const& entry : entries_)
+			{
+				ofs << std::hex << entry.second.first << std::dec << '\t' << entry.first << '\t' << entry.second.second << '\n';
+			}
+		}
+		std::filesystem::rename(tmp_path, path_);
+	}
+
+private:
+	static std::string Header()
+	{
+		return "KlayGE Cooker build database " + std::to_string(BUILD_DATABASE_VERSION);
+	}
+
+private:
+	std::filesystem::path path_;
+	std::map<std::string, std::pair<uint64_t, std::string>> entries_;
+	mutable std::mutex mutex_;
+};
+
+// Time spent in each stage, summed over all threads
+struct CookStatistics
+{
+	std::atomic<uint32_t> num_cache_hits{0};
+	std::atomic<uint32_t> num_cooked{0};
+	std::atomic<uint32_t> num_failed{0};
+
+	std::atomic<uint64_t> scan_us{0};
+	std::atomic<uint64_t> convert_us{0};
+	std::atomic<uint64_t> save_us{0};
+};
+
+void AddTime(std::atomic<uint64_t>& total_us, Timer const& timer)
+{
+	total_us += static_cast<uint64_t>(timer.elapsed() * 1e6);
+}
+
+std::mutex cout_mutex;
+
+// Messages from different threads mustn't interleave
+template <typename... Args>
+void CookLog(Args const&... args)
+{
+	std::lock_guard<std::mutex> lock(cout_mutex);
+	(std::cout << ... << args) << std::endl;
+}
+
+// Calls func(worker_index, i) for every i in [0, num), on up to num_workers threads. Assets take very different times to cook, so
+// each worker pulls the next item when it is done instead of getting a fixed range.
+template <typename Func>
+void ForEachItem(size_t num, uint32_t num_workers, Func const& func)
+{
+	num_workers = static_cast<uint32_t>(std::min<size_t>(num_workers, num));
+
+	std::atomic<size_t> next(0);
+	ParallelFor(Context::Instance().ThreadPoolInstance(), num_workers, 1,
+		[num, &next, &func](uint32_t worker_begin, uint32_t worker_end)
+		{
+			for (uint32_t worker_index = worker_begin; worker_index < worker_end; ++ worker_index)
+			{
+				for (size_t i = next++; i < num; i = next++)
+				{
+					func(worker_index, i);
+				}
+			}
+		},
+		num_workers);
+}
+
+void HashResource(size_t& seed, std::string_view res_name)
+{
+	HashCombine(seed, HashValue(res_name));
+
+	ResIdentifierPtr const res = Context::Instance().ResLoaderInstance().Open(res_name);
+	if (res)
+	{
+		res->seekg(0, std::ios_base::end);
+		std::vector<uint8_t> buff(static_cast<size_t>(res->tellg()));
+		res->seekg(0, std::ios_base::beg);
+		res->read(buff.data(), buff.size());
+		HashRange(seed, buff.begin(), buff.end());
+	}
+}
+
+// The key covers the source files, the metadata, the target platform and the resource type
+template <typename Metadata>
+uint64_t CookKey(std::string const& res_name, Metadata const& metadata, std::string_view res_type, std::string_view platform)
+{
+	size_t seed = 0;
+	HashCombine(seed, BUILD_DATABASE_VERSION);
+	HashCombine(seed, HashValue(res_type));
+	HashCombine(seed, HashValue(platform));
+	HashResource(seed, std::string(platform) + ".plat");
+	HashResource(seed, res_name);
+	HashResource(seed, res_name + ".kmeta");
+
+	if constexpr (std::is_same_v<Metadata, TexMetadata>)
+	{
+		for (uint32_t array_index = 0; array_index < metadata.ArraySize(); ++ array_index)
+		{
+			for (uint32_t mip = 0; !metadata.PlaneFileName(array_index, mip).empty(); ++ mip)
+			{
+				HashResource(seed, metadata.PlaneFileName(array_index, mip));
+			}
+		}
+	}
+	else
+	{
+		for (uint32_t lod = 0; lod < metadata.NumLods(); ++ lod)
+		{
+			HashResource(seed, metadata.LodFileName(lod));
+		}
+		for (uint32_t mtl_index = 0; mtl_index < metadata.NumMaterials(); ++ mtl_index)
+		{
+			HashResource(seed, metadata.MaterialFileName(mtl_index));
+		}
+	}
+
+	return seed;
+}
+
+template <typename Metadata>
+struct CookItem
+{
+	std::string res_name;
+	std::string output_name;
+	Metadata metadata;
+	uint64_t key;
+};
+
+// Assets are cooked in three stages. Scanning loads the metadata and hashes the sources in parallel, and drops the assets
+// the build database says are up to date. Then the input folders are added to the resource paths, since the converters
+// would add and remove them per asset otherwise. At last the remaining assets are converted and saved in parallel.
+template <typename Converter, typename Metadata, typename LoadMetadataFunc, typename CookFunc>
+void CookAssets(std::vector<std::string> const& res_names, std::string_view res_type, std::string_view platform,
+	std::string_view dest_folder, std::string_view output_ext, uint32_t num_jobs, BuildDatabase& build_db, CookStatistics& stats,
+	LoadMetadataFunc const& load_metadata, CookFunc const& cook)
+{
+	std::vector<CookItem<Metadata>> items(res_names.size());
+	std::vector<char> up_to_date(res_names.size(), false);
+	ForEachItem(res_names.size(), num_jobs, [&](uint32_t worker_index, size_t i)
+		{
+			KFL_UNUSED(worker_index);
+
+			Timer timer;
+
+			auto& item = items[i];
+			item.res_name = res_names[i];
+			item.metadata = load_metadata(item.res_name);
+
+			std::filesystem::path res_path(item.res_name);
+			if (!dest_folder.empty())
+			{
+				res_path = std::filesystem::path(dest_folder) / res_path.filename();
+			}
+			item.output_name = res_path.string() + std::string(output_ext);
+
+			item.key = CookKey(item.res_name, item.metadata, res_type, platform);
+			up_to_date[i] = build_db.UpToDate(item.res_name, item.key, item.output_name);
+
+			AddTime(stats.scan_us, timer);
+		});
+
+	std::vector<CookItem<Metadata>> dirty_items;
+	for (size_t i = 0; i < items.size(); ++ i)
+	{
+		if (up_to_date[i])
+		{
+			++ stats.num_cache_hits;
+		}
+		else
+		{
+			dirty_items.push_back(std::move(items[i]));
+		}
+	}
+	if (dirty_items.empty())
+	{
+		return;
+	}
+
+	auto& res_loader = Context::Instance().ResLoaderInstance();
+	std::vector<std::string> added_folders;
+	for (auto const& item : dirty_items)
+	{
+		std::string const in_folder = std::filesystem::path(res_loader.Locate(item.res_name)).parent_path().string();
+		if (!in_folder.empty() && !res_loader.IsInPath(in_folder))
+		{
+			res_loader.AddPath(in_folder);
+			added_folders.push_back(in_folder);
+		}
+	}
+	auto on_cooked = nonstd::make_scope_exit([&res_loader, &added_folders] {
+		for (auto const& folder : added_folders)
+		{
+			res_loader.DelPath(folder);
+		}
+	});
+
+	std::vector<Converter> converters(std::min<size_t>(num_jobs, dirty_items.size()));
+	ForEachItem(dirty_items.size(), num_jobs, [&](uint32_t worker_index, size_t i)
+		{
+			auto const& item = dirty_items[i];
+			try
+			{
+				if (cook(converters[worker_index], item, stats))
+				{
+					build_db.Update(item.res_name, item.key, item.output_name);
+					++ stats.num_cooked;
+				}
+				else
+				{
+					CookLog("Error: Failed to cook ", item.res_name, '.');
+					++ stats.num_failed;
+				}
+			}
+			catch (std::exception const& e)
+			{
+				CookLog("Error: Failed to cook ", item.res_name, ": ", e.what());
+				++ stats.num_failed;
+			}
+		});
+}
+
 void Cook(std::vector<std::string> const& res_names, std::string_view res_type, RenderDeviceCaps const& caps, std::string_view platform,
-	std::string_view dest_folder)
+	std::string_view dest_folder, uint32_t num_jobs, BuildDatabase& build_db, CookStatistics& stats)
 {
-	size_t const res_type_hash = HashValue(std::move(res_type));
+	size_t const res_type_hash = HashValue(res_type);
 
 	if ((CtHash("albedo") == res_type_hash)
 		|| (CtHash("emissive") == res_type_hash)
@@ -161,71 +473,55 @@ void Cook(std::vector<std::string> const& res_names, std::string_view res_type,
 	{
 		TexMetadata const default_metadata = DefaultTextureMetadata(res_type_hash, caps);
 
-		TexConverter tc;
-		for (size_t i = 0; i < res_names.size(); ++ i)
-		{
-			std::string_view real_res_type;
-			auto metadata = LoadTextureMetadata(res_names[i], default_metadata);
-			switch (metadata.Slot())
+		CookAssets<TexConverter, TexMetadata>(res_names, res_type, platform, dest_folder, ".dds", num_jobs, build_db, stats,
+			[&default_metadata](std::string const& res_name)
 			{
-			case RenderMaterial::TS_Albedo:
-				real_res_type = "albedo";
-				break;
-			case RenderMaterial::TS_MetalnessGlossiness:
-				real_res_type = "metalness & glossiness";
-				break;
-			case RenderMaterial::TS_Emissive:
-				real_res_type = "emissive";
-				break;
-			case RenderMaterial::TS_Normal:
-				real_res_type = "normal";
-				break;
-			case RenderMaterial::TS_Height:
-				real_res_type = "height";
-				break;
-			case RenderMaterial::TS_Occlusion:
-				real_res_type = "occlusion";
-				break;
-
-			default:
-				KFL_UNREACHABLE("Invalid texture slot");
-			}
-
-			std::cout << "Cooking " << res_names[i] << " to " << real_res_type << std::endl;
-
-			auto output_tex = tc.Load(metadata);
-			if (output_tex)
+				return LoadTextureMetadata(res_name, default_metadata);
+			},
+			[](TexConverter& tc, CookItem<TexMetadata> const& item, CookStatistics& stats)
 			{
-				std::filesystem::path res_path(res_names[i]);
-				if (!dest_folder.empty())
+				CookLog("Cooking ", item.res_name, " to ", TextureSlotName(item.metadata.Slot()));
+
+				Timer timer;
+				auto output_tex = tc.Load(item.metadata);
+				AddTime(stats.convert_us, timer);
+				if (!output_tex)
 				{
-					res_path = std::filesystem::path(dest_folder) / res_path.filename();
+					return false;
 				}
-				SaveTexture(output_tex, res_path.string() + ".dds");
-			}
-		}
+
+				timer.restart();
+				SaveTexture(output_tex, item.output_name);
+				AddTime(stats.save_us, timer);
+				return true;
+			});
 	}
 	else if (CtHash("model") == res_type_hash)
 	{
 		MeshMetadata const default_metadata;
 
-		MeshConverter mc;
-		for (size_t i = 0; i < res_names.size(); ++ i)
-		{
-			std::cout << "Cooking " << res_names[i] << " to " << res_type << std::endl;
-
-			auto metadata = LoadMeshMetadata(res_names[i], default_metadata);
-			auto output_model = mc.Load(metadata);
-			if (output_model)
+		CookAssets<MeshConverter, MeshMetadata>(res_names, res_type, platform, dest_folder, ".model_bin", num_jobs, build_db, stats,
+			[&default_metadata](std::string const& res_name)
 			{
-				std::filesystem::path res_path(res_names[i]);
-				if (!dest_folder.empty())
+				return LoadMeshMetadata(res_name, default_metadata);
+			},
+			[res_type](MeshConverter& mc, CookItem<MeshMetadata> const& item, CookStatistics& stats)
+			{
+				CookLog("Cooking ", item.res_name, " to ", res_type);
+
+				Timer timer;
+				auto output_model = mc.Load(item.metadata);
+				AddTime(stats.convert_us, timer);
+				if (!output_model)
 				{
-					res_path = std::filesystem::path(dest_folder) / res_path.filename();
+					return false;
 				}
-				SaveModel(*output_model, res_path.string() + ".model_bin");
-			}
-		}
+
+				timer.restart();
+				SaveModel(*output_model, item.output_name);
+				AddTime(stats.save_us, timer);
+				return true;
+			});
 	}
 	else
 	{
@@ -309,6 +605,7 @@ int main(int argc, char* argv[])
 	std::string res_type;
 	std::string platform;
 	std::string dest_folder;
+	uint32_t num_jobs = 0;
 
 	cxxopts::Options options("Cooker", "KlayGE Cooker");
 	// clang-format off
@@ -318,6 +615,8 @@ int main(int argc, char* argv[])
 		("T,type", "Resource type (auto by default).", cxxopts::value<std::string>())
 		("P,platform", "Platform name.", cxxopts::value<std::string>())
 		("D,dest-folder", "Destination folder.", cxxopts::value<std::string>())
+		("j,jobs", "Number of assets cooked at the same time, 0 for one per hardware thread.", cxxopts::value<uint32_t>())
+		("f,force", "Cook all assets, even if the build database says they are up to date.")
 		("v,version", "Version.");
 	// clang-format on
 
@@ -338,6 +637,14 @@ int main(int argc, char* argv[])
 	{
 		dest_folder = vm["dest-folder"].as<std::string>();
 	}
+	if (vm.count("jobs") > 0)
+	{
+		num_jobs = vm["jobs"].as<uint32_t>();
+	}
+	if (num_jobs == 0)
+	{
+		num_jobs = std::max(std::thread::hardware_concurrency(), 1U);
+	}
 	if (vm.count("input-path") > 0)
 	{
 		std::string input_name_str = vm["input-path"].as<std::string>();
@@ -513,7 +820,19 @@ int main(int argc, char* argv[])
 	}
 
 	PlatformDefinition platform_def(platform + ".plat");
-	Cook(res_names, res_type, platform_def.device_caps, platform, dest_folder);
 
-	return 0;
+	// One database per destination folder. Entries of other platforms or resource types don't match the keys, they're cooked again.
+	BuildDatabase build_db(std::filesystem::path(dest_folder.empty() ? "." : dest_folder) / "Cooker.kbdb", vm.count("force") == 0);
+	CookStatistics stats;
+
+	Timer timer;
+	Cook(res_names, res_type, platform_def.device_caps, platform, dest_folder, num_jobs, build_db, stats);
+	build_db.Save();
+
+	cout << res_names.size() << " assets: " << stats.num_cooked << " cooked, " << stats.num_cache_hits << " up to date, "
+		 << stats.num_failed << " failed." << endl;
+	cout << std::fixed << std::setprecision(3) << "Scan " << stats.scan_us / 1e6 << " s, convert " << stats.convert_us / 1e6
+		 << " s, save " << stats.save_us / 1e6 << " s (summed over threads), total " << timer.elapsed() << " s." << endl;
+
+	return (stats.num_failed > 0) ? 1 : 0;
 }
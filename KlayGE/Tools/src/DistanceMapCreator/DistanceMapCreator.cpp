@@ -8,6 +8,7 @@
 #include <KlayGE/RenderFactory.hpp>
 #include <KlayGE/Context.hpp>
 #include <KlayGE/RenderSettings.hpp>
+#include <KlayGE/DistanceField.hpp>
 
 #include <cmath>
 #include <iostream>
@@ -23,199 +24,6 @@
 using namespace std;
 using namespace KlayGE;
 
-// A type to hold the distance map while it's being constructed
-template <typename DistanceType>
-class DistanceMap
-{
-public:
-	DistanceMap(int width, int height, int depth)
-		: data_(width * height * depth * 3),
-			width_(width), height_(height), depth_(depth)
-	{
-	}
-
-	DistanceType& operator()(int x, int y, int z, int i)
-	{
-		return data_[((z * height_ + y) * width_ + x) * 3 + i];
-	}
-
-	DistanceType const & operator()(int x, int y, int z, int i) const
-	{
-		return data_[((z * height_ + y) * width_ + x) * 3 + i];
-	}
-
-	bool inside(int x, int y, int z) const
-	{
-		return (0 <= x) && (x < width_)
-			&& (0 <= y) && (y < height_)
-			&& (0 <= z) && (z < depth_);
-	}
-
-	// Do a single pass over the data.
-	// Start at (x,y,z) and walk in the direction (cx,cy,cz)
-	// Combine each pixel (x,y,z) with the value at (x+dx,y+dy,z+dz)
-	void combine(int dx, int dy, int dz,
-		int cx, int cy, int cz,
-		int x, int y, int z)
-	{
-		while (inside(x, y, z) && inside(x + dx, y + dy, z + dz))
-		{
-			int d[3] =
-			{
-				abs(dx),
-				abs(dy),
-				abs(dz)
-			};
-
-			uint32_t v1[3], v2[3];
-			for (int i = 0; i < 3; ++ i)
-			{
-				v1[i] = operator()(x, y, z, i);
-				v2[i] = operator()(x + dx, y + dy, z + dz, i) + d[i];
-			}
-
-			if (v1[0] * v1[0] + v1[1] * v1[1] + v1[2] * v1[2] > v2[0] * v2[0] + v2[1] * v2[1] + v2[2] * v2[2])
-			{
-				for (int i = 0; i < 3; ++ i)
-				{
-					operator()(x, y, z, i) = static_cast<DistanceType>(v2[i]);
-				}
-			}
-
-			x += cx;
-			y += cy;
-			z += cz;
-		}
-	}
-
-private:
-	std::vector<DistanceType> data_;
-	int width_, height_, depth_;
-};
-
-void ComputeDistanceField(std::vector<uint8_t>& distances, int width, int height, int depth,
-						std::vector<uint8_t> const & volume)
-{
-	// and +infinity above
-	DistanceMap<uint16_t> dmap(width, height, depth);
-	for (int z = 0; z < depth; ++ z)
-	{
-		for (int y = 0; y < height; ++ y)
-		{
-			for (int x = 0; x < width; ++ x)
-			{
-				for (int i = 0; i < 3; ++ i)
-				{
-					if (volume[(z * height + y) * width + x] != 0)
-					{
-						dmap(x, y, z, i) = 0;
-					}
-					else
-					{
-						dmap(x, y, z, i) = std::numeric_limits<uint16_t>::max();
-					}
-				}
-			}
-		}
-	}
-
-
-	// Compute the rest of dmap by sequential sweeps over the data
-	// using a 3d variant of Danielsson's algorithm
-
-	for (int z = 1; z < depth; ++ z)
-	{
-		// combine with everything with dz = -1
-		for (int y = 0; y < height; ++ y)
-		{
-			dmap.combine(0, 0, -1,
-				1, 0, 0,
-				0, y, z);
-		}
-
-		for (int y = 1; y < height; ++ y)
-		{
-			dmap.combine(0, -1, 0,
-				1, 0, 0,
-				0, y, z);
-			dmap.combine(-1, 0, 0,
-				1, 0, 0,
-				1, y, z);
-			dmap.combine(+1, 0, 0,
-				-1, 0, 0,
-				width - 2, y, z);
-		}
-
-		for (int y = height - 1; y >= 0; -- y)
-		{
-			dmap.combine(0, +1, 0,
-				1, 0, 0,
-				0, y, z);
-			dmap.combine(-1, 0, 0,
-				1, 0, 0,
-				1, y, z);
-			dmap.combine(+1, 0, 0,
-				-1, 0, 0,
-				width - 1, y, z);
-		}
-	}
-
-	for (int z = depth - 1; z >= 0; -- z)
-	{
-		cout << ".";
-
-		// combine with everything with dz = +1
-		for (int y = 0; y < height; ++ y)
-		{
-			dmap.combine(0, 0, +1,
-				1, 0, 0,
-				0, y, z);
-		}
-
-		for (int y = 1; y < height; ++ y)
-		{
-			dmap.combine(0, -1, 0,
-				1, 0, 0,
-				0, y, z);
-			dmap.combine(-1, 0, 0,
-				1, 0, 0,
-				1, y, z);
-			dmap.combine(+1, 0, 0,
-				-1, 0, 0,
-				width - 2, y, z);
-		}
-		for (int y = height - 1; y >= 0; -- y)
-		{
-			dmap.combine(0, +1, 0,
-				1, 0, 0,
-				0, y, z);
-			dmap.combine(-1, 0, 0,
-				1, 0, 0,
-				1, y, z);
-			dmap.combine(+1, 0, 0,
-				-1, 0, 0,
-				width - 1, y, z);
-		}
-	}
-
-	for (int z = 0; z < depth; ++ z)
-	{
-		for (int y = 0; y < height; ++ y)
-		{
-			for (int x = 0; x < width; ++ x)
-			{
-				float value = 0;
-				for (int i = 0; i < 3; ++ i)
-				{
-					value += dmap(x, y, z, i) * dmap(x, y, z, i);
-				}
-				distances[(z * height + y) * width + x]
-					= static_cast<uint8_t>(MathLib::clamp(sqrt(value) / depth, 0.0f, 1.0f) * 255);
-			}
-		}
-	}
-}
-
 class DistanceMapCreatorApp : public KlayGE::App3DFramework
 {
 public:
@@ -239,6 +47,7 @@ int main(int argc, char* argv[])
 	auto on_exit = nonstd::make_scope_exit([] { Context::Destroy(); });
 
 	int width = 256, height = 256, depth = 16;
+	int bits = 8;
 
 	std::string src_name("height.dds");
 	std::string distance_name("distance.dds");
@@ -263,6 +72,11 @@ int main(int argc, char* argv[])
 	{
 		depth = std::stoi(argv[5]);
 	}
+	if (argc > 6)
+	{
+		bits = std::stoi(argv[6]);
+	}
+	ElementFormat const distance_format = (bits > 8) ? EF_R16 : EF_R8;
 
 	Context::Instance().LoadCfg("KlayGE.cfg");
 	ContextCfg context_cfg = Context::Instance().Config();
@@ -337,23 +151,35 @@ int main(int argc, char* argv[])
 
 	clock_t start = clock();
 
-	std::vector<uint8_t> distances(width * height * depth);
-	ComputeDistanceField(distances, width, height, depth, volume);
+	// The exact Euclidean distance in voxels, normalized by the depth
+	std::vector<float> distance_field;
+	ComputeBinaryDistance(volume, width, height, depth, distance_field);
 
-	cout << endl << "Computing time: " << clock() - start << " ms" << endl;
+	uint32_t const distance_texel_size = NumFormatBytes(distance_format);
+	std::vector<uint8_t> distances(width * height * depth * distance_texel_size);
+	if (EF_R16 == distance_format)
+	{
+		QuantizeDistance(distance_field, static_cast<float>(depth),
+			std::span(reinterpret_cast<uint16_t*>(distances.data()), distance_field.size()));
+	}
+	else
+	{
+		QuantizeDistance(distance_field, static_cast<float>(depth), distances);
+	}
 
-	TexturePtr distance_map_texture = render_factory.MakeTexture3D(width, height, depth, 1, 1, EF_R8, 1, 0, EAH_CPU_Read | EAH_CPU_Write);
+	cout << "Computing time: " << clock() - start << " ms" << endl;
 
-	{
-		uint32_t texel_size = NumFormatBytes(distance_map_texture->Format());
+	TexturePtr distance_map_texture =
+		render_factory.MakeTexture3D(width, height, depth, 1, 1, distance_format, 1, 0, EAH_CPU_Read | EAH_CPU_Write);
 
+	{
 		Texture::Mapper mapper(*distance_map_texture, 0, 0, TMA_Write_Only, 0, 0, 0, width, height, depth);
 		uint8_t* data = mapper.Pointer<uint8_t>();
 		for (int z = 0; z < depth; ++ z)
 		{
 			for (int y = 0; y < height; ++ y)
 			{
-				std::memcpy(data, &distances[z * width * height + y * width], width * texel_size);
+				std::memcpy(data, &distances[(z * width * height + y * width) * distance_texel_size], width * distance_texel_size);
 				data += mapper.RowPitch();
 			}
 			data += mapper.SlicePitch() - mapper.RowPitch() * height;
@@ -79,6 +79,7 @@ int main(int argc, char* argv[])
 	std::vector<std::string> input_names;
 	std::string platform;
 	std::string dest_folder;
+	uint32_t num_jobs = 0;
 
 	cxxopts::Options options("FxmlJit", "KlayGE fxml compiler");
 	// clang-format off
@@ -87,6 +88,7 @@ int main(int argc, char* argv[])
 		("I,input-path", "Input resource path.", cxxopts::value<std::string>())
 		("P,platform", "Platform name.", cxxopts::value<std::string>())
 		("D,dest-folder", "Destination folder.", cxxopts::value<std::string>())
+		("j,jobs", "Number of shaders compiled at the same time, 0 for one per hardware thread.", cxxopts::value<uint32_t>())
 		("v,version", "Version.");
 	// clang-format on
 
@@ -107,6 +109,10 @@ int main(int argc, char* argv[])
 	{
 		dest_folder = vm["dest-folder"].as<std::string>();
 	}
+	if (vm.count("jobs") > 0)
+	{
+		num_jobs = vm["jobs"].as<uint32_t>();
+	}
 	if (vm.count("input-path") > 0)
 	{
 		std::string input_name_str = vm["input-path"].as<std::string>();
@@ -259,7 +265,7 @@ int main(int argc, char* argv[])
 
 			RenderEffect effect;
 			effect.Load(fxml_names);
-			effect.CompileShaders();
+			effect.CompileShaders(num_jobs);
 		}
 		if (!dest_folder.empty())
 		{